@@ -288,7 +288,7 @@ CREATE TABLE IF NOT EXISTS crs_grp (
 	FileZones ENUM('N','Y') NOT NULL DEFAULT 'N',
 	UNIQUE INDEX(GrpCod),
 	INDEX(GrpTypCod),
-	INDEX(RooCod));
+	INDEX(RooCod)) ENGINE=InnoDB;
 --
 -- Table crs_grp_types: stores the types of groups in courses
 --
@@ -301,7 +301,7 @@ CREATE TABLE IF NOT EXISTS crs_grp_types (
 	MustBeOpened ENUM('N','Y') NOT NULL DEFAULT 'N',
 	OpenTime DATETIME NOT NULL,
 	UNIQUE INDEX(GrpTypCod),
-	INDEX(CrsCod));
+	INDEX(CrsCod)) ENGINE=InnoDB;
 --
 -- Table crs_grp_usr: stores the users beloging to each group
 --
@@ -310,7 +310,33 @@ CREATE TABLE IF NOT EXISTS crs_grp_usr (
 	UsrCod INT NOT NULL,
 	UNIQUE INDEX(GrpCod,UsrCod),
 	INDEX(GrpCod),
-	INDEX(UsrCod));
+	INDEX(UsrCod)) ENGINE=InnoDB;
+--
+-- Table crs_indicators: stores the precomputed indicators of courses
+--
+CREATE TABLE IF NOT EXISTS crs_indicators (
+	CrsCod INT NOT NULL,
+	Dirty TINYINT NOT NULL DEFAULT 0,
+	Computing TINYINT NOT NULL DEFAULT 0,
+	ComputingToken CHAR(43) NOT NULL DEFAULT '',
+	UpdateTime DATETIME NOT NULL,
+	SyllabusLecSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',
+	SyllabusPraSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',
+	TeachingGuideSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',
+	AssessmentSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',
+	NumAsgs INT NOT NULL DEFAULT 0,
+	NumFilesAsgs INT NOT NULL DEFAULT 0,
+	NumFilesWorks INT NOT NULL DEFAULT 0,
+	NumThreads INT NOT NULL DEFAULT 0,
+	NumPosts INT NOT NULL DEFAULT 0,
+	NumNotif INT NOT NULL DEFAULT 0,
+	NumMsgsSentByTchs INT NOT NULL DEFAULT 0,
+	NumFilesDocum INT NOT NULL DEFAULT 0,
+	NumFilesShare INT NOT NULL DEFAULT 0,
+	UNIQUE INDEX(CrsCod),
+	INDEX(Dirty),
+	INDEX(ComputingToken),
+	INDEX(UpdateTime));
 --
 -- Table crs_info_read: stores the users who have read the information with mandatory reading
 --
@@ -482,7 +508,7 @@ CREATE TABLE IF NOT EXISTS exa_exams (
 	Title VARCHAR(2047) NOT NULL,
 	Txt TEXT NOT NULL,
 	UNIQUE INDEX(ExaCod),
-	INDEX(CrsCod));
+	INDEX(CrsCod)) ENGINE=InnoDB;
 --
 -- Table exa_log: stores the access log to exam prints
 --
@@ -578,7 +604,7 @@ CREATE TABLE IF NOT EXISTS exa_sets (
 	NumQstsToPrint INT NOT NULL DEFAULT 0,
 	Title VARCHAR(2047) NOT NULL,
 	UNIQUE INDEX(SetCod),
-	UNIQUE INDEX(ExaCod,SetInd));
+	UNIQUE INDEX(ExaCod,SetInd)) ENGINE=InnoDB;
 --
 -- Table exam_announcements: stores the calls for examination
 --
@@ -617,6 +643,36 @@ CREATE TABLE IF NOT EXISTS expanded_folders (
 	INDEX(FileBrowser,Cod),
 	INDEX(WorksUsrCod));
 --
+-- Table fig_snapshot_rows: stores the rows of the results of the queries used to compute figures
+--
+CREATE TABLE IF NOT EXISTS fig_snapshot_rows (
+	SnpCod INT NOT NULL,
+	NumRow INT NOT NULL,
+	Col0 TEXT,
+	Col1 TEXT,
+	Col2 TEXT,
+	Col3 TEXT,
+	Col4 TEXT,
+	Col5 TEXT,
+	Col6 TEXT,
+	Col7 TEXT,
+	UNIQUE INDEX(SnpCod,NumRow));
+--
+-- Table fig_snapshots: stores snapshots of the results of the queries used to compute figures (i.e. number of forums in the platform)
+--
+CREATE TABLE IF NOT EXISTS fig_snapshots (
+	SnpCod INT NOT NULL AUTO_INCREMENT,
+	FigureType INT NOT NULL,
+	Scope ENUM('Sys','Cty','Ins','Ctr','Deg','Crs') NOT NULL DEFAULT 'Sys',
+	QueryHash CHAR(43) NOT NULL,
+	NumCols INT NOT NULL,
+	Complete ENUM('N','Y') NOT NULL DEFAULT 'N',
+	CreatTime DATETIME NOT NULL,
+	UNIQUE INDEX(SnpCod),
+	INDEX(QueryHash),
+	INDEX(Scope,FigureType),
+	INDEX(CreatTime));
+--
 -- Table figures: stores cached figures for quick retrieval of figures (i.e. number of students in the platform)
 --
 CREATE TABLE IF NOT EXISTS figures (
@@ -626,6 +682,7 @@ CREATE TABLE IF NOT EXISTS figures (
 	ValueInt INT NOT NULL DEFAULT 0,
 	ValueDouble DOUBLE PRECISION NOT NULL DEFAULT 0.0,
 	LastUpdate TIMESTAMP,
+	RefreshUntil DATETIME NOT NULL DEFAULT '1970-01-01 00:00:00',
 	UNIQUE INDEX(Figure,Scope,Cod));
 --
 -- Table file_browser_last: stores the last click of every user in each file browser zone
@@ -710,6 +767,14 @@ CREATE TABLE IF NOT EXISTS forum_disabled_post (
 	DisableTime DATETIME NOT NULL,
 	UNIQUE INDEX(PstCod));
 --
+-- Table forum_num_thrs: stores the number of threads in each forum
+--
+CREATE TABLE IF NOT EXISTS forum_num_thrs (
+	ForumType TINYINT NOT NULL,
+	Location INT NOT NULL DEFAULT -1,
+	NumThrs INT NOT NULL DEFAULT 0,
+	UNIQUE INDEX(ForumType,Location));
+--
 -- Table forum_post: stores the forum posts
 --
 CREATE TABLE IF NOT EXISTS forum_post (
@@ -729,6 +794,18 @@ CREATE TABLE IF NOT EXISTS forum_post (
 	INDEX(ModifTime),
 	INDEX(MedCod));
 --
+-- Table forum_read: stores the number of threads opened and completely read by each user in each forum, and the last time the user read the forum
+--
+CREATE TABLE IF NOT EXISTS forum_read (
+	UsrCod INT NOT NULL,
+	ForumType TINYINT NOT NULL,
+	Location INT NOT NULL DEFAULT -1,
+	NumThrsOpened INT NOT NULL DEFAULT 0,
+	NumThrsRead INT NOT NULL DEFAULT 0,
+	ReadTime DATETIME NOT NULL,
+	UNIQUE INDEX(UsrCod,ForumType,Location),
+	INDEX(ForumType,Location));
+--
 -- Table forum_thr_clip: stores the clipboards used to move threads from one forum to another
 --
 CREATE TABLE IF NOT EXISTS forum_thr_clip (
@@ -744,6 +821,7 @@ CREATE TABLE IF NOT EXISTS forum_thr_read (
 	ThrCod INT NOT NULL,
 	UsrCod INT NOT NULL,
 	ReadTime DATETIME NOT NULL,
+	NumUnread INT NOT NULL DEFAULT 0,
 	UNIQUE INDEX(ThrCod,UsrCod));
 --
 -- Table forum_thread: stores the forum threads
@@ -754,12 +832,21 @@ CREATE TABLE IF NOT EXISTS forum_thread (
 	Location INT NOT NULL DEFAULT -1,
 	FirstPstCod INT NOT NULL,
 	LastPstCod INT NOT NULL,
+	NumPsts INT NOT NULL DEFAULT 0,
 	UNIQUE INDEX(ThrCod),
 	INDEX(ForumType),
 	INDEX(Location),
 	UNIQUE INDEX(FirstPstCod),
 	UNIQUE INDEX(LastPstCod));
 --
+-- Table frg_versions: stores the versions of the cached fragments of HTML pages, increased when their content changes
+--
+CREATE TABLE IF NOT EXISTS frg_versions (
+	FrgType TINYINT NOT NULL,
+	Cod INT NOT NULL,
+	Version INT NOT NULL DEFAULT 0,
+	UNIQUE INDEX(FrgType,Cod));
+--
 -- Table gam_games: stores the games
 --
 CREATE TABLE IF NOT EXISTS gam_games (
@@ -772,7 +859,7 @@ CREATE TABLE IF NOT EXISTS gam_games (
 	Title VARCHAR(2047) NOT NULL,
 	Txt TEXT NOT NULL,
 	UNIQUE INDEX(GamCod),
-	INDEX(CrsCod));
+	INDEX(CrsCod)) ENGINE=InnoDB;
 --
 -- Table mch_answers: stores the users' answers to the matches
 --
@@ -852,7 +939,7 @@ CREATE TABLE IF NOT EXISTS gam_questions (
 	QstInd INT NOT NULL,
 	QstCod INT NOT NULL,
 	UNIQUE INDEX(GamCod,QstInd),
-	UNIQUE INDEX(GamCod,QstCod));
+	UNIQUE INDEX(GamCod,QstCod)) ENGINE=InnoDB;
 --
 -- Table mch_times: stores the elapsed time in every question in every match played
 --
@@ -929,61 +1016,51 @@ CREATE TABLE IF NOT EXISTS log (
 	INDEX(InsCod),
 	INDEX(CtrCod),
 	INDEX(DegCod),
-	INDEX(CrsCod),
+	INDEX(CrsCod,ClickTime,LogCod),
 	INDEX(UsrCod),
 	INDEX(ClickTime,Role)
 	) ENGINE=InnoDB
-	PARTITION BY RANGE (YEAR(ClickTime))
+	PARTITION BY RANGE (TO_DAYS(ClickTime))
 	(
-	PARTITION p2004 VALUES LESS THAN (2005),
-	PARTITION p2005 VALUES LESS THAN (2006),
-	PARTITION p2006 VALUES LESS THAN (2007),
-	PARTITION p2007 VALUES LESS THAN (2008),
-	PARTITION p2008 VALUES LESS THAN (2009),
-	PARTITION p2009 VALUES LESS THAN (2010),
-	PARTITION p2010 VALUES LESS THAN (2011),
-	PARTITION p2011 VALUES LESS THAN (2012),
-	PARTITION p2012 VALUES LESS THAN (2013),
-	PARTITION p2013 VALUES LESS THAN (2014),
-	PARTITION p2014 VALUES LESS THAN (2015),
-	PARTITION p2015 VALUES LESS THAN (2016),
-	PARTITION p2016 VALUES LESS THAN (2017),
-	PARTITION p2017 VALUES LESS THAN (2018),
-	PARTITION p2018 VALUES LESS THAN (2019),
-	PARTITION p2019 VALUES LESS THAN (2020),
-	PARTITION p2020 VALUES LESS THAN (2021),
-	PARTITION p2021 VALUES LESS THAN (2022),
-	PARTITION p2022 VALUES LESS THAN (2023),
-	PARTITION p2023 VALUES LESS THAN (2024),
-	PARTITION p2024 VALUES LESS THAN (2025),
-	PARTITION p2025 VALUES LESS THAN (2026),
-	PARTITION p2026 VALUES LESS THAN (2027),
-	PARTITION p2027 VALUES LESS THAN (2028),
-	PARTITION p2028 VALUES LESS THAN (2029),
-	PARTITION p2029 VALUES LESS THAN (2030),
-	PARTITION p2030 VALUES LESS THAN (2031),
-	PARTITION p2031 VALUES LESS THAN (2032),
-	PARTITION p2032 VALUES LESS THAN (2033),
-	PARTITION p2033 VALUES LESS THAN (2034),
-	PARTITION p2034 VALUES LESS THAN (2035),
-	PARTITION p2035 VALUES LESS THAN (2036),
-	PARTITION p2036 VALUES LESS THAN (2037),
-	PARTITION p2037 VALUES LESS THAN (2038),
-	PARTITION p2038 VALUES LESS THAN (2039),
-	PARTITION p2039 VALUES LESS THAN (2040),
-	PARTITION p2040 VALUES LESS THAN (2041),
-	PARTITION p2041 VALUES LESS THAN (2042),
-	PARTITION p2042 VALUES LESS THAN (2043),
-	PARTITION p2043 VALUES LESS THAN (2044),
-	PARTITION p2044 VALUES LESS THAN (2045),
-	PARTITION p2045 VALUES LESS THAN (2046),
-	PARTITION p2046 VALUES LESS THAN (2047),
-	PARTITION p2047 VALUES LESS THAN (2048),
-	PARTITION p2048 VALUES LESS THAN (2049),
-	PARTITION p2049 VALUES LESS THAN (2050),
-	PARTITION p2050 VALUES LESS THAN MAXVALUE
+	PARTITION p2004 VALUES LESS THAN (TO_DAYS('2005-01-01')),
+	PARTITION p2005 VALUES LESS THAN (TO_DAYS('2006-01-01')),
+	PARTITION p2006 VALUES LESS THAN (TO_DAYS('2007-01-01')),
+	PARTITION p2007 VALUES LESS THAN (TO_DAYS('2008-01-01')),
+	PARTITION p2008 VALUES LESS THAN (TO_DAYS('2009-01-01')),
+	PARTITION p2009 VALUES LESS THAN (TO_DAYS('2010-01-01')),
+	PARTITION p2010 VALUES LESS THAN (TO_DAYS('2011-01-01')),
+	PARTITION p2011 VALUES LESS THAN (TO_DAYS('2012-01-01')),
+	PARTITION p2012 VALUES LESS THAN (TO_DAYS('2013-01-01')),
+	PARTITION p2013 VALUES LESS THAN (TO_DAYS('2014-01-01')),
+	PARTITION p2014 VALUES LESS THAN (TO_DAYS('2015-01-01')),
+	PARTITION p2015 VALUES LESS THAN (TO_DAYS('2016-01-01')),
+	PARTITION p2016 VALUES LESS THAN (TO_DAYS('2017-01-01')),
+	PARTITION p2017 VALUES LESS THAN (TO_DAYS('2018-01-01')),
+	PARTITION p2018 VALUES LESS THAN (TO_DAYS('2019-01-01')),
+	PARTITION p2019 VALUES LESS THAN (TO_DAYS('2020-01-01')),
+	PARTITION p202001 VALUES LESS THAN (TO_DAYS('2020-02-01')),
+	PARTITION p202002 VALUES LESS THAN (TO_DAYS('2020-03-01')),
+	PARTITION p202003 VALUES LESS THAN (TO_DAYS('2020-04-01')),
+	PARTITION p202004 VALUES LESS THAN (TO_DAYS('2020-05-01')),
+	PARTITION p202005 VALUES LESS THAN (TO_DAYS('2020-06-01')),
+	PARTITION p202006 VALUES LESS THAN (TO_DAYS('2020-07-01')),
+	PARTITION p202007 VALUES LESS THAN (TO_DAYS('2020-08-01')),
+	PARTITION p202008 VALUES LESS THAN (TO_DAYS('2020-09-01')),
+	PARTITION p202009 VALUES LESS THAN (TO_DAYS('2020-10-01')),
+	PARTITION p202010 VALUES LESS THAN (TO_DAYS('2020-11-01')),
+	PARTITION p202011 VALUES LESS THAN (TO_DAYS('2020-12-01')),
+	PARTITION p202012 VALUES LESS THAN (TO_DAYS('2021-01-01')),
+	PARTITION pmax VALUES LESS THAN MAXVALUE
 	);
 --
+-- Table log_archives: stores the tables with old partitions of the log, archived and compressed
+--
+CREATE TABLE IF NOT EXISTS log_archives (
+	TableName VARCHAR(16) NOT NULL,
+	StartTime DATETIME NOT NULL,
+	EndTime DATETIME NOT NULL,
+	UNIQUE INDEX(TableName),INDEX(StartTime,EndTime));
+--
 -- Table log_banners: stores the log of clicked banners
 --
 CREATE TABLE IF NOT EXISTS log_banners (
@@ -991,6 +1068,16 @@ CREATE TABLE IF NOT EXISTS log_banners (
 	BanCod INT NOT NULL,
 	UNIQUE INDEX(LogCod),INDEX(BanCod));
 --
+-- Table log_columns: stores the closed months of the log exported to files in columnar format
+--
+CREATE TABLE IF NOT EXISTS log_columns (
+	StartTime DATETIME NOT NULL,
+	EndTime DATETIME NOT NULL,
+	NumClicks INT NOT NULL,
+	ToExport ENUM('N','Y') NOT NULL DEFAULT 'N',
+	UNIQUE INDEX(StartTime),
+	INDEX(ToExport));
+--
 -- Table log_comments: stores the comments about errors associated to the log
 --
 CREATE TABLE IF NOT EXISTS log_comments (
@@ -998,6 +1085,32 @@ CREATE TABLE IF NOT EXISTS log_comments (
 	Comments TEXT NOT NULL,
 	UNIQUE INDEX(LogCod));
 --
+-- Table log_frg: stores the number of hits and misses in the cache of fragments of HTML pages in each access
+--
+CREATE TABLE IF NOT EXISTS log_frg (
+	LogCod INT NOT NULL,
+	FrgType TINYINT NOT NULL,
+	NumHits INT NOT NULL DEFAULT 0,
+	NumMisses INT NOT NULL DEFAULT 0,
+	UNIQUE INDEX(LogCod,FrgType));
+--
+-- Table log_hours: stores the number of clicks per hour (UTC), pre-aggregated from the log, used to speed up statistics
+--
+CREATE TABLE IF NOT EXISTS log_hours (
+	HourUTC INT NOT NULL,
+	ActCod INT NOT NULL DEFAULT -1,
+	Role TINYINT NOT NULL,
+	CrsCod INT NOT NULL DEFAULT -1,
+	DegCod INT NOT NULL DEFAULT -1,
+	CtrCod INT NOT NULL DEFAULT -1,
+	InsCod INT NOT NULL DEFAULT -1,
+	CtyCod INT NOT NULL DEFAULT -1,
+	NumClicks INT NOT NULL DEFAULT 0,
+	SumTimeToGenerate BIGINT NOT NULL DEFAULT 0,
+	SumTimeToSend BIGINT NOT NULL DEFAULT 0,
+	Sketch BINARY(64) NOT NULL,
+	UNIQUE INDEX(HourUTC,ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod));
+--
 -- Table log_recent: stores the log of the most recent clicks, used to speed up queries related to log
 --
 CREATE TABLE IF NOT EXISTS log_recent (
@@ -1020,7 +1133,7 @@ CREATE TABLE IF NOT EXISTS log_recent (
 	INDEX(InsCod),
 	INDEX(CtrCod),
 	INDEX(DegCod),
-	INDEX(CrsCod),
+	INDEX(CrsCod,ClickTime,LogCod),
 	INDEX(UsrCod),
 	INDEX(ClickTime,Role));
 --
@@ -1050,6 +1163,22 @@ CREATE TABLE IF NOT EXISTS mail_domains (
 	UNIQUE INDEX(MaiCod),
 	UNIQUE INDEX(Domain));
 --
+-- Table mail_outbox: stores automatic emails waiting to be sent (subject and content are stored in files)
+--
+CREATE TABLE IF NOT EXISTS mail_outbox (
+	OutCod INT NOT NULL AUTO_INCREMENT,
+	ToUsrCod INT NOT NULL DEFAULT -1,
+	MaxNtfCod INT NOT NULL DEFAULT -1,
+	Email VARCHAR(255) NOT NULL,
+	NumAttempts INT NOT NULL DEFAULT 0,
+	NextAttempt DATETIME NOT NULL,
+	CreatTime DATETIME NOT NULL,
+	ClaimToken CHAR(43) NOT NULL DEFAULT '',
+	UNIQUE INDEX(OutCod),
+	INDEX(ToUsrCod),
+	INDEX(NextAttempt),
+	INDEX(ClaimToken));
+--
 -- Table marks_properties: stores information about files of marks
 --
 CREATE TABLE IF NOT EXISTS marks_properties (
@@ -1249,7 +1378,7 @@ CREATE TABLE IF NOT EXISTS prg_items (
 	Title VARCHAR(2047) NOT NULL,
 	Txt TEXT NOT NULL,
 	UNIQUE INDEX(ItmCod),
-	UNIQUE INDEX(CrsCod,ItmInd));
+	UNIQUE INDEX(CrsCod,ItmInd)) ENGINE=InnoDB;
 --
 -- Table prj_config: stores the configuration of projects for each course
 --
@@ -1323,6 +1452,23 @@ CREATE TABLE IF NOT EXISTS room_check_in (
 	INDEX(UsrCod,CheckInTime),
 	INDEX(CheckInTime));
 --
+-- Table sch_indexed: stores the progress of the indexing of names for searches
+--
+CREATE TABLE IF NOT EXISTS sch_indexed (
+	Type TINYINT NOT NULL,
+	LastCod INT NOT NULL DEFAULT 0,
+	Complete ENUM('N','Y') NOT NULL DEFAULT 'N',
+	UNIQUE INDEX(Type));
+--
+-- Table sch_trigrams: stores the trigrams of names of users, institutions, centres, degrees, courses and files, used to speed up searches
+--
+CREATE TABLE IF NOT EXISTS sch_trigrams (
+	Type TINYINT NOT NULL,
+	Cod INT NOT NULL,
+	Trigram INT NOT NULL,
+	UNIQUE INDEX(Type,Trigram,Cod),
+	INDEX(Type,Cod));
+--
 -- Table sessions: stores the information of open sessions
 --
 CREATE TABLE IF NOT EXISTS sessions (
@@ -1419,6 +1565,24 @@ CREATE TABLE IF NOT EXISTS svy_users (
 	UsrCod INT NOT NULL,
 	UNIQUE INDEX(SvyCod,UsrCod));
 --
+-- Table syl_items: stores the items of the syllabuses of lectures and practicals of the courses
+--
+CREATE TABLE IF NOT EXISTS syl_items (
+	CrsCod INT NOT NULL DEFAULT -1,
+	WhichSyllabus ENUM('lectures','practicals') NOT NULL,
+	ItmInd INT NOT NULL DEFAULT 0,
+	Level INT NOT NULL DEFAULT 1,
+	Txt TEXT NOT NULL,
+	UNIQUE INDEX(CrsCod,WhichSyllabus,ItmInd)) ENGINE=InnoDB;
+--
+-- Table syl_syllabuses: stores the version of each syllabus of the courses, used to detect concurrent changes
+--
+CREATE TABLE IF NOT EXISTS syl_syllabuses (
+	CrsCod INT NOT NULL DEFAULT -1,
+	WhichSyllabus ENUM('lectures','practicals') NOT NULL,
+	Version INT NOT NULL DEFAULT 0,
+	UNIQUE INDEX(CrsCod,WhichSyllabus)) ENGINE=InnoDB;
+--
 -- Table timetable_crs: stores the timetables of the courses
 --
 CREATE TABLE IF NOT EXISTS timetable_crs (
@@ -1530,7 +1694,7 @@ CREATE TABLE IF NOT EXISTS tst_answers (
 	MedCod INT NOT NULL DEFAULT -1,
 	Correct ENUM('N','Y') NOT NULL,
 	INDEX(QstCod),
-	INDEX(MedCod));
+	INDEX(MedCod)) ENGINE=InnoDB;
 --
 -- Table tst_config: stores the configuration of tests for each course
 --
@@ -1577,7 +1741,7 @@ CREATE TABLE IF NOT EXISTS tst_question_tags (
 	QstCod INT NOT NULL,
 	TagCod INT NOT NULL,
 	TagInd TINYINT NOT NULL,
-	UNIQUE INDEX(QstCod,TagCod));
+	UNIQUE INDEX(QstCod,TagCod)) ENGINE=InnoDB;
 --
 -- Table tst_questions: stores the test questions
 --
@@ -1595,7 +1759,7 @@ CREATE TABLE IF NOT EXISTS tst_questions (
 	Score DOUBLE PRECISION NOT NULL DEFAULT 0,
 	UNIQUE INDEX(QstCod),
 	INDEX(CrsCod,EditTime),
-	INDEX(MedCod));
+	INDEX(MedCod)) ENGINE=InnoDB;
 --
 -- Table tst_tags: stores the tags of test questions
 --
@@ -1606,7 +1770,7 @@ CREATE TABLE IF NOT EXISTS tst_tags (
 	TagTxt VARCHAR(2047) NOT NULL,
 	TagHidden ENUM('N','Y') NOT NULL,
 	UNIQUE INDEX(TagCod),
-	INDEX(CrsCod,ChangeTime));
+	INDEX(CrsCod,ChangeTime)) ENGINE=InnoDB;
 --
 -- Table usr_banned: stores users banned for ranking
 --
@@ -1671,6 +1835,23 @@ CREATE TABLE IF NOT EXISTS usr_data (
 	INDEX(SideCols),
 	INDEX(ThirdPartyCookies));
 --
+-- Table usr_dup_indexed: stores the progress of the storage of keys of users existing before table usr_dup_keys
+--
+CREATE TABLE IF NOT EXISTS usr_dup_indexed (
+	KeyType TINYINT NOT NULL,
+	LastUsrCod INT NOT NULL DEFAULT 0,
+	Complete ENUM('N','Y') NOT NULL DEFAULT 'N',
+	UNIQUE INDEX(KeyType));
+--
+-- Table usr_dup_keys: stores keys of users (pronunciation of name, words of name sorted, beginning of IDs) used to find similar users
+--
+CREATE TABLE IF NOT EXISTS usr_dup_keys (
+	UsrCod INT NOT NULL,
+	KeyType TINYINT NOT NULL,
+	DupKey VARCHAR(255) NOT NULL,
+	UNIQUE INDEX(UsrCod,KeyType,DupKey),
+	INDEX(KeyType,DupKey));
+--
 -- Table usr_duplicated: stores informs of users possibly duplicated
 --
 CREATE TABLE IF NOT EXISTS usr_duplicated (
@@ -1748,6 +1929,31 @@ CREATE TABLE IF NOT EXISTS usr_nicknames (
 	UNIQUE INDEX(UsrCod,Nickname),
 	UNIQUE INDEX(Nickname));
 --
+-- Table usr_rankings: stores the versions of the rankings of users' figures
+--
+CREATE TABLE IF NOT EXISTS usr_rankings (
+	Figure TINYINT NOT NULL,
+	Version INT NOT NULL DEFAULT 0,
+	NumUsrs INT NOT NULL DEFAULT 0,
+	BuildingToken CHAR(43) NOT NULL DEFAULT '',
+	BuildingVersion INT NOT NULL DEFAULT 0,
+	UpdateTime DATETIME NOT NULL,
+	UNIQUE INDEX(Figure),
+	INDEX(UpdateTime));
+--
+-- Table usr_ranks: stores the rankings of users' figures
+--
+CREATE TABLE IF NOT EXISTS usr_ranks (
+	Figure TINYINT NOT NULL,
+	Version INT NOT NULL,
+	UsrCod INT NOT NULL,
+	Value DOUBLE NOT NULL,
+	Rnk INT NOT NULL,
+	Pos INT NOT NULL,
+	UNIQUE INDEX(Figure,Version,UsrCod),
+	INDEX(Figure,Version,Pos),
+	INDEX(UsrCod));
+--
 -- Table usr_report: stores users' usage reports
 --
 CREATE TABLE IF NOT EXISTS usr_report (
@@ -1761,6 +1967,19 @@ CREATE TABLE IF NOT EXISTS usr_report (
 	UNIQUE INDEX(RepCod),
 	INDEX(UsrCod));
 --
+-- Table usr_report_jobs: stores the queue of jobs to generate users' usage reports
+--
+CREATE TABLE IF NOT EXISTS usr_report_jobs (
+	UsrCod INT NOT NULL,
+	Status ENUM('pending','running','done','failed') NOT NULL DEFAULT 'pending',
+	RequestTime DATETIME NOT NULL,
+	UpdateTime DATETIME NOT NULL,
+	Progress TINYINT NOT NULL DEFAULT 0,
+	LastLogCod INT NOT NULL DEFAULT -1,
+	RepCod INT NOT NULL DEFAULT -1,
+	UNIQUE INDEX(UsrCod),
+	INDEX(Status,UpdateTime));
+--
 -- Table usr_webs: stores users' web and social networks
 --
 CREATE TABLE IF NOT EXISTS usr_webs (
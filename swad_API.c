@@ -114,6 +114,7 @@ cp -f /home/acanas/swad/swad/swad /var/www/cgi-bin/
 #include "swad_notice.h"
 #include "swad_notification.h"
 #include "swad_password.h"
+#include "swad_random.h"
 #include "swad_role.h"
 #include "swad_search.h"
 #include "swad_test_config.h"
@@ -1966,11 +1967,12 @@ int swad__findUsers (struct soap *soap,
 							     Hie_SYS;
       if (Sch_BuildSearchQuery (SearchQuery,
 				"CONCAT_WS(' ',FirstName,Surname1,Surname2)",
-				NULL,NULL))
+				NULL,NULL,
+				SchIdx_USR_NAME,"usr_data.UsrCod"))
 	{
-	 /***** Create temporary table with candidate users *****/
-	 // Search is faster (aproximately x2) using temporary tables
-	 Usr_CreateTmpTableAndSearchCandidateUsrs (SearchQuery);
+	 /***** Get set with candidate users *****/
+	 // Search is faster (aproximately x2) getting first the candidate users
+	 Usr_GetCandidateUsrs (SearchQuery);
 
 	 /***** Search for users *****/
 	 Usr_SearchListUsrs (Role);
@@ -1978,8 +1980,8 @@ int swad__findUsers (struct soap *soap,
 			    Role,getUsersOut);
 	 Usr_FreeUsrsList (Role);
 
-	 /***** Drop temporary table with candidate users *****/
-	 Usr_DropTmpTableWithCandidateUsrs ();
+	 /***** Free set with candidate users *****/
+	 Usr_FreeCandidateUsrs ();
         }
       else
 	 FilterTooShort = true;
@@ -2398,7 +2400,7 @@ int swad__sendMyGroups (struct soap *soap,
      }
 
    /***** Change my groups *****/
-   SendMyGroupsOut->success = Grp_ChangeMyGrpsAtomically (&LstGrpsIWant);
+   SendMyGroupsOut->success = (Grp_ChangeMyGrpsAtomically (&LstGrpsIWant) == Grp_CHANGES_MADE);
 
    /***** Free memory with the list of groups which I want to belong to *****/
    Grp_FreeListCodGrp (&LstGrpsIWant);
@@ -4631,6 +4633,7 @@ int swad__getTrivialQuestion (struct soap *soap,
    MYSQL_ROW row;
    unsigned NumRow;
    unsigned NumRows;
+   struct Rnd_Generator Generator;
    long QstCod = -1L;
    Tst_AnswerType_t AnswerType;
    unsigned Index;
@@ -4699,13 +4702,11 @@ int swad__getTrivialQuestion (struct soap *soap,
 	                        "Bad score interval",
 	                        "lowerScore or upperScore values not valid");
 
-   /***** Start query *****/
+   /***** Get codes of the questions that can be chosen *****/
    Str_SetDecimalPointToUS ();	// To print the floating point as a dot
    NumRows =
    (unsigned) DB_QuerySELECT (&mysql_res,"can not get test questions",
 			      "SELECT DISTINCTROW tst_questions.QstCod,"
-			      "tst_questions.AnsType,tst_questions.Shuffle,"
-			      "tst_questions.Stem,tst_questions.Feedback,"
 			      "tst_questions.Score/tst_questions.NumHits AS S"
 			      " FROM courses,tst_questions"
 			      " WHERE courses.DegCod IN (%s)"
@@ -4720,11 +4721,36 @@ int swad__getTrivialQuestion (struct soap *soap,
 			      " AND tst_tags.TagHidden='Y'"
 			      " AND tst_tags.TagCod=tst_question_tags.TagCod)"
 			      " HAVING S>='%f' AND S<='%f'"
-			      " ORDER BY RAND() LIMIT 1",
+			      " ORDER BY tst_questions.QstCod",
 			      DegreesStr,DegreesStr,
 			      lowerScore,upperScore);
    Str_SetDecimalPointToLocal ();	// Return to local system
 
+   /***** Choose one of the questions at random *****/
+   if (NumRows)
+     {
+      Rnd_SetRandomSeed (&Generator);
+      mysql_data_seek (mysql_res,
+                       (my_ulonglong) Rnd_GetNumLessThan (&Generator,
+                                                          (unsigned long) NumRows));
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get question code (row[0]) */
+      QstCod = Str_ConvertStrCodToLongCod (row[0]);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Get the question chosen *****/
+   NumRows = 0;
+   if (QstCod > 0)
+      NumRows =
+      (unsigned) DB_QuerySELECT (&mysql_res,"can not get test question",
+				 "SELECT QstCod,AnsType,Shuffle,Stem,Feedback"
+				 " FROM tst_questions WHERE QstCod=%ld",
+				 QstCod);
+
    if (NumRows == 1)	// Question found
      {
       /* Get next question */
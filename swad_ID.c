@@ -33,6 +33,7 @@
 #include "swad_account.h"
 #include "swad_box.h"
 #include "swad_database.h"
+#include "swad_duplicate.h"
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
@@ -840,6 +841,9 @@ static void ID_RemoveUsrIDFromDB (long UsrCod,const char *UsrID)
 		    "DELETE FROM usr_IDs"
 		    " WHERE UsrCod=%ld AND UsrID='%s'",
                     UsrCod,UsrID);
+
+   /***** Update keys to find users similar to this one *****/
+   Dup_UpdateUsrKeys (UsrCod);
   }
 
 /*****************************************************************************/
@@ -981,6 +985,9 @@ static void ID_InsertANewUsrIDInDB (long UsrCod,const char *NewID,bool Confirmed
 	           UsrCod,NewID,
 	           Confirmed ? 'Y' :
 			       'N');
+
+   /***** Update keys to find users similar to this one *****/
+   Dup_UpdateUsrKeys (UsrCod);
   }
 
 /*****************************************************************************/
@@ -52,6 +52,7 @@
 #include "swad_profile.h"
 #include "swad_project.h"
 #include "swad_report.h"
+#include "swad_search_index.h"
 #include "swad_test_print.h"
 #include "swad_timeline.h"
 
@@ -794,6 +795,9 @@ void Acc_CreateNewUsr (struct UsrData *UsrDat,bool CreatingMyOwnAccount)
 				(unsigned) Mnu_MENU_DEFAULT,
 				(unsigned) Cfg_DEFAULT_COLUMNS);
 
+   /* Index user's name for searches */
+   SchIdx_IndexRow (SchIdx_USR_NAME,UsrDat->UsrCod);
+
    /* Insert user's IDs as confirmed */
    for (NumID = 0;
 	NumID < UsrDat->IDs.Num;
@@ -811,6 +815,9 @@ void Acc_CreateNewUsr (struct UsrData *UsrDat,bool CreatingMyOwnAccount)
 							  'N');
      }
 
+   /* Store keys to find users similar to this one */
+   Dup_UpdateUsrKeys (UsrDat->UsrCod);
+
    /***** Create directory for the user, if not exists *****/
    Usr_ConstructPathUsr (UsrDat->UsrCod,PathRelUsr);
    Fil_CreateDirIfNotExists (PathRelUsr);
@@ -1049,6 +1056,7 @@ void Acc_CompletelyEliminateAccount (struct UsrData *UsrDat,
 
    /***** Remove user from possible duplicate users *****/
    Dup_RemoveUsrFromDuplicated (UsrDat->UsrCod);
+   Dup_RemoveUsrKeys (UsrDat->UsrCod);
 
    /***** Remove user from the tables of courses and users *****/
    DB_QueryDELETE ("can not remove a user from all courses",
@@ -1196,6 +1204,9 @@ static void Acc_RemoveUsr (struct UsrData *UsrDat)
 		   "DELETE FROM usr_last WHERE UsrCod=%ld",
 		   UsrDat->UsrCod);
 
+   /***** Remove user's name from search index *****/
+   SchIdx_RemoveRow (SchIdx_USR_NAME,UsrDat->UsrCod);
+
    /***** Remove user's data  *****/
    DB_QueryDELETE ("can not remove user's data",
 		   "DELETE FROM usr_data WHERE UsrCod=%ld",
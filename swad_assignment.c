@@ -40,6 +40,7 @@
 #include "swad_global.h"
 #include "swad_group.h"
 #include "swad_HTML.h"
+#include "swad_indicator.h"
 #include "swad_notification.h"
 #include "swad_pagination.h"
 #include "swad_parameter.h"
@@ -1083,6 +1084,9 @@ void Asg_RemoveAssignment (void)
 		   "DELETE FROM assignments WHERE AsgCod=%ld AND CrsCod=%ld",
                    Asg.AsgCod,Gbl.Hierarchy.Crs.CrsCod);
 
+   /***** Indicators about assignments must be computed again *****/
+   Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,Ind_ASSIGNMENTS);
+
    /***** Mark possible notifications as removed *****/
    Ntf_MarkNotifAsRemoved (Ntf_EVENT_ASSIGNMENT,Asg.AsgCod);
 
@@ -1587,6 +1591,9 @@ static void Asg_CreateAssignment (struct Asg_Assignment *Asg,const char *Txt)
    /***** Create groups *****/
    if (Gbl.Crs.Grps.LstGrpsSel.NumGrps)
       Asg_CreateGrps (Asg->AsgCod);
+
+   /***** Indicators about assignments must be computed again *****/
+   Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,Ind_ASSIGNMENTS);
   }
 
 /*****************************************************************************/
@@ -38,10 +38,12 @@
 #include "swad_form.h"
 #include "swad_forum.h"
 #include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_logo.h"
 #include "swad_message.h"
 #include "swad_place.h"
+#include "swad_search_index.h"
 #include "swad_survey.h"
 
 /*****************************************************************************/
@@ -78,7 +80,6 @@ static void Ctr_GetParamCtrOrder (void);
 static void Ctr_EditCentresInternal (void);
 static void Ctr_PutIconsEditingCentres (__attribute__((unused)) void *Args);
 
-static void Ctr_GetDataOfCentreFromRow (struct Centre *Ctr,MYSQL_ROW row);
 
 static void Ctr_ListCentresForEdition (const struct Plc_Places *Places);
 static bool Ctr_CheckIfICanEditACentre (struct Centre *Ctr);
@@ -748,7 +749,7 @@ bool Ctr_GetDataOfCentreByCod (struct Centre *Ctr)
 /********** Get data of a centre from a row resulting of a query *************/
 /*****************************************************************************/
 
-static void Ctr_GetDataOfCentreFromRow (struct Centre *Ctr,MYSQL_ROW row)
+void Ctr_GetDataOfCentreFromRow (struct Centre *Ctr,MYSQL_ROW row)
   {
    /***** Get centre code (row[0]) *****/
    if ((Ctr->CtrCod = Str_ConvertStrCodToLongCod (row[0])) <= 0)
@@ -1275,10 +1276,14 @@ void Ctr_RemoveCentre (void)
 	        (unsigned) Ctr_EditingCtr->CtrCod);
       Fil_RemoveTree (PathCtr);
 
+      /***** Remove centre from search index *****/
+      SchIdx_RemoveRow (SchIdx_CTR_NAME,Ctr_EditingCtr->CtrCod);
+
       /***** Remove centre *****/
       DB_QueryDELETE ("can not remove a centre",
 		      "DELETE FROM centres WHERE CtrCod=%ld",
 		      Ctr_EditingCtr->CtrCod);
+      HieSnp_InvalidateSnapshot ();
 
       /***** Flush caches *****/
       Deg_FlushCacheNumDegsInCtr ();
@@ -1334,6 +1339,7 @@ void Ctr_UpdateCtrPlcDB (long CtrCod,long NewPlcCod)
    DB_QueryUPDATE ("can not update the place of a centre",
 		   "UPDATE centres SET PlcCod=%ld WHERE CtrCod=%ld",
 	           NewPlcCod,CtrCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -1459,6 +1465,10 @@ static void Ctr_UpdateInsNameDB (long CtrCod,const char *FieldName,const char *N
    DB_QueryUPDATE ("can not update the name of a centre",
 		   "UPDATE centres SET %s='%s' WHERE CtrCod=%ld",
 	           FieldName,NewCtrName,CtrCod);
+   HieSnp_InvalidateSnapshot ();
+
+   /***** Update centre name in search index *****/
+   SchIdx_IndexRow (SchIdx_CTR_NAME,CtrCod);
   }
 
 /*****************************************************************************/
@@ -1510,6 +1520,7 @@ void Ctr_UpdateCtrWWWDB (long CtrCod,const char NewWWW[Cns_MAX_BYTES_WWW + 1])
    DB_QueryUPDATE ("can not update the web of a centre",
 		   "UPDATE centres SET WWW='%s' WHERE CtrCod=%ld",
 	           NewWWW,CtrCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -1546,6 +1557,7 @@ void Ctr_ChangeCtrStatus (void)
    DB_QueryUPDATE ("can not update the status of a centre",
 		   "UPDATE centres SET Status=%u WHERE CtrCod=%ld",
 	           (unsigned) Status,Ctr_EditingCtr->CtrCod);
+   HieSnp_InvalidateSnapshot ();
    Ctr_EditingCtr->Status = Status;
 
    /***** Write message to show the change made
@@ -1915,6 +1927,9 @@ static void Ctr_CreateCentre (unsigned Status)
 				Ctr_EditingCtr->ShrtName,
 				Ctr_EditingCtr->FullName,
 				Ctr_EditingCtr->WWW);
+
+   /***** Index name of new centre for searches *****/
+   SchIdx_IndexRow (SchIdx_CTR_NAME,Ctr_EditingCtr->CtrCod);
   }
 
 /*****************************************************************************/
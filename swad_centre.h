@@ -110,6 +110,7 @@ void Ctr_PutIconToViewCentres (void);
 void Ctr_GetBasicListOfCentres (long InsCod);
 void Ctr_GetFullListOfCentres (long InsCod);
 bool Ctr_GetDataOfCentreByCod (struct Centre *Ctr);
+void Ctr_GetDataOfCentreFromRow (struct Centre *Ctr,MYSQL_ROW row);
 long Ctr_GetInsCodOfCentreByCod (long CtrCod);
 void Ctr_GetShortNameOfCentreByCod (struct Centre *Ctr);
 void Ctr_FreeListCentres (void);
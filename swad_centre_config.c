@@ -40,6 +40,7 @@
 #include "swad_global.h"
 #include "swad_help.h"
 #include "swad_hierarchy_config.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_logo.h"
 #include "swad_place.h"
@@ -1083,6 +1084,7 @@ static void CtrCfg_UpdateCtrInsDB (long CtrCod,long InsCod)
    DB_QueryUPDATE ("can not update the institution of a centre",
 		   "UPDATE centres SET InsCod=%ld WHERE CtrCod=%ld",
                    InsCod,CtrCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -1197,6 +1199,7 @@ static void CtrCfg_UpdateCtrCoordinateDB (long CtrCod,
    DB_QueryUPDATE ("can not update a coordinate of a centre",
 		   "UPDATE centres SET %s='%.15lg' WHERE CtrCod=%ld",
 	           CoordField,NewCoord,CtrCod);
+   HieSnp_InvalidateSnapshot ();
    Str_SetDecimalPointToLocal ();	// Return to local system
   }
 
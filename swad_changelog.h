@@ -555,7 +555,7 @@ enscript -2 --landscape --color --file-align=2 --highlight --line-numbers -o - *
 En OpenSWAD:
 ps2pdf source.ps destination.pdf
 */
-#define Log_PLATFORM_VERSION	"SWAD 20.2.2 (2020-09-27)"
+#define Log_PLATFORM_VERSION	"SWAD 20.27.24 (2020-10-24)"
 #define CSS_FILE		"swad20.1.1.css"
 #define JS_FILE			"swad19.254.js"
 /*
@@ -573,6 +573,174 @@ TODO: Que al generar un examen s
 TODO: Create module swad_test_result
 "sudo apt install webp" en Ubuntu, y "yum install libwebp libwebp-tools" en CentOS, para decodificar imgenes Web/ug reportado por Javier Fernndez Baldomero.
 
+	Version 20.27.24: Oct 24, 2020  Test import: documented that progress of the import can not be shown until the page is sent. (315733 lines)
+	Version 20.27.23: Oct 24, 2020  Syllabus: when editing a syllabus, an icon creates an XML file with its items, in the same format used to import it, and puts a link to download it. (315728 lines)
+	Version 20.27.22: Oct 24, 2020  Items of course programs are reordered while holding a named lock of the course, instead of locking the row of the course, so the table of courses keeps its engine. (315646 lines)
+	Version 20.27.21: Oct 24, 2020  Groups: changes of groups of the same user are serialized with a named lock, and the rule of single enrolment is checked again inside the transaction. (315614 lines)
+	Version 20.27.20: Oct 24, 2020  Rankings: the oldest ranking of users' figures is rebuilt in a worker process. (315545 lines)
+	Version 20.27.19: Oct 24, 2020  Indicators of courses: dirty indicators are computed in a worker process. (315544 lines)
+	Version 20.27.18: Oct 24, 2020  Statistics: numbers of distinct users estimated from hits per hour are shown as approximate. Hits are rolled up in a worker process. (315543 lines)
+	Version 20.27.17: Oct 24, 2020  Fragment cache: hits and misses are counted in memory and stored in a new table log_frg at the end of each request, instead of updating a shared row of frg_stats. A fragment being generated when exiting due to an error is written to HTML output and its temporary file is removed. (315514 lines)
+					3 changes necessary in database:
+CREATE TABLE IF NOT EXISTS log_frg (LogCod INT NOT NULL,FrgType TINYINT NOT NULL,NumHits INT NOT NULL DEFAULT 0,NumMisses INT NOT NULL DEFAULT 0,UNIQUE INDEX(LogCod,FrgType));
+INSERT INTO log_frg (LogCod,FrgType,NumHits,NumMisses) SELECT 0,FrgType,NumHits,NumMisses FROM frg_stats;
+DROP TABLE frg_stats;
+
+	Version 20.27.16: Oct 24, 2020  Notifications: emails dropped after many attempts no longer leave their notifications pending. SMTP client pipelines MAIL FROM, RCPT TO and DATA when server supports PIPELINING. (315460 lines)
+	Version 20.27.15: Oct 24, 2020  Messages: nicknames written as recipients are resolved with a single query that also gets the encrypted codes of their users. (315362 lines)
+	Version 20.27.14: Oct 24, 2020  Forums: a thread never opened by a user is counted as new only if it has posts after the last time the user read the forum, as before the counters of threads read. (315235 lines)
+					3 changes necessary in database:
+DROP TABLE forum_read;
+CREATE TABLE IF NOT EXISTS forum_read (UsrCod INT NOT NULL,ForumType TINYINT NOT NULL,Location INT NOT NULL DEFAULT -1,NumThrsOpened INT NOT NULL DEFAULT 0,NumThrsRead INT NOT NULL DEFAULT 0,ReadTime DATETIME NOT NULL,UNIQUE INDEX(UsrCod,ForumType,Location),INDEX(ForumType,Location));
+INSERT INTO forum_read (UsrCod,ForumType,Location,NumThrsOpened,NumThrsRead,ReadTime) SELECT forum_thr_read.UsrCod,forum_thread.ForumType,forum_thread.Location,COUNT(*),SUM(forum_thr_read.NumUnread=0),MAX(forum_thr_read.ReadTime) FROM forum_thr_read,forum_thread WHERE forum_thr_read.ThrCod=forum_thread.ThrCod GROUP BY forum_thr_read.UsrCod,forum_thread.ForumType,forum_thread.Location;
+
+	Version 20.27.13: Oct 23, 2020  Test import: tables of test questions, answers and tags are converted to InnoDB, so questions imported from an XML file are really inserted in transactions. New benchmark of import of large synthetic XML files. (315110 lines)
+					4 changes necessary in database:
+ALTER TABLE tst_answers ENGINE=InnoDB;
+ALTER TABLE tst_question_tags ENGINE=InnoDB;
+ALTER TABLE tst_questions ENGINE=InnoDB;
+ALTER TABLE tst_tags ENGINE=InnoDB;
+
+	Version 20.27.12: Oct 23, 2020  Syllabus: removed functions to write a syllabus into an XML file, not used since syllabuses are stored in database. Fixed end of table syl_syllabuses in swad.sql. (315101 lines)
+	Version 20.27.11: Oct 23, 2020  Groups: the groups a user belongs to are got after locking the groups, and the change is tried again if the user has been registered in a group not locked. An alert is shown when groups can not be locked after several tries. New concurrency stress test of changes of groups. (315132 lines)
+	Version 20.27.10: Oct 23, 2020  Statistics: changes of UTC offset are searched hour by hour, going on from each change found, so two changes in the same day are not missed. New test of changes of UTC offset against the operating system and against CONVERT_TZ. (315069 lines)
+	Version 20.27.9: Oct 23, 2020  Rankings of users' figures: a build is claimed with the unique name of the request and a new version, so a slow build reclaimed by another process never inserts duplicate rows. A builder checks its claim after each batch and abandons the build if it has been lost. (315063 lines)
+					1 change necessary in database:
+ALTER TABLE usr_rankings CHANGE COLUMN BuildingPID BuildingToken CHAR(43) NOT NULL DEFAULT '',ADD COLUMN BuildingVersion INT NOT NULL DEFAULT 0 AFTER BuildingToken;
+
+	Version 20.27.8: Oct 23, 2020  Indicators of courses: a batch is claimed with the unique name of the request instead of the PID, which may be reused by another process. (314994 lines)
+					1 change necessary in database:
+ALTER TABLE crs_indicators DROP INDEX ComputingPID,CHANGE COLUMN ComputingPID ComputingToken CHAR(43) NOT NULL DEFAULT '',ADD INDEX(ComputingToken);
+
+	Version 20.27.7: Oct 23, 2020  Usage report: a worker is started with a conditional update that claims the job and checks the number of running jobs in the same query. A worker exiting on error sets its job as failed. Long sections update the job periodically. (314937 lines)
+					1 change necessary in database:
+ALTER TABLE usr_report_jobs CHANGE COLUMN Status Status ENUM('pending','running','done','failed') NOT NULL DEFAULT 'pending';
+
+	Version 20.27.6: Oct 23, 2020  Columns of log: a missing or wrong file of a month falls back to log and the month is exported again. Months are exported in a worker process, getting clicks one by one. Benchmark in test/. (314865 lines)
+					1 change necessary in database:
+ALTER TABLE log_columns ADD COLUMN ToExport ENUM('N','Y') NOT NULL DEFAULT 'N' AFTER NumClicks,ADD INDEX(ToExport);
+
+	Version 20.27.5: Oct 23, 2020  Maintenance of log partitions is done in a worker process under a named lock, and archives are compressed in a later step. (314594 lines)
+	Version 20.27.4: Oct 23, 2020  The snapshot of hierarchy is rebuilt by only one process at a time, holding a lock on a file, while other processes use the previous snapshot. (314554 lines)
+	Version 20.27.3: Oct 23, 2020  System-wide figures are recomputed in a worker process detached from the refresh request, by only one process at a time. Rows of snapshots of figures are inserted in batches, and results with any number of rows are stored. (314476 lines)
+	Version 20.27.2: Oct 23, 2020  Automatic emails are sent by an SMTP client inside swad, reusing one session for all the emails in a batch. Emails in outbox are claimed atomically. Notifications are marked as sent only when their email has been sent. (314270 lines)
+					2 changes necessary in database:
+ALTER TABLE mail_outbox ADD COLUMN ToUsrCod INT NOT NULL DEFAULT -1 AFTER OutCod,ADD COLUMN MaxNtfCod INT NOT NULL DEFAULT -1 AFTER ToUsrCod,ADD INDEX(ToUsrCod);
+ALTER TABLE mail_outbox ADD COLUMN ClaimToken CHAR(43) NOT NULL DEFAULT '' AFTER CreatTime,ADD INDEX(ClaimToken);
+					swad_smtp.py is no longer used. It can be removed from swad cgi directory.
+
+	Version 20.27:	  Oct 22, 2020  Test questions are imported from XML files with an event-based parser reading the file as a stream, inserting new questions in transactions of 100 questions. (313654 lines)
+	Version 20.26:	  Oct 21, 2020  Syllabuses are stored in database instead of XML files, and each change updates only the items involved. Changes made by another user after the syllabus was shown are detected and not overwritten. XML files are imported the first time. (313549 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS syl_items (CrsCod INT NOT NULL DEFAULT -1,WhichSyllabus ENUM('lectures','practicals') NOT NULL,ItmInd INT NOT NULL DEFAULT 0,Level INT NOT NULL DEFAULT 1,Txt TEXT NOT NULL,UNIQUE INDEX(CrsCod,WhichSyllabus,ItmInd)) ENGINE=InnoDB;
+CREATE TABLE IF NOT EXISTS syl_syllabuses (CrsCod INT NOT NULL DEFAULT -1,WhichSyllabus ENUM('lectures','practicals') NOT NULL,Version INT NOT NULL DEFAULT 0,UNIQUE INDEX(CrsCod,WhichSyllabus)) ENGINE=InnoDB;
+
+	Version 20.25:	  Oct 20, 2020  Course program is read as a tree in one pass: brothers and subtrees of each item are got without scanning the list, hidden subtrees are computed in one pass, all items are shown using a single query, and new items are inserted between non-consecutive indexes without moving the items after them. (313274 lines)
+	Version 20.24:	  Oct 19, 2020  Sets of exams, questions of games and items of course programs are reordered in a transaction that locks only the row of the exam, game or course, instead of locking the whole table. (313211 lines)
+					5 changes necessary in database:
+ALTER TABLE exa_exams ENGINE=InnoDB;
+ALTER TABLE exa_sets ENGINE=InnoDB;
+ALTER TABLE gam_games ENGINE=InnoDB;
+ALTER TABLE gam_questions ENGINE=InnoDB;
+ALTER TABLE prg_items ENGINE=InnoDB;
+
+	Version 20.23:	  Oct 18, 2020  Changes in groups are made in a transaction that locks only the rows of the groups involved, instead of locking tables of groups. Retried if groups are locked by other transactions. (313144 lines)
+					3 changes necessary in database:
+ALTER TABLE crs_grp ENGINE=InnoDB;
+ALTER TABLE crs_grp_types ENGINE=InnoDB;
+ALTER TABLE crs_grp_usr ENGINE=InnoDB;
+
+	Version 20.22:	  Oct 17, 2020  Random questions, students and users to follow are drawn with a seeded generator from their codes instead of sorting rows with ORDER BY RAND(). (312968 lines)
+	Version 20.21:	  Oct 16, 2020  Similar users are got from keys of users (pronunciation of name, words of name sorted and beginning of IDs) and scored comparing their names. Keys are updated when users change and stored in background for existing users. (312661 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS usr_dup_indexed (KeyType TINYINT NOT NULL,LastUsrCod INT NOT NULL DEFAULT 0,Complete ENUM('N','Y') NOT NULL DEFAULT 'N',UNIQUE INDEX(KeyType));
+CREATE TABLE IF NOT EXISTS usr_dup_keys (UsrCod INT NOT NULL,KeyType TINYINT NOT NULL,DupKey VARCHAR(255) NOT NULL,UNIQUE INDEX(UsrCod,KeyType,DupKey),INDEX(KeyType,DupKey));
+
+	Version 20.20:	  Oct 15, 2020  Searches of names of users, institutions, centres, degrees, courses and files use an index of trigrams to get candidates before checking them with LIKE. The index is updated when names change and filled in background. (311917 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS sch_indexed (Type TINYINT NOT NULL,LastCod INT NOT NULL DEFAULT 0,Complete ENUM('N','Y') NOT NULL DEFAULT 'N',UNIQUE INDEX(Type));
+CREATE TABLE IF NOT EXISTS sch_trigrams (Type TINYINT NOT NULL,Cod INT NOT NULL,Trigram INT NOT NULL,UNIQUE INDEX(Type,Trigram,Cod),INDEX(Type,Cod));
+
+	Version 20.19:	  Oct 14, 2020  Statistics grouped by time count clicks per UTC hour and group these hours by local time using changes of UTC offset from the time zone database of the operating system. (311330 lines)
+	Version 20.18:	  Oct 13, 2020  Detailed list of clicks in course statistics is got in pages using the key (click time, log code) of the first or last click in the page, so only the clicks shown are transferred from database. (310869 lines)
+					2 changes necessary in database:
+ALTER TABLE log DROP INDEX CrsCod,ADD INDEX CrsCod (CrsCod,ClickTime,LogCod);
+ALTER TABLE log_recent DROP INDEX CrsCod,ADD INDEX CrsCod (CrsCod,ClickTime,LogCod);
+
+	Version 20.17:	  Oct 12, 2020  Rankings of users' figures are stored in database and rebuilt in background, so rank of a user and top of a ranking are got using indexes. (310749 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS usr_rankings (Figure TINYINT NOT NULL,Version INT NOT NULL DEFAULT 0,NumUsrs INT NOT NULL DEFAULT 0,BuildingPID INT NOT NULL DEFAULT 0,UpdateTime DATETIME NOT NULL,UNIQUE INDEX(Figure),INDEX(UpdateTime));
+CREATE TABLE IF NOT EXISTS usr_ranks (Figure TINYINT NOT NULL,Version INT NOT NULL,UsrCod INT NOT NULL,Value DOUBLE NOT NULL,Rnk INT NOT NULL,Pos INT NOT NULL,UNIQUE INDEX(Figure,Version,UsrCod),INDEX(Figure,Version,Pos),INDEX(UsrCod));
+
+	Version 20.16:	  Oct 11, 2020  Course indicators are precomputed in a new table. Changes in courses set their indicators as dirty, and a background process computes dirty indicators of batches of courses with one query per group of indicators. (310280 lines)
+					1 change necessary in database:
+CREATE TABLE IF NOT EXISTS crs_indicators (CrsCod INT NOT NULL,Dirty TINYINT NOT NULL DEFAULT 0,Computing TINYINT NOT NULL DEFAULT 0,ComputingPID INT NOT NULL DEFAULT 0,UpdateTime DATETIME NOT NULL,SyllabusLecSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',SyllabusPraSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',TeachingGuideSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',AssessmentSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',NumAsgs INT NOT NULL DEFAULT 0,NumFilesAsgs INT NOT NULL DEFAULT 0,NumFilesWorks INT NOT NULL DEFAULT 0,NumThreads INT NOT NULL DEFAULT 0,NumPosts INT NOT NULL DEFAULT 0,NumNotif INT NOT NULL DEFAULT 0,NumMsgsSentByTchs INT NOT NULL DEFAULT 0,NumFilesDocum INT NOT NULL DEFAULT 0,NumFilesShare INT NOT NULL DEFAULT 0,UNIQUE INDEX(CrsCod),INDEX(Dirty),INDEX(ComputingPID),INDEX(UpdateTime));
+
+	Version 20.15:	  Oct 10, 2020  Usage reports are generated by a worker process from a queue of jobs. The user sees the progress, and the last report is reused if there are no new clicks. (310040 lines)
+					1 change necessary in database:
+CREATE TABLE IF NOT EXISTS usr_report_jobs (UsrCod INT NOT NULL,Status ENUM('pending','running','done') NOT NULL DEFAULT 'pending',RequestTime DATETIME NOT NULL,UpdateTime DATETIME NOT NULL,Progress TINYINT NOT NULL DEFAULT 0,LastLogCod INT NOT NULL DEFAULT -1,RepCod INT NOT NULL DEFAULT -1,UNIQUE INDEX(UsrCod),INDEX(Status,UpdateTime));
+
+	Version 20.14:	  Oct 09, 2020  Closed months of log are exported by a background process to files with columns of action, user, course, time and role, encoded with dictionaries and deltas. (309616 lines)
+					The usage report gets clicks in exported months by scanning blocks of these columns, and the rest from log.
+					1 change necessary in database:
+CREATE TABLE IF NOT EXISTS log_columns (StartTime DATETIME NOT NULL,EndTime DATETIME NOT NULL,NumClicks INT NOT NULL,UNIQUE INDEX(StartTime));
+
+	Version 20.13:	  Oct 08, 2020  Table log is partitioned by months. A background process adds next partitions and moves partitions older than Cfg_MONTHS_IN_LOG months to compressed archive tables. (308509 lines)
+					Statistics, usage report and user's figures get clicks only from the partitions and archives in their range of dates.
+					2 changes necessary in database:
+ALTER TABLE log PARTITION BY RANGE (TO_DAYS(ClickTime)) (PARTITION p2004 VALUES LESS THAN (TO_DAYS('2005-01-01')),PARTITION p2005 VALUES LESS THAN (TO_DAYS('2006-01-01')),PARTITION p2006 VALUES LESS THAN (TO_DAYS('2007-01-01')),PARTITION p2007 VALUES LESS THAN (TO_DAYS('2008-01-01')),PARTITION p2008 VALUES LESS THAN (TO_DAYS('2009-01-01')),PARTITION p2009 VALUES LESS THAN (TO_DAYS('2010-01-01')),PARTITION p2010 VALUES LESS THAN (TO_DAYS('2011-01-01')),PARTITION p2011 VALUES LESS THAN (TO_DAYS('2012-01-01')),PARTITION p2012 VALUES LESS THAN (TO_DAYS('2013-01-01')),PARTITION p2013 VALUES LESS THAN (TO_DAYS('2014-01-01')),PARTITION p2014 VALUES LESS THAN (TO_DAYS('2015-01-01')),PARTITION p2015 VALUES LESS THAN (TO_DAYS('2016-01-01')),PARTITION p2016 VALUES LESS THAN (TO_DAYS('2017-01-01')),PARTITION p2017 VALUES LESS THAN (TO_DAYS('2018-01-01')),PARTITION p2018 VALUES LESS THAN (TO_DAYS('2019-01-01')),PARTITION p2019 VALUES LESS THAN (TO_DAYS('2020-01-01')),PARTITION p202001 VALUES LESS THAN (TO_DAYS('2020-02-01')),PARTITION p202002 VALUES LESS THAN (TO_DAYS('2020-03-01')),PARTITION p202003 VALUES LESS THAN (TO_DAYS('2020-04-01')),PARTITION p202004 VALUES LESS THAN (TO_DAYS('2020-05-01')),PARTITION p202005 VALUES LESS THAN (TO_DAYS('2020-06-01')),PARTITION p202006 VALUES LESS THAN (TO_DAYS('2020-07-01')),PARTITION p202007 VALUES LESS THAN (TO_DAYS('2020-08-01')),PARTITION p202008 VALUES LESS THAN (TO_DAYS('2020-09-01')),PARTITION p202009 VALUES LESS THAN (TO_DAYS('2020-10-01')),PARTITION p202010 VALUES LESS THAN (TO_DAYS('2020-11-01')),PARTITION p202011 VALUES LESS THAN (TO_DAYS('2020-12-01')),PARTITION p202012 VALUES LESS THAN (TO_DAYS('2021-01-01')),PARTITION pmax VALUES LESS THAN MAXVALUE);
+CREATE TABLE IF NOT EXISTS log_archives (TableName VARCHAR(16) NOT NULL,StartTime DATETIME NOT NULL,EndTime DATETIME NOT NULL,UNIQUE INDEX(TableName),INDEX(StartTime,EndTime));
+
+	Version 20.12:	  Oct 07, 2020  Clicks are pre-aggregated per hour in a new table, with sketches to estimate distinct users. Global statistics grouped by time, action or hierarchy are got from it when possible. (308074 lines)
+					1 change necessary in database:
+CREATE TABLE IF NOT EXISTS log_hours (HourUTC INT NOT NULL,ActCod INT NOT NULL DEFAULT -1,Role TINYINT NOT NULL,CrsCod INT NOT NULL DEFAULT -1,DegCod INT NOT NULL DEFAULT -1,CtrCod INT NOT NULL DEFAULT -1,InsCod INT NOT NULL DEFAULT -1,CtyCod INT NOT NULL DEFAULT -1,NumClicks INT NOT NULL DEFAULT 0,SumTimeToGenerate BIGINT NOT NULL DEFAULT 0,SumTimeToSend BIGINT NOT NULL DEFAULT 0,Sketch BINARY(64) NOT NULL,UNIQUE INDEX(HourUTC,ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod));
+
+	Version 20.11:	  Oct 06, 2020  Temporary tables with my courses, courses of a user, candidate users and files in my courses are replaced by sets of codes sorted in memory, passed to database in lists of values. (307672 lines)
+	Version 20.10:	  Oct 05, 2020  Fragments of HTML pages that rarely change (course info and course timetable) are stored in a cache of files, invalidated by version counters.
+					Hit ratio of the cache is shown in figures. (307429 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS frg_stats (FrgType TINYINT NOT NULL,NumHits BIGINT NOT NULL DEFAULT 0,NumMisses BIGINT NOT NULL DEFAULT 0,UNIQUE INDEX(FrgType));
+CREATE TABLE IF NOT EXISTS frg_versions (FrgType TINYINT NOT NULL,Cod INT NOT NULL,Version INT NOT NULL DEFAULT 0,UNIQUE INDEX(FrgType,Cod));
+
+	Version 20.9:	  Oct 04, 2020  Current country, institution, centre, degree and course are got from a snapshot of the hierarchy mapped into memory, rebuilt after changes. (306881 lines)
+	Version 20.8:	  Oct 03, 2020  Figures are got from snapshots of the results of their queries, stored in database.
+					System-wide snapshots are recomputed every day by refresh processes. Users can recompute a figure on demand. (305941 lines)
+					2 changes necessary in database:
+CREATE TABLE IF NOT EXISTS fig_snapshots (SnpCod INT NOT NULL AUTO_INCREMENT,FigureType INT NOT NULL,Scope ENUM('Sys','Cty','Ins','Ctr','Deg','Crs') NOT NULL DEFAULT 'Sys',QueryHash CHAR(43) NOT NULL,NumCols INT NOT NULL,Complete ENUM('N','Y') NOT NULL DEFAULT 'N',CreatTime DATETIME NOT NULL,UNIQUE INDEX(SnpCod),INDEX(QueryHash),INDEX(Scope,FigureType),INDEX(CreatTime));
+CREATE TABLE IF NOT EXISTS fig_snapshot_rows (SnpCod INT NOT NULL,NumRow INT NOT NULL,Col0 TEXT,Col1 TEXT,Col2 TEXT,Col3 TEXT,Col4 TEXT,Col5 TEXT,Col6 TEXT,Col7 TEXT,UNIQUE INDEX(SnpCod,NumRow));
+					If you want to use MyISAM:
+ALTER TABLE fig_snapshots ENGINE=MyISAM;
+ALTER TABLE fig_snapshot_rows ENGINE=MyISAM;
+
+	Version 20.7:	  Oct 02, 2020  Cached figures are recomputed by only one process at a time,
+					others get the previous value meanwhile. Figures frequently accessed are recomputed before they expire. (305233 lines)
+					1 change necessary in database:
+ALTER TABLE figures ADD COLUMN RefreshUntil DATETIME NOT NULL DEFAULT '1970-01-01 00:00:00' AFTER LastUpdate;
+
+	Version 20.6:	  Oct 01, 2020  Automatic emails are put into a persistent outbox and sent in batches,
+					using only one session with the SMTP server. Emails not sent are retried later. (305125 lines)
+					1 change necessary in database:
+CREATE TABLE IF NOT EXISTS mail_outbox (OutCod INT NOT NULL AUTO_INCREMENT,Email VARCHAR(255) NOT NULL,NumAttempts INT NOT NULL DEFAULT 0,NextAttempt DATETIME NOT NULL,CreatTime DATETIME NOT NULL,UNIQUE INDEX(OutCod),INDEX(NextAttempt));
+					If you want to use MyISAM:
+ALTER TABLE mail_outbox ENGINE=MyISAM;
+					Copy the new swad_smtp.py into swad cgi directory.
+
+	Version 20.5:	  Sep 30, 2020  Messages to many recipients are delivered with a few queries:
+					recipients and bans are got at once, and received messages and notifications are inserted for all recipients together. (304815 lines)
+	Version 20.4:	  Sep 29, 2020  Notifications about an event to many users are stored
+					with two INSERT ... SELECT queries, instead of one query per user. (304651 lines)
+	Version 20.3:	  Sep 28, 2020  Unread posts and threads in forums are got from counters
+					maintained when posts are written or removed and when threads are read. (304633 lines)
+					8 changes necessary in database:
+ALTER TABLE forum_thread ADD COLUMN NumPsts INT NOT NULL DEFAULT 0 AFTER LastPstCod;
+UPDATE forum_thread SET NumPsts=(SELECT COUNT(*) FROM forum_post WHERE forum_post.ThrCod=forum_thread.ThrCod);
+ALTER TABLE forum_thr_read ADD COLUMN NumUnread INT NOT NULL DEFAULT 0 AFTER ReadTime;
+UPDATE forum_thr_read SET NumUnread=(SELECT COUNT(*) FROM forum_post WHERE forum_post.ThrCod=forum_thr_read.ThrCod AND forum_post.CreatTime>forum_thr_read.ReadTime);
+CREATE TABLE IF NOT EXISTS forum_num_thrs (ForumType TINYINT NOT NULL,Location INT NOT NULL DEFAULT -1,NumThrs INT NOT NULL DEFAULT 0,UNIQUE INDEX(ForumType,Location));
+INSERT INTO forum_num_thrs (ForumType,Location,NumThrs) SELECT ForumType,Location,COUNT(*) FROM forum_thread GROUP BY ForumType,Location;
+CREATE TABLE IF NOT EXISTS forum_read (UsrCod INT NOT NULL,ForumType TINYINT NOT NULL,Location INT NOT NULL DEFAULT -1,NumThrsRead INT NOT NULL DEFAULT 0,UNIQUE INDEX(UsrCod,ForumType,Location),INDEX(ForumType,Location));
+INSERT INTO forum_read (UsrCod,ForumType,Location,NumThrsRead) SELECT forum_thr_read.UsrCod,forum_thread.ForumType,forum_thread.Location,COUNT(*) FROM forum_thr_read,forum_thread WHERE forum_thr_read.ThrCod=forum_thread.ThrCod AND forum_thr_read.NumUnread=0 GROUP BY forum_thr_read.UsrCod,forum_thread.ForumType,forum_thread.Location;
+
 	Version 20.2.2:	  Sep 27, 2020  Fixed bug in exam. (304448 lines)
 	Version 20.2.1:	  Sep 27, 2020  Fixed bug in exam, reported by Nuria Torres Rosell. (304442 lines)
 	Version 20.2:	  Sep 26, 2020  Removed unused action.
@@ -0,0 +1,250 @@
+// swad_code_set.c: sets of codes stored in memory
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#define _GNU_SOURCE 		// For vasprintf
+#include <stdarg.h>		// For va_start, va_end
+#include <stdio.h>		// For vasprintf, sprintf
+#include <stdlib.h>		// For bsearch, free, malloc, qsort, realloc
+
+#include "swad_code_set.h"
+#include "swad_constant.h"
+#include "swad_database.h"
+#include "swad_global.h"
+#include "swad_layout.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+#define CodSet_MIN_SIZE 16	// Minimum number of codes allocated
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static int CodSet_CompareCods (const void *Cod1,const void *Cod2);
+
+/*****************************************************************************/
+/******************************* Reset a set *********************************/
+/*****************************************************************************/
+
+void CodSet_ResetSet (struct CodSet_CodeSet *Set)
+  {
+   Set->Num  = 0;
+   Set->Size = 0;
+   Set->Cods = NULL;
+  }
+
+/*****************************************************************************/
+/************************ Free memory used by a set **************************/
+/*****************************************************************************/
+
+void CodSet_FreeSet (struct CodSet_CodeSet *Set)
+  {
+   if (Set->Cods)
+      free (Set->Cods);
+   CodSet_ResetSet (Set);
+  }
+
+/*****************************************************************************/
+/************************** Add a code to a set ******************************/
+/*****************************************************************************/
+// The set must be sorted after adding codes
+
+void CodSet_AddCodToSet (struct CodSet_CodeSet *Set,long Cod)
+  {
+   long *Cods;
+
+   /***** Enlarge set if full *****/
+   if (Set->Num == Set->Size)
+     {
+      Set->Size = Set->Size ? Set->Size * 2 :
+			      CodSet_MIN_SIZE;
+      if ((Cods = realloc (Set->Cods,Set->Size * sizeof (*Set->Cods))) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      Set->Cods = Cods;
+     }
+
+   /***** Add code *****/
+   Set->Cods[Set->Num++] = Cod;
+  }
+
+/*****************************************************************************/
+/************ Fill a set with codes got from a SELECT query ******************/
+/*****************************************************************************/
+// The query must get codes in the first column
+// Return the number of codes in the set (sorted and without duplicates)
+
+unsigned CodSet_GetSetFromQuery (struct CodSet_CodeSet *Set,const char *MsgError,
+                                 const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumRows;
+   unsigned NumRow;
+   long Cod;
+
+   /***** Build query *****/
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Query database *****/
+   if (mysql_query (&Gbl.mysql,Query))
+     {
+      free (Query);
+      DB_ExitOnMySQLError (MsgError);
+     }
+   free (Query);
+   if ((mysql_res = mysql_store_result (&Gbl.mysql)) == NULL)
+      DB_ExitOnMySQLError (MsgError);
+
+   /***** Add codes to set *****/
+   NumRows = (unsigned) mysql_num_rows (mysql_res);
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      if ((Cod = Str_ConvertStrCodToLongCod (row[0])) > 0)
+	 CodSet_AddCodToSet (Set,Cod);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Sort set *****/
+   CodSet_SortSet (Set);
+
+   return Set->Num;
+  }
+
+/*****************************************************************************/
+/********************* Sort a set and remove duplicates **********************/
+/*****************************************************************************/
+
+void CodSet_SortSet (struct CodSet_CodeSet *Set)
+  {
+   unsigned NumCod;
+   unsigned NumCodsWithoutDup;
+
+   if (Set->Num > 1)
+     {
+      /***** Sort codes *****/
+      qsort (Set->Cods,Set->Num,sizeof (*Set->Cods),CodSet_CompareCods);
+
+      /***** Remove duplicates *****/
+      for (NumCod = 1, NumCodsWithoutDup = 1;
+	   NumCod < Set->Num;
+	   NumCod++)
+	 if (Set->Cods[NumCod] != Set->Cods[NumCodsWithoutDup - 1])
+	    Set->Cods[NumCodsWithoutDup++] = Set->Cods[NumCod];
+      Set->Num = NumCodsWithoutDup;
+     }
+  }
+
+static int CodSet_CompareCods (const void *Cod1,const void *Cod2)
+  {
+   long C1 = *((const long *) Cod1);
+   long C2 = *((const long *) Cod2);
+
+   return (C1 > C2) - (C1 < C2);
+  }
+
+/*****************************************************************************/
+/********************* Check if a code is in a sorted set ********************/
+/*****************************************************************************/
+
+bool CodSet_CheckIfCodIsInSet (const struct CodSet_CodeSet *Set,long Cod)
+  {
+   if (Set->Num == 0)
+      return false;
+
+   return bsearch (&Cod,Set->Cods,Set->Num,sizeof (*Set->Cods),
+		   CodSet_CompareCods) != NULL;
+  }
+
+/*****************************************************************************/
+/************ Get the position of a code in a sorted set *********************/
+/*****************************************************************************/
+// Return false if the code is not in the set
+
+bool CodSet_GetIndexOfCodInSet (const struct CodSet_CodeSet *Set,long Cod,
+                                unsigned *Index)
+  {
+   const long *Found;
+
+   if (Set->Num == 0)
+      return false;
+
+   if ((Found = bsearch (&Cod,Set->Cods,Set->Num,sizeof (*Set->Cods),
+			 CodSet_CompareCods)) == NULL)
+      return false;
+
+   *Index = (unsigned) (Found - Set->Cods);
+   return true;
+  }
+
+/*****************************************************************************/
+/*************** Build a comma-separated list with the codes *****************/
+/*****************************************************************************/
+// The list is allocated and must be freed by the caller
+// An empty set produces "-1", so "IN (...)" is always valid and matches nothing
+
+void CodSet_BuildListOfCods (const struct CodSet_CodeSet *Set,char **ListCods)
+  {
+   unsigned NumCod;
+   char *Ptr;
+
+   /***** Allocate memory for the list *****/
+   if ((*ListCods = malloc ((Set->Num ? (size_t) Set->Num :
+					1) * (Cns_MAX_DECIMAL_DIGITS_LONG + 2))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Write codes separated by commas *****/
+   if (Set->Num)
+      for (NumCod = 0, Ptr = *ListCods;
+	   NumCod < Set->Num;
+	   NumCod++)
+	 Ptr += sprintf (Ptr,NumCod ? ",%ld" :
+				      "%ld",
+			 Set->Cods[NumCod]);
+   else
+      sprintf (*ListCods,"-1");
+  }
@@ -0,0 +1,64 @@
+// swad_code_set.h: sets of codes stored in memory
+
+#ifndef _SWAD_COD_SET
+#define _SWAD_COD_SET
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+// Set of codes (of courses, groups, users...) sorted in ascending order
+// and without duplicates, to be searched quickly
+// and to be passed to the database as a list of values in "IN (...)"
+struct CodSet_CodeSet
+  {
+   unsigned Num;	// Number of codes in set
+   unsigned Size;	// Number of codes allocated
+   long *Cods;		// Codes sorted in ascending order
+  };
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void CodSet_ResetSet (struct CodSet_CodeSet *Set);
+void CodSet_FreeSet (struct CodSet_CodeSet *Set);
+
+void CodSet_AddCodToSet (struct CodSet_CodeSet *Set,long Cod);
+unsigned CodSet_GetSetFromQuery (struct CodSet_CodeSet *Set,const char *MsgError,
+                                 const char *fmt,...);
+void CodSet_SortSet (struct CodSet_CodeSet *Set);
+
+bool CodSet_CheckIfCodIsInSet (const struct CodSet_CodeSet *Set,long Cod);
+bool CodSet_GetIndexOfCodInSet (const struct CodSet_CodeSet *Set,long Cod,
+                                unsigned *Index);
+
+void CodSet_BuildListOfCods (const struct CodSet_CodeSet *Set,char **ListCods);
+
+#endif
@@ -354,6 +354,21 @@
 #define Cfg_FOLDER_OUT 				"out"			// Created automatically the first time it is accessed
 #define Cfg_PATH_OUT_PRIVATE			Cfg_PATH_SWAD_PRIVATE "/" Cfg_FOLDER_OUT
 
+/* Folder for automatic emails waiting to be sent, inside private swad directory */
+#define Cfg_FOLDER_OUTBOX			"outbox"		// Created automatically the first time it is accessed
+#define Cfg_PATH_OUTBOX_PRIVATE			Cfg_PATH_SWAD_PRIVATE "/" Cfg_FOLDER_OUTBOX
+
+/* Folder for snapshot of hierarchy (countries, institutions, centres, degrees and courses), inside private swad directory */
+#define Cfg_FOLDER_HIE_SNAPSHOT			"hie"			// Created automatically the first time it is accessed
+#define Cfg_PATH_HIE_SNAPSHOT_PRIVATE		Cfg_PATH_SWAD_PRIVATE "/" Cfg_FOLDER_HIE_SNAPSHOT
+
+/* Folder for cached fragments of HTML pages, inside private swad directory */
+#define Cfg_FOLDER_FRAGMENT_CACHE		"fragment"		// Created automatically the first time it is accessed
+#define Cfg_PATH_FRAGMENT_CACHE_PRIVATE		Cfg_PATH_SWAD_PRIVATE "/" Cfg_FOLDER_FRAGMENT_CACHE
+
+#define Cfg_FOLDER_LOG_COLUMNS			"log"			// Created automatically the first time it is accessed
+#define Cfg_PATH_LOG_COLUMNS_PRIVATE		Cfg_PATH_SWAD_PRIVATE "/" Cfg_FOLDER_LOG_COLUMNS
+
 /* Folder for temporary public links to file zones, used when displaying file browsers, inside public swad directory */
 #define Cfg_FOLDER_FILE_BROWSER_TMP		"tmp"			// Created automatically the first time it is accessed
 #define Cfg_PATH_FILE_BROWSER_TMP_PUBLIC	Cfg_PATH_SWAD_PUBLIC "/" Cfg_FOLDER_FILE_BROWSER_TMP
@@ -469,9 +484,6 @@
 #define Cfg_COMMAND_DEGREE_PHOTO_MEDIAN			"./foto_mediana"
 #define Cfg_COMMAND_DEGREE_PHOTO_AVERAGE		"./foto_promedio"
 
-/* Command to send automatic emails, programmed by Antonio F. Daz-Garca and Antonio Caas-Vargas */
-#define Cfg_COMMAND_SEND_AUTOMATIC_EMAIL		"./swad_smtp.py"
-
 /*****************************************************************************/
 /******************************** Time periods *******************************/
 /*****************************************************************************/
@@ -481,6 +493,7 @@
 
 #define Cfg_DAYS_IN_RECENT_LOG				 15	// Only accesses in these last days + 1 are stored in recent log.
 								// Important!!! Must be 1 <= Cfg_DAYS_IN_RECENT_LOG <= 29
+#define Cfg_MONTHS_IN_LOG				 36	// Partitions of log older than these months are archived in compressed tables
 #define Cfg_TIMES_PER_SECOND_REFRESH_CONNECTED		  2	// Execute this CGI to refresh connected users about these times per second
 #define Cfg_MIN_TIME_TO_REFRESH_CONNECTED		((time_t)(                     60UL))	// Refresh period of connected users in seconds
 #define Cfg_MAX_TIME_TO_REFRESH_CONNECTED		((time_t)(              15UL * 60UL))	// Refresh period of connected users in seconds
@@ -520,6 +533,8 @@
 
 #define Cfg_TIME_TO_DELETE_TEST_TMP_FILES		((time_t)(        2UL * 60UL * 60UL))  	// Temporary files related to imported test questions after these seconds
 
+#define Cfg_TIME_TO_DELETE_FRAGMENT_CACHE		((time_t)(       24UL * 60UL * 60UL))	// Cached fragments of HTML pages older than these seconds are not used and are removed
+
 #define Cfg_TIME_TO_DELETE_ENROLMENT_REQUESTS		((time_t)(30UL * 24UL * 60UL * 60UL))	// Past these seconds, remove expired enrolment requests
 
 #define Cfg_TIME_TO_DELETE_THREAD_CLIPBOARD		((time_t)(              15UL * 60UL))	// Threads older than these seconds are removed from clipboard
@@ -531,6 +546,8 @@
 
 #define Cfg_TIME_TO_DELETE_OLD_NOTIF 			((time_t)(30UL * 24UL * 60UL * 60UL))	// Past these seconds, remove expired notifications
 
+#define Cfg_TIME_TO_REFRESH_RANKINGS			((time_t)(              60UL * 60UL))	// Rankings of users' figures older than these seconds are rebuilt in background
+
 #define Cfg_MIN_TIME_TO_RECOMPUTE_AVG_PHOTO		((time_t)(       12UL * 60UL * 60UL))	// After these seconds, users can recompute the average photos of a degree
 
 #define Cfg_MAX_TIME_TO_REMEMBER_LAST_ACTION_ON_LOGIN	((time_t)(        2UL * 60UL * 60UL))	// On login, if interval since last action is less than this time, remember last action
@@ -38,6 +38,7 @@
 #include "swad_figure_cache.h"
 #include "swad_form.h"
 #include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_survey.h"
 
@@ -1379,6 +1380,7 @@ void Cty_RemoveCountry (void)
       DB_QueryDELETE ("can not remove a country",
 		      "DELETE FROM countries WHERE CtyCod='%03ld'",
 		      Cty_EditingCty->CtyCod);
+      HieSnp_InvalidateSnapshot ();
 
       /***** Flush cache *****/
       Cty_FlushCacheCountryName ();
@@ -1521,6 +1523,7 @@ static void Cty_UpdateCtyNameDB (long CtyCod,const char *FieldName,const char *N
    DB_QueryUPDATE ("can not update the name of a country",
 		   "UPDATE countries SET %s='%s' WHERE CtyCod='%03ld'",
 	           FieldName,NewCtyName,CtyCod);
+   HieSnp_InvalidateSnapshot ();
 
    /***** Flush cache *****/
    Cty_FlushCacheCountryName ();
@@ -1557,6 +1560,7 @@ void Cty_ChangeCtyWWW (void)
 		   "UPDATE countries SET WWW_%s='%s'"
 		   " WHERE CtyCod='%03ld'",
 	           Lan_STR_LANG_ID[Language],NewWWW,Cty_EditingCty->CtyCod);
+   HieSnp_InvalidateSnapshot ();
    Str_Copy (Cty_EditingCty->WWW[Language],NewWWW,
 	     Cns_MAX_BYTES_WWW);
 
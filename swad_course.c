@@ -43,12 +43,15 @@
 #include "swad_game.h"
 #include "swad_global.h"
 #include "swad_help.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
+#include "swad_indicator.h"
 #include "swad_info.h"
 #include "swad_logo.h"
 #include "swad_message.h"
 #include "swad_project.h"
 #include "swad_search.h"
+#include "swad_search_index.h"
 #include "swad_survey.h"
 #include "swad_test.h"
 
@@ -100,7 +103,6 @@ static void Crs_ReceiveFormRequestOrCreateCrs (unsigned Status);
 static void Crs_GetParamsNewCourse (struct Course *Crs);
 
 static void Crs_CreateCourse (unsigned Status);
-static void Crs_GetDataOfCourseFromRow (struct Course *Crs,MYSQL_ROW row);
 
 static void Crs_GetShortNamesByCod (long CrsCod,
                                     char CrsShortName[Hie_MAX_BYTES_SHRT_NAME + 1],
@@ -1699,6 +1701,9 @@ static void Crs_CreateCourse (unsigned Status)
 				Gbl.Usrs.Me.UsrDat.UsrCod,
 				Crs_EditingCrs->ShrtName,
 				Crs_EditingCrs->FullName);
+
+   /***** Index name of new course for searches *****/
+   SchIdx_IndexRow (SchIdx_CRS_NAME,Crs_EditingCrs->CrsCod);
   }
 
 /*****************************************************************************/
@@ -1797,7 +1802,7 @@ bool Crs_GetDataOfCourseByCod (struct Course *Crs)
 /********** Get data of a course from a row resulting of a query *************/
 /*****************************************************************************/
 
-static void Crs_GetDataOfCourseFromRow (struct Course *Crs,MYSQL_ROW row)
+void Crs_GetDataOfCourseFromRow (struct Course *Crs,MYSQL_ROW row)
   {
    /***** Get course code (row[0]) *****/
    if ((Crs->CrsCod = Str_ConvertStrCodToLongCod (row[0])) < 0)
@@ -1882,10 +1887,17 @@ void Crs_RemoveCourseCompletely (long CrsCod)
 		      "DELETE FROM crs_last WHERE CrsCod=%ld",
 		      CrsCod);
 
+      /***** Remove indicators of the course *****/
+      Ind_RemoveCrsIndicators (CrsCod);
+
+      /***** Remove course from search index *****/
+      SchIdx_RemoveRow (SchIdx_CRS_NAME,CrsCod);
+
       /***** Remove course from table of courses in database *****/
       DB_QueryDELETE ("can not remove a course",
 		      "DELETE FROM courses WHERE CrsCod=%ld",
 		      CrsCod);
+      HieSnp_InvalidateSnapshot ();
      }
   }
 
@@ -1928,6 +1940,15 @@ static void Crs_EmptyCourseCompletely (long CrsCod)
 		      "DELETE FROM crs_info_txt WHERE CrsCod=%ld",
 		      CrsCod);
 
+      /* Remove syllabuses of the course */
+      DB_QueryDELETE ("can not remove syllabus items of a course",
+		      "DELETE FROM syl_items WHERE CrsCod=%ld",
+		      CrsCod);
+
+      DB_QueryDELETE ("can not remove syllabuses of a course",
+		      "DELETE FROM syl_syllabuses WHERE CrsCod=%ld",
+		      CrsCod);
+
       /***** Remove exam announcements in the course *****/
       /* Mark all exam announcements in the course as deleted */
       DB_QueryUPDATE ("can not remove exam announcements of a course",
@@ -2158,6 +2179,7 @@ void Crs_UpdateCrsYear (struct Course *Crs,unsigned NewYear)
    DB_QueryUPDATE ("can not update the year of a course",
 		   "UPDATE courses SET Year=%u WHERE CrsCod=%ld",
 	           NewYear,Crs->CrsCod);
+   HieSnp_InvalidateSnapshot ();
 
    /***** Copy course year/semester *****/
    Crs->Year = NewYear;
@@ -2174,6 +2196,7 @@ void Crs_UpdateInstitutionalCrsCod (struct Course *Crs,const char *NewInstitutio
 	           " of the current course",
 		   "UPDATE courses SET InsCrsCod='%s' WHERE CrsCod=%ld",
                    NewInstitutionalCrsCod,Crs->CrsCod);
+   HieSnp_InvalidateSnapshot ();
 
    /***** Copy institutional course code *****/
    Str_Copy (Crs->InstitutionalCrsCod,NewInstitutionalCrsCod,
@@ -2310,6 +2333,10 @@ static void Crs_UpdateCrsNameDB (long CrsCod,const char *FieldName,const char *N
    DB_QueryUPDATE ("can not update the name of a course",
 		   "UPDATE courses SET %s='%s' WHERE CrsCod=%ld",
 	           FieldName,NewCrsName,CrsCod);
+   HieSnp_InvalidateSnapshot ();
+
+   /***** Update course name in search index *****/
+   SchIdx_IndexRow (SchIdx_CRS_NAME,CrsCod);
   }
 
 /*****************************************************************************/
@@ -2347,6 +2374,7 @@ void Crs_ChangeCrsStatus (void)
    DB_QueryUPDATE ("can not update the status of a course",
 		   "UPDATE courses SET Status=%u WHERE CrsCod=%ld",
                    (unsigned) Status,Crs_EditingCrs->CrsCod);
+   HieSnp_InvalidateSnapshot ();
    Crs_EditingCrs->Status = Status;
 
    /***** Create alert to show the change made *****/
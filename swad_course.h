@@ -132,6 +132,7 @@ void Crs_ReceiveFormNewCrs (void);
 
 void Crs_RemoveCourse (void);
 bool Crs_GetDataOfCourseByCod (struct Course *Crs);
+void Crs_GetDataOfCourseFromRow (struct Course *Crs,MYSQL_ROW row);
 void Crs_RemoveCourseCompletely (long CrsCod);
 void Crs_ChangeInsCrsCod (void);
 void Crs_ChangeCrsYear (void);
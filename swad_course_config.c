@@ -36,6 +36,7 @@
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_hierarchy_config.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_indicator.h"
 #include "swad_logo.h"
@@ -425,12 +426,10 @@ static void CrsCfg_Indicators (void)
    extern const char *Txt_Indicators;
    extern const char *Txt_of_PART_OF_A_TOTAL;
    struct Ind_IndicatorsCrs IndicatorsCrs;
-   int NumIndicatorsFromDB = Ind_GetNumIndicatorsCrsFromDB (Gbl.Hierarchy.Crs.CrsCod);
    char *Title;
 
-   /***** Compute indicators ******/
-   Ind_ComputeAndStoreIndicatorsCrs (Gbl.Hierarchy.Crs.CrsCod,
-				     NumIndicatorsFromDB,&IndicatorsCrs);
+   /***** Get indicators ******/
+   Ind_GetIndicatorsCrs (Gbl.Hierarchy.Crs.CrsCod,&IndicatorsCrs);
 
    /***** Number of indicators *****/
    HTM_TR_Begin (NULL);
@@ -522,6 +521,7 @@ static void CrsCfg_UpdateCrsDegDB (long CrsCod,long DegCod)
    DB_QueryUPDATE ("can not move course to another degree",
 		   "UPDATE courses SET DegCod=%ld WHERE CrsCod=%ld",
 	           DegCod,CrsCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
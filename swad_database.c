@@ -28,6 +28,7 @@
 
 #define _GNU_SOURCE 		// For vasprintf
 #include <mysql/mysql.h>	// To access MySQL databases
+#include <mysql/mysqld_error.h>	// For ER_LOCK_DEADLOCK, ER_LOCK_WAIT_TIMEOUT
 #include <stdarg.h>		// For va_start, va_end
 #include <stddef.h>		// For NULL
 #include <stdio.h>		// For FILE, vasprintf
@@ -39,6 +40,12 @@
 #include "swad_HTML.h"
 #include "swad_language.h"
 
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+#define DB_MAX_TRIES_TO_LOCK_ROWS 5	// Tries to lock rows locked by other transactions
+
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
 /*****************************************************************************/
@@ -54,6 +61,7 @@ extern struct Globals Gbl;
 /*****************************************************************************/
 
 static void DB_CreateTable (const char *Query);
+static bool DB_QueryLockRowsUsingQueryStr (char *Query,const char *MsgError);
 static unsigned long DB_QuerySELECTusingQueryStr (char *Query,
 					          MYSQL_RES **mysql_res,
 						  const char *MsgError);
@@ -681,7 +689,8 @@ mysql> DESCRIBE crs_grp;
 			"FileZones ENUM('N','Y') NOT NULL DEFAULT 'N',"
 		   "UNIQUE INDEX(GrpCod),"
 		   "INDEX(GrpTypCod),"
-		   "INDEX(RooCod))");
+		   "INDEX(RooCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table crs_grp_types *****/
 /*
@@ -708,7 +717,8 @@ mysql> DESCRIBE crs_grp_types;
 			"MustBeOpened ENUM('N','Y') NOT NULL DEFAULT 'N',"
 			"OpenTime DATETIME NOT NULL,"
 		   "UNIQUE INDEX(GrpTypCod),"
-		   "INDEX(CrsCod))");
+		   "INDEX(CrsCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table crs_grp_usr *****/
 /*
@@ -726,7 +736,59 @@ mysql> DESCRIBE crs_grp_usr;
 			"UsrCod INT NOT NULL,"
 		   "UNIQUE INDEX(GrpCod,UsrCod),"
 		   "INDEX(GrpCod),"
-		   "INDEX(UsrCod))");
+		   "INDEX(UsrCod))"
+		   " ENGINE=InnoDB");
+
+   /***** Table crs_indicators *****/
+/*
+mysql> DESCRIBE crs_indicators;
++-------------------+-------------------------------------------------------------+------+-----+---------+-------+
+| Field             | Type                                                        | Null | Key | Default | Extra |
++-------------------+-------------------------------------------------------------+------+-----+---------+-------+
+| CrsCod            | int(11)                                                     | NO   | PRI | NULL    |       |
+| Dirty             | tinyint(4)                                                  | NO   | MUL | 0       |       |
+| Computing         | tinyint(4)                                                  | NO   |     | 0       |       |
+| ComputingToken    | char(43)                                                    | NO   | MUL |         |       |
+| UpdateTime        | datetime                                                    | NO   | MUL | NULL    |       |
+| SyllabusLecSrc    | enum('none','editor','plain_text','rich_text','page','URL') | NO   |     | none    |       |
+| SyllabusPraSrc    | enum('none','editor','plain_text','rich_text','page','URL') | NO   |     | none    |       |
+| TeachingGuideSrc  | enum('none','editor','plain_text','rich_text','page','URL') | NO   |     | none    |       |
+| AssessmentSrc     | enum('none','editor','plain_text','rich_text','page','URL') | NO   |     | none    |       |
+| NumAsgs           | int(11)                                                     | NO   |     | 0       |       |
+| NumFilesAsgs      | int(11)                                                     | NO   |     | 0       |       |
+| NumFilesWorks     | int(11)                                                     | NO   |     | 0       |       |
+| NumThreads        | int(11)                                                     | NO   |     | 0       |       |
+| NumPosts          | int(11)                                                     | NO   |     | 0       |       |
+| NumNotif          | int(11)                                                     | NO   |     | 0       |       |
+| NumMsgsSentByTchs | int(11)                                                     | NO   |     | 0       |       |
+| NumFilesDocum     | int(11)                                                     | NO   |     | 0       |       |
+| NumFilesShare     | int(11)                                                     | NO   |     | 0       |       |
++-------------------+-------------------------------------------------------------+------+-----+---------+-------+
+18 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS crs_indicators ("
+			"CrsCod INT NOT NULL,"
+			"Dirty TINYINT NOT NULL DEFAULT 0,"	// Mask of indicators to be computed again
+			"Computing TINYINT NOT NULL DEFAULT 0,"	// Mask of indicators being computed
+			"ComputingToken CHAR(43) NOT NULL DEFAULT '',"	// Unique token of the process computing the indicators
+			"UpdateTime DATETIME NOT NULL,"
+			"SyllabusLecSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',"
+			"SyllabusPraSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',"
+			"TeachingGuideSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',"
+			"AssessmentSrc ENUM('none','editor','plain_text','rich_text','page','URL') NOT NULL DEFAULT 'none',"
+			"NumAsgs INT NOT NULL DEFAULT 0,"
+			"NumFilesAsgs INT NOT NULL DEFAULT 0,"
+			"NumFilesWorks INT NOT NULL DEFAULT 0,"
+			"NumThreads INT NOT NULL DEFAULT 0,"
+			"NumPosts INT NOT NULL DEFAULT 0,"
+			"NumNotif INT NOT NULL DEFAULT 0,"
+			"NumMsgsSentByTchs INT NOT NULL DEFAULT 0,"
+			"NumFilesDocum INT NOT NULL DEFAULT 0,"
+			"NumFilesShare INT NOT NULL DEFAULT 0,"
+		   "UNIQUE INDEX(CrsCod),"
+		   "INDEX(Dirty),"
+		   "INDEX(ComputingToken),"
+		   "INDEX(UpdateTime))");
 
    /***** Table crs_info_read *****/
 /*
@@ -1042,7 +1104,8 @@ mysql> DESCRIBE exa_exams;
 			"Title VARCHAR(2047) NOT NULL,"	// Exa_MAX_BYTES_TITLE
 			"Txt TEXT NOT NULL,"		// Cns_MAX_BYTES_TEXT
 		   "UNIQUE INDEX(ExaCod),"
-		   "INDEX(CrsCod))");
+		   "INDEX(CrsCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table exa_log *****/
 /*
@@ -1275,7 +1338,8 @@ mysql> DESCRIBE exa_sets;
 			"NumQstsToPrint INT NOT NULL DEFAULT 0,"
 			"Title VARCHAR(2047) NOT NULL,"	// ExaSet_MAX_BYTES_TITLE
 		   "UNIQUE INDEX(SetCod),"
-		   "UNIQUE INDEX(ExaCod,SetInd))");
+		   "UNIQUE INDEX(ExaCod,SetInd))"
+		   " ENGINE=InnoDB");
 
    /***** Table exam_announcements *****/
 /*
@@ -1351,20 +1415,82 @@ mysql> DESCRIBE expanded_folders;
 		   "INDEX(FileBrowser,Cod),"
 		   "INDEX(WorksUsrCod))");
 
+   /***** Table fig_snapshot_rows *****/
+/*
+mysql> DESCRIBE fig_snapshot_rows;
++--------+---------+------+-----+---------+-------+
+| Field  | Type    | Null | Key | Default | Extra |
++--------+---------+------+-----+---------+-------+
+| SnpCod | int(11) | NO   | PRI | NULL    |       |
+| NumRow | int(11) | NO   | PRI | NULL    |       |
+| Col0   | text    | YES  |     | NULL    |       |
+| Col1   | text    | YES  |     | NULL    |       |
+| Col2   | text    | YES  |     | NULL    |       |
+| Col3   | text    | YES  |     | NULL    |       |
+| Col4   | text    | YES  |     | NULL    |       |
+| Col5   | text    | YES  |     | NULL    |       |
+| Col6   | text    | YES  |     | NULL    |       |
+| Col7   | text    | YES  |     | NULL    |       |
++--------+---------+------+-----+---------+-------+
+10 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS fig_snapshot_rows ("
+			"SnpCod INT NOT NULL,"
+			"NumRow INT NOT NULL,"
+			"Col0 TEXT,"
+			"Col1 TEXT,"
+			"Col2 TEXT,"
+			"Col3 TEXT,"
+			"Col4 TEXT,"
+			"Col5 TEXT,"
+			"Col6 TEXT,"
+			"Col7 TEXT,"
+		   "UNIQUE INDEX(SnpCod,NumRow))");
+
+   /***** Table fig_snapshots *****/
+/*
+mysql> DESCRIBE fig_snapshots;
++------------+-------------------------------------------+------+-----+---------+----------------+
+| Field      | Type                                      | Null | Key | Default | Extra          |
++------------+-------------------------------------------+------+-----+---------+----------------+
+| SnpCod     | int(11)                                   | NO   | PRI | NULL    | auto_increment |
+| FigureType | int(11)                                   | NO   |     | NULL    |                |
+| Scope      | enum('Sys','Cty','Ins','Ctr','Deg','Crs') | NO   | MUL | Sys     |                |
+| QueryHash  | char(43)                                  | NO   | MUL | NULL    |                |
+| NumCols    | int(11)                                   | NO   |     | NULL    |                |
+| Complete   | enum('N','Y')                             | NO   |     | N       |                |
+| CreatTime  | datetime                                  | NO   | MUL | NULL    |                |
++------------+-------------------------------------------+------+-----+---------+----------------+
+7 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS fig_snapshots ("
+			"SnpCod INT NOT NULL AUTO_INCREMENT,"
+			"FigureType INT NOT NULL,"
+			"Scope ENUM('Sys','Cty','Ins','Ctr','Deg','Crs') NOT NULL DEFAULT 'Sys',"
+			"QueryHash CHAR(43) NOT NULL,"
+			"NumCols INT NOT NULL,"
+			"Complete ENUM('N','Y') NOT NULL DEFAULT 'N',"
+			"CreatTime DATETIME NOT NULL,"
+		   "UNIQUE INDEX(SnpCod),"
+		   "INDEX(QueryHash),"
+		   "INDEX(Scope,FigureType),"
+		   "INDEX(CreatTime))");
+
    /***** Table figures *****/
    /*
 mysql> DESCRIBE figures;
-+-------------+-------------------------------------------+------+-----+-------------------+-----------------------------+
-| Field       | Type                                      | Null | Key | Default           | Extra                       |
-+-------------+-------------------------------------------+------+-----+-------------------+-----------------------------+
-| Figure      | int(11)                                   | NO   | PRI | NULL              |                             |
-| Scope       | enum('Sys','Cty','Ins','Ctr','Deg','Crs') | NO   | PRI | Sys               |                             |
-| Cod         | int(11)                                   | NO   | PRI | -1                |                             |
-| ValueInt    | int(11)                                   | NO   |     | 0                 |                             |
-| ValueDouble | double                                    | NO   |     | 0                 |                             |
-| LastUpdate  | timestamp                                 | NO   |     | CURRENT_TIMESTAMP | on update CURRENT_TIMESTAMP |
-+-------------+-------------------------------------------+------+-----+-------------------+-----------------------------+
-6 rows in set (0.00 sec)
++--------------+-------------------------------------------+------+-----+---------------------+-----------------------------+
+| Field        | Type                                      | Null | Key | Default             | Extra                       |
++--------------+-------------------------------------------+------+-----+---------------------+-----------------------------+
+| Figure       | int(11)                                   | NO   | PRI | NULL                |                             |
+| Scope        | enum('Sys','Cty','Ins','Ctr','Deg','Crs') | NO   | PRI | Sys                 |                             |
+| Cod          | int(11)                                   | NO   | PRI | -1                  |                             |
+| ValueInt     | int(11)                                   | NO   |     | 0                   |                             |
+| ValueDouble  | double                                    | NO   |     | 0                   |                             |
+| LastUpdate   | timestamp                                 | NO   |     | CURRENT_TIMESTAMP   | on update CURRENT_TIMESTAMP |
+| RefreshUntil | datetime                                  | NO   |     | 1970-01-01 00:00:00 |                             |
++--------------+-------------------------------------------+------+-----+---------------------+-----------------------------+
+7 rows in set (0.00 sec)
    */
    DB_CreateTable ("CREATE TABLE IF NOT EXISTS figures ("
 			"Figure INT NOT NULL,"
@@ -1373,6 +1499,7 @@ mysql> DESCRIBE figures;
 			"ValueInt INT NOT NULL,"
 			"ValueDouble DOUBLE PRECISION NOT NULL,"
 			"LastUpdate TIMESTAMP,"
+			"RefreshUntil DATETIME NOT NULL DEFAULT '1970-01-01 00:00:00',"
 		   "UNIQUE INDEX(Figure,Scope,Cod))");
 
    /***** Table file_browser_last *****/
@@ -1549,6 +1676,24 @@ mysql> DESCRIBE forum_disabled_post;
 			"DisableTime DATETIME NOT NULL,"
 		   "UNIQUE INDEX(PstCod))");
 
+   /***** Table forum_num_thrs *****/
+/*
+mysql> DESCRIBE forum_num_thrs;
++-----------+------------+------+-----+---------+-------+
+| Field     | Type       | Null | Key | Default | Extra |
++-----------+------------+------+-----+---------+-------+
+| ForumType | tinyint(4) | NO   | PRI | NULL    |       |
+| Location  | int(11)    | NO   | PRI | -1      |       |
+| NumThrs   | int(11)    | NO   |     | 0       |       |
++-----------+------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS forum_num_thrs ("
+			"ForumType TINYINT NOT NULL,"
+			"Location INT NOT NULL DEFAULT -1,"
+			"NumThrs INT NOT NULL DEFAULT 0,"
+		   "UNIQUE INDEX(ForumType,Location))");
+
    /***** Table forum_post *****/
 /*
 mysql> DESCRIBE forum_post;
@@ -1584,6 +1729,31 @@ mysql> DESCRIBE forum_post;
 		   "INDEX(ModifTime),"
 		   "INDEX(MedCod))");
 
+   /***** Table forum_read *****/
+/*
+mysql> DESCRIBE forum_read;
++---------------+------------+------+-----+---------+-------+
+| Field         | Type       | Null | Key | Default | Extra |
++---------------+------------+------+-----+---------+-------+
+| UsrCod        | int(11)    | NO   | PRI | NULL    |       |
+| ForumType     | tinyint(4) | NO   | PRI | NULL    |       |
+| Location      | int(11)    | NO   | PRI | -1      |       |
+| NumThrsOpened | int(11)    | NO   |     | 0       |       |
+| NumThrsRead   | int(11)    | NO   |     | 0       |       |
+| ReadTime      | datetime   | NO   |     | NULL    |       |
++---------------+------------+------+-----+---------+-------+
+6 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS forum_read ("
+			"UsrCod INT NOT NULL,"
+			"ForumType TINYINT NOT NULL,"
+			"Location INT NOT NULL DEFAULT -1,"
+			"NumThrsOpened INT NOT NULL DEFAULT 0,"
+			"NumThrsRead INT NOT NULL DEFAULT 0,"
+			"ReadTime DATETIME NOT NULL,"
+		   "UNIQUE INDEX(UsrCod,ForumType,Location),"
+		   "INDEX(ForumType,Location))");
+
    /***** Table forum_thr_clip *****/
 /*
 mysql> DESCRIBE forum_thr_clip;
@@ -1606,19 +1776,21 @@ mysql> DESCRIBE forum_thr_clip;
    /***** Table forum_thr_read *****/
 /*
 mysql> DESCRIBE forum_thr_read;
-+----------+----------+------+-----+---------------------+-------+
-| Field    | Type     | Null | Key | Default             | Extra |
-+----------+----------+------+-----+---------------------+-------+
-| ThrCod   | int(11)  | NO   | PRI | 0                   |       |
-| UsrCod   | int(11)  | NO   | PRI | NULL                |       |
-| ReadTime | datetime | NO   |     | 0000-00-00 00:00:00 |       |
-+----------+----------+------+-----+---------------------+-------+
-3 rows in set (0.00 sec)
++-----------+----------+------+-----+---------------------+-------+
+| Field     | Type     | Null | Key | Default             | Extra |
++-----------+----------+------+-----+---------------------+-------+
+| ThrCod    | int(11)  | NO   | PRI | 0                   |       |
+| UsrCod    | int(11)  | NO   | PRI | NULL                |       |
+| ReadTime  | datetime | NO   |     | 0000-00-00 00:00:00 |       |
+| NumUnread | int(11)  | NO   |     | 0                   |       |
++-----------+----------+------+-----+---------------------+-------+
+4 rows in set (0.00 sec)
 */
    DB_CreateTable ("CREATE TABLE IF NOT EXISTS forum_thr_read ("
 			"ThrCod INT NOT NULL,"
 			"UsrCod INT NOT NULL,"
 			"ReadTime DATETIME NOT NULL,"
+			"NumUnread INT NOT NULL DEFAULT 0,"
 		   "UNIQUE INDEX(ThrCod,UsrCod))");
 
    /***** Table forum_thread *****/
@@ -1632,8 +1804,9 @@ mysql> DESCRIBE forum_thread;
 | Location    | int(11)    | NO   | MUL | -1      |                |
 | FirstPstCod | int(11)    | NO   | UNI | NULL    |                |
 | LastPstCod  | int(11)    | NO   | UNI | NULL    |                |
+| NumPsts     | int(11)    | NO   |     | 0       |                |
 +-------------+------------+------+-----+---------+----------------+
-5 rows in set (0.00 sec)
+6 rows in set (0.00 sec)
 */
    DB_CreateTable ("CREATE TABLE IF NOT EXISTS forum_thread ("
 			"ThrCod INT NOT NULL AUTO_INCREMENT,"
@@ -1641,12 +1814,31 @@ mysql> DESCRIBE forum_thread;
 			"Location INT NOT NULL DEFAULT -1,"
 			"FirstPstCod INT NOT NULL,"
 			"LastPstCod INT NOT NULL,"
+			"NumPsts INT NOT NULL DEFAULT 0,"
 		   "UNIQUE INDEX(ThrCod),"
 		   "INDEX(ForumType),"
 		   "INDEX(Location),"
 		   "UNIQUE INDEX(FirstPstCod),"
 		   "UNIQUE INDEX(LastPstCod))");
 
+   /***** Table frg_versions *****/
+/*
+mysql> DESCRIBE frg_versions;
++---------+------------+------+-----+---------+-------+
+| Field   | Type       | Null | Key | Default | Extra |
++---------+------------+------+-----+---------+-------+
+| FrgType | tinyint(4) | NO   | PRI | NULL    |       |
+| Cod     | int(11)    | NO   | PRI | NULL    |       |
+| Version | int(11)    | NO   |     | 0       |       |
++---------+------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS frg_versions ("
+			"FrgType TINYINT NOT NULL,"
+			"Cod INT NOT NULL,"
+			"Version INT NOT NULL DEFAULT 0,"
+		   "UNIQUE INDEX(FrgType,Cod))");
+
    /***** Table gam_games *****/
 /*
 mysql> DESCRIBE gam_games;
@@ -1674,7 +1866,8 @@ mysql> DESCRIBE gam_games;
 			"Title VARCHAR(2047) NOT NULL,"	// Gam_MAX_BYTES_TITLE
 			"Txt TEXT NOT NULL,"		// Cns_MAX_BYTES_TEXT
 		   "UNIQUE INDEX(GamCod),"
-		   "INDEX(CrsCod))");
+		   "INDEX(CrsCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table gam_questions *****/
 /*
@@ -1693,7 +1886,8 @@ mysql> DESCRIBE gam_questions;
 			"QstInd INT NOT NULL,"
 			"QstCod INT NOT NULL,"
 		   "UNIQUE INDEX(GamCod,QstInd),"
-		   "UNIQUE INDEX(GamCod,QstCod))");
+		   "UNIQUE INDEX(GamCod,QstCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table mch_answers *****/
 /*
@@ -2005,61 +2199,62 @@ mysql> DESCRIBE log;
 			"INDEX(InsCod),"
 			"INDEX(CtrCod),"
 			"INDEX(DegCod),"
-			"INDEX(CrsCod),"
+			"INDEX(CrsCod,ClickTime,LogCod),"
 			"INDEX(UsrCod),"
 			"INDEX(ClickTime,Role)"
 			") ENGINE=InnoDB"
-			" PARTITION BY RANGE (YEAR(ClickTime))"
+			" PARTITION BY RANGE (TO_DAYS(ClickTime))"	// Monthly partitions are added and archived by LogArc_MaintainLogPartitions
 			" ("
-			"PARTITION p2004 VALUES LESS THAN (2005),"
-			"PARTITION p2005 VALUES LESS THAN (2006),"
-			"PARTITION p2006 VALUES LESS THAN (2007),"
-			"PARTITION p2007 VALUES LESS THAN (2008),"
-			"PARTITION p2008 VALUES LESS THAN (2009),"
-			"PARTITION p2009 VALUES LESS THAN (2010),"
-			"PARTITION p2010 VALUES LESS THAN (2011),"
-			"PARTITION p2011 VALUES LESS THAN (2012),"
-			"PARTITION p2012 VALUES LESS THAN (2013),"
-			"PARTITION p2013 VALUES LESS THAN (2014),"
-			"PARTITION p2014 VALUES LESS THAN (2015),"
-			"PARTITION p2015 VALUES LESS THAN (2016),"
-			"PARTITION p2016 VALUES LESS THAN (2017),"
-			"PARTITION p2017 VALUES LESS THAN (2018),"
-			"PARTITION p2018 VALUES LESS THAN (2019),"
-			"PARTITION p2019 VALUES LESS THAN (2020),"
-			"PARTITION p2020 VALUES LESS THAN (2021),"
-			"PARTITION p2021 VALUES LESS THAN (2022),"
-			"PARTITION p2022 VALUES LESS THAN (2023),"
-			"PARTITION p2023 VALUES LESS THAN (2024),"
-			"PARTITION p2024 VALUES LESS THAN (2025),"
-			"PARTITION p2025 VALUES LESS THAN (2026),"
-			"PARTITION p2026 VALUES LESS THAN (2027),"
-			"PARTITION p2027 VALUES LESS THAN (2028),"
-			"PARTITION p2028 VALUES LESS THAN (2029),"
-			"PARTITION p2029 VALUES LESS THAN (2030),"
-			"PARTITION p2030 VALUES LESS THAN (2031),"
-			"PARTITION p2031 VALUES LESS THAN (2032),"
-			"PARTITION p2032 VALUES LESS THAN (2033),"
-			"PARTITION p2033 VALUES LESS THAN (2034),"
-			"PARTITION p2034 VALUES LESS THAN (2035),"
-			"PARTITION p2035 VALUES LESS THAN (2036),"
-			"PARTITION p2036 VALUES LESS THAN (2037),"
-			"PARTITION p2037 VALUES LESS THAN (2038),"
-			"PARTITION p2038 VALUES LESS THAN (2039),"
-			"PARTITION p2039 VALUES LESS THAN (2040),"
-			"PARTITION p2040 VALUES LESS THAN (2041),"
-			"PARTITION p2041 VALUES LESS THAN (2042),"
-			"PARTITION p2042 VALUES LESS THAN (2043),"
-			"PARTITION p2043 VALUES LESS THAN (2044),"
-			"PARTITION p2044 VALUES LESS THAN (2045),"
-			"PARTITION p2045 VALUES LESS THAN (2046),"
-			"PARTITION p2046 VALUES LESS THAN (2047),"
-			"PARTITION p2047 VALUES LESS THAN (2048),"
-			"PARTITION p2048 VALUES LESS THAN (2049),"
-			"PARTITION p2049 VALUES LESS THAN (2050),"
-			"PARTITION p2050 VALUES LESS THAN MAXVALUE"
+			"PARTITION p2004 VALUES LESS THAN (TO_DAYS('2005-01-01')),"
+			"PARTITION p2005 VALUES LESS THAN (TO_DAYS('2006-01-01')),"
+			"PARTITION p2006 VALUES LESS THAN (TO_DAYS('2007-01-01')),"
+			"PARTITION p2007 VALUES LESS THAN (TO_DAYS('2008-01-01')),"
+			"PARTITION p2008 VALUES LESS THAN (TO_DAYS('2009-01-01')),"
+			"PARTITION p2009 VALUES LESS THAN (TO_DAYS('2010-01-01')),"
+			"PARTITION p2010 VALUES LESS THAN (TO_DAYS('2011-01-01')),"
+			"PARTITION p2011 VALUES LESS THAN (TO_DAYS('2012-01-01')),"
+			"PARTITION p2012 VALUES LESS THAN (TO_DAYS('2013-01-01')),"
+			"PARTITION p2013 VALUES LESS THAN (TO_DAYS('2014-01-01')),"
+			"PARTITION p2014 VALUES LESS THAN (TO_DAYS('2015-01-01')),"
+			"PARTITION p2015 VALUES LESS THAN (TO_DAYS('2016-01-01')),"
+			"PARTITION p2016 VALUES LESS THAN (TO_DAYS('2017-01-01')),"
+			"PARTITION p2017 VALUES LESS THAN (TO_DAYS('2018-01-01')),"
+			"PARTITION p2018 VALUES LESS THAN (TO_DAYS('2019-01-01')),"
+			"PARTITION p2019 VALUES LESS THAN (TO_DAYS('2020-01-01')),"
+			"PARTITION p202001 VALUES LESS THAN (TO_DAYS('2020-02-01')),"
+			"PARTITION p202002 VALUES LESS THAN (TO_DAYS('2020-03-01')),"
+			"PARTITION p202003 VALUES LESS THAN (TO_DAYS('2020-04-01')),"
+			"PARTITION p202004 VALUES LESS THAN (TO_DAYS('2020-05-01')),"
+			"PARTITION p202005 VALUES LESS THAN (TO_DAYS('2020-06-01')),"
+			"PARTITION p202006 VALUES LESS THAN (TO_DAYS('2020-07-01')),"
+			"PARTITION p202007 VALUES LESS THAN (TO_DAYS('2020-08-01')),"
+			"PARTITION p202008 VALUES LESS THAN (TO_DAYS('2020-09-01')),"
+			"PARTITION p202009 VALUES LESS THAN (TO_DAYS('2020-10-01')),"
+			"PARTITION p202010 VALUES LESS THAN (TO_DAYS('2020-11-01')),"
+			"PARTITION p202011 VALUES LESS THAN (TO_DAYS('2020-12-01')),"
+			"PARTITION p202012 VALUES LESS THAN (TO_DAYS('2021-01-01')),"
+			"PARTITION pmax VALUES LESS THAN MAXVALUE"
 			")");
 
+   /***** Table log_archives *****/
+/*
+mysql> DESCRIBE log_archives;
++-----------+-------------+------+-----+---------+-------+
+| Field     | Type        | Null | Key | Default | Extra |
++-----------+-------------+------+-----+---------+-------+
+| TableName | varchar(16) | NO   | PRI | NULL    |       |
+| StartTime | datetime    | NO   | MUL | NULL    |       |
+| EndTime   | datetime    | NO   |     | NULL    |       |
++-----------+-------------+------+-----+---------+-------+
+3 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS log_archives ("
+			"TableName VARCHAR(16) NOT NULL,"	// LogArc_MAX_BYTES_TABLE_NAME
+			"StartTime DATETIME NOT NULL,"
+			"EndTime DATETIME NOT NULL,"
+		   "UNIQUE INDEX(TableName),"
+		   "INDEX(StartTime,EndTime))");
+
    /***** Table log_banners *****/
 /*
 mysql> DESCRIBE log_banners;
@@ -2078,6 +2273,27 @@ mysql> DESCRIBE log_banners;
 		   "UNIQUE INDEX(LogCod),"
 		   "INDEX(BanCod))");
 
+   /***** Table log_columns *****/
+/*
+mysql> DESCRIBE log_columns;
++-----------+---------------+------+-----+---------+-------+
+| Field     | Type          | Null | Key | Default | Extra |
++-----------+---------------+------+-----+---------+-------+
+| StartTime | datetime      | NO   | PRI | NULL    |       |
+| EndTime   | datetime      | NO   |     | NULL    |       |
+| NumClicks | int(11)       | NO   |     | NULL    |       |
+| ToExport  | enum('N','Y') | NO   | MUL | N       |       |
++-----------+---------------+------+-----+---------+-------+
+4 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS log_columns ("
+			"StartTime DATETIME NOT NULL,"
+			"EndTime DATETIME NOT NULL,"
+			"NumClicks INT NOT NULL,"
+			"ToExport ENUM('N','Y') NOT NULL DEFAULT 'N',"
+		   "UNIQUE INDEX(StartTime),"
+		   "INDEX(ToExport))");
+
    /***** Table log_comments *****/
 /*
 mysql> DESCRIBE log_comments;
@@ -2095,6 +2311,62 @@ mysql> DESCRIBE log_comments;
 			"Comments TEXT NOT NULL,"
 		   "UNIQUE INDEX(LogCod))");
 
+   /***** Table log_frg *****/
+/*
+mysql> DESCRIBE log_frg;
++-----------+------------+------+-----+---------+-------+
+| Field     | Type       | Null | Key | Default | Extra |
++-----------+------------+------+-----+---------+-------+
+| LogCod    | int(11)    | NO   | PRI | NULL    |       |
+| FrgType   | tinyint(4) | NO   | PRI | NULL    |       |
+| NumHits   | int(11)    | NO   |     | 0       |       |
+| NumMisses | int(11)    | NO   |     | 0       |       |
++-----------+------------+------+-----+---------+-------+
+4 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS log_frg ("
+			"LogCod INT NOT NULL,"
+			"FrgType TINYINT NOT NULL,"
+			"NumHits INT NOT NULL DEFAULT 0,"
+			"NumMisses INT NOT NULL DEFAULT 0,"
+		   "UNIQUE INDEX(LogCod,FrgType))");
+
+   /***** Table log_hours *****/
+/*
+mysql> DESCRIBE log_hours;
++-------------------+------------+------+-----+---------+-------+
+| Field             | Type       | Null | Key | Default | Extra |
++-------------------+------------+------+-----+---------+-------+
+| HourUTC           | int(11)    | NO   | PRI | NULL    |       |
+| ActCod            | int(11)    | NO   | PRI | -1      |       |
+| Role              | tinyint(4) | NO   | PRI | NULL    |       |
+| CrsCod            | int(11)    | NO   | PRI | -1      |       |
+| DegCod            | int(11)    | NO   | PRI | -1      |       |
+| CtrCod            | int(11)    | NO   | PRI | -1      |       |
+| InsCod            | int(11)    | NO   | PRI | -1      |       |
+| CtyCod            | int(11)    | NO   | PRI | -1      |       |
+| NumClicks         | int(11)    | NO   |     | 0       |       |
+| SumTimeToGenerate | bigint(20) | NO   |     | 0       |       |
+| SumTimeToSend     | bigint(20) | NO   |     | 0       |       |
+| Sketch            | binary(64) | NO   |     | NULL    |       |
++-------------------+------------+------+-----+---------+-------+
+12 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS log_hours ("
+			"HourUTC INT NOT NULL,"
+			"ActCod INT NOT NULL DEFAULT -1,"
+			"Role TINYINT NOT NULL,"
+			"CrsCod INT NOT NULL DEFAULT -1,"
+			"DegCod INT NOT NULL DEFAULT -1,"
+			"CtrCod INT NOT NULL DEFAULT -1,"
+			"InsCod INT NOT NULL DEFAULT -1,"
+			"CtyCod INT NOT NULL DEFAULT -1,"
+			"NumClicks INT NOT NULL DEFAULT 0,"
+			"SumTimeToGenerate BIGINT NOT NULL DEFAULT 0,"
+			"SumTimeToSend BIGINT NOT NULL DEFAULT 0,"
+			"Sketch BINARY(64) NOT NULL,"
+		   "UNIQUE INDEX(HourUTC,ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod))");
+
    /***** Table log_recent *****/
 /*
 mysql> DESCRIBE log_recent;
@@ -2138,7 +2410,7 @@ mysql> DESCRIBE log_recent;
 		   "INDEX(InsCod),"
 		   "INDEX(CtrCod),"
 		   "INDEX(DegCod),"
-		   "INDEX(CrsCod),"
+		   "INDEX(CrsCod,ClickTime,LogCod),"
 		   "INDEX(UsrCod),"
 		   "INDEX(ClickTime,Role))");
 
@@ -2198,6 +2470,37 @@ mysql> DESCRIBE mail_domains;
 		   "UNIQUE INDEX(MaiCod),"
 		   "UNIQUE INDEX(Domain))");
 
+   /***** Table mail_outbox *****/
+/*
+mysql> DESCRIBE mail_outbox;
++-------------+--------------+------+-----+---------+----------------+
+| Field       | Type         | Null | Key | Default | Extra          |
++-------------+--------------+------+-----+---------+----------------+
+| OutCod      | int(11)      | NO   | PRI | NULL    | auto_increment |
+| ToUsrCod    | int(11)      | NO   | MUL | -1      |                |
+| MaxNtfCod   | int(11)      | NO   |     | -1      |                |
+| Email       | varchar(255) | NO   |     | NULL    |                |
+| NumAttempts | int(11)      | NO   |     | 0       |                |
+| NextAttempt | datetime     | NO   | MUL | NULL    |                |
+| CreatTime   | datetime     | NO   |     | NULL    |                |
+| ClaimToken  | char(43)     | NO   | MUL |         |                |
++-------------+--------------+------+-----+---------+----------------+
+8 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS mail_outbox ("
+			"OutCod INT NOT NULL AUTO_INCREMENT,"
+			"ToUsrCod INT NOT NULL DEFAULT -1,"
+			"MaxNtfCod INT NOT NULL DEFAULT -1,"
+			"Email VARCHAR(255) NOT NULL,"	// Cns_MAX_BYTES_EMAIL_ADDRESS
+			"NumAttempts INT NOT NULL DEFAULT 0,"
+			"NextAttempt DATETIME NOT NULL,"
+			"CreatTime DATETIME NOT NULL,"
+			"ClaimToken CHAR(43) NOT NULL DEFAULT '',"	// Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64
+		   "UNIQUE INDEX(OutCod),"
+		   "INDEX(ToUsrCod),"
+		   "INDEX(NextAttempt),"
+		   "INDEX(ClaimToken))");
+
    /***** Table marks_properties *****/
 /*
 mysql> DESCRIBE marks_properties;
@@ -2608,7 +2911,8 @@ mysql> DESCRIBE prg_items;
 			"Title VARCHAR(2047) NOT NULL,"		// Prg_MAX_BYTES_PROGRAM_ITEM_TITLE
 			"Txt TEXT NOT NULL,"			// Cns_MAX_BYTES_TEXT
 		   "UNIQUE INDEX(ItmCod),"
-		   "UNIQUE INDEX(CrsCod,ItmInd))");
+		   "UNIQUE INDEX(CrsCod,ItmInd))"
+		   " ENGINE=InnoDB");
 
    /***** Table prj_config *****/
 /*
@@ -2783,6 +3087,43 @@ mysql> DESCRIBE room_check_in;
 		   "INDEX(UsrCod,CheckInTime),"
 		   "INDEX(CheckInTime))");
 
+   /***** Table sch_indexed *****/
+/*
+mysql> DESCRIBE sch_indexed;
++----------+---------------+------+-----+---------+-------+
+| Field    | Type          | Null | Key | Default | Extra |
++----------+---------------+------+-----+---------+-------+
+| Type     | tinyint(4)    | NO   | PRI | NULL    |       |
+| LastCod  | int(11)       | NO   |     | 0       |       |
+| Complete | enum('N','Y') | NO   |     | N       |       |
++----------+---------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS sch_indexed ("
+			"Type TINYINT NOT NULL,"
+			"LastCod INT NOT NULL DEFAULT 0,"
+			"Complete ENUM('N','Y') NOT NULL DEFAULT 'N',"
+		   "UNIQUE INDEX(Type))");
+
+   /***** Table sch_trigrams *****/
+/*
+mysql> DESCRIBE sch_trigrams;
++---------+------------+------+-----+---------+-------+
+| Field   | Type       | Null | Key | Default | Extra |
++---------+------------+------+-----+---------+-------+
+| Type    | tinyint(4) | NO   | PRI | NULL    |       |
+| Cod     | int(11)    | NO   | PRI | NULL    |       |
+| Trigram | int(11)    | NO   | PRI | NULL    |       |
++---------+------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS sch_trigrams ("
+			"Type TINYINT NOT NULL,"
+			"Cod INT NOT NULL,"
+			"Trigram INT NOT NULL,"
+		   "UNIQUE INDEX(Type,Trigram,Cod),"
+		   "INDEX(Type,Cod))");
+
    /***** Table sessions *****/
 /*
 mysql> DESCRIBE sessions;
@@ -2990,6 +3331,48 @@ mysql> DESCRIBE svy_users;
 			"UsrCod INT NOT NULL,"
 		   "UNIQUE INDEX(SvyCod,UsrCod))");
 
+   /***** Table syl_items *****/
+/*
+mysql> DESCRIBE syl_items;
++---------------+---------------------------------+------+-----+---------+-------+
+| Field         | Type                            | Null | Key | Default | Extra |
++---------------+---------------------------------+------+-----+---------+-------+
+| CrsCod        | int(11)                         | NO   | PRI | -1      |       |
+| WhichSyllabus | enum('lectures','practicals')   | NO   | PRI | NULL    |       |
+| ItmInd        | int(11)                         | NO   | PRI | 0       |       |
+| Level         | int(11)                         | NO   |     | 1       |       |
+| Txt           | text                            | NO   |     | NULL    |       |
++---------------+---------------------------------+------+-----+---------+-------+
+5 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS syl_items ("
+			"CrsCod INT NOT NULL DEFAULT -1,"
+			"WhichSyllabus ENUM('lectures','practicals') NOT NULL,"
+			"ItmInd INT NOT NULL DEFAULT 0,"
+			"Level INT NOT NULL DEFAULT 1,"
+			"Txt TEXT NOT NULL,"			// Syl_MAX_BYTES_TEXT_ITEM
+		   "UNIQUE INDEX(CrsCod,WhichSyllabus,ItmInd))"
+		   " ENGINE=InnoDB");
+
+   /***** Table syl_syllabuses *****/
+/*
+mysql> DESCRIBE syl_syllabuses;
++---------------+---------------------------------+------+-----+---------+-------+
+| Field         | Type                            | Null | Key | Default | Extra |
++---------------+---------------------------------+------+-----+---------+-------+
+| CrsCod        | int(11)                         | NO   | PRI | -1      |       |
+| WhichSyllabus | enum('lectures','practicals')   | NO   | PRI | NULL    |       |
+| Version       | int(11)                         | NO   |     | 0       |       |
++---------------+---------------------------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS syl_syllabuses ("
+			"CrsCod INT NOT NULL DEFAULT -1,"
+			"WhichSyllabus ENUM('lectures','practicals') NOT NULL,"
+			"Version INT NOT NULL DEFAULT 0,"
+		   "UNIQUE INDEX(CrsCod,WhichSyllabus))"
+		   " ENGINE=InnoDB");
+
    /***** Table timetable_crs *****/
 /*
 mysql> DESCRIBE timetable_crs;
@@ -3216,7 +3599,8 @@ mysql> DESCRIBE tst_answers;
 			"MedCod INT NOT NULL DEFAULT -1,"
 			"Correct ENUM('N','Y') NOT NULL,"
 		   "INDEX(QstCod),"
-		   "INDEX(MedCod))");
+		   "INDEX(MedCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table tst_config *****/
 /*
@@ -3317,7 +3701,8 @@ mysql> DESCRIBE tst_question_tags;
 			"QstCod INT NOT NULL,"
 			"TagCod INT NOT NULL,"
 			"TagInd TINYINT NOT NULL,"
-		   "UNIQUE INDEX(QstCod,TagCod))");
+		   "UNIQUE INDEX(QstCod,TagCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table tst_questions *****/
 /*
@@ -3353,7 +3738,8 @@ mysql> DESCRIBE tst_questions;
 			"Score DOUBLE PRECISION NOT NULL DEFAULT 0,"
 		   "UNIQUE INDEX(QstCod),"
 		   "INDEX(CrsCod,EditTime),"
-		   "INDEX(MedCod))");
+		   "INDEX(MedCod))"
+		   " ENGINE=InnoDB");
 
    /***** Table tst_tags *****/
 /*
@@ -3377,7 +3763,8 @@ mysql> DESCRIBE tst_tags;
 			"TagTxt VARCHAR(2047) NOT NULL,"	// Tag_MAX_BYTES_TAG
 			"TagHidden ENUM('N','Y') NOT NULL,"
 		   "UNIQUE INDEX(TagCod),"
-		   "INDEX(CrsCod,ChangeTime))");
+		   "INDEX(CrsCod,ChangeTime))"
+		   " ENGINE=InnoDB");
 
    /***** Table usr_banned *****/
 /*
@@ -3493,6 +3880,43 @@ mysql> DESCRIBE usr_data;
 		   "INDEX(SideCols),"
 		   "INDEX(ThirdPartyCookies))");
 
+   /***** Table usr_dup_indexed *****/
+/*
+mysql> DESCRIBE usr_dup_indexed;
++------------+---------------+------+-----+---------+-------+
+| Field      | Type          | Null | Key | Default | Extra |
++------------+---------------+------+-----+---------+-------+
+| KeyType    | tinyint(4)    | NO   | PRI | NULL    |       |
+| LastUsrCod | int(11)       | NO   |     | 0       |       |
+| Complete   | enum('N','Y') | NO   |     | N       |       |
++------------+---------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS usr_dup_indexed ("
+			"KeyType TINYINT NOT NULL,"
+			"LastUsrCod INT NOT NULL DEFAULT 0,"
+			"Complete ENUM('N','Y') NOT NULL DEFAULT 'N',"
+		   "UNIQUE INDEX(KeyType))");
+
+   /***** Table usr_dup_keys *****/
+/*
+mysql> DESCRIBE usr_dup_keys;
++---------+--------------+------+-----+---------+-------+
+| Field   | Type         | Null | Key | Default | Extra |
++---------+--------------+------+-----+---------+-------+
+| UsrCod  | int(11)      | NO   | PRI | NULL    |       |
+| KeyType | tinyint(4)   | NO   | PRI | NULL    |       |
+| DupKey  | varchar(255) | NO   | PRI | NULL    |       |
++---------+--------------+------+-----+---------+-------+
+3 rows in set (0.00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS usr_dup_keys ("
+			"UsrCod INT NOT NULL,"
+			"KeyType TINYINT NOT NULL,"
+			"DupKey VARCHAR(255) NOT NULL,"		// Dup_MAX_BYTES_KEY
+		   "UNIQUE INDEX(UsrCod,KeyType,DupKey),"
+		   "INDEX(KeyType,DupKey))");
+
    /***** Table usr_duplicated *****/
 /*
 mysql> DESCRIBE usr_duplicated;
@@ -3652,6 +4076,57 @@ mysql> DESCRIBE usr_nicknames;
 		   "UNIQUE INDEX(UsrCod,Nickname),"
 		   "UNIQUE INDEX(Nickname))");
 
+   /***** Table usr_rankings *****/
+/*
+mysql> DESCRIBE usr_rankings;
++-----------------+------------+------+-----+---------+-------+
+| Field           | Type       | Null | Key | Default | Extra |
++-----------------+------------+------+-----+---------+-------+
+| Figure          | tinyint(4) | NO   | PRI | NULL    |       |
+| Version         | int(11)    | NO   |     | 0       |       |
+| NumUsrs         | int(11)    | NO   |     | 0       |       |
+| BuildingToken   | char(43)   | NO   |     |         |       |
+| BuildingVersion | int(11)    | NO   |     | 0       |       |
+| UpdateTime      | datetime   | NO   | MUL | NULL    |       |
++-----------------+------------+------+-----+---------+-------+
+6 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS usr_rankings ("
+			"Figure TINYINT NOT NULL,"			// PrfRnk_Figure_t
+			"Version INT NOT NULL DEFAULT 0,"		// Version of the ranking in usr_ranks, 0 if not built
+			"NumUsrs INT NOT NULL DEFAULT 0,"		// Number of users in the ranking
+			"BuildingToken CHAR(43) NOT NULL DEFAULT '',"	// Unique name of the process building a new version
+			"BuildingVersion INT NOT NULL DEFAULT 0,"	// Last version claimed for building
+			"UpdateTime DATETIME NOT NULL,"
+		   "UNIQUE INDEX(Figure),"
+		   "INDEX(UpdateTime))");
+
+   /***** Table usr_ranks *****/
+/*
+mysql> DESCRIBE usr_ranks;
++---------+------------+------+-----+---------+-------+
+| Field   | Type       | Null | Key | Default | Extra |
++---------+------------+------+-----+---------+-------+
+| Figure  | tinyint(4) | NO   | PRI | NULL    |       |
+| Version | int(11)    | NO   | PRI | NULL    |       |
+| UsrCod  | int(11)    | NO   | PRI | NULL    |       |
+| Value   | double     | NO   |     | NULL    |       |
+| Rnk     | int(11)    | NO   |     | NULL    |       |
+| Pos     | int(11)    | NO   |     | NULL    |       |
++---------+------------+------+-----+---------+-------+
+6 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS usr_ranks ("
+			"Figure TINYINT NOT NULL,"			// PrfRnk_Figure_t
+			"Version INT NOT NULL,"
+			"UsrCod INT NOT NULL,"
+			"Value DOUBLE NOT NULL,"			// Value of the figure
+			"Rnk INT NOT NULL,"				// 1 + number of users with greater value
+			"Pos INT NOT NULL,"				// Position in list ordered by value
+		   "UNIQUE INDEX(Figure,Version,UsrCod),"
+		   "INDEX(Figure,Version,Pos),"
+		   "INDEX(UsrCod))");
+
    /***** Table usr_report *****/
 /*
 mysql> DESCRIBE usr_report;
@@ -3679,6 +4154,33 @@ mysql> DESCRIBE usr_report;
 		   "UNIQUE INDEX(RepCod),"
 		   "INDEX(UsrCod))");
 
+   /***** Table usr_report_jobs *****/
+/*
+mysql> DESCRIBE usr_report_jobs;
++-------------+-------------------------------------------+------+-----+---------+-------+
+| Field       | Type                                      | Null | Key | Default | Extra |
++-------------+-------------------------------------------+------+-----+---------+-------+
+| UsrCod      | int(11)                                   | NO   | PRI | NULL    |       |
+| Status      | enum('pending','running','done','failed') | NO   | MUL | pending |       |
+| RequestTime | datetime                                  | NO   |     | NULL    |       |
+| UpdateTime  | datetime                                  | NO   |     | NULL    |       |
+| Progress    | tinyint(4)                                | NO   |     | 0       |       |
+| LastLogCod  | int(11)                                   | NO   |     | -1      |       |
+| RepCod      | int(11)                                   | NO   |     | -1      |       |
++-------------+-------------------------------------------+------+-----+---------+-------+
+7 rows in set (0,00 sec)
+*/
+   DB_CreateTable ("CREATE TABLE IF NOT EXISTS usr_report_jobs ("
+			"UsrCod INT NOT NULL,"
+			"Status ENUM('pending','running','done','failed') NOT NULL DEFAULT 'pending',"
+			"RequestTime DATETIME NOT NULL,"
+			"UpdateTime DATETIME NOT NULL,"
+			"Progress TINYINT NOT NULL DEFAULT 0,"		// 0 to 100
+			"LastLogCod INT NOT NULL DEFAULT -1,"		// Last click in log when the report was generated
+			"RepCod INT NOT NULL DEFAULT -1,"		// Generated report
+		   "UNIQUE INDEX(UsrCod),"
+		   "INDEX(Status,UpdateTime))");
+
 /***** Table usr_webs *****/
 /*
 mysql> DESCRIBE usr_webs;
@@ -3848,6 +4350,49 @@ static unsigned long DB_QuerySELECTusingQueryStr (char *Query,
    return (unsigned long) mysql_num_rows (*mysql_res);
   }
 
+/*****************************************************************************/
+/*********** Make a SELECT query from database without storing rows **********/
+/*****************************************************************************/
+// Used for queries with a lot of rows, which are not stored in memory.
+// Rows must be got with mysql_fetch_row until it returns NULL,
+// with no other query in the meantime,
+// then DB_CheckUnbufferedResult must be called
+// and mysql_res must be freed by the caller
+
+void DB_QuerySELECTunbuffered (MYSQL_RES **mysql_res,const char *MsgError,
+                               const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   int Result;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Query database and free query string pointer *****/
+   Result = mysql_query (&Gbl.mysql,Query);	// Returns 0 on success
+   free (Query);
+   if (Result)
+      DB_ExitOnMySQLError (MsgError);
+
+   /***** Start getting rows one by one *****/
+   if ((*mysql_res = mysql_use_result (&Gbl.mysql)) == NULL)
+      DB_ExitOnMySQLError (MsgError);
+  }
+
+// Rows of an unbuffered query may be interrupted by an error,
+// which is only known after mysql_fetch_row returns NULL
+
+void DB_CheckUnbufferedResult (const char *MsgError)
+  {
+   if (mysql_errno (&Gbl.mysql))
+      DB_ExitOnMySQLError (MsgError);
+  }
+
 /*****************************************************************************/
 /**************** Make a SELECT COUNT query from database ********************/
 /*****************************************************************************/
@@ -4036,6 +4581,177 @@ void DB_Query (const char *MsgError,const char *fmt,...)
       DB_ExitOnMySQLError (MsgError);
   }
 
+/*****************************************************************************/
+/********************** Start a transaction in database **********************/
+/*****************************************************************************/
+// Each query in the transaction sees the rows committed before the query.
+// Rows locked in the transaction are not locked for other transactions
+// in tables not involved, unlike LOCK TABLES
+
+void DB_StartTransaction (void)
+  {
+   DB_Query ("can not set transaction isolation level",
+	     "SET TRANSACTION ISOLATION LEVEL READ COMMITTED");
+   DB_Query ("can not start transaction",
+	     "START TRANSACTION");
+   Gbl.DB.InTransaction = true;
+  }
+
+/*****************************************************************************/
+/***************** Lock some rows in the current transaction *****************/
+/*****************************************************************************/
+// Query must be a SELECT ... FOR UPDATE
+// Return false if rows can not be locked because of a deadlock
+// or a timeout waiting for other transaction,
+// so the transaction should be rolled back and retried
+
+bool DB_QueryLockRows (const char *MsgError,const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   bool Locked;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Query database and free query string pointer *****/
+   Locked = DB_QueryLockRowsUsingQueryStr (Query,MsgError);
+   free (Query);
+
+   return Locked;
+  }
+
+/*****************************************************************************/
+/************ Start a transaction locking some rows in database **************/
+/*****************************************************************************/
+// Query must be a SELECT ... FOR UPDATE.
+// It's used to lock a row of a parent table (an exam, a game, a course...)
+// before changing its children, so only the children of this parent
+// are blocked, not the whole table of children.
+// The transaction is retried if rows are locked by other transactions
+
+void DB_StartTransactionLockingRows (const char *MsgError,const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   unsigned NumTry;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   for (NumTry = 0;
+	NumTry < DB_MAX_TRIES_TO_LOCK_ROWS;
+	NumTry++)
+     {
+      DB_StartTransaction ();
+      if (DB_QueryLockRowsUsingQueryStr (Query,MsgError))
+	{
+	 free (Query);
+	 return;
+	}
+      DB_RollbackTransaction ();
+     }
+
+   free (Query);
+   Lay_ShowErrorAndExit ("Data are being changed by other users. Please try again.");
+  }
+
+/*****************************************************************************/
+/******* Lock some rows in the current transaction using a query string ******/
+/*****************************************************************************/
+
+static bool DB_QueryLockRowsUsingQueryStr (char *Query,const char *MsgError)
+  {
+   MYSQL_RES *mysql_res;
+
+   /***** Query database *****/
+   if (mysql_query (&Gbl.mysql,Query))	// Returns 0 on success
+      switch (mysql_errno (&Gbl.mysql))
+        {
+	 case ER_LOCK_DEADLOCK:
+	 case ER_LOCK_WAIT_TIMEOUT:
+	    return false;
+	 default:
+	    DB_ExitOnMySQLError (MsgError);
+	    break;
+        }
+
+   /***** Rows locked are not used *****/
+   if ((mysql_res = mysql_store_result (&Gbl.mysql)) == NULL)
+      DB_ExitOnMySQLError ("can not store result of a query");
+   DB_FreeMySQLResult (&mysql_res);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/******************** Commit the transaction in database *********************/
+/*****************************************************************************/
+
+void DB_CommitTransaction (void)
+  {
+   Gbl.DB.InTransaction = false;	// Set to false before the following commit...
+					// ...to not retry the commit if error in committing
+   DB_Query ("can not commit transaction",
+	     "COMMIT");
+  }
+
+/*****************************************************************************/
+/****************** Roll back the transaction in database ********************/
+/*****************************************************************************/
+
+void DB_RollbackTransaction (void)
+  {
+   Gbl.DB.InTransaction = false;	// Set to false before the following rollback...
+					// ...to not retry the rollback if error in rolling back
+   DB_Query ("can not roll back transaction",
+	     "ROLLBACK");
+  }
+
+/*****************************************************************************/
+/************************ Get a named lock in database ***********************/
+/*****************************************************************************/
+// Named locks are used to run a slow task in only one process at a time.
+// It does not wait if the lock is held by another connection.
+// Return true if the lock has been got.
+// The lock is released when the database connection is closed
+
+bool DB_GetNamedLock (const char *LockName)
+  {
+   return DB_WaitForNamedLock (LockName,0);
+  }
+
+/*****************************************************************************/
+/*************** Wait some seconds to get a named lock in database ***********/
+/*****************************************************************************/
+// Return true if the lock has been got before timeout
+
+bool DB_WaitForNamedLock (const char *LockName,unsigned Seconds)
+  {
+   return DB_QueryCOUNT ("can not get lock",
+			 "SELECT COALESCE(GET_LOCK('%s',%u),0)",
+			 LockName,Seconds) == 1;
+  }
+
+/*****************************************************************************/
+/********************** Release a named lock in database *********************/
+/*****************************************************************************/
+
+void DB_ReleaseNamedLock (const char *LockName)
+  {
+   DB_QueryCOUNT ("can not release lock",
+		  "SELECT COALESCE(RELEASE_LOCK('%s'),0)",
+		  LockName);
+  }
+
 /*****************************************************************************/
 /********** Free structure that stores the result of a SELECT query **********/
 /*****************************************************************************/
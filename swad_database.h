@@ -28,6 +28,7 @@
 /*****************************************************************************/
 
 #include <mysql/mysql.h>	// To access MySQL databases
+#include <stdbool.h>		// For boolean type
 
 /*****************************************************************************/
 /***************************** Public prototypes *****************************/
@@ -41,6 +42,9 @@ void DB_BuildQuery (char **Query,const char *fmt,...);
 
 unsigned long DB_QuerySELECT (MYSQL_RES **mysql_res,const char *MsgError,
                               const char *fmt,...);
+void DB_QuerySELECTunbuffered (MYSQL_RES **mysql_res,const char *MsgError,
+                               const char *fmt,...);
+void DB_CheckUnbufferedResult (const char *MsgError);
 unsigned long DB_GetNumRowsTable (const char *Table);
 unsigned long DB_QueryCOUNT (const char *MsgError,const char *fmt,...);
 
@@ -56,6 +60,16 @@ void DB_QueryDELETE (const char *MsgError,const char *fmt,...);
 
 void DB_Query (const char *MsgError,const char *fmt,...);
 
+void DB_StartTransaction (void);
+bool DB_QueryLockRows (const char *MsgError,const char *fmt,...);
+void DB_StartTransactionLockingRows (const char *MsgError,const char *fmt,...);
+void DB_CommitTransaction (void);
+void DB_RollbackTransaction (void);
+
+bool DB_GetNamedLock (const char *LockName);
+bool DB_WaitForNamedLock (const char *LockName,unsigned Seconds);
+void DB_ReleaseNamedLock (const char *LockName);
+
 void DB_FreeMySQLResult (MYSQL_RES **mysql_res);
 void DB_ExitOnMySQLError (const char *Message);
 
@@ -26,10 +26,13 @@
 /*****************************************************************************/
 
 #define _GNU_SOURCE		// For vasprintf
+#include <ctype.h>		// For isalnum
+#include <linux/limits.h>	// For PATH_MAX
 #include <stdio.h>		// For vasprintf
-#include <stdlib.h>		// For free
+#include <stdlib.h>		// For free, getenv, setenv
 #include <string.h>		// For string functions
 #include <time.h>		// For time functions (mktime...)
+#include <unistd.h>		// For access
 
 #include "swad_box.h"
 #include "swad_calendar.h"
@@ -70,6 +73,11 @@ const char *Dat_TimeStatusClassHidden[Dat_NUM_TIME_STATUS] =
 /**************************** Private constants ******************************/
 /*****************************************************************************/
 
+#define Dat_PATH_TZ_DATABASE "/usr/share/zoneinfo"	// Used when TZDIR is not set
+
+#define Dat_SECONDS_TO_CHECK_TIME_ZONE (60UL * 60UL)	// A change of UTC offset undone before this time is not detected.
+							// In the tz database changes are days apart
+
 static const unsigned Dat_NumDaysMonth[1 + 12] =
   {
    [ 0] =  0,
@@ -98,6 +106,11 @@ static const unsigned Dat_NumDaysMonth[1 + 12] =
 static void Dat_PutIconsDateFormat (__attribute__((unused)) void *Args);
 static unsigned Dat_GetParamDateFormat (void);
 
+static bool Dat_CheckIfTimeZoneIsInOS (const char *TimeZone);
+static long Dat_GetUTCOffset (time_t TimeUTC);
+static bool Dat_AddTimeZoneChange (struct Dat_TimeZoneChanges *Changes,
+                                   time_t TimeUTC,long Offset);
+
 /*****************************************************************************/
 /******************************** Reset date *********************************/
 /*****************************************************************************/
@@ -843,6 +856,237 @@ void Dat_GetBrowserTimeZone (char BrowserTimeZone[Dat_MAX_BYTES_TIME_ZONE + 1])
      }
   }
 
+/*****************************************************************************/
+/********** Get the changes of UTC offset of a time zone in a range **********/
+/*****************************************************************************/
+// TimeZone may be a name in the tz database (for example "Europe/Madrid")
+// or a fixed offset in +hh:mm or -hh:mm format.
+// Offsets are got from the tz database of the operating system,
+// so they are right before and after Daylight Saving Time changes.
+// Return false if the time zone is unknown
+
+bool Dat_GetTimeZoneChanges (const char *TimeZone,
+                             time_t StartTimeUTC,time_t EndTimeUTC,
+                             struct Dat_TimeZoneChanges *Changes)
+  {
+   unsigned Hours;
+   unsigned Minutes;
+   long Offset;
+   long NextOffset;
+   time_t Time;
+   time_t NextTime;
+   time_t Lo;
+   time_t Hi;
+   char *OldTZ = NULL;
+   char TZ[1 + Dat_MAX_BYTES_TIME_ZONE + 1];
+   bool Ok = true;
+
+   Changes->Num = 0;
+
+   /***** Time zone with a fixed offset *****/
+   if (TimeZone[0] == '+' ||
+       TimeZone[0] == '-')
+     {
+      if (sscanf (&TimeZone[1],"%u:%u",&Hours,&Minutes) != 2)
+	 return false;
+      Offset = (long) (Hours * 60 * 60 + Minutes * 60);
+      return Dat_AddTimeZoneChange (Changes,StartTimeUTC,
+				    TimeZone[0] == '-' ? -Offset :
+							  Offset);
+     }
+
+   /***** Time zone in the tz database of the operating system *****/
+   if (!Dat_CheckIfTimeZoneIsInOS (TimeZone))
+      return false;
+
+   /* Save current time zone and set the time zone to check */
+   if (getenv ("TZ"))
+      if ((OldTZ = strdup (getenv ("TZ"))) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+   snprintf (TZ,sizeof (TZ),":%s",TimeZone);
+   setenv ("TZ",TZ,1);
+   tzset ();
+
+   /* Offset at the start of the range */
+   Offset = Dat_GetUTCOffset (StartTimeUTC);
+   Ok = Dat_AddTimeZoneChange (Changes,StartTimeUTC,Offset);
+
+   /* Check offset hour by hour, so two changes in the same day are found.
+      When offset changes, search the exact second of the change
+      and go on checking from that second, not from the end of the hour */
+   for (Time = StartTimeUTC;
+	Ok && Time < EndTimeUTC;
+	Time = NextTime)
+     {
+      NextTime = Time + (time_t) Dat_SECONDS_TO_CHECK_TIME_ZONE;
+      if (NextTime > EndTimeUTC)
+	 NextTime = EndTimeUTC;
+      if (Dat_GetUTCOffset (NextTime) != Offset)
+	{
+	 for (Lo = Time, Hi = NextTime;
+	      Hi - Lo > 1;)
+	    if (Dat_GetUTCOffset (Lo + (Hi - Lo) / 2) == Offset)
+	       Lo = Lo + (Hi - Lo) / 2;
+	    else
+	       Hi = Lo + (Hi - Lo) / 2;
+	 NextOffset = Dat_GetUTCOffset (Hi);
+	 Ok = Dat_AddTimeZoneChange (Changes,Hi,NextOffset);
+	 Offset = NextOffset;
+	 NextTime = Hi;
+	}
+     }
+
+   /* Restore time zone */
+   if (OldTZ)
+     {
+      setenv ("TZ",OldTZ,1);
+      free (OldTZ);
+     }
+   else
+      unsetenv ("TZ");
+   tzset ();
+
+   return Ok;
+  }
+
+/*****************************************************************************/
+/************ Check if a time zone is in the tz database of the OS ***********/
+/*****************************************************************************/
+// The name comes from the browser, so it's checked before being used as a path
+
+static bool Dat_CheckIfTimeZoneIsInOS (const char *TimeZone)
+  {
+   const char *Ptr;
+   const char *TZDir;
+   char PathFile[PATH_MAX + 1];
+
+   /***** Only letters, digits, '_', '+', '-' and '/' are allowed *****/
+   if (!TimeZone[0] ||
+       TimeZone[0] == '/' ||
+       strstr (TimeZone,".."))
+      return false;
+   for (Ptr = TimeZone;
+	*Ptr;
+	Ptr++)
+      if (!isalnum ((unsigned char) *Ptr) &&
+	  *Ptr != '_' && *Ptr != '+' && *Ptr != '-' && *Ptr != '/')
+	 return false;
+
+   /***** Check if the file of the time zone exists *****/
+   if ((TZDir = getenv ("TZDIR")) == NULL)
+      TZDir = Dat_PATH_TZ_DATABASE;
+   snprintf (PathFile,sizeof (PathFile),"%s/%s",TZDir,TimeZone);
+   return access (PathFile,R_OK) == 0;
+  }
+
+/*****************************************************************************/
+/************ Get UTC offset of current time zone at a given time ************/
+/*****************************************************************************/
+// Local time - UTC, in seconds
+
+static long Dat_GetUTCOffset (time_t TimeUTC)
+  {
+   struct tm tm;
+
+   if (localtime_r (&TimeUTC,&tm) == NULL)
+      return 0;
+   return tm.tm_gmtoff;
+  }
+
+/*****************************************************************************/
+/*********************** Add a change of UTC offset **************************/
+/*****************************************************************************/
+// Return false if there is no space for more changes
+
+static bool Dat_AddTimeZoneChange (struct Dat_TimeZoneChanges *Changes,
+                                   time_t TimeUTC,long Offset)
+  {
+   if (Changes->Num >= Dat_MAX_TIME_ZONE_CHANGES)
+      return false;
+
+   Changes->TimeUTC[Changes->Num] = TimeUTC;
+   Changes->Offset [Changes->Num] = Offset;
+   Changes->Num++;
+   return true;
+  }
+
+/*****************************************************************************/
+/**** Get the greatest number of seconds that divides all offsets/changes ****/
+/*****************************************************************************/
+// Clicks grouped by UTC intervals of this size can be moved to local time
+// adding a single offset to each interval
+
+unsigned Dat_GetSecondsPerTimeZoneInterval (const struct Dat_TimeZoneChanges *Changes)
+  {
+   static const unsigned Intervals[] =
+     {
+      60 * 60,	// Hour
+      60,	// Minute
+     };
+   unsigned NumInterval;
+   unsigned NumChange;
+   bool Divides;
+
+   for (NumInterval = 0;
+	NumInterval < sizeof (Intervals) / sizeof (Intervals[0]);
+	NumInterval++)
+     {
+      for (NumChange = 0, Divides = true;
+	   Divides && NumChange < Changes->Num;
+	   NumChange++)
+	 Divides = (Changes->Offset[NumChange] % (long) Intervals[NumInterval] == 0) &&
+		   (NumChange == 0 ||	// First time is the start of the range
+		    Changes->TimeUTC[NumChange] % (time_t) Intervals[NumInterval] == 0);
+      if (Divides)
+	 return Intervals[NumInterval];
+     }
+
+   return 1;	// Second
+  }
+
+/*****************************************************************************/
+/****** Build a database expression with local time from a UTC time **********/
+/*****************************************************************************/
+// UTCTimeExpr is an expression with seconds since the UNIX epoch.
+// The offset of each time is got from the changes of UTC offset,
+// avoiding the use of CONVERT_TZ for each row.
+// LocalTime must be freed by the caller
+
+void Dat_BuildLocalTimeExpression (const struct Dat_TimeZoneChanges *Changes,
+                                   const char *UTCTimeExpr,
+                                   char **LocalTime)
+  {
+   size_t MaxLength;
+   unsigned NumChange;
+   char *Ptr;
+
+   /***** Allocate space for expression *****/
+   MaxLength = 128 + (Changes->Num + 1) * (strlen (UTCTimeExpr) + 64);
+   if ((*LocalTime = (char *) malloc (MaxLength + 1)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Local time = UTC time + offset *****/
+   Ptr = *LocalTime;
+   Ptr += sprintf (Ptr,"DATE_ADD('1970-01-01',INTERVAL (%s+",UTCTimeExpr);
+   if (Changes->Num <= 1)
+      Ptr += sprintf (Ptr,"%ld",Changes->Num ? Changes->Offset[0] :
+					       0L);
+   else
+     {
+      Ptr += sprintf (Ptr,"CASE");
+      for (NumChange = 1;
+	   NumChange < Changes->Num;
+	   NumChange++)
+	 Ptr += sprintf (Ptr," WHEN %s<%ld THEN %ld",
+			 UTCTimeExpr,
+			 (long) Changes->TimeUTC[NumChange],
+			 Changes->Offset[NumChange - 1]);
+      Ptr += sprintf (Ptr," ELSE %ld END",
+		      Changes->Offset[Changes->Num - 1]);
+     }
+   sprintf (Ptr,") SECOND)");
+  }
+
 /*****************************************************************************/
 /************************* Show a form to enter a date ***********************/
 /*****************************************************************************/
@@ -37,10 +37,13 @@
 /***************************** Public constants ******************************/
 /*****************************************************************************/
 
+#define Dat_SECONDS_IN_ONE_DAY (24UL * 60UL * 60UL)
 #define Dat_SECONDS_IN_ONE_MONTH (30UL * 24UL * 60UL * 60UL)
 
 #define Dat_MAX_BYTES_TIME_ZONE 256
 
+#define Dat_MAX_TIME_ZONE_CHANGES 256	// Two changes per year are usual
+
 #define Dat_MAX_BYTES_TIME (128 - 1)
 
 /*****************************************************************************/
@@ -103,6 +106,14 @@ typedef enum
    Dat_HMS_TO_235959  = 2,
   } Dat_SetHMS;
 
+/***** Changes of UTC offset of a time zone in a range of time *****/
+struct Dat_TimeZoneChanges
+  {
+   unsigned Num;					// Number of changes
+   time_t TimeUTC[Dat_MAX_TIME_ZONE_CHANGES];	// First is the start of the range
+   long Offset[Dat_MAX_TIME_ZONE_CHANGES];	// Local time - UTC, in seconds, from this time
+  };
+
 /***** Date format *****/
 #define Dat_NUM_OPTIONS_FORMAT 3
 typedef enum
@@ -163,6 +174,13 @@ time_t Dat_GetTimeUTCFromForm (const char *ParamName);
 
 void Dat_PutHiddenParBrowserTZDiff (void);
 void Dat_GetBrowserTimeZone (char BrowserTimeZone[Dat_MAX_BYTES_TIME_ZONE + 1]);
+bool Dat_GetTimeZoneChanges (const char *TimeZone,
+                             time_t StartTimeUTC,time_t EndTimeUTC,
+                             struct Dat_TimeZoneChanges *Changes);
+unsigned Dat_GetSecondsPerTimeZoneInterval (const struct Dat_TimeZoneChanges *Changes);
+void Dat_BuildLocalTimeExpression (const struct Dat_TimeZoneChanges *Changes,
+                                   const char *UTCTimeExpr,
+                                   char **LocalTime);
 
 void Dat_WriteFormDate (unsigned FirstYear,unsigned LastYear,
 	                const char *Id,
@@ -38,9 +38,11 @@
 #include "swad_form.h"
 #include "swad_forum.h"
 #include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_logo.h"
 #include "swad_message.h"
+#include "swad_search_index.h"
 #include "swad_survey.h"
 
 /*****************************************************************************/
@@ -94,7 +96,6 @@ static void Deg_PutIconsEditingDegrees (__attribute__((unused)) void *Args);
 static void Deg_ReceiveFormRequestOrCreateDeg (unsigned Status);
 static void Deg_PutParamOtherDegCod (long DegCod);
 
-static void Deg_GetDataOfDegreeFromRow (struct Degree *Deg,MYSQL_ROW row);
 
 static void Deg_UpdateDegNameDB (long DegCod,const char *FieldName,const char *NewDegName);
 
@@ -786,6 +787,9 @@ static void Deg_CreateDegree (unsigned Status)
 				Deg_EditingDeg->ShrtName,
 				Deg_EditingDeg->FullName,
 				Deg_EditingDeg->WWW);
+
+   /***** Index name of new degree for searches *****/
+   SchIdx_IndexRow (SchIdx_DEG_NAME,Deg_EditingDeg->DegCod);
   }
 
 /*****************************************************************************/
@@ -1370,7 +1374,7 @@ bool Deg_GetDataOfDegreeByCod (struct Degree *Deg)
 /********** Get data of a degree from a row resulting of a query *************/
 /*****************************************************************************/
 
-static void Deg_GetDataOfDegreeFromRow (struct Degree *Deg,MYSQL_ROW row)
+void Deg_GetDataOfDegreeFromRow (struct Degree *Deg,MYSQL_ROW row)
   {
    /***** Get degree code (row[0]) *****/
    if ((Deg->DegCod = Str_ConvertStrCodToLongCod (row[0])) < 0)
@@ -1551,10 +1555,14 @@ void Deg_RemoveDegreeCompletely (long DegCod)
 		   "DELETE FROM admin WHERE Scope='%s' AND Cod=%ld",
                    Sco_GetDBStrFromScope (Hie_DEG),DegCod);
 
+   /***** Remove the degree from search index *****/
+   SchIdx_RemoveRow (SchIdx_DEG_NAME,DegCod);
+
    /***** Remove the degree *****/
    DB_QueryDELETE ("can not remove a degree",
 		   "DELETE FROM degrees WHERE DegCod=%ld",
 		   DegCod);
+   HieSnp_InvalidateSnapshot ();
 
    /***** Flush caches *****/
    Crs_FlushCacheNumCrssInDeg ();
@@ -1686,6 +1694,10 @@ static void Deg_UpdateDegNameDB (long DegCod,const char *FieldName,const char *N
    DB_QueryUPDATE ("can not update the name of a degree",
 		   "UPDATE degrees SET %s='%s' WHERE DegCod=%ld",
 	           FieldName,NewDegName,DegCod);
+   HieSnp_InvalidateSnapshot ();
+
+   /***** Update degree name in search index *****/
+   SchIdx_IndexRow (SchIdx_DEG_NAME,DegCod);
   }
 
 /*****************************************************************************/
@@ -1714,6 +1726,7 @@ void Deg_ChangeDegreeType (void)
    DB_QueryUPDATE ("can not update the type of a degree",
 		   "UPDATE degrees SET DegTypCod=%ld WHERE DegCod=%ld",
 	           NewDegTypCod,Deg_EditingDeg->DegCod);
+   HieSnp_InvalidateSnapshot ();
    Deg_EditingDeg->DegTypCod = NewDegTypCod;
 
    /***** Create alert to show the change made
@@ -1773,6 +1786,7 @@ void Deg_UpdateDegWWWDB (long DegCod,const char NewWWW[Cns_MAX_BYTES_WWW + 1])
    DB_QueryUPDATE ("can not update the web of a degree",
 		   "UPDATE degrees SET WWW='%s' WHERE DegCod=%ld",
 	           NewWWW,DegCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -1810,6 +1824,7 @@ void Deg_ChangeDegStatus (void)
    DB_QueryUPDATE ("can not update the status of a degree",
 		   "UPDATE degrees SET Status=%u WHERE DegCod=%ld",
                    (unsigned) Status,Deg_EditingDeg->DegCod);
+   HieSnp_InvalidateSnapshot ();
    Deg_EditingDeg->Status = Status;
 
    /***** Write alert to show the change made
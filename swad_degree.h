@@ -115,6 +115,7 @@ void Deg_PutParamDegCod (long DegCod);
 long Deg_GetAndCheckParamOtherDegCod (long MinCodAllowed);
 
 bool Deg_GetDataOfDegreeByCod (struct Degree *Deg);
+void Deg_GetDataOfDegreeFromRow (struct Degree *Deg,MYSQL_ROW row);
 void Deg_GetShortNameOfDegreeByCod (struct Degree *Deg);
 long Deg_GetCtrCodOfDegreeByCod (long DegCod);
 long Deg_GetInsCodOfDegreeByCod (long DegCod);
@@ -33,6 +33,7 @@
 #include "swad_global.h"
 #include "swad_help.h"
 #include "swad_hierarchy_config.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_logo.h"
 
@@ -405,6 +406,7 @@ static void DegCfg_UpdateDegCtrDB (long DegCod,long CtrCod)
    DB_QueryUPDATE ("can not update the centre of a degree",
 		   "UPDATE degrees SET CtrCod=%ld WHERE DegCod=%ld",
                    CtrCod,DegCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -25,6 +25,10 @@
 /*********************************** Headers *********************************/
 /*****************************************************************************/
 
+#include <stdio.h>		// For sscanf, snprintf
+#include <stdlib.h>		// For malloc, free, qsort
+#include <string.h>		// For strcmp, strlen
+
 #include "swad_account.h"
 #include "swad_box.h"
 #include "swad_database.h"
@@ -33,6 +37,7 @@
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
+#include "swad_ID.h"
 #include "swad_layout.h"
 #include "swad_profile.h"
 #include "swad_role_type.h"
@@ -46,10 +51,52 @@
 /***************************** Private constants *****************************/
 /*****************************************************************************/
 
+/*
+   Table usr_dup_keys stores some keys of each user
+   (pronunciation of name, words of name sorted, beginning of IDs).
+   Users sharing any key with a given user are candidates to be similar,
+   so candidates are got using the index of usr_dup_keys,
+   and then they are scored comparing the words of their names.
+   Keys are updated when a user is created, renamed or his/her IDs change.
+   Keys of users existing before the table are stored in background,
+   and the table is not used until all the keys are stored.
+*/
+#define Dup_NUM_KEY_TYPES 3
+
+#define Dup_MAX_BYTES_KEY	255
+
+#define Dup_LENGTH_ID_PREFIX	8	// Number of characters at the beginning of an ID used as key
+
+#define Dup_MAX_TOKENS_IN_NAME	16	// Maximum number of words in first name and surnames
+
+#define Dup_MAX_USRS_PER_BATCH	1000	// Maximum number of users whose keys are stored in background each time
+#define Dup_MAX_CANDIDATES	1000	// Maximum number of candidates got from database
+#define Dup_MAX_SIMILAR_USRS	  50	// Maximum number of similar users listed
+#define Dup_MIN_SCORE		  50	// Minimum score of a candidate to be listed as similar
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
 
+typedef enum
+  {
+   Dup_KEY_PHONETIC_NAME = 0,	// Pronunciation of first surname and first name
+   Dup_KEY_SORTED_NAME   = 1,	// Words of first name and surnames sorted
+   Dup_KEY_ID_PREFIX     = 2,	// Beginning of ID
+  } Dup_KeyType_t;
+
+struct Dup_Tokens
+  {
+   unsigned Num;
+   char Token[Dup_MAX_TOKENS_IN_NAME][Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME + 1];
+  };
+
+struct Dup_Candidate
+  {
+   long UsrCod;
+   unsigned Score;
+  };
+
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
 /*****************************************************************************/
@@ -65,6 +112,17 @@ extern struct Globals Gbl;
 /*****************************************************************************/
 
 static void Dup_ListSimilarUsrs (void);
+static bool Dup_CheckIfAllKeysAreStored (void);
+static unsigned Dup_GetSimilarUsrsUsingKeys (const struct UsrData *UsrDat,
+                                             struct Dup_Candidate **Candidates);
+static unsigned Dup_GetSimilarUsrsWithoutKeys (const struct UsrData *UsrDat,
+                                               struct Dup_Candidate **Candidates);
+static unsigned Dup_GetScore (unsigned MatchedKeys,
+                              const struct Dup_Tokens *Tokens,
+                              const struct Dup_Tokens *TokensCandidate);
+static unsigned Dup_GetNumCommonTokens (const struct Dup_Tokens *Tokens1,
+                                        const struct Dup_Tokens *Tokens2);
+static int Dup_CompareCandidates (const void *p1,const void *p2);
 
 static bool Dup_CheckIfUsrIsDup (long UsrCod);
 
@@ -72,6 +130,24 @@ static void Dup_PutButtonToViewSimilarUsrs (const struct UsrData *UsrDat);
 static void Dup_PutButtonToEliminateUsrAccount (const struct UsrData *UsrDat);
 static void Dup_PutButtonToRemoveFromListOfDupUsrs (const struct UsrData *UsrDat);
 
+static void Dup_InsertNameKey (long UsrCod,Dup_KeyType_t KeyType,
+                               const char *FirstName,
+                               const char *Surname1,
+                               const char *Surname2);
+static void Dup_InsertIDKey (long UsrCod,const char *UsrID);
+static void Dup_InsertKey (long UsrCod,Dup_KeyType_t KeyType,const char *Key);
+static void Dup_GetTokensOfName (const char *FirstName,
+                                 const char *Surname1,
+                                 const char *Surname2,
+                                 struct Dup_Tokens *Tokens);
+static void Dup_GetSortedNameKey (const struct Dup_Tokens *Tokens,
+                                  char Key[Dup_MAX_BYTES_KEY + 1]);
+static int Dup_CompareTokens (const void *p1,const void *p2);
+static void Dup_GetPhoneticNameKey (const struct Dup_Tokens *Tokens,
+                                    const char *Surname1,
+                                    char Key[Dup_MAX_BYTES_KEY + 1]);
+static void Dup_GetPhoneticCode (const char *Word,char *Code,size_t MaxLength);
+
 /*****************************************************************************/
 /******************** Report a user as possible duplicate ********************/
 /*****************************************************************************/
@@ -259,8 +335,7 @@ static void Dup_ListSimilarUsrs (void)
    extern const char *Hlp_USERS_Duplicates_similar_users;
    extern const char *Txt_Similar_users;
    struct UsrData UsrDat;
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
+   struct Dup_Candidate *Candidates;
    unsigned NumUsrs;
    unsigned NumUsr;
 
@@ -269,26 +344,11 @@ static void Dup_ListSimilarUsrs (void)
                  NULL,NULL,
                  Hlp_USERS_Duplicates_similar_users,Box_NOT_CLOSABLE);
 
-   /***** Make query *****/
-   if (Gbl.Usrs.Other.UsrDat.Surname1[0] &&
-       Gbl.Usrs.Other.UsrDat.FirstName[0])	// Name and surname 1 not empty
-      NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get similar users",
-					   "SELECT DISTINCT UsrCod FROM"
-					   "(SELECT DISTINCT UsrCod FROM usr_IDs"
-					   " WHERE UsrID IN (SELECT UsrID FROM usr_IDs WHERE UsrCod=%ld)"
-					   " UNION"
-					   " SELECT UsrCod FROM usr_data"
-					   " WHERE Surname1='%s' AND Surname2='%s' AND FirstName='%s')"
-					   " AS U",
-					   Gbl.Usrs.Other.UsrDat.UsrCod,
-					   Gbl.Usrs.Other.UsrDat.Surname1,
-					   Gbl.Usrs.Other.UsrDat.Surname2,
-					   Gbl.Usrs.Other.UsrDat.FirstName);
+   /***** Get similar users *****/
+   if (Dup_CheckIfAllKeysAreStored ())
+      NumUsrs = Dup_GetSimilarUsrsUsingKeys (&Gbl.Usrs.Other.UsrDat,&Candidates);
    else
-      NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get similar users",
-					   "SELECT DISTINCT UsrCod FROM usr_IDs"
-					   " WHERE UsrID IN (SELECT UsrID FROM usr_IDs WHERE UsrCod=%ld)",
-					   Gbl.Usrs.Other.UsrDat.UsrCod);
+      NumUsrs = Dup_GetSimilarUsrsWithoutKeys (&Gbl.Usrs.Other.UsrDat,&Candidates);
 
    /***** List possible similar users *****/
    if (NumUsrs)
@@ -311,10 +371,8 @@ static void Dup_ListSimilarUsrs (void)
            NumUsr < NumUsrs;
            NumUsr++)
         {
-         row = mysql_fetch_row (mysql_res);
-
-         /* Get user code (row[0]) */
-         UsrDat.UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+         /* Get user code */
+         UsrDat.UsrCod = Candidates[NumUsr].UsrCod;
          if (Usr_ChkUsrCodAndGetAllUsrDataFromUsrCod (&UsrDat,Usr_DONT_GET_PREFS))
            {
             /* Get if user has accepted all his/her courses */
@@ -379,13 +437,250 @@ static void Dup_ListSimilarUsrs (void)
       /***** Show warning indicating no users found *****/
       Usr_ShowWarningNoUsersFound (Rol_UNK);
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free list of similar users *****/
+   free (Candidates);
 
    /***** End box *****/
    Box_BoxEnd ();
   }
 
+/*****************************************************************************/
+/************* Check if keys of all users are stored in database *************/
+/*****************************************************************************/
+
+static bool Dup_CheckIfAllKeysAreStored (void)
+  {
+   return (DB_QueryCOUNT ("can not check if keys of users are stored",
+			  "SELECT COUNT(*) FROM usr_dup_indexed"
+			  " WHERE Complete='Y'") == Dup_NUM_KEY_TYPES);
+  }
+
+/*****************************************************************************/
+/************* Get users similar to a given one using their keys *************/
+/*****************************************************************************/
+// Candidates are the users sharing some key with the given user.
+// They are scored and sorted from the most similar to the least similar.
+// Candidates must be freed by the caller
+
+static unsigned Dup_GetSimilarUsrsUsingKeys (const struct UsrData *UsrDat,
+                                             struct Dup_Candidate **Candidates)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   struct Dup_Tokens Tokens;
+   struct Dup_Tokens TokensCandidate;
+   unsigned NumRows;
+   unsigned NumRow;
+   unsigned NumUsrs = 0;
+   unsigned MatchedKeys;
+   unsigned Score;
+
+   /***** Get candidates sharing some key with the user *****/
+   NumRows = (unsigned) DB_QuerySELECT (&mysql_res,"can not get similar users",
+				        "SELECT usr_data.UsrCod,"
+				               "BIT_OR(1<<k2.KeyType),"
+				               "usr_data.FirstName,"
+				               "usr_data.Surname1,"
+				               "usr_data.Surname2"
+				        " FROM usr_dup_keys AS k1,"
+				              "usr_dup_keys AS k2,"
+				              "usr_data"
+				        " WHERE k1.UsrCod=%ld"
+				        " AND k2.KeyType=k1.KeyType"
+				        " AND k2.DupKey=k1.DupKey"
+				        " AND k2.UsrCod=usr_data.UsrCod"
+				        " GROUP BY usr_data.UsrCod"
+				        " ORDER BY COUNT(DISTINCT k2.KeyType) DESC"
+				        " LIMIT %u",
+				        UsrDat->UsrCod,
+				        Dup_MAX_CANDIDATES);
+
+   /***** Score candidates *****/
+   *Candidates = NULL;
+   if (NumRows)
+     {
+      if ((*Candidates = (struct Dup_Candidate *) malloc (NumRows *
+                                                          sizeof (struct Dup_Candidate))) == NULL)
+         Lay_NotEnoughMemoryExit ();
+
+      Dup_GetTokensOfName (UsrDat->FirstName,UsrDat->Surname1,UsrDat->Surname2,
+                           &Tokens);
+      for (NumRow = 0;
+	   NumRow < NumRows;
+	   NumRow++)
+	{
+	 row = mysql_fetch_row (mysql_res);
+
+	 /* Get keys shared with the user (row[1])
+	    and first name and surnames (row[2], row[3], row[4]) */
+	 if (sscanf (row[1],"%u",&MatchedKeys) != 1)
+	    MatchedKeys = 0;
+	 Dup_GetTokensOfName (row[2],row[3],row[4],&TokensCandidate);
+
+	 /* Candidates not similar enough are discarded */
+	 if ((Score = Dup_GetScore (MatchedKeys,&Tokens,&TokensCandidate)) >= Dup_MIN_SCORE)
+	   {
+	    /* Get user code (row[0]) */
+	    (*Candidates)[NumUsrs].UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	    (*Candidates)[NumUsrs].Score  = Score;
+	    NumUsrs++;
+	   }
+	}
+
+      /***** Sort candidates from the most similar to the least similar *****/
+      qsort (*Candidates,(size_t) NumUsrs,sizeof (struct Dup_Candidate),
+             Dup_CompareCandidates);
+      if (NumUsrs > Dup_MAX_SIMILAR_USRS)
+	 NumUsrs = Dup_MAX_SIMILAR_USRS;
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return NumUsrs;
+  }
+
+/*****************************************************************************/
+/********* Get users similar to a given one using names and IDs only *********/
+/*****************************************************************************/
+// Used while keys of all users are not stored yet.
+// Candidates must be freed by the caller
+
+static unsigned Dup_GetSimilarUsrsWithoutKeys (const struct UsrData *UsrDat,
+                                               struct Dup_Candidate **Candidates)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumUsrs;
+   unsigned NumUsr;
+
+   /***** Make query *****/
+   if (UsrDat->Surname1[0] &&
+       UsrDat->FirstName[0])	// Name and surname 1 not empty
+      NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get similar users",
+					   "SELECT DISTINCT UsrCod FROM"
+					   "(SELECT DISTINCT UsrCod FROM usr_IDs"
+					   " WHERE UsrID IN (SELECT UsrID FROM usr_IDs WHERE UsrCod=%ld)"
+					   " UNION"
+					   " SELECT UsrCod FROM usr_data"
+					   " WHERE Surname1='%s' AND Surname2='%s' AND FirstName='%s')"
+					   " AS U",
+					   UsrDat->UsrCod,
+					   UsrDat->Surname1,
+					   UsrDat->Surname2,
+					   UsrDat->FirstName);
+   else
+      NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get similar users",
+					   "SELECT DISTINCT UsrCod FROM usr_IDs"
+					   " WHERE UsrID IN (SELECT UsrID FROM usr_IDs WHERE UsrCod=%ld)",
+					   UsrDat->UsrCod);
+
+   /***** Get users' codes *****/
+   *Candidates = NULL;
+   if (NumUsrs)
+     {
+      if ((*Candidates = (struct Dup_Candidate *) malloc (NumUsrs *
+                                                          sizeof (struct Dup_Candidate))) == NULL)
+         Lay_NotEnoughMemoryExit ();
+
+      for (NumUsr = 0;
+	   NumUsr < NumUsrs;
+	   NumUsr++)
+	{
+	 row = mysql_fetch_row (mysql_res);
+
+	 /* Get user code (row[0]) */
+	 (*Candidates)[NumUsr].UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	 (*Candidates)[NumUsr].Score  = 0;
+	}
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return NumUsrs;
+  }
+
+/*****************************************************************************/
+/********* Get how similar a candidate is to a user (the higher the more) ****/
+/*****************************************************************************/
+
+static unsigned Dup_GetScore (unsigned MatchedKeys,
+                              const struct Dup_Tokens *Tokens,
+                              const struct Dup_Tokens *TokensCandidate)
+  {
+   unsigned MaxNumTokens;
+   unsigned Score = 0;
+
+   /***** Words in common in first name and surnames (0 to 100) *****/
+   MaxNumTokens = (Tokens->Num > TokensCandidate->Num) ? Tokens->Num :
+							 TokensCandidate->Num;
+   if (MaxNumTokens)
+      Score = 100 * Dup_GetNumCommonTokens (Tokens,TokensCandidate) / MaxNumTokens;
+
+   /***** Names that sound alike *****/
+   if (MatchedKeys & (1 << Dup_KEY_PHONETIC_NAME))
+      Score += 25;
+
+   /***** IDs beginning by the same characters *****/
+   if (MatchedKeys & (1 << Dup_KEY_ID_PREFIX))
+      Score += 100;
+
+   return Score;
+  }
+
+/*****************************************************************************/
+/************** Get number of words in common in two names *******************/
+/*****************************************************************************/
+
+static unsigned Dup_GetNumCommonTokens (const struct Dup_Tokens *Tokens1,
+                                        const struct Dup_Tokens *Tokens2)
+  {
+   bool Used[Dup_MAX_TOKENS_IN_NAME];
+   unsigned NumToken1;
+   unsigned NumToken2;
+   unsigned NumCommonTokens = 0;
+
+   for (NumToken2 = 0;
+	NumToken2 < Tokens2->Num;
+	NumToken2++)
+      Used[NumToken2] = false;
+
+   for (NumToken1 = 0;
+	NumToken1 < Tokens1->Num;
+	NumToken1++)
+      for (NumToken2 = 0;
+	   NumToken2 < Tokens2->Num;
+	   NumToken2++)
+	 if (!Used[NumToken2] &&
+	     !strcmp (Tokens1->Token[NumToken1],Tokens2->Token[NumToken2]))
+	   {
+	    Used[NumToken2] = true;
+	    NumCommonTokens++;
+	    break;
+	   }
+
+   return NumCommonTokens;
+  }
+
+/*****************************************************************************/
+/***** Compare two candidates to sort them from the most similar to the least */
+/*****************************************************************************/
+
+static int Dup_CompareCandidates (const void *p1,const void *p2)
+  {
+   const struct Dup_Candidate *Candidate1 = (const struct Dup_Candidate *) p1;
+   const struct Dup_Candidate *Candidate2 = (const struct Dup_Candidate *) p2;
+
+   if (Candidate1->Score > Candidate2->Score)
+      return -1;
+   if (Candidate1->Score < Candidate2->Score)
+      return 1;
+   return (Candidate1->UsrCod < Candidate2->UsrCod) ? -1 :
+	  (Candidate1->UsrCod > Candidate2->UsrCod ?  1 :
+						      0);
+  }
+
 /*****************************************************************************/
 /********** Check if a user is in list of possible duplicate users ***********/
 /*****************************************************************************/
@@ -474,3 +769,474 @@ void Dup_RemoveUsrFromDuplicated (long UsrCod)
    DB_QueryDELETE ("can not remove a user from possible duplicates",
 		   "DELETE FROM usr_duplicated WHERE UsrCod=%ld",UsrCod);
   }
+
+/*****************************************************************************/
+/********** Update the keys used to find users similar to a user *************/
+/*****************************************************************************/
+// Call this function after a user is created,
+// or after his/her name or his/her IDs are changed
+
+void Dup_UpdateUsrKeys (long UsrCod)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumIDs;
+   unsigned NumID;
+
+   /***** Remove old keys *****/
+   Dup_RemoveUsrKeys (UsrCod);
+
+   /***** Insert keys from first name and surnames *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get user's name",
+		       "SELECT FirstName,Surname1,Surname2"
+		       " FROM usr_data WHERE UsrCod=%ld",
+		       UsrCod))
+     {
+      row = mysql_fetch_row (mysql_res);
+      Dup_InsertNameKey (UsrCod,Dup_KEY_PHONETIC_NAME,row[0],row[1],row[2]);
+      Dup_InsertNameKey (UsrCod,Dup_KEY_SORTED_NAME  ,row[0],row[1],row[2]);
+     }
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Insert keys from IDs *****/
+   NumIDs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get user's IDs",
+				       "SELECT UsrID FROM usr_IDs"
+				       " WHERE UsrCod=%ld",
+				       UsrCod);
+   for (NumID = 0;
+	NumID < NumIDs;
+	NumID++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      Dup_InsertIDKey (UsrCod,row[0]);
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/*********** Remove the keys used to find users similar to a user ************/
+/*****************************************************************************/
+
+void Dup_RemoveUsrKeys (long UsrCod)
+  {
+   DB_QueryDELETE ("can not remove keys of a user",
+		   "DELETE FROM usr_dup_keys WHERE UsrCod=%ld",
+		   UsrCod);
+  }
+
+/*****************************************************************************/
+/*************** Store keys of users existing before the keys ****************/
+/*****************************************************************************/
+// Keys of each type are got in ascending order of user's code,
+// a batch of users each time
+
+void Dup_StoreKeysOfNextUsrs (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   Dup_KeyType_t KeyType;
+   unsigned UnsignedNum;
+   long LastUsrCod;
+   long UsrCod;
+   long LastUsrCodInBatch;
+   unsigned NumRows;
+   unsigned NumRow;
+   bool Complete;
+
+   /***** Create progress of types of keys not yet stored *****/
+   for (KeyType  = (Dup_KeyType_t) 0;
+	KeyType <= (Dup_KeyType_t) (Dup_NUM_KEY_TYPES - 1);
+	KeyType++)
+      DB_QueryINSERT ("can not create progress of keys of users",
+		      "INSERT IGNORE INTO usr_dup_indexed"
+		      " (KeyType,LastUsrCod,Complete)"
+		      " VALUES"
+		      " (%u,0,'N')",
+		      (unsigned) KeyType);
+
+   /***** Get the first type of keys not completely stored *****/
+   if (!DB_QuerySELECT (&mysql_res,"can not get progress of keys of users",
+			"SELECT KeyType,LastUsrCod FROM usr_dup_indexed"
+			" WHERE Complete='N'"
+			" ORDER BY KeyType LIMIT 1"))
+     {
+      DB_FreeMySQLResult (&mysql_res);
+      return;	// All keys are stored
+     }
+   row = mysql_fetch_row (mysql_res);
+
+   /* Get type of key (row[0]) */
+   if (sscanf (row[0],"%u",&UnsignedNum) != 1)
+      Lay_ShowErrorAndExit ("Error when getting progress of keys of users.");
+   if (UnsignedNum >= Dup_NUM_KEY_TYPES)
+      Lay_ShowErrorAndExit ("Wrong type of key of users.");
+   KeyType = (Dup_KeyType_t) UnsignedNum;
+
+   /* Get last user's code (row[1]) */
+   LastUsrCod = Str_ConvertStrCodToLongCod (row[1]);
+
+   /* Free structure that stores the query result */
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Store keys of next users.
+	  Keys are only inserted (never removed) here, so if a user
+	  is changed at the same time, his/her new keys are not lost *****/
+   switch (KeyType)
+     {
+      case Dup_KEY_PHONETIC_NAME:
+      case Dup_KEY_SORTED_NAME:
+	 NumRows = (unsigned) DB_QuerySELECT (&mysql_res,"can not get users' names",
+					      "SELECT UsrCod,FirstName,Surname1,Surname2"
+					      " FROM usr_data"
+					      " WHERE UsrCod>%ld"
+					      " ORDER BY UsrCod LIMIT %u",
+					      LastUsrCod,Dup_MAX_USRS_PER_BATCH);
+	 for (NumRow = 0;
+	      NumRow < NumRows;
+	      NumRow++)
+	   {
+	    row = mysql_fetch_row (mysql_res);
+
+	    /* Get user's code (row[0]) and name (row[1], row[2], row[3]) */
+	    if ((UsrCod = Str_ConvertStrCodToLongCod (row[0])) > 0)
+	      {
+	       Dup_InsertNameKey (UsrCod,KeyType,row[1],row[2],row[3]);
+	       LastUsrCod = UsrCod;
+	      }
+	   }
+	 break;
+      case Dup_KEY_ID_PREFIX:
+      default:
+	 NumRows = (unsigned) DB_QuerySELECT (&mysql_res,"can not get users' IDs",
+					      "SELECT UsrCod,UsrID"
+					      " FROM usr_IDs"
+					      " WHERE UsrCod>%ld"
+					      " ORDER BY UsrCod LIMIT %u",
+					      LastUsrCod,Dup_MAX_USRS_PER_BATCH);
+
+	 /* When the batch is full, IDs of its last user may be incomplete,
+	    so they are left for the next batch,
+	    except if all the IDs in the batch are of the same user */
+	 LastUsrCodInBatch = -1L;
+	 if (NumRows == Dup_MAX_USRS_PER_BATCH)
+	   {
+	    row = mysql_fetch_row (mysql_res);
+	    UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	    mysql_data_seek (mysql_res,(my_ulonglong) (NumRows - 1));
+	    row = mysql_fetch_row (mysql_res);
+	    if ((LastUsrCodInBatch = Str_ConvertStrCodToLongCod (row[0])) == UsrCod)
+	       LastUsrCodInBatch = -1L;
+	    mysql_data_seek (mysql_res,0);
+	   }
+
+	 for (NumRow = 0;
+	      NumRow < NumRows;
+	      NumRow++)
+	   {
+	    row = mysql_fetch_row (mysql_res);
+
+	    /* Get user's code (row[0]) and ID (row[1]) */
+	    if ((UsrCod = Str_ConvertStrCodToLongCod (row[0])) == LastUsrCodInBatch)
+	       break;
+	    if (UsrCod > 0)
+	      {
+	       Dup_InsertIDKey (UsrCod,row[1]);
+	       LastUsrCod = UsrCod;
+	      }
+	   }
+	 break;
+     }
+   Complete = (NumRows < Dup_MAX_USRS_PER_BATCH);
+
+   /* Free structure that stores the query result */
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Update progress *****/
+   DB_QueryUPDATE ("can not update progress of keys of users",
+		   "UPDATE usr_dup_indexed"
+		   " SET LastUsrCod=%ld,Complete='%c'"
+		   " WHERE KeyType=%u",
+		   LastUsrCod,
+		   Complete ? 'Y' :
+			      'N',
+		   (unsigned) KeyType);
+  }
+
+/*****************************************************************************/
+/************** Insert a key got from the name of a user *********************/
+/*****************************************************************************/
+
+static void Dup_InsertNameKey (long UsrCod,Dup_KeyType_t KeyType,
+                               const char *FirstName,
+                               const char *Surname1,
+                               const char *Surname2)
+  {
+   struct Dup_Tokens Tokens;
+   char Key[Dup_MAX_BYTES_KEY + 1];
+
+   /***** Get key *****/
+   Dup_GetTokensOfName (FirstName,Surname1,Surname2,&Tokens);
+   switch (KeyType)
+     {
+      case Dup_KEY_PHONETIC_NAME:
+	 Dup_GetPhoneticNameKey (&Tokens,Surname1,Key);
+	 break;
+      case Dup_KEY_SORTED_NAME:
+	 Dup_GetSortedNameKey (&Tokens,Key);
+	 break;
+      default:
+	 return;
+     }
+
+   /***** Insert key *****/
+   Dup_InsertKey (UsrCod,KeyType,Key);
+  }
+
+/*****************************************************************************/
+/**************** Insert a key got from an ID of a user **********************/
+/*****************************************************************************/
+// The key is the beginning of the ID without leading zeros,
+// so IDs with or without the final letter or leading zeros share a key
+
+static void Dup_InsertIDKey (long UsrCod,const char *UsrID)
+  {
+   char Key[ID_MAX_BYTES_USR_ID + 1];
+
+   /***** Get key *****/
+   Str_Copy (Key,UsrID,
+             ID_MAX_BYTES_USR_ID);
+   Str_RemoveLeadingZeros (Key);
+   Str_ConvertToUpperText (Key);
+   if (strlen (Key) > Dup_LENGTH_ID_PREFIX)
+      Key[Dup_LENGTH_ID_PREFIX] = '\0';
+
+   /***** Insert key *****/
+   Dup_InsertKey (UsrCod,Dup_KEY_ID_PREFIX,Key);
+  }
+
+/*****************************************************************************/
+/************************** Insert a key of a user ***************************/
+/*****************************************************************************/
+
+static void Dup_InsertKey (long UsrCod,Dup_KeyType_t KeyType,const char *Key)
+  {
+   if (Key[0])	// Empty keys are not stored
+      DB_QueryINSERT ("can not store key of a user",
+		      "INSERT IGNORE INTO usr_dup_keys"
+		      " (UsrCod,KeyType,DupKey)"
+		      " VALUES"
+		      " (%ld,%u,'%s')",
+		      UsrCod,(unsigned) KeyType,Key);
+  }
+
+/*****************************************************************************/
+/************** Get the words of the first name and surnames *****************/
+/*****************************************************************************/
+// Words are converted to be comparable (lowercase, without tildes)
+
+static void Dup_GetTokensOfName (const char *FirstName,
+                                 const char *Surname1,
+                                 const char *Surname2,
+                                 struct Dup_Tokens *Tokens)
+  {
+   const char *Names[3];
+   unsigned NumName;
+   char Name[Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME + 1];
+   char *Ptr;
+   const char *PtrName;
+
+   Names[0] = FirstName;
+   Names[1] = Surname1;
+   Names[2] = Surname2;
+
+   Tokens->Num = 0;
+   for (NumName = 0;
+	NumName < 3;
+	NumName++)
+      if (Names[NumName])
+	{
+	 /***** Convert name to comparable *****/
+	 Str_Copy (Name,Names[NumName],
+		   Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+	 Str_ConvertToComparable (Name);
+	 for (Ptr = Name;
+	      *Ptr;
+	      Ptr++)
+	    if (*Ptr == '\'' || *Ptr == '\\' || *Ptr == '-')
+	       *Ptr = ' ';
+
+	 /***** Split name into words *****/
+	 for (PtrName = Name;
+	      Tokens->Num < Dup_MAX_TOKENS_IN_NAME;
+	      Tokens->Num++)
+	   {
+	    Str_GetNextStringUntilSpace (&PtrName,Tokens->Token[Tokens->Num],
+					 Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+	    if (!Tokens->Token[Tokens->Num][0])	// No more words
+	       break;
+	   }
+	}
+  }
+
+/*****************************************************************************/
+/********** Get a key with the words of a name sorted alphabetically *********/
+/*****************************************************************************/
+// Users with the same words in different fields
+// (for example first name and surname swapped) share this key
+
+static void Dup_GetSortedNameKey (const struct Dup_Tokens *Tokens,
+                                  char Key[Dup_MAX_BYTES_KEY + 1])
+  {
+   const char *SortedTokens[Dup_MAX_TOKENS_IN_NAME];
+   unsigned NumToken;
+
+   /***** Sort words *****/
+   for (NumToken = 0;
+	NumToken < Tokens->Num;
+	NumToken++)
+      SortedTokens[NumToken] = Tokens->Token[NumToken];
+   qsort (SortedTokens,(size_t) Tokens->Num,sizeof (SortedTokens[0]),
+          Dup_CompareTokens);
+
+   /***** Join words *****/
+   Key[0] = '\0';
+   for (NumToken = 0;
+	NumToken < Tokens->Num;
+	NumToken++)
+     {
+      if (NumToken)
+	 Str_Concat (Key," ",
+	             Dup_MAX_BYTES_KEY);
+      Str_Concat (Key,SortedTokens[NumToken],
+                  Dup_MAX_BYTES_KEY);
+     }
+  }
+
+static int Dup_CompareTokens (const void *p1,const void *p2)
+  {
+   return strcmp (*(const char **) p1,*(const char **) p2);
+  }
+
+/*****************************************************************************/
+/****** Get a key with the pronunciation of first surname and first name *****/
+/*****************************************************************************/
+// Users whose first surname and first name sound alike share this key
+
+static void Dup_GetPhoneticNameKey (const struct Dup_Tokens *Tokens,
+                                    const char *Surname1,
+                                    char Key[Dup_MAX_BYTES_KEY + 1])
+  {
+   char Surname[Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME + 1];
+   char PhoneticSurname[Dup_MAX_BYTES_KEY / 2 + 1];
+   char PhoneticName[Dup_MAX_BYTES_KEY / 2 + 1];
+
+   Key[0] = '\0';
+
+   /***** Both first name and first surname are needed *****/
+   if (!Tokens->Num || !Surname1)
+      return;
+
+   /***** Get pronunciation of first surname (all its words)
+          and pronunciation of the first word of first name *****/
+   Str_Copy (Surname,Surname1,
+             Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+   Str_ConvertToComparable (Surname);
+   Dup_GetPhoneticCode (Surname,PhoneticSurname,Dup_MAX_BYTES_KEY / 2);
+   Dup_GetPhoneticCode (Tokens->Token[0],PhoneticName,Dup_MAX_BYTES_KEY / 2);
+   if (!PhoneticSurname[0] || !PhoneticName[0])
+      return;
+
+   snprintf (Key,Dup_MAX_BYTES_KEY + 1,"%s %s",PhoneticSurname,PhoneticName);
+  }
+
+/*****************************************************************************/
+/******************* Get a code with the sound of a word *********************/
+/*****************************************************************************/
+// Word must be comparable (lowercase, without tildes).
+// Letters with the same sound in Spanish get the same code,
+// silent letters and characters other than letters are skipped,
+// and repeated sounds are written once
+
+static void Dup_GetPhoneticCode (const char *Word,char *Code,size_t MaxLength)
+  {
+   const unsigned char *Ptr;
+   char Sound;
+   char LastSound = '\0';
+   size_t Length = 0;
+
+   for (Ptr = (const unsigned char *) Word;
+	*Ptr && Length < MaxLength;
+	Ptr++)
+     {
+      switch (*Ptr)
+	{
+	 case 'b':
+	 case 'v':
+	 case 'w':
+	    Sound = 'b';
+	    break;
+	 case 'c':
+	    if (Ptr[1] == 'h')				// "ch"
+	      {
+	       Sound = 'C';
+	       Ptr++;
+	      }
+	    else if (Ptr[1] == 'e' || Ptr[1] == 'i')	// "ce", "ci"
+	       Sound = 's';
+	    else
+	       Sound = 'k';
+	    break;
+	 case 'g':
+	    if (Ptr[1] == 'e' || Ptr[1] == 'i')		// "ge", "gi"
+	       Sound = 'j';
+	    else
+	      {
+	       Sound = 'g';
+	       if (Ptr[1] == 'u' &&
+		   (Ptr[2] == 'e' || Ptr[2] == 'i'))	// "gue", "gui"
+		  Ptr++;
+	      }
+	    break;
+	 case 'h':					// Silent
+	    Sound = '\0';
+	    break;
+	 case 'k':
+	 case 'q':
+	    Sound = 'k';
+	    if (*Ptr == 'q' && Ptr[1] == 'u')		// "qu"
+	       Ptr++;
+	    break;
+	 case 'l':
+	    if (Ptr[1] == 'l')				// "ll"
+	      {
+	       Sound = 'y';
+	       Ptr++;
+	      }
+	    else
+	       Sound = 'l';
+	    break;
+	 case 'y':
+	    Sound = (Ptr[1] == 'a' || Ptr[1] == 'e' || Ptr[1] == 'i' ||
+		     Ptr[1] == 'o' || Ptr[1] == 'u') ? 'y' :	// Consonant
+						       'i';	// Vowel
+	    break;
+	 case 'z':
+	    Sound = 's';
+	    break;
+	 case (unsigned char) '\xF1':			// ''
+	    Sound = 'N';
+	    break;
+	 default:
+	    Sound = (*Ptr >= 'a' && *Ptr <= 'z') ? (char) *Ptr :
+						   '\0';
+	    break;
+	}
+
+      if (Sound && Sound != LastSound)
+	{
+	 Code[Length++] = Sound;
+	 LastSound = Sound;
+	}
+     }
+   Code[Length] = '\0';
+  }
@@ -49,4 +49,8 @@ void Dup_GetUsrCodAndListSimilarUsrs (void);
 void Dup_RemoveUsrFromListDupUsrs (void);
 void Dup_RemoveUsrFromDuplicated (long UsrCod);
 
+void Dup_UpdateUsrKeys (long UsrCod);
+void Dup_RemoveUsrKeys (long UsrCod);
+void Dup_StoreKeysOfNextUsrs (void);
+
 #endif
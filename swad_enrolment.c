@@ -48,6 +48,7 @@
 #include "swad_parameter.h"
 #include "swad_photo.h"
 #include "swad_role.h"
+#include "swad_search_index.h"
 #include "swad_test_print.h"
 #include "swad_user.h"
 
@@ -579,6 +580,12 @@ void Enr_UpdateUsrData (struct UsrData *UsrDat)
 	           UsrDat->Comments ? UsrDat->Comments :
 				      "",
 	           UsrDat->UsrCod);
+
+   /***** Update user's name in search index *****/
+   SchIdx_IndexRow (SchIdx_USR_NAME,UsrDat->UsrCod);
+
+   /***** Update keys to find users similar to this one *****/
+   Dup_UpdateUsrKeys (UsrDat->UsrCod);
   }
 
 /*****************************************************************************/
@@ -4155,7 +4162,7 @@ static void Enr_EffectivelyRemUsrFromCrs (struct UsrData *UsrDat,
          Gbl.Usrs.Me.UsrDat.Accepted     = false;
 
          /* Fill the list with the courses I belong to */
-         Gbl.Usrs.Me.MyCrss.Filled = false;
+         Usr_FreeMyCourses ();
          Usr_GetMyCourses ();
 
          /* Set my roles */
@@ -43,6 +43,7 @@
 #include "swad_exam_type.h"
 #include "swad_form.h"
 #include "swad_global.h"
+#include "swad_random.h"
 
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
@@ -429,32 +430,44 @@ static unsigned ExaPrn_GetSomeQstsFromSetToPrint (struct ExaPrn_Print *Print,
   {
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
-   unsigned NumQstsInSet;
-   unsigned NumQstInSet;
+   struct Rnd_Generator Generator;
+   unsigned long NumQstsInSet;
+   unsigned long NumQstsToPrint;
+   unsigned long NumQstInSet;
+   unsigned long *Indexes;
    Tst_AnswerType_t AnswerType;
    bool Shuffle;
 
-   /***** Get questions from database *****/
-   NumQstsInSet = (unsigned)
-		  DB_QuerySELECT (&mysql_res,"can not get questions from set",
+   /***** Get all questions in set from database *****/
+   NumQstsInSet = DB_QuerySELECT (&mysql_res,"can not get questions from set",
 				  "SELECT QstCod,"	// row[0]
 					 "AnsType,"	// row[1]
 					 "Shuffle"	// row[2]
 				  " FROM exa_set_questions"
 				  " WHERE SetCod=%ld"
-				  " ORDER BY RAND()"	// Don't use RAND(NOW()) because the same ordering will be repeated across sets
-				  " LIMIT %u",
-				  Set->SetCod,
-				  Set->NumQstsToPrint);
+				  " ORDER BY QstCod",
+				  Set->SetCod);
+
+   /***** Draw questions to print.
+          The seed depends on session, user and set,
+          so the same questions would be drawn again for this print,
+          but different questions are drawn for other users or sets *****/
+   Rnd_SetSeed (&Generator,Print->SesCod);
+   Rnd_AddToSeed (&Generator,Print->UsrCod);
+   Rnd_AddToSeed (&Generator,Set->SetCod);
+   NumQstsToPrint = Rnd_GetSample (&Generator,NumQstsInSet,
+                                   (unsigned long) Set->NumQstsToPrint,
+                                   &Indexes);
 
    /***** Questions in this set *****/
    for (NumQstInSet = 0;
-	NumQstInSet < NumQstsInSet;
+	NumQstInSet < NumQstsToPrint;
 	NumQstInSet++, (*NumQstInPrint)++)
      {
       Gbl.RowEvenOdd = 1 - Gbl.RowEvenOdd;
 
       /***** Get question data *****/
+      mysql_data_seek (mysql_res,(my_ulonglong) Indexes[NumQstInSet]);
       row = mysql_fetch_row (mysql_res);
       /*
       row[0] QstCod
@@ -503,7 +516,13 @@ static unsigned ExaPrn_GetSomeQstsFromSetToPrint (struct ExaPrn_Print *Print,
       Print->PrintedQuestions[*NumQstInPrint].Score = 0.0;
      }
 
-   return NumQstsInSet;
+   /***** Free list of drawn questions *****/
+   free (Indexes);
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return (unsigned) NumQstsToPrint;
   }
 
 /*****************************************************************************/
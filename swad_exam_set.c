@@ -2243,10 +2243,13 @@ static void ExaSet_ExchangeSets (long ExaCod,
    long SetCodTop;
    long SetCodBottom;
 
-   /***** Lock table to make the move atomic *****/
-   DB_Query ("can not lock tables to exchange sets of questions",
-	     "LOCK TABLES exa_sets WRITE");
-   Gbl.DB.LockedTables = true;
+   /***** Lock the exam to make the move atomic *****/
+   // Only the sets of this exam are blocked, not the whole table of sets
+   DB_StartTransactionLockingRows ("can not lock exam to exchange sets of questions",
+				   "SELECT ExaCod FROM exa_exams"
+				   " WHERE ExaCod=%ld"
+				   " FOR UPDATE",
+				   ExaCod);
 
    /***** Get set codes of the sets to be moved *****/
    SetCodTop    = ExaSet_GetSetCodFromSetInd (ExaCod,SetIndTop);
@@ -2288,11 +2291,8 @@ static void ExaSet_ExchangeSets (long ExaCod,
 		   SetIndBottom,
 		   ExaCod,SetCodTop);
 
-   /***** Unlock table *****/
-   Gbl.DB.LockedTables = false;	// Set to false before the following unlock...
-				// ...to not retry the unlock if error in unlocking
-   DB_Query ("can not unlock tables after exchanging sets of questions",
-	     "UNLOCK TABLES");
+   /***** Commit changes and unlock the exam *****/
+   DB_CommitTransaction ();
   }
 
 /*****************************************************************************/
@@ -33,15 +33,19 @@
 #include "swad_action.h"
 #include "swad_box.h"
 #include "swad_database.h"
+#include "swad_date.h"
 #include "swad_figure.h"
 #include "swad_figure_cache.h"
+#include "swad_figure_snapshot.h"
 #include "swad_file_browser.h"
 #include "swad_follow.h"
 #include "swad_form.h"
 #include "swad_forum.h"
+#include "swad_fragment_cache.h"
 #include "swad_global.h"
 #include "swad_hierarchy.h"
 #include "swad_HTML.h"
+#include "swad_icon.h"
 #include "swad_institution.h"
 #include "swad_logo.h"
 #include "swad_message.h"
@@ -102,6 +106,9 @@ static void Fig_ReqShowFigure (Fig_FigureType_t SelectedFigureType);
 static void Fig_PutHiddenParamFigureType (Fig_FigureType_t FigureType);
 static void Fig_PutHiddenParamScopeFig (Hie_Level_t ScopeFig);
 
+static void Fig_ComputeAndShowFigure (Fig_FigureType_t FigureType);
+static void Fig_ShowTimeOfSnapshot (Fig_FigureType_t FigureType,time_t TimeUTC);
+
 static void Fig_GetAndShowHierarchyStats (void);
 static void Fig_WriteHeadHierarchy (void);
 static void Fig_GetAndShowHierarchyWithInss (void);
@@ -323,6 +330,37 @@ static void Fig_PutHiddenParamScopeFig (Hie_Level_t ScopeFig)
 /*****************************************************************************/
 
 void Fig_ShowFigures (void)
+  {
+   Fig_FigureType_t SelectedFigureType;
+   FigSnp_Mode_t Mode;
+   time_t TimeSnapshot;
+
+   /***** Get the type of figure ******/
+   SelectedFigureType = (Fig_FigureType_t)
+		        Par_GetParToUnsignedLong ("FigureType",
+						  0,
+						  Fig_NUM_FIGURES - 1,
+						  (unsigned long) Fig_FIGURE_TYPE_DEF);
+
+   /***** Recompute the figure or get it from snapshot? *****/
+   Mode = Par_GetParToBool ("Recompute") ? FigSnp_RECOMPUTE :
+					   FigSnp_GET_FROM_SNAPSHOT;
+
+   /***** Show again the form to see use of the platform *****/
+   Fig_ReqShowFigure (SelectedFigureType);
+
+   /***** Show the stat of use selected by user *****/
+   FigSnp_BeginFigure (SelectedFigureType,Gbl.Scope.Current,Mode);
+   Fig_ComputeAndShowFigure (SelectedFigureType);
+   if ((TimeSnapshot = FigSnp_EndFigure ()))
+      Fig_ShowTimeOfSnapshot (SelectedFigureType,TimeSnapshot);
+  }
+
+/*****************************************************************************/
+/************************ Compute and show a figure **************************/
+/*****************************************************************************/
+
+static void Fig_ComputeAndShowFigure (Fig_FigureType_t FigureType)
   {
    static void (*Fig_Function[Fig_NUM_FIGURES])(void) =	// Array of pointers to functions
      {
@@ -356,21 +394,106 @@ void Fig_ShowFigures (void)
       [Fig_SIDE_COLUMNS     ] = Fig_GetAndShowNumUsrsPerSideColumns,
       [Fig_PRIVACY          ] = Fig_GetAndShowNumUsrsPerPrivacy,
       [Fig_COOKIES          ] = Fig_GetAndShowNumUsrsPerCookies,
+      [Fig_FRAGMENT_CACHE   ] = Frg_GetAndShowFragmentCacheStats,
      };
-   Fig_FigureType_t SelectedFigureType;
 
-   /***** Get the type of figure ******/
-   SelectedFigureType = (Fig_FigureType_t)
-		        Par_GetParToUnsignedLong ("FigureType",
-						  0,
-						  Fig_NUM_FIGURES - 1,
-						  (unsigned long) Fig_FIGURE_TYPE_DEF);
+   Fig_Function[FigureType] ();
+  }
 
-   /***** Show again the form to see use of the platform *****/
-   Fig_ReqShowFigure (SelectedFigureType);
+/*****************************************************************************/
+/********* Show when a figure was computed and button to recompute it ********/
+/*****************************************************************************/
 
-   /***** Show the stat of use selected by user *****/
-   Fig_Function[SelectedFigureType] ();
+static void Fig_ShowTimeOfSnapshot (Fig_FigureType_t FigureType,time_t TimeUTC)
+  {
+   extern const char *The_ClassFormInBox[The_NUM_THEMES];
+   extern const char *The_ClassFormLinkInBoxBold[The_NUM_THEMES];
+   extern const char *Txt_Last_update;
+   extern const char *Txt_Update;
+   struct Fig_Figures Figures;
+
+   /***** Begin container *****/
+   HTM_DIV_Begin ("class=\"CM\"");
+
+   /***** Time of the oldest result used in the figure *****/
+   HTM_SPAN_Begin ("class=\"%s\"",The_ClassFormInBox[Gbl.Prefs.Theme]);
+   HTM_TxtColonNBSP (Txt_Last_update);
+   HTM_SPAN_End ();
+   HTM_SPAN_Begin ("id=\"fig_snapshot_time\" class=\"DAT\"");
+   HTM_SPAN_End ();
+   Dat_WriteLocalDateHMSFromUTC ("fig_snapshot_time",TimeUTC,
+				 Gbl.Prefs.DateFormat,Dat_SEPARATOR_COMMA,
+				 true,true,false,0x6);
+
+   /***** Button to recompute the figure *****/
+   Frm_StartForm (ActSeeUseGbl);
+   Figures.Scope      = Gbl.Scope.Current;
+   Figures.FigureType = FigureType;
+   Fig_PutHiddenParamFigures (&Figures);
+   Par_PutHiddenParamChar ("Recompute",'Y');
+   HTM_BUTTON_Animated_Begin (Txt_Update,
+			      The_ClassFormLinkInBoxBold[Gbl.Prefs.Theme],
+			      NULL);
+   Ico_PutCalculateIconWithText (Txt_Update);
+   HTM_BUTTON_End ();
+   Frm_EndForm ();
+
+   /***** End container *****/
+   HTM_DIV_End ();
+  }
+
+/*****************************************************************************/
+/******* Update the snapshot of the oldest figure for the whole system *******/
+/*****************************************************************************/
+// This is a slow function, run from time to time
+// in a worker process started by a refresh process.
+// Only one process updates snapshots at a time
+
+void Fig_UpdateOldestSnapshotInSystem (void)
+  {
+   static const char *LockName = "swad_fig_snapshots";
+   Fig_FigureType_t FigureType;
+   FILE *FileNull;
+   FILE *FileOut;
+   Hie_Level_t Scope;
+
+   /***** Another process is updating snapshots ==> nothing to do *****/
+   if (!DB_GetNamedLock (LockName))
+      return;
+
+   /***** Remove snapshots too old to be used *****/
+   FigSnp_RemoveOldSnapshots ();
+
+   /***** Get the system-wide figure not updated for a longer time *****/
+   if (!FigSnp_GetOldestFigureInSystem (&FigureType))
+     {
+      DB_ReleaseNamedLock (LockName);
+      return;
+     }
+
+   /***** Figures are shown while they are computed,
+          so write them to nowhere *****/
+   if ((FileNull = fopen ("/dev/null","w")) == NULL)
+     {
+      DB_ReleaseNamedLock (LockName);
+      return;
+     }
+   FileOut = Gbl.F.Out;
+   Gbl.F.Out = FileNull;
+   Scope = Gbl.Scope.Current;
+   Gbl.Scope.Current = Hie_SYS;
+
+   /***** Recompute figure and store it in snapshot *****/
+   FigSnp_BeginFigure (FigureType,Hie_SYS,FigSnp_RECOMPUTE);
+   Fig_ComputeAndShowFigure (FigureType);
+   FigSnp_EndFigure ();
+
+   /***** Restore output and scope *****/
+   Gbl.Scope.Current = Scope;
+   Gbl.F.Out = FileOut;
+   fclose (FileNull);
+
+   DB_ReleaseNamedLock (LockName);
   }
 
 /*****************************************************************************/
@@ -1071,35 +1194,35 @@ static void Fig_GetAndShowInssOrderedByNumCtrs (void)
      {
       case Hie_SYS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT InsCod,COUNT(*) AS N"
-				    " FROM centres"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC");
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT InsCod,COUNT(*) AS N"
+					" FROM centres"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC");
          break;
       case Hie_CTY:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM institutions,centres"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Cty.CtyCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM institutions,centres"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
       case Hie_CTR:
       case Hie_DEG:
       case Hie_CRS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT InsCod,COUNT(*) AS N"
-				    " FROM centres"
-				    " WHERE InsCod=%ld"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Ins.InsCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT InsCod,COUNT(*) AS N"
+					" FROM centres"
+					" WHERE InsCod=%ld"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -1137,38 +1260,38 @@ static void Fig_GetAndShowInssOrderedByNumDegs (void)
      {
       case Hie_SYS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM centres,degrees"
-				    " WHERE centres.CtrCod=degrees.CtrCod"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC");
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM centres,degrees"
+					" WHERE centres.CtrCod=degrees.CtrCod"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC");
          break;
       case Hie_CTY:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM institutions,centres,degrees"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Cty.CtyCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM institutions,centres,degrees"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
       case Hie_CTR:
       case Hie_DEG:
       case Hie_CRS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM centres,degrees"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Ins.InsCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM centres,degrees"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -1206,41 +1329,41 @@ static void Fig_GetAndShowInssOrderedByNumCrss (void)
      {
       case Hie_SYS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM centres,degrees,courses"
-				    " WHERE centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC");
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM centres,degrees,courses"
+					" WHERE centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC");
          break;
       case Hie_CTY:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM institutions,centres,degrees,courses"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Cty.CtyCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM institutions,centres,degrees,courses"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
       case Hie_CTR:
       case Hie_DEG:
       case Hie_CRS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(*) AS N"
-				    " FROM centres,degrees,courses"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Ins.InsCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(*) AS N"
+					" FROM centres,degrees,courses"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -1278,44 +1401,44 @@ static void Fig_GetAndShowInssOrderedByNumUsrsInCrss (void)
      {
       case Hie_SYS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
-				    " FROM centres,degrees,courses,crs_usr"
-				    " WHERE centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC");
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
+					" FROM centres,degrees,courses,crs_usr"
+					" WHERE centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC");
          break;
       case Hie_CTY:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
-				    " FROM institutions,centres,degrees,courses,crs_usr"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Cty.CtyCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
+					" FROM institutions,centres,degrees,courses,crs_usr"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
       case Hie_CTR:
       case Hie_DEG:
       case Hie_CRS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
-				    " FROM centres,degrees,courses,crs_usr"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " GROUP BY centres.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Ins.InsCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT centres.InsCod,COUNT(DISTINCT crs_usr.UsrCod) AS N"
+					" FROM centres,degrees,courses,crs_usr"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" GROUP BY centres.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -1354,36 +1477,36 @@ static void Fig_GetAndShowInssOrderedByNumUsrsWhoClaimToBelongToThem (void)
      {
       case Hie_SYS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT InsCod,COUNT(*) AS N"
-				    " FROM usr_data"
-				    " WHERE InsCod>0"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC");
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT InsCod,COUNT(*) AS N"
+					" FROM usr_data"
+					" WHERE InsCod>0"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC");
          break;
       case Hie_CTY:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT usr_data.InsCod,COUNT(*) AS N"
-				    " FROM institutions,usr_data"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=usr_data.InsCod"
-				    " GROUP BY usr_data.InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Cty.CtyCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT usr_data.InsCod,COUNT(*) AS N"
+					" FROM institutions,usr_data"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=usr_data.InsCod"
+					" GROUP BY usr_data.InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
       case Hie_CTR:
       case Hie_DEG:
       case Hie_CRS:
 	 NumInss =
-	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
-				    "SELECT InsCod,COUNT(*) AS N"
-				    " FROM usr_data"
-				    " WHERE InsCod=%ld"
-				    " GROUP BY InsCod"
-				    " ORDER BY N DESC",
-				    Gbl.Hierarchy.Ins.InsCod);
+	 (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get institutions",
+					"SELECT InsCod,COUNT(*) AS N"
+					" FROM usr_data"
+					" WHERE InsCod=%ld"
+					" GROUP BY InsCod"
+					" ORDER BY N DESC",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -1647,107 +1770,107 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT Cod AS CrsCod,"
-				      "-1 AS GrpCod,"
-				      "NumLevels,"
-				      "NumFolders,"
-				      "NumFiles,"
-				      "TotalSize"
-			       " FROM file_browser_size"
-			       " WHERE FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-				      "file_browser_size.Cod AS GrpCod,"
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT Cod AS CrsCod,"
+					  "-1 AS GrpCod,"
+					  "NumLevels,"
+					  "NumFolders,"
+					  "NumFiles,"
+					  "TotalSize"
+				   " FROM file_browser_size"
+				   " WHERE FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT Cod),"
-				      "-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM file_browser_size"
-			       " WHERE FileBrowser=%u",
-			       (unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT Cod),"
+					  "-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM file_browser_size"
+				   " WHERE FileBrowser=%u",
+				   (unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-	                       " AND file_browser_size.FileBrowser=%u",
-			       (unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   (unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT Cod),"
-				      "-1,"
-				      "COUNT(DISTINCT ZoneUsrCod),"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM file_browser_size"
-			       " WHERE FileBrowser=%u",
-			       (unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT Cod),"
+					  "-1,"
+					  "COUNT(DISTINCT ZoneUsrCod),"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM file_browser_size"
+				   " WHERE FileBrowser=%u",
+				   (unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT ZoneUsrCod),"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM file_browser_size"
-			       " WHERE FileBrowser=%u",
-			       (unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT ZoneUsrCod),"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM file_browser_size"
+				   " WHERE FileBrowser=%u",
+				   (unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -1759,140 +1882,140 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT file_browser_size.Cod AS CrsCod,"
-				      "-1 AS GrpCod,"				// Course zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM institutions,centres,degrees,courses,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-			       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-				      "file_browser_size.Cod AS GrpCod,"	// Group zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM institutions,centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-	                       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       Gbl.Hierarchy.Cty.CtyCod,
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       Gbl.Hierarchy.Cty.CtyCod,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT file_browser_size.Cod AS CrsCod,"
+					  "-1 AS GrpCod,"                           // Course zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM institutions,centres,degrees,courses,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"        // Group zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM institutions,centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   Gbl.Hierarchy.Cty.CtyCod,
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   Gbl.Hierarchy.Cty.CtyCod,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM institutions,centres,degrees,courses,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-	                       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " and file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM institutions,centres,degrees,courses,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " and file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM institutions,centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-	                       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM institutions,centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM institutions,centres,degrees,courses,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-	                       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-	                       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM institutions,centres,degrees,courses,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM institutions,centres,degrees,courses,crs_usr,file_browser_size"
-			       " WHERE institutions.CtyCod=%ld"
-	                       " AND institutions.InsCod=centres.InsCod"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_usr.CrsCod"
-			       " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM institutions,centres,degrees,courses,crs_usr,file_browser_size"
+				   " WHERE institutions.CtyCod=%ld"
+				   " AND institutions.InsCod=centres.InsCod"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_usr.CrsCod"
+				   " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Cty.CtyCod,(unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -1904,134 +2027,134 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT file_browser_size.Cod AS CrsCod,"
-				      "-1 AS GrpCod,"				// Course zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM centres,degrees,courses,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-				      "file_browser_size.Cod AS GrpCod,"	// Group zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       Gbl.Hierarchy.Ins.InsCod,
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       Gbl.Hierarchy.Ins.InsCod,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT file_browser_size.Cod AS CrsCod,"
+					  "-1 AS GrpCod,"                           // Course zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM centres,degrees,courses,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"        // Group zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   Gbl.Hierarchy.Ins.InsCod,
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   Gbl.Hierarchy.Ins.InsCod,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM centres,degrees,courses,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " and file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM centres,degrees,courses,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " and file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM centres,degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM centres,degrees,courses,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-	                       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM centres,degrees,courses,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM centres,degrees,courses,crs_usr,file_browser_size"
-			       " WHERE centres.InsCod=%ld"
-			       " AND centres.CtrCod=degrees.CtrCod"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_usr.CrsCod"
-			       " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM centres,degrees,courses,crs_usr,file_browser_size"
+				   " WHERE centres.InsCod=%ld"
+				   " AND centres.CtrCod=degrees.CtrCod"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_usr.CrsCod"
+				   " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ins.InsCod,(unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -2043,128 +2166,128 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT file_browser_size.Cod AS CrsCod,"
-				      "-1 AS GrpCod,"				// Course zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM degrees,courses,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-				      "file_browser_size.Cod AS GrpCod,"	// Group zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       Gbl.Hierarchy.Ctr.CtrCod,
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       Gbl.Hierarchy.Ctr.CtrCod,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT file_browser_size.Cod AS CrsCod,"
+					  "-1 AS GrpCod,"                           // Course zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM degrees,courses,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"        // Group zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   Gbl.Hierarchy.Ctr.CtrCod,
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   Gbl.Hierarchy.Ctr.CtrCod,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM degrees,courses,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM degrees,courses,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
                break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM degrees,courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM degrees,courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
                break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM degrees,courses,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM degrees,courses,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM degrees,courses,crs_usr,file_browser_size"
-			       " WHERE degrees.CtrCod=%ld"
-			       " AND degrees.DegCod=courses.DegCod"
-			       " AND courses.CrsCod=crs_usr.CrsCod"
-			       " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM degrees,courses,crs_usr,file_browser_size"
+				   " WHERE degrees.CtrCod=%ld"
+				   " AND degrees.DegCod=courses.DegCod"
+				   " AND courses.CrsCod=crs_usr.CrsCod"
+				   " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Ctr.CtrCod,(unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -2176,122 +2299,122 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT file_browser_size.Cod AS CrsCod,"
-				      "-1 AS GrpCod,"				// Course zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM courses,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-	                              "file_browser_size.Cod AS GrpCod,"	// Group zones
-			              "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       Gbl.Hierarchy.Deg.DegCod,
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       Gbl.Hierarchy.Deg.DegCod,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT file_browser_size.Cod AS CrsCod,"
+					  "-1 AS GrpCod,"                           // Course zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM courses,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"        // Group zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   Gbl.Hierarchy.Deg.DegCod,
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   Gbl.Hierarchy.Deg.DegCod,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM courses,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM courses,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM courses,crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=crs_grp_types.CrsCod"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM courses,crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=crs_grp_types.CrsCod"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM courses,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM courses,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM courses,crs_usr,file_browser_size"
-			       " WHERE courses.DegCod=%ld"
-			       " AND courses.CrsCod=crs_usr.CrsCod"
-			       " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM courses,crs_usr,file_browser_size"
+				   " WHERE courses.DegCod=%ld"
+				   " AND courses.CrsCod=crs_usr.CrsCod"
+				   " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Deg.DegCod,(unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -2303,114 +2426,114 @@ static void Fig_GetSizeOfFileZoneFromDB (Hie_Level_t Scope,
 	 switch (FileBrowser)
 	   {
 	    case Brw_UNKNOWN:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT CrsCod),"
-				      "COUNT(DISTINCT GrpCod)-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM "
-	                       "("
-	                       "SELECT Cod AS CrsCod,"
-				      "-1 AS GrpCod,"				// Course zones
-				      "NumLevels,"
-				      "NumFolders,"
-				      "NumFiles,"
-				      "TotalSize"
-			       " FROM file_browser_size"
-			       " WHERE Cod=%ld"
-			       " AND FileBrowser IN (%u,%u,%u,%u,%u,%u)"
-	                       " UNION "
-	                       "SELECT crs_grp_types.CrsCod,"
-				      "file_browser_size.Cod AS GrpCod,"	// Group zones
-				      "file_browser_size.NumLevels,"
-				      "file_browser_size.NumFolders,"
-				      "file_browser_size.NumFiles,"
-				      "file_browser_size.TotalSize"
-			       " FROM crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE crs_grp_types.CrsCod=%ld"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
-			       ") AS sizes",
-			       Gbl.Hierarchy.Crs.CrsCod,
-			       (unsigned) Brw_ADMI_DOC_CRS,
-			       (unsigned) Brw_ADMI_TCH_CRS,
-			       (unsigned) Brw_ADMI_SHR_CRS,
-			       (unsigned) Brw_ADMI_ASG_USR,
-			       (unsigned) Brw_ADMI_WRK_USR,
-			       (unsigned) Brw_ADMI_MRK_CRS,
-			       Gbl.Hierarchy.Crs.CrsCod,
-			       (unsigned) Brw_ADMI_DOC_GRP,
-			       (unsigned) Brw_ADMI_TCH_GRP,
-			       (unsigned) Brw_ADMI_SHR_GRP,
-			       (unsigned) Brw_ADMI_MRK_GRP);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT CrsCod),"
+					  "COUNT(DISTINCT GrpCod)-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM "
+				   "("
+				   "SELECT Cod AS CrsCod,"
+					  "-1 AS GrpCod,"                           // Course zones
+					  "NumLevels,"
+					  "NumFolders,"
+					  "NumFiles,"
+					  "TotalSize"
+				   " FROM file_browser_size"
+				   " WHERE Cod=%ld"
+				   " AND FileBrowser IN (%u,%u,%u,%u,%u,%u)"
+				   " UNION "
+				   "SELECT crs_grp_types.CrsCod,"
+					  "file_browser_size.Cod AS GrpCod,"        // Group zones
+					  "file_browser_size.NumLevels,"
+					  "file_browser_size.NumFolders,"
+					  "file_browser_size.NumFiles,"
+					  "file_browser_size.TotalSize"
+				   " FROM crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE crs_grp_types.CrsCod=%ld"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser IN (%u,%u,%u,%u)"
+				   ") AS sizes",
+				   Gbl.Hierarchy.Crs.CrsCod,
+				   (unsigned) Brw_ADMI_DOC_CRS,
+				   (unsigned) Brw_ADMI_TCH_CRS,
+				   (unsigned) Brw_ADMI_SHR_CRS,
+				   (unsigned) Brw_ADMI_ASG_USR,
+				   (unsigned) Brw_ADMI_WRK_USR,
+				   (unsigned) Brw_ADMI_MRK_CRS,
+				   Gbl.Hierarchy.Crs.CrsCod,
+				   (unsigned) Brw_ADMI_DOC_GRP,
+				   (unsigned) Brw_ADMI_TCH_GRP,
+				   (unsigned) Brw_ADMI_SHR_GRP,
+				   (unsigned) Brw_ADMI_MRK_GRP);
 	       break;
 	    case Brw_ADMI_DOC_CRS:
 	    case Brw_ADMI_TCH_CRS:
 	    case Brw_ADMI_SHR_CRS:
 	    case Brw_ADMI_MRK_CRS:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT 1,"
-				      "-1,"
-				      "-1,"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM file_browser_size"
-			       " WHERE Cod=%ld AND FileBrowser=%u",
-			       Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT 1,"
+					  "-1,"
+					  "-1,"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM file_browser_size"
+				   " WHERE Cod=%ld AND FileBrowser=%u",
+				   Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_DOC_GRP:
 	    case Brw_ADMI_TCH_GRP:
 	    case Brw_ADMI_SHR_GRP:
 	    case Brw_ADMI_MRK_GRP:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
-				      "COUNT(DISTINCT file_browser_size.Cod),"
-				      "-1,"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM crs_grp_types,crs_grp,file_browser_size"
-			       " WHERE crs_grp_types.CrsCod=%ld"
-			       " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-			       " AND crs_grp.GrpCod=file_browser_size.Cod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT COUNT(DISTINCT crs_grp_types.CrsCod),"
+					  "COUNT(DISTINCT file_browser_size.Cod),"
+					  "-1,"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM crs_grp_types,crs_grp,file_browser_size"
+				   " WHERE crs_grp_types.CrsCod=%ld"
+				   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+				   " AND crs_grp.GrpCod=file_browser_size.Cod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_ASG_USR:
 	    case Brw_ADMI_WRK_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT 1,"
-				      "-1,"
-				      "COUNT(DISTINCT ZoneUsrCod),"
-				      "MAX(NumLevels),"
-				      "SUM(NumFolders),"
-				      "SUM(NumFiles),"
-				      "SUM(TotalSize)"
-			       " FROM file_browser_size"
-			       " WHERE Cod=%ld AND FileBrowser=%u",
-			       Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT 1,"
+					  "-1,"
+					  "COUNT(DISTINCT ZoneUsrCod),"
+					  "MAX(NumLevels),"
+					  "SUM(NumFolders),"
+					  "SUM(NumFiles),"
+					  "SUM(TotalSize)"
+				   " FROM file_browser_size"
+				   " WHERE Cod=%ld AND FileBrowser=%u",
+				   Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
 	       break;
 	    case Brw_ADMI_BRF_USR:
-	       DB_QuerySELECT (&mysql_res,"can not get size of a file browser",
-			       "SELECT -1,"
-				      "-1,"
-				      "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
-				      "MAX(file_browser_size.NumLevels),"
-				      "SUM(file_browser_size.NumFolders),"
-				      "SUM(file_browser_size.NumFiles),"
-				      "SUM(file_browser_size.TotalSize)"
-			       " FROM crs_usr,file_browser_size"
-			       " WHERE crs_usr.CrsCod=%ld"
-			       " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
-			       " AND file_browser_size.FileBrowser=%u",
-			       Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
+	       FigSnp_QuerySELECT (&mysql_res,"can not get size of a file browser",
+				   "SELECT -1,"
+					  "-1,"
+					  "COUNT(DISTINCT file_browser_size.ZoneUsrCod),"
+					  "MAX(file_browser_size.NumLevels),"
+					  "SUM(file_browser_size.NumFolders),"
+					  "SUM(file_browser_size.NumFiles),"
+					  "SUM(file_browser_size.TotalSize)"
+				   " FROM crs_usr,file_browser_size"
+				   " WHERE crs_usr.CrsCod=%ld"
+				   " AND crs_usr.UsrCod=file_browser_size.ZoneUsrCod"
+				   " AND file_browser_size.FileBrowser=%u",
+				   Gbl.Hierarchy.Crs.CrsCod,(unsigned) FileBrowser);
 	       break;
 	    default:
 	       Lay_ShowErrorAndExit ("Wrong file browser.");
@@ -2832,92 +2955,92 @@ static void Fig_GetNumberOfOERsFromDB (Hie_Level_t Scope,Brw_License_t License,u
      {
       case Hie_SYS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT Public,COUNT(*)"
-				    " FROM files"
-				    " WHERE License=%u"
-				    " GROUP BY Public",
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT Public,COUNT(*)"
+					" FROM files"
+					" WHERE License=%u"
+					" GROUP BY Public",
+					(unsigned) License);
          break;
       case Hie_CTY:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT files.Public,COUNT(*)"
-				    " FROM institutions,centres,degrees,courses,files"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=files.Cod"
-				    " AND files.FileBrowser IN (%u,%u)"
-				    " AND files.License=%u"
-				    " GROUP BY files.Public",
-				    Gbl.Hierarchy.Cty.CtyCod,
-				    (unsigned) Brw_ADMI_DOC_CRS,
-				    (unsigned) Brw_ADMI_SHR_CRS,
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT files.Public,COUNT(*)"
+					" FROM institutions,centres,degrees,courses,files"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=files.Cod"
+					" AND files.FileBrowser IN (%u,%u)"
+					" AND files.License=%u"
+					" GROUP BY files.Public",
+					Gbl.Hierarchy.Cty.CtyCod,
+					(unsigned) Brw_ADMI_DOC_CRS,
+					(unsigned) Brw_ADMI_SHR_CRS,
+					(unsigned) License);
          break;
       case Hie_INS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT files.Public,COUNT(*)"
-				    " FROM centres,degrees,courses,files"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=files.Cod"
-				    " AND files.FileBrowser IN (%u,%u)"
-				    " AND files.License=%u"
-				    " GROUP BY files.Public",
-				    Gbl.Hierarchy.Ins.InsCod,
-				    (unsigned) Brw_ADMI_DOC_CRS,
-				    (unsigned) Brw_ADMI_SHR_CRS,
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT files.Public,COUNT(*)"
+					" FROM centres,degrees,courses,files"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=files.Cod"
+					" AND files.FileBrowser IN (%u,%u)"
+					" AND files.License=%u"
+					" GROUP BY files.Public",
+					Gbl.Hierarchy.Ins.InsCod,
+					(unsigned) Brw_ADMI_DOC_CRS,
+					(unsigned) Brw_ADMI_SHR_CRS,
+					(unsigned) License);
          break;
       case Hie_CTR:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT files.Public,COUNT(*)"
-				    " FROM degrees,courses,files"
-				    " WHERE degrees.CtrCod=%ld"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=files.Cod"
-				    " AND files.FileBrowser IN (%u,%u)"
-				    " AND files.License=%u"
-				    " GROUP BY files.Public",
-				    Gbl.Hierarchy.Ctr.CtrCod,
-				    (unsigned) Brw_ADMI_DOC_CRS,
-				    (unsigned) Brw_ADMI_SHR_CRS,
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT files.Public,COUNT(*)"
+					" FROM degrees,courses,files"
+					" WHERE degrees.CtrCod=%ld"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=files.Cod"
+					" AND files.FileBrowser IN (%u,%u)"
+					" AND files.License=%u"
+					" GROUP BY files.Public",
+					Gbl.Hierarchy.Ctr.CtrCod,
+					(unsigned) Brw_ADMI_DOC_CRS,
+					(unsigned) Brw_ADMI_SHR_CRS,
+					(unsigned) License);
          break;
       case Hie_DEG:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT files.Public,COUNT(*)"
-				    " FROM courses,files"
-				    " WHERE courses.DegCod=%ld"
-				    " AND courses.CrsCod=files.Cod"
-				    " AND files.FileBrowser IN (%u,%u)"
-				    " AND files.License=%u"
-				    " GROUP BY files.Public",
-				    Gbl.Hierarchy.Deg.DegCod,
-				    (unsigned) Brw_ADMI_DOC_CRS,
-				    (unsigned) Brw_ADMI_SHR_CRS,
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT files.Public,COUNT(*)"
+					" FROM courses,files"
+					" WHERE courses.DegCod=%ld"
+					" AND courses.CrsCod=files.Cod"
+					" AND files.FileBrowser IN (%u,%u)"
+					" AND files.License=%u"
+					" GROUP BY files.Public",
+					Gbl.Hierarchy.Deg.DegCod,
+					(unsigned) Brw_ADMI_DOC_CRS,
+					(unsigned) Brw_ADMI_SHR_CRS,
+					(unsigned) License);
          break;
       case Hie_CRS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of OERs",
-				    "SELECT Public,COUNT(*)"
-				    " FROM files"
-				    " WHERE Cod=%ld"
-				    " AND FileBrowser IN (%u,%u)"
-				    " AND License=%u"
-				    " GROUP BY Public",
-				    Gbl.Hierarchy.Crs.CrsCod,
-				    (unsigned) Brw_ADMI_DOC_CRS,
-				    (unsigned) Brw_ADMI_SHR_CRS,
-				    (unsigned) License);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of OERs",
+					"SELECT Public,COUNT(*)"
+					" FROM files"
+					" WHERE Cod=%ld"
+					" AND FileBrowser IN (%u,%u)"
+					" AND License=%u"
+					" GROUP BY Public",
+					Gbl.Hierarchy.Crs.CrsCod,
+					(unsigned) Brw_ADMI_DOC_CRS,
+					(unsigned) Brw_ADMI_SHR_CRS,
+					(unsigned) License);
          break;
       default:
 	 Lay_WrongScopeExit ();
@@ -3440,76 +3563,76 @@ static void Fig_GetAndShowTimelineActivityStats (void)
       switch (Gbl.Scope.Current)
 	{
 	 case Hie_SYS:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(*),"
-					     "COUNT(DISTINCT UsrCod)"
-				      " FROM tl_notes WHERE NoteType=%u",
-				      NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(*),"
+						 "COUNT(DISTINCT UsrCod)"
+					  " FROM tl_notes WHERE NoteType=%u",
+					  NoteType);
 	    break;
 	 case Hie_CTY:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					     "COUNT(DISTINCT tl_notes.UsrCod)"
-				      " FROM institutions,centres,degrees,courses,crs_usr,tl_notes"
-				      " WHERE institutions.CtyCod=%ld"
-				      " AND institutions.InsCod=centres.InsCod"
-				      " AND centres.CtrCod=degrees.CtrCod"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=tl_notes.UsrCod"
-				      " AND tl_notes.NoteType=%u",
-				      Gbl.Hierarchy.Cty.CtyCod,
-				      (unsigned) NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+						 "COUNT(DISTINCT tl_notes.UsrCod)"
+					  " FROM institutions,centres,degrees,courses,crs_usr,tl_notes"
+					  " WHERE institutions.CtyCod=%ld"
+					  " AND institutions.InsCod=centres.InsCod"
+					  " AND centres.CtrCod=degrees.CtrCod"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=tl_notes.UsrCod"
+					  " AND tl_notes.NoteType=%u",
+					  Gbl.Hierarchy.Cty.CtyCod,
+					  (unsigned) NoteType);
 	    break;
 	 case Hie_INS:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					     "COUNT(DISTINCT tl_notes.UsrCod)"
-				      " FROM centres,degrees,courses,crs_usr,tl_notes"
-				      " WHERE centres.InsCod=%ld"
-				      " AND centres.CtrCod=degrees.CtrCod"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=tl_notes.UsrCod"
-				      " AND tl_notes.NoteType=%u",
-				      Gbl.Hierarchy.Ins.InsCod,
-				      (unsigned) NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+						 "COUNT(DISTINCT tl_notes.UsrCod)"
+					  " FROM centres,degrees,courses,crs_usr,tl_notes"
+					  " WHERE centres.InsCod=%ld"
+					  " AND centres.CtrCod=degrees.CtrCod"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=tl_notes.UsrCod"
+					  " AND tl_notes.NoteType=%u",
+					  Gbl.Hierarchy.Ins.InsCod,
+					  (unsigned) NoteType);
 	    break;
 	 case Hie_CTR:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					     "COUNT(DISTINCT tl_notes.UsrCod)"
-				      " FROM degrees,courses,crs_usr,tl_notes"
-				      " WHERE degrees.CtrCod=%ld"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=tl_notes.UsrCod"
-				      " AND tl_notes.NoteType=%u",
-				      Gbl.Hierarchy.Ctr.CtrCod,
-				      (unsigned) NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+						 "COUNT(DISTINCT tl_notes.UsrCod)"
+					  " FROM degrees,courses,crs_usr,tl_notes"
+					  " WHERE degrees.CtrCod=%ld"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=tl_notes.UsrCod"
+					  " AND tl_notes.NoteType=%u",
+					  Gbl.Hierarchy.Ctr.CtrCod,
+					  (unsigned) NoteType);
 	    break;
 	 case Hie_DEG:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					     "COUNT(DISTINCT tl_notes.UsrCod)"
-				      " FROM courses,crs_usr,tl_notes"
-				      " WHERE courses.DegCod=%ld"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=tl_notes.UsrCod"
-				      " AND tl_notes.NoteType=%u",
-				      Gbl.Hierarchy.Deg.DegCod,
-				      (unsigned) NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+						 "COUNT(DISTINCT tl_notes.UsrCod)"
+					  " FROM courses,crs_usr,tl_notes"
+					  " WHERE courses.DegCod=%ld"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=tl_notes.UsrCod"
+					  " AND tl_notes.NoteType=%u",
+					  Gbl.Hierarchy.Deg.DegCod,
+					  (unsigned) NoteType);
 	    break;
 	 case Hie_CRS:
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				      "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					     "COUNT(DISTINCT tl_notes.UsrCod)"
-				      " FROM crs_usr,tl_notes"
-				      " WHERE crs_usr.CrsCod=%ld"
-				      " AND crs_usr.UsrCod=tl_notes.UsrCod"
-				      " AND tl_notes.NoteType=%u",
-				      Gbl.Hierarchy.Crs.CrsCod,
-				      (unsigned) NoteType);
+	    NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+					  "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+						 "COUNT(DISTINCT tl_notes.UsrCod)"
+					  " FROM crs_usr,tl_notes"
+					  " WHERE crs_usr.CrsCod=%ld"
+					  " AND crs_usr.UsrCod=tl_notes.UsrCod"
+					  " AND tl_notes.NoteType=%u",
+					  Gbl.Hierarchy.Crs.CrsCod,
+					  (unsigned) NoteType);
 	    break;
 	 default:
 	    Lay_WrongScopeExit ();
@@ -3571,65 +3694,65 @@ static void Fig_GetAndShowTimelineActivityStats (void)
    switch (Gbl.Scope.Current)
      {
       case Hie_SYS:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(*),"
-					  "COUNT(DISTINCT UsrCod)"
-				   " FROM tl_notes");
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(*),"
+					      "COUNT(DISTINCT UsrCod)"
+				       " FROM tl_notes");
 	 break;
       case Hie_CTY:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					  "COUNT(DISTINCT tl_notes.UsrCod)"
-				   " FROM institutions,centres,degrees,courses,crs_usr,tl_notes"
-				   " WHERE institutions.CtyCod=%ld"
-				   " AND institutions.InsCod=centres.InsCod"
-				   " AND centres.CtrCod=degrees.CtrCod"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=tl_notes.UsrCod",
-				   Gbl.Hierarchy.Cty.CtyCod);
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+					      "COUNT(DISTINCT tl_notes.UsrCod)"
+				       " FROM institutions,centres,degrees,courses,crs_usr,tl_notes"
+				       " WHERE institutions.CtyCod=%ld"
+				       " AND institutions.InsCod=centres.InsCod"
+				       " AND centres.CtrCod=degrees.CtrCod"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=tl_notes.UsrCod",
+				       Gbl.Hierarchy.Cty.CtyCod);
 	 break;
       case Hie_INS:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					  "COUNT(DISTINCT tl_notes.UsrCod)"
-				   " FROM centres,degrees,courses,crs_usr,tl_notes"
-				   " WHERE centres.InsCod=%ld"
-				   " AND centres.CtrCod=degrees.CtrCod"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=tl_notes.UsrCod",
-				   Gbl.Hierarchy.Ins.InsCod);
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+					      "COUNT(DISTINCT tl_notes.UsrCod)"
+				       " FROM centres,degrees,courses,crs_usr,tl_notes"
+				       " WHERE centres.InsCod=%ld"
+				       " AND centres.CtrCod=degrees.CtrCod"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=tl_notes.UsrCod",
+				       Gbl.Hierarchy.Ins.InsCod);
 	 break;
       case Hie_CTR:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					  "COUNT(DISTINCT tl_notes.UsrCod)"
-				   " FROM degrees,courses,crs_usr,tl_notes"
-				   " WHERE degrees.CtrCod=%ld"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=tl_notes.UsrCod",
-				   Gbl.Hierarchy.Ctr.CtrCod);
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+					      "COUNT(DISTINCT tl_notes.UsrCod)"
+				       " FROM degrees,courses,crs_usr,tl_notes"
+				       " WHERE degrees.CtrCod=%ld"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=tl_notes.UsrCod",
+				       Gbl.Hierarchy.Ctr.CtrCod);
 	 break;
       case Hie_DEG:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					  "COUNT(DISTINCT tl_notes.UsrCod)"
-				   " FROM courses,crs_usr,tl_notes"
-				   " WHERE courses.DegCod=%ld"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=tl_notes.UsrCod",
-				   Gbl.Hierarchy.Deg.DegCod);
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+					      "COUNT(DISTINCT tl_notes.UsrCod)"
+				       " FROM courses,crs_usr,tl_notes"
+				       " WHERE courses.DegCod=%ld"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=tl_notes.UsrCod",
+				       Gbl.Hierarchy.Deg.DegCod);
 	 break;
       case Hie_CRS:
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get number of social notes",
-				   "SELECT COUNT(DISTINCT tl_notes.NotCod),"
-					  "COUNT(DISTINCT tl_notes.UsrCod)"
-				   " FROM crs_usr,tl_notes"
-				   " WHERE crs_usr.CrsCod=%ld"
-				   " AND crs_usr.UsrCod=tl_notes.UsrCod",
-				   Gbl.Hierarchy.Crs.CrsCod);
+	 NumRows = FigSnp_QuerySELECT (&mysql_res,"can not get number of social notes",
+				       "SELECT COUNT(DISTINCT tl_notes.NotCod),"
+					      "COUNT(DISTINCT tl_notes.UsrCod)"
+				       " FROM crs_usr,tl_notes"
+				       " WHERE crs_usr.CrsCod=%ld"
+				       " AND crs_usr.UsrCod=tl_notes.UsrCod",
+				       Gbl.Hierarchy.Crs.CrsCod);
 	 break;
       default:
 	 Lay_WrongScopeExit ();
@@ -3753,80 +3876,80 @@ static void Fig_GetAndShowFollowStats (void)
 	{
 	 case Hie_SYS:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT %s) FROM usr_follow",
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT %s) FROM usr_follow",
+					  FieldDB[Fol]);
 	    break;
 	 case Hie_CTY:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT usr_follow.%s)"
-				      " FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
-				      " WHERE institutions.CtyCod=%ld"
-				      " AND institutions.InsCod=centres.InsCod"
-				      " AND centres.CtrCod=degrees.CtrCod"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=usr_follow.%s",
-				      FieldDB[Fol],
-				      Gbl.Hierarchy.Cty.CtyCod,
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT usr_follow.%s)"
+					  " FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
+					  " WHERE institutions.CtyCod=%ld"
+					  " AND institutions.InsCod=centres.InsCod"
+					  " AND centres.CtrCod=degrees.CtrCod"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=usr_follow.%s",
+					  FieldDB[Fol],
+					  Gbl.Hierarchy.Cty.CtyCod,
+					  FieldDB[Fol]);
 	    break;
 	 case Hie_INS:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT usr_follow.%s)"
-				      " FROM centres,degrees,courses,crs_usr,usr_follow"
-				      " WHERE centres.InsCod=%ld"
-				      " AND centres.CtrCod=degrees.CtrCod"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=usr_follow.%s",
-				      FieldDB[Fol],
-				      Gbl.Hierarchy.Ins.InsCod,
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT usr_follow.%s)"
+					  " FROM centres,degrees,courses,crs_usr,usr_follow"
+					  " WHERE centres.InsCod=%ld"
+					  " AND centres.CtrCod=degrees.CtrCod"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=usr_follow.%s",
+					  FieldDB[Fol],
+					  Gbl.Hierarchy.Ins.InsCod,
+					  FieldDB[Fol]);
 	    break;
 	 case Hie_CTR:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT usr_follow.%s)"
-				      " FROM degrees,courses,crs_usr,usr_follow"
-				      " WHERE degrees.CtrCod=%ld"
-				      " AND degrees.DegCod=courses.DegCod"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=usr_follow.%s",
-				      FieldDB[Fol],
-				      Gbl.Hierarchy.Ctr.CtrCod,
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT usr_follow.%s)"
+					  " FROM degrees,courses,crs_usr,usr_follow"
+					  " WHERE degrees.CtrCod=%ld"
+					  " AND degrees.DegCod=courses.DegCod"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=usr_follow.%s",
+					  FieldDB[Fol],
+					  Gbl.Hierarchy.Ctr.CtrCod,
+					  FieldDB[Fol]);
 	    break;
 	 case Hie_DEG:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT usr_follow.%s)"
-				      " FROM courses,crs_usr,usr_follow"
-				      " WHERE courses.DegCod=%ld"
-				      " AND courses.CrsCod=crs_usr.CrsCod"
-				      " AND crs_usr.UsrCod=usr_follow.%s",
-				      FieldDB[Fol],
-				      Gbl.Hierarchy.Deg.DegCod,
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT usr_follow.%s)"
+					  " FROM courses,crs_usr,usr_follow"
+					  " WHERE courses.DegCod=%ld"
+					  " AND courses.CrsCod=crs_usr.CrsCod"
+					  " AND crs_usr.UsrCod=usr_follow.%s",
+					  FieldDB[Fol],
+					  Gbl.Hierarchy.Deg.DegCod,
+					  FieldDB[Fol]);
 	    break;
 	 case Hie_CRS:
 	    NumUsrs =
-	    (unsigned) DB_QueryCOUNT ("can not get the total number"
-				      " of following/followers",
-				      "SELECT COUNT(DISTINCT usr_follow.%s)"
-				      " FROM crs_usr,usr_follow"
-				      " WHERE crs_usr.CrsCod=%ld"
-				      " AND crs_usr.UsrCod=usr_follow.%s",
-				      FieldDB[Fol],
-				      Gbl.Hierarchy.Crs.CrsCod,
-				      FieldDB[Fol]);
+	    (unsigned) FigSnp_QueryCOUNT ("can not get the total number"
+					  " of following/followers",
+					  "SELECT COUNT(DISTINCT usr_follow.%s)"
+					  " FROM crs_usr,usr_follow"
+					  " WHERE crs_usr.CrsCod=%ld"
+					  " AND crs_usr.UsrCod=usr_follow.%s",
+					  FieldDB[Fol],
+					  Gbl.Hierarchy.Crs.CrsCod,
+					  FieldDB[Fol]);
 	    break;
 	 default:
 	    Lay_WrongScopeExit ();
@@ -3863,94 +3986,94 @@ static void Fig_GetAndShowFollowStats (void)
       switch (Gbl.Scope.Current)
 	{
 	 case Hie_SYS:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(%s) AS N"
-			    " FROM usr_follow"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(%s) AS N"
+				" FROM usr_follow"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 case Hie_CTY:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
-			    " FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
-			    " WHERE institutions.CtyCod=%ld"
-			    " AND institutions.InsCod=centres.InsCod"
-			    " AND centres.CtrCod=degrees.CtrCod"
-			    " AND degrees.DegCod=courses.DegCod"
-			    " AND courses.CrsCod=crs_usr.CrsCod"
-			    " AND crs_usr.UsrCod=usr_follow.%s"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    Gbl.Hierarchy.Cty.CtyCod,
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
+				" FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
+				" WHERE institutions.CtyCod=%ld"
+				" AND institutions.InsCod=centres.InsCod"
+				" AND centres.CtrCod=degrees.CtrCod"
+				" AND degrees.DegCod=courses.DegCod"
+				" AND courses.CrsCod=crs_usr.CrsCod"
+				" AND crs_usr.UsrCod=usr_follow.%s"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				Gbl.Hierarchy.Cty.CtyCod,
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 case Hie_INS:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
-			    " FROM centres,degrees,courses,crs_usr,usr_follow"
-			    " WHERE centres.InsCod=%ld"
-			    " AND centres.CtrCod=degrees.CtrCod"
-			    " AND degrees.DegCod=courses.DegCod"
-			    " AND courses.CrsCod=crs_usr.CrsCod"
-			    " AND crs_usr.UsrCod=usr_follow.%s"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    Gbl.Hierarchy.Ins.InsCod,
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
+				" FROM centres,degrees,courses,crs_usr,usr_follow"
+				" WHERE centres.InsCod=%ld"
+				" AND centres.CtrCod=degrees.CtrCod"
+				" AND degrees.DegCod=courses.DegCod"
+				" AND courses.CrsCod=crs_usr.CrsCod"
+				" AND crs_usr.UsrCod=usr_follow.%s"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				Gbl.Hierarchy.Ins.InsCod,
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 case Hie_CTR:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
-			    " FROM degrees,courses,crs_usr,usr_follow"
-			    " WHERE degrees.CtrCod=%ld"
-			    " AND degrees.DegCod=courses.DegCod"
-			    " AND courses.CrsCod=crs_usr.CrsCod"
-			    " AND crs_usr.UsrCod=usr_follow.%s"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    Gbl.Hierarchy.Ctr.CtrCod,
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
+				" FROM degrees,courses,crs_usr,usr_follow"
+				" WHERE degrees.CtrCod=%ld"
+				" AND degrees.DegCod=courses.DegCod"
+				" AND courses.CrsCod=crs_usr.CrsCod"
+				" AND crs_usr.UsrCod=usr_follow.%s"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				Gbl.Hierarchy.Ctr.CtrCod,
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 case Hie_DEG:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
-			    " FROM courses,crs_usr,usr_follow"
-			    " WHERE courses.DegCod=%ld"
-			    " AND courses.CrsCod=crs_usr.CrsCod"
-			    " AND crs_usr.UsrCod=usr_follow.%s"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    Gbl.Hierarchy.Deg.DegCod,
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
+				" FROM courses,crs_usr,usr_follow"
+				" WHERE courses.DegCod=%ld"
+				" AND courses.CrsCod=crs_usr.CrsCod"
+				" AND crs_usr.UsrCod=usr_follow.%s"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				Gbl.Hierarchy.Deg.DegCod,
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 case Hie_CRS:
-	    DB_QuerySELECT (&mysql_res,"can not get number of questions"
-				       " per survey",
-			    "SELECT AVG(N) FROM "
-			    "(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
-			    " FROM crs_usr,usr_follow"
-			    " WHERE crs_usr.CrsCod=%ld"
-			    " AND crs_usr.UsrCod=usr_follow.%s"
-			    " GROUP BY %s) AS F",
-			    FieldDB[Fol],
-			    Gbl.Hierarchy.Crs.CrsCod,
-			    FieldDB[Fol],
-			    FieldDB[1 - Fol]);
+	    FigSnp_QuerySELECT (&mysql_res,"can not get number of questions"
+					   " per survey",
+				"SELECT AVG(N) FROM "
+				"(SELECT COUNT(DISTINCT usr_follow.%s) AS N"
+				" FROM crs_usr,usr_follow"
+				" WHERE crs_usr.CrsCod=%ld"
+				" AND crs_usr.UsrCod=usr_follow.%s"
+				" GROUP BY %s) AS F",
+				FieldDB[Fol],
+				Gbl.Hierarchy.Crs.CrsCod,
+				FieldDB[Fol],
+				FieldDB[1 - Fol]);
 	    break;
 	 default:
 	    Lay_WrongScopeExit ();
@@ -4404,63 +4527,63 @@ static void Fig_GetAndShowNumUsrsPerNotifyEvent (void)
       switch (Gbl.Scope.Current)
         {
          case Hie_SYS:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(NumEvents),SUM(NumMails)"
-                            " FROM sta_notif"
-                            " WHERE NotifyEvent=%u",
-			    (unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(NumEvents),SUM(NumMails)"
+				" FROM sta_notif"
+				" WHERE NotifyEvent=%u",
+				(unsigned) NotifyEvent);
             break;
 	 case Hie_CTY:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
-                            " FROM institutions,centres,degrees,sta_notif"
-                            " WHERE institutions.CtyCod=%ld"
-                            " AND institutions.InsCod=centres.InsCod"
-                            " AND centres.CtrCod=degrees.CtrCod"
-                            " AND degrees.DegCod=sta_notif.DegCod"
-                            " AND sta_notif.NotifyEvent=%u",
-			    Gbl.Hierarchy.Cty.CtyCod,(unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
+				" FROM institutions,centres,degrees,sta_notif"
+				" WHERE institutions.CtyCod=%ld"
+				" AND institutions.InsCod=centres.InsCod"
+				" AND centres.CtrCod=degrees.CtrCod"
+				" AND degrees.DegCod=sta_notif.DegCod"
+				" AND sta_notif.NotifyEvent=%u",
+				Gbl.Hierarchy.Cty.CtyCod,(unsigned) NotifyEvent);
             break;
 	 case Hie_INS:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
-                            " FROM centres,degrees,sta_notif"
-                            " WHERE centres.InsCod=%ld"
-                            " AND centres.CtrCod=degrees.CtrCod"
-                            " AND degrees.DegCod=sta_notif.DegCod"
-                            " AND sta_notif.NotifyEvent=%u",
-			    Gbl.Hierarchy.Ins.InsCod,(unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
+				" FROM centres,degrees,sta_notif"
+				" WHERE centres.InsCod=%ld"
+				" AND centres.CtrCod=degrees.CtrCod"
+				" AND degrees.DegCod=sta_notif.DegCod"
+				" AND sta_notif.NotifyEvent=%u",
+				Gbl.Hierarchy.Ins.InsCod,(unsigned) NotifyEvent);
             break;
          case Hie_CTR:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
-                            " FROM degrees,sta_notif"
-                            " WHERE degrees.CtrCod=%ld"
-                            " AND degrees.DegCod=sta_notif.DegCod"
-                            " AND sta_notif.NotifyEvent=%u",
-			    Gbl.Hierarchy.Ctr.CtrCod,(unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(sta_notif.NumEvents),SUM(sta_notif.NumMails)"
+				" FROM degrees,sta_notif"
+				" WHERE degrees.CtrCod=%ld"
+				" AND degrees.DegCod=sta_notif.DegCod"
+				" AND sta_notif.NotifyEvent=%u",
+				Gbl.Hierarchy.Ctr.CtrCod,(unsigned) NotifyEvent);
             break;
          case Hie_DEG:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(NumEvents),SUM(NumMails)"
-                            " FROM sta_notif"
-                            " WHERE DegCod=%ld"
-                            " AND NotifyEvent=%u",
-			    Gbl.Hierarchy.Deg.DegCod,(unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(NumEvents),SUM(NumMails)"
+				" FROM sta_notif"
+				" WHERE DegCod=%ld"
+				" AND NotifyEvent=%u",
+				Gbl.Hierarchy.Deg.DegCod,(unsigned) NotifyEvent);
             break;
          case Hie_CRS:
-            DB_QuerySELECT (&mysql_res,"can not get the number"
-        			       " of notifications by email",
-        		    "SELECT SUM(NumEvents),SUM(NumMails)"
-                            " FROM sta_notif"
-                            " WHERE CrsCod=%ld"
-                            " AND NotifyEvent=%u",
-			    Gbl.Hierarchy.Crs.CrsCod,(unsigned) NotifyEvent);
+            FigSnp_QuerySELECT (&mysql_res,"can not get the number"
+					   " of notifications by email",
+				"SELECT SUM(NumEvents),SUM(NumMails)"
+				" FROM sta_notif"
+				" WHERE CrsCod=%ld"
+				" AND NotifyEvent=%u",
+				Gbl.Hierarchy.Crs.CrsCod,(unsigned) NotifyEvent);
             break;
 	 default:
 	    Lay_WrongScopeExit ();
@@ -5571,76 +5694,76 @@ unsigned Fig_GetNumUsrsWhoChoseAnOption (const char *SubQuery)
      {
       case Hie_SYS:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(*)"
-				   " FROM usr_data WHERE %s",
-				   SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(*)"
+				       " FROM usr_data WHERE %s",
+				       SubQuery);
 	 break;
       case Hie_CTY:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(DISTINCT usr_data.UsrCod)"
-				   " FROM institutions,centres,degrees,courses,crs_usr,usr_data"
-				   " WHERE institutions.CtyCod=%ld"
-				   " AND institutions.InsCod=centres.InsCod"
-				   " AND centres.CtrCod=degrees.CtrCod"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=usr_data.UsrCod"
-				   " AND %s",
-				   Gbl.Hierarchy.Cty.CtyCod,SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(DISTINCT usr_data.UsrCod)"
+				       " FROM institutions,centres,degrees,courses,crs_usr,usr_data"
+				       " WHERE institutions.CtyCod=%ld"
+				       " AND institutions.InsCod=centres.InsCod"
+				       " AND centres.CtrCod=degrees.CtrCod"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=usr_data.UsrCod"
+				       " AND %s",
+				       Gbl.Hierarchy.Cty.CtyCod,SubQuery);
 	 break;
       case Hie_INS:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(DISTINCT usr_data.UsrCod)"
-				   " FROM centres,degrees,courses,crs_usr,usr_data"
-				   " WHERE centres.InsCod=%ld"
-				   " AND centres.CtrCod=degrees.CtrCod"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=usr_data.UsrCod"
-				   " AND %s",
-				   Gbl.Hierarchy.Ins.InsCod,SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(DISTINCT usr_data.UsrCod)"
+				       " FROM centres,degrees,courses,crs_usr,usr_data"
+				       " WHERE centres.InsCod=%ld"
+				       " AND centres.CtrCod=degrees.CtrCod"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=usr_data.UsrCod"
+				       " AND %s",
+				       Gbl.Hierarchy.Ins.InsCod,SubQuery);
 	 break;
       case Hie_CTR:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(DISTINCT usr_data.UsrCod)"
-				   " FROM degrees,courses,crs_usr,usr_data"
-				   " WHERE degrees.CtrCod=%ld"
-				   " AND degrees.DegCod=courses.DegCod"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=usr_data.UsrCod"
-				   " AND %s",
-				   Gbl.Hierarchy.Ctr.CtrCod,SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(DISTINCT usr_data.UsrCod)"
+				       " FROM degrees,courses,crs_usr,usr_data"
+				       " WHERE degrees.CtrCod=%ld"
+				       " AND degrees.DegCod=courses.DegCod"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=usr_data.UsrCod"
+				       " AND %s",
+				       Gbl.Hierarchy.Ctr.CtrCod,SubQuery);
 	 break;
       case Hie_DEG:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(DISTINCT usr_data.UsrCod)"
-				   " FROM courses,crs_usr,usr_data"
-				   " WHERE courses.DegCod=%ld"
-				   " AND courses.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod=usr_data.UsrCod"
-				   " AND %s",
-				   Gbl.Hierarchy.Deg.DegCod,SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(DISTINCT usr_data.UsrCod)"
+				       " FROM courses,crs_usr,usr_data"
+				       " WHERE courses.DegCod=%ld"
+				       " AND courses.CrsCod=crs_usr.CrsCod"
+				       " AND crs_usr.UsrCod=usr_data.UsrCod"
+				       " AND %s",
+				       Gbl.Hierarchy.Deg.DegCod,SubQuery);
 	 break;
       case Hie_CRS:
 	 NumUsrs =
-	 (unsigned) DB_QueryCOUNT ("can not get the number of users"
-				   " who have chosen an option",
-				   "SELECT COUNT(DISTINCT usr_data.UsrCod)"
-				   " FROM crs_usr,usr_data"
-				   " WHERE crs_usr.CrsCod=%ld"
-				   " AND crs_usr.UsrCod=usr_data.UsrCod"
-				   " AND %s",
-				   Gbl.Hierarchy.Crs.CrsCod,SubQuery);
+	 (unsigned) FigSnp_QueryCOUNT ("can not get the number of users"
+				       " who have chosen an option",
+				       "SELECT COUNT(DISTINCT usr_data.UsrCod)"
+				       " FROM crs_usr,usr_data"
+				       " WHERE crs_usr.CrsCod=%ld"
+				       " AND crs_usr.UsrCod=usr_data.UsrCod"
+				       " AND %s",
+				       Gbl.Hierarchy.Crs.CrsCod,SubQuery);
 	 break;
       default:
 	 Lay_WrongScopeExit ();
@@ -33,7 +33,7 @@
 /************************** Public types and constants ***********************/
 /*****************************************************************************/
 
-#define Fig_NUM_FIGURES 30
+#define Fig_NUM_FIGURES 31
 typedef enum
   {
    Fig_USERS,			// Number of users
@@ -66,6 +66,7 @@ typedef enum
    Fig_SIDE_COLUMNS,		// Number of users per layout of columns
    Fig_PRIVACY,			// Number of users per privacity
    Fig_COOKIES,			// Number of users per acceptation of cookies
+   Fig_FRAGMENT_CACHE,		// Hit ratio of the cache of fragments of HTML pages
   } Fig_FigureType_t;
 #define Fig_FIGURE_TYPE_DEF Fig_USERS
 
@@ -85,5 +86,6 @@ void Fig_ReqShowFigures (void);
 void Fig_PutIconToShowFigure (Fig_FigureType_t FigureType);
 void Fig_PutHiddenParamFigures (void *Figures);
 void Fig_ShowFigures (void);
+void Fig_UpdateOldestSnapshotInSystem (void);
 
 #endif
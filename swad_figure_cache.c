@@ -26,21 +26,33 @@
 /*****************************************************************************/
 
 #include <stdio.h>		// For sscanf
+#include <time.h>		// For time_t
+#include <unistd.h>		// For usleep
 
 #include "swad_database.h"
 #include "swad_figure_cache.h"
+#include "swad_global.h"
 #include "swad_scope.h"
 
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
 /*****************************************************************************/
 
-// extern struct Globals Gbl;
+extern struct Globals Gbl;
 
 /*****************************************************************************/
 /***************************** Private constants *****************************/
 /*****************************************************************************/
 
+// Only one process recomputes a figure at a time.
+// While it is recomputing, the other processes get the old value,
+// or wait for the new value if the old one is too old.
+#define FigCch_REFRESH_AHEAD_PERCENT	 75		// A figure accessed after this percentage of its cache time is recomputed in advance
+#define FigCch_STALE_FACTOR		  2		// A figure is got while it is being recomputed until this number of times its cache time
+#define FigCch_SECONDS_REFRESH_LEASE	((time_t) 30UL)	// Maximum time a process can take to recompute a figure
+#define FigCch_MAX_WAITS		 20		// Maximum number of waits for another process recomputing a figure
+#define FigCch_MICROSECONDS_WAIT	100000		// Time of each wait
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
@@ -53,9 +65,19 @@
 /****************************** Private prototypes ***************************/
 /*****************************************************************************/
 
+static bool FigCch_GetFigureAndAgeFromDB (FigCch_FigureCached_t Figure,
+                                          Hie_Level_t Scope,long Cod,
+                                          FigCch_Type_t Type,void *ValuePtr,
+                                          time_t *Age);
+static bool FigCch_LockFigureToRecompute (FigCch_FigureCached_t Figure,
+                                          Hie_Level_t Scope,long Cod);
+static bool FigCch_CreateLockedFigure (FigCch_FigureCached_t Figure,
+                                       Hie_Level_t Scope,long Cod);
+
 /*****************************************************************************/
-/************** Get number of users who have chosen an option ****************/
+/*********************** Update a figure into cache **************************/
 /*****************************************************************************/
+// The figure is unlocked, so other processes can recompute it later
 
 void FigCch_UpdateFigureIntoCache (FigCch_FigureCached_t Figure,
                                    Hie_Level_t Scope,long Cod,
@@ -92,9 +114,12 @@ void FigCch_UpdateFigureIntoCache (FigCch_FigureCached_t Figure,
   }
 
 /*****************************************************************************/
-/************** Get number of users who have chosen an option ****************/
+/************************* Get a figure from cache ***************************/
 /*****************************************************************************/
-// Return true is figure is found (if figure is cached and recently updated)
+// Return true is figure is found (if figure is cached and recently updated,
+// or if it is being recomputed by another process and it's not too old)
+// Return false if the figure must be recomputed by the caller,
+// that must update it into cache with FigCch_UpdateFigureIntoCache
 
 bool FigCch_GetFigureFromCache (FigCch_FigureCached_t Figure,
                                 Hie_Level_t Scope,long Cod,
@@ -111,14 +136,8 @@ bool FigCch_GetFigureFromCache (FigCch_FigureCached_t Figure,
       [Hie_DEG] = (time_t) ( 1UL * 60UL * 60UL),	// Degree
       [Hie_CRS] = (time_t) (              60UL),	// Course
      };
-   static const char *Field[FigCch_NUM_TYPES] =
-     {
-      [FigCch_UNSIGNED] = "ValueInt",
-      [FigCch_DOUBLE  ] = "ValueDouble",
-     };
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   bool Found = false;
+   time_t Age;
+   unsigned NumWaits;
 
    /***** Set default value when not found *****/
    switch (Type)
@@ -136,36 +155,87 @@ bool FigCch_GetFigureFromCache (FigCch_FigureCached_t Figure,
        Scope == Hie_UNK)		// Unknown scope
       return false;
 
-   /***** Get figure's value if cached and recent *****/
+   for (NumWaits = 0;
+	;
+	NumWaits++)
+     {
+      /***** Get figure's value and age *****/
+      if (FigCch_GetFigureAndAgeFromDB (Figure,Scope,Cod,Type,ValuePtr,&Age))
+	{
+	 /* Recent value */
+	 if (Age < TimeCached[Scope] * FigCch_REFRESH_AHEAD_PERCENT / 100)
+	    return true;
+
+	 /* Value near to expire, or expired but not too old ==>
+	    recompute it if no other process is recomputing it,
+	    else get it */
+	 if (Age < TimeCached[Scope] * FigCch_STALE_FACTOR)
+	    return !FigCch_LockFigureToRecompute (Figure,Scope,Cod);
+
+	 /* Value too old ==>
+	    recompute it if no other process is recomputing it,
+	    else wait for the new value */
+	 if (FigCch_LockFigureToRecompute (Figure,Scope,Cod))
+	    return false;
+	}
+      else if (FigCch_CreateLockedFigure (Figure,Scope,Cod))
+	 /* Figure not cached ==> recompute it */
+	 return false;
+
+      /***** Another process is recomputing this figure ==> wait for it *****/
+      if (NumWaits == FigCch_MAX_WAITS)
+	 return false;	// Waited too long ==> recompute it
+      usleep (FigCch_MICROSECONDS_WAIT);
+     }
+  }
+
+/*****************************************************************************/
+/****************** Get a figure and its age from database *******************/
+/*****************************************************************************/
+// Return true is figure is found in database
+
+static bool FigCch_GetFigureAndAgeFromDB (FigCch_FigureCached_t Figure,
+                                          Hie_Level_t Scope,long Cod,
+                                          FigCch_Type_t Type,void *ValuePtr,
+                                          time_t *Age)
+  {
+   static const char *Field[FigCch_NUM_TYPES] =
+     {
+      [FigCch_UNSIGNED] = "ValueInt",
+      [FigCch_DOUBLE  ] = "ValueDouble",
+     };
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   bool Found = false;
+
+   /***** Get figure's value and age *****/
    if (DB_QuerySELECT (&mysql_res,"can not get cached figure value",
-		       "SELECT %s"
+		       "SELECT %s,"						// row[0]
+		              "UNIX_TIMESTAMP()-UNIX_TIMESTAMP(LastUpdate)"	// row[1]
 		       " FROM figures"
-		       " WHERE Figure=%u AND Scope='%s' AND Cod=%ld"
-		       " AND LastUpdate>FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)",
+		       " WHERE Figure=%u AND Scope='%s' AND Cod=%ld",
 		       Field[Type],
-		       (unsigned) Figure,Sco_GetDBStrFromScope (Scope),Cod,
-		       TimeCached[Scope]))
+		       (unsigned) Figure,Sco_GetDBStrFromScope (Scope),Cod))
      {
       /* Get row */
       row = mysql_fetch_row (mysql_res);
 
-      /* Get value (row[0]) */
-      if (row[0])
-	{
-	 switch (Type)
-	   {
-	    case FigCch_UNSIGNED:
-	       if (sscanf (row[0],"%u",(unsigned *) ValuePtr) == 1)
-		  Found = true;
-	       break;
-	    case FigCch_DOUBLE:
-               Str_SetDecimalPointToUS ();	// To write the decimal point as a dot
-	       if (sscanf (row[0],"%lf",(double *) ValuePtr) == 1)
-		  Found = true;
-               Str_SetDecimalPointToLocal ();	// Return to local system
-	       break;
-	   }
-	}
+      /* Get value (row[0]) and age (row[1]) */
+      if (row[0] && row[1])
+	 if (sscanf (row[1],"%ld",Age) == 1)
+	    switch (Type)
+	      {
+	       case FigCch_UNSIGNED:
+		  if (sscanf (row[0],"%u",(unsigned *) ValuePtr) == 1)
+		     Found = true;
+		  break;
+	       case FigCch_DOUBLE:
+		  Str_SetDecimalPointToUS ();	// To write the decimal point as a dot
+		  if (sscanf (row[0],"%lf",(double *) ValuePtr) == 1)
+		     Found = true;
+		  Str_SetDecimalPointToLocal ();	// Return to local system
+		  break;
+	      }
      }
 
    /***** Free structure that stores the query result *****/
@@ -173,3 +243,48 @@ bool FigCch_GetFigureFromCache (FigCch_FigureCached_t Figure,
 
    return Found;
   }
+
+/*****************************************************************************/
+/****************** Lock a figure in order to recompute it *******************/
+/*****************************************************************************/
+// Return true if I have locked the figure
+// Return false if another process is recomputing it
+
+static bool FigCch_LockFigureToRecompute (FigCch_FigureCached_t Figure,
+                                          Hie_Level_t Scope,long Cod)
+  {
+   /***** Lock figure if not locked by another process *****/
+   // LastUpdate is not changed
+   DB_QueryUPDATE ("can not lock cached figure",
+		   "UPDATE figures"
+		   " SET RefreshUntil=FROM_UNIXTIME(UNIX_TIMESTAMP()+%lu),"
+		   "LastUpdate=LastUpdate"
+		   " WHERE Figure=%u AND Scope='%s' AND Cod=%ld"
+		   " AND RefreshUntil<NOW()",
+		   FigCch_SECONDS_REFRESH_LEASE,
+		   (unsigned) Figure,Sco_GetDBStrFromScope (Scope),Cod);
+
+   return (mysql_affected_rows (&Gbl.mysql) != 0);
+  }
+
+/*****************************************************************************/
+/************* Create a locked figure not yet cached in database *************/
+/*****************************************************************************/
+// Return true if I have created the figure
+// Return false if another process has just created it
+
+static bool FigCch_CreateLockedFigure (FigCch_FigureCached_t Figure,
+                                       Hie_Level_t Scope,long Cod)
+  {
+   /***** Create figure, with a very old value, locked by me *****/
+   DB_QueryINSERT ("can not lock cached figure",
+		   "INSERT IGNORE INTO figures"
+		   " (Figure,Scope,Cod,ValueInt,ValueDouble,LastUpdate,RefreshUntil)"
+		   " VALUES"
+		   " (%u,'%s',%ld,0,'0.0',FROM_UNIXTIME(%lu),FROM_UNIXTIME(UNIX_TIMESTAMP()+%lu))",
+		   (unsigned) Figure,Sco_GetDBStrFromScope (Scope),Cod,
+		   (time_t) (24UL * 60UL * 60UL),	// 1970-01-02
+		   FigCch_SECONDS_REFRESH_LEASE);
+
+   return (mysql_affected_rows (&Gbl.mysql) != 0);
+  }
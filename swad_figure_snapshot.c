@@ -0,0 +1,567 @@
+// swad_figure_snapshot.c: snapshots of figures (global stats) stored in database
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#define _GNU_SOURCE 		// For vasprintf
+#include <stdarg.h>		// For va_start, va_end
+#include <stdio.h>		// For sscanf, vasprintf
+#include <stdlib.h>		// For free, malloc
+#include <string.h>		// For memcpy
+
+#include "swad_cryptography.h"
+#include "swad_database.h"
+#include "swad_date.h"
+#include "swad_figure_snapshot.h"
+#include "swad_global.h"
+#include "swad_scope.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+// The results of the queries made to compute a figure are stored in database.
+// Next time the figure is shown, the results are got from the snapshot,
+// so the heavy queries are not made again until the snapshot is recomputed.
+#define FigSnp_MAX_COLS		  8	// Maximum number of columns in a result stored in snapshot
+
+// Rows of a snapshot are inserted in batches
+#define FigSnp_MAX_ROWS_PER_INSERT	500
+#define FigSnp_MAX_BYTES_PER_INSERT	((size_t) (1024UL * 1024UL))	// Must be lower than max_allowed_packet
+
+#define FigSnp_SECONDS_TO_UPDATE_SYSTEM	((time_t) (     24UL * 60UL * 60UL))	// System-wide snapshots are recomputed every night
+#define FigSnp_SECONDS_MAX_AGE		((time_t) (7UL * 24UL * 60UL * 60UL))	// Older snapshots are not used
+#define FigSnp_SECONDS_TO_COMPLETE	((time_t) (           60UL * 60UL))	// Maximum time a process can take to store a snapshot
+
+#define FigSnp_MAX_BYTES_COLS_LIST (FigSnp_MAX_COLS * (3 + 10 + 1))	// "Col0,Col1,..."
+
+/*****************************************************************************/
+/******************************* Private types *******************************/
+/*****************************************************************************/
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static struct
+  {
+   bool Active;			// Are we computing a figure?
+   Fig_FigureType_t FigureType;
+   Hie_Level_t Scope;
+   FigSnp_Mode_t Mode;
+   time_t OldestTime;		// Time of the oldest result used in this figure
+  } FigSnp_Figure =
+  {
+   .Active = false,
+  };
+
+/*****************************************************************************/
+/****************************** Private prototypes ***************************/
+/*****************************************************************************/
+
+static unsigned long FigSnp_QuerySELECTusingQueryStr (char *Query,
+						      MYSQL_RES **mysql_res,
+						      const char *MsgError);
+static bool FigSnp_GetSnapshot (const char QueryHash[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1],
+                                long *SnpCod,unsigned *NumCols,time_t *CreatTime);
+static unsigned long FigSnp_GetRowsFromSnapshot (MYSQL_RES **mysql_res,
+                                                 const char *MsgError,
+                                                 long SnpCod,unsigned NumCols);
+static void FigSnp_StoreSnapshot (const char QueryHash[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1],
+                                  MYSQL_RES *mysql_res);
+static void FigSnp_AddRowToValues (char **Values,size_t *Size,size_t *Length,
+                                   long SnpCod,unsigned long NumRow,
+                                   unsigned NumCols,
+                                   MYSQL_ROW row,unsigned long *Lengths);
+static void FigSnp_InsertRowsIntoSnapshot (const char *ColsList,const char *Values);
+static void FigSnp_BuildColsList (unsigned NumCols,
+                                  char ColsList[FigSnp_MAX_BYTES_COLS_LIST + 1]);
+static void FigSnp_RemoveSnapshots (const char *fmt,...);
+static void FigSnp_UpdateOldestTime (time_t Time);
+
+/*****************************************************************************/
+/*********************** Begin/end computing a figure ************************/
+/*****************************************************************************/
+// Between begin and end, the queries made with FigSnp_Query... functions
+// are got from snapshot or stored in snapshot
+
+void FigSnp_BeginFigure (Fig_FigureType_t FigureType,Hie_Level_t Scope,
+                         FigSnp_Mode_t Mode)
+  {
+   FigSnp_Figure.Active     = true;
+   FigSnp_Figure.FigureType = FigureType;
+   FigSnp_Figure.Scope      = Scope;
+   FigSnp_Figure.Mode       = Mode;
+   FigSnp_Figure.OldestTime = (time_t) 0;
+  }
+
+// Return the time of the oldest result used in the figure,
+// or 0 if no result has been got from or stored in snapshot
+
+time_t FigSnp_EndFigure (void)
+  {
+   FigSnp_Figure.Active = false;
+   return FigSnp_Figure.OldestTime;
+  }
+
+/*****************************************************************************/
+/************** Make a SELECT query used to compute a figure *****************/
+/*****************************************************************************/
+
+unsigned long FigSnp_QuerySELECT (MYSQL_RES **mysql_res,const char *MsgError,
+                                  const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   return FigSnp_QuerySELECTusingQueryStr (Query,mysql_res,MsgError);
+  }
+
+/*****************************************************************************/
+/********** Make a SELECT COUNT query used to compute a figure ***************/
+/*****************************************************************************/
+
+unsigned long FigSnp_QueryCOUNT (const char *MsgError,const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned long NumRows;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Make query "SELECT COUNT(*) FROM..." *****/
+   FigSnp_QuerySELECTusingQueryStr (Query,&mysql_res,MsgError);
+
+   /***** Get number of rows *****/
+   row = mysql_fetch_row (mysql_res);
+   if (sscanf (row[0],"%lu",&NumRows) != 1)
+      Lay_ShowErrorAndExit ("Error when counting number of rows.");
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return NumRows;
+  }
+
+/*****************************************************************************/
+/******** Get the result of a query from snapshot or from database ***********/
+/*****************************************************************************/
+// Query string is freed
+
+static unsigned long FigSnp_QuerySELECTusingQueryStr (char *Query,
+						      MYSQL_RES **mysql_res,
+						      const char *MsgError)
+  {
+   char QueryHash[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1];
+   long SnpCod;
+   unsigned NumCols;
+   time_t CreatTime;
+   unsigned long NumRows;
+
+   /***** Not computing a figure ==> make the query as usual *****/
+   if (!FigSnp_Figure.Active)
+     {
+      NumRows = DB_QuerySELECT (mysql_res,MsgError,"%s",Query);
+      free (Query);
+      return NumRows;
+     }
+
+   /***** The query itself identifies the snapshot *****/
+   Cry_EncryptSHA256Base64 (Query,QueryHash);
+
+   /***** Try to get the result from snapshot *****/
+   if (FigSnp_Figure.Mode == FigSnp_GET_FROM_SNAPSHOT)
+      if (FigSnp_GetSnapshot (QueryHash,&SnpCod,&NumCols,&CreatTime))
+	{
+	 free (Query);
+	 FigSnp_UpdateOldestTime (CreatTime);
+	 return FigSnp_GetRowsFromSnapshot (mysql_res,MsgError,SnpCod,NumCols);
+	}
+
+   /***** Make the query and store its result in snapshot *****/
+   NumRows = DB_QuerySELECT (mysql_res,MsgError,"%s",Query);
+   free (Query);
+   FigSnp_StoreSnapshot (QueryHash,*mysql_res);
+   FigSnp_UpdateOldestTime (time (NULL));
+
+   return NumRows;
+  }
+
+/*****************************************************************************/
+/**************** Get the most recent snapshot of a query ********************/
+/*****************************************************************************/
+
+static bool FigSnp_GetSnapshot (const char QueryHash[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1],
+                                long *SnpCod,unsigned *NumCols,time_t *CreatTime)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   bool Found = false;
+
+   /***** Get most recent complete snapshot of this query *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get snapshot of figure",
+		       "SELECT SnpCod,"				// row[0]
+			      "NumCols,"			// row[1]
+			      "UNIX_TIMESTAMP(CreatTime)"	// row[2]
+		       " FROM fig_snapshots"
+		       " WHERE QueryHash='%s'"
+		       " AND Complete='Y'"
+		       " AND CreatTime>FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)"
+		       " ORDER BY SnpCod DESC LIMIT 1",
+		       QueryHash,
+		       (unsigned long) FigSnp_SECONDS_MAX_AGE))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get snapshot code (row[0]), number of columns (row[1])
+         and creation time (row[2]) */
+      if ((*SnpCod = Str_ConvertStrCodToLongCod (row[0])) > 0)
+	 if (sscanf (row[1],"%u",NumCols) == 1)
+	    if (*NumCols && *NumCols <= FigSnp_MAX_COLS)
+	      {
+	       *CreatTime = Dat_GetUNIXTimeFromStr (row[2]);
+	       Found = true;
+	      }
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Found;
+  }
+
+/*****************************************************************************/
+/********************** Get the rows stored in a snapshot ********************/
+/*****************************************************************************/
+// The result has the same columns as the original query,
+// so callers can not distinguish it from the original result
+
+static unsigned long FigSnp_GetRowsFromSnapshot (MYSQL_RES **mysql_res,
+                                                 const char *MsgError,
+                                                 long SnpCod,unsigned NumCols)
+  {
+   char ColsList[FigSnp_MAX_BYTES_COLS_LIST + 1];
+
+   FigSnp_BuildColsList (NumCols,ColsList);
+   return DB_QuerySELECT (mysql_res,MsgError,
+			  "SELECT %s"
+			  " FROM fig_snapshot_rows"
+			  " WHERE SnpCod=%ld"
+			  " ORDER BY NumRow",
+			  ColsList,
+			  SnpCod);
+  }
+
+/*****************************************************************************/
+/******************** Store the result of a query in snapshot ****************/
+/*****************************************************************************/
+
+static void FigSnp_StoreSnapshot (const char QueryHash[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1],
+                                  MYSQL_RES *mysql_res)
+  {
+   unsigned NumCols;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   MYSQL_ROW row;
+   unsigned long *Lengths;
+   long SnpCod;
+   char ColsList[FigSnp_MAX_BYTES_COLS_LIST + 1];
+   char *Values = NULL;		// "(SnpCod,NumRow,...),(SnpCod,NumRow,...),..."
+   size_t Size = 0;
+   size_t Length = 0;
+   unsigned NumRowsInValues = 0;
+
+   /***** Check if the result fits in a snapshot *****/
+   NumCols = (unsigned) mysql_num_fields (mysql_res);
+   NumRows = (unsigned long) mysql_num_rows (mysql_res);
+   if (NumCols == 0 || NumCols > FigSnp_MAX_COLS)
+      return;
+
+   /***** Create a new snapshot, not visible until it is complete *****/
+   SnpCod =
+   DB_QueryINSERTandReturnCode ("can not create snapshot of figure",
+				"INSERT INTO fig_snapshots"
+				" (FigureType,Scope,QueryHash,NumCols,"
+				"Complete,CreatTime)"
+				" VALUES"
+				" (%u,'%s','%s',%u,"
+				"'N',NOW())",
+				(unsigned) FigSnp_Figure.FigureType,
+				Sco_GetDBStrFromScope (FigSnp_Figure.Scope),
+				QueryHash,
+				NumCols);
+
+   /***** Store rows, several rows in each query *****/
+   FigSnp_BuildColsList (NumCols,ColsList);
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      Lengths = mysql_fetch_lengths (mysql_res);
+      FigSnp_AddRowToValues (&Values,&Size,&Length,
+                             SnpCod,NumRow,NumCols,row,Lengths);
+      if (++NumRowsInValues == FigSnp_MAX_ROWS_PER_INSERT ||
+	  Length >= FigSnp_MAX_BYTES_PER_INSERT)
+	{
+	 FigSnp_InsertRowsIntoSnapshot (ColsList,Values);
+	 Length = 0;
+	 NumRowsInValues = 0;
+	}
+     }
+   if (NumRowsInValues)
+      FigSnp_InsertRowsIntoSnapshot (ColsList,Values);
+   free (Values);
+
+   /***** Rewind result to be used by the caller *****/
+   mysql_data_seek (mysql_res,0);
+
+   /***** Make the new snapshot visible *****/
+   DB_QueryUPDATE ("can not update snapshot of figure",
+		   "UPDATE fig_snapshots SET Complete='Y'"
+		   " WHERE SnpCod=%ld",
+		   SnpCod);
+
+   /***** Remove previous snapshots of the same query,
+          except those being stored by other processes *****/
+   FigSnp_RemoveSnapshots ("fig_snapshots.QueryHash='%s'"
+			   " AND fig_snapshots.SnpCod<%ld"
+			   " AND (fig_snapshots.Complete='Y'"
+			   " OR fig_snapshots.CreatTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu))",
+			   QueryHash,
+			   SnpCod,
+			   (unsigned long) FigSnp_SECONDS_TO_COMPLETE);
+  }
+
+/*****************************************************************************/
+/********* Add a row of a result to the list of values to be inserted ********/
+/*****************************************************************************/
+// Values is enlarged when needed. Size is its allocated size.
+// Length is the length of the list of values (0 to begin a new list)
+
+static void FigSnp_AddRowToValues (char **Values,size_t *Size,size_t *Length,
+                                   long SnpCod,unsigned long NumRow,
+                                   unsigned NumCols,
+                                   MYSQL_ROW row,unsigned long *Lengths)
+  {
+   unsigned NumCol;
+   size_t MaxLengthRow;
+   char *Ptr;
+
+   /***** Enlarge list of values if needed *****/
+   for (NumCol = 0, MaxLengthRow = 1 + 1 + 2 * (1 + Cns_MAX_DECIMAL_DIGITS_LONG) + 1 + 1;	// ,(SnpCod,NumRow)\0
+	NumCol < NumCols;
+	NumCol++)
+      MaxLengthRow += row[NumCol] ? 2 * Lengths[NumCol] + 4 :	// ,'escaped value'
+				    5;				// ,NULL
+   if (*Length + MaxLengthRow > *Size)
+     {
+      *Size = 2 * (*Length + MaxLengthRow);
+      if ((*Values = (char *) realloc (*Values,*Size)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+     }
+
+   /***** Add row "(SnpCod,NumRow,Col0,Col1...)" *****/
+   Ptr = *Values + *Length;
+   Ptr += sprintf (Ptr,*Length ? ",(%ld,%lu" :
+				 "(%ld,%lu",
+		   SnpCod,NumRow);
+   for (NumCol = 0;
+	NumCol < NumCols;
+	NumCol++)
+     {
+      *Ptr++ = ',';
+      if (row[NumCol])
+	{
+	 *Ptr++ = '\'';
+	 Ptr += mysql_real_escape_string (&Gbl.mysql,Ptr,
+					  row[NumCol],Lengths[NumCol]);
+	 *Ptr++ = '\'';
+	}
+      else
+	{
+	 memcpy (Ptr,"NULL",4);
+	 Ptr += 4;
+	}
+     }
+   *Ptr++ = ')';
+   *Ptr = '\0';
+
+   *Length = (size_t) (Ptr - *Values);
+  }
+
+/*****************************************************************************/
+/*************** Insert a list of rows of a result in snapshot ***************/
+/*****************************************************************************/
+
+static void FigSnp_InsertRowsIntoSnapshot (const char *ColsList,const char *Values)
+  {
+   DB_QueryINSERT ("can not store snapshot of figure",
+		   "INSERT INTO fig_snapshot_rows"
+		   " (SnpCod,NumRow,%s)"
+		   " VALUES"
+		   " %s",
+		   ColsList,
+		   Values);
+  }
+
+/*****************************************************************************/
+/************* Build the list of columns "Col0,Col1,..." of a snapshot *******/
+/*****************************************************************************/
+
+static void FigSnp_BuildColsList (unsigned NumCols,
+                                  char ColsList[FigSnp_MAX_BYTES_COLS_LIST + 1])
+  {
+   unsigned NumCol;
+   char Col[3 + 10 + 1 + 1];
+
+   for (NumCol = 0, ColsList[0] = '\0';
+	NumCol < NumCols;
+	NumCol++)
+     {
+      snprintf (Col,sizeof (Col),
+	        NumCol ? ",Col%u" :
+	                 "Col%u",
+	        NumCol);
+      Str_Concat (ColsList,Col,FigSnp_MAX_BYTES_COLS_LIST);
+     }
+  }
+
+/*****************************************************************************/
+/************* Get the system-wide figure with the oldest snapshot ***********/
+/*****************************************************************************/
+// Return true if there is a system-wide figure whose snapshot must be updated
+
+bool FigSnp_GetOldestFigureInSystem (Fig_FigureType_t *FigureType)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned UnsignedNum;
+   bool Found = false;
+
+   /***** Get the figure with the oldest snapshot,
+          only if it has not been updated for a day *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get snapshots of figures",
+		       "SELECT FigureType"
+		       " FROM fig_snapshots"
+		       " WHERE Scope='%s'"
+		       " AND Complete='Y'"
+		       " GROUP BY FigureType"
+		       " HAVING MIN(CreatTime)<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)"
+		       " ORDER BY MIN(CreatTime) LIMIT 1",
+		       Sco_GetDBStrFromScope (Hie_SYS),
+		       (unsigned long) FigSnp_SECONDS_TO_UPDATE_SYSTEM))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get figure type (row[0]) */
+      if (sscanf (row[0],"%u",&UnsignedNum) == 1)
+	 if (UnsignedNum < Fig_NUM_FIGURES)
+	   {
+	    *FigureType = (Fig_FigureType_t) UnsignedNum;
+	    Found = true;
+	   }
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Found;
+  }
+
+/*****************************************************************************/
+/************************** Remove old snapshots *****************************/
+/*****************************************************************************/
+
+void FigSnp_RemoveOldSnapshots (void)
+  {
+   FigSnp_RemoveSnapshots ("fig_snapshots.CreatTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)",
+			   (unsigned long) FigSnp_SECONDS_MAX_AGE);
+  }
+
+/*****************************************************************************/
+/************** Remove snapshots that match a condition **********************/
+/*****************************************************************************/
+
+static void FigSnp_RemoveSnapshots (const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Where;
+
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Where,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Remove rows of snapshots *****/
+   DB_QueryDELETE ("can not remove snapshots of figures",
+		   "DELETE fig_snapshot_rows"
+		   " FROM fig_snapshots,fig_snapshot_rows"
+		   " WHERE %s"
+		   " AND fig_snapshots.SnpCod=fig_snapshot_rows.SnpCod",
+		   Where);
+
+   /***** Remove snapshots *****/
+   DB_QueryDELETE ("can not remove snapshots of figures",
+		   "DELETE FROM fig_snapshots"
+		   " WHERE %s",
+		   Where);
+
+   free (Where);
+  }
+
+/*****************************************************************************/
+/************ Update the time of the oldest result used in figure ************/
+/*****************************************************************************/
+
+static void FigSnp_UpdateOldestTime (time_t Time)
+  {
+   if (FigSnp_Figure.OldestTime == (time_t) 0 ||
+       Time < FigSnp_Figure.OldestTime)
+      FigSnp_Figure.OldestTime = Time;
+  }
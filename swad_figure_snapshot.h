@@ -0,0 +1,63 @@
+// swad_figure_snapshot.h: snapshots of figures (global stats) stored in database
+
+#ifndef _SWAD_FIG_SNP
+#define _SWAD_FIG_SNP
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+#include <mysql/mysql.h>	// To access MySQL databases
+#include <time.h>		// For time_t
+
+#include "swad_figure.h"
+#include "swad_hierarchy.h"
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+#define FigSnp_NUM_MODES 2
+typedef enum
+  {
+   FigSnp_GET_FROM_SNAPSHOT,	// Get results from snapshot if it exists and is not too old
+   FigSnp_RECOMPUTE,		// Recompute results and store them in snapshot
+  } FigSnp_Mode_t;
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void FigSnp_BeginFigure (Fig_FigureType_t FigureType,Hie_Level_t Scope,
+                         FigSnp_Mode_t Mode);
+time_t FigSnp_EndFigure (void);
+
+unsigned long FigSnp_QuerySELECT (MYSQL_RES **mysql_res,const char *MsgError,
+                                  const char *fmt,...);
+unsigned long FigSnp_QueryCOUNT (const char *MsgError,const char *fmt,...);
+
+bool FigSnp_GetOldestFigureInSystem (Fig_FigureType_t *FigureType);
+void FigSnp_RemoveOldSnapshots (void);
+
+#endif
@@ -49,6 +49,7 @@
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_ID.h"
+#include "swad_indicator.h"
 #include "swad_logo.h"
 #include "swad_mark.h"
 #include "swad_notification.h"
@@ -57,6 +58,7 @@
 #include "swad_profile.h"
 #include "swad_project.h"
 #include "swad_role.h"
+#include "swad_search_index.h"
 #include "swad_string.h"
 #include "swad_timeline.h"
 #include "swad_zip.h"
@@ -1423,6 +1425,7 @@ static long Brw_GetZoneUsrCodForFiles (void);
 
 static void Brw_RemoveOneFileOrFolderFromDB (const char Path[PATH_MAX + 1]);
 static void Brw_RemoveChildrenOfFolderFromDB (const char Path[PATH_MAX + 1]);
+static void Brw_SetIndicatorsCrsAsDirty (void);
 static void Brw_RenameOneFolderInDB (const char OldPath[PATH_MAX + 1],
                                      const char NewPath[PATH_MAX + 1]);
 static void Brw_RenameChildrenFilesOrFoldersInDB (const char OldPath[PATH_MAX + 1],
@@ -11151,9 +11154,13 @@ long Brw_AddPathToDB (long PublisherUsrCod,Brw_FileType_t FileType,
   {
    long Cod = Brw_GetCodForFiles ();
    long ZoneUsrCod = Brw_GetZoneUsrCodForFiles ();
+   long FilCod;
+
+   /***** Indicators of the course may change *****/
+   Brw_SetIndicatorsCrsAsDirty ();
 
    /***** Add path to the database *****/
-   return
+   FilCod =
    DB_QueryINSERTandReturnCode ("can not add path to database",
 				"INSERT INTO files"
 				" (FileBrowser,Cod,ZoneUsrCod,"
@@ -11169,6 +11176,11 @@ long Brw_AddPathToDB (long PublisherUsrCod,Brw_FileType_t FileType,
 				IsPublic ? 'Y' :
 					   'N',
 				(unsigned) License);
+
+   /***** Index name of file for searches *****/
+   SchIdx_IndexRow (SchIdx_FILE_NAME,FilCod);
+
+   return FilCod;
   }
 
 /*****************************************************************************/
@@ -11187,6 +11199,9 @@ static void Brw_RemoveOneFileOrFolderFromDB (const char Path[PATH_MAX + 1])
    Ntf_MarkNotifOneFileAsRemoved (Path);
    TL_MarkNoteOneFileAsUnavailable (Path);
 
+   /***** Indicators of the course may change *****/
+   Brw_SetIndicatorsCrsAsDirty ();
+
    /***** Remove from database the entries that store the marks properties *****/
    if (FileBrowser == Brw_ADMI_MRK_CRS ||
        FileBrowser == Brw_ADMI_MRK_GRP)
@@ -11207,6 +11222,17 @@ static void Brw_RemoveOneFileOrFolderFromDB (const char Path[PATH_MAX + 1])
 		  " AND files.FilCod=file_view.FilCod",
 	          (unsigned) FileBrowser,Cod,ZoneUsrCod,Path);
 
+   /***** Remove from database the entries that index the name of the file *****/
+   DB_QueryDELETE ("can not remove file from search index",
+		   "DELETE FROM sch_trigrams USING files,sch_trigrams"
+		   " WHERE files.FileBrowser=%u AND files.Cod=%ld"
+		   " AND files.ZoneUsrCod=%ld"
+		   " AND files.Path='%s'"
+		   " AND sch_trigrams.Type=%u"
+		   " AND sch_trigrams.Cod=files.FilCod",
+	           (unsigned) FileBrowser,Cod,ZoneUsrCod,Path,
+	           (unsigned) SchIdx_FILE_NAME);
+
    /***** Remove from database the entry that stores the data of a file *****/
    DB_QueryDELETE ("can not remove path from database",
 		   "DELETE FROM files"
@@ -11231,6 +11257,9 @@ static void Brw_RemoveChildrenOfFolderFromDB (const char Path[PATH_MAX + 1])
    Ntf_MarkNotifChildrenOfFolderAsRemoved (Path);
    TL_MarkNotesChildrenOfFolderAsUnavailable (Path);
 
+   /***** Indicators of the course may change *****/
+   Brw_SetIndicatorsCrsAsDirty ();
+
    /***** Remove from database the entries that store the marks properties *****/
    if (FileBrowser == Brw_ADMI_MRK_CRS ||
        FileBrowser == Brw_ADMI_MRK_GRP)
@@ -11251,6 +11280,17 @@ static void Brw_RemoveChildrenOfFolderFromDB (const char Path[PATH_MAX + 1])
 		  " AND files.FilCod=file_view.FilCod",
                   (unsigned) FileBrowser,Cod,ZoneUsrCod,Path);
 
+   /***** Remove from database the entries that index the names of files *****/
+   DB_QueryDELETE ("can not remove files from search index",
+		   "DELETE FROM sch_trigrams USING files,sch_trigrams"
+		   " WHERE files.FileBrowser=%u AND files.Cod=%ld"
+		   " AND files.ZoneUsrCod=%ld"
+		   " AND files.Path LIKE '%s/%%'"
+		   " AND sch_trigrams.Type=%u"
+		   " AND sch_trigrams.Cod=files.FilCod",
+                   (unsigned) FileBrowser,Cod,ZoneUsrCod,Path,
+                   (unsigned) SchIdx_FILE_NAME);
+
    /***** Remove from database the entries that store the data of files *****/
    DB_QueryDELETE ("can not remove paths from database",
 		   "DELETE FROM files"
@@ -11259,6 +11299,30 @@ static void Brw_RemoveChildrenOfFolderFromDB (const char Path[PATH_MAX + 1])
                    (unsigned) FileBrowser,Cod,ZoneUsrCod,Path);
   }
 
+/*****************************************************************************/
+/******* Set indicators of current course as dirty if they depend on *********/
+/******* the number of files in the current file browser             *********/
+/*****************************************************************************/
+
+static void Brw_SetIndicatorsCrsAsDirty (void)
+  {
+   switch (Brw_FileBrowserForDB_files[Gbl.FileBrowser.Type])
+     {
+      case Brw_ADMI_DOC_CRS:
+      case Brw_ADMI_DOC_GRP:
+      case Brw_ADMI_SHR_CRS:
+      case Brw_ADMI_SHR_GRP:
+	 Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,Ind_MATERIALS);
+	 break;
+      case Brw_ADMI_ASG_USR:
+      case Brw_ADMI_WRK_USR:
+	 Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,Ind_ASSIGNMENTS);
+	 break;
+      default:
+	 break;
+     }
+  }
+
 /*****************************************************************************/
 /*************** Rename a file or folder in table of files *******************/
 /*****************************************************************************/
@@ -11268,6 +11332,7 @@ static void Brw_RenameOneFolderInDB (const char OldPath[PATH_MAX + 1],
   {
    long Cod = Brw_GetCodForFiles ();
    long ZoneUsrCod = Brw_GetZoneUsrCodForFiles ();
+   long FilCod;
 
    /***** Update file or folder in table of common files *****/
    DB_QueryUPDATE ("can not update folder name in a common zone",
@@ -11277,6 +11342,10 @@ static void Brw_RenameOneFolderInDB (const char OldPath[PATH_MAX + 1],
 		   (unsigned) Brw_FileBrowserForDB_files[Gbl.FileBrowser.Type],
 		   Cod,ZoneUsrCod,
 		   OldPath);
+
+   /***** Update name of file or folder in search index *****/
+   if ((FilCod = Brw_GetFilCodByPath (NewPath,false)) > 0)
+      SchIdx_IndexRow (SchIdx_FILE_NAME,FilCod);
   }
 
 /*****************************************************************************/
@@ -26,11 +26,13 @@
 /*****************************************************************************/
 
 #include <stdbool.h>		// For boolean type
+#include <stdlib.h>		// For malloc and free
 #include <string.h>		// For string functions
 
 #include "swad_box.h"
 #include "swad_database.h"
 #include "swad_figure.h"
+#include "swad_figure_snapshot.h"
 #include "swad_follow.h"
 #include "swad_form.h"
 #include "swad_global.h"
@@ -39,6 +41,7 @@
 #include "swad_photo.h"
 #include "swad_privacy.h"
 #include "swad_profile.h"
+#include "swad_random.h"
 #include "swad_user.h"
 
 /*****************************************************************************/
@@ -79,7 +82,7 @@ extern struct Globals Gbl;
 
 static unsigned long Fol_GetUsrsToFollow (unsigned long MaxUsrsToShow,
 					  Fol_WhichUsersSuggestToFollowThem_t WhichUsersSuggestToFollowThem,
-					  MYSQL_RES **mysql_res);
+					  long **UsrCods);
 
 static void Fol_PutIconsWhoToFollow (__attribute__((unused)) void *Args);
 static void Fol_PutIconToUpdateWhoToFollow (void);
@@ -132,8 +135,7 @@ void Fol_SuggestUsrsToFollowMainZone (void)
    extern const char *Hlp_START_Profiles_who_to_follow;
    extern const char *Txt_Who_to_follow;
    extern const char *Txt_No_user_to_whom_you_can_follow_Try_again_later;
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
+   long *UsrCods;
    unsigned long NumUsrs;
    unsigned long NumUsr;
    struct UsrData UsrDat;
@@ -147,7 +149,7 @@ void Fol_SuggestUsrsToFollowMainZone (void)
    /***** Get users *****/
    if ((NumUsrs = Fol_GetUsrsToFollow (Fol_MAX_USRS_TO_FOLLOW_MAIN_ZONE,
                                        Fol_SUGGEST_ANY_USER,
-                                       &mysql_res)))
+                                       &UsrCods)))
      {
       /***** Begin box and table *****/
       Box_BoxTableBegin ("560px",Txt_Who_to_follow,
@@ -162,11 +164,8 @@ void Fol_SuggestUsrsToFollowMainZone (void)
 	   NumUsr < NumUsrs;
 	   NumUsr++)
 	{
-	 /***** Get user *****/
-	 row = mysql_fetch_row (mysql_res);
-
-	 /* Get user's code (row[0]) */
-	 UsrDat.UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	 /***** Get user's code *****/
+	 UsrDat.UsrCod = UsrCods[NumUsr];
 
 	 /***** Show user *****/
 	 if ((NumUsr % Fol_NUM_COLUMNS_FOLLOW) == 0)
@@ -187,8 +186,8 @@ void Fol_SuggestUsrsToFollowMainZone (void)
    else
       Ale_ShowAlert (Ale_INFO,Txt_No_user_to_whom_you_can_follow_Try_again_later);
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free list of users' codes *****/
+   free (UsrCods);
   }
 
 /*****************************************************************************/
@@ -201,8 +200,7 @@ void Fol_SuggestUsrsToFollowMainZoneOnRightColumn (void)
   {
    extern const char *Txt_Who_to_follow;
    extern const char *Txt_No_user_to_whom_you_can_follow_Try_again_later;
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
+   long *UsrCods;
    unsigned long NumUsrs;
    unsigned long NumUsr;
    struct UsrData UsrDat;
@@ -210,7 +208,7 @@ void Fol_SuggestUsrsToFollowMainZoneOnRightColumn (void)
    /***** Get users *****/
    if ((NumUsrs = Fol_GetUsrsToFollow (Fol_MAX_USRS_TO_FOLLOW_RIGHT_COLUMN,
                                        Fol_SUGGEST_ONLY_USERS_WITH_PHOTO,
-                                       &mysql_res)))
+                                       &UsrCods)))
      {
       /***** Start container *****/
       HTM_DIV_Begin ("class=\"CONNECTED\"");
@@ -233,11 +231,8 @@ void Fol_SuggestUsrsToFollowMainZoneOnRightColumn (void)
 	   NumUsr < NumUsrs;
 	   NumUsr++)
 	{
-	 /***** Get user *****/
-	 row = mysql_fetch_row (mysql_res);
-
-	 /* Get user's code (row[0]) */
-	 UsrDat.UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	 /***** Get user's code *****/
+	 UsrDat.UsrCod = UsrCods[NumUsr];
 
 	 /***** Show user *****/
 	 if (Usr_ChkUsrCodAndGetAllUsrDataFromUsrCod (&UsrDat,Usr_DONT_GET_PREFS))
@@ -254,19 +249,34 @@ void Fol_SuggestUsrsToFollowMainZoneOnRightColumn (void)
       HTM_DIV_End ();
      }
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free list of users' codes *****/
+   free (UsrCods);
   }
 
 /*****************************************************************************/
 /*************************** Get users to follow *****************************/
 /*****************************************************************************/
+// Users are chosen at random here, not in database,
+// so candidates are not sorted by RAND() in each query.
+// Codes of users must be freed by the caller
 
 static unsigned long Fol_GetUsrsToFollow (unsigned long MaxUsrsToShow,
 					  Fol_WhichUsersSuggestToFollowThem_t WhichUsersSuggestToFollowThem,
-					  MYSQL_RES **mysql_res)
+					  long **UsrCods)
   {
    extern const char *Pri_VisibilityDB[Pri_NUM_OPTIONS_PRIVACY];
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   struct Rnd_Generator Generator;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   unsigned long NumCandidates = 0;
+   unsigned long NumCandidate;
+   unsigned long NumUsrs;
+   unsigned long NumUsr;
+   unsigned long *Indexes;
+   long *Candidates;
+   long UsrCod;
    char SubQuery1[256];
    char SubQuery2[256];
    char SubQuery3[256];
@@ -309,14 +319,17 @@ static unsigned long Fol_GetUsrsToFollow (unsigned long MaxUsrsToShow,
 	 break;
      }
 
-   /***** Build query to get users to follow *****/
+   /***** Allocate list of candidates
+          (2/3 likely known users and 1/3 likely unknown users) *****/
+   if ((Candidates = (long *) malloc (MaxUsrsToShow * 3 * sizeof (long))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   Rnd_SetRandomSeed (&Generator);
+
+   /***** Get likely known users *****/
    // Get only users with surname 1 and first name
-   return DB_QuerySELECT (mysql_res,"can not get users to follow",
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get users to follow",
 			  "SELECT DISTINCT UsrCod FROM"
 			  " ("
-			  /***** Likely known users *****/
-			  "(SELECT DISTINCT UsrCod FROM"
-			  " ("
 			  // 1. Users followed by my followed
 			  "("
 			  "SELECT DISTINCT usr_follow.FollowedCod AS UsrCod"
@@ -365,13 +378,36 @@ static unsigned long Fol_GetUsrsToFollow (unsigned long MaxUsrsToShow,
 			  // Do not select my followed
 			  " WHERE UsrCod NOT IN"
 			  " (SELECT FollowedCod FROM usr_follow"
-			  " WHERE FollowerCod=%ld)"
-			  // Get only MaxUsrsToShow * 3 users
-			  " ORDER BY RAND() LIMIT %lu"
-			  ")"
-			  " UNION "
-			  "("
-			  /***** Likely unknown userd *****/
+			  " WHERE FollowerCod=%ld)",
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  SubQuery1,
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  SubQuery2,
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  SubQuery3,
+			  Gbl.Usrs.Me.UsrDat.UsrCod);
+
+   /***** Choose only MaxUsrsToShow * 2 likely known users *****/
+   NumUsrs = Rnd_GetSample (&Generator,NumRows,MaxUsrsToShow * 2,&Indexes);
+   for (NumUsr = 0;
+	NumUsr < NumUsrs;
+	NumUsr++)
+     {
+      mysql_data_seek (mysql_res,(my_ulonglong) Indexes[NumUsr]);
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get user's code (row[0]) */
+      Candidates[NumCandidates++] = Str_ConvertStrCodToLongCod (row[0]);
+     }
+   free (Indexes);
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Get likely unknown users *****/
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get users to follow",
 			  // 4. Add some likely unknown random user
 			  // Be careful with the method to get some random users
 			  // from the big table of users.
@@ -392,29 +428,48 @@ static unsigned long Fol_GetUsrsToFollow (unsigned long MaxUsrsToShow,
 			  " WHERE FollowerCod=%ld)"
 			  " AND usr_data.UsrCod>=random_usr.RandomUsrCod"	// random user code could not exists in table of users
 			  // Get only MaxUsrsToShow users
-			  " LIMIT %lu"
-			  ")"
-			  ") AS UsrsToFollow"
-			  // Get only MaxUsrsToShow users
-			  " ORDER BY RAND() LIMIT %lu",
-
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  SubQuery1,
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  SubQuery2,
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  SubQuery3,
-			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  MaxUsrsToShow * 2,		// 2/3 likely known users
-
+			  " LIMIT %lu",
 			  Gbl.Usrs.Me.UsrDat.UsrCod,
 			  SubQuery4,
 			  Gbl.Usrs.Me.UsrDat.UsrCod,
-			  MaxUsrsToShow,		// 1/3 likely unknown users
+			  MaxUsrsToShow);		// 1/3 likely unknown users
+
+   /***** Add likely unknown users not already added *****/
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get user's code (row[0]) */
+      UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+      for (NumCandidate = 0;
+	   NumCandidate < NumCandidates;
+	   NumCandidate++)
+	 if (Candidates[NumCandidate] == UsrCod)
+	    break;
+      if (NumCandidate == NumCandidates)	// Not found
+	 Candidates[NumCandidates++] = UsrCod;
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Choose only MaxUsrsToShow users *****/
+   *UsrCods = NULL;
+   if ((NumUsrs = Rnd_GetSample (&Generator,NumCandidates,MaxUsrsToShow,&Indexes)))
+     {
+      if ((*UsrCods = (long *) malloc (NumUsrs * sizeof (long))) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      for (NumUsr = 0;
+	   NumUsr < NumUsrs;
+	   NumUsr++)
+	 (*UsrCods)[NumUsr] = Candidates[Indexes[NumUsr]];
+     }
+   free (Indexes);
+   free (Candidates);
 
-			  MaxUsrsToShow);
+   return NumUsrs;
   }
 
 /*****************************************************************************/
@@ -1375,76 +1430,76 @@ void Fol_GetAndShowRankingFollowers (void)
      {
       case Hie_SYS:
 	 NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT FollowedCod,COUNT(FollowerCod) AS N"
-				    " FROM usr_follow"
-				    " GROUP BY FollowedCod"
-				    " ORDER BY N DESC,FollowedCod LIMIT 100");
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT FollowedCod,COUNT(FollowerCod) AS N"
+					" FROM usr_follow"
+					" GROUP BY FollowedCod"
+					" ORDER BY N DESC,FollowedCod LIMIT 100");
          break;
       case Hie_CTY:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
-				    " FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_follow.FollowedCod"
-				    " GROUP BY usr_follow.FollowedCod"
-				    " ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
-				    Gbl.Hierarchy.Cty.CtyCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
+					" FROM institutions,centres,degrees,courses,crs_usr,usr_follow"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_follow.FollowedCod"
+					" GROUP BY usr_follow.FollowedCod"
+					" ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
-				    " FROM centres,degrees,courses,crs_usr,usr_follow"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_follow.FollowedCod"
-				    " GROUP BY usr_follow.FollowedCod"
-				    " ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
-				    Gbl.Hierarchy.Ins.InsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
+					" FROM centres,degrees,courses,crs_usr,usr_follow"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_follow.FollowedCod"
+					" GROUP BY usr_follow.FollowedCod"
+					" ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       case Hie_CTR:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
-				    " FROM degrees,courses,crs_usr,usr_follow"
-				    " WHERE degrees.CtrCod=%ld"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_follow.FollowedCod"
-				    " GROUP BY usr_follow.FollowedCod"
-				    " ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
-				    Gbl.Hierarchy.Ctr.CtrCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
+					" FROM degrees,courses,crs_usr,usr_follow"
+					" WHERE degrees.CtrCod=%ld"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_follow.FollowedCod"
+					" GROUP BY usr_follow.FollowedCod"
+					" ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
+					Gbl.Hierarchy.Ctr.CtrCod);
          break;
       case Hie_DEG:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
-				    " FROM courses,crs_usr,usr_follow"
-				    " WHERE courses.DegCod=%ld"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_follow.FollowedCod"
-				    " GROUP BY usr_follow.FollowedCod"
-				    " ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
-				    Gbl.Hierarchy.Deg.DegCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
+					" FROM courses,crs_usr,usr_follow"
+					" WHERE courses.DegCod=%ld"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_follow.FollowedCod"
+					" GROUP BY usr_follow.FollowedCod"
+					" ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
+					Gbl.Hierarchy.Deg.DegCod);
          break;
       case Hie_CRS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
-				    " FROM crs_usr,usr_follow"
-				    " WHERE crs_usr.CrsCod=%ld"
-				    " AND crs_usr.UsrCod=usr_follow.FollowedCod"
-				    " GROUP BY usr_follow.FollowedCod"
-				    " ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
-				    Gbl.Hierarchy.Crs.CrsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT usr_follow.FollowedCod,COUNT(DISTINCT usr_follow.FollowerCod) AS N"
+					" FROM crs_usr,usr_follow"
+					" WHERE crs_usr.CrsCod=%ld"
+					" AND crs_usr.UsrCod=usr_follow.FollowedCod"
+					" GROUP BY usr_follow.FollowedCod"
+					" ORDER BY N DESC,usr_follow.FollowedCod LIMIT 100",
+					Gbl.Hierarchy.Crs.CrsCod);
          break;
       default:
          Lay_WrongScopeExit ();
@@ -42,6 +42,7 @@
 #include "swad_forum.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
+#include "swad_indicator.h"
 #include "swad_layout.h"
 #include "swad_logo.h"
 #include "swad_message.h"
@@ -318,10 +319,18 @@ static void For_UpdateThrLastPst (long ThrCod,long LastPstCod);
 static long For_GetLastPstCod (long ThrCod);
 
 static void For_UpdateThrReadTime (long ThrCod,
-                                   time_t CreatTimeUTCOfTheMostRecentPostRead);
+                                   time_t CreatTimeUTCOfTheMostRecentPostRead,
+                                   unsigned NumUnreadPsts);
+static void For_IncrementNumPstsInThr (long ThrCod);
+static void For_DecrementNumPstsInThr (long ThrCod,long PstCod);
+static void For_AddThrToForumCounters (long ThrCod);
+static void For_RemoveThrFromForumCounters (long ThrCod);
+static void For_AddThrToNumThrsRead (long ThrCod);
+static void For_RemoveThrFromNumThrsRead (long ThrCod);
+static void For_AddThrToForumRead (long ThrCod);
+static void For_RemoveThrFromForumRead (long ThrCod);
 static unsigned For_GetNumOfReadersOfThr (long ThrCod);
 static unsigned For_GetNumOfWritersInThr (long ThrCod);
-static unsigned For_GetNumPstsInThr (long ThrCod);
 static unsigned For_GetNumMyPstInThr (long ThrCod);
 static time_t For_GetThrReadTime (long ThrCod);
 static void For_DeleteThrFromReadThrs (long ThrCod);
@@ -373,10 +382,8 @@ static void For_WriteLinkToForum (const struct For_Forums *Forums,
                                   bool IsLastItemInLevel[1 + For_FORUM_MAX_LEVELS]);
 static unsigned For_GetNumThrsWithNewPstsInForum (struct For_Forum *Forum,
                                                   unsigned NumThreads);
-static unsigned For_GetNumOfThreadsInForumNewerThan (struct For_Forum *Forum,
-                                                     const char *Time);
-static unsigned For_GetNumOfUnreadPostsInThr (long ThrCod,unsigned NumPostsInThr);
-static unsigned For_GetNumOfPostsInThrNewerThan (long ThrCod,const char *Time);
+static unsigned For_GetNumOfThreadsNotOpenedNewerThan (struct For_Forum *Forum,
+                                                       const char *Time);
 
 static void For_WriteNumberOfThrs (unsigned NumThrs);
 static void For_ShowForumThreadsHighlightingOneThread (struct For_Forums *Forums,
@@ -405,6 +412,7 @@ static bool For_CheckIfICanMoveThreads (void);
 static long For_GetThrInMyClipboard (void);
 static bool For_CheckIfThrBelongsToForum (long ThrCod,struct For_Forum *Forum);
 static void For_MoveThrToCurrentForum (const struct For_Forums *Forums);
+static void For_SetIndicatorsCrsAsDirty (const struct For_Forum *Forum);
 static void For_InsertThrInClipboard (long ThrCod);
 static void For_RemoveExpiredThrsClipboards (void);
 static void For_RemoveThrCodFromThrClipboard (long ThrCod);
@@ -591,6 +599,9 @@ static bool For_RemoveForumPst (long PstCod,long MedCod)
       For_RemoveThreadOnly (ThrCod);
       ThreadDeleted = true;
      }
+   else
+      /***** Update counters of posts in the thread *****/
+      For_DecrementNumPstsInThr (ThrCod,PstCod);
 
    /***** Delete post from forum post table *****/
    DB_QueryDELETE ("can not remove a post from a forum",
@@ -662,6 +673,9 @@ static long For_InsertForumThread (const struct For_Forums *Forums,
 
 static void For_RemoveThreadOnly (long ThrCod)
   {
+   /***** Remove thread from counters of its forum *****/
+   For_RemoveThrFromForumCounters (ThrCod);
+
    /***** Indicate that this thread has not been read by anyone *****/
    For_DeleteThrFromReadThrs (ThrCod);
 
@@ -821,19 +835,249 @@ static long For_GetLastPstCod (long ThrCod)
 // (even if any previous pages have been no read actually)
 // Note that database is not updated with the current time,
 // but with the creation time of the most recent post in this thread read by me.
+// NumUnreadPsts is the number of posts in the thread after the last one read.
 
 static void For_UpdateThrReadTime (long ThrCod,
-                                   time_t CreatTimeUTCOfTheMostRecentPostRead)
+                                   time_t CreatTimeUTCOfTheMostRecentPostRead,
+                                   unsigned NumUnreadPsts)
   {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   bool ThrWasOpened = false;
+   bool ThrWasCompletelyRead = false;
+
+   /***** Check if I had opened this thread
+          and if I had read all its posts *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get the status of reading"
+				  " of a thread of a forum",
+		       "SELECT NumUnread FROM forum_thr_read"
+		       " WHERE ThrCod=%ld AND UsrCod=%ld",
+		       ThrCod,Gbl.Usrs.Me.UsrDat.UsrCod))
+     {
+      ThrWasOpened = true;
+      row = mysql_fetch_row (mysql_res);
+      ThrWasCompletelyRead = !strcmp (row[0],"0");
+     }
+   DB_FreeMySQLResult (&mysql_res);
+
    /***** Insert or replace pair ThrCod-UsrCod in forum_thr_read *****/
    DB_QueryREPLACE ("can not update the status of reading"
 		    " of a thread of a forum",
 		    "REPLACE INTO forum_thr_read"
-		    " (ThrCod,UsrCod,ReadTime)"
+		    " (ThrCod,UsrCod,ReadTime,NumUnread)"
 		    " VALUES"
-		    " (%ld,%ld,FROM_UNIXTIME(%ld))",
+		    " (%ld,%ld,FROM_UNIXTIME(%ld),%u)",
 	            ThrCod,Gbl.Usrs.Me.UsrDat.UsrCod,
-	            (long) CreatTimeUTCOfTheMostRecentPostRead);
+	            (long) CreatTimeUTCOfTheMostRecentPostRead,
+	            NumUnreadPsts);
+
+   /***** Update the reading of its forum by me:
+          number of threads opened, number of threads completely read
+          and creation time of the most recent post read *****/
+   DB_QueryINSERT ("can not update the reading of a forum",
+		   "INSERT INTO forum_read"
+		   " (UsrCod,ForumType,Location,"
+		   "NumThrsOpened,NumThrsRead,ReadTime)"
+		   " SELECT %ld,ForumType,Location,"
+		   "1,%u,FROM_UNIXTIME(%ld)"
+		   " FROM forum_thread WHERE ThrCod=%ld"
+		   " ON DUPLICATE KEY UPDATE"
+		   " NumThrsOpened=NumThrsOpened+%u,"
+		   "NumThrsRead=NumThrsRead+%u,"
+		   "ReadTime=GREATEST(ReadTime,VALUES(ReadTime))",
+		   Gbl.Usrs.Me.UsrDat.UsrCod,
+		   NumUnreadPsts ? 0 :
+				   1,
+		   (long) CreatTimeUTCOfTheMostRecentPostRead,
+		   ThrCod,
+		   ThrWasOpened ? 0 :
+				  1,
+		   (!ThrWasCompletelyRead && !NumUnreadPsts) ? 1 :
+							       0);
+  }
+
+/*****************************************************************************/
+/**************** Update counters when a new post is written *****************/
+/*****************************************************************************/
+
+static void For_IncrementNumPstsInThr (long ThrCod)
+  {
+   /***** The thread will not be completely read by anyone *****/
+   For_RemoveThrFromNumThrsRead (ThrCod);
+
+   /***** The new post is unread for all the readers of the thread *****/
+   DB_QueryUPDATE ("can not update the number of unread posts"
+		   " in a thread of a forum",
+		   "UPDATE forum_thr_read SET NumUnread=NumUnread+1"
+		   " WHERE ThrCod=%ld",
+		   ThrCod);
+
+   /***** Increment number of posts in thread *****/
+   DB_QueryUPDATE ("can not update the number of posts"
+		   " in a thread of a forum",
+		   "UPDATE forum_thread SET NumPsts=NumPsts+1"
+		   " WHERE ThrCod=%ld",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/******************* Update counters when a post is removed ******************/
+/*****************************************************************************/
+// Must be called before removing the post from database
+
+static void For_DecrementNumPstsInThr (long ThrCod,long PstCod)
+  {
+   /***** Remove thread from counters of threads read... *****/
+   For_RemoveThrFromNumThrsRead (ThrCod);
+
+   /***** ...the post is no longer unread for those who had not read it... *****/
+   DB_QueryUPDATE ("can not update the number of unread posts"
+		   " in a thread of a forum",
+		   "UPDATE forum_thr_read,forum_post"
+		   " SET forum_thr_read.NumUnread=forum_thr_read.NumUnread-1"
+		   " WHERE forum_thr_read.ThrCod=%ld"
+		   " AND forum_post.PstCod=%ld"
+		   " AND forum_thr_read.ReadTime<forum_post.CreatTime"
+		   " AND forum_thr_read.NumUnread>0",
+		   ThrCod,PstCod);
+
+   /***** ...and add thread again to counters of threads read *****/
+   For_AddThrToNumThrsRead (ThrCod);
+
+   /***** Decrement number of posts in thread *****/
+   DB_QueryUPDATE ("can not update the number of posts"
+		   " in a thread of a forum",
+		   "UPDATE forum_thread SET NumPsts=NumPsts-1"
+		   " WHERE ThrCod=%ld AND NumPsts>0",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/************* Add a thread to the counters of threads of its forum **********/
+/*****************************************************************************/
+
+static void For_AddThrToForumCounters (long ThrCod)
+  {
+   /***** Increment number of threads in forum *****/
+   DB_QueryINSERT ("can not update the number of threads in a forum",
+		   "INSERT INTO forum_num_thrs"
+		   " (ForumType,Location,NumThrs)"
+		   " SELECT ForumType,Location,1"
+		   " FROM forum_thread WHERE ThrCod=%ld"
+		   " ON DUPLICATE KEY UPDATE NumThrs=NumThrs+1",
+		   ThrCod);
+
+   /***** Increment number of threads opened and read in forum *****/
+   For_AddThrToForumRead (ThrCod);
+  }
+
+/*****************************************************************************/
+/********** Remove a thread from the counters of threads of its forum ********/
+/*****************************************************************************/
+
+static void For_RemoveThrFromForumCounters (long ThrCod)
+  {
+   /***** Decrement number of threads opened and read in forum *****/
+   For_RemoveThrFromForumRead (ThrCod);
+
+   /***** Decrement number of threads in forum *****/
+   DB_QueryUPDATE ("can not update the number of threads in a forum",
+		   "UPDATE forum_num_thrs,forum_thread"
+		   " SET forum_num_thrs.NumThrs=forum_num_thrs.NumThrs-1"
+		   " WHERE forum_thread.ThrCod=%ld"
+		   " AND forum_thread.ForumType=forum_num_thrs.ForumType"
+		   " AND forum_thread.Location=forum_num_thrs.Location"
+		   " AND forum_num_thrs.NumThrs>0",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/***** Increment number of threads read in the forum of a thread for all *****/
+/***** the users who have read all the posts of that thread              *****/
+/*****************************************************************************/
+
+static void For_AddThrToNumThrsRead (long ThrCod)
+  {
+   DB_QueryINSERT ("can not update the number of threads read in a forum",
+		   "INSERT INTO forum_read"
+		   " (UsrCod,ForumType,Location,"
+		   "NumThrsOpened,NumThrsRead,ReadTime)"
+		   " SELECT forum_thr_read.UsrCod,"
+		   "forum_thread.ForumType,forum_thread.Location,"
+		   "1,1,forum_thr_read.ReadTime"
+		   " FROM forum_thread,forum_thr_read"
+		   " WHERE forum_thread.ThrCod=%ld"
+		   " AND forum_thread.ThrCod=forum_thr_read.ThrCod"
+		   " AND forum_thr_read.NumUnread=0"
+		   " ON DUPLICATE KEY UPDATE NumThrsRead=NumThrsRead+1",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/***** Decrement number of threads read in the forum of a thread for all *****/
+/***** the users who have read all the posts of that thread              *****/
+/*****************************************************************************/
+
+static void For_RemoveThrFromNumThrsRead (long ThrCod)
+  {
+   DB_QueryUPDATE ("can not update the number of threads read in a forum",
+		   "UPDATE forum_read,forum_thread,forum_thr_read"
+		   " SET forum_read.NumThrsRead=forum_read.NumThrsRead-1"
+		   " WHERE forum_thread.ThrCod=%ld"
+		   " AND forum_thread.ThrCod=forum_thr_read.ThrCod"
+		   " AND forum_thr_read.NumUnread=0"
+		   " AND forum_thr_read.UsrCod=forum_read.UsrCod"
+		   " AND forum_thread.ForumType=forum_read.ForumType"
+		   " AND forum_thread.Location=forum_read.Location"
+		   " AND forum_read.NumThrsRead>0",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/******* Add a thread to the reading of its forum by all its readers *********/
+/*****************************************************************************/
+// Called when a thread is created in a forum or moved to it
+
+static void For_AddThrToForumRead (long ThrCod)
+  {
+   DB_QueryINSERT ("can not update the reading of a forum",
+		   "INSERT INTO forum_read"
+		   " (UsrCod,ForumType,Location,"
+		   "NumThrsOpened,NumThrsRead,ReadTime)"
+		   " SELECT forum_thr_read.UsrCod,"
+		   "forum_thread.ForumType,forum_thread.Location,"
+		   "1,forum_thr_read.NumUnread=0,forum_thr_read.ReadTime"
+		   " FROM forum_thread,forum_thr_read"
+		   " WHERE forum_thread.ThrCod=%ld"
+		   " AND forum_thread.ThrCod=forum_thr_read.ThrCod"
+		   " ON DUPLICATE KEY UPDATE"
+		   " NumThrsOpened=NumThrsOpened+1,"
+		   "NumThrsRead=NumThrsRead+VALUES(NumThrsRead),"
+		   "ReadTime=GREATEST(ReadTime,VALUES(ReadTime))",
+		   ThrCod);
+  }
+
+/*****************************************************************************/
+/**** Remove a thread from the reading of its forum by all its readers *******/
+/*****************************************************************************/
+// Called when a thread is removed from a forum or moved out of it.
+// ReadTime of the forum is not moved back, as it was the last time
+// the user read the forum
+
+static void For_RemoveThrFromForumRead (long ThrCod)
+  {
+   DB_QueryUPDATE ("can not update the reading of a forum",
+		   "UPDATE forum_read,forum_thread,forum_thr_read"
+		   " SET forum_read.NumThrsRead=forum_read.NumThrsRead-"
+		   "(forum_thr_read.NumUnread=0 AND forum_read.NumThrsRead>0),"
+		   "forum_read.NumThrsOpened=forum_read.NumThrsOpened-"
+		   "(forum_read.NumThrsOpened>0)"
+		   " WHERE forum_thread.ThrCod=%ld"
+		   " AND forum_thread.ThrCod=forum_thr_read.ThrCod"
+		   " AND forum_thr_read.UsrCod=forum_read.UsrCod"
+		   " AND forum_thread.ForumType=forum_read.ForumType"
+		   " AND forum_thread.Location=forum_read.Location",
+		   ThrCod);
   }
 
 /*****************************************************************************/
@@ -881,21 +1125,6 @@ static unsigned For_GetNumOfWritersInThr (long ThrCod)
    return NumWriters;
   }
 
-/*****************************************************************************/
-/********************** Get number of posts in a thread **********************/
-/*****************************************************************************/
-
-static unsigned For_GetNumPstsInThr (long ThrCod)
-  {
-   /***** Get number of posts in a thread from database *****/
-   return
-   (unsigned) DB_QueryCOUNT ("can not get the number of posts"
-	                     " in a thread of a forum",
-			     "SELECT COUNT(*) FROM forum_post"
-			     " WHERE ThrCod=%ld",
-			     ThrCod);
-  }
-
 /*****************************************************************************/
 /************** Get whether there are posts of mine in a thread **************/
 /*****************************************************************************/
@@ -980,6 +1209,11 @@ void For_RemoveUsrFromReadThrs (long UsrCod)
 		   " of all the threads of a forum",
 		   "DELETE FROM forum_thr_read WHERE UsrCod=%ld",
 		   UsrCod);
+
+   /***** Delete number of threads read by a user in every forum *****/
+   DB_QueryDELETE ("can not remove the number of threads read by a user",
+		   "DELETE FROM forum_read WHERE UsrCod=%ld",
+		   UsrCod);
   }
 
 /*****************************************************************************/
@@ -1112,7 +1346,8 @@ static void For_ShowPostsOfAThread (struct For_Forums *Forums,
                but with the creation time of the most recent post
                in this page of threads. */
             For_UpdateThrReadTime (Thread.ThrCod,
-                                   CreatTimeUTC);
+                                   CreatTimeUTC,
+                                   NumPsts - NumPst);
 
          /* Show post */
          For_ShowAForumPost (Forums,NumPst,PstCod,
@@ -2276,7 +2511,7 @@ void For_SetForumName (const struct For_Forum *Forum,
   }
 
 /*****************************************************************************/
-/***** Get number of threads with new posts since my last read of a forum ****/
+/****** Get number of threads with posts in a forum not yet read by me *******/
 /*****************************************************************************/
 
 static unsigned For_GetNumThrsWithNewPstsInForum (struct For_Forum *Forum,
@@ -2285,29 +2520,36 @@ static unsigned For_GetNumThrsWithNewPstsInForum (struct For_Forum *Forum,
    char SubQuery[256];
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
-   unsigned long NumRows;
+   unsigned NumThrsOpened;
+   unsigned NumThrsRead;
    unsigned NumThrsWithNewPosts = NumThreads;	// By default, all the threads are new to me
 
-   /***** Get last time I read this forum from database *****/
+   /***** Get number of threads opened and completely read by me
+          in this forum, and last time I read this forum *****/
    if (Forum->Location > 0)
-      sprintf (SubQuery," AND forum_thread.Location=%ld",Forum->Location);
+      sprintf (SubQuery," AND Location=%ld",Forum->Location);
    else
       SubQuery[0] = '\0';
-   NumRows = DB_QuerySELECT (&mysql_res,"can not get the date of reading of a forum",
-			     "SELECT MAX(forum_thr_read.ReadTime)"
-			     " FROM forum_thr_read,forum_thread"
-			     " WHERE forum_thr_read.UsrCod=%ld"
-			     " AND forum_thr_read.ThrCod=forum_thread.ThrCod"
-			     " AND forum_thread.ForumType=%u%s",
-			     Gbl.Usrs.Me.UsrDat.UsrCod,
-			     (unsigned) Forum->Type,SubQuery);
-
-   if (NumRows)
-     {
-      /***** Get number of threads with a last message modify time > newest read time (row[0]) *****/
-      row = mysql_fetch_row (mysql_res);
-      NumThrsWithNewPosts = For_GetNumOfThreadsInForumNewerThan (Forum,row[0]);
-     }
+   DB_QuerySELECT (&mysql_res,"can not get the reading of a forum",
+		   "SELECT SUM(NumThrsOpened),SUM(NumThrsRead),MAX(ReadTime)"
+		   " FROM forum_read"
+		   " WHERE UsrCod=%ld AND ForumType=%u%s",
+		   Gbl.Usrs.Me.UsrDat.UsrCod,
+		   (unsigned) Forum->Type,SubQuery);
+   row = mysql_fetch_row (mysql_res);
+   if (row[0] && row[1] && row[2])
+      if (sscanf (row[0],"%u",&NumThrsOpened) == 1 &&
+	  sscanf (row[1],"%u",&NumThrsRead) == 1)
+	{
+	 /***** Threads opened by me and not completely read have new posts,
+		and threads not opened by me have new posts
+		if their last post is newer than the last time I read the forum *****/
+	 NumThrsWithNewPosts = (NumThrsRead < NumThrsOpened ? NumThrsOpened - NumThrsRead :
+							      0) +
+			       For_GetNumOfThreadsNotOpenedNewerThan (Forum,row[2]);
+	 if (NumThrsWithNewPosts > NumThreads)
+	    NumThrsWithNewPosts = NumThreads;
+	}
 
    /***** Free structure that stores the query result *****/
    DB_FreeMySQLResult (&mysql_res);
@@ -2316,74 +2558,32 @@ static unsigned For_GetNumThrsWithNewPstsInForum (struct For_Forum *Forum,
   }
 
 /*****************************************************************************/
-/**** Get number of threads in forum with a modify time > a specified time ***/
+/******** Get number of threads in forum not opened by me and with a *********/
+/******************* last post newer than a specified time *******************/
 /*****************************************************************************/
 
-static unsigned For_GetNumOfThreadsInForumNewerThan (struct For_Forum *Forum,
-                                                     const char *Time)
+static unsigned For_GetNumOfThreadsNotOpenedNewerThan (struct For_Forum *Forum,
+                                                       const char *Time)
   {
    char SubQuery[256];
 
-   /***** Get number of threads with a last message modify time
-          > specified time from database *****/
    if (Forum->Location > 0)
       sprintf (SubQuery," AND forum_thread.Location=%ld",Forum->Location);
    else
       SubQuery[0] = '\0';
    return
    (unsigned) DB_QueryCOUNT ("can not check if there are new posts in a forum",
-			     "SELECT COUNT(*) FROM forum_thread,forum_post"
-			     " WHERE forum_thread.ForumType=%u%s"
-			     " AND forum_thread.LastPstCod=forum_post.PstCod"
-			     " AND forum_post.ModifTime>'%s'",
-			     (unsigned) Forum->Type,SubQuery,Time);
-  }
-
-/*****************************************************************************/
-/** Get number of unread posts in a thread since my last read of that thread */
-/*****************************************************************************/
-
-static unsigned For_GetNumOfUnreadPostsInThr (long ThrCod,unsigned NumPostsInThr)
-  {
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumRows;
-   unsigned NumUnreadPosts = NumPostsInThr;	// By default, all the posts are unread by me
-
-   /***** Get last time I read this thread from database *****/
-   NumRows = DB_QuerySELECT (&mysql_res,"can not get the date of reading"
-					" of a thread",
-			     "SELECT ReadTime FROM forum_thr_read"
-			     " WHERE ThrCod=%ld AND UsrCod=%ld",
-			     ThrCod,Gbl.Usrs.Me.UsrDat.UsrCod);
-
-   /***** Get if last time I read this thread exists in database *****/
-   if (NumRows)
-     {
-      /***** Get the number of posts in thread with a modify time > newest read time for me (row[0]) *****/
-      row = mysql_fetch_row (mysql_res);
-      NumUnreadPosts = For_GetNumOfPostsInThrNewerThan (ThrCod,row[0]);
-     }
-
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
-
-   return NumUnreadPosts;
-  }
-
-/*****************************************************************************/
-/**** Get number of posts in thread with a modify time > a specified time ****/
-/*****************************************************************************/
-
-static unsigned For_GetNumOfPostsInThrNewerThan (long ThrCod,const char *Time)
-  {
-   /***** Get the number of posts in thread with a modify time > a specified time from database *****/
-   return
-   (unsigned) DB_QueryCOUNT ("can not check if there are new posts"
-			     " in a thread of a forum",
-			     "SELECT COUNT(*) FROM forum_post"
-			     " WHERE ThrCod=%ld AND ModifTime>'%s'",
-			     ThrCod,Time);
+			     "SELECT COUNT(*) FROM forum_post,forum_thread"
+			     " WHERE forum_post.CreatTime>'%s'"
+			     " AND forum_post.PstCod=forum_thread.LastPstCod"
+			     " AND forum_thread.ForumType=%u%s"
+			     " AND NOT EXISTS"
+			     " (SELECT * FROM forum_thr_read"
+			     " WHERE forum_thr_read.ThrCod=forum_thread.ThrCod"
+			     " AND forum_thr_read.UsrCod=%ld)",
+			     Time,
+			     (unsigned) Forum->Type,SubQuery,
+			     Gbl.Usrs.Me.UsrDat.UsrCod);
   }
 
 /*****************************************************************************/
@@ -3045,7 +3245,8 @@ static unsigned For_GetNumThrsInForum (struct For_Forum *Forum)
       SubQuery[0] = '\0';
    return
    (unsigned) DB_QueryCOUNT ("can not get number of threads in a forum",
-			     "SELECT COUNT(*) FROM forum_thread"
+			     "SELECT COALESCE(SUM(NumThrs),0)"
+			     " FROM forum_num_thrs"
 			     " WHERE ForumType=%u%s",
 			     (unsigned) Forum->Type,SubQuery);
   }
@@ -3497,11 +3698,18 @@ static void For_GetThreadData (struct For_Thread *Thr)
 			     "SELECT m0.PstCod,m1.PstCod,m0.UsrCod,m1.UsrCod,"
 			     "UNIX_TIMESTAMP(m0.CreatTime),"
 			     "UNIX_TIMESTAMP(m1.CreatTime),"
-			     "m0.Subject"
-			     " FROM forum_thread,forum_post AS m0,forum_post AS m1"
+			     "m0.Subject,"
+			     "forum_thread.NumPsts,"
+			     "forum_thr_read.NumUnread"
+			     " FROM forum_thread"
+			     " LEFT JOIN forum_thr_read"
+			     " ON forum_thread.ThrCod=forum_thr_read.ThrCod"
+			     " AND forum_thr_read.UsrCod=%ld,"
+			     "forum_post AS m0,forum_post AS m1"
 			     " WHERE forum_thread.ThrCod=%ld"
 			     " AND forum_thread.FirstPstCod=m0.PstCod"
 			     " AND forum_thread.LastPstCod=m1.PstCod",
+			     Gbl.Usrs.Me.UsrDat.UsrCod,
 			     Thr->ThrCod);
 
    /***** The result of the query should have one row *****/
@@ -3543,6 +3751,19 @@ static void For_GetThreadData (struct For_Thread *Thr)
 	        "[%s]",
 		Txt_no_subject);
 
+   /***** Get number of posts in this thread (row[7]) *****/
+   if (sscanf (row[7],"%u",&Thr->NumPosts) != 1)
+      Thr->NumPosts = 0;
+
+   /***** Get number of unread (by me) posts in this thread (row[8]) *****/
+   if (row[8])
+     {
+      if (sscanf (row[8],"%u",&Thr->NumUnreadPosts) != 1)
+	 Thr->NumUnreadPosts = Thr->NumPosts;
+     }
+   else		// I have never read this thread
+      Thr->NumUnreadPosts = Thr->NumPosts;
+
    /***** Free structure that stores the query result *****/
    DB_FreeMySQLResult (&mysql_res);
 
@@ -3553,12 +3774,6 @@ static void For_GetThreadData (struct For_Thread *Thr)
       Thr->Enabled[Order] = For_GetIfPstIsEnabled (Thr->PstCod[Order]);
       // Thr->Enabled[Order] = true;
 
-   /***** Get number of posts in this thread *****/
-   Thr->NumPosts = For_GetNumPstsInThr (Thr->ThrCod);
-
-   /***** Get number of unread (by me) posts in this thread *****/
-   Thr->NumUnreadPosts = For_GetNumOfUnreadPostsInThr (Thr->ThrCod,Thr->NumPosts);
-
    /***** Get number of posts that I have written in this thread *****/
    Thr->NumMyPosts = For_GetNumMyPstInThr (Thr->ThrCod);
 
@@ -3992,6 +4207,9 @@ void For_ReceiveForumPost (void)
 
       /***** Modify last message of the thread *****/
       For_UpdateThrLastPst (Forums.ThrCod,PstCod);
+
+      /***** Update counters of posts in the thread *****/
+      For_IncrementNumPstsInThr (Forums.ThrCod);
      }
    else			// This post is the first of a new thread
      {
@@ -4004,6 +4222,11 @@ void For_ReceiveForumPost (void)
 
       /***** Update first and last posts of new thread *****/
       For_UpdateThrFirstAndLastPst (Forums.ThrCod,PstCod,PstCod);
+
+      /***** Update counters of posts in the thread
+             and of threads in the forum *****/
+      For_IncrementNumPstsInThr (Forums.ThrCod);
+      For_AddThrToForumCounters (Forums.ThrCod);
      }
 
    /***** Free media *****/
@@ -4012,6 +4235,9 @@ void For_ReceiveForumPost (void)
    /***** Increment number of forum posts in my user's figures *****/
    Prf_IncrementNumForPstUsr (Gbl.Usrs.Me.UsrDat.UsrCod);
 
+   /***** Indicators of the course must be computed again *****/
+   For_SetIndicatorsCrsAsDirty (&Forums.Forum);
+
    /***** Notify the new post to users in course *****/
    switch (Forums.Forum.Type)
      {
@@ -4109,6 +4335,7 @@ void For_RemovePost (void)
 
    /***** Remove the post *****/
    ThreadDeleted = For_RemoveForumPst (Forums.PstCod,Media.MedCod);
+   For_SetIndicatorsCrsAsDirty (&Forums.Forum);
 
    /***** Free image *****/
    Med_MediaDestructor (&Media);
@@ -4226,6 +4453,7 @@ void For_RemoveThread (void)
 
       /***** Remove the thread and all its posts *****/
       For_RemoveThreadAndItsPsts (Forums.ThrCod);
+      For_SetIndicatorsCrsAsDirty (&Forums.Forum);
 
       /***** Show forum list again *****/
       For_ShowForumList (&Forums);
@@ -4327,6 +4555,7 @@ void For_PasteThread (void)
      {
       /***** Paste (move) the thread to current forum *****/
       For_MoveThrToCurrentForum (&Forums);
+      For_SetIndicatorsCrsAsDirty (&Forums.Forum);
 
       /***** Show forum list again *****/
       For_ShowForumList (&Forums);
@@ -4410,6 +4639,9 @@ static bool For_CheckIfThrBelongsToForum (long ThrCod,struct For_Forum *Forum)
 
 static void For_MoveThrToCurrentForum (const struct For_Forums *Forums)
   {
+   /***** Remove thread from counters of its old forum *****/
+   For_RemoveThrFromForumCounters (Forums->ThrCod);
+
    /***** Move a thread to current forum *****/
    switch (Forums->Forum.Type)
      {
@@ -4468,6 +4700,20 @@ static void For_MoveThrToCurrentForum (const struct For_Forums *Forums)
 	 Lay_ShowErrorAndExit ("Wrong forum.");
 	 break;
      }
+
+   /***** Add thread to counters of its new forum *****/
+   For_AddThrToForumCounters (Forums->ThrCod);
+  }
+
+/*****************************************************************************/
+/********* Set indicators of the course of a forum as dirty ******************/
+/*****************************************************************************/
+// Only threads and posts in forums of users of a course are indicators
+
+static void For_SetIndicatorsCrsAsDirty (const struct For_Forum *Forum)
+  {
+   if (Forum->Type == For_FORUM_COURSE_USRS)
+      Ind_SetIndicatorsCrsAsDirty (Forum->Location,Ind_ONLINE_TUTORING);
   }
 
 /*****************************************************************************/
@@ -4589,6 +4835,30 @@ void For_RemoveForums (Hie_Level_t Scope,long ForumLocation)
 	           ForumType[Scope].Tchs,
 	           ForumLocation);
 
+   /***** Remove number of threads read *****/
+   DB_QueryDELETE ("can not remove number of threads read in forums",
+		   "DELETE FROM forum_read"
+		   " WHERE"
+		   " (ForumType=%u"
+		   " OR"
+		   " ForumType=%u)"
+		   " AND Location=%ld",
+	           ForumType[Scope].Usrs,
+	           ForumType[Scope].Tchs,
+	           ForumLocation);
+
+   /***** Remove number of threads *****/
+   DB_QueryDELETE ("can not remove number of threads in forums",
+		   "DELETE FROM forum_num_thrs"
+		   " WHERE"
+		   " (ForumType=%u"
+		   " OR"
+		   " ForumType=%u)"
+		   " AND Location=%ld",
+	           ForumType[Scope].Usrs,
+	           ForumType[Scope].Tchs,
+	           ForumLocation);
+
    /***** Remove threads *****/
    DB_QueryDELETE ("can not remove threads in forums",
 		   "DELETE FROM forum_thread"
@@ -0,0 +1,396 @@
+// swad_fragment_cache.c: cache of fragments of HTML pages
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <linux/limits.h>	// For PATH_MAX
+#include <stdio.h>		// For FILE, fopen, rename, snprintf
+#include <sys/stat.h>		// For stat
+#include <unistd.h>		// For unlink
+
+#include "swad_box.h"
+#include "swad_config.h"
+#include "swad_database.h"
+#include "swad_figure.h"
+#include "swad_file.h"
+#include "swad_fragment_cache.h"
+#include "swad_global.h"
+#include "swad_HTML.h"
+#include "swad_info.h"
+#include "swad_timetable.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+// A fragment is stored in a file whose name is built from
+// fragment type, code (of course...), variant, language, role and version.
+// Actions modifying the data shown in a fragment increase its version,
+// so the old files are no longer used and are removed when they get old.
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static struct
+  {
+   bool Generating;			// Is a fragment being generated now?
+   FILE *FileOut;			// Original HTML output while generating fragment
+   FILE *FileFragment;			// Temporary file where fragment is generated
+   char PathTmp[PATH_MAX + 1];		// Path of temporary file
+   char PathFragment[PATH_MAX + 1];	// Path of file in cache
+   unsigned NumHits[Frg_NUM_FRAGMENT_TYPES];	// Hits in this request
+   unsigned NumMisses[Frg_NUM_FRAGMENT_TYPES];	// Misses in this request
+  } Frg_Current =
+  {
+   .Generating = false,
+  };
+
+/*****************************************************************************/
+/****************************** Private prototypes ***************************/
+/*****************************************************************************/
+
+static long Frg_GetVersion (Frg_FragmentType_t FragmentType,long Cod);
+static bool Frg_WriteFragmentFromCache (const char *PathFragment);
+static void Frg_IncreaseNumHitsOrMisses (Frg_FragmentType_t FragmentType,bool Hit);
+static void Frg_RestoreOutputAndCopyFragment (void);
+
+/*****************************************************************************/
+/****************************** Begin a fragment *****************************/
+/*****************************************************************************/
+// If the fragment is in cache, write it to HTML output and return true,
+// so the caller must not generate it.
+// If not, return false and the caller must generate the fragment
+// and then call Frg_EndFragment to store it in cache.
+
+bool Frg_BeginFragment (Frg_FragmentType_t FragmentType,long Cod,unsigned Variant)
+  {
+   /***** Fragments can not be nested *****/
+   if (Frg_Current.Generating)
+      Lay_ShowErrorAndExit ("Fragments of HTML can not be nested.");
+
+   /***** Build path of the fragment in cache *****/
+   snprintf (Frg_Current.PathFragment,sizeof (Frg_Current.PathFragment),
+	     "%s/%u_%ld_%u_%u_%u_%ld.html",
+	     Cfg_PATH_FRAGMENT_CACHE_PRIVATE,
+	     (unsigned) FragmentType,Cod,Variant,
+	     (unsigned) Gbl.Prefs.Language,
+	     (unsigned) Gbl.Usrs.Me.Role.Logged,
+	     Frg_GetVersion (FragmentType,Cod));
+
+   /***** Try to get fragment from cache *****/
+   if (Frg_WriteFragmentFromCache (Frg_Current.PathFragment))
+     {
+      Frg_IncreaseNumHitsOrMisses (FragmentType,true);
+      return true;
+     }
+   Frg_IncreaseNumHitsOrMisses (FragmentType,false);
+
+   /***** Fragment not found in cache ==>
+          redirect HTML output to a temporary file *****/
+   Fil_CreateDirIfNotExists (Cfg_PATH_FRAGMENT_CACHE_PRIVATE);
+   snprintf (Frg_Current.PathTmp,sizeof (Frg_Current.PathTmp),
+	     "%s.%d.tmp",
+	     Frg_Current.PathFragment,(int) Gbl.PID);
+   if ((Frg_Current.FileFragment = fopen (Frg_Current.PathTmp,"w+b")) != NULL)
+     {
+      Frg_Current.Generating = true;
+      Frg_Current.FileOut = Gbl.F.Out;
+      Gbl.F.Out = Frg_Current.FileFragment;
+     }
+   // If temporary file can not be created,
+   // fragment is generated directly into HTML output
+
+   return false;
+  }
+
+/*****************************************************************************/
+/********* End a fragment generated after a call to Frg_BeginFragment ********/
+/*****************************************************************************/
+
+void Frg_EndFragment (void)
+  {
+   if (Frg_Current.Generating)
+     {
+      /***** Restore HTML output and copy generated fragment to it *****/
+      Frg_RestoreOutputAndCopyFragment ();
+
+      /***** Store fragment in cache *****/
+      if (fclose (Frg_Current.FileFragment) ||
+	  rename (Frg_Current.PathTmp,Frg_Current.PathFragment))	// Atomic
+	 unlink (Frg_Current.PathTmp);
+     }
+  }
+
+/*****************************************************************************/
+/************ Abort a fragment when exiting due to an error ******************/
+/*****************************************************************************/
+// The part of the fragment generated so far is written to HTML output,
+// but it's not stored in cache because it may be incomplete
+
+void Frg_AbortFragment (void)
+  {
+   if (Frg_Current.Generating)
+     {
+      /***** Restore HTML output and copy generated fragment to it *****/
+      Frg_RestoreOutputAndCopyFragment ();
+
+      /***** Remove temporary file *****/
+      fclose (Frg_Current.FileFragment);
+      unlink (Frg_Current.PathTmp);
+     }
+  }
+
+/*****************************************************************************/
+/********* Restore HTML output and copy generated fragment to it *************/
+/*****************************************************************************/
+
+static void Frg_RestoreOutputAndCopyFragment (void)
+  {
+   /***** Restore HTML output *****/
+   Gbl.F.Out = Frg_Current.FileOut;
+   Frg_Current.Generating = false;
+
+   /***** Copy generated fragment to HTML output *****/
+   rewind (Frg_Current.FileFragment);
+   Fil_FastCopyOfOpenFiles (Frg_Current.FileFragment,Gbl.F.Out);
+  }
+
+/*****************************************************************************/
+/**************** Write a fragment from cache to HTML output *****************/
+/*****************************************************************************/
+// Return true if fragment found in cache and written
+
+static bool Frg_WriteFragmentFromCache (const char *PathFragment)
+  {
+   struct stat FileStatus;
+   FILE *FileFragment;
+
+   /***** Check if fragment exists and is not too old *****/
+   if (stat (PathFragment,&FileStatus))
+      return false;
+   if (FileStatus.st_mtime + Cfg_TIME_TO_DELETE_FRAGMENT_CACHE < Gbl.StartExecutionTimeUTC)
+      return false;
+
+   /***** Copy fragment to HTML output *****/
+   if ((FileFragment = fopen (PathFragment,"rb")) == NULL)
+      return false;
+   Fil_FastCopyOfOpenFiles (FileFragment,Gbl.F.Out);
+   fclose (FileFragment);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/******** Invalidate all fragments of a type related to a given code *********/
+/*****************************************************************************/
+
+void Frg_InvalidateFragments (Frg_FragmentType_t FragmentType,long Cod)
+  {
+   DB_QueryINSERT ("can not increase version of fragment",
+		   "INSERT INTO frg_versions"
+		   " (FrgType,Cod,Version)"
+		   " VALUES"
+		   " (%u,%ld,1)"
+		   " ON DUPLICATE KEY UPDATE Version=Version+1",
+		   (unsigned) FragmentType,Cod);
+  }
+
+/*****************************************************************************/
+/********** Get current version of fragments of a type and a code ************/
+/*****************************************************************************/
+
+static long Frg_GetVersion (Frg_FragmentType_t FragmentType,long Cod)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   long Version = 0;	// Fragment never invalidated
+
+   if (DB_QuerySELECT (&mysql_res,"can not get version of fragment",
+		       "SELECT Version"
+		       " FROM frg_versions"
+		       " WHERE FrgType=%u AND Cod=%ld",
+		       (unsigned) FragmentType,Cod))
+     {
+      row = mysql_fetch_row (mysql_res);
+      Version = Str_ConvertStrCodToLongCod (row[0]);
+     }
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Version;
+  }
+
+/*****************************************************************************/
+/************ Increase number of hits or misses of a fragment type ***********/
+/*****************************************************************************/
+// Counted in memory and stored in log at the end of the request,
+// so there is no row updated by every page view
+
+static void Frg_IncreaseNumHitsOrMisses (Frg_FragmentType_t FragmentType,bool Hit)
+  {
+   if (Hit)
+      Frg_Current.NumHits[FragmentType]++;
+   else
+      Frg_Current.NumMisses[FragmentType]++;
+  }
+
+/*****************************************************************************/
+/******** Log hits and misses of fragments in this request in database *******/
+/*****************************************************************************/
+
+void Frg_LogAccess (long LogCod)
+  {
+   Frg_FragmentType_t FragmentType;
+
+   for (FragmentType  = (Frg_FragmentType_t) 0;
+	FragmentType <= (Frg_FragmentType_t) (Frg_NUM_FRAGMENT_TYPES - 1);
+	FragmentType++)
+      if (Frg_Current.NumHits[FragmentType] ||
+	  Frg_Current.NumMisses[FragmentType])
+	 DB_QueryINSERT ("can not log access (fragments)",
+			 "INSERT INTO log_frg"
+			 " (LogCod,FrgType,NumHits,NumMisses)"
+			 " VALUES"
+			 " (%ld,%u,%u,%u)",
+			 LogCod,(unsigned) FragmentType,
+			 Frg_Current.NumHits[FragmentType],
+			 Frg_Current.NumMisses[FragmentType]);
+  }
+
+/*****************************************************************************/
+/********************* Remove old fragments from cache ***********************/
+/*****************************************************************************/
+
+void Frg_RemoveOldFragments (void)
+  {
+   Fil_RemoveOldTmpFiles (Cfg_PATH_FRAGMENT_CACHE_PRIVATE,Cfg_TIME_TO_DELETE_FRAGMENT_CACHE,false);
+  }
+
+/*****************************************************************************/
+/************** Show hit ratio of the cache for each fragment type ***********/
+/*****************************************************************************/
+
+void Frg_GetAndShowFragmentCacheStats (void)
+  {
+   extern const char *Hlp_ANALYTICS_Figures_cache;
+   extern const char *Txt_FIGURE_TYPES[Fig_NUM_FIGURES];
+   extern const char *Txt_INFO_SRC_FULL_TEXT[Inf_NUM_INFO_SOURCES];
+   extern const char *Txt_TIMETABLE_TYPES[TT_NUM_TIMETABLE_TYPES];
+   extern const char *Txt_Type;
+   extern const char *Txt_Cache_hits;
+   extern const char *Txt_Cache_misses;
+   extern const char *Txt_Hit_ratio;
+   const char *FragmentName[Frg_NUM_FRAGMENT_TYPES] =
+     {
+      [Frg_CRS_INFO_PLAIN_TXT] = Txt_INFO_SRC_FULL_TEXT[Inf_INFO_SRC_PLAIN_TEXT],
+      [Frg_CRS_INFO_RICH_TXT ] = Txt_INFO_SRC_FULL_TEXT[Inf_INFO_SRC_RICH_TEXT],
+      [Frg_CRS_TIMETABLE     ] = Txt_TIMETABLE_TYPES[TT_COURSE_TIMETABLE],
+     };
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   unsigned FragmentType;
+   unsigned long NumHits;
+   unsigned long NumMisses;
+
+   /***** Get hits and misses of each fragment type from log *****/
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get statistics of cache of fragments",
+			     "SELECT FrgType,"		// row[0]
+				    "SUM(NumHits),"	// row[1]
+				    "SUM(NumMisses)"	// row[2]
+			     " FROM log_frg"
+			     " GROUP BY FrgType"
+			     " ORDER BY FrgType");
+
+   /***** Begin box and table *****/
+   Box_BoxTableBegin (NULL,Txt_FIGURE_TYPES[Fig_FRAGMENT_CACHE],
+                      NULL,NULL,
+                      Hlp_ANALYTICS_Figures_cache,Box_NOT_CLOSABLE,2);
+
+   /***** Heading row *****/
+   HTM_TR_Begin (NULL);
+
+   HTM_TH (1,1,"LM",Txt_Type);
+   HTM_TH (1,1,"RM",Txt_Cache_hits);
+   HTM_TH (1,1,"RM",Txt_Cache_misses);
+   HTM_TH (1,1,"RM",Txt_Hit_ratio);
+
+   HTM_TR_End ();
+
+   /***** Write hits and misses of each fragment type *****/
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get fragment type (row[0]) */
+      if (sscanf (row[0],"%u",&FragmentType) != 1)
+	 continue;
+      if (FragmentType >= Frg_NUM_FRAGMENT_TYPES)
+	 continue;
+
+      /* Get number of hits (row[1]) and misses (row[2]) */
+      if (sscanf (row[1],"%lu",&NumHits) != 1)
+	 NumHits = 0;
+      if (sscanf (row[2],"%lu",&NumMisses) != 1)
+	 NumMisses = 0;
+
+      HTM_TR_Begin (NULL);
+
+      HTM_TD_Begin ("class=\"DAT LM\"");
+      HTM_Txt (FragmentName[FragmentType]);
+      HTM_TD_End ();
+
+      HTM_TD_Begin ("class=\"DAT RM\"");
+      HTM_UnsignedLong (NumHits);
+      HTM_TD_End ();
+
+      HTM_TD_Begin ("class=\"DAT RM\"");
+      HTM_UnsignedLong (NumMisses);
+      HTM_TD_End ();
+
+      HTM_TD_Begin ("class=\"DAT RM\"");
+      HTM_Percentage (NumHits + NumMisses ? (double) NumHits * 100.0 /
+					    (double) (NumHits + NumMisses) :
+					    0.0);
+      HTM_TD_End ();
+
+      HTM_TR_End ();
+     }
+
+   /***** End table and box *****/
+   Box_BoxTableEnd ();
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
@@ -0,0 +1,61 @@
+// swad_fragment_cache.h: cache of fragments of HTML pages
+
+#ifndef _SWAD_FRG
+#define _SWAD_FRG
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+// Fragments must not contain forms, because forms depend on session
+#define Frg_NUM_FRAGMENT_TYPES 3
+typedef enum
+  {
+   Frg_CRS_INFO_PLAIN_TXT,	// Course info written with plain text editor
+   Frg_CRS_INFO_RICH_TXT,	// Course info written with rich text editor (converted by pandoc)
+   Frg_CRS_TIMETABLE,		// Course timetable showing all groups
+  } Frg_FragmentType_t;
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+bool Frg_BeginFragment (Frg_FragmentType_t FragmentType,long Cod,unsigned Variant);
+void Frg_EndFragment (void);
+void Frg_AbortFragment (void);
+
+void Frg_InvalidateFragments (Frg_FragmentType_t FragmentType,long Cod);
+
+void Frg_LogAccess (long LogCod);
+
+void Frg_RemoveOldFragments (void);
+
+void Frg_GetAndShowFragmentCacheStats (void);
+
+#endif
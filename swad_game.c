@@ -2493,10 +2493,13 @@ static void Gam_ExchangeQuestions (long GamCod,
    long QstCodTop;
    long QstCodBottom;
 
-   /***** Lock table to make the move atomic *****/
-   DB_Query ("can not lock tables to move game question",
-	     "LOCK TABLES gam_questions WRITE");
-   Gbl.DB.LockedTables = true;
+   /***** Lock the game to make the move atomic *****/
+   // Only the questions of this game are blocked, not the whole table of questions
+   DB_StartTransactionLockingRows ("can not lock game to move game question",
+				   "SELECT GamCod FROM gam_games"
+				   " WHERE GamCod=%ld"
+				   " FOR UPDATE",
+				   GamCod);
 
    /***** Get question code of the questions to be moved *****/
    QstCodTop    = Gam_GetQstCodFromQstInd (GamCod,QstIndTop);
@@ -2538,11 +2541,8 @@ static void Gam_ExchangeQuestions (long GamCod,
 		   QstIndBottom,
 		   GamCod,QstCodTop);
 
-   /***** Unlock table *****/
-   Gbl.DB.LockedTables = false;	// Set to false before the following unlock...
-				// ...to not retry the unlock if error in unlocking
-   DB_Query ("can not unlock tables after moving game questions",
-	     "UNLOCK TABLES");
+   /***** Commit changes and unlock the game *****/
+   DB_CommitTransaction ();
   }
 
 /*****************************************************************************/
@@ -134,6 +134,7 @@ void Gbl_InitializeGlobals (void)
 
    Gbl.DB.DatabaseIsOpen = false;
    Gbl.DB.LockedTables = false;
+   Gbl.DB.InTransaction = false;
 
    Gbl.HiddenParamsInsertedIntoDB = false;
 
@@ -183,6 +184,7 @@ void Gbl_InitializeGlobals (void)
    Gbl.Usrs.Me.MyDegs.Filled = false;
    Gbl.Usrs.Me.MyCrss.Filled = false;
    Gbl.Usrs.Me.MyCrss.Num = 0;
+   CodSet_ResetSet (&Gbl.Usrs.Me.MyCrss.Cods);
    Gbl.Usrs.Me.ConfirmEmailJustSent = false;	// An email to confirm my email address has not just been sent
 
    Gbl.Usrs.Other.UsrDat.UsrCod = -1L;
@@ -37,6 +37,7 @@
 #include "swad_assignment.h"
 #include "swad_box.h"
 #include "swad_centre.h"
+#include "swad_code_set.h"
 #include "swad_connected.h"
 #include "swad_config.h"
 #include "swad_country.h"
@@ -130,6 +131,7 @@ struct Globals
      {
       bool DatabaseIsOpen;
       bool LockedTables;
+      bool InTransaction;
      } DB;
 
    bool HiddenParamsInsertedIntoDB;	// If parameters are inserted in the database in this execution
@@ -180,7 +182,6 @@ struct Globals
    struct Date Yesterday;
    unsigned RowEvenOdd;	// To alternate row colors in listings
    char *ColorRows[2];
-   const char *XMLPtr;
    struct
      {
       char FileName[PATH_MAX + 1];
@@ -313,6 +314,7 @@ struct Globals
                Rol_Role_t Role;
                long DegCod;
               } Crss[Crs_MAX_COURSES_PER_USR];
+            struct CodSet_CodeSet Cods;	// Codes of my courses, sorted to be searched
            } MyCrss;
 	 Usr_ShowUsrsType_t ListType;	// My preference about user's list type
 	 unsigned NumFollowers;	// Number of users who follow me
@@ -37,6 +37,7 @@
 #include "swad_database.h"
 #include "swad_exam_session.h"
 #include "swad_form.h"
+#include "swad_fragment_cache.h"
 #include "swad_game.h"
 #include "swad_global.h"
 #include "swad_group.h"
@@ -58,6 +59,10 @@
 #define Grp_GROUPS_SECTION_ID		"grps"
 #define Grp_NEW_GROUP_SECTION_ID	"new_grp"
 
+#define Grp_MAX_TRIES_TO_CHANGE_GRPS	5	// Tries to change groups when other transactions have locked them
+
+#define Grp_MAX_BYTES_LOCK_NAME	(16 + Cns_MAX_DECIMAL_DIGITS_LONG)	// "swad_grp_usr_<UsrCod>"
+
 static const bool Grp_ICanChangeGrps[Rol_NUM_ROLES] =
   {
    [Rol_UNK    ] = false,
@@ -105,8 +110,15 @@ static void Grp_PutIconToCreateNewGroup (void);
 
 static void Grp_PutCheckboxAllGrps (Grp_WhichGroups_t GroupsSelectableByStdsOrNETs);
 
-static void Grp_LockTables (void);
-static void Grp_UnlockTables (void);
+static Grp_ResultOfChanges_t Grp_ChangeMyGrpsInTransaction (struct ListCodGrps *LstGrpsIWant,
+                                                            const struct ListCodGrps *LstGrpsIBelong);
+static bool Grp_ChangeGrpsOtherUsrInTransaction (struct ListCodGrps *LstGrpsUsrWants,
+                                                 const struct ListCodGrps *LstGrpsUsrBelongs);
+static bool Grp_GetLockOfUsr (long UsrCod,char LockName[Grp_MAX_BYTES_LOCK_NAME + 1]);
+static bool Grp_LockGrpsOfUsr (long UsrCod,const struct ListCodGrps *LstGrpsUsrWants,
+                               struct ListCodGrps *LstGrpsUsrBelongs);
+static void Grp_AppendLstCodGrps (char *GrpCods,size_t MaxLengthGrpCods,
+                                  const struct ListCodGrps *LstGrps);
 
 static void Grp_ConstructorListGrpAlreadySelec (struct ListGrpsAlreadySelec **AlreadyExistsGroupOfType);
 static void Grp_DestructorListGrpAlreadySelec (struct ListGrpsAlreadySelec **AlreadyExistsGroupOfType);
@@ -143,7 +155,7 @@ static unsigned long Grp_CountNumUsrsInNoGrpsOfType (Rol_Role_t Role,long GrpTyp
 static bool Grp_CheckIfIBelongToGrpsOfType (long GrpTypCod);
 static void Grp_GetLstCodGrpsUsrBelongs (long CrsCod,long GrpTypCod,long UsrCod,
                                          struct ListCodGrps *LstGrps);
-static bool Grp_CheckIfGrpIsInList (long GrpCod,struct ListCodGrps *LstGrps);
+static bool Grp_CheckIfGrpIsInList (long GrpCod,const struct ListCodGrps *LstGrps);
 static bool Grp_CheckIfOpenTimeInTheFuture (time_t OpenTimeUTC);
 static bool Grp_CheckIfGroupTypeNameExists (const char *GrpTypName,long GrpTypCod);
 static bool Grp_CheckIfGroupNameExists (long GrpTypCod,const char *GrpName,long GrpCod);
@@ -666,9 +678,10 @@ void Grp_ChangeMyGrps (Cns_QuietOrVerbose_t QuietOrVerbose)
    extern const char *Txt_The_requested_group_changes_were_successful;
    extern const char *Txt_There_has_been_no_change_in_groups;
    extern const char *Txt_In_a_type_of_group_with_single_enrolment_students_can_not_be_registered_in_more_than_one_group;
+   extern const char *Txt_Groups_are_being_changed_by_other_users_Please_try_again;
    struct ListCodGrps LstGrpsIWant;
    bool MySelectionIsValid;
-   bool ChangesMade;
+   Grp_ResultOfChanges_t ResultOfChanges;
 
    /***** Can I change my groups? *****/
    if (Grp_ICanChangeGrps[Gbl.Usrs.Me.Role.Logged])
@@ -697,16 +710,27 @@ void Grp_ChangeMyGrps (Cns_QuietOrVerbose_t QuietOrVerbose)
       /***** Change my groups *****/
       if (MySelectionIsValid)
 	{
-	 ChangesMade = Grp_ChangeMyGrpsAtomically (&LstGrpsIWant);
+	 ResultOfChanges = Grp_ChangeMyGrpsAtomically (&LstGrpsIWant);
 	 if (QuietOrVerbose == Cns_VERBOSE)
-	   {
-	    if (ChangesMade)
-	       Ale_CreateAlert (Ale_SUCCESS,NULL,
-		                Txt_The_requested_group_changes_were_successful);
-	    else
-	       Ale_CreateAlert (Ale_WARNING,NULL,
-		                Txt_There_has_been_no_change_in_groups);
-	   }
+	    switch (ResultOfChanges)
+	      {
+	       case Grp_CHANGES_NOT_MADE:
+		  Ale_CreateAlert (Ale_WARNING,NULL,
+				   Txt_There_has_been_no_change_in_groups);
+		  break;
+	       case Grp_CHANGES_MADE:
+		  Ale_CreateAlert (Ale_SUCCESS,NULL,
+				   Txt_The_requested_group_changes_were_successful);
+		  break;
+	       case Grp_GROUPS_LOCKED:
+		  Ale_CreateAlert (Ale_WARNING,NULL,
+				   Txt_Groups_are_being_changed_by_other_users_Please_try_again);
+		  break;
+	       case Grp_SELECTION_NOT_VALID:
+		  Ale_CreateAlert (Ale_WARNING,NULL,
+				   Txt_In_a_type_of_group_with_single_enrolment_students_can_not_be_registered_in_more_than_one_group);
+		  break;
+	      }
 	}
       else if (QuietOrVerbose == Cns_VERBOSE)
 	 Ale_CreateAlert (Ale_WARNING,NULL,
@@ -764,11 +788,61 @@ void Grp_ChangeOtherUsrGrps (void)
 /*****************************************************************************/
 /********************** Change my groups atomically **************************/
 /*****************************************************************************/
-// Return true if desired changes are made
 
-bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
+Grp_ResultOfChanges_t Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
   {
+   char LockName[Grp_MAX_BYTES_LOCK_NAME + 1];
    struct ListCodGrps LstGrpsIBelong;
+   unsigned NumTry;
+   Grp_ResultOfChanges_t ResultOfChanges;
+
+   /***** Only one change of my groups at a time *****/
+   if (!Grp_GetLockOfUsr (Gbl.Usrs.Me.UsrDat.UsrCod,LockName))
+      return Grp_GROUPS_LOCKED;
+
+   for (NumTry = 0;
+	NumTry < Grp_MAX_TRIES_TO_CHANGE_GRPS;
+	NumTry++)
+     {
+      /***** Start a transaction to make the inscription atomic *****/
+      DB_StartTransaction ();
+
+      /***** Lock only the groups involved in the changes
+             and get the groups I belong to *****/
+      if (Grp_LockGrpsOfUsr (Gbl.Usrs.Me.UsrDat.UsrCod,LstGrpsIWant,
+			     &LstGrpsIBelong))
+	{
+	 /***** Change my groups and commit changes *****/
+	 ResultOfChanges = Grp_ChangeMyGrpsInTransaction (LstGrpsIWant,
+							  &LstGrpsIBelong);
+	 if (ResultOfChanges == Grp_CHANGES_MADE)
+	    DB_CommitTransaction ();
+	 else
+	    DB_RollbackTransaction ();
+
+	 /***** Free memory with the list of groups which I belonged to *****/
+	 Grp_FreeListCodGrp (&LstGrpsIBelong);
+
+	 DB_ReleaseNamedLock (LockName);
+	 return ResultOfChanges;
+	}
+
+      /***** Groups locked by other transactions ==> try again *****/
+      DB_RollbackTransaction ();
+     }
+
+   DB_ReleaseNamedLock (LockName);
+   return Grp_GROUPS_LOCKED;
+  }
+
+/*****************************************************************************/
+/****************** Change my groups inside a transaction ********************/
+/*****************************************************************************/
+// Return Grp_CHANGES_MADE if desired changes are made
+
+static Grp_ResultOfChanges_t Grp_ChangeMyGrpsInTransaction (struct ListCodGrps *LstGrpsIWant,
+                                                            const struct ListCodGrps *LstGrpsIBelong)
+  {
    unsigned NumGrpTyp;
    unsigned NumGrpIBelong;
    unsigned NumGrpIWant;
@@ -779,29 +853,32 @@ bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
    bool ITryToRegisterInFullGroup    = false;
    bool RemoveMeFromThisGrp;
    bool RegisterMeInThisGrp;
-   bool ChangesMade = false;
-
-   /***** Lock tables to make the inscription atomic *****/
-   Grp_LockTables ();
+   Grp_ResultOfChanges_t ResultOfChanges = Grp_CHANGES_NOT_MADE;
 
    /***** Get list of groups types and groups in this course *****/
    Grp_GetListGrpTypesAndGrpsInThisCrs (Grp_ONLY_GROUP_TYPES_WITH_GROUPS);
 
-   /***** Query in the database the group codes which I belong to *****/
-   Grp_GetLstCodGrpsUsrBelongs (Gbl.Hierarchy.Crs.CrsCod,-1L,
-				Gbl.Usrs.Me.UsrDat.UsrCod,&LstGrpsIBelong);
+   /***** Check again, with groups locked, that I will not belong
+          to more than one group of a type of single enrolment.
+          The groups I will belong to after the changes
+          are exactly the groups I want *****/
+   if (!Grp_CheckIfSelectionGrpsSingleEnrolmentIsValid (Gbl.Usrs.Me.Role.Logged,LstGrpsIWant))
+     {
+      Grp_FreeListGrpTypesAndGrps ();
+      return Grp_SELECTION_NOT_VALID;
+     }
 
    if (Gbl.Usrs.Me.Role.Logged == Rol_STD)
      {
       /***** Go across the list of groups which I belong to and check if I try to leave a closed group *****/
       for (NumGrpIBelong = 0;
-	   NumGrpIBelong < LstGrpsIBelong.NumGrps && !ITryToLeaveAClosedGroup;
+	   NumGrpIBelong < LstGrpsIBelong->NumGrps && !ITryToLeaveAClosedGroup;
 	   NumGrpIBelong++)
 	{
 	 for (NumGrpIWant = 0, RemoveMeFromThisGrp = true;
 	      NumGrpIWant < LstGrpsIWant->NumGrps && RemoveMeFromThisGrp;
 	      NumGrpIWant++)
-	    if (LstGrpsIBelong.GrpCods[NumGrpIBelong] == LstGrpsIWant->GrpCods[NumGrpIWant])
+	    if (LstGrpsIBelong->GrpCods[NumGrpIBelong] == LstGrpsIWant->GrpCods[NumGrpIWant])
 	       RemoveMeFromThisGrp = false;
 	 if (RemoveMeFromThisGrp)
 	    /* Check if the group is closed */
@@ -813,7 +890,7 @@ bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
 	       for (NumGrpThisType = 0;
 		    NumGrpThisType < GrpTyp->NumGrps && !ITryToLeaveAClosedGroup;
 		    NumGrpThisType++)
-		  if ((GrpTyp->LstGrps[NumGrpThisType]).GrpCod == LstGrpsIBelong.GrpCods[NumGrpIBelong])
+		  if ((GrpTyp->LstGrps[NumGrpThisType]).GrpCod == LstGrpsIBelong->GrpCods[NumGrpIBelong])
 		     if (!((GrpTyp->LstGrps[NumGrpThisType]).Open))
 			ITryToLeaveAClosedGroup = true;
 	      }
@@ -829,9 +906,9 @@ bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
 	      NumGrpIWant++)
 	   {
 	    for (NumGrpIBelong = 0, RegisterMeInThisGrp = true;
-		 NumGrpIBelong < LstGrpsIBelong.NumGrps && RegisterMeInThisGrp;
+		 NumGrpIBelong < LstGrpsIBelong->NumGrps && RegisterMeInThisGrp;
 		 NumGrpIBelong++)
-	       if (LstGrpsIWant->GrpCods[NumGrpIWant] == LstGrpsIBelong.GrpCods[NumGrpIBelong])
+	       if (LstGrpsIWant->GrpCods[NumGrpIWant] == LstGrpsIBelong->GrpCods[NumGrpIBelong])
 		  RegisterMeInThisGrp = false;
 	    if (RegisterMeInThisGrp)
 	       /* Check if the group is closed or full */
@@ -867,16 +944,16 @@ bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
      {
       /***** Go across the list of groups I belong to, removing those groups that are not present in the list of groups I want to belong to *****/
       for (NumGrpIBelong = 0;
-	   NumGrpIBelong < LstGrpsIBelong.NumGrps;
+	   NumGrpIBelong < LstGrpsIBelong->NumGrps;
 	   NumGrpIBelong++)
 	{
 	 for (NumGrpIWant = 0, RemoveMeFromThisGrp = true;
 	      NumGrpIWant < LstGrpsIWant->NumGrps && RemoveMeFromThisGrp;
 	      NumGrpIWant++)
-	    if (LstGrpsIBelong.GrpCods[NumGrpIBelong] == LstGrpsIWant->GrpCods[NumGrpIWant])
+	    if (LstGrpsIBelong->GrpCods[NumGrpIBelong] == LstGrpsIWant->GrpCods[NumGrpIWant])
 	       RemoveMeFromThisGrp = false;
 	 if (RemoveMeFromThisGrp)
-	    Grp_RemoveUsrFromGroup (Gbl.Usrs.Me.UsrDat.UsrCod,LstGrpsIBelong.GrpCods[NumGrpIBelong]);
+	    Grp_RemoveUsrFromGroup (Gbl.Usrs.Me.UsrDat.UsrCod,LstGrpsIBelong->GrpCods[NumGrpIBelong]);
 	}
 
       /***** Go across the list of groups that I want to register in, adding those groups that are not present in the list of groups I belong to *****/
@@ -885,64 +962,118 @@ bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant)
 	   NumGrpIWant++)
 	{
 	 for (NumGrpIBelong = 0, RegisterMeInThisGrp = true;
-	      NumGrpIBelong < LstGrpsIBelong.NumGrps && RegisterMeInThisGrp;
+	      NumGrpIBelong < LstGrpsIBelong->NumGrps && RegisterMeInThisGrp;
 	      NumGrpIBelong++)
-	    if (LstGrpsIWant->GrpCods[NumGrpIWant] == LstGrpsIBelong.GrpCods[NumGrpIBelong])
+	    if (LstGrpsIWant->GrpCods[NumGrpIWant] == LstGrpsIBelong->GrpCods[NumGrpIBelong])
 	       RegisterMeInThisGrp = false;
 	 if (RegisterMeInThisGrp)
 	    Grp_AddUsrToGroup (&Gbl.Usrs.Me.UsrDat,LstGrpsIWant->GrpCods[NumGrpIWant]);
 	}
 
-      ChangesMade = true;
+      ResultOfChanges = Grp_CHANGES_MADE;
      }
 
-   /***** Free memory with the list of groups which I belonged to *****/
-   Grp_FreeListCodGrp (&LstGrpsIBelong);
-
-   /***** Unlock tables after changes in my groups *****/
-   Grp_UnlockTables ();
-
    /***** Free list of groups types and groups in this course *****/
    Grp_FreeListGrpTypesAndGrps ();
 
-   return ChangesMade;
+   return ResultOfChanges;
   }
 
 /*****************************************************************************/
-/********************** Change my groups atomically **************************/
+/***************** Change groups of another user atomically ******************/
 /*****************************************************************************/
 
 void Grp_ChangeGrpsOtherUsrAtomically (struct ListCodGrps *LstGrpsUsrWants)
   {
+   extern const char *Txt_Groups_are_being_changed_by_other_users_Please_try_again;
+   extern const char *Txt_In_a_type_of_group_with_single_enrolment_students_can_not_be_registered_in_more_than_one_group;
+   char LockName[Grp_MAX_BYTES_LOCK_NAME + 1];
    struct ListCodGrps LstGrpsUsrBelongs;
+   unsigned NumTry;
+
+   /***** Only one change of the user's groups at a time *****/
+   if (Grp_GetLockOfUsr (Gbl.Usrs.Other.UsrDat.UsrCod,LockName))
+     {
+      for (NumTry = 0;
+	   NumTry < Grp_MAX_TRIES_TO_CHANGE_GRPS;
+	   NumTry++)
+	{
+	 /***** Start a transaction to make the inscription atomic *****/
+	 DB_StartTransaction ();
+
+	 /***** Lock only the groups involved in the changes
+		and get the groups the user belongs to *****/
+	 if (Grp_LockGrpsOfUsr (Gbl.Usrs.Other.UsrDat.UsrCod,LstGrpsUsrWants,
+				&LstGrpsUsrBelongs))
+	   {
+	    /***** Change user's groups and commit changes *****/
+	    if (Grp_ChangeGrpsOtherUsrInTransaction (LstGrpsUsrWants,
+						     &LstGrpsUsrBelongs))
+	       DB_CommitTransaction ();
+	    else
+	      {
+	       DB_RollbackTransaction ();
+	       Ale_CreateAlert (Ale_WARNING,NULL,
+				Txt_In_a_type_of_group_with_single_enrolment_students_can_not_be_registered_in_more_than_one_group);
+	      }
+
+	    /***** Free memory with the list of groups which user belonged to *****/
+	    Grp_FreeListCodGrp (&LstGrpsUsrBelongs);
+
+	    DB_ReleaseNamedLock (LockName);
+	    return;
+	   }
+
+	 /***** Groups locked by other transactions ==> try again *****/
+	 DB_RollbackTransaction ();
+	}
+
+      DB_ReleaseNamedLock (LockName);
+     }
+
+   Ale_CreateAlert (Ale_WARNING,NULL,
+		    Txt_Groups_are_being_changed_by_other_users_Please_try_again);
+  }
+
+/*****************************************************************************/
+/*************** Change groups of another user in a transaction **************/
+/*****************************************************************************/
+// Return false if changes are not made because selection is not valid
+
+static bool Grp_ChangeGrpsOtherUsrInTransaction (struct ListCodGrps *LstGrpsUsrWants,
+                                                 const struct ListCodGrps *LstGrpsUsrBelongs)
+  {
    unsigned NumGrpUsrBelongs;
    unsigned NumGrpUsrWants;
    bool RemoveUsrFromThisGrp;
    bool RegisterUsrInThisGrp;
 
-   /***** Lock tables to make the inscription atomic *****/
-   if (Gbl.Usrs.Other.UsrDat.Roles.InCurrentCrs.Role == Rol_STD)
-      Grp_LockTables ();
-
    /***** Get list of groups types and groups in this course *****/
    Grp_GetListGrpTypesAndGrpsInThisCrs (Grp_ONLY_GROUP_TYPES_WITH_GROUPS);
 
-   /***** Query in the database the group codes which user belongs to *****/
-   Grp_GetLstCodGrpsUsrBelongs (Gbl.Hierarchy.Crs.CrsCod,-1L,
-				Gbl.Usrs.Other.UsrDat.UsrCod,&LstGrpsUsrBelongs);
+   /***** Check again, with groups locked, that the user will not belong
+          to more than one group of a type of single enrolment.
+          The groups the user will belong to after the changes
+          are exactly the groups the user wants *****/
+   if (!Grp_CheckIfSelectionGrpsSingleEnrolmentIsValid (Gbl.Usrs.Other.UsrDat.Roles.InCurrentCrs.Role,
+							LstGrpsUsrWants))
+     {
+      Grp_FreeListGrpTypesAndGrps ();
+      return false;
+     }
 
    /***** Go across the list of groups user belongs to, removing those groups that are not present in the list of groups user wants to belong to *****/
    for (NumGrpUsrBelongs = 0;
-	NumGrpUsrBelongs < LstGrpsUsrBelongs.NumGrps;
+	NumGrpUsrBelongs < LstGrpsUsrBelongs->NumGrps;
 	NumGrpUsrBelongs++)
      {
       for (NumGrpUsrWants = 0, RemoveUsrFromThisGrp = true;
 	   NumGrpUsrWants < LstGrpsUsrWants->NumGrps && RemoveUsrFromThisGrp;
 	   NumGrpUsrWants++)
-	 if (LstGrpsUsrBelongs.GrpCods[NumGrpUsrBelongs] == LstGrpsUsrWants->GrpCods[NumGrpUsrWants])
+	 if (LstGrpsUsrBelongs->GrpCods[NumGrpUsrBelongs] == LstGrpsUsrWants->GrpCods[NumGrpUsrWants])
 	    RemoveUsrFromThisGrp = false;
       if (RemoveUsrFromThisGrp)
-	 Grp_RemoveUsrFromGroup (Gbl.Usrs.Other.UsrDat.UsrCod,LstGrpsUsrBelongs.GrpCods[NumGrpUsrBelongs]);
+	 Grp_RemoveUsrFromGroup (Gbl.Usrs.Other.UsrDat.UsrCod,LstGrpsUsrBelongs->GrpCods[NumGrpUsrBelongs]);
      }
 
    /***** Go across the list of groups that user wants to register in, adding those groups that are not present in the list of groups user belongs to *****/
@@ -951,52 +1082,132 @@ void Grp_ChangeGrpsOtherUsrAtomically (struct ListCodGrps *LstGrpsUsrWants)
 	NumGrpUsrWants++)
      {
       for (NumGrpUsrBelongs = 0, RegisterUsrInThisGrp = true;
-	   NumGrpUsrBelongs < LstGrpsUsrBelongs.NumGrps && RegisterUsrInThisGrp;
+	   NumGrpUsrBelongs < LstGrpsUsrBelongs->NumGrps && RegisterUsrInThisGrp;
 	   NumGrpUsrBelongs++)
-	 if (LstGrpsUsrWants->GrpCods[NumGrpUsrWants] == LstGrpsUsrBelongs.GrpCods[NumGrpUsrBelongs])
+	 if (LstGrpsUsrWants->GrpCods[NumGrpUsrWants] == LstGrpsUsrBelongs->GrpCods[NumGrpUsrBelongs])
 	    RegisterUsrInThisGrp = false;
       if (RegisterUsrInThisGrp)
 	 Grp_AddUsrToGroup (&Gbl.Usrs.Other.UsrDat,LstGrpsUsrWants->GrpCods[NumGrpUsrWants]);
      }
 
-   /***** Free memory with the list of groups which user belonged to *****/
-   Grp_FreeListCodGrp (&LstGrpsUsrBelongs);
-
-   /***** Unlock tables after changes in groups *****/
-   if (Gbl.Usrs.Other.UsrDat.Roles.InCurrentCrs.Role == Rol_STD)
-      Grp_UnlockTables ();
-
    /***** Free list of groups types and groups in this course *****/
    Grp_FreeListGrpTypesAndGrps ();
+
+   return true;
   }
 
 /*****************************************************************************/
-/*********** Lock tables to make the registration in groups atomic ***********/
+/************** Get a lock to change the groups of a user ********************/
 /*****************************************************************************/
+// Changes of groups of the same user are serialized, so two requests
+// of a student to join two different groups of a type of single enrolment
+// can not both read the groups the student belongs to before the other commits.
+// Rows of different groups are locked in these requests, so they do not wait
+// for each other without this lock.
+// Return false if another request is changing the groups of this user.
+// If true is returned, the lock must be released by the caller
 
-static void Grp_LockTables (void)
+static bool Grp_GetLockOfUsr (long UsrCod,char LockName[Grp_MAX_BYTES_LOCK_NAME + 1])
   {
-   DB_Query ("can not lock tables to change user's groups",
-	     "LOCK TABLES "
-	     "crs_grp_types WRITE,"
-	     "crs_grp WRITE,"
-	     "crs_grp_usr WRITE,"
-	     "crs_usr READ,"
-	     "crs_usr_last READ,"
-	     "rooms READ");
-   Gbl.DB.LockedTables = true;
+   snprintf (LockName,Grp_MAX_BYTES_LOCK_NAME + 1,
+	     "swad_grp_usr_%ld",
+	     UsrCod);
+   return DB_GetNamedLock (LockName);
   }
 
 /*****************************************************************************/
-/*********** Unlock tables after changes in registration in groups ***********/
+/****** Lock the groups a user belongs to and the groups he/she wants ********/
 /*****************************************************************************/
+// Only the rows of these groups are locked until the end of the transaction,
+// so users can change their groups at the same time if groups are different.
+// The number of students in a locked group can not be changed by others,
+// so it can be checked against the maximum before registering a student.
+// Rows are locked in order of group code to avoid deadlocks.
+// The groups the user belongs to are got again after locking,
+// because they may have been changed by other transaction
+// before the locks were taken. All of them must be locked.
+// Return false if groups can not be locked because of other transactions.
+// If true is returned, LstGrpsUsrBelongs must be freed by the caller
 
-static void Grp_UnlockTables (void)
+static bool Grp_LockGrpsOfUsr (long UsrCod,const struct ListCodGrps *LstGrpsUsrWants,
+                               struct ListCodGrps *LstGrpsUsrBelongs)
   {
-   Gbl.DB.LockedTables = false;	// Set to false before the following unlock...
-				// ...to not retry the unlock if error in unlocking
-   DB_Query ("can not unlock tables after changing user's groups",
-	     "UNLOCK TABLES");
+   struct ListCodGrps LstGrpsToLock;
+   unsigned NumGrp;
+   size_t MaxLengthGrpCods;
+   char *GrpCods;
+   bool Locked = true;
+
+   /***** Get groups the user belongs to before locking *****/
+   Grp_GetLstCodGrpsUsrBelongs (Gbl.Hierarchy.Crs.CrsCod,-1L,
+				UsrCod,&LstGrpsToLock);
+
+   if (LstGrpsToLock.NumGrps + LstGrpsUsrWants->NumGrps)
+     {
+      /***** Build list of codes of groups *****/
+      MaxLengthGrpCods = (LstGrpsToLock.NumGrps + LstGrpsUsrWants->NumGrps) *
+	                 (Cns_MAX_DECIMAL_DIGITS_LONG + 1) - 1;
+      if ((GrpCods = (char *) malloc (MaxLengthGrpCods + 1)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      GrpCods[0] = '\0';
+      Grp_AppendLstCodGrps (GrpCods,MaxLengthGrpCods,&LstGrpsToLock);
+      Grp_AppendLstCodGrps (GrpCods,MaxLengthGrpCods,LstGrpsUsrWants);
+
+      /***** Lock groups *****/
+      Locked = DB_QueryLockRows ("can not lock groups",
+				 "SELECT GrpCod FROM crs_grp"
+				 " WHERE GrpCod IN (%s)"
+				 " ORDER BY GrpCod"
+				 " FOR UPDATE",
+				 GrpCods);
+
+      free (GrpCods);
+     }
+
+   if (Locked)
+     {
+      /***** Get groups the user belongs to after locking *****/
+      Grp_GetLstCodGrpsUsrBelongs (Gbl.Hierarchy.Crs.CrsCod,-1L,
+				   UsrCod,LstGrpsUsrBelongs);
+
+      /***** If the user has been registered in a group not locked,
+             the transaction must be tried again *****/
+      for (NumGrp = 0;
+	   Locked && NumGrp < LstGrpsUsrBelongs->NumGrps;
+	   NumGrp++)
+	 Locked = Grp_CheckIfGrpIsInList (LstGrpsUsrBelongs->GrpCods[NumGrp],&LstGrpsToLock) ||
+		  Grp_CheckIfGrpIsInList (LstGrpsUsrBelongs->GrpCods[NumGrp],LstGrpsUsrWants);
+      if (!Locked)
+	 Grp_FreeListCodGrp (LstGrpsUsrBelongs);
+     }
+
+   /***** Free memory with the list of groups locked *****/
+   Grp_FreeListCodGrp (&LstGrpsToLock);
+
+   return Locked;
+  }
+
+/*****************************************************************************/
+/********* Append the codes in a list of groups to a list of codes ***********/
+/*****************************************************************************/
+
+static void Grp_AppendLstCodGrps (char *GrpCods,size_t MaxLengthGrpCods,
+                                  const struct ListCodGrps *LstGrps)
+  {
+   unsigned NumGrp;
+   char GrpCod[Cns_MAX_DECIMAL_DIGITS_LONG + 1];
+
+   for (NumGrp = 0;
+	NumGrp < LstGrps->NumGrps;
+	NumGrp++)
+     {
+      if (GrpCods[0])
+	 Str_Concat (GrpCods,",",MaxLengthGrpCods);
+      snprintf (GrpCod,sizeof (GrpCod),
+		"%ld",
+		LstGrps->GrpCods[NumGrp]);
+      Str_Concat (GrpCods,GrpCod,MaxLengthGrpCods);
+     }
   }
 
 /*****************************************************************************/
@@ -2754,7 +2965,6 @@ void Grp_GetListGrpTypesInThisCrs (Grp_WhichGroupTypes_t WhichGroupTypes)
    Grp_OpenGroupsAutomatically ();
 
    /***** Get group types with groups + groups types without groups from database *****/
-   // The tables in the second part of the UNION requires ALIAS in order to LOCK TABLES when registering in groups
    switch (WhichGroupTypes)
      {
       case Grp_ONLY_GROUP_TYPES_WITH_GROUPS:
@@ -3677,7 +3887,7 @@ void Grp_GetLstCodGrpsWithFileZonesIBelong (struct ListCodGrps *LstGrps)
 /******** Check if a group is in a list of groups which I belong to **********/
 /*****************************************************************************/
 
-static bool Grp_CheckIfGrpIsInList (long GrpCod,struct ListCodGrps *LstGrps)
+static bool Grp_CheckIfGrpIsInList (long GrpCod,const struct ListCodGrps *LstGrps)
   {
    unsigned NumGrp;
 
@@ -4144,6 +4354,7 @@ static void Grp_RemoveGroupTypeCompletely (void)
 		   " WHERE GrpCod IN"
 		   " (SELECT GrpCod FROM crs_grp WHERE GrpTypCod=%ld)",
                    Gbl.Crs.Grps.GrpTyp.GrpTypCod);
+   Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
    /***** Remove all the students in groups of this type *****/
    DB_QueryDELETE ("can not remove users from all groups of a type",
@@ -4204,6 +4415,7 @@ static void Grp_RemoveGroupCompletely (void)
    DB_QueryUPDATE ("can not update a group in course timetable",
 		   "UPDATE timetable_crs SET GrpCod=-1 WHERE GrpCod=%ld",
                    Gbl.Crs.Grps.GrpCod);
+   Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
    /***** Remove all the students in this group *****/
    DB_QueryDELETE ("can not remove users from a group",
@@ -4401,6 +4613,7 @@ void Grp_ChangeGroupType (void)
       DB_QueryUPDATE ("can not update the type of a group",
 		      "UPDATE crs_grp SET GrpTypCod=%ld WHERE GrpCod=%ld",
                       NewGrpTypCod,Gbl.Crs.Grps.GrpCod);
+      Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
       /* Create message to show the change made */
       AlertType = Ale_SUCCESS;
@@ -4443,6 +4656,7 @@ void Grp_ChangeGroupRoom (void)
    DB_QueryUPDATE ("can not update the room of a group",
 		   "UPDATE crs_grp SET RooCod=%ld WHERE GrpCod=%ld",
 		   NewRooCod,Gbl.Crs.Grps.GrpCod);
+   Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
    /* Create message to show the change made */
    AlertType = Ale_SUCCESS;
@@ -4750,6 +4964,7 @@ void Grp_RenameGroupType (void)
 			    " WHERE GrpTypCod=%ld",
                             NewNameGrpTyp,
                             Gbl.Crs.Grps.GrpTyp.GrpTypCod);
+            Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
             /***** Write message to show the change made *****/
 	    AlertType = Ale_SUCCESS;
@@ -4834,6 +5049,7 @@ void Grp_RenameGroup (void)
             DB_QueryUPDATE ("can not update the name of a group",
         		    "UPDATE crs_grp SET GrpName='%s' WHERE GrpCod=%ld",
                             NewNameGrp,Gbl.Crs.Grps.GrpCod);
+            Frg_InvalidateFragments (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod);
 
             /***** Write message to show the change made *****/
 	    AlertType = Ale_SUCCESS;
@@ -55,6 +55,15 @@ typedef enum
    Grp_ALL_GROUP_TYPES,
   } Grp_WhichGroupTypes_t;
 
+#define Grp_NUM_RESULTS_OF_CHANGES 4
+typedef enum
+  {
+   Grp_CHANGES_NOT_MADE,	// Changes not allowed (closed or full groups)
+   Grp_CHANGES_MADE,
+   Grp_GROUPS_LOCKED,		// Groups locked by other users, changes not made
+   Grp_SELECTION_NOT_VALID,	// More than one group of a type of single enrolment
+  } Grp_ResultOfChanges_t;
+
 // Related with groups
 struct GroupData
   {
@@ -173,7 +182,7 @@ void Grp_FreeListCodSelectedGrps (void);
 void Grp_ChangeMyGrpsAndShowChanges (void);
 void Grp_ChangeMyGrps (Cns_QuietOrVerbose_t QuietOrVerbose);
 void Grp_ChangeOtherUsrGrps (void);
-bool Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant);
+Grp_ResultOfChanges_t Grp_ChangeMyGrpsAtomically (struct ListCodGrps *LstGrpsIWant);
 void Grp_ChangeGrpsOtherUsrAtomically (struct ListCodGrps *LstGrpsUsrWants);
 bool Grp_CheckIfSelectionGrpsSingleEnrolmentIsValid (Rol_Role_t Role,struct ListCodGrps *LstGrps);
 void Grp_RegisterUsrIntoGroups (struct UsrData *UsrDat,struct ListCodGrps *LstGrps);
@@ -3477,6 +3477,27 @@ const char *Hlp_ANALYTICS_Figures_cookies =
 	"ANALYTICS.Figures.en#cookies";
 #endif
 
+const char *Hlp_ANALYTICS_Figures_cache =
+#if   L==1
+	"ANALYTICS.Figures.es#cache";
+#elif L==2
+	"ANALYTICS.Figures.en#cache";
+#elif L==3
+	"ANALYTICS.Figures.en#cache";
+#elif L==4
+	"ANALYTICS.Figures.es#cache";
+#elif L==5
+	"ANALYTICS.Figures.en#cache";
+#elif L==6
+	"ANALYTICS.Figures.es#cache";
+#elif L==7
+	"ANALYTICS.Figures.en#cache";
+#elif L==8
+	"ANALYTICS.Figures.en#cache";
+#elif L==9
+	"ANALYTICS.Figures.en#cache";
+#endif
+
 const char *Hlp_ANALYTICS_Degrees =
 #if   L==1
 	"ANALYTICS.Degrees.es";
@@ -32,6 +32,7 @@
 #include "swad_database.h"
 #include "swad_form.h"
 #include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_logo.h"
 
@@ -520,7 +521,8 @@ void Hie_InitHierarchy (void)
    /***** If course code is available, get course data *****/
    if (Gbl.Hierarchy.Crs.CrsCod > 0)
      {
-      if (Crs_GetDataOfCourseByCod (&Gbl.Hierarchy.Crs))	// Course found
+      if (HieSnp_GetDataOfCourseByCod (&Gbl.Hierarchy.Crs) ||	// Course found in snapshot...
+	  Crs_GetDataOfCourseByCod (&Gbl.Hierarchy.Crs))	// ...or in database
          Gbl.Hierarchy.Deg.DegCod = Gbl.Hierarchy.Crs.DegCod;
       else
          Hie_ResetHierarchy ();
@@ -529,11 +531,9 @@ void Hie_InitHierarchy (void)
    /***** If degree code is available, get degree data *****/
    if (Gbl.Hierarchy.Deg.DegCod > 0)
      {
-      if (Deg_GetDataOfDegreeByCod (&Gbl.Hierarchy.Deg))	// Degree found
-	{
-	 Gbl.Hierarchy.Ctr.CtrCod = Gbl.Hierarchy.Deg.CtrCod;
-         Gbl.Hierarchy.Ins.InsCod = Deg_GetInsCodOfDegreeByCod (Gbl.Hierarchy.Deg.DegCod);
-	}
+      if (HieSnp_GetDataOfDegreeByCod (&Gbl.Hierarchy.Deg) ||	// Degree found in snapshot...
+	  Deg_GetDataOfDegreeByCod (&Gbl.Hierarchy.Deg))	// ...or in database
+	 Gbl.Hierarchy.Ctr.CtrCod = Gbl.Hierarchy.Deg.CtrCod;	// Institution is got from centre
       else
          Hie_ResetHierarchy ();
      }
@@ -541,7 +541,8 @@ void Hie_InitHierarchy (void)
    /***** If centre code is available, get centre data *****/
    if (Gbl.Hierarchy.Ctr.CtrCod > 0)
      {
-      if (Ctr_GetDataOfCentreByCod (&Gbl.Hierarchy.Ctr))	// Centre found
+      if (HieSnp_GetDataOfCentreByCod (&Gbl.Hierarchy.Ctr) ||	// Centre found in snapshot...
+	  Ctr_GetDataOfCentreByCod (&Gbl.Hierarchy.Ctr))	// ...or in database
          Gbl.Hierarchy.Ins.InsCod = Gbl.Hierarchy.Ctr.InsCod;
       else
          Hie_ResetHierarchy ();
@@ -550,7 +551,8 @@ void Hie_InitHierarchy (void)
    /***** If institution code is available, get institution data *****/
    if (Gbl.Hierarchy.Ins.InsCod > 0)
      {
-      if (Ins_GetDataOfInstitutionByCod (&Gbl.Hierarchy.Ins))	// Institution found
+      if (HieSnp_GetDataOfInstitutionByCod (&Gbl.Hierarchy.Ins) ||	// Institution found in snapshot...
+	  Ins_GetDataOfInstitutionByCod (&Gbl.Hierarchy.Ins))		// ...or in database
 	 Gbl.Hierarchy.Cty.CtyCod = Gbl.Hierarchy.Ins.CtyCod;
       else
          Hie_ResetHierarchy ();
@@ -558,7 +560,8 @@ void Hie_InitHierarchy (void)
 
    /***** If country code is available, get country data *****/
    if (Gbl.Hierarchy.Cty.CtyCod > 0)
-      if (!Cty_GetDataOfCountryByCod (&Gbl.Hierarchy.Cty))		// Country not found
+      if (!HieSnp_GetDataOfCountryByCod (&Gbl.Hierarchy.Cty) &&	// Country not found in snapshot...
+	  !Cty_GetDataOfCountryByCod (&Gbl.Hierarchy.Cty))	// ...nor in database
          Hie_ResetHierarchy ();
 
    /***** Set current hierarchy level and code
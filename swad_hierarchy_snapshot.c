@@ -0,0 +1,1087 @@
+// swad_hierarchy_snapshot.c: snapshot of the hierarchy stored in a file mapped into memory
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <fcntl.h>		// For open, O_RDONLY...
+#include <linux/limits.h>	// For PATH_MAX
+#include <stdio.h>		// For snprintf, rename
+#include <stdlib.h>		// For bsearch, free, realloc
+#include <string.h>		// For memcmp, memcpy, memset, strlen
+#include <sys/file.h>		// For flock
+#include <sys/mman.h>		// For mmap, munmap
+#include <sys/stat.h>		// For fstat, futimens, stat
+#include <time.h>		// For clock_gettime
+#include <unistd.h>		// For close, pwrite, unlink
+
+#include "swad_config.h"
+#include "swad_database.h"
+#include "swad_file.h"
+#include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
+#include "swad_language.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+// The data of countries, institutions, centres, degrees and courses
+// are got from a snapshot file mapped into memory, instead of from database.
+// Any change in the hierarchy updates the modification time of a version file.
+// A snapshot begun before that time is rebuilt by only one process,
+// holding a lock on a lock file, while others use the old snapshot.
+// The new snapshot replaces the old one by renaming it atomically.
+#define HieSnp_FILE_SNAPSHOT	"snapshot"
+#define HieSnp_FILE_VERSION	"version"
+#define HieSnp_FILE_LOCK	"lock"
+
+#define HieSnp_MAGIC		"SWADHIE1"
+#define HieSnp_BYTES_MAGIC	8
+
+#define HieSnp_ALIGN		16	// Alignment of the arrays of records in the file
+
+#define HieSnp_SECONDS_MAX_AGE	((time_t) (60UL * 60UL))	// Rebuild snapshot at least every hour
+
+#define HieSnp_MAX_BYTES_SUBQUERY_CTYS	((1 + Lan_NUM_LANGUAGES) * 16)
+
+/*****************************************************************************/
+/******************************* Private types *******************************/
+/*****************************************************************************/
+
+struct HieSnp_Header
+  {
+   char Magic[HieSnp_BYTES_MAGIC];
+   size_t SizeOfRecord[Hie_NUM_LEVELS];	// To discard snapshots written by other versions
+   struct timespec CreatTime;		// When the snapshot began to be built
+   size_t NumRecords[Hie_NUM_LEVELS];
+   size_t OffsetRecords[Hie_NUM_LEVELS];	// From the beginning of the file
+   size_t OffsetStrings;			// From the beginning of the file
+   size_t Size;				// Size of the file
+  };
+
+/* Records are ordered by code, and code must be their first field */
+/* Strings are stored as offsets from the beginning of strings */
+struct HieSnp_Cty
+  {
+   long CtyCod;
+   char Alpha2[2 + 1];
+   size_t Name[1 + Lan_NUM_LANGUAGES];
+   size_t WWW [1 + Lan_NUM_LANGUAGES];
+  };
+
+struct HieSnp_Ins
+  {
+   long InsCod;
+   long CtyCod;
+   Ins_Status_t Status;
+   long RequesterUsrCod;
+   size_t ShrtName;
+   size_t FullName;
+   size_t WWW;
+  };
+
+struct HieSnp_Ctr
+  {
+   long CtrCod;
+   long InsCod;
+   long PlcCod;
+   Ctr_Status_t Status;
+   long RequesterUsrCod;
+   struct Coordinates Coord;
+   size_t ShrtName;
+   size_t FullName;
+   size_t WWW;
+  };
+
+struct HieSnp_Deg
+  {
+   long DegCod;
+   long DegTypCod;
+   long CtrCod;
+   Deg_Status_t Status;
+   long RequesterUsrCod;
+   size_t ShrtName;
+   size_t FullName;
+   size_t WWW;
+  };
+
+struct HieSnp_Crs
+  {
+   long CrsCod;
+   long DegCod;
+   unsigned Year;
+   Crs_Status_t Status;
+   long RequesterUsrCod;
+   size_t InstitutionalCrsCod;
+   size_t ShrtName;
+   size_t FullName;
+  };
+
+struct HieSnp_Buffer
+  {
+   char *Data;
+   size_t Length;
+   size_t Size;
+  };
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static const size_t HieSnp_SizeOfRecord[Hie_NUM_LEVELS] =
+  {
+   [Hie_UNK] = 0,
+   [Hie_SYS] = 0,
+   [Hie_CTY] = sizeof (struct HieSnp_Cty),
+   [Hie_INS] = sizeof (struct HieSnp_Ins),
+   [Hie_CTR] = sizeof (struct HieSnp_Ctr),
+   [Hie_DEG] = sizeof (struct HieSnp_Deg),
+   [Hie_CRS] = sizeof (struct HieSnp_Crs),
+  };
+
+static struct
+  {
+   bool Checked;	// Has the snapshot been checked in this execution?
+   char *Base;		// Snapshot mapped into memory (NULL if not available)
+   size_t Size;
+   bool ChangedByMe;	// Has hierarchy been changed in this execution?
+  } HieSnp_Snapshot =
+  {
+   .Checked     = false,
+   .Base        = NULL,
+   .Size        = 0,
+   .ChangedByMe = false,
+  };
+
+/*****************************************************************************/
+/****************************** Private prototypes ***************************/
+/*****************************************************************************/
+
+static const void *HieSnp_SearchRecord (Hie_Level_t Level,long Cod);
+static int HieSnp_CompareCods (const void *Cod1,const void *Cod2);
+static const char *HieSnp_GetString (size_t Offset);
+
+static const struct HieSnp_Header *HieSnp_GetSnapshot (void);
+static bool HieSnp_MapSnapshot (void);
+static bool HieSnp_MapFile (int FileDescriptor);
+static bool HieSnp_CheckSnapshot (const struct HieSnp_Header *Header,size_t Size);
+static bool HieSnp_CheckIfSnapshotIsUpToDate (void);
+static void HieSnp_UnmapFile (void);
+static void HieSnp_UnmapSnapshot (void);
+static int HieSnp_LockToBuildSnapshot (void);
+
+static void HieSnp_BuildAndMapSnapshot (void);
+static void HieSnp_AddCountries (struct HieSnp_Buffer *Records,
+                                 struct HieSnp_Buffer *Strings);
+static void HieSnp_AddInstitutions (struct HieSnp_Buffer *Records,
+                                    struct HieSnp_Buffer *Strings);
+static void HieSnp_AddCentres (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings);
+static void HieSnp_AddDegrees (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings);
+static void HieSnp_AddCourses (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings);
+static size_t HieSnp_AppendToBuffer (struct HieSnp_Buffer *Buffer,
+                                     const void *Data,size_t Length);
+static size_t HieSnp_AppendString (struct HieSnp_Buffer *Strings,
+                                   const char *Str);
+static bool HieSnp_WriteFile (int FileDescriptor,
+                              const struct HieSnp_Header *Header,
+                              const struct HieSnp_Buffer Records[Hie_NUM_LEVELS],
+                              const struct HieSnp_Buffer *Strings);
+
+static void HieSnp_GetVersion (struct timespec *Version);
+static int HieSnp_CompareTimes (const struct timespec *Time1,
+                                const struct timespec *Time2);
+static void HieSnp_BuildPath (char Path[PATH_MAX + 1],const char *FileName);
+static size_t HieSnp_Align (size_t Offset);
+
+/*****************************************************************************/
+/******************** Get data of a country from snapshot ********************/
+/*****************************************************************************/
+// Return false if the country is not found in snapshot,
+// so the caller must get it from database
+
+bool HieSnp_GetDataOfCountryByCod (struct Country *Cty)
+  {
+   const struct HieSnp_Cty *Rec;
+   Lan_Language_t Lan;
+
+   if ((Rec = HieSnp_SearchRecord (Hie_CTY,Cty->CtyCod)) == NULL)
+      return false;
+
+   Str_Copy (Cty->Alpha2,Rec->Alpha2,
+	     2);
+   for (Lan  = (Lan_Language_t) 1;
+	Lan <= (Lan_Language_t) Lan_NUM_LANGUAGES;
+	Lan++)
+     {
+      Str_Copy (Cty->Name[Lan],HieSnp_GetString (Rec->Name[Lan]),
+		Cty_MAX_BYTES_NAME);
+      Str_Copy (Cty->WWW[Lan],HieSnp_GetString (Rec->WWW[Lan]),
+		Cns_MAX_BYTES_WWW);
+     }
+   Cty->NumUsrsWhoClaimToBelongToCty.Valid = false;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/****************** Get data of an institution from snapshot *****************/
+/*****************************************************************************/
+// Return false if the institution is not found in snapshot,
+// so the caller must get it from database
+
+bool HieSnp_GetDataOfInstitutionByCod (struct Instit *Ins)
+  {
+   const struct HieSnp_Ins *Rec;
+
+   if ((Rec = HieSnp_SearchRecord (Hie_INS,Ins->InsCod)) == NULL)
+      return false;
+
+   Ins->CtyCod          = Rec->CtyCod;
+   Ins->Status          = Rec->Status;
+   Ins->RequesterUsrCod = Rec->RequesterUsrCod;
+   Str_Copy (Ins->ShrtName,HieSnp_GetString (Rec->ShrtName),
+	     Hie_MAX_BYTES_SHRT_NAME);
+   Str_Copy (Ins->FullName,HieSnp_GetString (Rec->FullName),
+	     Hie_MAX_BYTES_FULL_NAME);
+   Str_Copy (Ins->WWW,HieSnp_GetString (Rec->WWW),
+	     Cns_MAX_BYTES_WWW);
+   Ins->NumUsrsWhoClaimToBelongToIns.Valid = false;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/********************* Get data of a centre from snapshot ********************/
+/*****************************************************************************/
+// Return false if the centre is not found in snapshot,
+// so the caller must get it from database
+
+bool HieSnp_GetDataOfCentreByCod (struct Centre *Ctr)
+  {
+   const struct HieSnp_Ctr *Rec;
+
+   if ((Rec = HieSnp_SearchRecord (Hie_CTR,Ctr->CtrCod)) == NULL)
+      return false;
+
+   Ctr->InsCod          = Rec->InsCod;
+   Ctr->PlcCod          = Rec->PlcCod;
+   Ctr->Status          = Rec->Status;
+   Ctr->RequesterUsrCod = Rec->RequesterUsrCod;
+   Ctr->Coord           = Rec->Coord;
+   Str_Copy (Ctr->ShrtName,HieSnp_GetString (Rec->ShrtName),
+	     Hie_MAX_BYTES_SHRT_NAME);
+   Str_Copy (Ctr->FullName,HieSnp_GetString (Rec->FullName),
+	     Hie_MAX_BYTES_FULL_NAME);
+   Str_Copy (Ctr->WWW,HieSnp_GetString (Rec->WWW),
+	     Cns_MAX_BYTES_WWW);
+   Ctr->NumUsrsWhoClaimToBelongToCtr.Valid = false;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/********************* Get data of a degree from snapshot ********************/
+/*****************************************************************************/
+// Return false if the degree is not found in snapshot,
+// so the caller must get it from database
+
+bool HieSnp_GetDataOfDegreeByCod (struct Degree *Deg)
+  {
+   const struct HieSnp_Deg *Rec;
+
+   if ((Rec = HieSnp_SearchRecord (Hie_DEG,Deg->DegCod)) == NULL)
+      return false;
+
+   Deg->DegTypCod       = Rec->DegTypCod;
+   Deg->CtrCod          = Rec->CtrCod;
+   Deg->Status          = Rec->Status;
+   Deg->RequesterUsrCod = Rec->RequesterUsrCod;
+   Str_Copy (Deg->ShrtName,HieSnp_GetString (Rec->ShrtName),
+	     Hie_MAX_BYTES_SHRT_NAME);
+   Str_Copy (Deg->FullName,HieSnp_GetString (Rec->FullName),
+	     Hie_MAX_BYTES_FULL_NAME);
+   Str_Copy (Deg->WWW,HieSnp_GetString (Rec->WWW),
+	     Cns_MAX_BYTES_WWW);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/********************* Get data of a course from snapshot ********************/
+/*****************************************************************************/
+// Return false if the course is not found in snapshot,
+// so the caller must get it from database
+
+bool HieSnp_GetDataOfCourseByCod (struct Course *Crs)
+  {
+   const struct HieSnp_Crs *Rec;
+
+   if ((Rec = HieSnp_SearchRecord (Hie_CRS,Crs->CrsCod)) == NULL)
+      return false;
+
+   Crs->DegCod          = Rec->DegCod;
+   Crs->Year            = Rec->Year;
+   Crs->Status          = Rec->Status;
+   Crs->RequesterUsrCod = Rec->RequesterUsrCod;
+   Str_Copy (Crs->InstitutionalCrsCod,HieSnp_GetString (Rec->InstitutionalCrsCod),
+	     Crs_MAX_BYTES_INSTITUTIONAL_CRS_COD);
+   Str_Copy (Crs->ShrtName,HieSnp_GetString (Rec->ShrtName),
+	     Hie_MAX_BYTES_SHRT_NAME);
+   Str_Copy (Crs->FullName,HieSnp_GetString (Rec->FullName),
+	     Hie_MAX_BYTES_FULL_NAME);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/************** Search a record by its code in snapshot **********************/
+/*****************************************************************************/
+
+static const void *HieSnp_SearchRecord (Hie_Level_t Level,long Cod)
+  {
+   const struct HieSnp_Header *Header;
+
+   /***** Trivial check *****/
+   if (Cod <= 0)
+      return NULL;
+
+   /***** Get snapshot *****/
+   if ((Header = HieSnp_GetSnapshot ()) == NULL)
+      return NULL;
+
+   /***** Binary search of the code *****/
+   if (!Header->NumRecords[Level])
+      return NULL;
+   return bsearch (&Cod,HieSnp_Snapshot.Base + Header->OffsetRecords[Level],
+		   Header->NumRecords[Level],Header->SizeOfRecord[Level],
+		   HieSnp_CompareCods);
+  }
+
+static int HieSnp_CompareCods (const void *Cod1,const void *Cod2)
+  {
+   long C1 = *((const long *) Cod1);
+   long C2 = *((const long *) Cod2);
+
+   return C1 < C2 ? -1 :
+		    (C1 > C2 ? 1 :
+			       0);
+  }
+
+/*****************************************************************************/
+/************************* Get a string from snapshot ************************/
+/*****************************************************************************/
+
+static const char *HieSnp_GetString (size_t Offset)
+  {
+   const struct HieSnp_Header *Header = (const struct HieSnp_Header *) HieSnp_Snapshot.Base;
+
+   if (Offset >= Header->Size - Header->OffsetStrings)
+      return "";
+   return HieSnp_Snapshot.Base + Header->OffsetStrings + Offset;
+  }
+
+/*****************************************************************************/
+/********** Get the snapshot, building it if it's not up to date *************/
+/*****************************************************************************/
+// Return NULL if snapshot is not available
+
+static const struct HieSnp_Header *HieSnp_GetSnapshot (void)
+  {
+   int LockFileDescriptor;
+
+   /***** Check snapshot only the first time it is used *****/
+   if (!HieSnp_Snapshot.Checked)
+     {
+      HieSnp_Snapshot.Checked = true;
+
+      /***** Map current snapshot, even if it's not up to date *****/
+      if (HieSnp_MapSnapshot ())
+	 if (HieSnp_CheckIfSnapshotIsUpToDate ())
+	    return (const struct HieSnp_Header *) HieSnp_Snapshot.Base;
+
+      /***** Snapshot does not exist or is not up to date.
+             Only the process that gets the lock rebuilds it *****/
+      if ((LockFileDescriptor = HieSnp_LockToBuildSnapshot ()) >= 0)
+	{
+	 /* Snapshot may have been rebuilt
+	    by another process while waiting for the lock */
+	 HieSnp_UnmapFile ();
+	 if (HieSnp_MapSnapshot ())
+	    if (!HieSnp_CheckIfSnapshotIsUpToDate ())
+	       HieSnp_UnmapFile ();
+	 if (!HieSnp_Snapshot.Base)
+	    HieSnp_BuildAndMapSnapshot ();
+
+	 close (LockFileDescriptor);	// Release lock
+	}
+      /***** Another process is rebuilding it ==> use the old snapshot
+             meanwhile, unless hierarchy has been changed in this execution,
+             so the change is seen (got from database) *****/
+      else if (HieSnp_Snapshot.ChangedByMe)
+	 HieSnp_UnmapFile ();
+     }
+
+   return (const struct HieSnp_Header *) HieSnp_Snapshot.Base;
+  }
+
+/*****************************************************************************/
+/************ Get the lock to build snapshot, without waiting ****************/
+/*****************************************************************************/
+// Return file descriptor of lock file, to be closed to release lock,
+// or -1 if lock is held by another process.
+// The lock is released too if the process ends
+
+static int HieSnp_LockToBuildSnapshot (void)
+  {
+   char PathLock[PATH_MAX + 1];
+   int FileDescriptor;
+
+   Fil_CreateDirIfNotExists (Cfg_PATH_HIE_SNAPSHOT_PRIVATE);
+   HieSnp_BuildPath (PathLock,HieSnp_FILE_LOCK);
+   if ((FileDescriptor = open (PathLock,O_RDWR | O_CREAT,
+			       S_IRUSR | S_IWUSR)) < 0)
+      return -1;
+   if (flock (FileDescriptor,LOCK_EX | LOCK_NB))
+     {
+      close (FileDescriptor);
+      return -1;
+     }
+
+   return FileDescriptor;
+  }
+
+/*****************************************************************************/
+/***************** Map current snapshot file into memory *********************/
+/*****************************************************************************/
+// Return true if the snapshot exists and has a valid format
+
+static bool HieSnp_MapSnapshot (void)
+  {
+   char PathSnapshot[PATH_MAX + 1];
+   int FileDescriptor;
+   bool Mapped;
+
+   HieSnp_BuildPath (PathSnapshot,HieSnp_FILE_SNAPSHOT);
+   if ((FileDescriptor = open (PathSnapshot,O_RDONLY)) < 0)
+      return false;
+   Mapped = HieSnp_MapFile (FileDescriptor);
+   close (FileDescriptor);
+
+   return Mapped;
+  }
+
+/*****************************************************************************/
+/********************** Map a snapshot file into memory **********************/
+/*****************************************************************************/
+// Return true if the snapshot has a valid format
+
+static bool HieSnp_MapFile (int FileDescriptor)
+  {
+   struct stat FileStatus;
+   size_t Size;
+   void *Base;
+
+   /***** Get size of file *****/
+   if (fstat (FileDescriptor,&FileStatus))
+      return false;
+   if (FileStatus.st_size < (off_t) sizeof (struct HieSnp_Header))
+      return false;
+   Size = (size_t) FileStatus.st_size;
+
+   /***** Map file into memory *****/
+   if ((Base = mmap (NULL,Size,PROT_READ,MAP_SHARED,FileDescriptor,0)) == MAP_FAILED)
+      return false;
+
+   /***** Check snapshot *****/
+   if (!HieSnp_CheckSnapshot ((const struct HieSnp_Header *) Base,Size))
+     {
+      munmap (Base,Size);
+      return false;
+     }
+
+   HieSnp_Snapshot.Base = (char *) Base;
+   HieSnp_Snapshot.Size = Size;
+   return true;
+  }
+
+/*****************************************************************************/
+/******************* Check if a snapshot can be used *************************/
+/*****************************************************************************/
+
+static bool HieSnp_CheckSnapshot (const struct HieSnp_Header *Header,size_t Size)
+  {
+   Hie_Level_t Level;
+
+   /***** Check format *****/
+   if (memcmp (Header->Magic,HieSnp_MAGIC,HieSnp_BYTES_MAGIC))
+      return false;
+   if (Header->Size != Size ||
+       Header->OffsetStrings >= Size)
+      return false;
+   for (Level  = (Hie_Level_t) 0;
+	Level <= (Hie_Level_t) (Hie_NUM_LEVELS - 1);
+	Level++)
+      if (Header->SizeOfRecord[Level] != HieSnp_SizeOfRecord[Level] ||
+	  Header->OffsetRecords[Level] +
+	  Header->NumRecords[Level] * Header->SizeOfRecord[Level] > Header->OffsetStrings)
+	 return false;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/************ Check if the snapshot mapped in memory is up to date ***********/
+/*****************************************************************************/
+
+static bool HieSnp_CheckIfSnapshotIsUpToDate (void)
+  {
+   const struct HieSnp_Header *Header = (const struct HieSnp_Header *) HieSnp_Snapshot.Base;
+   struct timespec Version;
+
+   /***** Check age *****/
+   if (Header->CreatTime.tv_sec + HieSnp_SECONDS_MAX_AGE < Gbl.StartExecutionTimeUTC)
+      return false;
+
+   /***** Check that the snapshot was begun after the last change *****/
+   HieSnp_GetVersion (&Version);
+   return HieSnp_CompareTimes (&Header->CreatTime,&Version) > 0;
+  }
+
+/*****************************************************************************/
+/********************** Unmap snapshot file from memory **********************/
+/*****************************************************************************/
+
+static void HieSnp_UnmapFile (void)
+  {
+   if (HieSnp_Snapshot.Base)
+     {
+      munmap (HieSnp_Snapshot.Base,HieSnp_Snapshot.Size);
+      HieSnp_Snapshot.Base = NULL;
+      HieSnp_Snapshot.Size = 0;
+     }
+  }
+
+/*****************************************************************************/
+/************************* Unmap snapshot from memory ************************/
+/*****************************************************************************/
+// Snapshot will be checked again the next time it is used
+
+static void HieSnp_UnmapSnapshot (void)
+  {
+   HieSnp_UnmapFile ();
+   HieSnp_Snapshot.Checked = false;
+  }
+
+/*****************************************************************************/
+/******************* Build a new snapshot from database **********************/
+/*****************************************************************************/
+
+static void HieSnp_BuildAndMapSnapshot (void)
+  {
+   struct HieSnp_Header Header;
+   struct HieSnp_Buffer Records[Hie_NUM_LEVELS];
+   struct HieSnp_Buffer Strings;
+   char PathTmp[PATH_MAX + 1];
+   char PathSnapshot[PATH_MAX + 1];
+   int FileDescriptor;
+   Hie_Level_t Level;
+   size_t Offset;
+
+   /***** Initialize header *****/
+   memset (&Header,0,sizeof (Header));
+   memcpy (Header.Magic,HieSnp_MAGIC,HieSnp_BYTES_MAGIC);
+   for (Level  = (Hie_Level_t) 0;
+	Level <= (Hie_Level_t) (Hie_NUM_LEVELS - 1);
+	Level++)
+      Header.SizeOfRecord[Level] = HieSnp_SizeOfRecord[Level];
+
+   /* Time must be got before reading database
+      in order to detect changes made while building */
+   clock_gettime (CLOCK_REALTIME,&Header.CreatTime);
+
+   /***** Get hierarchy from database *****/
+   memset (Records,0,sizeof (Records));
+   memset (&Strings,0,sizeof (Strings));
+   HieSnp_AppendString (&Strings,"");	// Offset 0 ==> empty string
+   HieSnp_AddCountries    (&Records[Hie_CTY],&Strings);
+   HieSnp_AddInstitutions (&Records[Hie_INS],&Strings);
+   HieSnp_AddCentres      (&Records[Hie_CTR],&Strings);
+   HieSnp_AddDegrees      (&Records[Hie_DEG],&Strings);
+   HieSnp_AddCourses      (&Records[Hie_CRS],&Strings);
+
+   /***** Set position of each part in file *****/
+   for (Level  = (Hie_Level_t) 0, Offset = HieSnp_Align (sizeof (Header));
+	Level <= (Hie_Level_t) (Hie_NUM_LEVELS - 1);
+	Level++)
+     {
+      Header.NumRecords[Level] = HieSnp_SizeOfRecord[Level] ? Records[Level].Length /
+							      HieSnp_SizeOfRecord[Level] :
+							      0;
+      Header.OffsetRecords[Level] = Offset;
+      Offset = HieSnp_Align (Offset + Records[Level].Length);
+     }
+   Header.OffsetStrings = Offset;
+   Header.Size = Offset + Strings.Length;
+
+   /***** Write snapshot into a temporary file *****/
+   Fil_CreateDirIfNotExists (Cfg_PATH_HIE_SNAPSHOT_PRIVATE);
+   snprintf (PathTmp,sizeof (PathTmp),
+	     "%s/%s.%d",
+	     Cfg_PATH_HIE_SNAPSHOT_PRIVATE,HieSnp_FILE_SNAPSHOT,(int) Gbl.PID);
+   if ((FileDescriptor = open (PathTmp,O_RDWR | O_CREAT | O_TRUNC,
+			       S_IRUSR | S_IWUSR)) >= 0)
+     {
+      /***** Replace old snapshot only if the new one is up to date,
+             that is, if the hierarchy has not changed while building it *****/
+      if (HieSnp_WriteFile (FileDescriptor,&Header,Records,&Strings) &&
+	  HieSnp_MapFile (FileDescriptor))
+	{
+	 if (HieSnp_CheckIfSnapshotIsUpToDate ())
+	   {
+	    HieSnp_BuildPath (PathSnapshot,HieSnp_FILE_SNAPSHOT);
+	    if (rename (PathTmp,PathSnapshot))
+	       unlink (PathTmp);
+	   }
+	 else
+	   {
+	    HieSnp_UnmapFile ();
+	    unlink (PathTmp);
+	   }
+	}
+      else
+	 unlink (PathTmp);
+      close (FileDescriptor);
+     }
+
+   /***** Free buffers *****/
+   for (Level  = (Hie_Level_t) 0;
+	Level <= (Hie_Level_t) (Hie_NUM_LEVELS - 1);
+	Level++)
+      free (Records[Level].Data);
+   free (Strings.Data);
+  }
+
+/*****************************************************************************/
+/*********************** Add all countries to snapshot ***********************/
+/*****************************************************************************/
+
+static void HieSnp_AddCountries (struct HieSnp_Buffer *Records,
+                                 struct HieSnp_Buffer *Strings)
+  {
+   extern const char *Lan_STR_LANG_ID[1 + Lan_NUM_LANGUAGES];
+   char StrField[16];
+   char SubQueryNam[HieSnp_MAX_BYTES_SUBQUERY_CTYS + 1];
+   char SubQueryWWW[HieSnp_MAX_BYTES_SUBQUERY_CTYS + 1];
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   struct HieSnp_Cty Rec;
+   Lan_Language_t Lan;
+
+   /***** Build subqueries with names and WWW in all languages *****/
+   SubQueryNam[0] = '\0';
+   SubQueryWWW[0] = '\0';
+   for (Lan  = (Lan_Language_t) 1;
+	Lan <= (Lan_Language_t) Lan_NUM_LANGUAGES;
+	Lan++)
+     {
+      snprintf (StrField,sizeof (StrField),
+		",Name_%s",
+		Lan_STR_LANG_ID[Lan]);
+      Str_Concat (SubQueryNam,StrField,
+		  HieSnp_MAX_BYTES_SUBQUERY_CTYS);
+      snprintf (StrField,sizeof (StrField),
+		",WWW_%s",
+		Lan_STR_LANG_ID[Lan]);
+      Str_Concat (SubQueryWWW,StrField,
+		  HieSnp_MAX_BYTES_SUBQUERY_CTYS);
+     }
+
+   /***** Get countries from database *****/
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get countries",
+			     "SELECT CtyCod,Alpha2%s%s"
+			     " FROM countries"
+			     " ORDER BY CtyCod",
+			     SubQueryNam,SubQueryWWW);
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      memset (&Rec,0,sizeof (Rec));
+
+      /* Get country code (row[0]) and Alpha-2 country code (row[1]) */
+      Rec.CtyCod = Str_ConvertStrCodToLongCod (row[0]);
+      Str_Copy (Rec.Alpha2,row[1],
+		2);
+
+      /* Get name and WWW of the country in all languages */
+      for (Lan  = (Lan_Language_t) 1;
+	   Lan <= (Lan_Language_t) Lan_NUM_LANGUAGES;
+	   Lan++)
+	{
+	 Rec.Name[Lan] = HieSnp_AppendString (Strings,row[1 + Lan]);
+	 Rec.WWW [Lan] = HieSnp_AppendString (Strings,row[1 + Lan_NUM_LANGUAGES + Lan]);
+	}
+
+      HieSnp_AppendToBuffer (Records,&Rec,sizeof (Rec));
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/********************* Add all institutions to snapshot **********************/
+/*****************************************************************************/
+
+static void HieSnp_AddInstitutions (struct HieSnp_Buffer *Records,
+                                    struct HieSnp_Buffer *Strings)
+  {
+   MYSQL_RES *mysql_res;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   struct Instit Ins;
+   struct HieSnp_Ins Rec;
+
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get institutions",
+			     "SELECT InsCod,"		// row[0]
+				    "CtyCod,"		// row[1]
+				    "Status,"		// row[2]
+				    "RequesterUsrCod,"	// row[3]
+				    "ShortName,"	// row[4]
+				    "FullName,"		// row[5]
+				    "WWW"		// row[6]
+			     " FROM institutions"
+			     " ORDER BY InsCod");
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      Ins_GetDataOfInstitFromRow (&Ins,mysql_fetch_row (mysql_res));
+
+      memset (&Rec,0,sizeof (Rec));
+      Rec.InsCod          = Ins.InsCod;
+      Rec.CtyCod          = Ins.CtyCod;
+      Rec.Status          = Ins.Status;
+      Rec.RequesterUsrCod = Ins.RequesterUsrCod;
+      Rec.ShrtName        = HieSnp_AppendString (Strings,Ins.ShrtName);
+      Rec.FullName        = HieSnp_AppendString (Strings,Ins.FullName);
+      Rec.WWW             = HieSnp_AppendString (Strings,Ins.WWW);
+      HieSnp_AppendToBuffer (Records,&Rec,sizeof (Rec));
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************************ Add all centres to snapshot ************************/
+/*****************************************************************************/
+
+static void HieSnp_AddCentres (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings)
+  {
+   MYSQL_RES *mysql_res;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   struct Centre Ctr;
+   struct HieSnp_Ctr Rec;
+
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get centres",
+			     "SELECT CtrCod,"		// row[ 0]
+				    "InsCod,"		// row[ 1]
+				    "PlcCod,"		// row[ 2]
+				    "Status,"		// row[ 3]
+				    "RequesterUsrCod,"	// row[ 4]
+				    "Latitude,"		// row[ 5]
+				    "Longitude,"	// row[ 6]
+				    "Altitude,"		// row[ 7]
+				    "ShortName,"	// row[ 8]
+				    "FullName,"		// row[ 9]
+				    "WWW"		// row[10]
+			     " FROM centres"
+			     " ORDER BY CtrCod");
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      Ctr_GetDataOfCentreFromRow (&Ctr,mysql_fetch_row (mysql_res));
+
+      memset (&Rec,0,sizeof (Rec));
+      Rec.CtrCod          = Ctr.CtrCod;
+      Rec.InsCod          = Ctr.InsCod;
+      Rec.PlcCod          = Ctr.PlcCod;
+      Rec.Status          = Ctr.Status;
+      Rec.RequesterUsrCod = Ctr.RequesterUsrCod;
+      Rec.Coord           = Ctr.Coord;
+      Rec.ShrtName        = HieSnp_AppendString (Strings,Ctr.ShrtName);
+      Rec.FullName        = HieSnp_AppendString (Strings,Ctr.FullName);
+      Rec.WWW             = HieSnp_AppendString (Strings,Ctr.WWW);
+      HieSnp_AppendToBuffer (Records,&Rec,sizeof (Rec));
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************************ Add all degrees to snapshot ************************/
+/*****************************************************************************/
+
+static void HieSnp_AddDegrees (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings)
+  {
+   MYSQL_RES *mysql_res;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   struct Degree Deg;
+   struct HieSnp_Deg Rec;
+
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get degrees",
+			     "SELECT DegCod,CtrCod,DegTypCod,Status,"
+			     "RequesterUsrCod,ShortName,FullName,WWW"
+			     " FROM degrees"
+			     " ORDER BY DegCod");
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      Deg_GetDataOfDegreeFromRow (&Deg,mysql_fetch_row (mysql_res));
+
+      memset (&Rec,0,sizeof (Rec));
+      Rec.DegCod          = Deg.DegCod;
+      Rec.DegTypCod       = Deg.DegTypCod;
+      Rec.CtrCod          = Deg.CtrCod;
+      Rec.Status          = Deg.Status;
+      Rec.RequesterUsrCod = Deg.RequesterUsrCod;
+      Rec.ShrtName        = HieSnp_AppendString (Strings,Deg.ShrtName);
+      Rec.FullName        = HieSnp_AppendString (Strings,Deg.FullName);
+      Rec.WWW             = HieSnp_AppendString (Strings,Deg.WWW);
+      HieSnp_AppendToBuffer (Records,&Rec,sizeof (Rec));
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************************ Add all courses to snapshot ************************/
+/*****************************************************************************/
+
+static void HieSnp_AddCourses (struct HieSnp_Buffer *Records,
+                               struct HieSnp_Buffer *Strings)
+  {
+   MYSQL_RES *mysql_res;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   struct Course Crs;
+   struct HieSnp_Crs Rec;
+
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get courses",
+			     "SELECT CrsCod,"		// row[0]
+				    "DegCod,"		// row[1]
+				    "Year,"		// row[2]
+				    "InsCrsCod,"	// row[3]
+				    "Status,"		// row[4]
+				    "RequesterUsrCod,"	// row[5]
+				    "ShortName,"	// row[6]
+				    "FullName"		// row[7]
+			     " FROM courses"
+			     " ORDER BY CrsCod");
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      Crs_GetDataOfCourseFromRow (&Crs,mysql_fetch_row (mysql_res));
+
+      memset (&Rec,0,sizeof (Rec));
+      Rec.CrsCod              = Crs.CrsCod;
+      Rec.DegCod              = Crs.DegCod;
+      Rec.Year                = Crs.Year;
+      Rec.Status              = Crs.Status;
+      Rec.RequesterUsrCod     = Crs.RequesterUsrCod;
+      Rec.InstitutionalCrsCod = HieSnp_AppendString (Strings,Crs.InstitutionalCrsCod);
+      Rec.ShrtName            = HieSnp_AppendString (Strings,Crs.ShrtName);
+      Rec.FullName            = HieSnp_AppendString (Strings,Crs.FullName);
+      HieSnp_AppendToBuffer (Records,&Rec,sizeof (Rec));
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/**************************** Append data to a buffer ************************/
+/*****************************************************************************/
+// Return the offset of the data in the buffer
+
+static size_t HieSnp_AppendToBuffer (struct HieSnp_Buffer *Buffer,
+                                     const void *Data,size_t Length)
+  {
+   size_t Offset = Buffer->Length;
+
+   /***** Enlarge buffer if necessary *****/
+   if (Buffer->Length + Length > Buffer->Size)
+     {
+      Buffer->Size = (Buffer->Length + Length) * 2;
+      if ((Buffer->Data = (char *) realloc (Buffer->Data,Buffer->Size)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+     }
+
+   /***** Append data *****/
+   memcpy (Buffer->Data + Buffer->Length,Data,Length);
+   Buffer->Length += Length;
+
+   return Offset;
+  }
+
+static size_t HieSnp_AppendString (struct HieSnp_Buffer *Strings,
+                                   const char *Str)
+  {
+   if (!Str || !Str[0])
+      return 0;	// Offset of the empty string
+   return HieSnp_AppendToBuffer (Strings,Str,strlen (Str) + 1);
+  }
+
+/*****************************************************************************/
+/************************** Write snapshot into a file ***********************/
+/*****************************************************************************/
+// Return true on success
+
+static bool HieSnp_WriteFile (int FileDescriptor,
+                              const struct HieSnp_Header *Header,
+                              const struct HieSnp_Buffer Records[Hie_NUM_LEVELS],
+                              const struct HieSnp_Buffer *Strings)
+  {
+   Hie_Level_t Level;
+
+   /***** Write header *****/
+   if (pwrite (FileDescriptor,Header,sizeof (*Header),0) != (ssize_t) sizeof (*Header))
+      return false;
+
+   /***** Write records *****/
+   for (Level  = (Hie_Level_t) 0;
+	Level <= (Hie_Level_t) (Hie_NUM_LEVELS - 1);
+	Level++)
+      if (Records[Level].Length)
+	 if (pwrite (FileDescriptor,Records[Level].Data,Records[Level].Length,
+		     (off_t) Header->OffsetRecords[Level]) != (ssize_t) Records[Level].Length)
+	    return false;
+
+   /***** Write strings *****/
+   if (pwrite (FileDescriptor,Strings->Data,Strings->Length,
+	       (off_t) Header->OffsetStrings) != (ssize_t) Strings->Length)
+      return false;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/*************** Invalidate snapshot after a change in hierarchy *************/
+/*****************************************************************************/
+// Must be called after changing countries, institutions, centres, degrees
+// or courses in database
+
+void HieSnp_InvalidateSnapshot (void)
+  {
+   char PathVersion[PATH_MAX + 1];
+   int FileDescriptor;
+   struct timespec Times[2];
+
+   /***** Set modification time of version file to current time,
+          so snapshots begun before now are not used *****/
+   Fil_CreateDirIfNotExists (Cfg_PATH_HIE_SNAPSHOT_PRIVATE);
+   HieSnp_BuildPath (PathVersion,HieSnp_FILE_VERSION);
+   if ((FileDescriptor = open (PathVersion,O_WRONLY | O_CREAT,
+			       S_IRUSR | S_IWUSR)) >= 0)
+     {
+      Times[0].tv_sec  = 0;
+      Times[0].tv_nsec = UTIME_OMIT;	// Don't change access time
+      clock_gettime (CLOCK_REALTIME,&Times[1]);
+      futimens (FileDescriptor,Times);
+      close (FileDescriptor);
+     }
+
+   /***** The snapshot used in this execution is no longer valid *****/
+   HieSnp_Snapshot.ChangedByMe = true;
+   HieSnp_UnmapSnapshot ();
+  }
+
+/*****************************************************************************/
+/************ Get time of last change in hierarchy (version) *****************/
+/*****************************************************************************/
+
+static void HieSnp_GetVersion (struct timespec *Version)
+  {
+   char PathVersion[PATH_MAX + 1];
+   struct stat FileStatus;
+
+   HieSnp_BuildPath (PathVersion,HieSnp_FILE_VERSION);
+   if (stat (PathVersion,&FileStatus))	// Hierarchy has never been changed
+     {
+      Version->tv_sec  = 0;
+      Version->tv_nsec = 0;
+     }
+   else
+      *Version = FileStatus.st_mtim;
+  }
+
+/*****************************************************************************/
+/***************************** Compare two times *****************************/
+/*****************************************************************************/
+
+static int HieSnp_CompareTimes (const struct timespec *Time1,
+                                const struct timespec *Time2)
+  {
+   if (Time1->tv_sec != Time2->tv_sec)
+      return Time1->tv_sec < Time2->tv_sec ? -1 :
+					     1;
+   if (Time1->tv_nsec != Time2->tv_nsec)
+      return Time1->tv_nsec < Time2->tv_nsec ? -1 :
+					       1;
+   return 0;
+  }
+
+/*****************************************************************************/
+/*************** Build the path of a file in snapshot directory **************/
+/*****************************************************************************/
+
+static void HieSnp_BuildPath (char Path[PATH_MAX + 1],const char *FileName)
+  {
+   snprintf (Path,PATH_MAX + 1,
+	     "%s/%s",
+	     Cfg_PATH_HIE_SNAPSHOT_PRIVATE,FileName);
+  }
+
+/*****************************************************************************/
+/******************** Align an offset inside snapshot file *******************/
+/*****************************************************************************/
+
+static size_t HieSnp_Align (size_t Offset)
+  {
+   return (Offset + HieSnp_ALIGN - 1) / HieSnp_ALIGN * HieSnp_ALIGN;
+  }
@@ -0,0 +1,54 @@
+// swad_hierarchy_snapshot.h: snapshot of the hierarchy stored in a file mapped into memory
+
+#ifndef _SWAD_HIE_SNP
+#define _SWAD_HIE_SNP
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+
+#include "swad_centre.h"
+#include "swad_country.h"
+#include "swad_course.h"
+#include "swad_degree.h"
+#include "swad_institution.h"
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+bool HieSnp_GetDataOfCountryByCod (struct Country *Cty);
+bool HieSnp_GetDataOfInstitutionByCod (struct Instit *Ins);
+bool HieSnp_GetDataOfCentreByCod (struct Centre *Ctr);
+bool HieSnp_GetDataOfDegreeByCod (struct Degree *Deg);
+bool HieSnp_GetDataOfCourseByCod (struct Course *Crs);
+
+void HieSnp_InvalidateSnapshot (void);
+
+#endif
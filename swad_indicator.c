@@ -26,6 +26,7 @@
 /*****************************************************************************/
 
 #include <stddef.h>		// For NULL
+#include <string.h>		// For strcmp
 #include <mysql/mysql.h>	// To access MySQL databases
 
 #include "swad_action.h"
@@ -37,7 +38,6 @@
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_indicator.h"
-#include "swad_message.h"
 #include "swad_parameter.h"
 #include "swad_theme.h"
 
@@ -51,6 +51,9 @@ extern struct Globals Gbl;
 /**************************** Private constants ******************************/
 /*****************************************************************************/
 
+#define Ind_MAX_COURSES_IN_BATCH	500	// Maximum number of courses whose indicators are computed in background at a time
+#define Ind_SECONDS_TO_EXPIRE_INDICATORS (7UL * 24UL * 60UL * 60UL)	// Indicators are computed again after this time
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
@@ -84,11 +87,12 @@ static void Ind_ShowTableOfCoursesWithIndicators (const struct Ind_Indicators *I
 	                                          Ind_IndicatorsLayout_t IndicatorsLayout,
                                                   unsigned NumCrss,MYSQL_RES *mysql_res);
 static unsigned Ind_GetAndUpdateNumIndicatorsCrs (long CrsCod);
+static int Ind_GetNumIndicatorsCrsFromDB (long CrsCod);
+static void Ind_ComputeIndicatorsOfBatch (void);
+static bool Ind_GetIndicatorsCrsFromDB (long CrsCod,
+                                        struct Ind_IndicatorsCrs *IndicatorsCrs);
 static void Ind_StoreIndicatorsCrsIntoDB (long CrsCod,unsigned NumIndicators);
-static unsigned long Ind_GetNumFilesInDocumZonesOfCrsFromDB (long CrsCod);
-static unsigned long Ind_GetNumFilesInShareZonesOfCrsFromDB (long CrsCod);
-static unsigned long Ind_GetNumFilesInAssigZonesOfCrsFromDB (long CrsCod);
-static unsigned long Ind_GetNumFilesInWorksZonesOfCrsFromDB (long CrsCod);
+static void Ind_ComputeNumIndicatorsCrs (struct Ind_IndicatorsCrs *IndicatorsCrs);
 
 /*****************************************************************************/
 /******************* Request showing statistics of courses *******************/
@@ -608,7 +612,7 @@ static void Ind_GetNumCoursesWithIndicators (unsigned NumCrssWithIndicatorYes[1
    unsigned NumCrs;
    long CrsCod;
    unsigned Ind;
-   unsigned NumIndicators;
+   struct Ind_IndicatorsCrs IndicatorsCrs;
 
    /***** Reset counters of courses with each number of indicators *****/
    for (Ind = 0;
@@ -628,9 +632,9 @@ static void Ind_GetNumCoursesWithIndicators (unsigned NumCrssWithIndicatorYes[1
       if ((CrsCod = Str_ConvertStrCodToLongCod (row[2])) < 0)
          Lay_ShowErrorAndExit ("Wrong code of course.");
 
-      /* Get stored number of indicators of this course */
-      NumIndicators = Ind_GetAndUpdateNumIndicatorsCrs (CrsCod);
-      NumCrssWithIndicatorYes[NumIndicators]++;
+      /* Get indicators of this course */
+      Ind_GetIndicatorsCrs (CrsCod,&IndicatorsCrs);
+      NumCrssWithIndicatorYes[IndicatorsCrs.NumIndicators]++;
      }
   }
 
@@ -900,8 +904,8 @@ static void Ind_ShowTableOfCoursesWithIndicators (const struct Ind_Indicators *I
       NumIndicators = Ind_GetAndUpdateNumIndicatorsCrs (CrsCod);
       if (Indicators->IndicatorsSelected[NumIndicators])
 	{
-	 /* Compute and store indicators */
-	 Ind_ComputeAndStoreIndicatorsCrs (CrsCod,(int) NumIndicators,&IndicatorsCrs);
+	 /* Get indicators, computing them now if they are dirty */
+	 Ind_GetIndicatorsCrs (CrsCod,&IndicatorsCrs);
 
 	 /* The number of indicators may have changed */
 	 if (Indicators->IndicatorsSelected[IndicatorsCrs.NumIndicators])
@@ -1259,7 +1263,7 @@ static unsigned Ind_GetAndUpdateNumIndicatorsCrs (long CrsCod)
    else	// Number of indicators is not already computed
      {
       /***** Compute and store number of indicators *****/
-      Ind_ComputeAndStoreIndicatorsCrs (CrsCod,NumIndicatorsFromDB,&IndicatorsCrs);
+      Ind_GetIndicatorsCrs (CrsCod,&IndicatorsCrs);
       NumIndicators = IndicatorsCrs.NumIndicators;
      }
    return NumIndicators;
@@ -1270,7 +1274,7 @@ static unsigned Ind_GetAndUpdateNumIndicatorsCrs (long CrsCod)
 /*****************************************************************************/
 // This function returns -1 if number of indicators is not yet calculated
 
-int Ind_GetNumIndicatorsCrsFromDB (long CrsCod)
+static int Ind_GetNumIndicatorsCrsFromDB (long CrsCod)
   {
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
@@ -1297,231 +1301,376 @@ int Ind_GetNumIndicatorsCrsFromDB (long CrsCod)
   }
 
 /*****************************************************************************/
-/************ Store number of indicators of a course in database *************/
+/****************** Set some indicators of a course as dirty *****************/
 /*****************************************************************************/
+// Indicators is a mask of Ind_SYLLABUS, Ind_ASSIGNMENTS...
+// Dirty indicators will be computed again in background or when requested
 
-static void Ind_StoreIndicatorsCrsIntoDB (long CrsCod,unsigned NumIndicators)
+void Ind_SetIndicatorsCrsAsDirty (long CrsCod,unsigned Indicators)
   {
-   /***** Store number of indicators of a course in database *****/
-   DB_QueryUPDATE ("can not store number of indicators of a course",
-		   "UPDATE courses SET NumIndicators=%u WHERE CrsCod=%ld",
-                   NumIndicators,CrsCod);
+   if (CrsCod > 0)
+      DB_QueryUPDATE ("can not set indicators of a course as dirty",
+		      "UPDATE crs_indicators SET Dirty=(Dirty|%u)"
+		      " WHERE CrsCod=%ld",
+		      Indicators,CrsCod);
   }
 
 /*****************************************************************************/
-/********************* Compute indicators of a course ************************/
+/************** Compute dirty indicators of a batch of courses ***************/
 /*****************************************************************************/
-/* NumIndicatorsFromDB (number of indicators stored in database)
-   must be retrieved before calling this function.
-   If NumIndicatorsFromDB is different from number of indicators just computed
-   ==> update it into database */
+// Indicators not computed for a long time are computed again,
+// since not all the changes in a course set its indicators as dirty
 
-void Ind_ComputeAndStoreIndicatorsCrs (long CrsCod,int NumIndicatorsFromDB,
-                                       struct Ind_IndicatorsCrs *IndicatorsCrs)
+void Ind_ComputeDirtyIndicators (void)
   {
-   /***** Initialize number of indicators *****/
-   IndicatorsCrs->NumIndicators = 0;
-
-   /***** Get whether download zones are empty or not *****/
-   IndicatorsCrs->NumFilesInDocumentZones = Ind_GetNumFilesInDocumZonesOfCrsFromDB (CrsCod);
-   IndicatorsCrs->NumFilesInSharedZones   = Ind_GetNumFilesInShareZonesOfCrsFromDB (CrsCod);
-
-   /***** Indicator #1: information about syllabus *****/
-   IndicatorsCrs->SyllabusLecSrc   = Inf_GetInfoSrcFromDB (CrsCod,Inf_LECTURES);
-   IndicatorsCrs->SyllabusPraSrc   = Inf_GetInfoSrcFromDB (CrsCod,Inf_PRACTICALS);
-   IndicatorsCrs->TeachingGuideSrc = Inf_GetInfoSrcFromDB (CrsCod,Inf_TEACHING_GUIDE);
-   IndicatorsCrs->ThereIsSyllabus = (IndicatorsCrs->SyllabusLecSrc   != Inf_INFO_SRC_NONE) ||
-                                    (IndicatorsCrs->SyllabusPraSrc   != Inf_INFO_SRC_NONE) ||
-                                    (IndicatorsCrs->TeachingGuideSrc != Inf_INFO_SRC_NONE);
-   if (IndicatorsCrs->ThereIsSyllabus)
-      IndicatorsCrs->NumIndicators++;
-
-   /***** Indicator #2: information about assignments *****/
-   IndicatorsCrs->NumAssignments = Asg_GetNumAssignmentsInCrs (CrsCod);
-   IndicatorsCrs->NumFilesAssignments = Ind_GetNumFilesInAssigZonesOfCrsFromDB (CrsCod);
-   IndicatorsCrs->NumFilesWorks       = Ind_GetNumFilesInWorksZonesOfCrsFromDB (CrsCod);
-   IndicatorsCrs->ThereAreAssignments = (IndicatorsCrs->NumAssignments      != 0) ||
-                                        (IndicatorsCrs->NumFilesAssignments != 0) ||
-                                        (IndicatorsCrs->NumFilesWorks       != 0);
-   if (IndicatorsCrs->ThereAreAssignments)
-      IndicatorsCrs->NumIndicators++;
-
-   /***** Indicator #3: information about online tutoring *****/
-   IndicatorsCrs->NumThreads = For_GetNumTotalThrsInForumsOfType (For_FORUM_COURSE_USRS,-1L,-1L,-1L,-1L,CrsCod);
-   IndicatorsCrs->NumPosts   = For_GetNumTotalPstsInForumsOfType (For_FORUM_COURSE_USRS,-1L,-1L,-1L,-1L,CrsCod,&(IndicatorsCrs->NumUsrsToBeNotifiedByEMail));
-   IndicatorsCrs->NumMsgsSentByTchs = Msg_GetNumMsgsSentByTchsCrs (CrsCod);
-   IndicatorsCrs->ThereIsOnlineTutoring = (IndicatorsCrs->NumThreads        != 0) ||
-	                                  (IndicatorsCrs->NumPosts          != 0) ||
-	                                  (IndicatorsCrs->NumMsgsSentByTchs != 0);
-   if (IndicatorsCrs->ThereIsOnlineTutoring)
-      IndicatorsCrs->NumIndicators++;
+   /***** Add courses without indicators *****/
+   DB_QueryINSERT ("can not add indicators of courses",
+		   "INSERT IGNORE INTO crs_indicators"
+		   " (CrsCod,Dirty,Computing,ComputingToken,UpdateTime)"
+		   " SELECT courses.CrsCod,%u,0,'',NOW()"
+		   " FROM courses LEFT JOIN crs_indicators"
+		   " ON courses.CrsCod=crs_indicators.CrsCod"
+		   " WHERE crs_indicators.CrsCod IS NULL",
+		   (unsigned) Ind_ALL_INDICATORS);
+
+   /***** Get a batch of courses with dirty or expired indicators *****/
+   DB_QueryUPDATE ("can not get courses with dirty indicators",
+		   "UPDATE crs_indicators"
+		   " SET Computing=IF(UpdateTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu),%u,Dirty),"
+		   "Dirty=0,"
+		   "ComputingToken='%s'"
+		   " WHERE Dirty<>0"
+		   " OR UpdateTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)"
+		   " LIMIT %u",
+		   Ind_SECONDS_TO_EXPIRE_INDICATORS,(unsigned) Ind_ALL_INDICATORS,
+		   Gbl.UniqueNameEncrypted,
+		   Ind_SECONDS_TO_EXPIRE_INDICATORS,
+		   Ind_MAX_COURSES_IN_BATCH);
+
+   /***** Compute indicators of the courses in the batch *****/
+   Ind_ComputeIndicatorsOfBatch ();
+  }
 
-   /***** Indicator #4: information about materials *****/
-   IndicatorsCrs->ThereAreMaterials = (IndicatorsCrs->NumFilesInDocumentZones != 0) ||
-                                      (IndicatorsCrs->NumFilesInSharedZones   != 0);
-   if (IndicatorsCrs->ThereAreMaterials)
-      IndicatorsCrs->NumIndicators++;
+/*****************************************************************************/
+/******************** Get indicators of a course *****************************/
+/*****************************************************************************/
+// Indicators are got from the table of precomputed indicators.
+// If they are not computed or they are dirty ==> compute them now
 
-   /***** Indicator #5: information about assessment *****/
-   IndicatorsCrs->AssessmentSrc = Inf_GetInfoSrcFromDB (CrsCod,Inf_ASSESSMENT);
-   IndicatorsCrs->ThereIsAssessment = (IndicatorsCrs->AssessmentSrc    != Inf_INFO_SRC_NONE) ||
-                                      (IndicatorsCrs->TeachingGuideSrc != Inf_INFO_SRC_NONE);
-   if (IndicatorsCrs->ThereIsAssessment)
-      IndicatorsCrs->NumIndicators++;
+void Ind_GetIndicatorsCrs (long CrsCod,struct Ind_IndicatorsCrs *IndicatorsCrs)
+  {
+   if (!Ind_GetIndicatorsCrsFromDB (CrsCod,IndicatorsCrs))
+     {
+      /***** Add course if it has no indicators *****/
+      DB_QueryINSERT ("can not add indicators of a course",
+		      "INSERT IGNORE INTO crs_indicators"
+		      " (CrsCod,Dirty,Computing,ComputingToken,UpdateTime)"
+		      " VALUES"
+		      " (%ld,%u,0,'',NOW())",
+		      CrsCod,(unsigned) Ind_ALL_INDICATORS);
+
+      /***** Get the course as a batch of only one course *****/
+      DB_QueryUPDATE ("can not get course with dirty indicators",
+		      "UPDATE crs_indicators"
+		      " SET Computing=(Computing|Dirty),"
+		      "Dirty=0,"
+		      "ComputingToken='%s'"
+		      " WHERE CrsCod=%ld",
+		      Gbl.UniqueNameEncrypted,
+		      CrsCod);
+
+      /***** Compute indicators of the course *****/
+      Ind_ComputeIndicatorsOfBatch ();
+
+      /***** Get computed indicators *****/
+      Ind_GetIndicatorsCrsFromDB (CrsCod,IndicatorsCrs);
+     }
+  }
 
-   /***** All the indicators are OK? *****/
-   IndicatorsCrs->CoursePartiallyOK = IndicatorsCrs->NumIndicators >= 1 &&
-	                              IndicatorsCrs->NumIndicators < Ind_NUM_INDICATORS;
-   IndicatorsCrs->CourseAllOK       = IndicatorsCrs->NumIndicators == Ind_NUM_INDICATORS;
+/*****************************************************************************/
+/***************** Remove indicators of a course from database ***************/
+/*****************************************************************************/
 
-   /***** Update number of indicators into database
-          if different to the stored one *****/
-   if (NumIndicatorsFromDB != (int) IndicatorsCrs->NumIndicators)
-      Ind_StoreIndicatorsCrsIntoDB (CrsCod,IndicatorsCrs->NumIndicators);
+void Ind_RemoveCrsIndicators (long CrsCod)
+  {
+   DB_QueryDELETE ("can not remove indicators of a course",
+		   "DELETE FROM crs_indicators WHERE CrsCod=%ld",
+		   CrsCod);
   }
 
 /*****************************************************************************/
-/*********** Get the number of files in document zones of a course ***********/
+/************ Compute indicators of the courses in my batch ******************/
 /*****************************************************************************/
+// Each group of indicators is computed with one query
+// for all the courses in the batch that have them dirty
 
-static unsigned long Ind_GetNumFilesInDocumZonesOfCrsFromDB (long CrsCod)
+static void Ind_ComputeIndicatorsOfBatch (void)
   {
+   extern const char *Inf_NamesInDBForInfoType[Inf_NUM_INFO_TYPES];
+   extern const char *Inf_NamesInDBForInfoSrc[Inf_NUM_INFO_SOURCES];
    extern const Brw_FileBrowser_t Brw_FileBrowserForDB_files[Brw_NUM_TYPES_FILE_BROWSER];
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
-   unsigned long NumFiles;
-
-   /***** Get number of files in document zones of a course from database *****/
-   DB_QuerySELECT (&mysql_res,"can not get the number of files",
-		   "SELECT"
-		   " (SELECT COALESCE(SUM(NumFiles),0)"
-		   " FROM file_browser_size"
-		   " WHERE FileBrowser=%u AND Cod=%ld) +"
-		   " (SELECT COALESCE(SUM(file_browser_size.NumFiles),0)"
+   unsigned NumCrss;
+   unsigned NumCrs;
+   long CrsCod;
+   struct Ind_IndicatorsCrs IndicatorsCrs;
+
+   /***** Indicators #1 and #5: syllabus and assessment *****/
+   DB_QueryUPDATE ("can not compute indicators of courses",
+		   "UPDATE crs_indicators SET"
+		   " SyllabusLecSrc=COALESCE((SELECT InfoSrc FROM crs_info_src"
+		   " WHERE CrsCod=crs_indicators.CrsCod AND InfoType='%s'),'%s'),"
+		   "SyllabusPraSrc=COALESCE((SELECT InfoSrc FROM crs_info_src"
+		   " WHERE CrsCod=crs_indicators.CrsCod AND InfoType='%s'),'%s'),"
+		   "TeachingGuideSrc=COALESCE((SELECT InfoSrc FROM crs_info_src"
+		   " WHERE CrsCod=crs_indicators.CrsCod AND InfoType='%s'),'%s'),"
+		   "AssessmentSrc=COALESCE((SELECT InfoSrc FROM crs_info_src"
+		   " WHERE CrsCod=crs_indicators.CrsCod AND InfoType='%s'),'%s')"
+		   " WHERE ComputingToken='%s' AND (Computing&%u)<>0",
+		   Inf_NamesInDBForInfoType[Inf_LECTURES      ],Inf_NamesInDBForInfoSrc[Inf_INFO_SRC_NONE],
+		   Inf_NamesInDBForInfoType[Inf_PRACTICALS    ],Inf_NamesInDBForInfoSrc[Inf_INFO_SRC_NONE],
+		   Inf_NamesInDBForInfoType[Inf_TEACHING_GUIDE],Inf_NamesInDBForInfoSrc[Inf_INFO_SRC_NONE],
+		   Inf_NamesInDBForInfoType[Inf_ASSESSMENT    ],Inf_NamesInDBForInfoSrc[Inf_INFO_SRC_NONE],
+		   Gbl.UniqueNameEncrypted,
+		   (unsigned) (Ind_SYLLABUS | Ind_ASSESSMENT));
+
+   /***** Indicator #2: assignments *****/
+   DB_QueryUPDATE ("can not compute indicators of courses",
+		   "UPDATE crs_indicators SET"
+		   " NumAsgs=(SELECT COUNT(*) FROM assignments"
+		   " WHERE CrsCod=crs_indicators.CrsCod),"
+		   "NumFilesAsgs=(SELECT COALESCE(SUM(NumFiles),0) FROM file_browser_size"
+		   " WHERE FileBrowser=%u AND Cod=crs_indicators.CrsCod),"
+		   "NumFilesWorks=(SELECT COALESCE(SUM(NumFiles),0) FROM file_browser_size"
+		   " WHERE FileBrowser=%u AND Cod=crs_indicators.CrsCod)"
+		   " WHERE ComputingToken='%s' AND (Computing&%u)<>0",
+		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_ASG_USR],
+		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_WRK_USR],
+		   Gbl.UniqueNameEncrypted,
+		   (unsigned) Ind_ASSIGNMENTS);
+
+   /***** Indicator #3: online tutoring *****/
+   DB_QueryUPDATE ("can not compute indicators of courses",
+		   "UPDATE crs_indicators SET"
+		   " NumThreads=(SELECT COUNT(*) FROM forum_thread"
+		   " WHERE ForumType=%u AND Location=crs_indicators.CrsCod),"
+		   "NumPosts=(SELECT COUNT(*) FROM forum_thread,forum_post"
+		   " WHERE forum_thread.ForumType=%u"
+		   " AND forum_thread.Location=crs_indicators.CrsCod"
+		   " AND forum_thread.ThrCod=forum_post.ThrCod),"
+		   "NumNotif=(SELECT COALESCE(SUM(forum_post.NumNotif),0) FROM forum_thread,forum_post"
+		   " WHERE forum_thread.ForumType=%u"
+		   " AND forum_thread.Location=crs_indicators.CrsCod"
+		   " AND forum_thread.ThrCod=forum_post.ThrCod),"
+		   "NumMsgsSentByTchs=(SELECT COUNT(*) FROM msg_snt,crs_usr"
+		   " WHERE msg_snt.CrsCod=crs_indicators.CrsCod"
+		   " AND crs_usr.CrsCod=crs_indicators.CrsCod AND crs_usr.Role=%u"
+		   " AND msg_snt.UsrCod=crs_usr.UsrCod)"
+		   " WHERE ComputingToken='%s' AND (Computing&%u)<>0",
+		   (unsigned) For_FORUM_COURSE_USRS,
+		   (unsigned) For_FORUM_COURSE_USRS,
+		   (unsigned) For_FORUM_COURSE_USRS,
+		   (unsigned) Rol_TCH,
+		   Gbl.UniqueNameEncrypted,
+		   (unsigned) Ind_ONLINE_TUTORING);
+
+   /***** Indicator #4: materials *****/
+   DB_QueryUPDATE ("can not compute indicators of courses",
+		   "UPDATE crs_indicators SET"
+		   " NumFilesDocum="
+		   "(SELECT COALESCE(SUM(NumFiles),0) FROM file_browser_size"
+		   " WHERE FileBrowser=%u AND Cod=crs_indicators.CrsCod)+"
+		   "(SELECT COALESCE(SUM(file_browser_size.NumFiles),0)"
+		   " FROM crs_grp_types,crs_grp,file_browser_size"
+		   " WHERE crs_grp_types.CrsCod=crs_indicators.CrsCod"
+		   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
+		   " AND file_browser_size.FileBrowser=%u"
+		   " AND file_browser_size.Cod=crs_grp.GrpCod),"
+		   "NumFilesShare="
+		   "(SELECT COALESCE(SUM(NumFiles),0) FROM file_browser_size"
+		   " WHERE FileBrowser=%u AND Cod=crs_indicators.CrsCod)+"
+		   "(SELECT COALESCE(SUM(file_browser_size.NumFiles),0)"
 		   " FROM crs_grp_types,crs_grp,file_browser_size"
-		   " WHERE crs_grp_types.CrsCod=%ld"
+		   " WHERE crs_grp_types.CrsCod=crs_indicators.CrsCod"
 		   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
 		   " AND file_browser_size.FileBrowser=%u"
-		   " AND file_browser_size.Cod=crs_grp.GrpCod)",
+		   " AND file_browser_size.Cod=crs_grp.GrpCod)"
+		   " WHERE ComputingToken='%s' AND (Computing&%u)<>0",
 		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_DOC_CRS],
-		   CrsCod,
-		   CrsCod,
-		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_DOC_GRP]);
-
-   /***** Get row *****/
-   row = mysql_fetch_row (mysql_res);
-
-   /***** Get number of files (row[0]) *****/
-   if (sscanf (row[0],"%lu",&NumFiles) != 1)
-      Lay_ShowErrorAndExit ("Error when getting the number of files.");
+		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_DOC_GRP],
+		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_SHR_CRS],
+		   (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_SHR_GRP],
+		   Gbl.UniqueNameEncrypted,
+		   (unsigned) Ind_MATERIALS);
+
+   /***** Get courses in the batch *****/
+   NumCrss = (unsigned)
+   DB_QuerySELECT (&mysql_res,"can not get courses with dirty indicators",
+		   "SELECT CrsCod FROM crs_indicators"
+		   " WHERE ComputingToken='%s' AND Computing<>0",
+		   Gbl.UniqueNameEncrypted);
+
+   /***** The courses in the batch are no longer being computed *****/
+   DB_QueryUPDATE ("can not update indicators of courses",
+		   "UPDATE crs_indicators"
+		   " SET Computing=0,UpdateTime=NOW()"
+		   " WHERE ComputingToken='%s' AND Computing<>0",
+		   Gbl.UniqueNameEncrypted);
+
+   /***** Update number of indicators of the courses in the batch *****/
+   for (NumCrs = 0;
+	NumCrs < NumCrss;
+	NumCrs++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      if ((CrsCod = Str_ConvertStrCodToLongCod (row[0])) > 0)
+	{
+	 Ind_GetIndicatorsCrsFromDB (CrsCod,&IndicatorsCrs);
+	 Ind_StoreIndicatorsCrsIntoDB (CrsCod,IndicatorsCrs.NumIndicators);
+	}
+     }
 
    /***** Free structure that stores the query result *****/
    DB_FreeMySQLResult (&mysql_res);
-
-   return NumFiles;
   }
 
 /*****************************************************************************/
-/*********** Get the number of files in shared zones of a course ***********/
+/************* Get precomputed indicators of a course from database **********/
 /*****************************************************************************/
+// Return true if indicators are computed and not dirty
 
-static unsigned long Ind_GetNumFilesInShareZonesOfCrsFromDB (long CrsCod)
+static bool Ind_GetIndicatorsCrsFromDB (long CrsCod,
+                                        struct Ind_IndicatorsCrs *IndicatorsCrs)
   {
-   extern const Brw_FileBrowser_t Brw_FileBrowserForDB_files[Brw_NUM_TYPES_FILE_BROWSER];
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
-   unsigned long NumFiles;
-
-   /***** Get number of files in document zones of a course from database *****/
-   DB_QuerySELECT (&mysql_res,"can not get the number of files",
-		   "SELECT"
-		   " (SELECT COALESCE(SUM(NumFiles),0)"
-		   " FROM file_browser_size"
-		   " WHERE FileBrowser=%u AND Cod=%ld) +"
-		   " (SELECT COALESCE(SUM(file_browser_size.NumFiles),0)"
-		   " FROM crs_grp_types,crs_grp,file_browser_size"
-		   " WHERE crs_grp_types.CrsCod=%ld"
-		   " AND crs_grp_types.GrpTypCod=crs_grp.GrpTypCod"
-		   " AND file_browser_size.FileBrowser=%u"
-		   " AND file_browser_size.Cod=crs_grp.GrpCod)",
-	           (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_SHR_CRS],
-	           CrsCod,
-	           CrsCod,
-	           (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_SHR_GRP]);
-
-   /***** Get row *****/
-   row = mysql_fetch_row (mysql_res);
+   bool UpToDate = false;
+
+   /***** Reset indicators *****/
+   IndicatorsCrs->SyllabusLecSrc              =
+   IndicatorsCrs->SyllabusPraSrc              =
+   IndicatorsCrs->TeachingGuideSrc            =
+   IndicatorsCrs->AssessmentSrc               = Inf_INFO_SRC_NONE;
+   IndicatorsCrs->NumAssignments              = 0;
+   IndicatorsCrs->NumFilesAssignments         = 0;
+   IndicatorsCrs->NumFilesWorks               = 0;
+   IndicatorsCrs->NumThreads                  = 0;
+   IndicatorsCrs->NumPosts                    = 0;
+   IndicatorsCrs->NumUsrsToBeNotifiedByEMail  = 0;
+   IndicatorsCrs->NumMsgsSentByTchs           = 0;
+   IndicatorsCrs->NumFilesInDocumentZones     = 0;
+   IndicatorsCrs->NumFilesInSharedZones       = 0;
+
+   /***** Get indicators of a course from database *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get indicators of a course",
+		       "SELECT Dirty|Computing,"	// row[ 0]
+			      "SyllabusLecSrc,"		// row[ 1]
+			      "SyllabusPraSrc,"		// row[ 2]
+			      "TeachingGuideSrc,"	// row[ 3]
+			      "AssessmentSrc,"		// row[ 4]
+			      "NumAsgs,"		// row[ 5]
+			      "NumFilesAsgs,"		// row[ 6]
+			      "NumFilesWorks,"		// row[ 7]
+			      "NumThreads,"		// row[ 8]
+			      "NumPosts,"		// row[ 9]
+			      "NumNotif,"		// row[10]
+			      "NumMsgsSentByTchs,"	// row[11]
+			      "NumFilesDocum,"		// row[12]
+			      "NumFilesShare"		// row[13]
+		       " FROM crs_indicators"
+		       " WHERE CrsCod=%ld",
+		       CrsCod))
+     {
+      row = mysql_fetch_row (mysql_res);
 
-   /***** Get number of files (row[0]) *****/
-   if (sscanf (row[0],"%lu",&NumFiles) != 1)
-      Lay_ShowErrorAndExit ("Error when getting the number of files.");
+      /* Get if indicators are dirty (row[0]) */
+      UpToDate = !strcmp (row[0],"0");
+
+      /* Get sources of syllabus, teaching guide and assessment (row[1]...row[4]) */
+      IndicatorsCrs->SyllabusLecSrc   = Inf_ConvertFromStrDBToInfoSrc (row[1]);
+      IndicatorsCrs->SyllabusPraSrc   = Inf_ConvertFromStrDBToInfoSrc (row[2]);
+      IndicatorsCrs->TeachingGuideSrc = Inf_ConvertFromStrDBToInfoSrc (row[3]);
+      IndicatorsCrs->AssessmentSrc    = Inf_ConvertFromStrDBToInfoSrc (row[4]);
+
+      /* Get numbers of assignments, threads, posts, messages and files (row[5]...row[13]) */
+      sscanf (row[ 5],"%u" ,&IndicatorsCrs->NumAssignments);
+      sscanf (row[ 6],"%lu",&IndicatorsCrs->NumFilesAssignments);
+      sscanf (row[ 7],"%lu",&IndicatorsCrs->NumFilesWorks);
+      sscanf (row[ 8],"%u" ,&IndicatorsCrs->NumThreads);
+      sscanf (row[ 9],"%u" ,&IndicatorsCrs->NumPosts);
+      sscanf (row[10],"%u" ,&IndicatorsCrs->NumUsrsToBeNotifiedByEMail);
+      sscanf (row[11],"%u" ,&IndicatorsCrs->NumMsgsSentByTchs);
+      sscanf (row[12],"%lu",&IndicatorsCrs->NumFilesInDocumentZones);
+      sscanf (row[13],"%lu",&IndicatorsCrs->NumFilesInSharedZones);
+     }
 
    /***** Free structure that stores the query result *****/
    DB_FreeMySQLResult (&mysql_res);
 
-   return NumFiles;
+   /***** Compute number of indicators *****/
+   Ind_ComputeNumIndicatorsCrs (IndicatorsCrs);
+
+   return UpToDate;
   }
 
 /*****************************************************************************/
-/********* Get the number of files in assignment zones of a course ***********/
+/************ Store number of indicators of a course in database *************/
 /*****************************************************************************/
 
-static unsigned long Ind_GetNumFilesInAssigZonesOfCrsFromDB (long CrsCod)
+static void Ind_StoreIndicatorsCrsIntoDB (long CrsCod,unsigned NumIndicators)
   {
-   extern const Brw_FileBrowser_t Brw_FileBrowserForDB_files[Brw_NUM_TYPES_FILE_BROWSER];
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumFiles;
-
-   /***** Get number of files in document zones of a course from database *****/
-   DB_QuerySELECT (&mysql_res,"can not get the number of files",
-		   "SELECT COALESCE(SUM(NumFiles),0)"
-		   " FROM file_browser_size"
-		   " WHERE FileBrowser=%u AND Cod=%ld",
-	           (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_ASG_USR],
-	           CrsCod);
-
-   /***** Get row *****/
-   row = mysql_fetch_row (mysql_res);
-
-   /***** Get number of files (row[0]) *****/
-   if (sscanf (row[0],"%lu",&NumFiles) != 1)
-      Lay_ShowErrorAndExit ("Error when getting the number of files.");
-
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
-
-   return NumFiles;
+   /***** Store number of indicators of a course in database *****/
+   DB_QueryUPDATE ("can not store number of indicators of a course",
+		   "UPDATE courses SET NumIndicators=%u"
+		   " WHERE CrsCod=%ld AND NumIndicators<>%u",
+                   NumIndicators,CrsCod,NumIndicators);
   }
 
 /*****************************************************************************/
-/************* Get the number of files in works zones of a course ************/
+/************** Compute number of indicators of a course *********************/
 /*****************************************************************************/
 
-static unsigned long Ind_GetNumFilesInWorksZonesOfCrsFromDB (long CrsCod)
+static void Ind_ComputeNumIndicatorsCrs (struct Ind_IndicatorsCrs *IndicatorsCrs)
   {
-   extern const Brw_FileBrowser_t Brw_FileBrowserForDB_files[Brw_NUM_TYPES_FILE_BROWSER];
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumFiles;
+   /***** Initialize number of indicators *****/
+   IndicatorsCrs->NumIndicators = 0;
 
-   /***** Get number of files in document zones of a course from database *****/
-   DB_QuerySELECT (&mysql_res,"can not get the number of files",
-		   "SELECT COALESCE(SUM(NumFiles),0)"
-		   " FROM file_browser_size"
-		   " WHERE FileBrowser=%u AND Cod=%ld",
-	           (unsigned) Brw_FileBrowserForDB_files[Brw_ADMI_WRK_USR],
-	           CrsCod);
+   /***** Indicator #1: information about syllabus *****/
+   IndicatorsCrs->ThereIsSyllabus = (IndicatorsCrs->SyllabusLecSrc   != Inf_INFO_SRC_NONE) ||
+                                    (IndicatorsCrs->SyllabusPraSrc   != Inf_INFO_SRC_NONE) ||
+                                    (IndicatorsCrs->TeachingGuideSrc != Inf_INFO_SRC_NONE);
+   if (IndicatorsCrs->ThereIsSyllabus)
+      IndicatorsCrs->NumIndicators++;
 
-   /***** Get row *****/
-   row = mysql_fetch_row (mysql_res);
+   /***** Indicator #2: information about assignments *****/
+   IndicatorsCrs->ThereAreAssignments = (IndicatorsCrs->NumAssignments      != 0) ||
+                                        (IndicatorsCrs->NumFilesAssignments != 0) ||
+                                        (IndicatorsCrs->NumFilesWorks       != 0);
+   if (IndicatorsCrs->ThereAreAssignments)
+      IndicatorsCrs->NumIndicators++;
+
+   /***** Indicator #3: information about online tutoring *****/
+   IndicatorsCrs->ThereIsOnlineTutoring = (IndicatorsCrs->NumThreads        != 0) ||
+	                                  (IndicatorsCrs->NumPosts          != 0) ||
+	                                  (IndicatorsCrs->NumMsgsSentByTchs != 0);
+   if (IndicatorsCrs->ThereIsOnlineTutoring)
+      IndicatorsCrs->NumIndicators++;
 
-   /***** Get number of files (row[0]) *****/
-   if (sscanf (row[0],"%lu",&NumFiles) != 1)
-      Lay_ShowErrorAndExit ("Error when getting the number of files.");
+   /***** Indicator #4: information about materials *****/
+   IndicatorsCrs->ThereAreMaterials = (IndicatorsCrs->NumFilesInDocumentZones != 0) ||
+                                      (IndicatorsCrs->NumFilesInSharedZones   != 0);
+   if (IndicatorsCrs->ThereAreMaterials)
+      IndicatorsCrs->NumIndicators++;
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Indicator #5: information about assessment *****/
+   IndicatorsCrs->ThereIsAssessment = (IndicatorsCrs->AssessmentSrc    != Inf_INFO_SRC_NONE) ||
+                                      (IndicatorsCrs->TeachingGuideSrc != Inf_INFO_SRC_NONE);
+   if (IndicatorsCrs->ThereIsAssessment)
+      IndicatorsCrs->NumIndicators++;
 
-   return NumFiles;
+   /***** All the indicators are OK? *****/
+   IndicatorsCrs->CoursePartiallyOK = IndicatorsCrs->NumIndicators >= 1 &&
+	                              IndicatorsCrs->NumIndicators < Ind_NUM_INDICATORS;
+   IndicatorsCrs->CourseAllOK       = IndicatorsCrs->NumIndicators == Ind_NUM_INDICATORS;
   }
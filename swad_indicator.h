@@ -34,6 +34,14 @@
 #define Ind_NUM_INDICATORS 5
 #define Ind_MAX_SIZE_INDICATORS_SELECTED ((1 + Ind_NUM_INDICATORS) * (10 + 1))
 
+// Masks to set indicators of a course as dirty
+#define Ind_SYLLABUS		(1 << 0)	// Indicator #1
+#define Ind_ASSIGNMENTS		(1 << 1)	// Indicator #2
+#define Ind_ONLINE_TUTORING	(1 << 2)	// Indicator #3
+#define Ind_MATERIALS		(1 << 3)	// Indicator #4
+#define Ind_ASSESSMENT		(1 << 4)	// Indicator #5
+#define Ind_ALL_INDICATORS	((1 << Ind_NUM_INDICATORS) - 1)
+
 struct Ind_IndicatorsCrs
   {
    unsigned long NumFilesInDocumentZones;
@@ -73,8 +81,9 @@ struct Ind_Indicators
 
 void Ind_ReqIndicatorsCourses (void);
 void Ind_ShowIndicatorsCourses (void);
-int Ind_GetNumIndicatorsCrsFromDB (long CrsCod);
-void Ind_ComputeAndStoreIndicatorsCrs (long CrsCod,int NumIndicatorsFromDB,
-                                       struct Ind_IndicatorsCrs *IndicatorsCrs);
+void Ind_SetIndicatorsCrsAsDirty (long CrsCod,unsigned Indicators);
+void Ind_ComputeDirtyIndicators (void);
+void Ind_GetIndicatorsCrs (long CrsCod,struct Ind_IndicatorsCrs *IndicatorsCrs);
+void Ind_RemoveCrsIndicators (long CrsCod);
 
 #endif
@@ -37,8 +37,10 @@
 #include "swad_box.h"
 #include "swad_database.h"
 #include "swad_form.h"
+#include "swad_fragment_cache.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
+#include "swad_indicator.h"
 #include "swad_info.h"
 #include "swad_parameter.h"
 #include "swad_string.h"
@@ -96,7 +98,7 @@ static void (*Inf_FormsForEditionTypes[Inf_NUM_INFO_SOURCES])(Inf_InfoSrc_t Info
    [Inf_INFO_SRC_URL       ] = Inf_FormToSendURL,
   };
 
-static const char *Inf_NamesInDBForInfoSrc[Inf_NUM_INFO_SOURCES] =
+const char *Inf_NamesInDBForInfoSrc[Inf_NUM_INFO_SOURCES] =	// Also used in indicators
   {
    [Inf_INFO_SRC_NONE      ] = "none",
    [Inf_INFO_SRC_EDITOR    ] = "editor",
@@ -235,7 +237,7 @@ static const Act_Action_t Inf_ActionsRcvRchTxtInfo[Inf_NUM_INFO_TYPES] =
    [Inf_ASSESSMENT    ] = ActRcvRchTxtAss,
   };
 
-static const char *Inf_NamesInDBForInfoType[Inf_NUM_INFO_TYPES] =
+const char *Inf_NamesInDBForInfoType[Inf_NUM_INFO_TYPES] =	// Also used in indicators
   {
    [Inf_INTRODUCTION  ] = "intro",		// TODO: Change this to "introduction"!
    [Inf_TEACHING_GUIDE] = "description",	// TODO: Change this to "guide"!
@@ -299,6 +301,7 @@ static bool Inf_CheckAndShowPlainTxt (void);
 
 static bool Inf_CheckRichTxt (long CrsCod,Inf_InfoType_t InfoType);
 static bool Inf_CheckAndShowRichTxt (void);
+static void Inf_WriteRichTxtAsHTML (const char *TxtMD);
 
 /*****************************************************************************/
 /******** Show course info (theory, practices, bibliography, etc.) ***********/
@@ -1448,6 +1451,10 @@ void Inf_SetInfoSrcIntoDB (Inf_InfoSrc_t InfoSrc)
 		      Gbl.Hierarchy.Crs.CrsCod,
 		      Inf_NamesInDBForInfoType[Gbl.Crs.Info.Type],
 		      Inf_NamesInDBForInfoSrc[InfoSrc]);
+
+   /***** Indicators about syllabus and assessment must be computed again *****/
+   Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,
+                                Ind_SYLLABUS | Ind_ASSESSMENT);
   }
 
 
@@ -1640,6 +1647,10 @@ static void Inf_SetInfoTxtIntoDB (const char *InfoTxtHTML,const char *InfoTxtMD)
 		    Gbl.Hierarchy.Crs.CrsCod,
 		    Inf_NamesInDBForInfoType[Gbl.Crs.Info.Type],
 		    InfoTxtHTML,InfoTxtMD);
+
+   /***** Cached course info is no longer valid *****/
+   Frg_InvalidateFragments (Frg_CRS_INFO_PLAIN_TXT,Gbl.Hierarchy.Crs.CrsCod);
+   Frg_InvalidateFragments (Frg_CRS_INFO_RICH_TXT ,Gbl.Hierarchy.Crs.CrsCod);
   }
 
 /*****************************************************************************/
@@ -1750,18 +1761,25 @@ static bool Inf_CheckAndShowPlainTxt (void)
           Gbl.Crs.Info.Type == Inf_TEACHING_GUIDE)
          Lay_WriteHeaderClassPhoto (false,false,Gbl.Hierarchy.Ins.InsCod,Gbl.Hierarchy.Deg.DegCod,Gbl.Hierarchy.Crs.CrsCod);
 
-      HTM_DIV_Begin ("class=\"DAT LM\"");
+      /***** Write text from cache or, if not cached, generate it *****/
+      if (!Frg_BeginFragment (Frg_CRS_INFO_PLAIN_TXT,Gbl.Hierarchy.Crs.CrsCod,
+			      (unsigned) Gbl.Crs.Info.Type))
+	{
+	 HTM_DIV_Begin ("class=\"DAT LM\"");
+
+	 /* Convert to respectful HTML and insert links */
+	 Str_ChangeFormat (Str_FROM_HTML,Str_TO_RIGOROUS_HTML,
+			   TxtHTML,Cns_MAX_BYTES_LONG_TEXT,false);	// Convert from HTML to recpectful HTML
+	 Str_InsertLinks (TxtHTML,Cns_MAX_BYTES_LONG_TEXT,60);	// Insert links
 
-      /***** Convert to respectful HTML and insert links *****/
-      Str_ChangeFormat (Str_FROM_HTML,Str_TO_RIGOROUS_HTML,
-                        TxtHTML,Cns_MAX_BYTES_LONG_TEXT,false);	// Convert from HTML to recpectful HTML
-      Str_InsertLinks (TxtHTML,Cns_MAX_BYTES_LONG_TEXT,60);	// Insert links
+	 /* Write text */
+	 HTM_Txt (TxtHTML);
 
-      /***** Write text *****/
-      HTM_Txt (TxtHTML);
+	 HTM_DIV_End ();
+	 Frg_EndFragment ();
+	}
 
       /***** End box *****/
-      HTM_DIV_End ();
       Box_BoxEnd ();
 
       return true;
@@ -1797,13 +1815,6 @@ static bool Inf_CheckAndShowRichTxt (void)
    extern const char *Txt_INFO_TITLE[Inf_NUM_INFO_TYPES];
    char TxtHTML[Cns_MAX_BYTES_LONG_TEXT + 1];
    char TxtMD[Cns_MAX_BYTES_LONG_TEXT + 1];
-   char PathFileMD[PATH_MAX + 1];
-   char PathFileHTML[PATH_MAX + 1];
-   FILE *FileMD;		// Temporary Markdown file
-   FILE *FileHTML;		// Temporary HTML file
-   char MathJaxURL[PATH_MAX + 1];
-   char Command[512 + PATH_MAX * 3]; // Command to call the program of preprocessing of photos
-   int ReturnCode;
    bool ICanEdit = (Gbl.Usrs.Me.Role.Logged == Rol_TCH ||
                     Gbl.Usrs.Me.Role.Logged == Rol_SYS_ADM);
    const char *Help[Inf_NUM_INFO_TYPES] =
@@ -1838,89 +1849,113 @@ static bool Inf_CheckAndShowRichTxt (void)
           Gbl.Crs.Info.Type == Inf_TEACHING_GUIDE)
          Lay_WriteHeaderClassPhoto (false,false,Gbl.Hierarchy.Ins.InsCod,Gbl.Hierarchy.Deg.DegCod,Gbl.Hierarchy.Crs.CrsCod);
 
-      HTM_DIV_Begin ("id=\"crs_info\" class=\"LM\"");
+      /***** Write text from cache or, if not cached, convert it *****/
+      if (!Frg_BeginFragment (Frg_CRS_INFO_RICH_TXT,Gbl.Hierarchy.Crs.CrsCod,
+			      (unsigned) Gbl.Crs.Info.Type))
+	{
+	 Inf_WriteRichTxtAsHTML (TxtMD);
+	 Frg_EndFragment ();
+	}
+
+      /***** End box *****/
+      Box_BoxEnd ();
+
+      return true;
+     }
+
+   return false;
+  }
+
+/*****************************************************************************/
+/************** Convert rich text from Markdown to HTML and write it *********/
+/*****************************************************************************/
+
+static void Inf_WriteRichTxtAsHTML (const char *TxtMD)
+  {
+   char PathFileMD[PATH_MAX + 1];
+   char PathFileHTML[PATH_MAX + 1];
+   FILE *FileMD;		// Temporary Markdown file
+   FILE *FileHTML;		// Temporary HTML file
+   char MathJaxURL[PATH_MAX + 1];
+   char Command[512 + PATH_MAX * 3]; // Command to call the program of preprocessing of photos
+   int ReturnCode;
+
+   HTM_DIV_Begin ("id=\"crs_info\" class=\"LM\"");
 
-      /***** Store text into a temporary .md file in HTML output directory *****/
-      // TODO: change to another directory?
-      /* Create a unique name for the .md file */
-      snprintf (PathFileMD,sizeof (PathFileMD),
-	        "%s/%s.md",
-	        Cfg_PATH_OUT_PRIVATE,Gbl.UniqueNameEncrypted);
-      snprintf (PathFileHTML,sizeof (PathFileHTML),
-	        "%s/%s.md.html",	// Do not use only .html because that is the output temporary file
-	        Cfg_PATH_OUT_PRIVATE,Gbl.UniqueNameEncrypted);
+   /***** Store text into a temporary .md file in HTML output directory *****/
+   // TODO: change to another directory?
+   /* Create a unique name for the .md file */
+   snprintf (PathFileMD,sizeof (PathFileMD),
+	     "%s/%s.md",
+	     Cfg_PATH_OUT_PRIVATE,Gbl.UniqueNameEncrypted);
+   snprintf (PathFileHTML,sizeof (PathFileHTML),
+	     "%s/%s.md.html",	// Do not use only .html because that is the output temporary file
+	     Cfg_PATH_OUT_PRIVATE,Gbl.UniqueNameEncrypted);
 
-      /* Open Markdown file for writing */
-      if ((FileMD = fopen (PathFileMD,"wb")) == NULL)
-	 Lay_ShowErrorAndExit ("Can not create temporary Markdown file.");
+   /* Open Markdown file for writing */
+   if ((FileMD = fopen (PathFileMD,"wb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not create temporary Markdown file.");
 
-      /* Write text into Markdown file */
-      fprintf (FileMD,"%s",TxtMD);
+   /* Write text into Markdown file */
+   fprintf (FileMD,"%s",TxtMD);
 
-      /* Close Markdown file */
-      fclose (FileMD);
+   /* Close Markdown file */
+   fclose (FileMD);
 
-      /***** Convert from Markdown to HTML *****/
-      /* MathJax 2.5.1
+   /***** Convert from Markdown to HTML *****/
+   /* MathJax 2.5.1
 #ifdef Cfg_MATHJAX_LOCAL
-      // Use the local copy of MathJax
-      snprintf (MathJaxURL,sizeof (MathJaxURL),
-	        "=%s/MathJax/MathJax.js?config=TeX-AMS-MML_HTMLorMML",
-	        Cfg_URL_SWAD_PUBLIC);
+   // Use the local copy of MathJax
+   snprintf (MathJaxURL,sizeof (MathJaxURL),
+	     "=%s/MathJax/MathJax.js?config=TeX-AMS-MML_HTMLorMML",
+	     Cfg_URL_SWAD_PUBLIC);
 #else
-      // Use the MathJax Content Delivery Network (CDN)
-      MathJaxURL[0] = '\0';
+   // Use the MathJax Content Delivery Network (CDN)
+   MathJaxURL[0] = '\0';
 #endif
-      */
-      /* MathJax 3.0.1 */
+   */
+   /* MathJax 3.0.1 */
 #ifdef Cfg_MATHJAX_LOCAL
-      // Use the local copy of MathJax
-      snprintf (MathJaxURL,sizeof (MathJaxURL),
-	        "=%s/mathjax/tex-chtml.js",
-	        Cfg_URL_SWAD_PUBLIC);
+   // Use the local copy of MathJax
+   snprintf (MathJaxURL,sizeof (MathJaxURL),
+	     "=%s/mathjax/tex-chtml.js",
+	     Cfg_URL_SWAD_PUBLIC);
 #else
-      // Use the MathJax Content Delivery Network (CDN)
-      MathJaxURL[0] = '\0';
+   // Use the MathJax Content Delivery Network (CDN)
+   MathJaxURL[0] = '\0';
 #endif
-      // --ascii uses only ascii characters in output
-      //         (uses numerical entities instead of UTF-8)
-      //         is mandatory in order to convert (with iconv) the UTF-8 output of pandoc to WINDOWS-1252
-      snprintf (Command,sizeof (Command),
-	        "iconv -f WINDOWS-1252 -t UTF-8 %s"
-	        " | "
-	        "pandoc --ascii --mathjax%s -f markdown_github+tex_math_dollars -t html5"
-	        " | "
-	        "iconv -f UTF-8 -t WINDOWS-1252 -o %s",
-	        PathFileMD,
-	        MathJaxURL,
-	        PathFileHTML);
-      ReturnCode = system (Command);
-      if (ReturnCode == -1)
-	 Lay_ShowErrorAndExit ("Error when running command to convert from Markdown to HTML.");
-
-      /***** Remove Markdown file *****/
-      unlink (PathFileMD);
-
-      /***** Copy HTML file just created to HTML output *****/
-      /* Open temporary HTML file for reading */
-      if ((FileHTML = fopen (PathFileHTML,"rb")) == NULL)
-	 Lay_ShowErrorAndExit ("Can not open temporary HTML file.");
-
-      /* Copy from temporary HTML file to output file */
-      Fil_FastCopyOfOpenFiles (FileHTML,Gbl.F.Out);
-
-      /* Close and remove temporary HTML file */
-      fclose (FileHTML);
-      unlink (PathFileHTML);
-
-      /***** End box *****/
-      HTM_DIV_End ();
-      Box_BoxEnd ();
+   // --ascii uses only ascii characters in output
+   //         (uses numerical entities instead of UTF-8)
+   //         is mandatory in order to convert (with iconv) the UTF-8 output of pandoc to WINDOWS-1252
+   snprintf (Command,sizeof (Command),
+	     "iconv -f WINDOWS-1252 -t UTF-8 %s"
+	     " | "
+	     "pandoc --ascii --mathjax%s -f markdown_github+tex_math_dollars -t html5"
+	     " | "
+	     "iconv -f UTF-8 -t WINDOWS-1252 -o %s",
+	     PathFileMD,
+	     MathJaxURL,
+	     PathFileHTML);
+   ReturnCode = system (Command);
+   if (ReturnCode == -1)
+      Lay_ShowErrorAndExit ("Error when running command to convert from Markdown to HTML.");
+
+   /***** Remove Markdown file *****/
+   unlink (PathFileMD);
+
+   /***** Copy HTML file just created to HTML output *****/
+   /* Open temporary HTML file for reading */
+   if ((FileHTML = fopen (PathFileHTML,"rb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not open temporary HTML file.");
+
+   /* Copy from temporary HTML file to output file */
+   Fil_FastCopyOfOpenFiles (FileHTML,Gbl.F.Out);
+
+   /* Close and remove temporary HTML file */
+   fclose (FileHTML);
+   unlink (PathFileHTML);
 
-      return true;
-     }
-
-   return false;
+   HTM_DIV_End ();
   }
 
 /*****************************************************************************/
@@ -37,11 +37,13 @@
 #include "swad_form.h"
 #include "swad_forum.h"
 #include "swad_global.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_institution.h"
 #include "swad_logo.h"
 #include "swad_message.h"
 #include "swad_place.h"
+#include "swad_search_index.h"
 #include "swad_survey.h"
 
 /*****************************************************************************/
@@ -80,7 +82,6 @@ static void Ins_EditInstitutionsInternal (void);
 static void Ins_PutIconsEditingInstitutions (__attribute__((unused)) void *Args);
 static void Ins_PutIconToViewInstitutions (void);
 
-static void Ins_GetDataOfInstitFromRow (struct Instit *Ins,MYSQL_ROW row);
 
 static void Ins_GetShrtNameAndCtyOfInstitution (struct Instit *Ins,
                                                 char CtyName[Hie_MAX_BYTES_FULL_NAME + 1]);
@@ -831,7 +832,7 @@ bool Ins_GetDataOfInstitutionByCod (struct Instit *Ins)
 /********** Get data of a centre from a row resulting of a query *************/
 /*****************************************************************************/
 
-static void Ins_GetDataOfInstitFromRow (struct Instit *Ins,MYSQL_ROW row)
+void Ins_GetDataOfInstitFromRow (struct Instit *Ins,MYSQL_ROW row)
   {
    /***** Get institution code (row[0]) *****/
    if ((Ins->InsCod = Str_ConvertStrCodToLongCod (row[0])) < 0)
@@ -1402,10 +1403,14 @@ void Ins_RemoveInstitution (void)
 	        (unsigned) Ins_EditingIns->InsCod);
       Fil_RemoveTree (PathIns);
 
+      /***** Remove institution from search index *****/
+      SchIdx_RemoveRow (SchIdx_INS_NAME,Ins_EditingIns->InsCod);
+
       /***** Remove institution *****/
       DB_QueryDELETE ("can not remove an institution",
 		      "DELETE FROM institutions WHERE InsCod=%ld",
 		      Ins_EditingIns->InsCod);
+      HieSnp_InvalidateSnapshot ();
 
       /***** Flush caches *****/
       Ins_FlushCacheShortNameOfInstitution ();
@@ -1550,6 +1555,10 @@ static void Ins_UpdateInsNameDB (long InsCod,const char *FieldName,const char *N
    DB_QueryUPDATE ("can not update the name of an institution",
 		   "UPDATE institutions SET %s='%s' WHERE InsCod=%ld",
 	           FieldName,NewInsName,InsCod);
+   HieSnp_InvalidateSnapshot ();
+
+   /***** Update institution name in search index *****/
+   SchIdx_IndexRow (SchIdx_INS_NAME,InsCod);
 
    /***** Flush caches *****/
    Ins_FlushCacheShortNameOfInstitution ();
@@ -1606,6 +1615,7 @@ void Ins_UpdateInsWWWDB (long InsCod,const char NewWWW[Cns_MAX_BYTES_WWW + 1])
    DB_QueryUPDATE ("can not update the web of an institution",
 		   "UPDATE institutions SET WWW='%s' WHERE InsCod=%ld",
 	           NewWWW,InsCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
@@ -1643,6 +1653,7 @@ void Ins_ChangeInsStatus (void)
    DB_QueryUPDATE ("can not update the status of an institution",
 		   "UPDATE institutions SET Status=%u WHERE InsCod=%ld",
                    (unsigned) Status,Ins_EditingIns->InsCod);
+   HieSnp_InvalidateSnapshot ();
    Ins_EditingIns->Status = Status;
 
    /***** Create message to show the change made
@@ -1929,6 +1940,9 @@ static void Ins_CreateInstitution (unsigned Status)
 				Ins_EditingIns->ShrtName,
 				Ins_EditingIns->FullName,
 				Ins_EditingIns->WWW);
+
+   /***** Index name of new institution for searches *****/
+   SchIdx_IndexRow (SchIdx_INS_NAME,Ins_EditingIns->InsCod);
   }
 
 /*****************************************************************************/
@@ -104,6 +104,7 @@ void Ins_GetFullListOfInstitutions (long CtyCod);
 
 void Ins_WriteInstitutionNameAndCty (long InsCod);
 bool Ins_GetDataOfInstitutionByCod (struct Instit *Ins);
+void Ins_GetDataOfInstitFromRow (struct Instit *Ins,MYSQL_ROW row);
 void Ins_FlushCacheShortNameOfInstitution (void);
 void Ins_GetShortNameOfInstitution (struct Instit *Ins);
 void Ins_FlushCacheFullNameAndCtyOfInstitution (void);
@@ -38,6 +38,7 @@
 #include "swad_global.h"
 #include "swad_help.h"
 #include "swad_hierarchy_config.h"
+#include "swad_hierarchy_snapshot.h"
 #include "swad_HTML.h"
 #include "swad_institution.h"
 #include "swad_logo.h"
@@ -626,6 +627,7 @@ static void InsCfg_UpdateInsCtyDB (long InsCod,long CtyCod)
    DB_QueryUPDATE ("can not update the country of an institution",
 		   "UPDATE institutions SET CtyCod=%ld WHERE InsCod=%ld",
                    CtyCod,InsCod);
+   HieSnp_InvalidateSnapshot ();
   }
 
 /*****************************************************************************/
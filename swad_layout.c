@@ -38,29 +38,39 @@
 #include "swad_config.h"
 #include "swad_connected.h"
 #include "swad_database.h"
+#include "swad_duplicate.h"
 #include "swad_exam_announcement.h"
 #include "swad_exam_session.h"
+#include "swad_figure.h"
 #include "swad_firewall.h"
 #include "swad_follow.h"
 #include "swad_form.h"
+#include "swad_fragment_cache.h"
 #include "swad_global.h"
 #include "swad_help.h"
 #include "swad_hierarchy.h"
 #include "swad_holiday.h"
 #include "swad_HTML.h"
+#include "swad_indicator.h"
 #include "swad_language.h"
 #include "swad_link.h"
 #include "swad_log.h"
+#include "swad_log_archive.h"
+#include "swad_log_column.h"
 #include "swad_logo.h"
 #include "swad_match.h"
 #include "swad_MFU.h"
 #include "swad_notice.h"
 #include "swad_notification.h"
 #include "swad_parameter.h"
+#include "swad_profile_ranking.h"
+#include "swad_search_index.h"
 #include "swad_setting.h"
+#include "swad_statistic_rollup.h"
 #include "swad_tab.h"
 #include "swad_theme.h"
 #include "swad_timeline.h"
+#include "swad_worker.h"
 
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
@@ -1467,6 +1477,19 @@ void Lay_ShowErrorAndExit (const char *Txt)
       mysql_query (&Gbl.mysql,"UNLOCK TABLES");
      }
 
+   /***** Roll back transaction if started *****/
+   if (Gbl.DB.InTransaction)
+     {
+      Gbl.DB.InTransaction = false;
+      mysql_query (&Gbl.mysql,"ROLLBACK");
+     }
+
+   /***** In a worker process, leave its job in a right state *****/
+   Wrk_RunFunctionOnError ();
+
+   /***** If a fragment is being generated, restore HTML output *****/
+   Frg_AbortFragment ();
+
    if (!Gbl.WebService.IsWebService)
      {
       /****** If start of page is not written yet, do it now ******/
@@ -1634,6 +1657,24 @@ void Lay_RefreshNotifsAndConnected (void)
       Fil_RemoveOldTmpFiles (Cfg_PATH_MARK_PRIVATE		,Cfg_TIME_TO_DELETE_MARKS_TMP_FILES	,false);
    else if (!(Gbl.PID % 149))
       Fil_RemoveOldTmpFiles (Cfg_PATH_TEST_PRIVATE		,Cfg_TIME_TO_DELETE_TEST_TMP_FILES	,false);
+   else if (!(Gbl.PID % 151))
+      Wrk_RunDetachedTask (Fig_UpdateOldestSnapshotInSystem);	// Recompute the oldest system-wide figure in a worker process, it's a slow function
+   else if (!(Gbl.PID % 157))
+      Frg_RemoveOldFragments ();
+   else if (!(Gbl.PID % 163))
+      Wrk_RunDetachedTask (StaRol_RollUpNextHits);	// Pre-aggregate hits per hour from log in a worker process, it's a slow query
+   else if (!(Gbl.PID % 167))
+      Wrk_RunDetachedTask (LogArc_MaintainLogPartitions);	// Add next partition of log or archive the oldest one in a worker process, it's a slow query
+   else if (!(Gbl.PID % 173))
+      Wrk_RunDetachedTask (LogCol_ExportNextMonth);	// Export the next closed month of log to columns in a worker process, it's a slow query
+   else if (!(Gbl.PID % 179))
+      Wrk_RunDetachedTask (Ind_ComputeDirtyIndicators);	// Compute dirty indicators of a batch of courses in a worker process, it's a slow query
+   else if (!(Gbl.PID % 181))
+      Wrk_RunDetachedTask (PrfRnk_UpdateOldestRanking);	// Rebuild the oldest ranking of users' figures if it is old in a worker process, it's a slow query
+   else if (!(Gbl.PID % 191))
+      SchIdx_IndexNextRows ();			// Index a batch of names existing before the search index, it's a slow query
+   else if (!(Gbl.PID % 193))
+      Dup_StoreKeysOfNextUsrs ();		// Store keys of a batch of users to find similar users, it's a slow query
 
    /***** Send, before the HTML, the refresh time *****/
    HTM_TxtF ("%lu|",Gbl.Usrs.Connected.TimeToRefreshInMs);
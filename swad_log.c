@@ -33,6 +33,7 @@
 #include "swad_config.h"
 #include "swad_database.h"
 #include "swad_exam_log.h"
+#include "swad_fragment_cache.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_log.h"
@@ -127,6 +128,9 @@ void Log_LogAccess (const char *Comments)
    /* Log access while answering exam prints */
    ExaLog_LogAccess (LogCod);
 
+   /* Log hits and misses in cache of fragments */
+   Frg_LogAccess (LogCod);
+
    /* Log comments */
    if (Comments)
      {
@@ -0,0 +1,434 @@
+// swad_log_archive.c: monthly partitions of log and archive of old partitions
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#define _GNU_SOURCE 		// For asprintf
+#include <stdio.h>		// For asprintf, snprintf, sprintf
+#include <stdlib.h>		// For free, malloc
+#include <string.h>		// For strlen
+
+#include "swad_config.h"
+#include "swad_database.h"
+#include "swad_global.h"
+#include "swad_layout.h"
+#include "swad_log_archive.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Table log is partitioned by ranges of TO_DAYS(ClickTime):
+   one partition per year until 2019 (p2004...p2019),
+   one partition per month from 2020 (p202001, p202002...)
+   and a last partition pmax, which should be empty.
+   Monthly partitions are added in advance by splitting pmax.
+   Partitions older than Cfg_MONTHS_IN_LOG months are moved
+   to compressed tables log_p2004, log_p202001...,
+   registered in table log_archives with their range of click times.
+   Queries involving old clicks must use LogArc_BuildLogTable
+   to get the archives too.
+*/
+#define LogArc_MONTHS_OF_PARTITIONS_AHEAD	2	// Partitions are created these months in advance
+
+#define LogArc_MAX_BYTES_PARTITION_NAME		 8	// "p" + year + month
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static bool LogArc_CheckIfLogIsPartitionedByMonths (void);
+static bool LogArc_AddNextPartition (void);
+static bool LogArc_ArchiveOldestPartition (void);
+static void LogArc_CompressNextArchive (void);
+
+static bool LogArc_CheckIfTableExists (const char *TableName);
+static bool LogArc_CheckIfTableIsEmpty (const char *Table);
+
+/*****************************************************************************/
+/*********** Add a partition for next months or archive an old one ***********/
+/*****************************************************************************/
+// Only one step is done in each call, because altering log may take time.
+// This is a slow function, run from time to time
+// in a worker process started by a refresh process.
+// Only one process alters log at a time
+
+void LogArc_MaintainLogPartitions (void)
+  {
+   static const char *LockName = "swad_log_partitions";
+
+   /***** Another process is altering log ==> nothing to do *****/
+   if (!DB_GetNamedLock (LockName))
+      return;
+
+   /***** Log with old partitioning by years must be altered by hand *****/
+   if (LogArc_CheckIfLogIsPartitionedByMonths ())
+      /***** Add a partition for next months if not yet added *****/
+      if (!LogArc_AddNextPartition ())
+	 /***** Archive the oldest partition if it is too old *****/
+	 if (!LogArc_ArchiveOldestPartition ())
+	    /***** Compress an archive not yet compressed *****/
+	    LogArc_CompressNextArchive ();
+
+   DB_ReleaseNamedLock (LockName);
+  }
+
+/*****************************************************************************/
+/************ Check if log is partitioned by months with pmax ****************/
+/*****************************************************************************/
+
+static bool LogArc_CheckIfLogIsPartitionedByMonths (void)
+  {
+   return (DB_QueryCOUNT ("can not check partitions of log",
+			  "SELECT COUNT(*)"
+			  " FROM INFORMATION_SCHEMA.PARTITIONS"
+			  " WHERE TABLE_SCHEMA=DATABASE()"
+			  " AND TABLE_NAME='log'"
+			  " AND PARTITION_NAME='pmax'"
+			  " AND PARTITION_EXPRESSION LIKE '%%to_days%%'") != 0);
+  }
+
+/*****************************************************************************/
+/**************** Add a monthly partition splitting pmax *********************/
+/*****************************************************************************/
+// Return true if a partition has been added
+
+static bool LogArc_AddNextPartition (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   char PartitionName[LogArc_MAX_BYTES_PARTITION_NAME + 1];
+   long EndDays;
+   bool Added = false;
+
+   /***** Get name and end of the partition after the last one,
+          only if the last one ends before some months from now *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get last partition of log",
+		       "SELECT DATE_FORMAT(FROM_DAYS(MAX(CAST(PARTITION_DESCRIPTION AS UNSIGNED))),'p%%Y%%m'),"
+		              "TO_DAYS(FROM_DAYS(MAX(CAST(PARTITION_DESCRIPTION AS UNSIGNED)))"
+		              "+INTERVAL 1 MONTH)"
+		       " FROM INFORMATION_SCHEMA.PARTITIONS"
+		       " WHERE TABLE_SCHEMA=DATABASE()"
+		       " AND TABLE_NAME='log'"
+		       " AND PARTITION_DESCRIPTION<>'MAXVALUE'"
+		       " HAVING MAX(CAST(PARTITION_DESCRIPTION AS UNSIGNED))<"
+		       "TO_DAYS(DATE_FORMAT(NOW()+INTERVAL %u MONTH,'%%Y-%%m-01'))",
+		       LogArc_MONTHS_OF_PARTITIONS_AHEAD))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get partition name (row[0]) and end in days (row[1]) */
+      Str_Copy (PartitionName,row[0],
+		LogArc_MAX_BYTES_PARTITION_NAME);
+      if (sscanf (row[1],"%ld",&EndDays) == 1)
+	{
+	 /***** Split pmax (empty) in new partition and pmax *****/
+	 DB_Query ("can not add partition to log",
+		   "ALTER TABLE log REORGANIZE PARTITION pmax INTO"
+		   " (PARTITION %s VALUES LESS THAN (%ld),"
+		   "PARTITION pmax VALUES LESS THAN MAXVALUE)",
+		   PartitionName,EndDays);
+	 Added = true;
+	}
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Added;
+  }
+
+/*****************************************************************************/
+/************* Move the oldest partition of log to an archive ****************/
+/*****************************************************************************/
+/*
+   Steps are ordered so that, if interrupted,
+   the next call completes the archive without losing clicks:
+   1. Exchange partition with an empty table (only metadata, fast)
+   2. Register archive table
+   3. Drop empty partition
+   The archive table is compressed later, in another call,
+   because compressing is slow.
+   Return true if a partition has been archived
+*/
+
+static bool LogArc_ArchiveOldestPartition (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   char PartitionName[LogArc_MAX_BYTES_PARTITION_NAME + 1];
+   char TableName[LogArc_MAX_BYTES_TABLE_NAME + 1];
+   long EndDays;
+   unsigned long NumRows;
+
+   /***** Get oldest partition if it ends before the clicks kept in log *****/
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get oldest partition of log",
+			     "SELECT PARTITION_NAME,"
+			            "CAST(PARTITION_DESCRIPTION AS UNSIGNED)"
+			     " FROM INFORMATION_SCHEMA.PARTITIONS"
+			     " WHERE TABLE_SCHEMA=DATABASE()"
+			     " AND TABLE_NAME='log'"
+			     " AND PARTITION_DESCRIPTION<>'MAXVALUE'"
+			     " AND CAST(PARTITION_DESCRIPTION AS UNSIGNED)<="
+			     "TO_DAYS(DATE_FORMAT(NOW()-INTERVAL %u MONTH,'%%Y-%%m-01'))"
+			     " ORDER BY PARTITION_ORDINAL_POSITION"
+			     " LIMIT 1",
+			     (unsigned) Cfg_MONTHS_IN_LOG);
+   if (NumRows)
+     {
+      row = mysql_fetch_row (mysql_res);
+      Str_Copy (PartitionName,row[0],
+		LogArc_MAX_BYTES_PARTITION_NAME);
+      if (sscanf (row[1],"%ld",&EndDays) != 1)
+	 NumRows = 0;
+     }
+   DB_FreeMySQLResult (&mysql_res);
+   if (!NumRows)
+      return false;	// Nothing to archive
+   snprintf (TableName,sizeof (TableName),"log_%s",PartitionName);
+
+   /***** 1. Move clicks in partition to archive table *****/
+   if (!DB_QueryCOUNT ("can not check partition of log",
+		       "SELECT COUNT(*) FROM"
+		       " (SELECT LogCod FROM log PARTITION (%s) LIMIT 1) AS clicks",
+		       PartitionName))
+     {
+      /* Partition is empty: clicks are already archived
+         or there are no clicks in it */
+      if (LogArc_CheckIfTableExists (TableName))
+	 if (LogArc_CheckIfTableIsEmpty (TableName))
+	    DB_Query ("can not remove empty archive of log",
+		      "DROP TABLE %s",TableName);
+     }
+   else
+     {
+      /* Create an empty table with the same structure, not partitioned */
+      if (LogArc_CheckIfTableExists (TableName))
+	{
+	 if (!LogArc_CheckIfTableIsEmpty (TableName))
+	    return false;	// Both partition and archive have clicks: to be solved by hand
+	}
+      else
+	{
+	 DB_Query ("can not create archive of log",
+		   "CREATE TABLE %s LIKE log",TableName);
+	 DB_Query ("can not create archive of log",
+		   "ALTER TABLE %s REMOVE PARTITIONING",TableName);
+	}
+
+      /* Exchange partition and empty table */
+      DB_Query ("can not archive partition of log",
+		"ALTER TABLE log EXCHANGE PARTITION %s WITH TABLE %s",
+		PartitionName,TableName);
+     }
+
+   /***** 2. Register archive table *****/
+   if (LogArc_CheckIfTableExists (TableName))
+      DB_QueryREPLACE ("can not register archive of log",
+		       "REPLACE INTO log_archives"
+		       " (TableName,StartTime,EndTime)"
+		       " SELECT '%s',MIN(ClickTime),FROM_DAYS(%ld)"
+		       " FROM %s",
+		       TableName,EndDays,
+		       TableName);
+
+   /***** 3. Remove empty partition *****/
+   DB_Query ("can not remove partition of log",
+	     "ALTER TABLE log DROP PARTITION %s",PartitionName);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/**************** Compress an archive of log not yet compressed **************/
+/*****************************************************************************/
+// Archive tables are only read, so they are compressed to save space
+
+static void LogArc_CompressNextArchive (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   char TableName[LogArc_MAX_BYTES_TABLE_NAME + 1];
+   bool Found = false;
+
+   /***** Get the oldest archive not compressed *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get archives of log",
+		       "SELECT log_archives.TableName"
+		       " FROM log_archives,INFORMATION_SCHEMA.TABLES"
+		       " WHERE INFORMATION_SCHEMA.TABLES.TABLE_SCHEMA=DATABASE()"
+		       " AND INFORMATION_SCHEMA.TABLES.TABLE_NAME=log_archives.TableName"
+		       " AND INFORMATION_SCHEMA.TABLES.ROW_FORMAT<>'Compressed'"
+		       " ORDER BY log_archives.StartTime"
+		       " LIMIT 1"))
+     {
+      row = mysql_fetch_row (mysql_res);
+      Str_Copy (TableName,row[0],
+		LogArc_MAX_BYTES_TABLE_NAME);
+      Found = true;
+     }
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Compress archive table (slow) *****/
+   if (Found)
+      DB_Query ("can not compress archive of log",
+		"ALTER TABLE %s ROW_FORMAT=COMPRESSED KEY_BLOCK_SIZE=8",
+		TableName);
+  }
+
+/*****************************************************************************/
+/********************** Check if a table exists ******************************/
+/*****************************************************************************/
+
+static bool LogArc_CheckIfTableExists (const char *TableName)
+  {
+   return (DB_QueryCOUNT ("can not check if a table exists",
+			  "SELECT COUNT(*)"
+			  " FROM INFORMATION_SCHEMA.TABLES"
+			  " WHERE TABLE_SCHEMA=DATABASE()"
+			  " AND TABLE_NAME='%s'",
+			  TableName) != 0);
+  }
+
+/*****************************************************************************/
+/********************* Check if a table has no rows **************************/
+/*****************************************************************************/
+
+static bool LogArc_CheckIfTableIsEmpty (const char *Table)
+  {
+   return (DB_QueryCOUNT ("can not check if a table is empty",
+			  "SELECT COUNT(*) FROM"
+			  " (SELECT LogCod FROM %s LIMIT 1) AS clicks",
+			  Table) == 0);
+  }
+
+/*****************************************************************************/
+/********* Build the table to get clicks from, including archives ************/
+/*****************************************************************************/
+/*
+   If no archive has clicks in the range, LogTable is "log",
+   so the range in the query selects only the partitions involved.
+   Else LogTable is a derived table named log, joining archives and log,
+   with the range and the condition (i.e. "UsrCod=1234")
+   applied to each table to use its indexes.
+   LogTable must be freed by the caller.
+*/
+
+void LogArc_BuildLogTable (char **LogTable,
+                           time_t StartTimeUTC,time_t EndTimeUTC,
+                           const char *Condition)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumArchives;
+   unsigned NumArchive;
+   char *Where;
+   size_t MaxLength;
+   char *Ptr;
+
+   /***** Get archives with clicks in the range *****/
+   NumArchives = (unsigned) DB_QuerySELECT (&mysql_res,"can not get archives of log",
+					    "SELECT TableName"
+					    " FROM log_archives"
+					    " WHERE StartTime<=FROM_UNIXTIME(%ld)"
+					    " AND EndTime>FROM_UNIXTIME(%ld)"
+					    " ORDER BY StartTime",
+					    (long) EndTimeUTC,
+					    (long) StartTimeUTC);
+
+   if (NumArchives)
+     {
+      /***** Build the condition applied to each table *****/
+      if (asprintf (&Where,"ClickTime>=FROM_UNIXTIME(%ld)"
+			   " AND ClickTime<=FROM_UNIXTIME(%ld)"
+			   "%s%s%s",
+		    (long) StartTimeUTC,
+		    (long) EndTimeUTC,
+		    Condition ? " AND (" :
+				"",
+		    Condition ? Condition :
+				"",
+		    Condition ? ")" :
+				"") < 0)
+	 Lay_NotEnoughMemoryExit ();
+
+      /***** Build derived table joining archives and log *****/
+      MaxLength = (NumArchives + 1) *
+		  (strlen (Where) + LogArc_MAX_BYTES_TABLE_NAME + 32) + 16;
+      if ((*LogTable = malloc (MaxLength)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      Ptr = *LogTable;
+      Ptr += sprintf (Ptr,"(");
+      for (NumArchive = 0;
+	   NumArchive < NumArchives;
+	   NumArchive++)
+	{
+	 row = mysql_fetch_row (mysql_res);
+	 Ptr += sprintf (Ptr,"SELECT * FROM %s WHERE %s UNION ALL ",
+			 row[0],Where);
+	}
+      sprintf (Ptr,"SELECT * FROM log WHERE %s) AS log",Where);
+      free (Where);
+     }
+   else if (asprintf (LogTable,"log") < 0)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************ Get time of first click from a time, including archives ********/
+/*****************************************************************************/
+// Return 0 if there are no clicks from the given time
+
+time_t LogArc_GetFirstClickTime (time_t FromTimeUTC)
+  {
+   time_t FirstClickTimeUTC;
+
+   /***** Archives are older than log, so check them first *****/
+   FirstClickTimeUTC = (time_t) DB_QueryCOUNT ("can not get first click",
+					       "SELECT COALESCE(UNIX_TIMESTAMP(MIN(StartTime)),0)"
+					       " FROM log_archives"
+					       " WHERE EndTime>FROM_UNIXTIME(%ld)",
+					       (long) FromTimeUTC);
+   if (FirstClickTimeUTC)
+      return FirstClickTimeUTC > FromTimeUTC ? FirstClickTimeUTC :
+					       FromTimeUTC;
+
+   /***** Get first click in log *****/
+   return (time_t) DB_QueryCOUNT ("can not get first click",
+				  "SELECT COALESCE(UNIX_TIMESTAMP(MIN(ClickTime)),0)"
+				  " FROM log"
+				  " WHERE ClickTime>=FROM_UNIXTIME(%ld)",
+				  (long) FromTimeUTC);
+  }
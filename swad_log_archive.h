@@ -0,0 +1,49 @@
+// swad_log_archive.h: monthly partitions of log and archive of old partitions
+
+#ifndef _SWAD_LOG_ARC
+#define _SWAD_LOG_ARC
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <time.h>		// For time_t
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+#define LogArc_MAX_BYTES_TABLE_NAME 16	// Archive tables are named "log_" + partition name
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void LogArc_MaintainLogPartitions (void);
+
+void LogArc_BuildLogTable (char **LogTable,
+                           time_t StartTimeUTC,time_t EndTimeUTC,
+                           const char *Condition);
+time_t LogArc_GetFirstClickTime (time_t FromTimeUTC);
+
+#endif
@@ -0,0 +1,1341 @@
+// swad_log_column.c: closed months of log stored in columnar files
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#define _GNU_SOURCE 		// For vasprintf, timegm
+#include <linux/limits.h>	// For PATH_MAX
+#include <stdarg.h>		// For va_start, va_end
+#include <stdint.h>		// For uint32_t, uint64_t...
+#include <stdio.h>		// For FILE, fopen, fread, fwrite, rename, vasprintf
+#include <stdlib.h>		// For calloc, free, malloc, qsort, realloc
+#include <string.h>		// For memcmp, memcpy
+#include <unistd.h>		// For unlink
+
+#include "swad_code_set.h"
+#include "swad_config.h"
+#include "swad_database.h"
+#include "swad_date.h"
+#include "swad_file.h"
+#include "swad_global.h"
+#include "swad_layout.h"
+#include "swad_log_archive.h"
+#include "swad_log_column.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Each closed month (UTC) of log is exported to a file YYYYMM.col
+   and registered in table log_columns.
+   The file stores the columns needed for long-range usage analyses:
+   - Action, user and course codes are encoded
+     as indexes in dictionaries of distinct codes,
+     so filtering by user or course compares small integers
+     and a month without the user or course is skipped.
+   - Click times are sorted and encoded as deltas.
+   All numbers are written as variable-length integers (7 bits per byte).
+   Queries decode and scan blocks of rows with loops without branches.
+   If the file of a month is missing or wrong,
+   its clicks are got from log and the month is marked to be exported again.
+*/
+#define LogCol_MAGIC		"SWLC"
+#define LogCol_VERSION		1
+
+#define LogCol_ROWS_PER_BLOCK	4096	// Rows decoded and scanned together
+#define LogCol_MIN_COUNTS	  16	// Minimum number of counts allocated
+
+#define LogCol_NUM_SECTIONS 8
+typedef enum
+  {
+   LogCol_DICT_ACT,	// Distinct action codes (sorted, delta encoded)
+   LogCol_DICT_USR,	// Distinct user   codes (sorted, delta encoded)
+   LogCol_DICT_CRS,	// Distinct course codes (sorted, delta encoded)
+   LogCol_COL_TIME,	// Click times (delta encoded from start of month)
+   LogCol_COL_ACT,	// Index of action code in dictionary
+   LogCol_COL_USR,	// Index of user   code in dictionary
+   LogCol_COL_CRS,	// Index of course code in dictionary
+   LogCol_COL_ROLE,	// Role (one byte per click)
+  } LogCol_Section_t;
+
+/*****************************************************************************/
+/******************************* Private types *******************************/
+/*****************************************************************************/
+
+struct LogCol_SectionInfo
+  {
+   uint64_t Offset;	// Position in file
+   uint64_t NumBytes;
+   uint32_t NumValues;
+   uint32_t Reserved;
+  };
+
+struct LogCol_Header
+  {
+   char Magic[4];
+   uint32_t Version;
+   uint32_t NumClicks;
+   uint32_t Reserved;
+   int64_t StartTimeUTC;	// Start of month
+   int64_t EndTimeUTC;		// Start of next month
+   struct LogCol_SectionInfo Sections[LogCol_NUM_SECTIONS];
+  };
+
+struct LogCol_Buffer	// Section being encoded
+  {
+   size_t Length;
+   size_t Size;
+   unsigned char *Bytes;
+  };
+
+struct LogCol_Column	// Section being decoded
+  {
+   unsigned char *Bytes;
+   const unsigned char *Ptr;
+   const unsigned char *End;
+  };
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static struct
+  {
+   int64_t Times[LogCol_ROWS_PER_BLOCK];
+   uint32_t ActIdxs[LogCol_ROWS_PER_BLOCK];
+   uint32_t UsrIdxs[LogCol_ROWS_PER_BLOCK];
+   uint32_t CrsIdxs[LogCol_ROWS_PER_BLOCK];
+   unsigned char Roles[LogCol_ROWS_PER_BLOCK];
+   unsigned char Selected[LogCol_ROWS_PER_BLOCK];
+  } LogCol_Block;
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static bool LogCol_GetMonthToExport (time_t *StartTimeUTC);
+static void LogCol_ExportMonth (time_t StartTimeUTC);
+static void LogCol_GetDictionary (struct CodSet_CodeSet *Dict,const char *Field,
+                                  const char *LogTable,
+                                  time_t StartTimeUTC,time_t EndTimeUTC);
+static time_t LogCol_GetStartOfMonth (time_t TimeUTC,int MonthsAfter);
+static void LogCol_BuildPath (char Path[PATH_MAX + 1],time_t StartTimeUTC);
+
+static void LogCol_WriteByte (struct LogCol_Buffer *Buffer,unsigned char Byte);
+static void LogCol_WriteVarint (struct LogCol_Buffer *Buffer,uint64_t Value);
+static void LogCol_WriteDictionary (struct LogCol_Buffer *Buffer,
+                                    const struct CodSet_CodeSet *Dict);
+static void LogCol_WriteIndex (struct LogCol_Buffer *Buffer,
+                               const struct CodSet_CodeSet *Dict,
+                               const char *Str);
+static bool LogCol_WriteFile (const char *Path,struct LogCol_Header *Header,
+                              const struct LogCol_Buffer Buffers[LogCol_NUM_SECTIONS]);
+
+static bool LogCol_ReadVarint (const unsigned char **Ptr,const unsigned char *End,
+                               uint64_t *Value);
+static bool LogCol_ReadSection (FILE *File,const struct LogCol_Header *Header,
+                                LogCol_Section_t Section,
+                                struct LogCol_Column *Column);
+static bool LogCol_ReadDictionary (FILE *File,const struct LogCol_Header *Header,
+                                   LogCol_Section_t Section,
+                                   struct CodSet_CodeSet *Dict);
+static bool LogCol_ReadIndexes (struct LogCol_Column *Column,unsigned NumRows,
+                                uint32_t *Idxs,unsigned NumValues);
+
+static bool LogCol_GetCountsFromMonth (struct LogCol_Counts *Counts,
+                                       const struct LogCol_Filter *Filter,
+                                       LogCol_GroupBy_t GroupBy,
+                                       time_t StartTimeUTC);
+static void LogCol_GetCountsFromLogInMonth (struct LogCol_Counts *Counts,
+                                            const struct LogCol_Filter *Filter,
+                                            LogCol_GroupBy_t GroupBy,
+                                            time_t StartTimeUTC);
+static void LogCol_SetMonthToExport (time_t StartTimeUTC);
+
+static int LogCol_CompareKeys (const void *C1,const void *C2);
+static int LogCol_CompareNumClicks (const void *C1,const void *C2);
+
+/*****************************************************************************/
+/************* Export the next closed month of log to a file *****************/
+/*****************************************************************************/
+// This is a slow function, run from time to time
+// in a worker process started by a refresh process.
+// Only one process exports at a time
+
+void LogCol_ExportNextMonth (void)
+  {
+   static const char *LockName = "swad_log_columns";
+   time_t StartTimeUTC;
+
+   /***** Another process is exporting ==> nothing to do *****/
+   if (!DB_GetNamedLock (LockName))
+      return;
+
+   /***** Export a month *****/
+   if (LogCol_GetMonthToExport (&StartTimeUTC))
+      LogCol_ExportMonth (StartTimeUTC);
+
+   DB_ReleaseNamedLock (LockName);
+  }
+
+/*****************************************************************************/
+/************************* Get the month to export ***************************/
+/*****************************************************************************/
+// Return false if there is no month to export
+
+static bool LogCol_GetMonthToExport (time_t *StartTimeUTC)
+  {
+   time_t FirstClickTimeUTC;
+
+   /***** A month with its file missing or wrong is exported again *****/
+   if ((*StartTimeUTC = (time_t) DB_QueryCOUNT ("can not get columns of log",
+						"SELECT COALESCE(UNIX_TIMESTAMP(MIN(StartTime)),0)"
+						" FROM log_columns"
+						" WHERE ToExport='Y'")))
+      return true;
+
+   /***** Get start of the next month to export *****/
+   if ((*StartTimeUTC = LogCol_GetEndOfColumns ()) == (time_t) 0)
+     {
+      /* No month exported yet ==> start in the month of the first click */
+      if ((FirstClickTimeUTC = LogArc_GetFirstClickTime ((time_t) 0)) == (time_t) 0)
+	 return false;	// No clicks
+      *StartTimeUTC = LogCol_GetStartOfMonth (FirstClickTimeUTC,0);
+     }
+
+   /***** Only closed months are exported, because they will not change *****/
+   return LogCol_GetStartOfMonth (*StartTimeUTC,1) <=
+	  LogCol_GetStartOfMonth (Gbl.StartExecutionTimeUTC,0);
+  }
+
+/*****************************************************************************/
+/*********************** Export a month of log to a file *********************/
+/*****************************************************************************/
+// Clicks are got one by one from database, without storing them in memory
+
+static void LogCol_ExportMonth (time_t StartTimeUTC)
+  {
+   time_t EndTimeUTC;
+   time_t ClickTimeUTC;
+   time_t PrevClickTimeUTC;
+   char *LogTable;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumClicks;
+   unsigned Role;
+   struct CodSet_CodeSet DictAct;
+   struct CodSet_CodeSet DictUsr;
+   struct CodSet_CodeSet DictCrs;
+   struct LogCol_Buffer Buffers[LogCol_NUM_SECTIONS];
+   struct LogCol_Header Header;
+   LogCol_Section_t Section;
+   char Path[PATH_MAX + 1];
+   bool Written;
+
+   /***** Clicks in month may be archived *****/
+   EndTimeUTC = LogCol_GetStartOfMonth (StartTimeUTC,1);
+   LogArc_BuildLogTable (&LogTable,StartTimeUTC,EndTimeUTC - 1,NULL);
+
+   /***** Get dictionaries with distinct codes *****/
+   CodSet_ResetSet (&DictAct);
+   CodSet_ResetSet (&DictUsr);
+   CodSet_ResetSet (&DictCrs);
+   LogCol_GetDictionary (&DictAct,"ActCod",LogTable,StartTimeUTC,EndTimeUTC);
+   LogCol_GetDictionary (&DictUsr,"UsrCod",LogTable,StartTimeUTC,EndTimeUTC);
+   LogCol_GetDictionary (&DictCrs,"CrsCod",LogTable,StartTimeUTC,EndTimeUTC);
+
+   /***** Encode dictionaries *****/
+   for (Section  = (LogCol_Section_t) 0;
+	Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+     {
+      Buffers[Section].Length = Buffers[Section].Size = 0;
+      Buffers[Section].Bytes  = NULL;
+     }
+   LogCol_WriteDictionary (&Buffers[LogCol_DICT_ACT],&DictAct);
+   LogCol_WriteDictionary (&Buffers[LogCol_DICT_USR],&DictUsr);
+   LogCol_WriteDictionary (&Buffers[LogCol_DICT_CRS],&DictCrs);
+
+   /***** Get clicks in month sorted by time and encode columns *****/
+   DB_QuerySELECTunbuffered (&mysql_res,"can not get clicks",
+			     "SELECT UNIX_TIMESTAMP(ClickTime),"
+				    "ActCod,UsrCod,CrsCod,Role"
+			     " FROM %s"
+			     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+			     " AND ClickTime<FROM_UNIXTIME(%ld)"
+			     " ORDER BY ClickTime",
+			     LogTable,
+			     (long) StartTimeUTC,
+			     (long) EndTimeUTC);
+   free (LogTable);
+   for (NumClicks = 0, PrevClickTimeUTC = StartTimeUTC;
+	(row = mysql_fetch_row (mysql_res));
+	NumClicks++)
+     {
+      /* Click time (row[0]) as delta from previous click */
+      ClickTimeUTC = Dat_GetUNIXTimeFromStr (row[0]);
+      if (ClickTimeUTC < PrevClickTimeUTC)	// Should not happen, because clicks are sorted
+	 ClickTimeUTC = PrevClickTimeUTC;
+      LogCol_WriteVarint (&Buffers[LogCol_COL_TIME],
+                          (uint64_t) (ClickTimeUTC - PrevClickTimeUTC));
+      PrevClickTimeUTC = ClickTimeUTC;
+
+      /* Action, user and course (row[1], row[2], row[3]) as indexes */
+      LogCol_WriteIndex (&Buffers[LogCol_COL_ACT],&DictAct,row[1]);
+      LogCol_WriteIndex (&Buffers[LogCol_COL_USR],&DictUsr,row[2]);
+      LogCol_WriteIndex (&Buffers[LogCol_COL_CRS],&DictCrs,row[3]);
+
+      /* Role (row[4]) */
+      if (sscanf (row[4],"%u",&Role) != 1)
+	 Role = (unsigned) Rol_UNK;
+      if (Role >= Rol_NUM_ROLES)
+	 Role = (unsigned) Rol_UNK;
+      LogCol_WriteByte (&Buffers[LogCol_COL_ROLE],(unsigned char) Role);
+     }
+   DB_CheckUnbufferedResult ("can not get clicks");
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Build header *****/
+   memset (&Header,0,sizeof (Header));
+   memcpy (Header.Magic,LogCol_MAGIC,sizeof (Header.Magic));
+   Header.Version      = LogCol_VERSION;
+   Header.NumClicks    = NumClicks;
+   Header.StartTimeUTC = (int64_t) StartTimeUTC;
+   Header.EndTimeUTC   = (int64_t) EndTimeUTC;
+   Header.Sections[LogCol_DICT_ACT].NumValues = DictAct.Num;
+   Header.Sections[LogCol_DICT_USR].NumValues = DictUsr.Num;
+   Header.Sections[LogCol_DICT_CRS].NumValues = DictCrs.Num;
+   for (Section  = LogCol_COL_TIME;
+	Section <= LogCol_COL_ROLE;
+	Section++)
+      Header.Sections[Section].NumValues = NumClicks;
+
+   /***** Write file *****/
+   Fil_CreateDirIfNotExists (Cfg_PATH_LOG_COLUMNS_PRIVATE);
+   LogCol_BuildPath (Path,StartTimeUTC);
+   Written = LogCol_WriteFile (Path,&Header,Buffers);
+
+   /***** Free memory *****/
+   for (Section  = (LogCol_Section_t) 0;
+	Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+      if (Buffers[Section].Bytes)
+	 free (Buffers[Section].Bytes);
+   CodSet_FreeSet (&DictAct);
+   CodSet_FreeSet (&DictUsr);
+   CodSet_FreeSet (&DictCrs);
+
+   /***** Register month as exported *****/
+   if (Written)
+      DB_QueryREPLACE ("can not register columns of log",
+		       "REPLACE INTO log_columns"
+		       " (StartTime,EndTime,NumClicks,ToExport)"
+		       " VALUES"
+		       " (FROM_UNIXTIME(%ld),FROM_UNIXTIME(%ld),%u,'N')",
+		       (long) StartTimeUTC,
+		       (long) EndTimeUTC,
+		       NumClicks);
+  }
+
+/*****************************************************************************/
+/************* Get distinct codes of a field of log in a month ***************/
+/*****************************************************************************/
+
+static void LogCol_GetDictionary (struct CodSet_CodeSet *Dict,const char *Field,
+                                  const char *LogTable,
+                                  time_t StartTimeUTC,time_t EndTimeUTC)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumCods;
+   unsigned NumCod;
+
+   /***** Get distinct codes *****/
+   NumCods = (unsigned) DB_QuerySELECT (&mysql_res,"can not get codes in log",
+					"SELECT DISTINCT %s"
+					" FROM %s"
+					" WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+					" AND ClickTime<FROM_UNIXTIME(%ld)",
+					Field,
+					LogTable,
+					(long) StartTimeUTC,
+					(long) EndTimeUTC);
+
+   /***** Add codes to dictionary *****/
+   for (NumCod = 0;
+	NumCod < NumCods;
+	NumCod++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      CodSet_AddCodToSet (Dict,Str_ConvertStrCodToLongCod (row[0]));
+     }
+   CodSet_SortSet (Dict);
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/********** Get end of the months exported (0 if none exported) **************/
+/*****************************************************************************/
+// Clicks before this time are in columns
+
+time_t LogCol_GetEndOfColumns (void)
+  {
+   return (time_t) DB_QueryCOUNT ("can not get end of columns of log",
+				  "SELECT COALESCE(UNIX_TIMESTAMP(MAX(EndTime)),0)"
+				  " FROM log_columns");
+  }
+
+/*****************************************************************************/
+/*************** Get start of a month (UTC) from a given time ****************/
+/*****************************************************************************/
+
+static time_t LogCol_GetStartOfMonth (time_t TimeUTC,int MonthsAfter)
+  {
+   struct tm tm;
+
+   gmtime_r (&TimeUTC,&tm);
+   tm.tm_mday = 1;
+   tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+   tm.tm_mon += MonthsAfter;	// timegm normalizes month and year
+
+   return timegm (&tm);
+  }
+
+/*****************************************************************************/
+/********************** Build path of file of a month ************************/
+/*****************************************************************************/
+
+static void LogCol_BuildPath (char Path[PATH_MAX + 1],time_t StartTimeUTC)
+  {
+   struct tm tm;
+
+   gmtime_r (&StartTimeUTC,&tm);
+   snprintf (Path,PATH_MAX + 1,"%s/%04d%02d.col",
+	     Cfg_PATH_LOG_COLUMNS_PRIVATE,
+	     1900 + tm.tm_year,1 + tm.tm_mon);
+  }
+
+/*****************************************************************************/
+/************************* Write bytes to a buffer ***************************/
+/*****************************************************************************/
+
+static void LogCol_WriteByte (struct LogCol_Buffer *Buffer,unsigned char Byte)
+  {
+   unsigned char *Bytes;
+
+   /***** Enlarge buffer if full *****/
+   if (Buffer->Length == Buffer->Size)
+     {
+      Buffer->Size = Buffer->Size ? Buffer->Size * 2 :
+				    4096;
+      if ((Bytes = realloc (Buffer->Bytes,Buffer->Size)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      Buffer->Bytes = Bytes;
+     }
+
+   /***** Add byte *****/
+   Buffer->Bytes[Buffer->Length++] = Byte;
+  }
+
+// 7 bits per byte, the highest bit is 1 when more bytes follow
+
+static void LogCol_WriteVarint (struct LogCol_Buffer *Buffer,uint64_t Value)
+  {
+   while (Value >= 0x80)
+     {
+      LogCol_WriteByte (Buffer,(unsigned char) (Value | 0x80));
+      Value >>= 7;
+     }
+   LogCol_WriteByte (Buffer,(unsigned char) Value);
+  }
+
+// Codes are sorted, so they are written as differences with the previous one.
+// Differences are zigzag encoded because the first code may be negative
+
+static void LogCol_WriteDictionary (struct LogCol_Buffer *Buffer,
+                                    const struct CodSet_CodeSet *Dict)
+  {
+   unsigned NumCod;
+   int64_t Delta;
+   long PrevCod;
+
+   for (NumCod = 0, PrevCod = 0;
+	NumCod < Dict->Num;
+	NumCod++)
+     {
+      Delta = (int64_t) Dict->Cods[NumCod] - (int64_t) PrevCod;
+      LogCol_WriteVarint (Buffer,((uint64_t) Delta << 1) ^ (uint64_t) (Delta >> 63));
+      PrevCod = Dict->Cods[NumCod];
+     }
+  }
+
+static void LogCol_WriteIndex (struct LogCol_Buffer *Buffer,
+                               const struct CodSet_CodeSet *Dict,
+                               const char *Str)
+  {
+   unsigned Index;
+
+   if (!CodSet_GetIndexOfCodInSet (Dict,Str_ConvertStrCodToLongCod (Str),&Index))
+      Index = 0;	// Should not happen, because dictionary has all the codes
+   LogCol_WriteVarint (Buffer,(uint64_t) Index);
+  }
+
+/*****************************************************************************/
+/***************** Write header and sections to a file ***********************/
+/*****************************************************************************/
+// Return true if file has been written
+
+static bool LogCol_WriteFile (const char *Path,struct LogCol_Header *Header,
+                              const struct LogCol_Buffer Buffers[LogCol_NUM_SECTIONS])
+  {
+   char PathTmp[PATH_MAX + 1];
+   FILE *File;
+   LogCol_Section_t Section;
+   uint64_t Offset;
+   bool Ok;
+
+   /***** Sections are written after header *****/
+   for (Section  = (LogCol_Section_t) 0, Offset = sizeof (*Header);
+	Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+     {
+      Header->Sections[Section].Offset   = Offset;
+      Header->Sections[Section].NumBytes = Buffers[Section].Length;
+      Offset += Buffers[Section].Length;
+     }
+
+   /***** Write a temporary file and rename it,
+          so readers never get an incomplete file *****/
+   snprintf (PathTmp,sizeof (PathTmp),"%s.%d.tmp",Path,(int) Gbl.PID);
+   if ((File = fopen (PathTmp,"wb")) == NULL)
+      return false;
+   Ok = (fwrite (Header,sizeof (*Header),1,File) == 1);
+   for (Section  = (LogCol_Section_t) 0;
+	Ok && Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+      if (Buffers[Section].Length)
+	 Ok = (fwrite (Buffers[Section].Bytes,1,Buffers[Section].Length,File) ==
+	       Buffers[Section].Length);
+   if (fclose (File))
+      Ok = false;
+   if (Ok)
+      Ok = (rename (PathTmp,Path) == 0);
+   if (!Ok)
+      unlink (PathTmp);
+
+   return Ok;
+  }
+
+/*****************************************************************************/
+/********************** Read sections of a file ******************************/
+/*****************************************************************************/
+
+static bool LogCol_ReadVarint (const unsigned char **Ptr,const unsigned char *End,
+                               uint64_t *Value)
+  {
+   unsigned Shift;
+
+   for (*Value = 0, Shift = 0;
+	*Ptr < End && Shift < 64;
+	Shift += 7)
+     {
+      *Value |= (uint64_t) (**Ptr & 0x7F) << Shift;
+      if (!(*(*Ptr)++ & 0x80))
+	 return true;
+     }
+
+   return false;	// Truncated or wrong value
+  }
+
+// Column->Bytes must be freed by the caller, even if false is returned
+
+static bool LogCol_ReadSection (FILE *File,const struct LogCol_Header *Header,
+                                LogCol_Section_t Section,
+                                struct LogCol_Column *Column)
+  {
+   size_t NumBytes = (size_t) Header->Sections[Section].NumBytes;
+
+   if ((Column->Bytes = malloc (NumBytes ? NumBytes :
+				           1)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   Column->Ptr = Column->Bytes;
+   Column->End = Column->Bytes + NumBytes;
+
+   if (NumBytes)
+      if (fseek (File,(long) Header->Sections[Section].Offset,SEEK_SET) ||
+	  fread (Column->Bytes,1,NumBytes,File) != NumBytes)
+	 return false;
+
+   return true;
+  }
+
+static bool LogCol_ReadDictionary (FILE *File,const struct LogCol_Header *Header,
+                                   LogCol_Section_t Section,
+                                   struct CodSet_CodeSet *Dict)
+  {
+   struct LogCol_Column Column;
+   unsigned NumCod;
+   uint64_t Value;
+   long Cod;
+   bool Ok;
+
+   Ok = LogCol_ReadSection (File,Header,Section,&Column);
+   for (NumCod = 0, Cod = 0;
+	Ok && NumCod < Header->Sections[Section].NumValues;
+	NumCod++)
+      if ((Ok = LogCol_ReadVarint (&Column.Ptr,Column.End,&Value)))
+	{
+	 Cod += (long) ((int64_t) (Value >> 1) ^ -(int64_t) (Value & 1));
+	 CodSet_AddCodToSet (Dict,Cod);
+	}
+   free (Column.Bytes);
+
+   return Ok;
+  }
+
+static bool LogCol_ReadIndexes (struct LogCol_Column *Column,unsigned NumRows,
+                                uint32_t *Idxs,unsigned NumValues)
+  {
+   unsigned NumRow;
+   uint64_t Value;
+
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      if (!LogCol_ReadVarint (&Column->Ptr,Column->End,&Value))
+	 return false;
+      if (Value >= NumValues)
+	 return false;
+      Idxs[NumRow] = (uint32_t) Value;
+     }
+
+   return true;
+  }
+
+/*****************************************************************************/
+/****************************** Reset a filter *******************************/
+/*****************************************************************************/
+
+void LogCol_ResetFilter (struct LogCol_Filter *Filter)
+  {
+   Filter->StartTimeUTC = (time_t) 0;
+   Filter->EndTimeUTC   = Gbl.StartExecutionTimeUTC;
+   Filter->UsrCod       = -1L;
+   Filter->CrsFilter    = LogCol_ANY_COURSE;
+   Filter->CrsCod       = -1L;
+   Filter->FirstRole    = (Rol_Role_t) 0;
+   Filter->LastRole     = (Rol_Role_t) (Rol_NUM_ROLES - 1);
+  }
+
+/*****************************************************************************/
+/***************************** Reset/free counts *****************************/
+/*****************************************************************************/
+
+void LogCol_ResetCounts (struct LogCol_Counts *Counts)
+  {
+   Counts->Num    = 0;
+   Counts->Size   = 0;
+   Counts->Counts = NULL;
+  }
+
+void LogCol_FreeCounts (struct LogCol_Counts *Counts)
+  {
+   if (Counts->Counts)
+      free (Counts->Counts);
+   LogCol_ResetCounts (Counts);
+  }
+
+/*****************************************************************************/
+/***************************** Add a count ***********************************/
+/*****************************************************************************/
+// Counts must be merged after adding them
+
+void LogCol_AddCount (struct LogCol_Counts *Counts,
+                      long Key,unsigned long NumClicks)
+  {
+   struct LogCol_Count *NewCounts;
+
+   /***** Enlarge counts if full *****/
+   if (Counts->Num == Counts->Size)
+     {
+      Counts->Size = Counts->Size ? Counts->Size * 2 :
+				    LogCol_MIN_COUNTS;
+      if ((NewCounts = realloc (Counts->Counts,
+                                Counts->Size * sizeof (*Counts->Counts))) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      Counts->Counts = NewCounts;
+     }
+
+   /***** Add count *****/
+   Counts->Counts[Counts->Num].Key       = Key;
+   Counts->Counts[Counts->Num].NumClicks = NumClicks;
+   Counts->Num++;
+  }
+
+/*****************************************************************************/
+/********** Add number of clicks got from columns of closed months ***********/
+/*****************************************************************************/
+
+void LogCol_GetCountsFromColumns (struct LogCol_Counts *Counts,
+                                  const struct LogCol_Filter *Filter,
+                                  LogCol_GroupBy_t GroupBy)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumMonths;
+   unsigned NumMonth;
+   time_t StartTimeUTC;
+   bool ToExport;
+
+   if (Filter->StartTimeUTC >= Filter->EndTimeUTC)
+      return;
+
+   /***** Get months with clicks in the range *****/
+   NumMonths = (unsigned) DB_QuerySELECT (&mysql_res,"can not get columns of log",
+					  "SELECT UNIX_TIMESTAMP(StartTime),"	// row[0]
+						 "ToExport"			// row[1]
+					  " FROM log_columns"
+					  " WHERE StartTime<FROM_UNIXTIME(%ld)"
+					  " AND EndTime>FROM_UNIXTIME(%ld)"
+					  " AND NumClicks>0"
+					  " ORDER BY StartTime",
+					  (long) Filter->EndTimeUTC,
+					  (long) Filter->StartTimeUTC);
+
+   /***** Scan each month *****/
+   for (NumMonth = 0;
+	NumMonth < NumMonths;
+	NumMonth++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      StartTimeUTC = Dat_GetUNIXTimeFromStr (row[0]);
+      ToExport = (row[1][0] == 'Y');
+
+      /* If the file of the month is missing or wrong,
+	 get clicks from log and export the month again later */
+      if (!ToExport)
+	 if (!LogCol_GetCountsFromMonth (Counts,Filter,GroupBy,StartTimeUTC))
+	   {
+	    LogCol_SetMonthToExport (StartTimeUTC);
+	    ToExport = true;
+	   }
+      if (ToExport)
+	 LogCol_GetCountsFromLogInMonth (Counts,Filter,GroupBy,StartTimeUTC);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************** Add number of clicks got from the file of a month ************/
+/*****************************************************************************/
+// Return false if the file is missing or wrong. In that case no count is added
+
+static bool LogCol_GetCountsFromMonth (struct LogCol_Counts *Counts,
+                                       const struct LogCol_Filter *Filter,
+                                       LogCol_GroupBy_t GroupBy,
+                                       time_t StartTimeUTC)
+  {
+   char Path[PATH_MAX + 1];
+   FILE *File;
+   struct LogCol_Header Header;
+   struct tm tm;
+   unsigned Year;
+   struct CodSet_CodeSet DictAct;
+   struct CodSet_CodeSet DictUsr;
+   struct CodSet_CodeSet DictCrs;
+   struct LogCol_Column Columns[LogCol_NUM_SECTIONS];
+   LogCol_Section_t Section;
+   bool NeedTime;
+   bool NeedAct;
+   bool NeedUsr;
+   bool NeedCrs;
+   bool NeedRole;
+   bool Scan = true;
+   bool Ok = true;
+   unsigned UsrIdx = 0;
+   unsigned CrsIdx = 0;
+   unsigned char *CrsIsSelected = NULL;
+   unsigned long *Counters = NULL;
+   unsigned NumCounters = 1;
+   unsigned NumCounter;
+   unsigned NumCrs;
+   unsigned Row;
+   unsigned NumRows;
+   unsigned i;
+   int64_t Time;
+   uint64_t Value;
+   long Key;
+
+   /***** Open file and check header *****/
+   LogCol_BuildPath (Path,StartTimeUTC);
+   if ((File = fopen (Path,"rb")) == NULL)
+      return false;
+   if (fread (&Header,sizeof (Header),1,File) != 1 ||
+       memcmp (Header.Magic,LogCol_MAGIC,sizeof (Header.Magic)) ||
+       Header.Version != LogCol_VERSION ||
+       Header.StartTimeUTC != (int64_t) StartTimeUTC)
+     {
+      fclose (File);
+      return false;
+     }
+
+   /***** All clicks in a month are in the same year *****/
+   gmtime_r (&StartTimeUTC,&tm);
+   Year = 1900 + (unsigned) tm.tm_year;
+
+   /***** Columns needed *****/
+   NeedTime = Filter->StartTimeUTC > (time_t) Header.StartTimeUTC ||
+	      Filter->EndTimeUTC   < (time_t) Header.EndTimeUTC;
+   NeedAct  = GroupBy == LogCol_GROUP_BY_ACTION;
+   NeedUsr  = Filter->UsrCod > 0;
+   NeedCrs  = Filter->CrsFilter != LogCol_ANY_COURSE ||
+	      GroupBy == LogCol_GROUP_BY_COURSE ||
+	      GroupBy == LogCol_GROUP_BY_COURSE_YEAR_ROLE;
+   NeedRole = Filter->FirstRole > (Rol_Role_t) 0 ||
+	      Filter->LastRole  < (Rol_Role_t) (Rol_NUM_ROLES - 1) ||
+	      GroupBy == LogCol_GROUP_BY_COURSE_YEAR_ROLE;
+
+   /***** Get dictionaries and skip month if user or course are not in it *****/
+   CodSet_ResetSet (&DictAct);
+   CodSet_ResetSet (&DictUsr);
+   CodSet_ResetSet (&DictCrs);
+   if (NeedUsr)
+     {
+      Ok = LogCol_ReadDictionary (File,&Header,LogCol_DICT_USR,&DictUsr);
+      if (Ok)
+	 Scan = CodSet_GetIndexOfCodInSet (&DictUsr,Filter->UsrCod,&UsrIdx);
+     }
+   if (Ok && Scan && NeedCrs)
+     {
+      Ok = LogCol_ReadDictionary (File,&Header,LogCol_DICT_CRS,&DictCrs);
+      if (Ok)
+	 switch (Filter->CrsFilter)
+	   {
+	    case LogCol_IN_ONE_COURSE:
+	       Scan = CodSet_GetIndexOfCodInSet (&DictCrs,Filter->CrsCod,&CrsIdx);
+	       break;
+	    case LogCol_WITHOUT_COURSE:
+	    case LogCol_IN_COURSES:
+	       if ((CrsIsSelected = malloc (DictCrs.Num ? DictCrs.Num :
+							  1)) == NULL)
+		  Lay_NotEnoughMemoryExit ();
+	       for (NumCrs = 0;
+		    NumCrs < DictCrs.Num;
+		    NumCrs++)
+		  CrsIsSelected[NumCrs] = (DictCrs.Cods[NumCrs] > 0) ==
+					  (Filter->CrsFilter == LogCol_IN_COURSES);
+	       break;
+	    default:
+	       break;
+	   }
+     }
+   if (Ok && Scan && NeedAct)
+      Ok = LogCol_ReadDictionary (File,&Header,LogCol_DICT_ACT,&DictAct);
+
+   /***** Read columns *****/
+   for (Section  = (LogCol_Section_t) 0;
+	Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+      Columns[Section].Bytes = NULL;
+   if (Ok && Scan)
+     {
+      if (NeedTime)
+	 Ok = LogCol_ReadSection (File,&Header,LogCol_COL_TIME,&Columns[LogCol_COL_TIME]);
+      if (Ok && NeedAct)
+	 Ok = LogCol_ReadSection (File,&Header,LogCol_COL_ACT ,&Columns[LogCol_COL_ACT ]);
+      if (Ok && NeedUsr)
+	 Ok = LogCol_ReadSection (File,&Header,LogCol_COL_USR ,&Columns[LogCol_COL_USR ]);
+      if (Ok && NeedCrs)
+	 Ok = LogCol_ReadSection (File,&Header,LogCol_COL_CRS ,&Columns[LogCol_COL_CRS ]);
+      if (Ok && NeedRole)
+	 Ok = LogCol_ReadSection (File,&Header,LogCol_COL_ROLE,&Columns[LogCol_COL_ROLE]);
+     }
+   fclose (File);
+
+   if (Ok && Scan)
+     {
+      /***** Allocate one counter per value of grouping *****/
+      switch (GroupBy)
+	{
+	 case LogCol_GROUP_BY_ACTION:
+	    NumCounters = DictAct.Num;
+	    break;
+	 case LogCol_GROUP_BY_COURSE:
+	    NumCounters = DictCrs.Num;
+	    break;
+	 case LogCol_GROUP_BY_COURSE_YEAR_ROLE:
+	    NumCounters = DictCrs.Num * Rol_NUM_ROLES;
+	    break;
+	 default:
+	    NumCounters = 1;
+	    break;
+	}
+      if ((Counters = calloc (NumCounters ? NumCounters :
+					    1,sizeof (*Counters))) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+
+      /***** Scan blocks of rows *****/
+      for (Row = 0, Time = Header.StartTimeUTC;
+	   Ok && Row < Header.NumClicks;
+	   Row += NumRows)
+	{
+	 NumRows = Header.NumClicks - Row;
+	 if (NumRows > LogCol_ROWS_PER_BLOCK)
+	    NumRows = LogCol_ROWS_PER_BLOCK;
+
+	 /* Decode needed columns of block */
+	 if (NeedTime)
+	    for (i = 0;
+		 Ok && i < NumRows;
+		 i++)
+	       if ((Ok = LogCol_ReadVarint (&Columns[LogCol_COL_TIME].Ptr,
+					    Columns[LogCol_COL_TIME].End,&Value)))
+		  LogCol_Block.Times[i] = (Time += (int64_t) Value);
+	 if (Ok && NeedAct)
+	    Ok = LogCol_ReadIndexes (&Columns[LogCol_COL_ACT],NumRows,
+				     LogCol_Block.ActIdxs,DictAct.Num);
+	 if (Ok && NeedUsr)
+	    Ok = LogCol_ReadIndexes (&Columns[LogCol_COL_USR],NumRows,
+				     LogCol_Block.UsrIdxs,DictUsr.Num);
+	 if (Ok && NeedCrs)
+	    Ok = LogCol_ReadIndexes (&Columns[LogCol_COL_CRS],NumRows,
+				     LogCol_Block.CrsIdxs,DictCrs.Num);
+	 if (Ok && NeedRole)
+	   {
+	    if ((Ok = (Columns[LogCol_COL_ROLE].End -
+		       Columns[LogCol_COL_ROLE].Ptr >= (long) NumRows)))
+	      {
+	       memcpy (LogCol_Block.Roles,Columns[LogCol_COL_ROLE].Ptr,NumRows);
+	       Columns[LogCol_COL_ROLE].Ptr += NumRows;
+	       for (i = 0;
+		    Ok && i < NumRows;
+		    i++)
+		  Ok = LogCol_Block.Roles[i] < Rol_NUM_ROLES;
+	      }
+	   }
+	 if (!Ok)
+	    break;
+
+	 /* Select rows of block matching the filter */
+	 memset (LogCol_Block.Selected,1,NumRows);
+	 if (NeedTime)
+	    for (i = 0;
+		 i < NumRows;
+		 i++)
+	       LogCol_Block.Selected[i] &= (LogCol_Block.Times[i] >= (int64_t) Filter->StartTimeUTC) &
+					   (LogCol_Block.Times[i] <  (int64_t) Filter->EndTimeUTC);
+	 if (NeedUsr)
+	    for (i = 0;
+		 i < NumRows;
+		 i++)
+	       LogCol_Block.Selected[i] &= (LogCol_Block.UsrIdxs[i] == UsrIdx);
+	 if (Filter->CrsFilter == LogCol_IN_ONE_COURSE)
+	    for (i = 0;
+		 i < NumRows;
+		 i++)
+	       LogCol_Block.Selected[i] &= (LogCol_Block.CrsIdxs[i] == CrsIdx);
+	 else if (CrsIsSelected)
+	    for (i = 0;
+		 i < NumRows;
+		 i++)
+	       LogCol_Block.Selected[i] &= CrsIsSelected[LogCol_Block.CrsIdxs[i]];
+	 if (NeedRole)
+	    for (i = 0;
+		 i < NumRows;
+		 i++)
+	       LogCol_Block.Selected[i] &= (LogCol_Block.Roles[i] >= (unsigned char) Filter->FirstRole) &
+					   (LogCol_Block.Roles[i] <= (unsigned char) Filter->LastRole);
+
+	 /* Count selected rows of block */
+	 switch (GroupBy)
+	   {
+	    case LogCol_GROUP_BY_ACTION:
+	       for (i = 0;
+		    i < NumRows;
+		    i++)
+		  Counters[LogCol_Block.ActIdxs[i]] += LogCol_Block.Selected[i];
+	       break;
+	    case LogCol_GROUP_BY_COURSE:
+	       for (i = 0;
+		    i < NumRows;
+		    i++)
+		  Counters[LogCol_Block.CrsIdxs[i]] += LogCol_Block.Selected[i];
+	       break;
+	    case LogCol_GROUP_BY_COURSE_YEAR_ROLE:
+	       for (i = 0;
+		    i < NumRows;
+		    i++)
+		  Counters[LogCol_Block.CrsIdxs[i] * Rol_NUM_ROLES +
+			   LogCol_Block.Roles[i]] += LogCol_Block.Selected[i];
+	       break;
+	    default:
+	       for (i = 0;
+		    i < NumRows;
+		    i++)
+		  Counters[0] += LogCol_Block.Selected[i];
+	       break;
+	   }
+	}
+
+      /***** Add counters to counts *****/
+      if (Ok)
+	 for (NumCounter = 0;
+	      NumCounter < NumCounters;
+	      NumCounter++)
+	    if (Counters[NumCounter])
+	      {
+	       switch (GroupBy)
+		 {
+		  case LogCol_GROUP_BY_ACTION:
+		     Key = DictAct.Cods[NumCounter];
+		     break;
+		  case LogCol_GROUP_BY_COURSE:
+		     Key = DictCrs.Cods[NumCounter];
+		     break;
+		  case LogCol_GROUP_BY_COURSE_YEAR_ROLE:
+		     Key = LogCol_KEY_CRS_YEAR_ROLE (DictCrs.Cods[NumCounter / Rol_NUM_ROLES],
+						     Year,
+						     NumCounter % Rol_NUM_ROLES);
+		     break;
+		  default:
+		     Key = (long) Year;
+		     break;
+		 }
+	       LogCol_AddCount (Counts,Key,Counters[NumCounter]);
+	      }
+     }
+
+   /***** Free memory *****/
+   if (Counters)
+      free (Counters);
+   if (CrsIsSelected)
+      free (CrsIsSelected);
+   for (Section  = (LogCol_Section_t) 0;
+	Section <= (LogCol_Section_t) (LogCol_NUM_SECTIONS - 1);
+	Section++)
+      if (Columns[Section].Bytes)
+	 free (Columns[Section].Bytes);
+   CodSet_FreeSet (&DictAct);
+   CodSet_FreeSet (&DictUsr);
+   CodSet_FreeSet (&DictCrs);
+
+   return Ok;
+  }
+
+/*****************************************************************************/
+/*************** Add number of clicks in a month got from log ****************/
+/*****************************************************************************/
+// Used when the file of the month is missing or wrong.
+// The same counts as from the file are added, although slower
+
+static void LogCol_GetCountsFromLogInMonth (struct LogCol_Counts *Counts,
+                                            const struct LogCol_Filter *Filter,
+                                            LogCol_GroupBy_t GroupBy,
+                                            time_t StartTimeUTC)
+  {
+   time_t EndTimeUTC;
+   struct tm tm;
+   unsigned Year;
+   char UsrCondition[64];
+   char CrsCondition[64];
+   const char *Fields;
+   const char *GroupByFields;
+   char *LogTable;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumRows;
+   unsigned NumRow;
+   long Cod;
+   unsigned Role;
+   unsigned long NumClicks;
+   long Key;
+
+   /***** All clicks in a month are in the same year *****/
+   gmtime_r (&StartTimeUTC,&tm);
+   Year = 1900 + (unsigned) tm.tm_year;
+
+   /***** Range of the filter inside the month *****/
+   EndTimeUTC = LogCol_GetStartOfMonth (StartTimeUTC,1);
+   if (StartTimeUTC < Filter->StartTimeUTC)
+      StartTimeUTC = Filter->StartTimeUTC;
+   if (EndTimeUTC > Filter->EndTimeUTC)
+      EndTimeUTC = Filter->EndTimeUTC;
+   if (StartTimeUTC >= EndTimeUTC)
+      return;
+
+   /***** Conditions of the filter *****/
+   if (Filter->UsrCod > 0)
+      snprintf (UsrCondition,sizeof (UsrCondition),"UsrCod=%ld",
+		Filter->UsrCod);
+   else
+      UsrCondition[0] = '\0';
+   switch (Filter->CrsFilter)
+     {
+      case LogCol_WITHOUT_COURSE:
+	 Str_Copy (CrsCondition," AND CrsCod<=0",
+		   sizeof (CrsCondition) - 1);
+	 break;
+      case LogCol_IN_COURSES:
+	 Str_Copy (CrsCondition," AND CrsCod>0",
+		   sizeof (CrsCondition) - 1);
+	 break;
+      case LogCol_IN_ONE_COURSE:
+	 snprintf (CrsCondition,sizeof (CrsCondition)," AND CrsCod=%ld",
+		   Filter->CrsCod);
+	 break;
+      default:
+	 CrsCondition[0] = '\0';
+	 break;
+     }
+
+   /***** Fields to group by *****/
+   switch (GroupBy)
+     {
+      case LogCol_GROUP_BY_ACTION:
+	 Fields        = "ActCod,0";
+	 GroupByFields = " GROUP BY ActCod";
+	 break;
+      case LogCol_GROUP_BY_COURSE:
+	 Fields        = "CrsCod,0";
+	 GroupByFields = " GROUP BY CrsCod";
+	 break;
+      case LogCol_GROUP_BY_COURSE_YEAR_ROLE:
+	 Fields        = "CrsCod,Role";
+	 GroupByFields = " GROUP BY CrsCod,Role";
+	 break;
+      default:
+	 Fields        = "0,0";
+	 GroupByFields = "";
+	 break;
+     }
+
+   /***** Get clicks (they may be archived) *****/
+   LogArc_BuildLogTable (&LogTable,StartTimeUTC,EndTimeUTC - 1,
+			 UsrCondition[0] ? UsrCondition :
+					   NULL);
+   NumRows = (unsigned) DB_QuerySELECT (&mysql_res,"can not get clicks",
+					"SELECT %s,COUNT(*)"
+					" FROM %s"
+					" WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+					" AND ClickTime<FROM_UNIXTIME(%ld)"
+					"%s%s%s"
+					" AND Role>=%u AND Role<=%u"
+					"%s",
+					Fields,
+					LogTable,
+					(long) StartTimeUTC,
+					(long) EndTimeUTC,
+					UsrCondition[0] ? " AND " :
+							  "",
+					UsrCondition,
+					CrsCondition,
+					(unsigned) Filter->FirstRole,
+					(unsigned) Filter->LastRole,
+					GroupByFields);
+   free (LogTable);
+
+   /***** Add counts *****/
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      if (sscanf (row[0],"%ld",&Cod) == 1 &&
+	  sscanf (row[1],"%u",&Role) == 1 &&
+	  sscanf (row[2],"%lu",&NumClicks) == 1)
+	 if (NumClicks)
+	   {
+	    switch (GroupBy)
+	      {
+	       case LogCol_GROUP_BY_ACTION:
+	       case LogCol_GROUP_BY_COURSE:
+		  Key = Cod;
+		  break;
+	       case LogCol_GROUP_BY_COURSE_YEAR_ROLE:
+		  Key = LogCol_KEY_CRS_YEAR_ROLE (Cod,Year,Role);
+		  break;
+	       default:
+		  Key = (long) Year;
+		  break;
+	      }
+	    LogCol_AddCount (Counts,Key,NumClicks);
+	   }
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/**************** Mark a month to be exported again to a file ****************/
+/*****************************************************************************/
+
+static void LogCol_SetMonthToExport (time_t StartTimeUTC)
+  {
+   DB_QueryUPDATE ("can not update columns of log",
+		   "UPDATE log_columns SET ToExport='Y'"
+		   " WHERE StartTime=FROM_UNIXTIME(%ld)",
+		   (long) StartTimeUTC);
+  }
+
+/*****************************************************************************/
+/************** Add number of clicks got from database ***********************/
+/*****************************************************************************/
+// The query must get the key in the first column
+// and the number of clicks in the second one
+
+void LogCol_GetCountsFromQuery (struct LogCol_Counts *Counts,const char *MsgError,
+                                const char *fmt,...)
+  {
+   va_list ap;
+   int NumBytesPrinted;
+   char *Query;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumRows;
+   unsigned NumRow;
+   long Key;
+   unsigned long NumClicks;
+
+   /***** Build query *****/
+   va_start (ap,fmt);
+   NumBytesPrinted = vasprintf (&Query,fmt,ap);
+   va_end (ap);
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Query database *****/
+   NumRows = (unsigned) DB_QuerySELECT (&mysql_res,MsgError,
+					"%s",
+					Query);
+   free (Query);
+
+   /***** Add counts *****/
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      if (sscanf (row[0],"%ld",&Key) == 1 &&
+	  sscanf (row[1],"%lu",&NumClicks) == 1)
+	 LogCol_AddCount (Counts,Key,NumClicks);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/********** Sort counts by key and add counts with the same key **************/
+/*****************************************************************************/
+
+void LogCol_MergeCounts (struct LogCol_Counts *Counts)
+  {
+   unsigned NumCount;
+   unsigned NumCountsWithoutDup;
+
+   if (Counts->Num > 1)
+     {
+      /***** Sort counts by key *****/
+      qsort (Counts->Counts,Counts->Num,sizeof (*Counts->Counts),
+             LogCol_CompareKeys);
+
+      /***** Add counts with the same key *****/
+      for (NumCount = 1, NumCountsWithoutDup = 1;
+	   NumCount < Counts->Num;
+	   NumCount++)
+	 if (Counts->Counts[NumCount].Key == Counts->Counts[NumCountsWithoutDup - 1].Key)
+	    Counts->Counts[NumCountsWithoutDup - 1].NumClicks += Counts->Counts[NumCount].NumClicks;
+	 else
+	    Counts->Counts[NumCountsWithoutDup++] = Counts->Counts[NumCount];
+      Counts->Num = NumCountsWithoutDup;
+     }
+  }
+
+/*****************************************************************************/
+/*************** Sort counts from highest to lowest number *******************/
+/*****************************************************************************/
+
+void LogCol_SortCountsByNumClicks (struct LogCol_Counts *Counts)
+  {
+   if (Counts->Num > 1)
+      qsort (Counts->Counts,Counts->Num,sizeof (*Counts->Counts),
+             LogCol_CompareNumClicks);
+  }
+
+/*****************************************************************************/
+/************************ Get maximum number of clicks ***********************/
+/*****************************************************************************/
+
+unsigned long LogCol_GetMaxNumClicks (const struct LogCol_Counts *Counts)
+  {
+   unsigned NumCount;
+   unsigned long Max = 0;
+
+   for (NumCount = 0;
+	NumCount < Counts->Num;
+	NumCount++)
+      if (Counts->Counts[NumCount].NumClicks > Max)
+	 Max = Counts->Counts[NumCount].NumClicks;
+
+   return Max;
+  }
+
+/*****************************************************************************/
+/************************ Functions to sort counts ***************************/
+/*****************************************************************************/
+
+static int LogCol_CompareKeys (const void *C1,const void *C2)
+  {
+   long K1 = ((const struct LogCol_Count *) C1)->Key;
+   long K2 = ((const struct LogCol_Count *) C2)->Key;
+
+   return (K1 > K2) - (K1 < K2);
+  }
+
+static int LogCol_CompareNumClicks (const void *C1,const void *C2)
+  {
+   unsigned long N1 = ((const struct LogCol_Count *) C1)->NumClicks;
+   unsigned long N2 = ((const struct LogCol_Count *) C2)->NumClicks;
+
+   if (N1 != N2)
+      return (N1 < N2) - (N1 > N2);	// Highest number first
+   return LogCol_CompareKeys (C1,C2);
+  }
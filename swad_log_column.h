@@ -0,0 +1,104 @@
+// swad_log_column.h: closed months of log stored in columnar files
+
+#ifndef _SWAD_LOG_COL
+#define _SWAD_LOG_COL
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <time.h>		// For time_t
+
+#include "swad_role_type.h"
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+typedef enum
+  {
+   LogCol_GROUP_BY_YEAR,		// Key = year (UTC)
+   LogCol_GROUP_BY_ACTION,		// Key = action code
+   LogCol_GROUP_BY_COURSE,		// Key = course code
+   LogCol_GROUP_BY_COURSE_YEAR_ROLE,	// Key = LogCol_KEY_CRS_YEAR_ROLE (course,year,role)
+  } LogCol_GroupBy_t;
+
+// Key for clicks grouped by course, year and role.
+// The same expression must be used in queries to database
+#define LogCol_KEY_CRS_YEAR_ROLE(CrsCod,Year,Role) ((((long) (CrsCod)) * 10000L + (long) (Year)) * Rol_NUM_ROLES + (long) (Role))
+
+typedef enum
+  {
+   LogCol_ANY_COURSE,		// Clicks with or without course
+   LogCol_WITHOUT_COURSE,	// Clicks with CrsCod <= 0
+   LogCol_IN_COURSES,		// Clicks with CrsCod > 0
+   LogCol_IN_ONE_COURSE,	// Clicks with CrsCod == Filter.CrsCod
+  } LogCol_CrsFilter_t;
+
+struct LogCol_Filter
+  {
+   time_t StartTimeUTC;		// Clicks from this time...
+   time_t EndTimeUTC;		// ...until this time (not included)
+   long UsrCod;			// <= 0 ==> any user
+   LogCol_CrsFilter_t CrsFilter;
+   long CrsCod;			// Only for LogCol_IN_ONE_COURSE
+   Rol_Role_t FirstRole;	// Clicks with roles from FirstRole...
+   Rol_Role_t LastRole;		// ...to LastRole
+  };
+
+struct LogCol_Count
+  {
+   long Key;
+   unsigned long NumClicks;
+  };
+
+struct LogCol_Counts
+  {
+   unsigned Num;		// Number of counts
+   unsigned Size;		// Number of counts allocated
+   struct LogCol_Count *Counts;
+  };
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void LogCol_ExportNextMonth (void);
+time_t LogCol_GetEndOfColumns (void);
+
+void LogCol_ResetFilter (struct LogCol_Filter *Filter);
+
+void LogCol_ResetCounts (struct LogCol_Counts *Counts);
+void LogCol_FreeCounts (struct LogCol_Counts *Counts);
+void LogCol_AddCount (struct LogCol_Counts *Counts,
+                      long Key,unsigned long NumClicks);
+void LogCol_GetCountsFromColumns (struct LogCol_Counts *Counts,
+                                  const struct LogCol_Filter *Filter,
+                                  LogCol_GroupBy_t GroupBy);
+void LogCol_GetCountsFromQuery (struct LogCol_Counts *Counts,const char *MsgError,
+                                const char *fmt,...);
+void LogCol_MergeCounts (struct LogCol_Counts *Counts);
+void LogCol_SortCountsByNumClicks (struct LogCol_Counts *Counts);
+unsigned long LogCol_GetMaxNumClicks (const struct LogCol_Counts *Counts);
+
+#endif
@@ -28,19 +28,21 @@
 #include <stddef.h>		// For NULL
 #include <stdlib.h>		// For calloc
 #include <string.h>		// For string functions
-#include <sys/wait.h>		// For the macro WEXITSTATUS
 #include <unistd.h>		// For access, lstat, getpid, chdir, symlink, unlink
 
 #include "swad_account.h"
 #include "swad_box.h"
 #include "swad_database.h"
+#include "swad_file.h"
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_language.h"
 #include "swad_mail.h"
+#include "swad_notification.h"
 #include "swad_parameter.h"
 #include "swad_QR.h"
+#include "swad_smtp.h"
 #include "swad_tab.h"
 
 /*****************************************************************************/
@@ -55,6 +57,14 @@ extern struct Globals Gbl;
 
 #define Mai_LENGTH_EMAIL_CONFIRM_KEY Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64
 
+// Emails in outbox are sent in batches.
+// After an error, a email is retried later,
+// waiting twice the time waited after the previous attempt
+#define Mai_MAX_MAILS_PER_BATCH		   100
+#define Mai_MAX_ATTEMPTS		     8
+#define Mai_SECONDS_FIRST_RETRY		((time_t) 60UL)
+#define Mai_SECONDS_TO_IGNORE_CLAIM	((time_t) (60UL * 60UL))	// A claim older than 1 hour is ignored
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
@@ -103,6 +113,16 @@ static void Mai_InsertMailKey (const char Email[Cns_MAX_BYTES_EMAIL_ADDRESS + 1]
 static void Mai_EditingMailDomainConstructor (void);
 static void Mai_EditingMailDomainDestructor (void);
 
+static void Mai_BuildFileNameOutbox (long OutCod,char FileNameOutbox[PATH_MAX + 1]);
+static void Mai_RemoveMailFromOutbox (long OutCod);
+static SMTP_Result_t Mai_SendMailInOutbox (struct SMTP_Session *Session,
+                                           bool *SessionIsOpen,
+                                           long OutCod,const char *Email);
+static SMTP_Result_t Mai_SendMailInSession (struct SMTP_Session *Session,
+                                            bool *SessionIsOpen,
+                                            const char *Email,const char *Subject,
+                                            FILE *FileContent);
+
 /*****************************************************************************/
 /************************* List all the mail domains *************************/
 /*****************************************************************************/
@@ -1649,10 +1669,7 @@ bool Mai_SendMailMsgToConfirmEmail (void)
    extern const char *Txt_There_was_a_problem_sending_an_email_automatically;
    char FileNameMail[PATH_MAX + 1];
    FILE *FileMail;
-   char Command[2048 +
-		Cfg_MAX_BYTES_SMTP_PASSWORD +
-		Cns_MAX_BYTES_EMAIL_ADDRESS +
-		PATH_MAX]; // Command to execute for sending an email
+   char Subject[Mai_MAX_BYTES_SUBJECT + 1];
    int ReturnCode;
 
    /***** Create temporary file for mail content *****/
@@ -1677,26 +1694,13 @@ bool Mai_SendMailMsgToConfirmEmail (void)
 
    fclose (FileMail);
 
-   /***** Call the script to send an email *****/
-   snprintf (Command,sizeof (Command),
-	     "%s \"%s\" \"%s\" \"%s\" \"%s\" \"%s\" \"[%s] %s\" \"%s\"",
-             Cfg_COMMAND_SEND_AUTOMATIC_EMAIL,
-             Cfg_AUTOMATIC_EMAIL_SMTP_SERVER,
-	     Cfg_AUTOMATIC_EMAIL_SMTP_PORT,
-             Cfg_AUTOMATIC_EMAIL_FROM,
-             Gbl.Config.SMTPPassword,
-             Gbl.Usrs.Me.UsrDat.Email,
-             Cfg_PLATFORM_SHORT_NAME,Txt_Confirmation_of_your_email_NO_HTML,
-             FileNameMail);
-   ReturnCode = system (Command);
-   if (ReturnCode == -1)
-      Lay_ShowErrorAndExit ("Error when running script to send email.");
-
-   /***** Remove temporary file *****/
-   unlink (FileNameMail);
+   /***** Send email now *****/
+   snprintf (Subject,sizeof (Subject),
+	     "[%s] %s",
+             Cfg_PLATFORM_SHORT_NAME,Txt_Confirmation_of_your_email_NO_HTML);
+   ReturnCode = Mai_SendMailNow (Gbl.Usrs.Me.UsrDat.Email,Subject,FileNameMail);
 
    /***** Write message depending on return code *****/
-   ReturnCode = WEXITSTATUS(ReturnCode);
    switch (ReturnCode)
      {
       case 0: // Message sent successfully
@@ -1882,6 +1886,324 @@ void Mai_WriteFootNoteEMail (FILE *FileMail,Lan_Language_t Language)
             Cfg_URL_SWAD_CGI);
   }
 
+/*****************************************************************************/
+/*********************** Put an email into the outbox ************************/
+/*****************************************************************************/
+// The file with the content of the email is moved to the outbox
+// ToUsrCod and MaxNtfCod identify the notifications included in the email,
+// which will be marked as sent when the email is sent (-1 if none)
+// Return the code of the email in the outbox
+
+long Mai_QueueMail (long ToUsrCod,long MaxNtfCod,
+                    const char *Email,const char *Subject,
+                    const char FileNameMail[PATH_MAX + 1])
+  {
+   long OutCod;
+   char FileNameOutbox[PATH_MAX + 1];
+   FILE *FileMail;
+   FILE *FileOutbox;
+   char Buffer[4096];
+   size_t NumBytes;
+
+   /***** Insert email into outbox in database *****/
+   OutCod =
+   DB_QueryINSERTandReturnCode ("can not insert email into outbox",
+				"INSERT INTO mail_outbox"
+				" (ToUsrCod,MaxNtfCod,Email,"
+				"NumAttempts,NextAttempt,CreatTime,ClaimToken)"
+				" VALUES"
+				" (%ld,%ld,'%s',"
+				"0,NOW(),NOW(),'')",
+				ToUsrCod,MaxNtfCod,Email);
+
+   /***** Store subject and content in a file in outbox directory *****/
+   Fil_CreateDirIfNotExists (Cfg_PATH_OUTBOX_PRIVATE);
+   Mai_BuildFileNameOutbox (OutCod,FileNameOutbox);
+   if ((FileOutbox = fopen (FileNameOutbox,"wb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not open file to queue email.");
+   if ((FileMail = fopen (FileNameMail,"rb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not open file to queue email.");
+
+   /* First line: subject */
+   fprintf (FileOutbox,"%s\n",Subject);
+
+   /* Rest of lines: content */
+   while ((NumBytes = fread (Buffer,1,sizeof (Buffer),FileMail)))
+      fwrite (Buffer,1,NumBytes,FileOutbox);
+
+   fclose (FileMail);
+   fclose (FileOutbox);
+
+   /***** Remove temporary file *****/
+   unlink (FileNameMail);
+
+   return OutCod;
+  }
+
+/*****************************************************************************/
+/********** Send the emails in outbox that are waiting to be sent ************/
+/*****************************************************************************/
+// All the emails are sent in one session with the SMTP server.
+// Emails sent successfully are removed from outbox.
+// Emails not sent will be retried later.
+
+void Mai_SendQueuedMails (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumMails;
+   unsigned NumMail;
+   long OutCod;
+   long ToUsrCod;
+   long MaxNtfCod;
+   struct SMTP_Session Session;
+   bool SessionIsOpen = false;
+
+   /***** Claim emails whose time to be sent has come.
+          Next attempt is delayed before sending,
+          so if sending fails these emails will be retried later.
+          Claim is done in only one query,
+          so other processes will not get the same emails.
+          A claim not released after one hour
+          (the process was killed) is ignored *****/
+   DB_QueryUPDATE ("can not claim emails in outbox",
+		   "UPDATE mail_outbox"
+		   " SET ClaimToken='%s',"
+		   "NextAttempt=FROM_UNIXTIME(UNIX_TIMESTAMP()+(%lu<<NumAttempts)),"
+		   "NumAttempts=NumAttempts+1"
+		   " WHERE NextAttempt<=NOW()"
+		   " AND NumAttempts<%u"
+		   " AND (ClaimToken=''"
+		   " OR NextAttempt<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu))"
+		   " ORDER BY OutCod"
+		   " LIMIT %u",
+		   Gbl.UniqueNameEncrypted,
+		   Mai_SECONDS_FIRST_RETRY,
+		   Mai_MAX_ATTEMPTS,
+		   Mai_SECONDS_TO_IGNORE_CLAIM,
+		   Mai_MAX_MAILS_PER_BATCH);
+
+   /***** Get emails claimed by me *****/
+   NumMails = (unsigned) DB_QuerySELECT (&mysql_res,"can not get emails from outbox",
+					 "SELECT OutCod,"	// row[0]
+						"ToUsrCod,"	// row[1]
+						"MaxNtfCod,"	// row[2]
+						"Email"		// row[3]
+					 " FROM mail_outbox"
+					 " WHERE ClaimToken='%s'"
+					 " ORDER BY OutCod",
+					 Gbl.UniqueNameEncrypted);
+
+   /***** Send emails one by one in the same session *****/
+   for (NumMail = 0;
+	NumMail < NumMails;
+	NumMail++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get code of email in outbox (row[0]),
+         notifications included (row[1], row[2])
+         and email address (row[3]) */
+      OutCod    = Str_ConvertStrCodToLongCod (row[0]);
+      ToUsrCod  = Str_ConvertStrCodToLongCod (row[1]);
+      MaxNtfCod = Str_ConvertStrCodToLongCod (row[2]);
+
+      /* Send email */
+      switch (Mai_SendMailInOutbox (&Session,&SessionIsOpen,OutCod,row[3]))
+	{
+	 case SMTP_OK:
+	    /* Only now the notifications are sent */
+	    if (ToUsrCod > 0)
+	       Ntf_MarkNotifAsSent (ToUsrCod,MaxNtfCod);
+	    Mai_RemoveMailFromOutbox (OutCod);
+	    break;
+	 case SMTP_MAIL_REJECTED:	// Retried later
+	    break;
+	 case SMTP_CONNECTION_ERROR:	// Server unavailable ==> stop
+	    NumMail = NumMails;
+	    break;
+	}
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Close session with SMTP server *****/
+   if (SessionIsOpen)
+      SMTP_Close (&Session);
+
+   /***** Release emails not sent, to be retried later *****/
+   DB_QueryUPDATE ("can not release emails in outbox",
+		   "UPDATE mail_outbox SET ClaimToken=''"
+		   " WHERE ClaimToken='%s'",
+		   Gbl.UniqueNameEncrypted);
+
+   /***** Remove emails that could not be sent after many attempts.
+          The notifications included are not sent by email again,
+          so a wrong address is not retried forever *****/
+   NumMails = (unsigned) DB_QuerySELECT (&mysql_res,"can not get emails from outbox",
+					 "SELECT OutCod,"	// row[0]
+						"ToUsrCod,"	// row[1]
+						"MaxNtfCod"	// row[2]
+					 " FROM mail_outbox"
+					 " WHERE NumAttempts>=%u"
+					 " AND NextAttempt<=NOW()"
+					 " AND ClaimToken=''",
+					 Mai_MAX_ATTEMPTS);
+   for (NumMail = 0;
+	NumMail < NumMails;
+	NumMail++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get code of email in outbox (row[0])
+         and notifications included (row[1], row[2]) */
+      OutCod    = Str_ConvertStrCodToLongCod (row[0]);
+      ToUsrCod  = Str_ConvertStrCodToLongCod (row[1]);
+      MaxNtfCod = Str_ConvertStrCodToLongCod (row[2]);
+
+      /* Drop email */
+      if (ToUsrCod > 0)
+	 Ntf_MarkNotifAsNotSentByEmail (ToUsrCod,MaxNtfCod);
+      Mai_RemoveMailFromOutbox (OutCod);
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/************************** Send one email right now *************************/
+/*****************************************************************************/
+// Used when the user is waiting for the result.
+// The email is not stored in outbox, so it's not retried
+// and its content (for example a new password) is not kept.
+// Return 0 on success, or 1 on error
+
+int Mai_SendMailNow (const char *Email,const char *Subject,
+                     const char FileNameMail[PATH_MAX + 1])
+  {
+   FILE *FileMail;
+   struct SMTP_Session Session;
+   bool SessionIsOpen = false;
+   SMTP_Result_t Result = SMTP_MAIL_REJECTED;
+
+   /***** Send email *****/
+   if ((FileMail = fopen (FileNameMail,"rb")))
+     {
+      Result = Mai_SendMailInSession (&Session,&SessionIsOpen,
+				      Email,Subject,FileMail);
+      fclose (FileMail);
+     }
+   if (SessionIsOpen)
+      SMTP_Close (&Session);
+
+   /***** Remove temporary file *****/
+   unlink (FileNameMail);
+
+   return (Result == SMTP_OK) ? 0 :
+				1;
+  }
+
+/*****************************************************************************/
+/**************** Send one email in outbox in an open session ****************/
+/*****************************************************************************/
+// First line of file in outbox is the subject. The rest is the content.
+
+static SMTP_Result_t Mai_SendMailInOutbox (struct SMTP_Session *Session,
+                                           bool *SessionIsOpen,
+                                           long OutCod,const char *Email)
+  {
+   char FileNameOutbox[PATH_MAX + 1];
+   FILE *FileOutbox;
+   char Subject[Mai_MAX_BYTES_SUBJECT + 1];
+   SMTP_Result_t Result;
+
+   /***** Open file with subject and content *****/
+   Mai_BuildFileNameOutbox (OutCod,FileNameOutbox);
+   if ((FileOutbox = fopen (FileNameOutbox,"rb")) == NULL)
+      return SMTP_MAIL_REJECTED;
+
+   /***** Get subject from first line *****/
+   if (!fgets (Subject,sizeof (Subject),FileOutbox))
+      Subject[0] = '\0';
+   Subject[strcspn (Subject,"\r\n")] = '\0';
+
+   /***** Send email *****/
+   Result = Mai_SendMailInSession (Session,SessionIsOpen,
+				   Email,Subject,FileOutbox);
+   fclose (FileOutbox);
+
+   return Result;
+  }
+
+/*****************************************************************************/
+/*************** Send one email in a session with SMTP server ****************/
+/*****************************************************************************/
+// FileContent must be positioned at the start of the content.
+// The session is opened if not yet open,
+// and opened again once if server closed it.
+
+static SMTP_Result_t Mai_SendMailInSession (struct SMTP_Session *Session,
+                                            bool *SessionIsOpen,
+                                            const char *Email,const char *Subject,
+                                            FILE *FileContent)
+  {
+   long StartContent = ftell (FileContent);
+   unsigned NumAttempt;
+   SMTP_Result_t Result = SMTP_CONNECTION_ERROR;
+
+   for (NumAttempt = 0;
+	NumAttempt < 2 && Result == SMTP_CONNECTION_ERROR;
+	NumAttempt++)
+     {
+      /***** Open session if not open *****/
+      if (!*SessionIsOpen)
+	 if (!(*SessionIsOpen = SMTP_Open (Session,
+					   Cfg_AUTOMATIC_EMAIL_SMTP_SERVER,
+					   Cfg_AUTOMATIC_EMAIL_SMTP_PORT,
+					   !strcmp (Cfg_AUTOMATIC_EMAIL_SMTP_PORT,"465"),	// Implicit TLS
+					   Cfg_AUTOMATIC_EMAIL_FROM,
+					   Gbl.Config.SMTPPassword)))
+	    break;
+
+      /***** Send email *****/
+      fseek (FileContent,StartContent,SEEK_SET);
+      if ((Result = SMTP_SendMail (Session,Cfg_AUTOMATIC_EMAIL_FROM,Email,
+                                   Subject,FileContent)) == SMTP_CONNECTION_ERROR)
+	 *SessionIsOpen = false;	// Session closed by SMTP_SendMail
+     }
+
+   return Result;
+  }
+
+/*****************************************************************************/
+/************* Build the name of the file of an email in outbox **************/
+/*****************************************************************************/
+
+static void Mai_BuildFileNameOutbox (long OutCod,char FileNameOutbox[PATH_MAX + 1])
+  {
+   snprintf (FileNameOutbox,PATH_MAX + 1,
+	     "%s/%ld.txt",
+             Cfg_PATH_OUTBOX_PRIVATE,OutCod);
+  }
+
+/*****************************************************************************/
+/*********************** Remove an email from outbox *************************/
+/*****************************************************************************/
+
+static void Mai_RemoveMailFromOutbox (long OutCod)
+  {
+   char FileNameOutbox[PATH_MAX + 1];
+
+   /***** Remove email from database *****/
+   DB_QueryDELETE ("can not remove email from outbox",
+		   "DELETE FROM mail_outbox WHERE OutCod=%ld",
+		   OutCod);
+
+   /***** Remove file with subject and content *****/
+   Mai_BuildFileNameOutbox (OutCod,FileNameOutbox);
+   unlink (FileNameOutbox);
+  }
+
 /*****************************************************************************/
 /**************** Check if I can see another user's email ********************/
 /*****************************************************************************/
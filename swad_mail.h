@@ -36,6 +36,8 @@
 #define Mai_MAX_CHARS_MAIL_INFO		(128 - 1)	// 127
 #define Mai_MAX_BYTES_MAIL_INFO		((Mai_MAX_CHARS_MAIL_INFO + 1) * Str_MAX_BYTES_PER_CHAR - 1)	// 2047
 
+#define Mai_MAX_BYTES_SUBJECT		(256 - 1)	// Subject of automatic emails
+
 #define Mai_NUM_ORDERS 3
 typedef enum
   {
@@ -95,6 +97,13 @@ void Mai_CreateFileNameMail (char FileNameMail[PATH_MAX + 1],FILE **FileMail);
 void Mai_WriteWelcomeNoteEMail (FILE *FileMail,struct UsrData *UsrDat);
 void Mai_WriteFootNoteEMail (FILE *FileMail,Lan_Language_t Language);
 
+long Mai_QueueMail (long ToUsrCod,long MaxNtfCod,
+                    const char *Email,const char *Subject,
+                    const char FileNameMail[PATH_MAX + 1]);
+void Mai_SendQueuedMails (void);
+int Mai_SendMailNow (const char *Email,const char *Subject,
+                     const char FileNameMail[PATH_MAX + 1]);
+
 bool Mai_ICanSeeOtherUsrEmail (const struct UsrData *UsrDat);
 
 #endif
@@ -45,6 +45,7 @@
 #include "swad_group.h"
 #include "swad_HTML.h"
 #include "swad_ID.h"
+#include "swad_indicator.h"
 #include "swad_message.h"
 #include "swad_notification.h"
 #include "swad_pagination.h"
@@ -84,6 +85,15 @@ static const Pag_WhatPaginate_t Msg_WhatPaginate[Msg_NUM_TYPES_OF_MSGS] =
 /******************************** Private types ******************************/
 /*****************************************************************************/
 
+// How a message is delivered to a recipient
+#define Msg_NUM_DELIVERIES 3
+typedef enum
+  {
+   Msg_DELIVER_NOTIFY_BY_EMAIL,	// Notification sent by email
+   Msg_DELIVER_NOTIFY,		// Notification not sent by email
+   Msg_DELIVER_DONT_NOTIFY,	// No notification
+  } Msg_Delivery_t;
+
 /*****************************************************************************/
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
@@ -150,7 +160,11 @@ static long Msg_InsertNewMsg (const char *Subject,const char *Content,
 static unsigned long Msg_DelSomeRecOrSntMsgsUsr (const struct Msg_Messages *Messages,
                                                  Msg_TypeOfMessages_t TypeOfMessages,long UsrCod,
                                                  const char *FilterFromToSubquery);
-static void Msg_InsertReceivedMsgIntoDB (long MsgCod,long UsrCod,bool NotifyByEmail);
+static void Msg_CreateSubqueryEncryptedUsrCods (const char *ListEncryptedUsrCods,
+					       unsigned NumUsrsInList,
+					       char **SubQueryUsrs);
+static void Msg_InsertReceivedMsgIntoDB (long MsgCod,Msg_Delivery_t Delivery,
+                                         long LstUsrCods[],unsigned NumUsrsInList);
 static void Msg_SetReceivedMsgAsReplied (long MsgCod);
 static void Msg_MoveReceivedMsgToDeleted (long MsgCod,long UsrCod);
 static void Msg_MoveSentMsgToDeleted (long MsgCod);
@@ -746,19 +760,28 @@ void Msg_RecMsgFromUsr (void)
    extern const char *Txt_The_message_has_been_sent_to_X_recipients;
    extern const char *Txt_There_have_been_X_errors_in_sending_the_message;
    struct Msg_Messages Messages;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
    bool IsReply;
    bool RecipientHasBannedMe;
    bool Replied = false;
    long OriginalMsgCod = -1L;	// Initialized to avoid warning
-   const char *Ptr;
+   char *SubQueryEncryptedUsrCods;
+   unsigned NumSelectedUsrs;
+   unsigned NumUsrs;
+   unsigned NumUsr;
    unsigned NumRecipients;
    unsigned NumRecipientsToBeNotifiedByEMail = 0;
    struct UsrData UsrDstData;
+   unsigned CreateNotifMask;
+   unsigned SendEmailMask;
    int NumErrors = 0;
-   long NewMsgCod = -1L;	// Initiliazed to avoid warning
-   bool MsgAlreadyInserted = false;
+   long NewMsgCod;
    bool CreateNotif;
    bool NotifyByEmail;
+   Msg_Delivery_t Delivery;
+   long *LstUsrCods[Msg_NUM_DELIVERIES];
+   unsigned NumUsrsInLst[Msg_NUM_DELIVERIES];
    char Content[Cns_MAX_BYTES_LONG_TEXT + 1];
    struct Media Media;
    bool Error = false;
@@ -790,10 +813,10 @@ void Msg_RecMsgFromUsr (void)
    Error = Usr_GetListMsgRecipientsWrittenExplicitelyBySender (true);
 
    /***** Check number of recipients *****/
-   if ((NumRecipients = Usr_CountNumUsrsInListOfSelectedEncryptedUsrCods (&Gbl.Usrs.Selected)))
+   if ((NumSelectedUsrs = Usr_CountNumUsrsInListOfSelectedEncryptedUsrCods (&Gbl.Usrs.Selected)))
      {
       if (Gbl.Usrs.Me.Role.Logged == Rol_STD &&
-          NumRecipients > Cfg_MAX_RECIPIENTS)
+          NumSelectedUsrs > Cfg_MAX_RECIPIENTS)
         {
          /* Write warning message */
          Ale_ShowAlert (Ale_WARNING,Txt_You_can_not_send_a_message_to_so_many_recipients_);
@@ -830,80 +853,145 @@ void Msg_RecMsgFromUsr (void)
    Med_GetMediaFromForm (-1L,-1L,-1,&Media,NULL,NULL);
    Ale_ShowAlerts (NULL);
 
-   /***** Loop over the list Gbl.Usrs.Selected.List[Rol_UNK], that holds the list of the
-	  recipients, creating a received message for each recipient *****/
+   /***** Convert the content of the message to be stored in database *****/
    Str_ChangeFormat (Str_FROM_FORM,Str_TO_RIGOROUS_HTML,
                      Content,Cns_MAX_BYTES_LONG_TEXT,false);
-   Ptr = Gbl.Usrs.Selected.List[Rol_UNK];
-   NumRecipients = 0;
-   while (*Ptr)
+
+   /***** Get all the recipients in the list Gbl.Usrs.Selected.List[Rol_UNK]
+          from database, checking at once if they have banned me *****/
+   Msg_CreateSubqueryEncryptedUsrCods (Gbl.Usrs.Selected.List[Rol_UNK],NumSelectedUsrs,
+				       &SubQueryEncryptedUsrCods);
+   NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get recipients",
+					"SELECT usr_data.UsrCod,"		// row[0]
+					       "usr_data.FirstName,"		// row[1]
+					       "usr_data.Surname1,"		// row[2]
+					       "usr_data.Surname2,"		// row[3]
+					       "usr_data.NotifNtfEvents,"	// row[4]
+					       "usr_data.EmailNtfEvents,"	// row[5]
+					       "msg_banned.ToUsrCod IS NOT NULL"	// row[6]
+					" FROM usr_data LEFT JOIN msg_banned"
+					" ON msg_banned.FromUsrCod=%ld"
+					" AND msg_banned.ToUsrCod=usr_data.UsrCod"
+					" WHERE usr_data.EncryptedUsrCod IN (%s)"
+					" ORDER BY usr_data.Surname1,"
+					          "usr_data.Surname2,"
+					          "usr_data.FirstName,"
+					          "usr_data.UsrCod",
+					Gbl.Usrs.Me.UsrDat.UsrCod,
+					SubQueryEncryptedUsrCods);
+   free (SubQueryEncryptedUsrCods);
+
+   /***** Recipients not found in database are errors *****/
+   for (NumUsr = NumUsrs;
+	NumUsr < NumSelectedUsrs;
+	NumUsr++)
      {
-      Par_GetNextStrUntilSeparParamMult (&Ptr,UsrDstData.EncryptedUsrCod,
-                                         Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64);
-      Usr_GetUsrCodFromEncryptedUsrCod (&UsrDstData);
-      if (Usr_ChkUsrCodAndGetAllUsrDataFromUsrCod (&UsrDstData,Usr_DONT_GET_PREFS))		// Get recipient's data from the database
-        {
-         /***** Check if recipient has banned me *****/
-         RecipientHasBannedMe = Msg_CheckIfUsrIsBanned (Gbl.Usrs.Me.UsrDat.UsrCod,UsrDstData.UsrCod);
+      Ale_ShowAlert (Ale_ERROR,Txt_Error_getting_data_from_a_recipient);
+      NumErrors++;
+     }
 
-         if (RecipientHasBannedMe)
-            /***** Show an alert indicating that the message has not been sent successfully *****/
-            Ale_ShowAlert (Ale_WARNING,Txt_message_not_sent_to_X,
-		           UsrDstData.FullName);
-         else
-           {
-            /***** Create message *****/
-            if (!MsgAlreadyInserted)
-              {
-               // The message is inserted only once in the table of messages sent
-               NewMsgCod = Msg_InsertNewMsg (Messages.Subject,Content,&Media);
-               MsgAlreadyInserted = true;
-              }
+   /***** Allocate lists of recipients, one for each type of delivery *****/
+   for (Delivery  = (Msg_Delivery_t) 0;
+	Delivery <= (Msg_Delivery_t) (Msg_NUM_DELIVERIES - 1);
+	Delivery++)
+     {
+      LstUsrCods[Delivery] = NULL;
+      NumUsrsInLst[Delivery] = 0;
+      if (NumUsrs)
+	 if ((LstUsrCods[Delivery] = (long *) malloc (NumUsrs * sizeof (long))) == NULL)
+	    Lay_NotEnoughMemoryExit ();
+     }
 
-            /***** If this recipient is the original sender of a message been replied, set Replied to true *****/
-            Replied = (IsReply &&
-        	       UsrDstData.UsrCod == Gbl.Usrs.Other.UsrDat.UsrCod);
-
-            /***** This received message must be notified by email? *****/
-            CreateNotif = (UsrDstData.NtfEvents.CreateNotif & (1 << Ntf_EVENT_MESSAGE));
-            NotifyByEmail = CreateNotif &&
-        	            (UsrDstData.UsrCod != Gbl.Usrs.Me.UsrDat.UsrCod) &&
-                            (UsrDstData.NtfEvents.SendEmail & (1 << Ntf_EVENT_MESSAGE));
-
-            /***** Create the received message for this recipient
-                   and increment number of new messages received by this recipient *****/
-            Msg_InsertReceivedMsgIntoDB (NewMsgCod,UsrDstData.UsrCod,NotifyByEmail);
-
-            /***** Create notification for this recipient.
-                   If this recipient wants to receive notifications by -mail,
-                   activate the sending of a notification *****/
-            if (CreateNotif)
-               Ntf_StoreNotifyEventToOneUser (Ntf_EVENT_MESSAGE,&UsrDstData,NewMsgCod,
-                                              (Ntf_Status_t) (NotifyByEmail ? Ntf_STATUS_BIT_EMAIL :
-                                        	                              0),
-                                              Gbl.Hierarchy.Ins.InsCod,
-                                              Gbl.Hierarchy.Ctr.CtrCod,
-                                              Gbl.Hierarchy.Deg.DegCod,
-                                              Gbl.Hierarchy.Crs.CrsCod);
-
-            /***** Show an alert indicating that the message has been sent successfully *****/
-            Ale_ShowAlert (Ale_SUCCESS,NotifyByEmail ? Txt_message_sent_to_X_notified_by_email :
-                                                       Txt_message_sent_to_X_not_notified_by_email,
-                           UsrDstData.FullName);
-
-            /***** Increment number of recipients *****/
-            if (NotifyByEmail)
-               NumRecipientsToBeNotifiedByEMail++;
-            NumRecipients++;
-           }
-        }
+   /***** Check recipients one by one, without querying database *****/
+   NumRecipients = 0;
+   for (NumUsr = 0;
+	NumUsr < NumUsrs;
+	NumUsr++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get recipient's code and name (row[0], row[1], row[2], row[3]) */
+      UsrDstData.UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+      Str_Copy (UsrDstData.FirstName,row[1],
+		Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+      Str_Copy (UsrDstData.Surname1,row[2],
+		Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+      Str_Copy (UsrDstData.Surname2,row[3],
+		Usr_MAX_BYTES_FIRSTNAME_OR_SURNAME);
+      Usr_BuildFullName (&UsrDstData);
+
+      /* Check if recipient has banned me (row[6]) */
+      RecipientHasBannedMe = (row[6][0] == '1');
+
+      if (RecipientHasBannedMe)
+	 /***** Show an alert indicating that the message has not been sent successfully *****/
+	 Ale_ShowAlert (Ale_WARNING,Txt_message_not_sent_to_X,
+			UsrDstData.FullName);
       else
-        {
-         Ale_ShowAlert (Ale_ERROR,Txt_Error_getting_data_from_a_recipient);
-         NumErrors++;
-        }
+	{
+	 /***** If this recipient is the original sender of a message been replied, set Replied to true *****/
+	 if (IsReply &&
+	     UsrDstData.UsrCod == Gbl.Usrs.Other.UsrDat.UsrCod)
+	    Replied = true;
+
+	 /***** Get on which events the recipient wants to be notified (row[4], row[5]) *****/
+	 if (sscanf (row[4],"%u",&CreateNotifMask) != 1)
+	    CreateNotifMask = (unsigned) -1;	// 0xFF..FF
+	 if (sscanf (row[5],"%u",&SendEmailMask) != 1)
+	    SendEmailMask = 0;
+	 if (SendEmailMask >= (1 << Ntf_NUM_NOTIFY_EVENTS))	// Maximum binary value for NotifyEvents is 000...0011...11
+	    SendEmailMask = 0;
+
+	 /***** This received message must be notified by email? *****/
+	 CreateNotif = (CreateNotifMask & (1 << Ntf_EVENT_MESSAGE));
+	 NotifyByEmail = CreateNotif &&
+			 (UsrDstData.UsrCod != Gbl.Usrs.Me.UsrDat.UsrCod) &&
+			 (SendEmailMask & (1 << Ntf_EVENT_MESSAGE));
+
+	 /***** Add this recipient to the list of its type of delivery *****/
+	 Delivery = NotifyByEmail ? Msg_DELIVER_NOTIFY_BY_EMAIL :
+		    (CreateNotif ? Msg_DELIVER_NOTIFY :
+				   Msg_DELIVER_DONT_NOTIFY);
+	 LstUsrCods[Delivery][NumUsrsInLst[Delivery]++] = UsrDstData.UsrCod;
+
+	 /***** Show an alert indicating that the message has been sent successfully *****/
+	 Ale_ShowAlert (Ale_SUCCESS,NotifyByEmail ? Txt_message_sent_to_X_notified_by_email :
+						    Txt_message_sent_to_X_not_notified_by_email,
+			UsrDstData.FullName);
+
+	 /***** Increment number of recipients *****/
+	 if (NotifyByEmail)
+	    NumRecipientsToBeNotifiedByEMail++;
+	 NumRecipients++;
+	}
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   if (NumRecipients)
+     {
+      /***** Create message *****/
+      // The message is inserted only once in the table of messages sent
+      NewMsgCod = Msg_InsertNewMsg (Messages.Subject,Content,&Media);
+
+      /***** Create the received message and the notifications
+             for all the recipients, with a few queries *****/
+      for (Delivery  = (Msg_Delivery_t) 0;
+	   Delivery <= (Msg_Delivery_t) (Msg_NUM_DELIVERIES - 1);
+	   Delivery++)
+	 if (NumUsrsInLst[Delivery])
+	    Msg_InsertReceivedMsgIntoDB (NewMsgCod,Delivery,
+					 LstUsrCods[Delivery],NumUsrsInLst[Delivery]);
      }
 
+   /***** Free lists of recipients *****/
+   for (Delivery  = (Msg_Delivery_t) 0;
+	Delivery <= (Msg_Delivery_t) (Msg_NUM_DELIVERIES - 1);
+	Delivery++)
+      if (LstUsrCods[Delivery])
+	 free (LstUsrCods[Delivery]);
+
    /***** Free image *****/
    Med_MediaDestructor (&Media);
 
@@ -1438,6 +1526,9 @@ static long Msg_InsertNewMsg (const char *Subject,const char *Content,
    /***** Increment number of messages sent by me *****/
    Prf_IncrementNumMsgSntUsr (Gbl.Usrs.Me.UsrDat.UsrCod);
 
+   /***** Indicators about online tutoring must be computed again *****/
+   Ind_SetIndicatorsCrsAsDirty (Gbl.Hierarchy.Crs.CrsCod,Ind_ONLINE_TUTORING);
+
    return MsgCod;
   }
 
@@ -1524,20 +1615,91 @@ void Msg_DelAllRecAndSntMsgsUsr (long UsrCod)
   }
 
 /*****************************************************************************/
-/**** Insert a message y su destinatario in the table of messages received ***/
+/******* Create subquery string with users' encrypted codes in quotes ********/
+/******* separated by commas, from list of users' encrypted codes      ********/
 /*****************************************************************************/
 
-static void Msg_InsertReceivedMsgIntoDB (long MsgCod,long UsrCod,bool NotifyByEmail)
+static void Msg_CreateSubqueryEncryptedUsrCods (const char *ListEncryptedUsrCods,
+					       unsigned NumUsrsInList,
+					       char **SubQueryUsrs)
   {
-   /***** Insert message received in the database *****/
+   const char *Ptr;
+   char EncryptedUsrCod[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1];
+   size_t MaxLength;
+   bool FirstUsr = true;
+
+   /***** Allocate space for subquery *****/
+   MaxLength = NumUsrsInList * (1 + 1 + Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1);
+   if ((*SubQueryUsrs = (char *) malloc (MaxLength + 1)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   (*SubQueryUsrs)[0] = '\0';
+
+   /***** Build subquery *****/
+   Ptr = ListEncryptedUsrCods;
+   while (*Ptr)
+     {
+      Par_GetNextStrUntilSeparParamMult (&Ptr,EncryptedUsrCod,
+                                         Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64);
+      if (EncryptedUsrCod[0])
+	{
+	 if (!FirstUsr)
+	    Str_Concat (*SubQueryUsrs,",",
+			MaxLength);
+	 Str_Concat (*SubQueryUsrs,"'",
+		     MaxLength);
+	 Str_Concat (*SubQueryUsrs,EncryptedUsrCod,
+		     MaxLength);
+	 Str_Concat (*SubQueryUsrs,"'",
+		     MaxLength);
+	 FirstUsr = false;
+	}
+     }
+
+   /***** Empty list? *****/
+   if (FirstUsr)	// No users' codes in list
+      Str_Copy (*SubQueryUsrs,"''",
+                MaxLength);
+  }
+
+/*****************************************************************************/
+/****** Insert a message and a list of its recipients in the table of ********/
+/****** messages received, and notify the recipients if they want     ********/
+/*****************************************************************************/
+
+static void Msg_InsertReceivedMsgIntoDB (long MsgCod,Msg_Delivery_t Delivery,
+                                         long LstUsrCods[],unsigned NumUsrsInList)
+  {
+   char *SubQueryUsrs;
+
+   /***** Create subquery with recipients' codes *****/
+   Usr_CreateSubqueryUsrCods (LstUsrCods,NumUsrsInList,&SubQueryUsrs);
+
+   /***** Insert message received in the database for all the recipients *****/
    DB_QueryINSERT ("can not create received message",
 		   "INSERT INTO msg_rcv"
 		   " (MsgCod,UsrCod,Notified,Open,Replied,Expanded)"
-		   " VALUES"
-		   " (%ld,%ld,'%c','N','N','N')",
-	           MsgCod,UsrCod,
-	           NotifyByEmail ? 'Y' :
-			           'N');
+		   " SELECT %ld,UsrCod,'%c','N','N','N'"
+		   " FROM usr_data"
+		   " WHERE UsrCod IN (%s)",
+	           MsgCod,
+	           Delivery == Msg_DELIVER_NOTIFY_BY_EMAIL ? 'Y' :
+			                                     'N',
+	           SubQueryUsrs);
+
+   /***** Create notification for all the recipients.
+          If they want to receive notifications by email,
+          activate the sending of a notification *****/
+   if (Delivery != Msg_DELIVER_DONT_NOTIFY)
+      Ntf_StoreNotifyEventToUsrsInList (Ntf_EVENT_MESSAGE,SubQueryUsrs,MsgCod,
+                                        (Ntf_Status_t) (Delivery == Msg_DELIVER_NOTIFY_BY_EMAIL ? Ntf_STATUS_BIT_EMAIL :
+                                        	                                                  0),
+                                        Gbl.Hierarchy.Ins.InsCod,
+                                        Gbl.Hierarchy.Ctr.CtrCod,
+                                        Gbl.Hierarchy.Deg.DegCod,
+                                        Gbl.Hierarchy.Crs.CrsCod);
+
+   /***** Free subquery *****/
+   Usr_FreeSubqueryUsrCods (SubQueryUsrs);
   }
 
 /*****************************************************************************/
@@ -30,6 +30,7 @@
 #include "swad_box.h"
 #include "swad_database.h"
 #include "swad_figure.h"
+#include "swad_figure_snapshot.h"
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
@@ -463,87 +464,87 @@ void Net_ShowWebAndSocialNetworksStats (void)
      {
       case Hie_SYS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT Web,COUNT(*) AS N"
-				    " FROM usr_webs"
-				    " GROUP BY Web"
-				    " ORDER BY N DESC,Web");
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT Web,COUNT(*) AS N"
+					" FROM usr_webs"
+					" GROUP BY Web"
+					" ORDER BY N DESC,Web");
          break;
       case Hie_CTY:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT usr_webs.Web,"
-				    "COUNT(DISTINCT usr_webs.UsrCod) AS N"
-				    " FROM institutions,centres,degrees,courses,crs_usr,usr_webs"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_webs.UsrCod"
-				    " GROUP BY usr_webs.Web"
-				    " ORDER BY N DESC,usr_webs.Web",
-				    Gbl.Hierarchy.Cty.CtyCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT usr_webs.Web,"
+					"COUNT(DISTINCT usr_webs.UsrCod) AS N"
+					" FROM institutions,centres,degrees,courses,crs_usr,usr_webs"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_webs.UsrCod"
+					" GROUP BY usr_webs.Web"
+					" ORDER BY N DESC,usr_webs.Web",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT usr_webs.Web,"
-				    "COUNT(DISTINCT usr_webs.UsrCod) AS N"
-				    " FROM centres,degrees,courses,crs_usr,usr_webs"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_webs.UsrCod"
-				    " GROUP BY usr_webs.Web"
-				    " ORDER BY N DESC,usr_webs.Web",
-				    Gbl.Hierarchy.Ins.InsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT usr_webs.Web,"
+					"COUNT(DISTINCT usr_webs.UsrCod) AS N"
+					" FROM centres,degrees,courses,crs_usr,usr_webs"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_webs.UsrCod"
+					" GROUP BY usr_webs.Web"
+					" ORDER BY N DESC,usr_webs.Web",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       case Hie_CTR:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT usr_webs.Web,"
-				    "COUNT(DISTINCT usr_webs.UsrCod) AS N"
-				    " FROM degrees,courses,crs_usr,usr_webs"
-				    " WHERE degrees.CtrCod=%ld"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_webs.UsrCod"
-				    " GROUP BY usr_webs.Web"
-				    " ORDER BY N DESC,usr_webs.Web",
-				    Gbl.Hierarchy.Ctr.CtrCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT usr_webs.Web,"
+					"COUNT(DISTINCT usr_webs.UsrCod) AS N"
+					" FROM degrees,courses,crs_usr,usr_webs"
+					" WHERE degrees.CtrCod=%ld"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_webs.UsrCod"
+					" GROUP BY usr_webs.Web"
+					" ORDER BY N DESC,usr_webs.Web",
+					Gbl.Hierarchy.Ctr.CtrCod);
          break;
       case Hie_DEG:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT usr_webs.Web,"
-				    "COUNT(DISTINCT usr_webs.UsrCod) AS N"
-				    " FROM courses,crs_usr,usr_webs"
-				    " WHERE courses.DegCod=%ld"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_webs.UsrCod"
-				    " GROUP BY usr_webs.Web"
-				    " ORDER BY N DESC,usr_webs.Web",
-				    Gbl.Hierarchy.Deg.DegCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT usr_webs.Web,"
+					"COUNT(DISTINCT usr_webs.UsrCod) AS N"
+					" FROM courses,crs_usr,usr_webs"
+					" WHERE courses.DegCod=%ld"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_webs.UsrCod"
+					" GROUP BY usr_webs.Web"
+					" ORDER BY N DESC,usr_webs.Web",
+					Gbl.Hierarchy.Deg.DegCod);
          break;
       case Hie_CRS:
          NumRows =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get number of users"
-					       " with webs / social networks",
-				    "SELECT usr_webs.Web,"
-				    "COUNT(DISTINCT usr_webs.UsrCod) AS N"
-				    " FROM crs_usr,usr_webs"
-				    " WHERE crs_usr.CrsCod=%ld"
-				    " AND crs_usr.UsrCod=usr_webs.UsrCod"
-				    " GROUP BY usr_webs.Web"
-				    " ORDER BY N DESC,usr_webs.Web",
-				    Gbl.Hierarchy.Crs.CrsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get number of users"
+						   " with webs / social networks",
+					"SELECT usr_webs.Web,"
+					"COUNT(DISTINCT usr_webs.UsrCod) AS N"
+					" FROM crs_usr,usr_webs"
+					" WHERE crs_usr.CrsCod=%ld"
+					" AND crs_usr.UsrCod=usr_webs.UsrCod"
+					" GROUP BY usr_webs.Web"
+					" ORDER BY N DESC,usr_webs.Web",
+					Gbl.Hierarchy.Crs.CrsCod);
          break;
       default:
 	 Lay_WrongScopeExit ();
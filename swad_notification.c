@@ -26,10 +26,8 @@
 /*****************************************************************************/
 
 #include <stddef.h>		// For NULL
-#include <stdlib.h>		// For system
+#include <stdlib.h>		// For free
 #include <string.h>
-#include <sys/wait.h>		// For the macro WEXITSTATUS
-#include <unistd.h>		// For unlink
 
 #include "swad_action.h"
 #include "swad_box.h"
@@ -275,6 +273,10 @@ static bool Ntf_StartFormGoToAction (Ntf_NotifyEvent_t NotifyEvent,
                                      const struct For_Forums *Forums);
 static void Ntf_PutHiddenParamNotifyEvent (Ntf_NotifyEvent_t NotifyEvent);
 
+static unsigned Ntf_StoreNotifyEventToUsrsInSubQuery (Ntf_NotifyEvent_t NotifyEvent,
+						      const char *SubQuery,long Cod,
+						      long InsCod,long CtrCod,long DegCod,long CrsCod);
+
 static void Ntf_UpdateMyLastAccessToNotifications (void);
 static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsigned *NumNotif,unsigned *NumMails);
 static void Ntf_GetNumNotifSent (long DegCod,long CrsCod,
@@ -1141,27 +1143,25 @@ void Ntf_MarkNotifFilesInGroupAsRemoved (long GrpCod)
   }
 
 /*****************************************************************************/
-/********** Get a list with user's codes of all users to be notified *********/
-/********** about an event, and notify them                          *********/
+/************* Notify an event to all the users to be notified ***************/
 /*****************************************************************************/
+// Recipients are selected and notified in database with a few queries,
+// instead of getting and checking each user one by one.
+// Ntf_StoreNotifyEventToOneUser is used only for events notified to one user.
 // Return the number of users notified by email
 
 unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
   {
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumRow;
-   unsigned long NumRows = 0;	// Initialized to avoid warning
-   struct UsrData UsrDat;
+   char *SubQuery = NULL;
    struct For_Forum ForumSelected;
    long InsCod;
    long CtrCod;
    long DegCod;
    long CrsCod;
-   unsigned NumUsrsToBeNotifiedByEMail = 0;
-   unsigned NotifyEventMask = (1 << NotifyEvent);
+   unsigned NumUsrsToBeNotifiedByEMail;
 
-   /***** Get users who want to be notified from database ******/
+   /***** Build subquery to get users to be notified ******/
+   // The subquery must return a column UsrCod with the users to be notified
    switch (NotifyEvent)
      {
       case Ntf_EVENT_UNKNOWN:	// This function should not be called in this case
@@ -1175,50 +1175,46 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
             case Brw_ADMI_DOC_CRS:
             case Brw_ADMI_SHR_CRS:
             case Brw_ADMI_MRK_CRS:	// Notify all users in course except me
-               NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-					 "SELECT UsrCod FROM crs_usr"
-					 " WHERE CrsCod=%ld"
-					 " AND UsrCod<>%ld",
-					 Gbl.Hierarchy.Crs.CrsCod,
-					 Gbl.Usrs.Me.UsrDat.UsrCod);
+               DB_BuildQuery (&SubQuery,
+			      "SELECT UsrCod FROM crs_usr"
+			      " WHERE CrsCod=%ld"
+			      " AND UsrCod<>%ld",
+			      Gbl.Hierarchy.Crs.CrsCod,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
                break;
             case Brw_ADMI_TCH_CRS:	// Notify all teachers in course except me
-               NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-					 "SELECT UsrCod FROM crs_usr"
-					 " WHERE CrsCod=%ld"
-					 " AND UsrCod<>%ld"
-					 " AND Role=%u",	// Notify teachers only
-					 Gbl.Hierarchy.Crs.CrsCod,
-					 Gbl.Usrs.Me.UsrDat.UsrCod,
-					 (unsigned) Rol_TCH);
+               DB_BuildQuery (&SubQuery,
+			      "SELECT UsrCod FROM crs_usr"
+			      " WHERE CrsCod=%ld"
+			      " AND UsrCod<>%ld"
+			      " AND Role=%u",	// Notify teachers only
+			      Gbl.Hierarchy.Crs.CrsCod,
+			      Gbl.Usrs.Me.UsrDat.UsrCod,
+			      (unsigned) Rol_TCH);
                break;
             case Brw_ADMI_DOC_GRP:
             case Brw_ADMI_SHR_GRP:
             case Brw_ADMI_MRK_GRP:	// Notify all users in group except me
-               NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-					 "SELECT UsrCod FROM crs_grp_usr"
-					 " WHERE crs_grp_usr.GrpCod=%ld"
-					 " AND crs_grp_usr.UsrCod<>%ld",
-					 Gbl.Crs.Grps.GrpCod,
-					 Gbl.Usrs.Me.UsrDat.UsrCod);
+               DB_BuildQuery (&SubQuery,
+			      "SELECT UsrCod FROM crs_grp_usr"
+			      " WHERE crs_grp_usr.GrpCod=%ld"
+			      " AND crs_grp_usr.UsrCod<>%ld",
+			      Gbl.Crs.Grps.GrpCod,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
                break;
             case Brw_ADMI_TCH_GRP:	// Notify all teachers in group except me
-               NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				         "SELECT crs_grp_usr.UsrCod"
-					 " FROM crs_grp_usr,crs_grp,crs_grp_types,crs_usr"
-					 " WHERE crs_grp_usr.GrpCod=%ld"
-					 " AND crs_grp_usr.UsrCod<>%ld"
-					 " AND crs_grp_usr.GrpCod=crs_grp.GrpCod"
-					 " AND crs_grp.GrpTypCod=crs_grp_types.GrpTypCod"
-					 " AND crs_grp_types.CrsCod=crs_usr.CrsCod"
-					 " AND crs_usr.Role=%u",	// Notify teachers only
-					 Gbl.Crs.Grps.GrpCod,
-					 Gbl.Usrs.Me.UsrDat.UsrCod,
-					 (unsigned) Rol_TCH);
+               DB_BuildQuery (&SubQuery,
+			      "SELECT crs_grp_usr.UsrCod"
+			      " FROM crs_grp_usr,crs_grp,crs_grp_types,crs_usr"
+			      " WHERE crs_grp_usr.GrpCod=%ld"
+			      " AND crs_grp_usr.UsrCod<>%ld"
+			      " AND crs_grp_usr.GrpCod=crs_grp.GrpCod"
+			      " AND crs_grp.GrpTypCod=crs_grp_types.GrpTypCod"
+			      " AND crs_grp_types.CrsCod=crs_usr.CrsCod"
+			      " AND crs_usr.Role=%u",	// Notify teachers only
+			      Gbl.Crs.Grps.GrpCod,
+			      Gbl.Usrs.Me.UsrDat.UsrCod,
+			      (unsigned) Rol_TCH);
                break;
             default:	// This function should not be called in other cases
                return 0;
@@ -1228,32 +1224,30 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
          // 1. If the assignment is available for the whole course ==> get all users enroled in the course except me
          // 2. If the assignment is available only for some groups ==> get all users who belong to any of the groups except me
          // Cases 1 and 2 are mutually exclusive, so the union returns the case 1 or 2
-         NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				   "(SELECT crs_usr.UsrCod"
-				   " FROM assignments,crs_usr"
-				   " WHERE assignments.AsgCod=%ld"
-				   " AND assignments.AsgCod NOT IN"
-				   " (SELECT AsgCod FROM asg_grp WHERE AsgCod=%ld)"
-				   " AND assignments.CrsCod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod<>%ld)"
-				   " UNION "
-				   "(SELECT DISTINCT crs_grp_usr.UsrCod"
-				   " FROM asg_grp,crs_grp_usr"
-				   " WHERE asg_grp.AsgCod=%ld"
-				   " AND asg_grp.GrpCod=crs_grp_usr.GrpCod"
-				   " AND crs_grp_usr.UsrCod<>%ld)",
-				   Cod,Cod,Gbl.Usrs.Me.UsrDat.UsrCod,
-				   Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
+         DB_BuildQuery (&SubQuery,
+			"(SELECT crs_usr.UsrCod"
+			" FROM assignments,crs_usr"
+			" WHERE assignments.AsgCod=%ld"
+			" AND assignments.AsgCod NOT IN"
+			" (SELECT AsgCod FROM asg_grp WHERE AsgCod=%ld)"
+			" AND assignments.CrsCod=crs_usr.CrsCod"
+			" AND crs_usr.UsrCod<>%ld)"
+			" UNION "
+			"(SELECT DISTINCT crs_grp_usr.UsrCod"
+			" FROM asg_grp,crs_grp_usr"
+			" WHERE asg_grp.AsgCod=%ld"
+			" AND asg_grp.GrpCod=crs_grp_usr.GrpCod"
+			" AND crs_grp_usr.UsrCod<>%ld)",
+			Cod,Cod,Gbl.Usrs.Me.UsrDat.UsrCod,
+			Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
          break;
       case Ntf_EVENT_EXAM_ANNOUNCEMENT:
       case Ntf_EVENT_NOTICE:
-         NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				   "SELECT UsrCod FROM crs_usr"
-				   " WHERE CrsCod=%ld AND UsrCod<>%ld",
-				   Gbl.Hierarchy.Crs.CrsCod,
-				   Gbl.Usrs.Me.UsrDat.UsrCod);
+         DB_BuildQuery (&SubQuery,
+			"SELECT UsrCod FROM crs_usr"
+			" WHERE CrsCod=%ld AND UsrCod<>%ld",
+			Gbl.Hierarchy.Crs.CrsCod,
+			Gbl.Usrs.Me.UsrDat.UsrCod);
          break;
       case Ntf_EVENT_ENROLMENT_STD:	// This function should not be called in this case
       case Ntf_EVENT_ENROLMENT_NET:	// This function should not be called in this case
@@ -1263,44 +1257,41 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
 	 if (Usr_GetNumUsrsInCrss (Hie_CRS,Gbl.Hierarchy.Crs.CrsCod,
 				   1 << Rol_TCH))
 	    // If this course has teachers ==> send notification to teachers
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					         " to be notified",
-				      "SELECT UsrCod FROM crs_usr"
-				      " WHERE CrsCod=%ld"
-				      " AND UsrCod<>%ld"
-				      " AND Role=%u",	// Notify teachers only
-				      Gbl.Hierarchy.Crs.CrsCod,
-				      Gbl.Usrs.Me.UsrDat.UsrCod,
-				      (unsigned) Rol_TCH);
+	    DB_BuildQuery (&SubQuery,
+			   "SELECT UsrCod FROM crs_usr"
+			   " WHERE CrsCod=%ld"
+			   " AND UsrCod<>%ld"
+			   " AND Role=%u",	// Notify teachers only
+			   Gbl.Hierarchy.Crs.CrsCod,
+			   Gbl.Usrs.Me.UsrDat.UsrCod,
+			   (unsigned) Rol_TCH);
 	 else	// Course without teachers
 	    // If this course has no teachers
 	    // and I want to be a teacher (checked before calling this function
 	    // to not send requests to be a student to admins)
 	    // ==> send notification to administrators or superusers
-	    NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					         " to be notified",
-				      "SELECT UsrCod FROM admin"
-				      " WHERE (Scope='%s'"
-				      " OR (Scope='%s' AND Cod=%ld)"
-				      " OR (Scope='%s' AND Cod=%ld)"
-				      " OR (Scope='%s' AND Cod=%ld))"
-				      " AND UsrCod<>%ld",
-				      Sco_GetDBStrFromScope (Hie_SYS),
-				      Sco_GetDBStrFromScope (Hie_INS),Gbl.Hierarchy.Ins.InsCod,
-				      Sco_GetDBStrFromScope (Hie_CTR),Gbl.Hierarchy.Ctr.CtrCod,
-				      Sco_GetDBStrFromScope (Hie_DEG),Gbl.Hierarchy.Deg.DegCod,
-				      Gbl.Usrs.Me.UsrDat.UsrCod);
+	    DB_BuildQuery (&SubQuery,
+			   "SELECT UsrCod FROM admin"
+			   " WHERE (Scope='%s'"
+			   " OR (Scope='%s' AND Cod=%ld)"
+			   " OR (Scope='%s' AND Cod=%ld)"
+			   " OR (Scope='%s' AND Cod=%ld))"
+			   " AND UsrCod<>%ld",
+			   Sco_GetDBStrFromScope (Hie_SYS),
+			   Sco_GetDBStrFromScope (Hie_INS),Gbl.Hierarchy.Ins.InsCod,
+			   Sco_GetDBStrFromScope (Hie_CTR),Gbl.Hierarchy.Ctr.CtrCod,
+			   Sco_GetDBStrFromScope (Hie_DEG),Gbl.Hierarchy.Deg.DegCod,
+			   Gbl.Usrs.Me.UsrDat.UsrCod);
          break;
       case Ntf_EVENT_TIMELINE_COMMENT:	// New comment to one of my social notes or comments
          // Cod is the code of the social publishing
-	 NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				   "SELECT DISTINCT(PublisherCod) FROM tl_pubs"
-				   " WHERE NotCod="
-				   "(SELECT NotCod FROM tl_pubs"
-				   " WHERE PubCod=%ld)"
-				   " AND PublisherCod<>%ld",
-				   Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
+	 DB_BuildQuery (&SubQuery,
+			"SELECT DISTINCT(PublisherCod) AS UsrCod FROM tl_pubs"
+			" WHERE NotCod="
+			"(SELECT NotCod FROM tl_pubs"
+			" WHERE PubCod=%ld)"
+			" AND PublisherCod<>%ld",
+			Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
          break;
       case Ntf_EVENT_TIMELINE_FAV:		// New favourite to one of my social notes or comments
       case Ntf_EVENT_TIMELINE_SHARE:		// New sharing of one of my social notes
@@ -1315,34 +1306,34 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
 	 switch (ForumSelected.Type)
 	   {
 	    case For_FORUM_COURSE_USRS:
-	       NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					            " to be notified",
-					 "SELECT UsrCod FROM crs_usr"
-					 " WHERE CrsCod=%ld AND UsrCod<>%ld",
-					 Gbl.Hierarchy.Crs.CrsCod,
-					 Gbl.Usrs.Me.UsrDat.UsrCod);
+	       DB_BuildQuery (&SubQuery,
+			      "SELECT UsrCod FROM crs_usr"
+			      " WHERE CrsCod=%ld AND UsrCod<>%ld",
+			      Gbl.Hierarchy.Crs.CrsCod,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
 	       break;
 	    case For_FORUM_COURSE_TCHS:
-	       NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					            " to be notified",
-					 "SELECT UsrCod FROM crs_usr"
-					 " WHERE CrsCod=%ld AND Role=%u AND UsrCod<>%ld",
-					 Gbl.Hierarchy.Crs.CrsCod,
-					 (unsigned) Rol_TCH,
-					 Gbl.Usrs.Me.UsrDat.UsrCod);
+	       DB_BuildQuery (&SubQuery,
+			      "SELECT UsrCod FROM crs_usr"
+			      " WHERE CrsCod=%ld AND Role=%u AND UsrCod<>%ld",
+			      Gbl.Hierarchy.Crs.CrsCod,
+			      (unsigned) Rol_TCH,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
 	       break;
 	    default:
 	       return 0;
 	   }
          break;
       case Ntf_EVENT_FORUM_REPLY:
-         NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				   "SELECT DISTINCT(UsrCod) FROM forum_post"
-				   " WHERE ThrCod = (SELECT ThrCod FROM forum_post"
-				   " WHERE PstCod=%ld)"
-				   " AND UsrCod<>%ld",
-				   Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
+	 // Get forum type and location, used below
+	 For_GetForumTypeAndLocationOfAPost (Cod,&ForumSelected);
+
+         DB_BuildQuery (&SubQuery,
+			"SELECT DISTINCT(UsrCod) AS UsrCod FROM forum_post"
+			" WHERE ThrCod = (SELECT ThrCod FROM forum_post"
+			" WHERE PstCod=%ld)"
+			" AND UsrCod<>%ld",
+			Cod,Gbl.Usrs.Me.UsrDat.UsrCod);
          break;
       case Ntf_EVENT_MESSAGE:		// This function should not be called in this case
 	 return 0;
@@ -1350,36 +1341,38 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
          // 1. If the survey is available for the whole course ==> get users enroled in the course whose role is available in survey, except me
          // 2. If the survey is available only for some groups ==> get users who belong to any of the groups and whose role is available in survey, except me
          // Cases 1 and 2 are mutually exclusive, so the union returns the case 1 or 2
-         NumRows = DB_QuerySELECT (&mysql_res,"can not get users"
-					      " to be notified",
-				   "(SELECT crs_usr.UsrCod"
-				   " FROM surveys,crs_usr"
-				   " WHERE surveys.SvyCod=%ld"
-				   " AND surveys.SvyCod NOT IN"
-				   " (SELECT SvyCod FROM svy_grp WHERE SvyCod=%ld)"
-				   " AND surveys.Scope='%s' AND surveys.Cod=crs_usr.CrsCod"
-				   " AND crs_usr.UsrCod<>%ld"
-				   " AND (surveys.Roles&(1<<crs_usr.Role))<>0)"
-				   " UNION "
-				   "(SELECT DISTINCT crs_grp_usr.UsrCod"
-				   " FROM svy_grp,crs_grp_usr,surveys,crs_usr"
-				   " WHERE svy_grp.SvyCod=%ld"
-				   " AND svy_grp.GrpCod=crs_grp_usr.GrpCod"
-				   " AND crs_grp_usr.UsrCod=crs_usr.UsrCod"
-				   " AND crs_grp_usr.UsrCod<>%ld"
-				   " AND svy_grp.SvyCod=surveys.SvyCod"
-				   " AND surveys.Scope='%s' AND surveys.Cod=crs_usr.CrsCod"
-				   " AND (surveys.Roles&(1<<crs_usr.Role))<>0)",
-				   Cod,
-				   Cod,
-				   Sco_GetDBStrFromScope (Hie_CRS),
-				   Gbl.Usrs.Me.UsrDat.UsrCod,
-				   Cod,
-				   Gbl.Usrs.Me.UsrDat.UsrCod,
-				   Sco_GetDBStrFromScope (Hie_CRS));
+         DB_BuildQuery (&SubQuery,
+			"(SELECT crs_usr.UsrCod"
+			" FROM surveys,crs_usr"
+			" WHERE surveys.SvyCod=%ld"
+			" AND surveys.SvyCod NOT IN"
+			" (SELECT SvyCod FROM svy_grp WHERE SvyCod=%ld)"
+			" AND surveys.Scope='%s' AND surveys.Cod=crs_usr.CrsCod"
+			" AND crs_usr.UsrCod<>%ld"
+			" AND (surveys.Roles&(1<<crs_usr.Role))<>0)"
+			" UNION "
+			"(SELECT DISTINCT crs_grp_usr.UsrCod"
+			" FROM svy_grp,crs_grp_usr,surveys,crs_usr"
+			" WHERE svy_grp.SvyCod=%ld"
+			" AND svy_grp.GrpCod=crs_grp_usr.GrpCod"
+			" AND crs_grp_usr.UsrCod=crs_usr.UsrCod"
+			" AND crs_grp_usr.UsrCod<>%ld"
+			" AND svy_grp.SvyCod=surveys.SvyCod"
+			" AND surveys.Scope='%s' AND surveys.Cod=crs_usr.CrsCod"
+			" AND (surveys.Roles&(1<<crs_usr.Role))<>0)",
+			Cod,
+			Cod,
+			Sco_GetDBStrFromScope (Hie_CRS),
+			Gbl.Usrs.Me.UsrDat.UsrCod,
+			Cod,
+			Gbl.Usrs.Me.UsrDat.UsrCod,
+			Sco_GetDBStrFromScope (Hie_CRS));
          break;
      }
 
+   if (SubQuery == NULL)
+      return 0;
+
    if (NotifyEvent == Ntf_EVENT_FORUM_POST_COURSE ||
        NotifyEvent == Ntf_EVENT_FORUM_REPLY)
      {
@@ -1414,44 +1407,69 @@ unsigned Ntf_StoreNotifyEventsToAllUsrs (Ntf_NotifyEvent_t NotifyEvent,long Cod)
       CrsCod = Gbl.Hierarchy.Crs.CrsCod;
      }
 
-   if (NumRows) // Users found
-     {
-      /***** Initialize structure with user's data *****/
-      Usr_UsrDataConstructor (&UsrDat);
+   /***** Notify all the users at once *****/
+   NumUsrsToBeNotifiedByEMail = Ntf_StoreNotifyEventToUsrsInSubQuery (NotifyEvent,SubQuery,Cod,
+								      InsCod,CtrCod,DegCod,CrsCod);
 
-      /***** Notify the users one by one *****/
-      for (NumRow = 0;
-	   NumRow < NumRows;
-	   NumRow++)
-	{
-         /* Get next user */
-         row = mysql_fetch_row (mysql_res);
+   /***** Free subquery *****/
+   free (SubQuery);
 
-         /* Get user code */
-         UsrDat.UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+   return NumUsrsToBeNotifiedByEMail;
+  }
 
-	 if (Usr_ChkUsrCodAndGetAllUsrDataFromUsrCod (&UsrDat,Usr_DONT_GET_PREFS))		// Get user's data from the database
-            if ((UsrDat.NtfEvents.CreateNotif & NotifyEventMask))	// Create notification
-              {
-	       if ((UsrDat.NtfEvents.SendEmail & NotifyEventMask))	// Send notification by email
-		 {
-		  Ntf_StoreNotifyEventToOneUser (NotifyEvent,&UsrDat,Cod,
-						 (Ntf_Status_t) Ntf_STATUS_BIT_EMAIL,
-						 InsCod,CtrCod,DegCod,CrsCod);
-		  NumUsrsToBeNotifiedByEMail++;
-		 }
-	       else							// Don't send notification by email
-		  Ntf_StoreNotifyEventToOneUser (NotifyEvent,&UsrDat,Cod,(Ntf_Status_t) 0,
-						 InsCod,CtrCod,DegCod,CrsCod);
-              }
-        }
+/*****************************************************************************/
+/******* Store a notify event to the users returned by a subquery ************/
+/*****************************************************************************/
+// Only users who want to be notified about this event are notified.
+// Return the number of users to be notified by email
 
-      /***** Free memory used for user's data *****/
-      Usr_UsrDataDestructor (&UsrDat);
-     }
+static unsigned Ntf_StoreNotifyEventToUsrsInSubQuery (Ntf_NotifyEvent_t NotifyEvent,
+						      const char *SubQuery,long Cod,
+						      long InsCod,long CtrCod,long DegCod,long CrsCod)
+  {
+   unsigned NotifyEventMask = (1 << NotifyEvent);
+   unsigned NumUsrsToBeNotifiedByEMail;
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Store notify event for users who want to be notified by email *****/
+   DB_QueryINSERT ("can not create new notification events",
+		   "INSERT INTO notif"
+		   " (NotifyEvent,ToUsrCod,FromUsrCod,"
+		   "InsCod,CtrCod,DegCod,CrsCod,Cod,TimeNotif,Status)"
+		   " SELECT %u,usr_data.UsrCod,%ld,"
+		   "%ld,%ld,%ld,%ld,%ld,NOW(),%u"
+		   " FROM (%s) AS ntf_usrs,usr_data"
+		   " WHERE ntf_usrs.UsrCod=usr_data.UsrCod"
+		   " AND (usr_data.NotifNtfEvents & %u)<>0"	// Create notification
+		   " AND (usr_data.EmailNtfEvents & %u)<>0"	// Send notification by email
+		   " AND usr_data.EmailNtfEvents<%u",		// Maximum binary value for NotifyEvents is 000...0011...11
+	           (unsigned) NotifyEvent,Gbl.Usrs.Me.UsrDat.UsrCod,
+	           InsCod,CtrCod,DegCod,CrsCod,Cod,
+	           (unsigned) Ntf_STATUS_BIT_EMAIL,
+	           SubQuery,
+	           NotifyEventMask,
+	           NotifyEventMask,
+	           (unsigned) (1 << Ntf_NUM_NOTIFY_EVENTS));
+   NumUsrsToBeNotifiedByEMail = (unsigned) mysql_affected_rows (&Gbl.mysql);
+
+   /***** Store notify event for the rest of users
+          who want to be notified, but not by email *****/
+   DB_QueryINSERT ("can not create new notification events",
+		   "INSERT INTO notif"
+		   " (NotifyEvent,ToUsrCod,FromUsrCod,"
+		   "InsCod,CtrCod,DegCod,CrsCod,Cod,TimeNotif,Status)"
+		   " SELECT %u,usr_data.UsrCod,%ld,"
+		   "%ld,%ld,%ld,%ld,%ld,NOW(),0"
+		   " FROM (%s) AS ntf_usrs,usr_data"
+		   " WHERE ntf_usrs.UsrCod=usr_data.UsrCod"
+		   " AND (usr_data.NotifNtfEvents & %u)<>0"	// Create notification
+		   " AND ((usr_data.EmailNtfEvents & %u)=0"	// Don't send notification by email
+		   " OR usr_data.EmailNtfEvents>=%u)",
+	           (unsigned) NotifyEvent,Gbl.Usrs.Me.UsrDat.UsrCod,
+	           InsCod,CtrCod,DegCod,CrsCod,Cod,
+	           SubQuery,
+	           NotifyEventMask,
+	           NotifyEventMask,
+	           (unsigned) (1 << Ntf_NUM_NOTIFY_EVENTS));
 
    return NumUsrsToBeNotifiedByEMail;
   }
@@ -1478,6 +1496,30 @@ void Ntf_StoreNotifyEventToOneUser (Ntf_NotifyEvent_t NotifyEvent,
 	           InsCod,CtrCod,DegCod,CrsCod,Cod,(unsigned) Status);
   }
 
+/*****************************************************************************/
+/********** Store a notify event to a list of users into database ************/
+/*****************************************************************************/
+// SubQueryUsrs holds users' codes separated by commas
+
+void Ntf_StoreNotifyEventToUsrsInList (Ntf_NotifyEvent_t NotifyEvent,
+                                       const char *SubQueryUsrs,
+                                       long Cod,Ntf_Status_t Status,
+                                       long InsCod,long CtrCod,long DegCod,long CrsCod)
+  {
+   /***** Store notify event for all the users in list *****/
+   DB_QueryINSERT ("can not create new notification events",
+		   "INSERT INTO notif"
+		   " (NotifyEvent,ToUsrCod,FromUsrCod,"
+		   "InsCod,CtrCod,DegCod,CrsCod,Cod,TimeNotif,Status)"
+		   " SELECT %u,UsrCod,%ld,"
+		   "%ld,%ld,%ld,%ld,%ld,NOW(),%u"
+		   " FROM usr_data"
+		   " WHERE UsrCod IN (%s)",
+	           (unsigned) NotifyEvent,Gbl.Usrs.Me.UsrDat.UsrCod,
+	           InsCod,CtrCod,DegCod,CrsCod,Cod,(unsigned) Status,
+	           SubQueryUsrs);
+  }
+
 /*****************************************************************************/
 /*************** Reset my number of new notifications to 0 *******************/
 /*****************************************************************************/
@@ -1517,7 +1559,9 @@ void Ntf_SendPendingNotifByEMailToAllUsrs (void)
 				  " WHERE TimeNotif<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)"
 				  " AND (Status & %u)<>0"
 				  " AND (Status & %u)=0"
-				  " AND (Status & %u)=0",
+				  " AND (Status & %u)=0"
+				  " AND ToUsrCod NOT IN"
+				  " (SELECT ToUsrCod FROM mail_outbox)",	// Not yet in outbox
 				  Cfg_TIME_TO_SEND_PENDING_NOTIF,
 				  (unsigned) Ntf_STATUS_BIT_EMAIL,
 				  (unsigned) Ntf_STATUS_BIT_SENT,
@@ -1554,6 +1598,10 @@ void Ntf_SendPendingNotifByEMailToAllUsrs (void)
    /***** Free structure that stores the query result *****/
    DB_FreeMySQLResult (&mysql_res);
 
+   /***** Send emails in outbox, including the ones just queued
+          and the ones to be retried *****/
+   Mai_SendQueuedMails ();
+
    /***** Delete old notifications ******/
    DB_QueryDELETE ("can not remove old notifications",
 		   "DELETE LOW_PRIORITY FROM notif"
@@ -1593,11 +1641,9 @@ static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsign
    char ForumName[For_MAX_BYTES_FORUM_NAME + 1];
    char FileNameMail[PATH_MAX + 1];
    FILE *FileMail;
-   char Command[2048 +
-		Cfg_MAX_BYTES_SMTP_PASSWORD +
-		Cns_MAX_BYTES_EMAIL_ADDRESS +
-		PATH_MAX]; // Command to execute for sending an email
-   int ReturnCode;
+   char Subject[Mai_MAX_BYTES_SUBJECT + 1];
+   long NtfCod;
+   long MaxNtfCod = -1L;
 
    /***** Return 0 notifications and 0 mails when error *****/
    *NumNotif = *NumMails = 0;
@@ -1613,7 +1659,8 @@ static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsign
 				       "CtrCod,"
 				       "DegCod,"
 				       "CrsCod,"
-				       "Cod"
+				       "Cod,"
+				       "NtfCod"
 				" FROM notif WHERE ToUsrCod=%ld"
 				" AND (Status & %u)<>0"
 				" AND (Status & %u)=0"
@@ -1681,6 +1728,10 @@ static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsign
 	    /* Get message/post/... code (row[6]) */
 	    Cod = Str_ConvertStrCodToLongCod (row[6]);
 
+	    /* Get notification code (row[7]) */
+	    if ((NtfCod = Str_ConvertStrCodToLongCod (row[7])) > MaxNtfCod)
+	       MaxNtfCod = NtfCod;
+
 	    /* Get forum type */
 	    if (NotifyEvent == Ntf_EVENT_FORUM_POST_COURSE ||
 		NotifyEvent == Ntf_EVENT_FORUM_REPLY)
@@ -1753,45 +1804,20 @@ static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsign
 
 	 fclose (FileMail);
 
-	 /***** Call the command to send an email *****/
-	 snprintf (Command,sizeof (Command),
-	           "%s \"%s\" \"%s\" \"%s\" \"%s\" \"%s\" \"[%s] %s\" \"%s\"",
-		   Cfg_COMMAND_SEND_AUTOMATIC_EMAIL,
-		   Cfg_AUTOMATIC_EMAIL_SMTP_SERVER,
-		   Cfg_AUTOMATIC_EMAIL_SMTP_PORT,
-		   Cfg_AUTOMATIC_EMAIL_FROM,
-		   Gbl.Config.SMTPPassword,
-		   ToUsrDat->Email,
+	 /***** Put the email into outbox.
+		It will be sent with other emails, and retried on error.
+		Notifications will be marked as sent
+		and statistics will be updated when the email is sent *****/
+	 snprintf (Subject,sizeof (Subject),
+	           "[%s] %s",
 		   Cfg_PLATFORM_SHORT_NAME,
-		   Txt_Notifications_NO_HTML[ToUsrLanguage],
-		   FileNameMail);
-	 ReturnCode = system (Command);
-	 if (ReturnCode == -1)
-	    Lay_ShowErrorAndExit ("Error when running script to send email.");
-
-	 /***** Remove temporary file *****/
-	 unlink (FileNameMail);
-
-	 /***** Update number of notifications, number of mails and statistics *****/
-	 ReturnCode = WEXITSTATUS(ReturnCode);
-	 if (ReturnCode == 0)	// Message sent successfully
-	   {
-	    *NumNotif = (unsigned) NumRows;
-	    *NumMails = 1;
-
-	    /* Update statistics about notifications */
-	    Ntf_UpdateNumNotifSent (Deg.DegCod,Crs.CrsCod,NotifyEvent,*NumNotif,*NumMails);
-	   }
+		   Txt_Notifications_NO_HTML[ToUsrLanguage]);
+	 Mai_QueueMail (ToUsrDat->UsrCod,MaxNtfCod,
+	                ToUsrDat->Email,Subject,FileNameMail);
 
-	 /***** Mark all the pending notifications of this user as 'sent' *****/
-	 DB_QueryUPDATE ("can not set pending notifications of a user as sent",
-			 "UPDATE notif SET Status=(Status | %u)"
-			 " WHERE ToUsrCod=%ld"
-			 " AND (Status & %u)<>0 AND (Status & %u)=0  AND (Status & %u)=0",
-		         (unsigned) Ntf_STATUS_BIT_SENT,ToUsrDat->UsrCod,
-		         (unsigned) Ntf_STATUS_BIT_EMAIL,
-		         (unsigned) Ntf_STATUS_BIT_SENT,
-		         (unsigned) (Ntf_STATUS_BIT_READ | Ntf_STATUS_BIT_REMOVED));
+	 /***** Update number of notifications and number of mails queued *****/
+	 *NumNotif = (unsigned) NumRows;
+	 *NumMails = 1;
 	}
 
       /***** Free structure that stores the query result *****/
@@ -1799,6 +1825,82 @@ static void Ntf_SendPendingNotifByEMailToOneUsr (struct UsrData *ToUsrDat,unsign
      }
   }
 
+/*****************************************************************************/
+/*********** Mark as sent the notifications included in an email *************/
+/*****************************************************************************/
+// Called when the email has been sent successfully.
+// Only pending notifications until MaxNtfCod were included in the email
+
+void Ntf_MarkNotifAsSent (long ToUsrCod,long MaxNtfCod)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumNotif;
+   long DegCod;
+   long CrsCod;
+   Ntf_NotifyEvent_t NotifyEvent;
+
+   /***** Get notifications included in the email, the last one first *****/
+   if ((NumNotif = (unsigned) DB_QuerySELECT (&mysql_res,"can not get notifications"
+							 " sent to a user",
+					      "SELECT DegCod,"		// row[0]
+						     "CrsCod,"		// row[1]
+						     "NotifyEvent"	// row[2]
+					      " FROM notif"
+					      " WHERE ToUsrCod=%ld"
+					      " AND NtfCod<=%ld"
+					      " AND (Status & %u)<>0"
+					      " AND (Status & %u)=0"
+					      " AND (Status & %u)=0"
+					      " ORDER BY TimeNotif DESC,NotifyEvent DESC",
+					      ToUsrCod,MaxNtfCod,
+					      (unsigned) Ntf_STATUS_BIT_EMAIL,
+					      (unsigned) Ntf_STATUS_BIT_SENT,
+					      (unsigned) (Ntf_STATUS_BIT_READ | Ntf_STATUS_BIT_REMOVED))))
+     {
+      /***** Update statistics about notifications,
+             using degree, course and event of the last notification *****/
+      row = mysql_fetch_row (mysql_res);
+      DegCod = Str_ConvertStrCodToLongCod (row[0]);
+      CrsCod = Str_ConvertStrCodToLongCod (row[1]);
+      NotifyEvent = Ntf_GetNotifyEventFromStr ((const char *) row[2]);
+      Ntf_UpdateNumNotifSent (DegCod,CrsCod,NotifyEvent,NumNotif,1);
+
+      /***** Mark these notifications as 'sent' *****/
+      DB_QueryUPDATE ("can not set pending notifications of a user as sent",
+		      "UPDATE notif SET Status=(Status | %u)"
+		      " WHERE ToUsrCod=%ld"
+		      " AND NtfCod<=%ld"
+		      " AND (Status & %u)<>0 AND (Status & %u)=0  AND (Status & %u)=0",
+		      (unsigned) Ntf_STATUS_BIT_SENT,ToUsrCod,MaxNtfCod,
+		      (unsigned) Ntf_STATUS_BIT_EMAIL,
+		      (unsigned) Ntf_STATUS_BIT_SENT,
+		      (unsigned) (Ntf_STATUS_BIT_READ | Ntf_STATUS_BIT_REMOVED));
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/******** Mark the notifications included in an email as not emailed *********/
+/*****************************************************************************/
+// Called when the email is dropped after failing many times.
+// These notifications are not included in new emails,
+// but they are still shown in the list of notifications of the user
+
+void Ntf_MarkNotifAsNotSentByEmail (long ToUsrCod,long MaxNtfCod)
+  {
+   DB_QueryUPDATE ("can not set pending notifications of a user as not emailed",
+		   "UPDATE notif SET Status=(Status & ~%u)"
+		   " WHERE ToUsrCod=%ld"
+		   " AND NtfCod<=%ld"
+		   " AND (Status & %u)<>0 AND (Status & %u)=0",
+		   (unsigned) Ntf_STATUS_BIT_EMAIL,ToUsrCod,MaxNtfCod,
+		   (unsigned) Ntf_STATUS_BIT_EMAIL,
+		   (unsigned) Ntf_STATUS_BIT_SENT);
+  }
+
 /*****************************************************************************/
 /****** Get notify event type from string number coming from database ********/
 /*****************************************************************************/
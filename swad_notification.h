@@ -133,7 +133,13 @@ void Ntf_StoreNotifyEventToOneUser (Ntf_NotifyEvent_t NotifyEvent,
                                     struct UsrData *UsrDat,
                                     long Cod,Ntf_Status_t Status,
                                     long InsCod,long CtrCod,long DegCod,long CrsCod);
+void Ntf_StoreNotifyEventToUsrsInList (Ntf_NotifyEvent_t NotifyEvent,
+                                       const char *SubQueryUsrs,
+                                       long Cod,Ntf_Status_t Status,
+                                       long InsCod,long CtrCod,long DegCod,long CrsCod);
 void Ntf_SendPendingNotifByEMailToAllUsrs (void);
+void Ntf_MarkNotifAsSent (long ToUsrCod,long MaxNtfCod);
+void Ntf_MarkNotifAsNotSentByEmail (long ToUsrCod,long MaxNtfCod);
 Ntf_NotifyEvent_t Ntf_GetNotifyEventFromStr (const char *Str);
 void Ntf_MarkAllNotifAsSeen (void);
 void Ntf_PutFormChangeNotifSentByEMail (void);
@@ -27,10 +27,8 @@
 
 #define _GNU_SOURCE 		// For asprintf
 #include <stdio.h>		// For asprintf
-#include <stdlib.h>		// For system, getenv, etc.
+#include <stdlib.h>		// For getenv, etc.
 #include <string.h>		// For string functions
-#include <sys/wait.h>		// For the macro WEXITSTATUS
-#include <unistd.h>		// For unlink
 
 #include "swad_box.h"
 #include "swad_database.h"
@@ -417,11 +415,7 @@ int Pwd_SendNewPasswordByEmail (char NewRandomPlainPassword[Pwd_MAX_BYTES_PLAIN_
    extern const char *Txt_New_password_NO_HTML[1 + Lan_NUM_LANGUAGES];
    char FileNameMail[PATH_MAX + 1];
    FILE *FileMail;
-   char Command[2048 +
-		Cfg_MAX_BYTES_SMTP_PASSWORD +
-		Cns_MAX_BYTES_EMAIL_ADDRESS +
-		PATH_MAX]; // Command to execute for sending an email
-   int ReturnCode;
+   char Subject[Mai_MAX_BYTES_SUBJECT + 1];
 
    /***** Create temporary file for mail content *****/
    Mai_CreateFileNameMail (FileNameMail,&FileMail);
@@ -444,27 +438,14 @@ int Pwd_SendNewPasswordByEmail (char NewRandomPlainPassword[Pwd_MAX_BYTES_PLAIN_
 
    fclose (FileMail);
 
-   /***** Call the script to send an email *****/
-   snprintf (Command,sizeof (Command),
-	     "%s \"%s\" \"%s\" \"%s\" \"%s\" \"%s\" \"[%s] %s\" \"%s\"",
-	     Cfg_COMMAND_SEND_AUTOMATIC_EMAIL,
-	     Cfg_AUTOMATIC_EMAIL_SMTP_SERVER,
-	     Cfg_AUTOMATIC_EMAIL_SMTP_PORT,
-	     Cfg_AUTOMATIC_EMAIL_FROM,
-             Gbl.Config.SMTPPassword,
-	     Gbl.Usrs.Me.UsrDat.Email,
+   /***** Send email now *****/
+   // The email is not kept in outbox to be retried,
+   // so the new password is not stored
+   snprintf (Subject,sizeof (Subject),
+	     "[%s] %s",
 	     Cfg_PLATFORM_SHORT_NAME,
-	     Txt_New_password_NO_HTML[Gbl.Usrs.Me.UsrDat.Prefs.Language],
-	     FileNameMail);
-   ReturnCode = system (Command);
-   if (ReturnCode == -1)
-      Lay_ShowErrorAndExit ("Error when running script to send email.");
-
-   /***** Remove temporary file *****/
-   unlink (FileNameMail);
-
-   /***** Write message depending on return code *****/
-   return WEXITSTATUS (ReturnCode);
+	     Txt_New_password_NO_HTML[Gbl.Usrs.Me.UsrDat.Prefs.Language]);
+   return Mai_SendMailNow (Gbl.Usrs.Me.UsrDat.Email,Subject,FileNameMail);
   }
 
 /*****************************************************************************/
@@ -27,19 +27,22 @@
 
 #define _GNU_SOURCE 		// For asprintf
 #include <stddef.h>		// For NULL
-#include <stdio.h>		// For asprintf
+#include <stdio.h>		// For asprintf, snprintf
+#include <stdlib.h>		// For free
 #include <string.h>		// For string functions
 
 #include "swad_box.h"
 #include "swad_config.h"
 #include "swad_database.h"
 #include "swad_figure.h"
+#include "swad_figure_snapshot.h"
 #include "swad_follow.h"
 #include "swad_form.h"
 #include "swad_forum.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_language.h"
+#include "swad_log_archive.h"
 #include "swad_message.h"
 #include "swad_network.h"
 #include "swad_nickname.h"
@@ -48,6 +51,7 @@
 #include "swad_photo.h"
 #include "swad_privacy.h"
 #include "swad_profile.h"
+#include "swad_profile_ranking.h"
 #include "swad_role.h"
 #include "swad_role_type.h"
 #include "swad_setting.h"
@@ -104,6 +108,7 @@ static unsigned long Prf_GetRankingFigure (long UsrCod,const char *FieldName);
 static unsigned long Prf_GetNumUsrsWithFigure (const char *FieldName);
 static unsigned long Prf_GetRankingNumClicksPerDay (long UsrCod);
 static unsigned long Prf_GetNumUsrsWithNumClicksPerDay (void);
+static void Prf_ShowRankingOfUsr (long UsrCod,PrfRnk_Figure_t Figure);
 static void Prf_ShowRanking (unsigned long Rank,unsigned long NumUsrs);
 
 static void Prf_GetFirstClickFromLogAndStoreAsUsrFigure (long UsrCod);
@@ -118,7 +123,7 @@ static void Prf_CreateUsrFigures (long UsrCod,const struct UsrFigures *UsrFigure
                                   bool CreatingMyOwnAccount);
 static bool Prf_CheckIfUsrFiguresExists (long UsrCod);
 
-static void Prf_GetAndShowRankingFigure (const char *FieldName);
+static void Prf_GetAndShowRankingFigure (PrfRnk_Figure_t Figure);
 static void Prf_ShowUsrInRanking (struct UsrData *UsrDat,unsigned Rank,bool ItsMe);
 
 /*****************************************************************************/
@@ -609,16 +614,14 @@ static void Prf_ShowNumClicks (const struct UsrData *UsrDat,
      {
       HTM_Long (UsrFigures->NumClicks);
       HTM_TxtF ("&nbsp;%s&nbsp;",Txt_clicks);
-      Prf_ShowRanking (Prf_GetRankingFigure (UsrDat->UsrCod,"NumClicks"),
-		       Prf_GetNumUsrsWithFigure ("NumClicks"));
+      Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_CLICKS);
       if (UsrFigures->NumDays > 0)
 	{
 	 HTM_TxtF ("&nbsp;%s","(");
 	 HTM_DoubleFewDigits ((double) UsrFigures->NumClicks /
 		     (double) UsrFigures->NumDays);
 	 HTM_TxtF ("/%s&nbsp;",Txt_day);
-	 Prf_ShowRanking (Prf_GetRankingNumClicksPerDay (UsrDat->UsrCod),
-			  Prf_GetNumUsrsWithNumClicksPerDay ());
+	 Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_CLICKS_PER_DAY);
 	 HTM_Txt (")");
 	}
      }
@@ -649,8 +652,7 @@ static void Prf_ShowNumFileViews (const struct UsrData *UsrDat,
       HTM_Long (UsrFigures->NumFileViews);
       HTM_TxtF ("&nbsp;%s&nbsp;",(UsrFigures->NumFileViews == 1) ? Txt_download :
 						         Txt_downloads);
-      Prf_ShowRanking (Prf_GetRankingFigure (UsrDat->UsrCod,"NumFileViews"),
-		       Prf_GetNumUsrsWithFigure ("NumFileViews"));
+      Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_FILE_VIEWS);
       if (UsrFigures->NumDays > 0)
 	{
 	 HTM_TxtF ("&nbsp;%s","(");
@@ -686,8 +688,7 @@ static void Prf_ShowNumSocialPublications (const struct UsrData *UsrDat,
       HTM_Long (UsrFigures->NumSocPub);
       HTM_TxtF ("&nbsp;%s&nbsp;",UsrFigures->NumSocPub == 1 ? Txt_TIMELINE_post :
 					                      Txt_TIMELINE_posts);
-      Prf_ShowRanking (Prf_GetRankingFigure (UsrDat->UsrCod,"NumSocPub"),
-		       Prf_GetNumUsrsWithFigure ("NumSocPub"));
+      Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_SOC_PUB);
       if (UsrFigures->NumDays > 0)
 	{
 	 HTM_TxtF ("&nbsp;%s","(");
@@ -723,8 +724,7 @@ static void Prf_ShowNumForumPosts (const struct UsrData *UsrDat,
       HTM_Long (UsrFigures->NumForPst);
       HTM_TxtF ("&nbsp;%s&nbsp;",UsrFigures->NumForPst == 1 ? Txt_FORUM_post :
 					                      Txt_FORUM_posts);
-      Prf_ShowRanking (Prf_GetRankingFigure (UsrDat->UsrCod,"NumForPst"),
-		       Prf_GetNumUsrsWithFigure ("NumForPst"));
+      Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_FOR_PST);
       if (UsrFigures->NumDays > 0)
 	{
 	 HTM_TxtF ("&nbsp;%s","(");
@@ -760,8 +760,7 @@ static void Prf_ShowNumMessagesSent (const struct UsrData *UsrDat,
       HTM_Long (UsrFigures->NumMsgSnt);
       HTM_TxtF ("&nbsp;%s&nbsp;",UsrFigures->NumMsgSnt == 1 ? Txt_message :
 					                      Txt_messages);
-      Prf_ShowRanking (Prf_GetRankingFigure (UsrDat->UsrCod,"NumMsgSnt"),
-		       Prf_GetNumUsrsWithFigure ("NumMsgSnt"));
+      Prf_ShowRankingOfUsr (UsrDat->UsrCod,PrfRnk_MSG_SNT);
       if (UsrFigures->NumDays > 0)
 	{
 	 HTM_TxtF ("&nbsp;%s","(");
@@ -948,6 +947,38 @@ static unsigned long Prf_GetNumUsrsWithNumClicksPerDay (void)
 			 " AND FirstClickTime>FROM_UNIXTIME(0)");
   }
 
+/*****************************************************************************/
+/******************* Get and show position of user in ranking ****************/
+/*****************************************************************************/
+
+static void Prf_ShowRankingOfUsr (long UsrCod,PrfRnk_Figure_t Figure)
+  {
+   extern const char *PrfRnk_FieldNames[PrfRnk_NUM_FIGURES];
+   unsigned long Rank;
+   unsigned long NumUsrs;
+
+   /***** Get rank from stored ranking.
+          If user is not in it (ranking not yet built
+          or user's figures computed after building it),
+          compute rank from users' figures *****/
+   if (!PrfRnk_GetRankOfUsr (Figure,UsrCod,&Rank,&NumUsrs))
+     {
+      if (Figure == PrfRnk_CLICKS_PER_DAY)
+	{
+	 Rank    = Prf_GetRankingNumClicksPerDay (UsrCod);
+	 NumUsrs = Prf_GetNumUsrsWithNumClicksPerDay ();
+	}
+      else
+	{
+	 Rank    = Prf_GetRankingFigure (UsrCod,PrfRnk_FieldNames[Figure]);
+	 NumUsrs = Prf_GetNumUsrsWithFigure (PrfRnk_FieldNames[Figure]);
+	}
+     }
+
+   /***** Show rank *****/
+   Prf_ShowRanking (Rank,NumUsrs);
+  }
+
 /*****************************************************************************/
 /************************* Show position in ranking **************************/
 /*****************************************************************************/
@@ -1048,18 +1079,24 @@ static void Prf_GetFirstClickFromLogAndStoreAsUsrFigure (long UsrCod)
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
    struct UsrFigures UsrFigures;
+   char Condition[16 + Cns_MAX_DECIMAL_DIGITS_LONG + 1];
+   char *LogTable;
 
    if (Usr_ChkIfUsrCodExists (UsrCod))
      {
       /***** Reset user's figures *****/
       Prf_ResetUsrFigures (&UsrFigures);
 
-      /***** Get first click from log table *****/
+      /***** Get first click from log table (including archives) *****/
+      snprintf (Condition,sizeof (Condition),"UsrCod=%ld",UsrCod);
+      LogArc_BuildLogTable (&LogTable,(time_t) 0,Gbl.StartExecutionTimeUTC,
+                            Condition);
       if (DB_QuerySELECT (&mysql_res,"can not get user's first click",
 			  "SELECT UNIX_TIMESTAMP("
-			  "(SELECT MIN(ClickTime) FROM log"
+			  "(SELECT MIN(ClickTime) FROM %s"
 			  " WHERE UsrCod=%ld)"
 			  ")",
+			  LogTable,
 			  UsrCod))
 	{
 	 /* Get first click */
@@ -1071,6 +1108,7 @@ static void Prf_GetFirstClickFromLogAndStoreAsUsrFigure (long UsrCod)
 	}
       /* Free structure that stores the query result */
       DB_FreeMySQLResult (&mysql_res);
+      free (LogTable);
 
       /***** Update first click time in user's figures *****/
       if (Prf_CheckIfUsrFiguresExists (UsrCod))
@@ -1091,18 +1129,25 @@ static void Prf_GetFirstClickFromLogAndStoreAsUsrFigure (long UsrCod)
 static void Prf_GetNumClicksAndStoreAsUsrFigure (long UsrCod)
   {
    struct UsrFigures UsrFigures;
+   char Condition[16 + Cns_MAX_DECIMAL_DIGITS_LONG + 1];
+   char *LogTable;
 
    if (Usr_ChkIfUsrCodExists (UsrCod))
      {
       /***** Reset user's figures *****/
       Prf_ResetUsrFigures (&UsrFigures);
 
-      /***** Get number of clicks from database *****/
+      /***** Get number of clicks from database (including archives) *****/
+      snprintf (Condition,sizeof (Condition),"UsrCod=%ld",UsrCod);
+      LogArc_BuildLogTable (&LogTable,(time_t) 0,Gbl.StartExecutionTimeUTC,
+                            Condition);
       UsrFigures.NumClicks =
       (long) DB_QueryCOUNT ("can not get number of clicks",
-			    "SELECT COUNT(*) FROM log"
+			    "SELECT COUNT(*) FROM %s"
 			    " WHERE UsrCod=%ld",
+			    LogTable,
 			    UsrCod);
+      free (LogTable);
 
       /***** Update number of clicks in user's figures *****/
       if (Prf_CheckIfUsrFiguresExists (UsrCod))
@@ -1302,6 +1347,9 @@ void Prf_RemoveUsrFigures (long UsrCod)
    DB_QueryDELETE ("can not delete user's figures",
 		   "DELETE FROM usr_figures WHERE UsrCod=%ld",
 		   UsrCod);
+
+   /***** Remove user from rankings *****/
+   PrfRnk_RemoveUsrFromRankings (UsrCod);
   }
 
 /*****************************************************************************/
@@ -1392,31 +1440,33 @@ void Prf_IncrementNumMsgSntUsr (long UsrCod)
 
 void Prf_GetAndShowRankingClicks (void)
   {
-   Prf_GetAndShowRankingFigure ("NumClicks");
+   Prf_GetAndShowRankingFigure (PrfRnk_CLICKS);
   }
 
 void Prf_GetAndShowRankingSocPub (void)
   {
-   Prf_GetAndShowRankingFigure ("NumSocPub");
+   Prf_GetAndShowRankingFigure (PrfRnk_SOC_PUB);
   }
 
 void Prf_GetAndShowRankingFileViews (void)
   {
-   Prf_GetAndShowRankingFigure ("NumFileViews");
+   Prf_GetAndShowRankingFigure (PrfRnk_FILE_VIEWS);
   }
 
 void Prf_GetAndShowRankingForPst (void)
   {
-   Prf_GetAndShowRankingFigure ("NumForPst");
+   Prf_GetAndShowRankingFigure (PrfRnk_FOR_PST);
   }
 
 void Prf_GetAndShowRankingMsgSnt (void)
   {
-   Prf_GetAndShowRankingFigure ("NumMsgSnt");
+   Prf_GetAndShowRankingFigure (PrfRnk_MSG_SNT);
   }
 
-static void Prf_GetAndShowRankingFigure (const char *FieldName)
+static void Prf_GetAndShowRankingFigure (PrfRnk_Figure_t Figure)
   {
+   extern const char *PrfRnk_FieldNames[PrfRnk_NUM_FIGURES];
+   const char *FieldName = PrfRnk_FieldNames[Figure];
    MYSQL_RES *mysql_res;
    unsigned NumUsrs = 0;	// Initialized to avoid warning
 
@@ -1424,95 +1474,97 @@ static void Prf_GetAndShowRankingFigure (const char *FieldName)
    switch (Gbl.Scope.Current)
      {
       case Hie_SYS:
-	 NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT UsrCod,%s"
-				    " FROM usr_figures"
-				    " WHERE %s>0"
-				    " AND UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY %s DESC,UsrCod LIMIT 100",
-				    FieldName,
-				    FieldName,FieldName);
+	 /* Get top of stored ranking, or sort users' figures if not built */
+	 if (!PrfRnk_GetTopUsrs (&mysql_res,Figure,&NumUsrs))
+	    NumUsrs =
+	    (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					   "SELECT UsrCod,%s"
+					   " FROM usr_figures"
+					   " WHERE %s>0"
+					   " AND UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					   " ORDER BY %s DESC,UsrCod LIMIT 100",
+					   FieldName,
+					   FieldName,FieldName);
          break;
       case Hie_CTY:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
-				    " FROM institutions,centres,degrees,courses,crs_usr,usr_figures"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.%s>0"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
-				    FieldName,
-				    Gbl.Hierarchy.Cty.CtyCod,
-				    FieldName,FieldName);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
+					" FROM institutions,centres,degrees,courses,crs_usr,usr_figures"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.%s>0"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
+					FieldName,
+					Gbl.Hierarchy.Cty.CtyCod,
+					FieldName,FieldName);
          break;
       case Hie_INS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
-				    " FROM centres,degrees,courses,crs_usr,usr_figures"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.%s>0"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
-				    FieldName,
-				    Gbl.Hierarchy.Ins.InsCod,
-				    FieldName,FieldName);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
+					" FROM centres,degrees,courses,crs_usr,usr_figures"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.%s>0"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
+					FieldName,
+					Gbl.Hierarchy.Ins.InsCod,
+					FieldName,FieldName);
          break;
       case Hie_CTR:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
-				    " FROM degrees,courses,crs_usr,usr_figures"
-				    " WHERE degrees.CtrCod=%ld"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.%s>0"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
-				    FieldName,
-				    Gbl.Hierarchy.Ctr.CtrCod,
-				    FieldName,FieldName);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
+					" FROM degrees,courses,crs_usr,usr_figures"
+					" WHERE degrees.CtrCod=%ld"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.%s>0"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
+					FieldName,
+					Gbl.Hierarchy.Ctr.CtrCod,
+					FieldName,FieldName);
          break;
       case Hie_DEG:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
-				    " FROM courses,crs_usr,usr_figures"
-				    " WHERE courses.DegCod=%ld"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.%s>0"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
-				    FieldName,
-				    Gbl.Hierarchy.Deg.DegCod,
-				    FieldName,FieldName);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
+					" FROM courses,crs_usr,usr_figures"
+					" WHERE courses.DegCod=%ld"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.%s>0"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
+					FieldName,
+					Gbl.Hierarchy.Deg.DegCod,
+					FieldName,FieldName);
          break;
       case Hie_CRS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
-				    " FROM crs_usr,usr_figures"
-				    " WHERE crs_usr.CrsCod=%ld"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.%s>0"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
-				    FieldName,
-				    Gbl.Hierarchy.Crs.CrsCod,
-				    FieldName,FieldName);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,usr_figures.%s"
+					" FROM crs_usr,usr_figures"
+					" WHERE crs_usr.CrsCod=%ld"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.%s>0"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY usr_figures.%s DESC,usr_figures.UsrCod LIMIT 100",
+					FieldName,
+					Gbl.Hierarchy.Crs.CrsCod,
+					FieldName,FieldName);
          break;
       default:
          Lay_WrongScopeExit ();
@@ -1603,100 +1655,102 @@ void Prf_GetAndShowRankingClicksPerDay (void)
    switch (Gbl.Scope.Current)
      {
       case Hie_SYS:
-	 NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT UsrCod,"
-				    "NumClicks/(DATEDIFF(NOW(),FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM usr_figures"
-				    " WHERE NumClicks>0"
-				    " AND FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,UsrCod LIMIT 100");
+	 /* Get top of stored ranking, or sort users' figures if not built */
+	 if (!PrfRnk_GetTopUsrs (&mysql_res,PrfRnk_CLICKS_PER_DAY,&NumUsrs))
+	    NumUsrs =
+	    (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					   "SELECT UsrCod,"
+					   "NumClicks/(DATEDIFF(NOW(),FirstClickTime)+1) AS NumClicksPerDay"
+					   " FROM usr_figures"
+					   " WHERE NumClicks>0"
+					   " AND FirstClickTime>FROM_UNIXTIME(0)"
+					   " AND UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					   " ORDER BY NumClicksPerDay DESC,UsrCod LIMIT 100");
          break;
       case Hie_CTY:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,"
-				    "usr_figures.NumClicks/(DATEDIFF(NOW(),"
-				    "usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM institutions,centres,degrees,courses,crs_usr,usr_figures"
-				    " WHERE institutions.CtyCod=%ld"
-				    " AND institutions.InsCod=centres.InsCod"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.NumClicks>0"
-				    " AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
-				    Gbl.Hierarchy.Cty.CtyCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,"
+					"usr_figures.NumClicks/(DATEDIFF(NOW(),"
+					"usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
+					" FROM institutions,centres,degrees,courses,crs_usr,usr_figures"
+					" WHERE institutions.CtyCod=%ld"
+					" AND institutions.InsCod=centres.InsCod"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.NumClicks>0"
+					" AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
+					Gbl.Hierarchy.Cty.CtyCod);
          break;
       case Hie_INS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,"
-				    "usr_figures.NumClicks/(DATEDIFF(NOW(),"
-				    "usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM centres,degrees,courses,crs_usr,usr_figures"
-				    " WHERE centres.InsCod=%ld"
-				    " AND centres.CtrCod=degrees.CtrCod"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.NumClicks>0"
-				    " AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
-				    Gbl.Hierarchy.Ins.InsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,"
+					"usr_figures.NumClicks/(DATEDIFF(NOW(),"
+					"usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
+					" FROM centres,degrees,courses,crs_usr,usr_figures"
+					" WHERE centres.InsCod=%ld"
+					" AND centres.CtrCod=degrees.CtrCod"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.NumClicks>0"
+					" AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
+					Gbl.Hierarchy.Ins.InsCod);
          break;
       case Hie_CTR:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,"
-				    "usr_figures.NumClicks/(DATEDIFF(NOW(),"
-				    "usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM degrees,courses,crs_usr,usr_figures"
-				    " WHERE degrees.CtrCod=%ld"
-				    " AND degrees.DegCod=courses.DegCod"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.NumClicks>0"
-				    " AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
-				    Gbl.Hierarchy.Ctr.CtrCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,"
+					"usr_figures.NumClicks/(DATEDIFF(NOW(),"
+					"usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
+					" FROM degrees,courses,crs_usr,usr_figures"
+					" WHERE degrees.CtrCod=%ld"
+					" AND degrees.DegCod=courses.DegCod"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.NumClicks>0"
+					" AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
+					Gbl.Hierarchy.Ctr.CtrCod);
          break;
       case Hie_DEG:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,"
-				    "usr_figures.NumClicks/(DATEDIFF(NOW(),"
-				    "usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM courses,crs_usr,usr_figures"
-				    " WHERE courses.DegCod=%ld"
-				    " AND courses.CrsCod=crs_usr.CrsCod"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.NumClicks>0"
-				    " AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
-				    Gbl.Hierarchy.Deg.DegCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,"
+					"usr_figures.NumClicks/(DATEDIFF(NOW(),"
+					"usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
+					" FROM courses,crs_usr,usr_figures"
+					" WHERE courses.DegCod=%ld"
+					" AND courses.CrsCod=crs_usr.CrsCod"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.NumClicks>0"
+					" AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
+					Gbl.Hierarchy.Deg.DegCod);
          break;
       case Hie_CRS:
          NumUsrs =
-         (unsigned) DB_QuerySELECT (&mysql_res,"can not get ranking",
-				    "SELECT DISTINCTROW usr_figures.UsrCod,"
-				    "usr_figures.NumClicks/(DATEDIFF(NOW(),"
-				    "usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
-				    " FROM crs_usr,usr_figures"
-				    " WHERE crs_usr.CrsCod=%ld"
-				    " AND crs_usr.UsrCod=usr_figures.UsrCod"
-				    " AND usr_figures.NumClicks>0"
-				    " AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
-				    " AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
-				    " ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
-				    Gbl.Hierarchy.Crs.CrsCod);
+         (unsigned) FigSnp_QuerySELECT (&mysql_res,"can not get ranking",
+					"SELECT DISTINCTROW usr_figures.UsrCod,"
+					"usr_figures.NumClicks/(DATEDIFF(NOW(),"
+					"usr_figures.FirstClickTime)+1) AS NumClicksPerDay"
+					" FROM crs_usr,usr_figures"
+					" WHERE crs_usr.CrsCod=%ld"
+					" AND crs_usr.UsrCod=usr_figures.UsrCod"
+					" AND usr_figures.NumClicks>0"
+					" AND usr_figures.FirstClickTime>FROM_UNIXTIME(0)"
+					" AND usr_figures.UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+					" ORDER BY NumClicksPerDay DESC,usr_figures.UsrCod LIMIT 100",
+					Gbl.Hierarchy.Crs.CrsCod);
          break;
       default:
          Lay_WrongScopeExit ();
@@ -0,0 +1,437 @@
+// swad_profile_ranking.c: rankings of users' figures stored in database
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdio.h>		// For sprintf
+#include <stdlib.h>		// For malloc, free
+#include <string.h>		// For strcmp, strlen
+
+#include "swad_config.h"
+#include "swad_constant.h"
+#include "swad_database.h"
+#include "swad_figure_snapshot.h"
+#include "swad_global.h"
+#include "swad_layout.h"
+#include "swad_profile_ranking.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Public constants ******************************/
+/*****************************************************************************/
+
+// Fields of usr_figures used in rankings (NULL if figure is not a field)
+const char *PrfRnk_FieldNames[PrfRnk_NUM_FIGURES] =
+  {
+   [PrfRnk_CLICKS        ] = "NumClicks",
+   [PrfRnk_CLICKS_PER_DAY] = NULL,
+   [PrfRnk_SOC_PUB       ] = "NumSocPub",
+   [PrfRnk_FILE_VIEWS    ] = "NumFileViews",
+   [PrfRnk_FOR_PST       ] = "NumForPst",
+   [PrfRnk_MSG_SNT       ] = "NumMsgSnt",
+  };
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Each ranking is stored in table usr_ranks, one row per user,
+   with the value of the figure, the rank (1 + number of users
+   with a greater value) and the position in the ordered list.
+   Rankings are rebuilt in background when they are older than
+   Cfg_TIME_TO_REFRESH_RANKINGS. A new ranking is stored with a new version
+   and then published in table usr_rankings, so readers always see
+   a complete ranking.
+   A process claims a build by setting its unique name in usr_rankings.
+   Each claim gets a new version, so a slow process whose claim
+   has been taken by another one never inserts rows in the same version.
+   While building, the claim is refreshed after each batch of users,
+   and the build is abandoned if the claim has been lost.
+   Rank of a user and top of a ranking are got using indexes,
+   without sorting table usr_figures.
+*/
+#define PrfRnk_MAX_USRS_IN_INSERT	1000	// Maximum number of users inserted in each query when building a ranking
+#define PrfRnk_MAX_BYTES_VALUE		64	// Maximum length of the value of a figure as got from database
+#define PrfRnk_MAX_BYTES_USR_IN_INSERT	(5 * Cns_MAX_DECIMAL_DIGITS_LONG + PrfRnk_MAX_BYTES_VALUE + 16)	// "(Figure,Version,UsrCod,Value,Rnk,Pos),"
+
+#define PrfRnk_MAX_USRS_IN_TOP		100	// Maximum number of users listed in a ranking
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static unsigned PrfRnk_GetVersion (PrfRnk_Figure_t Figure,unsigned long *NumUsrs);
+static bool PrfRnk_ClaimRanking (PrfRnk_Figure_t Figure,unsigned *Version);
+static bool PrfRnk_RefreshMyClaim (PrfRnk_Figure_t Figure);
+static void PrfRnk_BuildRanking (PrfRnk_Figure_t Figure,unsigned Version);
+
+/*****************************************************************************/
+/***************** Rebuild the oldest ranking if it is old *******************/
+/*****************************************************************************/
+
+void PrfRnk_UpdateOldestRanking (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   PrfRnk_Figure_t Figure;
+   unsigned UnsignedNum;
+   unsigned Version;
+   bool Found;
+
+   /***** Create rankings not yet created *****/
+   for (Figure  = (PrfRnk_Figure_t) 0;
+	Figure <= (PrfRnk_Figure_t) (PrfRnk_NUM_FIGURES - 1);
+	Figure++)
+      DB_QueryINSERT ("can not create ranking",
+		      "INSERT IGNORE INTO usr_rankings"
+		      " (Figure,Version,NumUsrs,"
+		      "BuildingToken,BuildingVersion,UpdateTime)"
+		      " VALUES"
+		      " (%u,0,0,'',0,FROM_UNIXTIME(0))",
+		      (unsigned) Figure);
+
+   /***** Get the oldest ranking, if it must be rebuilt *****/
+   if ((Found = (DB_QuerySELECT (&mysql_res,"can not get oldest ranking",
+				 "SELECT Figure FROM usr_rankings"
+				 " WHERE UpdateTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)"
+				 " ORDER BY UpdateTime LIMIT 1",
+				 (unsigned long) Cfg_TIME_TO_REFRESH_RANKINGS) != 0)))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get figure (row[0]) */
+      if (sscanf (row[0],"%u",&UnsignedNum) != 1)
+	 Lay_ShowErrorAndExit ("Error when getting ranking.");
+      Figure = (PrfRnk_Figure_t) UnsignedNum;
+      if (Figure >= PrfRnk_NUM_FIGURES)
+	 Lay_ShowErrorAndExit ("Wrong ranking.");
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   if (!Found)
+      return;
+
+   /***** Claim the ranking and build it *****/
+   if (PrfRnk_ClaimRanking (Figure,&Version))
+      PrfRnk_BuildRanking (Figure,Version);
+  }
+
+/*****************************************************************************/
+/******************** Claim the build of an old ranking **********************/
+/*****************************************************************************/
+// Return false if another process has claimed the ranking
+
+static bool PrfRnk_ClaimRanking (PrfRnk_Figure_t Figure,unsigned *Version)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   bool Claimed;
+
+   /***** Claim the ranking only if it is still old.
+          If this process does not end the build,
+          the ranking will be old again after some time
+          and another process will claim it with a greater version *****/
+   DB_QueryUPDATE ("can not claim ranking",
+		   "UPDATE usr_rankings"
+		   " SET BuildingToken='%s',"
+		   "BuildingVersion=GREATEST(Version,BuildingVersion)+1,"
+		   "UpdateTime=NOW()"
+		   " WHERE Figure=%u"
+		   " AND UpdateTime<FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)",
+		   Gbl.UniqueNameEncrypted,
+		   (unsigned) Figure,
+		   (unsigned long) Cfg_TIME_TO_REFRESH_RANKINGS);
+   if (!mysql_affected_rows (&Gbl.mysql))
+      return false;
+
+   /***** Get the version to be built by this process *****/
+   if ((Claimed = (DB_QuerySELECT (&mysql_res,"can not get ranking",
+				   "SELECT BuildingVersion FROM usr_rankings"
+				   " WHERE Figure=%u AND BuildingToken='%s'",
+				   (unsigned) Figure,
+				   Gbl.UniqueNameEncrypted) != 0)))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get version (row[0]) */
+      if (sscanf (row[0],"%u",Version) != 1)
+	 Lay_ShowErrorAndExit ("Error when getting ranking.");
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Claimed;
+  }
+
+/*****************************************************************************/
+/********** Refresh the claim of a ranking being built by this process *******/
+/*****************************************************************************/
+// Return false if the claim has been taken by another process
+
+static bool PrfRnk_RefreshMyClaim (PrfRnk_Figure_t Figure)
+  {
+   DB_QueryUPDATE ("can not refresh ranking",
+		   "UPDATE usr_rankings"
+		   " SET UpdateTime=NOW()"
+		   " WHERE Figure=%u AND BuildingToken='%s'",
+		   (unsigned) Figure,
+		   Gbl.UniqueNameEncrypted);
+
+   /* Affected rows are 0 too if the time has not changed,
+      so check the claim explicitly */
+   return (DB_QueryCOUNT ("can not check ranking",
+			  "SELECT COUNT(*) FROM usr_rankings"
+			  " WHERE Figure=%u AND BuildingToken='%s'",
+			  (unsigned) Figure,
+			  Gbl.UniqueNameEncrypted) != 0);
+  }
+
+/*****************************************************************************/
+/************ Build a new version of a ranking and publish it ****************/
+/*****************************************************************************/
+
+static void PrfRnk_BuildRanking (PrfRnk_Figure_t Figure,unsigned Version)
+  {
+   extern const char *PrfRnk_FieldNames[PrfRnk_NUM_FIGURES];
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned long NumUsrs;
+   unsigned long NumUsr;
+   unsigned long Rank = 0;
+   unsigned NumUsrsInInsert = 0;
+   char PrevValue[PrfRnk_MAX_BYTES_VALUE + 1];
+   char *Query;
+   char *Ptr = NULL;
+   bool ClaimLost = false;
+
+   /***** Get users ordered by figure *****/
+   if (Figure == PrfRnk_CLICKS_PER_DAY)
+      NumUsrs = DB_QuerySELECT (&mysql_res,"can not get users' figures",
+				"SELECT UsrCod,"
+				"NumClicks/(DATEDIFF(NOW(),FirstClickTime)+1) AS Value"
+				" FROM usr_figures"
+				" WHERE NumClicks>0"
+				" AND FirstClickTime>FROM_UNIXTIME(0)"
+				" ORDER BY Value DESC,UsrCod");
+   else
+      NumUsrs = DB_QuerySELECT (&mysql_res,"can not get users' figures",
+				"SELECT UsrCod,%s"
+				" FROM usr_figures"
+				" WHERE %s>=0"
+				" ORDER BY %s DESC,UsrCod",
+				PrfRnk_FieldNames[Figure],
+				PrfRnk_FieldNames[Figure],
+				PrfRnk_FieldNames[Figure]);
+
+   /***** Allocate memory for query *****/
+   if ((Query = malloc (256 + PrfRnk_MAX_USRS_IN_INSERT *
+			      PrfRnk_MAX_BYTES_USR_IN_INSERT)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Insert users in batches,
+          computing ranks from the sorted list *****/
+   PrevValue[0] = '\0';
+   for (NumUsr = 1;
+	NumUsr <= NumUsrs && !ClaimLost;
+	NumUsr++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Users with the same value have the same rank */
+      if (strlen (row[1]) > PrfRnk_MAX_BYTES_VALUE)
+	 Lay_ShowErrorAndExit ("Wrong user's figure.");
+      if (strcmp (row[1],PrevValue))
+	{
+	 Rank = NumUsr;
+	 strcpy (PrevValue,row[1]);
+	}
+
+      /* Add user (row[0]) to query */
+      if (NumUsrsInInsert == 0)
+	 Ptr = Query + sprintf (Query,"INSERT INTO usr_ranks"
+				      " (Figure,Version,UsrCod,Value,Rnk,Pos)"
+				      " VALUES");
+      Ptr += sprintf (Ptr,"%s(%u,%u,%ld,%s,%lu,%lu)",
+		      NumUsrsInInsert ? "," :
+				        "",
+		      (unsigned) Figure,Version,
+		      Str_ConvertStrCodToLongCod (row[0]),
+		      PrevValue,Rank,NumUsr);
+      NumUsrsInInsert++;
+
+      /* Insert batch */
+      if (NumUsrsInInsert == PrfRnk_MAX_USRS_IN_INSERT ||
+	  NumUsr == NumUsrs)
+	{
+	 DB_QueryINSERT ("can not insert users in ranking","%s",Query);
+	 NumUsrsInInsert = 0;
+
+	 /* Stop if another process has taken the ranking */
+	 ClaimLost = !PrfRnk_RefreshMyClaim (Figure);
+	}
+     }
+
+   /***** Free memory used for query *****/
+   free (Query);
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Publish new version of the ranking
+          only if this process still holds the claim *****/
+   if (!ClaimLost)
+     {
+      DB_QueryUPDATE ("can not publish ranking",
+		      "UPDATE usr_rankings"
+		      " SET Version=%u,NumUsrs=%lu,"
+		      "BuildingToken='',UpdateTime=NOW()"
+		      " WHERE Figure=%u AND BuildingToken='%s'",
+		      Version,NumUsrs,
+		      (unsigned) Figure,
+		      Gbl.UniqueNameEncrypted);
+      ClaimLost = !mysql_affected_rows (&Gbl.mysql);
+     }
+
+   if (ClaimLost)
+      /***** Remove the rows inserted by this process.
+             No other process builds this version *****/
+      DB_QueryDELETE ("can not remove ranking",
+		      "DELETE FROM usr_ranks"
+		      " WHERE Figure=%u AND Version=%u",
+		      (unsigned) Figure,Version);
+   else
+      /***** Remove older versions of the ranking.
+             Greater versions may be being built by other processes *****/
+      DB_QueryDELETE ("can not remove ranking",
+		      "DELETE FROM usr_ranks"
+		      " WHERE Figure=%u AND Version<%u",
+		      (unsigned) Figure,Version);
+  }
+
+/*****************************************************************************/
+/**************** Get the version of a ranking and its users *****************/
+/*****************************************************************************/
+// Return 0 if the ranking has not been built yet
+
+static unsigned PrfRnk_GetVersion (PrfRnk_Figure_t Figure,unsigned long *NumUsrs)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned Version = 0;
+
+   *NumUsrs = 0;
+
+   /***** Get version of the ranking from database *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get ranking",
+		       "SELECT Version,NumUsrs FROM usr_rankings"
+		       " WHERE Figure=%u",
+		       (unsigned) Figure))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get version (row[0]) and number of users (row[1]) */
+      if (sscanf (row[0],"%u",&Version) != 1 ||
+	  sscanf (row[1],"%lu",NumUsrs) != 1)
+	 Lay_ShowErrorAndExit ("Error when getting ranking.");
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Version;
+  }
+
+/*****************************************************************************/
+/*********************** Get the rank of a user in a ranking *****************/
+/*****************************************************************************/
+// Return false if the ranking is not built or the user is not in it
+
+bool PrfRnk_GetRankOfUsr (PrfRnk_Figure_t Figure,long UsrCod,
+                          unsigned long *Rank,unsigned long *NumUsrs)
+  {
+   unsigned Version;
+
+   /***** Get current version of the ranking *****/
+   if ((Version = PrfRnk_GetVersion (Figure,NumUsrs)) == 0)
+      return false;
+
+   /***** Get rank of user *****/
+   *Rank = DB_QueryCOUNT ("can not get rank",
+			  "SELECT COALESCE(MIN(Rnk),0) FROM usr_ranks"
+			  " WHERE Figure=%u AND Version=%u AND UsrCod=%ld",
+			  (unsigned) Figure,Version,UsrCod);
+   return (*Rank != 0);
+  }
+
+/*****************************************************************************/
+/************ Get the users at the top of a ranking, without banned **********/
+/*****************************************************************************/
+// Return false if the ranking is not built
+
+bool PrfRnk_GetTopUsrs (MYSQL_RES **mysql_res,PrfRnk_Figure_t Figure,
+                        unsigned *NumUsrs)
+  {
+   unsigned long NumUsrsInRanking;
+   unsigned Version;
+
+   /***** Get current version of the ranking *****/
+   if ((Version = PrfRnk_GetVersion (Figure,&NumUsrsInRanking)) == 0)
+      return false;
+
+   /***** Get users in order of position *****/
+   *NumUsrs =
+   (unsigned) FigSnp_QuerySELECT (mysql_res,"can not get ranking",
+				  "SELECT UsrCod,%s FROM usr_ranks"
+				  " WHERE Figure=%u AND Version=%u"
+				  " AND Value>0"
+				  " AND UsrCod NOT IN (SELECT UsrCod FROM usr_banned)"
+				  " ORDER BY Pos LIMIT %u",
+				  Figure == PrfRnk_CLICKS_PER_DAY ? "Value" :
+								    "CAST(Value AS SIGNED)",
+				  (unsigned) Figure,Version,
+				  PrfRnk_MAX_USRS_IN_TOP);
+   return true;
+  }
+
+/*****************************************************************************/
+/********************* Remove a user from all rankings ***********************/
+/*****************************************************************************/
+
+void PrfRnk_RemoveUsrFromRankings (long UsrCod)
+  {
+   DB_QueryDELETE ("can not remove user from rankings",
+		   "DELETE FROM usr_ranks WHERE UsrCod=%ld",
+		   UsrCod);
+  }
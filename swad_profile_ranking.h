@@ -0,0 +1,61 @@
+// swad_profile_ranking.h: rankings of users' figures stored in database
+
+#ifndef _SWAD_PRF_RNK
+#define _SWAD_PRF_RNK
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+#include <mysql/mysql.h>	// To access MySQL databases
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+#define PrfRnk_NUM_FIGURES 6
+typedef enum
+  {
+   PrfRnk_CLICKS		= 0,
+   PrfRnk_CLICKS_PER_DAY	= 1,
+   PrfRnk_SOC_PUB		= 2,
+   PrfRnk_FILE_VIEWS		= 3,
+   PrfRnk_FOR_PST		= 4,
+   PrfRnk_MSG_SNT		= 5,
+  } PrfRnk_Figure_t;
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void PrfRnk_UpdateOldestRanking (void);
+
+bool PrfRnk_GetRankOfUsr (PrfRnk_Figure_t Figure,long UsrCod,
+                          unsigned long *Rank,unsigned long *NumUsrs);
+bool PrfRnk_GetTopUsrs (MYSQL_RES **mysql_res,PrfRnk_Figure_t Figure,
+                        unsigned *NumUsrs);
+
+void PrfRnk_RemoveUsrFromRankings (long UsrCod);
+
+#endif
@@ -59,6 +59,15 @@ extern struct Globals Gbl;
 #define Prg_MAX_CHARS_PROGRAM_ITEM_TITLE	(128 - 1)	// 127
 #define Prg_MAX_BYTES_PROGRAM_ITEM_TITLE	((Prg_MAX_CHARS_PROGRAM_ITEM_TITLE + 1) * Str_MAX_BYTES_PER_CHAR - 1)	// 2047
 
+/* Indexes of items are not consecutive.
+   A gap is left after each new item,
+   so a new item can usually be inserted between two items
+   without changing the indexes of the items after it */
+#define Prg_INDEX_GAP 1024
+
+#define Prg_MAX_BYTES_LOCK_NAME		(16 + Cns_MAX_DECIMAL_DIGITS_LONG)	// "swad_prg_crs_<CrsCod>"
+#define Prg_SECONDS_TO_WAIT_FOR_LOCK	5
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
@@ -109,6 +118,13 @@ struct ItemRange
    unsigned End;	// Index of the last item in the subtree
   };
 
+struct ItemTree
+  {
+   int PrevBrother;	// Number of previous brother in list (-1 if none)
+   int NextBrother;	// Number of next brother in list (-1 if none)
+   unsigned LastChild;	// Number of last item in subtree (the item itself if no children)
+  };
+
 struct Level
   {
    unsigned Number;	// Numbers for each level from 1 to maximum level
@@ -127,6 +143,7 @@ static struct
 			        // ...or it needs to be read?
       unsigned NumItems;	// Number of items
       struct ProgramItemHierarchy *Items;	// List of items
+      struct ItemTree *Tree;	// Brothers and subtree of each item in list
      } List;
    unsigned MaxLevel;		// Maximum level of items
    struct Level *Levels;	// Numbers and hidden for each level from 1 to maximum level
@@ -137,11 +154,26 @@ static struct
       .IsRead     = false,
       .NumItems   = 0,
       .Items      = NULL,
+      .Tree       = NULL,
      },
    .MaxLevel      = 0,
    .Levels        = NULL
   };
 
+static const char *Prg_HiddenSubQuery[Rol_NUM_ROLES] =
+  {
+   [Rol_UNK    ] = " AND Hidden='N'",
+   [Rol_GST    ] = " AND Hidden='N'",
+   [Rol_USR    ] = " AND Hidden='N'",
+   [Rol_STD    ] = " AND Hidden='N'",
+   [Rol_NET    ] = " AND Hidden='N'",
+   [Rol_TCH    ] = "",
+   [Rol_DEG_ADM] = " AND Hidden='N'",
+   [Rol_CTR_ADM] = " AND Hidden='N'",
+   [Rol_INS_ADM] = " AND Hidden='N'",
+   [Rol_SYS_ADM] = "",
+  };
+
 /*****************************************************************************/
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
@@ -156,6 +188,7 @@ static void Prg_PutIconToCreateNewItem (void);
 static void Prg_PutButtonToCreateNewItem (void);
 
 static void Prg_WriteRowItem (unsigned NumItem,struct ProgramItem *Item,
+			      char Txt[Cns_MAX_BYTES_TEXT + 1],
 			      bool PrintView);
 static void Prg_WriteRowWithItemForm (Prg_CreateOrChangeItem_t CreateOrChangeItem,
 			              long ItmCod,unsigned FormLevel);
@@ -174,7 +207,6 @@ static void Prg_WriteNumNewItem (unsigned Level);
 
 static void Prg_SetHiddenLevel (unsigned Level,bool Hidden);
 static bool Prg_GetHiddenLevel (unsigned Level);
-static bool Prg_CheckIfAnyHigherLevelIsHidden (unsigned CurrentLevel);
 
 static void Prg_PutFormsToRemEditOneItem (unsigned NumItem,
 					  struct ProgramItem *Item);
@@ -186,10 +218,12 @@ static bool Prg_CheckIfMoveRightIsAllowed (unsigned NumItem);
 static void Prg_PutParams (void *ItmCod);
 
 static void Prg_GetListItems (void);
+static void Prg_BuildTreeOfItems (void);
 static void Prg_GetDataOfItemByCod (struct ProgramItem *Item);
 static void Prg_GetDataOfItem (struct ProgramItem *Item,
                                MYSQL_RES **mysql_res,
 			       unsigned long NumRows);
+static void Prg_GetDataOfItemFromRow (struct ProgramItem *Item,MYSQL_ROW row);
 static void Prg_ResetItem (struct ProgramItem *Item);
 static void Prg_FreeListItems (void);
 static void Prg_GetItemTxtFromDB (long ItmCod,char Txt[Cns_MAX_BYTES_TEXT + 1]);
@@ -202,6 +236,9 @@ static void Prg_HideUnhideItem (char YN);
 
 static void Prg_MoveUpDownItem (Prg_MoveUpDown_t UpDown);
 static bool Prg_ExchangeItemRanges (int NumItemTop,int NumItemBottom);
+static void Prg_LockProgram (void);
+static void Prg_UnlockProgram (void);
+static void Prg_GetLockName (char LockName[Prg_MAX_BYTES_LOCK_NAME + 1]);
 static int Prg_GetPrevBrother (int NumItem);
 static int Prg_GetNextBrother (int NumItem);
 
@@ -257,8 +294,12 @@ static void Prg_ShowAllItems (Prg_CreateOrChangeItem_t CreateOrChangeItem,
   {
    extern const char *Hlp_COURSE_Program;
    extern const char *Txt_Course_program;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumRows;
    unsigned NumItem;
    struct ProgramItem Item;
+   char Txt[Cns_MAX_BYTES_TEXT + 1];
    static bool FirstTBodyOpen = false;
 
    /***** Create numbers and hidden levels *****/
@@ -280,14 +321,39 @@ static void Prg_ShowAllItems (Prg_CreateOrChangeItem_t CreateOrChangeItem,
    HTM_TBODY_Begin (NULL);		// 1st tbody start
    FirstTBodyOpen = true;
 
+   /***** Get data of all the program items in a single ordered query,
+          in the same order as the list of items *****/
+   NumRows = (unsigned)
+   DB_QuerySELECT (&mysql_res,"can not get program items",
+		   "SELECT ItmCod,"				// row[0]
+			  "ItmInd,"				// row[1]
+			  "Level,"				// row[2]
+			  "Hidden,"				// row[3]
+			  "UsrCod,"				// row[4]
+			  "UNIX_TIMESTAMP(StartTime),"		// row[5]
+			  "UNIX_TIMESTAMP(EndTime),"		// row[6]
+			  "NOW() BETWEEN StartTime AND EndTime,"	// row[7]
+			  "Title,"				// row[8]
+			  "Txt"					// row[9]
+		   " FROM prg_items"
+		   " WHERE CrsCod=%ld%s"
+		   " ORDER BY ItmInd",
+		   Gbl.Hierarchy.Crs.CrsCod,
+		   Prg_HiddenSubQuery[Gbl.Usrs.Me.Role.Logged]);
+
    /***** Write all the program items *****/
    for (NumItem = 0;
+	NumItem < NumRows &&
 	NumItem < Prg_Gbl.List.NumItems;
 	NumItem++)
      {
       /* Get data of this program item */
-      Item.Hierarchy.ItmCod = Prg_Gbl.List.Items[NumItem].ItmCod;
-      Prg_GetDataOfItemByCod (&Item);
+      row = mysql_fetch_row (mysql_res);
+      Prg_GetDataOfItemFromRow (&Item,row);
+
+      /* Get text of this program item (row[9]) */
+      Str_Copy (Txt,row[9],
+                Cns_MAX_BYTES_TEXT);
 
       /* Begin range to highlight? */
       if (Item.Hierarchy.Index == ToHighlight->Begin)	// Begin of the highlighted range
@@ -301,7 +367,7 @@ static void Prg_ShowAllItems (Prg_CreateOrChangeItem_t CreateOrChangeItem,
 	}
 
       /* Show item */
-      Prg_WriteRowItem (NumItem,&Item,false);	// Not print view
+      Prg_WriteRowItem (NumItem,&Item,Txt,false);	// Not print view
 
       /* Show form to create/change item */
       if (Item.Hierarchy.ItmCod == ItmCodBeforeForm)
@@ -330,6 +396,9 @@ static void Prg_ShowAllItems (Prg_CreateOrChangeItem_t CreateOrChangeItem,
       Gbl.RowEvenOdd = 1 - Gbl.RowEvenOdd;
      }
 
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
    /***** Create item at the end? *****/
    if (ItmCodBeforeForm <= 0 && CreateOrChangeItem == Prg_PUT_FORM_CREATE_ITEM)
       Prg_WriteRowWithItemForm (Prg_PUT_FORM_CREATE_ITEM,-1L,1);
@@ -408,6 +477,7 @@ static void Prg_PutButtonToCreateNewItem (void)
 /*****************************************************************************/
 
 static void Prg_WriteRowItem (unsigned NumItem,struct ProgramItem *Item,
+			      char Txt[Cns_MAX_BYTES_TEXT + 1],
 			      bool PrintView)
   {
    static unsigned UniqueId = 0;
@@ -417,14 +487,11 @@ static void Prg_WriteRowItem (unsigned NumItem,struct ProgramItem *Item,
    unsigned NumCol;
    char *TitleClass;
    Dat_StartEndTime_t StartEndTime;
-   char Txt[Cns_MAX_BYTES_TEXT + 1];
 
-   /***** Check if this item should be shown as hidden *****/
+   /***** Check if this item should be shown as hidden
+          (it's marked as hidden or any higher level is hidden) *****/
    Prg_SetHiddenLevel (Item->Hierarchy.Level,Item->Hierarchy.Hidden);
-   if (Item->Hierarchy.Hidden)	// this item is marked as hidden
-      LightStyle = true;
-   else				// this item is not marked as hidden
-      LightStyle = Prg_CheckIfAnyHigherLevelIsHidden (Item->Hierarchy.Level);
+   LightStyle = Prg_GetHiddenLevel (Item->Hierarchy.Level);
 
    /***** Title CSS class *****/
    Prg_SetTitleClass (&TitleClass,Item->Hierarchy.Level,LightStyle);
@@ -474,7 +541,6 @@ static void Prg_WriteRowItem (unsigned NumItem,struct ProgramItem *Item,
    HTM_DIV_End ();
 
    /* Text */
-   Prg_GetItemTxtFromDB (Item->Hierarchy.ItmCod,Txt);
    Str_ChangeFormat (Str_FROM_HTML,Str_TO_RIGOROUS_HTML,
                      Txt,Cns_MAX_BYTES_TEXT,false);	// Convert from HTML to recpectful HTML
    Str_InsertLinks (Txt,Cns_MAX_BYTES_TEXT,60);	// Insert links
@@ -730,11 +796,14 @@ static void Prg_WriteNumNewItem (unsigned Level)
 /*****************************************************************************/
 /********************** Set / Get if a level is hidden ***********************/
 /*****************************************************************************/
+// A level is hidden if its item is hidden or if the level above is hidden,
+// so hidden subtrees are computed in one pass over the list of items
 
 static void Prg_SetHiddenLevel (unsigned Level,bool Hidden)
   {
    if (Prg_Gbl.Levels)
-      Prg_Gbl.Levels[Level].Hidden = Hidden;
+      Prg_Gbl.Levels[Level].Hidden = Hidden ||
+				     Prg_Gbl.Levels[Level - 1].Hidden;	// Level 0 is never hidden
   }
 
 static bool Prg_GetHiddenLevel (unsigned Level)
@@ -745,23 +814,6 @@ static bool Prg_GetHiddenLevel (unsigned Level)
    return false;
   }
 
-/*****************************************************************************/
-/********* Check if any level higher than the current one is hidden **********/
-/*****************************************************************************/
-
-static bool Prg_CheckIfAnyHigherLevelIsHidden (unsigned CurrentLevel)
-  {
-   unsigned Level;
-
-   for (Level = 1;
-	Level < CurrentLevel;
-	Level++)
-      if (Prg_GetHiddenLevel (Level))	// Hidden?
-         return true;
-
-   return false;	// None is hidden. All are visible.
-  }
-
 /*****************************************************************************/
 /**************** Put a link (form) to edit one program item *****************/
 /*****************************************************************************/
@@ -778,9 +830,10 @@ static void Prg_PutFormsToRemEditOneItem (unsigned NumItem,
    char StrItemIndex[Cns_MAX_DECIMAL_DIGITS_UINT + 1];
 
    /***** Initialize item index string *****/
+   // Indexes in database are not consecutive, so the position in list is used
    snprintf (StrItemIndex,sizeof (StrItemIndex),
 	     "%u",
-	     Item->Hierarchy.Index);
+	     NumItem + 1);
 
    switch (Gbl.Usrs.Me.Role.Logged)
      {
@@ -891,26 +944,8 @@ static bool Prg_CheckIfMoveUpIsAllowed (unsigned NumItem)
 
 static bool Prg_CheckIfMoveDownIsAllowed (unsigned NumItem)
   {
-   unsigned i;
-   unsigned Level;
-
-   /***** Trivial check: if item is the last one, move up is not allowed *****/
-   if (NumItem >= Prg_Gbl.List.NumItems - 1)
-      return false;
-
    /***** Move down is allowed if the item has brothers after it *****/
-   // NumItem + 1 < Prg_Gbl.List.NumItems
-   Level = Prg_Gbl.List.Items[NumItem].Level;
-   for (i = NumItem + 1;
-	i < Prg_Gbl.List.NumItems;
-	i++)
-     {
-      if (Prg_Gbl.List.Items[i].Level == Level)
-	 return true;	// Next brother found
-      if (Prg_Gbl.List.Items[i].Level < Level)
-	 return false;	// Next lower level found ==> there are no more brothers
-     }
-   return false;	// End reached ==> there are no more brothers
+   return Prg_GetNextBrother ((int) NumItem) >= 0;
   }
 
 /*****************************************************************************/
@@ -956,19 +991,6 @@ static void Prg_PutParams (void *ItmCod)
 
 static void Prg_GetListItems (void)
   {
-   static const char *HiddenSubQuery[Rol_NUM_ROLES] =
-     {
-      [Rol_UNK    ] = " AND Hidden='N'",
-      [Rol_GST    ] = " AND Hidden='N'",
-      [Rol_USR    ] = " AND Hidden='N'",
-      [Rol_STD    ] = " AND Hidden='N'",
-      [Rol_NET    ] = " AND Hidden='N'",
-      [Rol_TCH    ] = "",
-      [Rol_DEG_ADM] = " AND Hidden='N'",
-      [Rol_CTR_ADM] = " AND Hidden='N'",
-      [Rol_INS_ADM] = " AND Hidden='N'",
-      [Rol_SYS_ADM] = "",
-     };
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
    unsigned NumItem;
@@ -987,7 +1009,7 @@ static void Prg_GetListItems (void)
 			      " WHERE CrsCod=%ld%s"
 			      " ORDER BY ItmInd",
 			      Gbl.Hierarchy.Crs.CrsCod,
-			      HiddenSubQuery[Gbl.Usrs.Me.Role.Logged]);
+			      Prg_HiddenSubQuery[Gbl.Usrs.Me.Role.Logged]);
 
    if (Prg_Gbl.List.NumItems) // Items found...
      {
@@ -1018,6 +1040,9 @@ static void Prg_GetListItems (void)
 	 /* Get whether the program item is hidden or not (row[3]) */
 	 Prg_Gbl.List.Items[NumItem].Hidden = (row[3][0] == 'Y');
         }
+
+      /***** Get brothers and subtree of each item *****/
+      Prg_BuildTreeOfItems ();
      }
 
    /***** Free structure that stores the query result *****/
@@ -1026,6 +1051,69 @@ static void Prg_GetListItems (void)
    Prg_Gbl.List.IsRead = true;
   }
 
+/*****************************************************************************/
+/*************** Get brothers and subtree of each item in list ***************/
+/*****************************************************************************/
+/*
+   Items are in preorder, so the subtree of an item
+   is the range from the item to its last child.
+   A stack with the items whose subtrees are not closed yet
+   is used to get brothers and last children in one pass over the list.
+   After that, moving or removing a subtree does not need to scan the list.
+*/
+
+static void Prg_BuildTreeOfItems (void)
+  {
+   unsigned *Stack;
+   unsigned NumItemsInStack = 0;
+   unsigned NumItem;
+   unsigned NumItemInStack;
+   int PrevBrother;
+
+   /***** Allocate memory for tree and stack *****/
+   if ((Prg_Gbl.List.Tree =
+	(struct ItemTree *) calloc ((size_t) Prg_Gbl.List.NumItems,
+				    sizeof (struct ItemTree))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   if ((Stack = (unsigned *) malloc ((size_t) Prg_Gbl.List.NumItems *
+				     sizeof (unsigned))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   for (NumItem = 0;
+	NumItem < Prg_Gbl.List.NumItems;
+	NumItem++)
+     {
+      /***** Close subtrees of items in the same or lower levels *****/
+      PrevBrother = -1;
+      while (NumItemsInStack &&
+	     Prg_Gbl.List.Items[Stack[NumItemsInStack - 1]].Level >=
+	     Prg_Gbl.List.Items[NumItem].Level)
+	{
+	 NumItemInStack = Stack[--NumItemsInStack];
+	 Prg_Gbl.List.Tree[NumItemInStack].LastChild = NumItem - 1;
+	 if (Prg_Gbl.List.Items[NumItemInStack].Level ==
+	     Prg_Gbl.List.Items[NumItem].Level)
+	    PrevBrother = (int) NumItemInStack;
+	}
+
+      /***** Link item with its previous brother *****/
+      Prg_Gbl.List.Tree[NumItem].PrevBrother = PrevBrother;
+      Prg_Gbl.List.Tree[NumItem].NextBrother = -1;
+      if (PrevBrother >= 0)
+	 Prg_Gbl.List.Tree[PrevBrother].NextBrother = (int) NumItem;
+
+      /***** Open subtree of this item *****/
+      Stack[NumItemsInStack++] = NumItem;
+     }
+
+   /***** Close subtrees of items not closed *****/
+   while (NumItemsInStack)
+      Prg_Gbl.List.Tree[Stack[--NumItemsInStack]].LastChild = Prg_Gbl.List.NumItems - 1;
+
+   /***** Free stack *****/
+   free (Stack);
+  }
+
 /*****************************************************************************/
 /****************** Get program item data using its code *********************/
 /*****************************************************************************/
@@ -1079,49 +1167,58 @@ static void Prg_GetDataOfItem (struct ProgramItem *Item,
      {
       /* Get row */
       row = mysql_fetch_row (*mysql_res);
-      /*
-      ItmCod					row[0]
-      ItmInd					row[1]
-      Level					row[2]
-      Hidden					row[3]
-      UsrCod					row[4]
-      UNIX_TIMESTAMP(StartTime)			row[5]
-      UNIX_TIMESTAMP(EndTime)			row[6]
-      NOW() BETWEEN StartTime AND EndTime	row[7]
-      Title					row[8]
-      */
+      Prg_GetDataOfItemFromRow (Item,row);
+     }
 
-      /* Get code of the program item (row[0]) */
-      Item->Hierarchy.ItmCod = Str_ConvertStrCodToLongCod (row[0]);
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (mysql_res);
+  }
 
-      /* Get index of the program item (row[1]) */
-      Item->Hierarchy.Index = Str_ConvertStrToUnsigned (row[1]);
+/*****************************************************************************/
+/********************* Get program item data from a row **********************/
+/*****************************************************************************/
 
-      /* Get level of the program item (row[2]) */
-      Item->Hierarchy.Level = Str_ConvertStrToUnsigned (row[2]);
+static void Prg_GetDataOfItemFromRow (struct ProgramItem *Item,MYSQL_ROW row)
+  {
+   /*
+   ItmCod					row[0]
+   ItmInd					row[1]
+   Level					row[2]
+   Hidden					row[3]
+   UsrCod					row[4]
+   UNIX_TIMESTAMP(StartTime)			row[5]
+   UNIX_TIMESTAMP(EndTime)			row[6]
+   NOW() BETWEEN StartTime AND EndTime	row[7]
+   Title					row[8]
+   */
 
-      /* Get whether the program item is hidden or not (row[3]) */
-      Item->Hierarchy.Hidden = (row[3][0] == 'Y');
+   /* Get code of the program item (row[0]) */
+   Item->Hierarchy.ItmCod = Str_ConvertStrCodToLongCod (row[0]);
 
-      /* Get author of the program item (row[4]) */
-      Item->UsrCod = Str_ConvertStrCodToLongCod (row[4]);
+   /* Get index of the program item (row[1]) */
+   Item->Hierarchy.Index = Str_ConvertStrToUnsigned (row[1]);
 
-      /* Get start date (row[5] holds the start UTC time) */
-      Item->TimeUTC[Dat_START_TIME] = Dat_GetUNIXTimeFromStr (row[5]);
+   /* Get level of the program item (row[2]) */
+   Item->Hierarchy.Level = Str_ConvertStrToUnsigned (row[2]);
 
-      /* Get end date   (row[6] holds the end   UTC time) */
-      Item->TimeUTC[Dat_END_TIME  ] = Dat_GetUNIXTimeFromStr (row[6]);
+   /* Get whether the program item is hidden or not (row[3]) */
+   Item->Hierarchy.Hidden = (row[3][0] == 'Y');
 
-      /* Get whether the program item is open or closed (row(7)) */
-      Item->Open = (row[7][0] == '1');
+   /* Get author of the program item (row[4]) */
+   Item->UsrCod = Str_ConvertStrCodToLongCod (row[4]);
 
-      /* Get the title of the program item (row[8]) */
-      Str_Copy (Item->Title,row[8],
-                Prg_MAX_BYTES_PROGRAM_ITEM_TITLE);
-     }
+   /* Get start date (row[5] holds the start UTC time) */
+   Item->TimeUTC[Dat_START_TIME] = Dat_GetUNIXTimeFromStr (row[5]);
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (mysql_res);
+   /* Get end date   (row[6] holds the end   UTC time) */
+   Item->TimeUTC[Dat_END_TIME  ] = Dat_GetUNIXTimeFromStr (row[6]);
+
+   /* Get whether the program item is open or closed (row(7)) */
+   Item->Open = (row[7][0] == '1');
+
+   /* Get the title of the program item (row[8]) */
+   Str_Copy (Item->Title,row[8],
+             Prg_MAX_BYTES_PROGRAM_ITEM_TITLE);
   }
 
 /*****************************************************************************/
@@ -1152,6 +1249,11 @@ static void Prg_FreeListItems (void)
       /***** Free memory used by the list of program items *****/
       free (Prg_Gbl.List.Items);
       Prg_Gbl.List.Items = NULL;
+      if (Prg_Gbl.List.Tree)
+	{
+	 free (Prg_Gbl.List.Tree);
+	 Prg_Gbl.List.Tree = NULL;
+	}
       Prg_Gbl.List.NumItems = 0;
       Prg_Gbl.List.IsRead = false;
      }
@@ -1390,6 +1492,10 @@ static void Prg_MoveUpDownItem (Prg_MoveUpDown_t UpDown)
       [Prg_MOVE_DOWN] = Prg_CheckIfMoveDownIsAllowed,
      };
 
+   /***** Lock program to make the move atomic *****/
+   // The list of items must be got after locking the program
+   Prg_LockProgram ();
+
    /***** Get list of program items *****/
    Prg_GetListItems ();
 
@@ -1414,6 +1520,10 @@ static void Prg_MoveUpDownItem (Prg_MoveUpDown_t UpDown)
             break;
         }
      }
+
+   /***** Commit changes and unlock program *****/
+   Prg_UnlockProgram ();
+
    if (Success)
      {
       /* Update list of program items */
@@ -1455,11 +1565,6 @@ static bool Prg_ExchangeItemRanges (int NumItemTop,int NumItemBottom)
       DiffBegin = Bottom.Begin - Top.Begin;
       DiffEnd   = Bottom.End   - Top.End;
 
-      /***** Lock table to make the move atomic *****/
-      DB_Query ("can not lock tables to move program item",
-		"LOCK TABLES prg_items WRITE");
-      Gbl.DB.LockedTables = true;
-
       /***** Exchange indexes of items *****/
       // This implementation works with non continuous indexes
       /*
@@ -1511,18 +1616,53 @@ Bottom.End:   |    49|   222|-->|-->-49|   222|   |   -49|   222|-->|--> 26|   2
 		      Gbl.Hierarchy.Crs.CrsCod,
 		      Bottom.End,Bottom.Begin);		// All indexes in bottom part
 
-      /***** Unlock table *****/
-      Gbl.DB.LockedTables = false;	// Set to false before the following unlock...
-				   // ...to not retry the unlock if error in unlocking
-      DB_Query ("can not unlock tables after moving items",
-		"UNLOCK TABLES");
-
       return true;	// Success
      }
 
    return false;	// No success
   }
 
+/*****************************************************************************/
+/*************** Lock program of current course to change it *****************/
+/*****************************************************************************/
+// A named lock of the course is got before starting the transaction,
+// so programs of other courses can be changed at the same time
+
+static void Prg_LockProgram (void)
+  {
+   char LockName[Prg_MAX_BYTES_LOCK_NAME + 1];
+
+   Prg_GetLockName (LockName);
+   if (!DB_WaitForNamedLock (LockName,Prg_SECONDS_TO_WAIT_FOR_LOCK))
+      Lay_ShowErrorAndExit ("The program is being changed by another user."
+			    " Please try again.");
+   DB_StartTransaction ();
+  }
+
+/*****************************************************************************/
+/*********** Commit changes and unlock program of current course *************/
+/*****************************************************************************/
+
+static void Prg_UnlockProgram (void)
+  {
+   char LockName[Prg_MAX_BYTES_LOCK_NAME + 1];
+
+   DB_CommitTransaction ();
+   Prg_GetLockName (LockName);
+   DB_ReleaseNamedLock (LockName);
+  }
+
+/*****************************************************************************/
+/************** Get name of the lock of program of current course ************/
+/*****************************************************************************/
+
+static void Prg_GetLockName (char LockName[Prg_MAX_BYTES_LOCK_NAME + 1])
+  {
+   snprintf (LockName,Prg_MAX_BYTES_LOCK_NAME + 1,
+	     "swad_prg_crs_%ld",
+	     Gbl.Hierarchy.Crs.CrsCod);
+  }
+
 /*****************************************************************************/
 /******** Get previous brother item to a given item in current course ********/
 /*****************************************************************************/
@@ -1530,9 +1670,6 @@ Bottom.End:   |    49|   222|-->|-->-49|   222|   |   -49|   222|-->|--> 26|   2
 
 static int Prg_GetPrevBrother (int NumItem)
   {
-   unsigned Level;
-   int i;
-
    /***** Trivial check: if item is the first one, there is no previous brother *****/
    if (NumItem <= 0 ||
        NumItem >= (int) Prg_Gbl.List.NumItems)
@@ -1540,17 +1677,7 @@ static int Prg_GetPrevBrother (int NumItem)
 
    /***** Get previous brother before item *****/
    // 1 <= NumItem < Prg_Gbl.List.NumItems
-   Level = Prg_Gbl.List.Items[NumItem].Level;
-   for (i  = NumItem - 1;
-	i >= 0;
-	i--)
-     {
-      if (Prg_Gbl.List.Items[i].Level == Level)
-	 return i;	// Previous brother before item found
-      if (Prg_Gbl.List.Items[i].Level < Level)
-	 return -1;		// Previous lower level found ==> there are no brothers before item
-     }
-   return -1;	// Start reached ==> there are no brothers before item
+   return Prg_Gbl.List.Tree[NumItem].PrevBrother;
   }
 
 /*****************************************************************************/
@@ -1560,9 +1687,6 @@ static int Prg_GetPrevBrother (int NumItem)
 
 static int Prg_GetNextBrother (int NumItem)
   {
-   unsigned Level;
-   int i;
-
    /***** Trivial check: if item is the last one, there is no next brother *****/
    if (NumItem < 0 ||
        NumItem >= (int) Prg_Gbl.List.NumItems - 1)
@@ -1570,17 +1694,7 @@ static int Prg_GetNextBrother (int NumItem)
 
    /***** Get next brother after item *****/
    // 0 <= NumItem < Prg_Gbl.List.NumItems - 1
-   Level = Prg_Gbl.List.Items[NumItem].Level;
-   for (i = NumItem + 1;
-	i < (int) Prg_Gbl.List.NumItems;
-	i++)
-     {
-      if (Prg_Gbl.List.Items[i].Level == Level)
-	 return i;	// Next brother found
-      if (Prg_Gbl.List.Items[i].Level < Level)
-	 return -1;	// Next lower level found ==> there are no brothers after item
-     }
-   return -1;	// End reached ==> there are no brothers after item
+   return Prg_Gbl.List.Tree[NumItem].NextBrother;
   }
 
 /*****************************************************************************/
@@ -1710,25 +1824,14 @@ static void Prg_SetItemRangeWithAllChildren (unsigned NumItem,struct ItemRange *
 
 static unsigned Prg_GetLastChild (int NumItem)
   {
-   unsigned Level;
-   int i;
-
    /***** Trivial check: if item is wrong, there are no children *****/
    if (NumItem < 0 ||
        NumItem >= (int) Prg_Gbl.List.NumItems)
       Lay_ShowErrorAndExit ("Wrong number of item.");
 
-   /***** Get next brother after item *****/
+   /***** Get last child of item *****/
    // 0 <= NumItem < Prg_Gbl.List.NumItems
-   Level = Prg_Gbl.List.Items[NumItem].Level;
-   for (i = NumItem + 1;
-	i < (int) Prg_Gbl.List.NumItems;
-	i++)
-     {
-      if (Prg_Gbl.List.Items[i].Level <= Level)
-	 return i - 1;	// Last child found
-     }
-   return Prg_Gbl.List.NumItems - 1;	// End reached ==> all items after the given item are its children
+   return Prg_Gbl.List.Tree[NumItem].LastChild;
   }
 
 /*****************************************************************************/
@@ -2058,11 +2161,11 @@ static void Prg_InsertItem (const struct ProgramItem *ParentItem,
 		            struct ProgramItem *Item,const char *Txt)
   {
    unsigned NumItemLastChild;
+   unsigned IndexBefore;
+   unsigned IndexAfter;
 
-   /***** Lock table to create program item *****/
-   DB_Query ("can not lock tables to create program item",
-	     "LOCK TABLES prg_items WRITE");
-   Gbl.DB.LockedTables = true;
+   /***** Lock program to create program item *****/
+   Prg_LockProgram ();
 
    /***** Get list of program items *****/
    Prg_GetListItems ();
@@ -2074,21 +2177,31 @@ static void Prg_InsertItem (const struct ProgramItem *ParentItem,
 	 NumItemLastChild = Prg_GetLastChild (Prg_GetNumItemFromItmCod (ParentItem->Hierarchy.ItmCod));
 	 if (NumItemLastChild < Prg_Gbl.List.NumItems - 1)
 	   {
-	    /***** New program item will be inserted after last child of parent *****/
-	    Item->Hierarchy.Index = Prg_Gbl.List.Items[NumItemLastChild + 1].Index;
-
-	    /***** Move down all indexes of after last child of parent *****/
-	    DB_QueryUPDATE ("can not move down items",
-			    "UPDATE prg_items SET ItmInd=ItmInd+1"
-			    " WHERE CrsCod=%ld"
-			    " AND ItmInd>=%u"
-			    " ORDER BY ItmInd DESC",	// Necessary to not create duplicate key (CrsCod,ItmInd)
-			    Gbl.Hierarchy.Crs.CrsCod,
-			    Item->Hierarchy.Index);
+	    /***** New program item will be inserted after last child of parent,
+	           between its index and the index of the next item *****/
+	    IndexBefore = Prg_Gbl.List.Items[NumItemLastChild    ].Index;
+	    IndexAfter  = Prg_Gbl.List.Items[NumItemLastChild + 1].Index;
+
+	    /***** Only if there is no free index between them,
+	           move down all indexes after last child of parent *****/
+	    if (IndexAfter - IndexBefore < 2)
+	      {
+	       DB_QueryUPDATE ("can not move down items",
+			       "UPDATE prg_items SET ItmInd=ItmInd+%u"
+			       " WHERE CrsCod=%ld"
+			       " AND ItmInd>=%u"
+			       " ORDER BY ItmInd DESC",	// Necessary to not create duplicate key (CrsCod,ItmInd)
+			       Prg_INDEX_GAP,
+			       Gbl.Hierarchy.Crs.CrsCod,
+			       IndexAfter);
+	       IndexAfter += Prg_INDEX_GAP;
+	      }
+
+	    Item->Hierarchy.Index = IndexBefore + (IndexAfter - IndexBefore) / 2;
 	   }
 	 else
 	    /***** New program item will be inserted at the end *****/
-	    Item->Hierarchy.Index = Prg_Gbl.List.Items[Prg_Gbl.List.NumItems - 1].Index + 1;
+	    Item->Hierarchy.Index = Prg_Gbl.List.Items[Prg_Gbl.List.NumItems - 1].Index + Prg_INDEX_GAP;
 
 	 /***** Child ==> parent level + 1 *****/
          Item->Hierarchy.Level = ParentItem->Hierarchy.Level + 1;
@@ -2096,7 +2209,7 @@ static void Prg_InsertItem (const struct ProgramItem *ParentItem,
       else	// No parent specified
 	{
 	 /***** New program item will be inserted at the end *****/
-	 Item->Hierarchy.Index = Prg_Gbl.List.Items[Prg_Gbl.List.NumItems - 1].Index + 1;
+	 Item->Hierarchy.Index = Prg_Gbl.List.Items[Prg_Gbl.List.NumItems - 1].Index + Prg_INDEX_GAP;
 
 	 /***** First level *****/
          Item->Hierarchy.Level = 1;
@@ -2105,7 +2218,7 @@ static void Prg_InsertItem (const struct ProgramItem *ParentItem,
    else		// There are no items
      {
       /***** New program item will be inserted as the first one *****/
-      Item->Hierarchy.Index = 1;
+      Item->Hierarchy.Index = Prg_INDEX_GAP;
 
       /***** First level *****/
       Item->Hierarchy.Level = 1;
@@ -2114,11 +2227,8 @@ static void Prg_InsertItem (const struct ProgramItem *ParentItem,
    /***** Insert new program item *****/
    Item->Hierarchy.ItmCod = Prg_InsertItemIntoDB (Item,Txt);
 
-   /***** Unlock table *****/
-   Gbl.DB.LockedTables = false;	// Set to false before the following unlock...
-				// ...to not retry the unlock if error in unlocking
-   DB_Query ("can not unlock tables after moving items",
-	     "UNLOCK TABLES");
+   /***** Commit changes and unlock program *****/
+   Prg_UnlockProgram ();
 
    /***** Free list items *****/
    Prg_FreeListItems ();
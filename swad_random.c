@@ -0,0 +1,171 @@
+// swad_random.c: random numbers and samples got with a seeded generator
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdint.h>		// For uint64_t
+#include <stdlib.h>		// For malloc
+#include <sys/time.h>		// For gettimeofday
+#include <unistd.h>		// For getpid
+
+#include "swad_layout.h"
+#include "swad_random.h"
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Random samples are drawn here instead of using ORDER BY RAND() in database,
+   that sorts all the candidate rows each time.
+   Only the codes of the candidates are got from database,
+   in a fixed order, and the sample is drawn from them.
+   The generator (SplitMix64) gives the same sequence on every system
+   for the same seed, so a sample can be drawn again from its seed.
+*/
+#define Rnd_GOLDEN_GAMMA 0x9E3779B97F4A7C15ULL
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static uint64_t Rnd_GetNext (struct Rnd_Generator *Generator);
+
+/*****************************************************************************/
+/*************************** Set seed of generator ***************************/
+/*****************************************************************************/
+// The same seed produces the same sequence of random numbers
+
+void Rnd_SetSeed (struct Rnd_Generator *Generator,long Seed)
+  {
+   Generator->State = (uint64_t) Seed;
+  }
+
+/*****************************************************************************/
+/********************** Add a value to seed of generator *********************/
+/*****************************************************************************/
+// Used to build a seed from several codes (for example session, user and set)
+
+void Rnd_AddToSeed (struct Rnd_Generator *Generator,long Value)
+  {
+   Generator->State = Rnd_GetNext (Generator) ^ (uint64_t) Value;
+  }
+
+/*****************************************************************************/
+/***************** Set a seed different in each execution ********************/
+/*****************************************************************************/
+
+void Rnd_SetRandomSeed (struct Rnd_Generator *Generator)
+  {
+   struct timeval tv;
+
+   gettimeofday (&tv,NULL);
+   Rnd_SetSeed (Generator,(long) tv.tv_sec);
+   Rnd_AddToSeed (Generator,(long) tv.tv_usec);
+   Rnd_AddToSeed (Generator,(long) getpid ());
+  }
+
+/*****************************************************************************/
+/************** Get a random number between 0 and Num - 1 ********************/
+/*****************************************************************************/
+
+unsigned long Rnd_GetNumLessThan (struct Rnd_Generator *Generator,
+                                  unsigned long Num)
+  {
+   uint64_t Limit;
+   uint64_t Random;
+
+   if (Num <= 1)
+      return 0;
+
+   /***** Reject numbers beyond the greatest multiple of Num
+          so that all the results are equally probable *****/
+   Limit = UINT64_MAX - UINT64_MAX % (uint64_t) Num;
+   do
+      Random = Rnd_GetNext (Generator);
+   while (Random >= Limit);
+
+   return (unsigned long) (Random % (uint64_t) Num);
+  }
+
+/*****************************************************************************/
+/********* Get a random sample of items from a list of items *****************/
+/*****************************************************************************/
+// Items are numbered from 0 to NumItems - 1.
+// Return the number of items in the sample
+// (NumItemsInSample or NumItems if there are fewer items).
+// Indexes of sampled items are returned in random order
+// and must be freed by the caller
+
+unsigned long Rnd_GetSample (struct Rnd_Generator *Generator,
+                             unsigned long NumItems,
+                             unsigned long NumItemsInSample,
+                             unsigned long **Indexes)
+  {
+   unsigned long NumItem;
+   unsigned long RandomItem;
+   unsigned long Index;
+
+   *Indexes = NULL;
+   if (NumItemsInSample > NumItems)
+      NumItemsInSample = NumItems;
+   if (!NumItemsInSample)
+      return 0;
+
+   /***** Allocate list of indexes *****/
+   if ((*Indexes = (unsigned long *) malloc (NumItems * sizeof (unsigned long))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   for (NumItem = 0;
+	NumItem < NumItems;
+	NumItem++)
+      (*Indexes)[NumItem] = NumItem;
+
+   /***** Shuffle only the first items (Fisher-Yates) *****/
+   for (NumItem = 0;
+	NumItem < NumItemsInSample;
+	NumItem++)
+     {
+      RandomItem = NumItem + Rnd_GetNumLessThan (Generator,NumItems - NumItem);
+      Index                  = (*Indexes)[NumItem];
+      (*Indexes)[NumItem]    = (*Indexes)[RandomItem];
+      (*Indexes)[RandomItem] = Index;
+     }
+
+   return NumItemsInSample;
+  }
+
+/*****************************************************************************/
+/*************************** Get next random number **************************/
+/*****************************************************************************/
+
+static uint64_t Rnd_GetNext (struct Rnd_Generator *Generator)
+  {
+   uint64_t z;
+
+   z = (Generator->State += Rnd_GOLDEN_GAMMA);
+   z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+   z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+   return z ^ (z >> 31);
+  }
@@ -0,0 +1,56 @@
+// swad_random.h: random numbers and samples got with a seeded generator
+
+#ifndef _SWAD_RND
+#define _SWAD_RND
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdint.h>		// For uint64_t
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+struct Rnd_Generator
+  {
+   uint64_t State;
+  };
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void Rnd_SetSeed (struct Rnd_Generator *Generator,long Seed);
+void Rnd_AddToSeed (struct Rnd_Generator *Generator,long Value);
+void Rnd_SetRandomSeed (struct Rnd_Generator *Generator);
+
+unsigned long Rnd_GetNumLessThan (struct Rnd_Generator *Generator,
+                                  unsigned long Num);
+unsigned long Rnd_GetSample (struct Rnd_Generator *Generator,
+                             unsigned long NumItems,
+                             unsigned long NumItemsInSample,
+                             unsigned long **Indexes);
+
+#endif
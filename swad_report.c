@@ -25,18 +25,25 @@
 /*********************************** Headers *********************************/
 /*****************************************************************************/
 
+#include <stdio.h>		// For snprintf, sprintf
 #include <stdlib.h>		// For free
+#include <string.h>		// For strcmp
 #include <sys/stat.h>		// For mkdir
 #include <sys/types.h>		// For mkdir
+#include <time.h>		// For time
 
+#include "swad_alert.h"
 #include "swad_box.h"
 #include "swad_database.h"
 #include "swad_form.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_ID.h"
+#include "swad_log_archive.h"
+#include "swad_log_column.h"
 #include "swad_profile.h"
 #include "swad_tab.h"
+#include "swad_worker.h"
 
 /*****************************************************************************/
 /****************************** Public constants *****************************/
@@ -52,6 +59,11 @@
 #define Rep_MAX_ACTIONS	    50  // Maximum number of actions in list of frequent actions
 #define Rep_MAX_BAR_WIDTH 50	// Maximum width of graphic bar
 
+// Clicks in log are counted per hour in UTC, and then hours are grouped by year,
+// so the year in UTC is computed once per hour, not once per click
+#define Rep_HOUR_UTC_OF_CLICK "UNIX_TIMESTAMP(ClickTime) DIV 3600"
+#define Rep_YEAR_UTC_FROM_HOUR "YEAR(DATE_ADD('1970-01-01',INTERVAL HourUTC*3600 SECOND))"
+
 // #define Rep_BLOCK "&boxH;"	// HTML code for a block in graphic bar
 // #define Rep_BLOCK "&blk12;"	// HTML code for a block in graphic bar
 // #define Rep_BLOCK "&block;"	// HTML code for a block in graphic bar
@@ -60,6 +72,11 @@
 // #define Rep_BLOCK "&squf;"	// HTML code for a block in graphic bar
 #define Rep_BLOCK "-"
 
+#define Rep_MAX_RUNNING_JOBS			 4	// Maximum number of reports being generated at the same time
+#define Rep_MAX_SECONDS_WITHOUT_PROGRESS	(15 * 60)	// A running job not updated for this time is considered dead
+#define Rep_SECONDS_TO_REFRESH_JOB		 5	// Time to reload the page while my report is being generated
+#define Rep_SECONDS_BETWEEN_HEARTBEATS		60	// A running job is updated at least with this period
+
 /*****************************************************************************/
 /****************************** Private types ********************************/
 /*****************************************************************************/
@@ -78,14 +95,35 @@ struct Rep_Hits
    unsigned long Max;
   };
 
+typedef enum
+  {
+   Rep_JOB_NONE,	// There is no job for me
+   Rep_JOB_PENDING,	// Waiting for a worker
+   Rep_JOB_RUNNING,	// Being generated by a worker process
+   Rep_JOB_DONE,	// Report generated
+   Rep_JOB_FAILED,	// The worker process exited on error
+  } Rep_JobStatus_t;
+#define Rep_NUM_JOB_STATUS 5
+
+struct Rep_Job
+  {
+   Rep_JobStatus_t Status;
+   unsigned Progress;	// 0 to 100
+   long LastLogCod;	// Last click in log when the report was generated
+   long RepCod;		// Generated report
+  };
+
 struct Rep_Report
   {
+   long RepCod;
    struct UsrFigures UsrFigures;
    struct tm tm_FirstClickTime;
    struct tm tm_CurrentTime;
    struct Rep_CurrentTimeUTC CurrentTimeUTC;
    struct Rep_Hits Hits;
    unsigned long MaxHitsPerYear;
+   time_t StartTimeInLogUTC;	// My clicks before this time are got from columns of log
+   char *LogTable;		// Table with my clicks, including archives of log
    char FilenameReport[NAME_MAX + 1];
    char Permalink[Cns_MAX_BYTES_WWW + 1];
   };
@@ -100,10 +138,31 @@ extern struct Globals Gbl;
 /************************* Private global variables **************************/
 /*****************************************************************************/
 
+static const char *Rep_JobStatusDB[Rep_NUM_JOB_STATUS] =
+  {
+   [Rep_JOB_NONE   ] = "",
+   [Rep_JOB_PENDING] = "pending",
+   [Rep_JOB_RUNNING] = "running",
+   [Rep_JOB_DONE   ] = "done",
+   [Rep_JOB_FAILED ] = "failed",
+  };
+
 /*****************************************************************************/
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
 
+static void Rep_GetMyJob (struct Rep_Job *Job);
+static bool Rep_CheckIfMyReportIsUpToDate (const struct Rep_Job *Job,
+                                           struct Rep_Report *Report);
+static void Rep_QueueMyJob (struct Rep_Job *Job);
+static void Rep_StartWorkerIfPossible (struct Rep_Job *Job);
+static void Rep_RunMyJob (void);
+static void Rep_SetMyJobAsFailed (void);
+static long Rep_GetLastLogCod (void);
+static void Rep_UpdateMyJobProgress (unsigned Progress);
+static void Rep_HeartBeatMyJob (void);
+static void Rep_ShowProgressOfMyJob (const struct Rep_Job *Job);
+
 static void Rep_CreateMyUsageReport (struct Rep_Report *Report);
 static void Rep_PutLinkToMyUsageReport (struct Rep_Report *Report);
 static void Rep_TitleReport (struct Rep_CurrentTimeUTC *CurrentTimeUTC);
@@ -111,7 +170,8 @@ static void Rep_TitleReport (struct Rep_CurrentTimeUTC *CurrentTimeUTC);
 static void Rep_GetCurrentDateTimeUTC (struct Rep_Report *Report);
 
 static void Rep_CreateNewReportFile (struct Rep_Report *Report);
-static void Rep_CreateNewReportEntryIntoDB (const struct Rep_Report *Report);
+static void Rep_CreateNewReportEntryIntoDB (struct Rep_Report *Report);
+static bool Rep_GetReportDataByCod (struct Rep_Report *Report);
 static void Rep_WriteHeader (const struct Rep_Report *Report);
 static void Rep_WriteSectionPlatform (void);
 static void Rep_WriteSectionUsrInfo (void);
@@ -133,9 +193,8 @@ static void Rep_WriteRowCrsData (long CrsCod,Rol_Role_t Role,
 
 static void Rep_ShowMyHitsPerYear (bool AnyCourse,long CrsCod,Rol_Role_t Role,
                                    struct Rep_Report *Report);
-static void Rep_ComputeMaxAndTotalHits (struct Rep_Hits *Hits,
-                                        unsigned long NumRows,
-                                        MYSQL_RES *mysql_res,unsigned Field);
+static void Rep_ResetFilter (const struct Rep_Report *Report,
+                             struct LogCol_Filter *Filter);
 static void Rep_DrawBarNumHits (unsigned long HitsNum,unsigned long HitsMax,
                                 unsigned MaxBarWidth);
 
@@ -143,6 +202,7 @@ static void Rep_WriteDouble (double Num);
 
 static void Rep_RemoveUsrReportsFiles (long UsrCod);
 static void Rep_RemoveUsrReportsFromDB (long UsrCod);
+static void Rep_RemoveUsrJobFromDB (long UsrCod);
 
 /*****************************************************************************/
 /******* Request my usage report (report on my use of the platform) **********/
@@ -177,16 +237,366 @@ void Rep_ReqMyUsageReport (void)
 /*****************************************************************************/
 /********* Show my usage report (report on my use of the platform) ***********/
 /*****************************************************************************/
+// The report is generated by a worker process in background.
+// This action is reloaded until the report is done
 
 void Rep_ShowMyUsageReport (void)
   {
+   extern const char *Txt_The_report_could_not_be_generated_Please_try_again_later;
+   struct Rep_Job Job;
    struct Rep_Report Report;
 
+   /***** Get my report job *****/
+   Rep_GetMyJob (&Job);
+
+   /***** If my last job failed ==> show error
+          and remove my job, so a new one is queued next time *****/
+   if (Job.Status == Rep_JOB_FAILED)
+     {
+      Ale_ShowAlert (Ale_ERROR,Txt_The_report_could_not_be_generated_Please_try_again_later);
+      Rep_RemoveUsrJobFromDB (Gbl.Usrs.Me.UsrDat.UsrCod);
+      return;
+     }
+
+   /***** If my last report is up to date ==> reuse it *****/
+   if (Job.Status == Rep_JOB_DONE)
+     {
+      if (Rep_CheckIfMyReportIsUpToDate (&Job,&Report))
+	{
+	 /* Put link to my usage report */
+	 Rep_PutLinkToMyUsageReport (&Report);
+	 return;
+	}
+      Job.Status = Rep_JOB_NONE;	// Generate a new report
+     }
+
+   /***** Queue a new job for my report *****/
+   if (Job.Status == Rep_JOB_NONE)
+      Rep_QueueMyJob (&Job);
+
+   /***** Start a worker process for my job *****/
+   if (Job.Status == Rep_JOB_PENDING)
+      Rep_StartWorkerIfPossible (&Job);
+
+   /***** Show progress and reload this page later *****/
+   Rep_ShowProgressOfMyJob (&Job);
+  }
+
+/*****************************************************************************/
+/************************ Get my usage report job ****************************/
+/*****************************************************************************/
+
+static void Rep_GetMyJob (struct Rep_Job *Job)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   Rep_JobStatus_t Status;
+   unsigned long SecondsWithoutProgress;
+
+   /***** Default values *****/
+   Job->Status     = Rep_JOB_NONE;
+   Job->Progress   = 0;
+   Job->LastLogCod = -1L;
+   Job->RepCod     = -1L;
+
+   /***** Get my job from database *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get user's usage report job",
+		       "SELECT Status,"					// row[0]
+		              "Progress,"				// row[1]
+		              "LastLogCod,"				// row[2]
+		              "RepCod,"					// row[3]
+		              "UNIX_TIMESTAMP()-UNIX_TIMESTAMP(UpdateTime)"	// row[4]
+		       " FROM usr_report_jobs"
+		       " WHERE UsrCod=%ld",
+		       Gbl.Usrs.Me.UsrDat.UsrCod))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get status (row[0]) */
+      for (Status  = Rep_JOB_PENDING;
+	   Status <= Rep_JOB_FAILED;
+	   Status++)
+	 if (!strcmp (row[0],Rep_JobStatusDB[Status]))
+	   {
+	    Job->Status = Status;
+	    break;
+	   }
+
+      /* Get progress (row[1]) */
+      if (sscanf (row[1],"%u",&Job->Progress) != 1)
+	 Job->Progress = 0;
+      if (Job->Progress > 100)
+	 Job->Progress = 100;
+
+      /* Get last click and report code (row[2], row[3]) */
+      Job->LastLogCod = Str_ConvertStrCodToLongCod (row[2]);
+      Job->RepCod     = Str_ConvertStrCodToLongCod (row[3]);
+
+      /* A running job without progress for a long time is considered dead
+         (the worker process was killed) ==> it must be run again */
+      if (Job->Status == Rep_JOB_RUNNING)
+	 if (sscanf (row[4],"%lu",&SecondsWithoutProgress) == 1)
+	    if (SecondsWithoutProgress > (unsigned long) Rep_MAX_SECONDS_WITHOUT_PROGRESS)
+	       Job->Status = Rep_JOB_PENDING;
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/*************** Check if my last usage report is up to date *****************/
+/*****************************************************************************/
+// My report is up to date if it still exists
+// and I have not clicked since it was generated,
+// except on the actions to request my report
+
+static bool Rep_CheckIfMyReportIsUpToDate (const struct Rep_Job *Job,
+                                           struct Rep_Report *Report)
+  {
+   /***** Get data of my last report *****/
+   Report->RepCod = Job->RepCod;
+   if (!Rep_GetReportDataByCod (Report))
+      return false;
+
+   /***** Check if there are new clicks *****/
+   return (DB_QueryCOUNT ("can not check if there are new clicks",
+			  "SELECT COUNT(*)"
+			  " FROM log"
+			  " WHERE LogCod>%ld"
+			  " AND UsrCod=%ld"
+			  " AND ActCod NOT IN (%ld,%ld)",
+			  Job->LastLogCod,
+			  Gbl.Usrs.Me.UsrDat.UsrCod,
+			  Act_GetActCod (ActReqMyUsgRep),
+			  Act_GetActCod (ActSeeMyUsgRep)) == 0);
+  }
+
+/*****************************************************************************/
+/****************** Queue a new job for my usage report **********************/
+/*****************************************************************************/
+
+static void Rep_QueueMyJob (struct Rep_Job *Job)
+  {
+   /***** Replace my old job, if any *****/
+   DB_QueryREPLACE ("can not queue user's usage report job",
+		    "REPLACE INTO usr_report_jobs"
+		    " (UsrCod,Status,RequestTime,UpdateTime,"
+		    "Progress,LastLogCod,RepCod)"
+		    " VALUES"
+		    " (%ld,'%s',NOW(),NOW(),"
+		    "0,-1,-1)",
+		    Gbl.Usrs.Me.UsrDat.UsrCod,
+		    Rep_JobStatusDB[Rep_JOB_PENDING]);
+
+   Job->Status     = Rep_JOB_PENDING;
+   Job->Progress   = 0;
+   Job->LastLogCod = -1L;
+   Job->RepCod     = -1L;
+  }
+
+/*****************************************************************************/
+/************ Start a worker process to generate my usage report *************/
+/*****************************************************************************/
+// If too many reports are being generated, my job stays pending
+// until this action is reloaded and a worker can be started
+
+static void Rep_StartWorkerIfPossible (struct Rep_Job *Job)
+  {
+   /***** Mark my job as running
+          only if it is pending (or dead)
+          and there are not too many jobs being run by other workers.
+          Both conditions are checked in the same query,
+          so two processes can not start workers beyond the limit
+          nor two workers for the same job *****/
+   DB_QueryUPDATE ("can not update user's usage report job",
+		   "UPDATE usr_report_jobs"
+		   " SET Status='%s',Progress=0,UpdateTime=NOW()"
+		   " WHERE UsrCod=%ld"
+		   " AND (Status='%s'"
+		   " OR (Status='%s'"
+		   " AND UpdateTime<=FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu)))"
+		   " AND (SELECT NumRunningJobs"
+			" FROM (SELECT COUNT(*) AS NumRunningJobs"
+			      " FROM usr_report_jobs"
+			      " WHERE Status='%s'"
+			      " AND UpdateTime>FROM_UNIXTIME(UNIX_TIMESTAMP()-%lu))"
+			" AS running_jobs)<%u",
+		   Rep_JobStatusDB[Rep_JOB_RUNNING],
+		   Gbl.Usrs.Me.UsrDat.UsrCod,
+		   Rep_JobStatusDB[Rep_JOB_PENDING],
+		   Rep_JobStatusDB[Rep_JOB_RUNNING],
+		   (unsigned long) Rep_MAX_SECONDS_WITHOUT_PROGRESS,
+		   Rep_JobStatusDB[Rep_JOB_RUNNING],
+		   (unsigned long) Rep_MAX_SECONDS_WITHOUT_PROGRESS,
+		   (unsigned) Rep_MAX_RUNNING_JOBS);
+   if (!mysql_affected_rows (&Gbl.mysql))
+      return;	// Not claimed ==> my job stays pending or is run by another worker
+
+   /***** Start a worker process *****/
+   if (Wrk_RunDetachedTask (Rep_RunMyJob))
+     {
+      Job->Status   = Rep_JOB_RUNNING;
+      Job->Progress = 0;
+     }
+   else	// Error ==> my job stays pending
+      DB_QueryUPDATE ("can not update user's usage report job",
+		      "UPDATE usr_report_jobs"
+		      " SET Status='%s',UpdateTime=NOW()"
+		      " WHERE UsrCod=%ld",
+		      Rep_JobStatusDB[Rep_JOB_PENDING],
+		      Gbl.Usrs.Me.UsrDat.UsrCod);
+  }
+
+/*****************************************************************************/
+/**************** Generate my usage report in a worker process ***************/
+/*****************************************************************************/
+
+static void Rep_RunMyJob (void)
+  {
+   long LastLogCod;
+   struct Rep_Report Report;
+
+   /***** If this process exits on error, my job must not stay running *****/
+   Wrk_SetFunctionOnError (Rep_SetMyJobAsFailed);
+
+   /***** Get last click before generating report *****/
+   LastLogCod = Rep_GetLastLogCod ();
+
    /***** Create my usage report *****/
    Rep_CreateMyUsageReport (&Report);
 
-   /***** Put link to my usage report *****/
-   Rep_PutLinkToMyUsageReport (&Report);
+   /***** Set my job as done *****/
+   DB_QueryUPDATE ("can not update user's usage report job",
+		   "UPDATE usr_report_jobs"
+		   " SET Status='%s',Progress=100,UpdateTime=NOW(),"
+		   "LastLogCod=%ld,RepCod=%ld"
+		   " WHERE UsrCod=%ld",
+		   Rep_JobStatusDB[Rep_JOB_DONE],
+		   LastLogCod,Report.RepCod,
+		   Gbl.Usrs.Me.UsrDat.UsrCod);
+  }
+
+/*****************************************************************************/
+/************** Set my job as failed when its worker exits on error **********/
+/*****************************************************************************/
+
+static void Rep_SetMyJobAsFailed (void)
+  {
+   DB_QueryUPDATE ("can not update user's usage report job",
+		   "UPDATE usr_report_jobs"
+		   " SET Status='%s',UpdateTime=NOW()"
+		   " WHERE UsrCod=%ld",
+		   Rep_JobStatusDB[Rep_JOB_FAILED],
+		   Gbl.Usrs.Me.UsrDat.UsrCod);
+  }
+
+/*****************************************************************************/
+/************************ Get code of the last click *************************/
+/*****************************************************************************/
+
+static long Rep_GetLastLogCod (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   long LastLogCod = -1L;
+
+   /***** Get the last click from recent log *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get last click",
+		       "SELECT MAX(LogCod) FROM log_recent"))
+     {
+      row = mysql_fetch_row (mysql_res);
+      if (row[0])
+	 LastLogCod = Str_ConvertStrCodToLongCod (row[0]);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return LastLogCod;
+  }
+
+/*****************************************************************************/
+/******************** Update progress of my report job ***********************/
+/*****************************************************************************/
+
+static void Rep_UpdateMyJobProgress (unsigned Progress)
+  {
+   DB_QueryUPDATE ("can not update user's usage report job",
+		   "UPDATE usr_report_jobs"
+		   " SET Progress=%u,UpdateTime=NOW()"
+		   " WHERE UsrCod=%ld",
+		   Progress,
+		   Gbl.Usrs.Me.UsrDat.UsrCod);
+  }
+
+/*****************************************************************************/
+/************* Update my report job while it is being generated **************/
+/*****************************************************************************/
+// Called inside long sections of my report,
+// so my job is not considered dead and is not run by a second worker
+
+static void Rep_HeartBeatMyJob (void)
+  {
+   static time_t LastHeartBeatUTC = (time_t) 0;
+   time_t NowUTC = time (NULL);
+
+   if (NowUTC - LastHeartBeatUTC >= (time_t) Rep_SECONDS_BETWEEN_HEARTBEATS)
+     {
+      DB_QueryUPDATE ("can not update user's usage report job",
+		      "UPDATE usr_report_jobs"
+		      " SET UpdateTime=NOW()"
+		      " WHERE UsrCod=%ld",
+		      Gbl.Usrs.Me.UsrDat.UsrCod);
+      LastHeartBeatUTC = NowUTC;
+     }
+  }
+
+/*****************************************************************************/
+/********** Show progress of my report job and reload page later *************/
+/*****************************************************************************/
+
+static void Rep_ShowProgressOfMyJob (const struct Rep_Job *Job)
+  {
+   extern const char *Hlp_ANALYTICS_Report;
+   extern const char *Txt_Report_of_use_of_PLATFORM;
+   extern const char *Txt_Please_wait_;
+   char Id[Frm_MAX_BYTES_ID + 1];
+
+   /***** Form to reload this page *****/
+   Frm_SetUniqueId (Id);
+   Frm_StartFormId (ActSeeMyUsgRep,Id);
+
+   /***** Begin box *****/
+   Box_BoxBegin (NULL,Str_BuildStringStr (Txt_Report_of_use_of_PLATFORM,
+				          Cfg_PLATFORM_SHORT_NAME),
+                 NULL,NULL,
+                 Hlp_ANALYTICS_Report,Box_NOT_CLOSABLE);
+   Str_FreeString ();
+
+   /***** Header *****/
+   Rep_TitleReport (NULL);	// NULL means do not write date
+
+   /***** Progress *****/
+   HTM_DIV_Begin ("class=\"DAT CM\"");
+   Ico_PutIcon ("Spin-1s-200px.gif",Txt_Please_wait_,"ICO64x64");
+   HTM_BR ();
+   HTM_Txt (Txt_Please_wait_);
+   if (Job->Status == Rep_JOB_RUNNING)
+      HTM_TxtF (" %u%%",Job->Progress);
+   HTM_DIV_End ();
+
+   /***** End box *****/
+   Box_BoxEnd ();
+
+   /***** End form *****/
+   Frm_EndForm ();
+
+   /***** Reload this page later *****/
+   HTM_SCRIPT_Begin (NULL,NULL);
+   HTM_TxtF ("setTimeout(function(){document.getElementById('%s').submit();},%lu);",
+	     Id,(unsigned long) Rep_SECONDS_TO_REFRESH_JOB * 1000UL);
+   HTM_SCRIPT_End ();
   }
 
 /*****************************************************************************/
@@ -196,6 +606,7 @@ void Rep_ShowMyUsageReport (void)
 static void Rep_CreateMyUsageReport (struct Rep_Report *Report)
   {
    bool GetUsrFiguresAgain;
+   char Condition[16 + Cns_MAX_DECIMAL_DIGITS_LONG + 1];
 
    /***** Get current date-time *****/
    Rep_GetCurrentDateTimeUTC (Report);
@@ -231,20 +642,40 @@ static void Rep_CreateMyUsageReport (struct Rep_Report *Report)
       gmtime_r (&Report->UsrFigures.FirstClickTimeUTC,
                 &Report->tm_FirstClickTime);
    Rep_WriteSectionUsrFigures (Report);
+   Rep_UpdateMyJobProgress (10);
+
+   /***** My clicks in closed months are got from columns of log,
+          the rest from a table with my clicks *****/
+   Report->StartTimeInLogUTC = LogCol_GetEndOfColumns ();
+   if (Report->StartTimeInLogUTC < Report->UsrFigures.FirstClickTimeUTC)
+      Report->StartTimeInLogUTC = Report->UsrFigures.FirstClickTimeUTC;
+   snprintf (Condition,sizeof (Condition),"UsrCod=%ld",
+	     Gbl.Usrs.Me.UsrDat.UsrCod);
+   LogArc_BuildLogTable (&Report->LogTable,
+                         Report->StartTimeInLogUTC,
+                         Gbl.StartExecutionTimeUTC,
+                         Condition);
 
    /***** Global count of hits *****/
    Rep_WriteSectionGlobalHits (Report);
+   Rep_UpdateMyJobProgress (20);
 
    /***** Global hits distributed by action *****/
    Rep_WriteSectionHitsPerAction (Report);
+   Rep_UpdateMyJobProgress (40);
 
    /***** Current courses *****/
    Rep_GetMaxHitsPerYear (Report);
+   Rep_UpdateMyJobProgress (50);
    Rep_WriteSectionCurrentCourses (Report);
+   Rep_UpdateMyJobProgress (70);
 
    /***** Historic courses *****/
    Rep_WriteSectionHistoricCourses (Report);
 
+   /***** Free table with my clicks *****/
+   free (Report->LogTable);
+
    /***** End file *****/
    fprintf (Gbl.F.Rep,"</body>\n"
 	              "</html>\n");
@@ -424,27 +855,69 @@ static void Rep_CreateNewReportFile (struct Rep_Report *Report)
 /************** Insert a new user's usage report into database ***************/
 /*****************************************************************************/
 
-static void Rep_CreateNewReportEntryIntoDB (const struct Rep_Report *Report)
+static void Rep_CreateNewReportEntryIntoDB (struct Rep_Report *Report)
   {
    /***** Insert a new user's usage report into database *****/
-   DB_QueryINSERT ("can not create new user's usage report",
-		   "INSERT INTO usr_report"
-	           " (UsrCod,ReportTimeUTC,"
-	           "UniqueDirL,UniqueDirR,Filename,Permalink)"
-                   " VALUES"
-                   " (%ld,'%04d-%02d-%02d %02d:%02d:%02d',"
-                   "'%c%c','%s','%s','%s')",
-		   Gbl.Usrs.Me.UsrDat.UsrCod,
-		   1900 + Report->tm_CurrentTime.tm_year,	// year
-		   1 +  Report->tm_CurrentTime.tm_mon,		// month
-		   Report->tm_CurrentTime.tm_mday,		// day of the month
-		   Report->tm_CurrentTime.tm_hour,		// hours
-		   Report->tm_CurrentTime.tm_min,		// minutes
-		   Report->tm_CurrentTime.tm_sec,		// seconds
-		   Gbl.UniqueNameEncrypted[0],		//  2  leftmost chars from a unique 43 chars base64url codified from a unique SHA-256 string
-		   Gbl.UniqueNameEncrypted[1],
-		   &Gbl.UniqueNameEncrypted[2],		// 41 rightmost chars from a unique 43 chars base64url codified from a unique SHA-256 string
-		   Report->FilenameReport,Report->Permalink);
+   Report->RepCod =
+   DB_QueryINSERTandReturnCode ("can not create new user's usage report",
+				"INSERT INTO usr_report"
+				" (UsrCod,ReportTimeUTC,"
+				"UniqueDirL,UniqueDirR,Filename,Permalink)"
+				" VALUES"
+				" (%ld,'%04d-%02d-%02d %02d:%02d:%02d',"
+				"'%c%c','%s','%s','%s')",
+				Gbl.Usrs.Me.UsrDat.UsrCod,
+				1900 + Report->tm_CurrentTime.tm_year,	// year
+				1 +  Report->tm_CurrentTime.tm_mon,		// month
+				Report->tm_CurrentTime.tm_mday,		// day of the month
+				Report->tm_CurrentTime.tm_hour,		// hours
+				Report->tm_CurrentTime.tm_min,		// minutes
+				Report->tm_CurrentTime.tm_sec,		// seconds
+				Gbl.UniqueNameEncrypted[0],		//  2  leftmost chars from a unique 43 chars base64url codified from a unique SHA-256 string
+				Gbl.UniqueNameEncrypted[1],
+				&Gbl.UniqueNameEncrypted[2],		// 41 rightmost chars from a unique 43 chars base64url codified from a unique SHA-256 string
+				Report->FilenameReport,Report->Permalink);
+  }
+
+/*****************************************************************************/
+/*************** Get data of one of my usage reports from its code ***********/
+/*****************************************************************************/
+// Return true if the report exists
+
+static bool Rep_GetReportDataByCod (struct Rep_Report *Report)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   bool Found = false;
+
+   /***** Get data of the report from database *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get user's usage report",
+		       "SELECT DATE_FORMAT(ReportTimeUTC,'%%Y-%%m-%%d'),"	// row[0]
+		              "DATE_FORMAT(ReportTimeUTC,'%%H:%%i:%%s'),"	// row[1]
+		              "Filename,"					// row[2]
+		              "Permalink"					// row[3]
+		       " FROM usr_report"
+		       " WHERE RepCod=%ld AND UsrCod=%ld",
+		       Report->RepCod,
+		       Gbl.Usrs.Me.UsrDat.UsrCod))
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      Str_Copy (Report->CurrentTimeUTC.StrDate,row[0],
+	        sizeof (Report->CurrentTimeUTC.StrDate) - 1);
+      Str_Copy (Report->CurrentTimeUTC.StrTime,row[1],
+	        sizeof (Report->CurrentTimeUTC.StrTime) - 1);
+      Str_Copy (Report->FilenameReport,row[2],
+	        NAME_MAX);
+      Str_Copy (Report->Permalink,row[3],
+	        Cns_MAX_BYTES_WWW);
+      Found = true;
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Found;
   }
 
 /*****************************************************************************/
@@ -770,10 +1243,10 @@ static void Rep_WriteSectionHitsPerAction (struct Rep_Report *Report)
    extern const char *Txt_Hits_per_action;
    extern const char *Txt_TABS_TXT[Tab_NUM_TABS];
    extern const char *Txt_Other_actions;
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumRows;
-   unsigned long NumRow;
+   struct LogCol_Filter Filter;
+   struct LogCol_Counts Counts;
+   unsigned NumActions;
+   unsigned NumAction;
    long ActCod;
    Act_Action_t Action;
    Tab_Tab_t Tab;
@@ -784,34 +1257,38 @@ static void Rep_WriteSectionHitsPerAction (struct Rep_Report *Report)
                       "<h3>%s</h3>",
 	    Txt_Hits_per_action);
 
-   /***** Make the query *****/
-   NumRows = DB_QuerySELECT (&mysql_res,"can not get clicks",
-			     "SELECT SQL_NO_CACHE ActCod,COUNT(*) AS N"
-			     " FROM log"
-			     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
-			     " AND UsrCod=%ld"
-			     " GROUP BY ActCod ORDER BY N DESC LIMIT %u",
-			     (long) Report->UsrFigures.FirstClickTimeUTC,
-			     Gbl.Usrs.Me.UsrDat.UsrCod,
-			     Rep_MAX_ACTIONS);
+   /***** Get my clicks per action from columns and from log *****/
+   LogCol_ResetCounts (&Counts);
+   Rep_ResetFilter (Report,&Filter);
+   LogCol_GetCountsFromColumns (&Counts,&Filter,LogCol_GROUP_BY_ACTION);
+   LogCol_GetCountsFromQuery (&Counts,"can not get clicks",
+			      "SELECT SQL_NO_CACHE ActCod,COUNT(*)"
+			      " FROM %s"
+			      " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+			      " AND UsrCod=%ld"
+			      " GROUP BY ActCod",
+			      Report->LogTable,
+			      (long) Report->StartTimeInLogUTC,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
+   LogCol_MergeCounts (&Counts);
+   LogCol_SortCountsByNumClicks (&Counts);
+   NumActions = Counts.Num < Rep_MAX_ACTIONS ? Counts.Num :
+					       Rep_MAX_ACTIONS;
 
    /***** Compute maximum number of hits per action *****/
-   Rep_ComputeMaxAndTotalHits (&Report->Hits,NumRows,mysql_res,1);
-   mysql_data_seek (mysql_res,0);
+   Report->Hits.Max = NumActions ? Counts.Counts[0].NumClicks :
+				   0;
 
    /***** Write rows *****/
-   for (NumRow = 1, NumClicks = 0;
-	NumRow <= NumRows;
-	NumRow++)
+   for (NumAction = 0, NumClicks = 0;
+	NumAction < NumActions;
+	NumAction++)
      {
-      row = mysql_fetch_row (mysql_res);
+      /* Get the action */
+      ActCod = Counts.Counts[NumAction].Key;
 
-      /* Get the action (row[0]) */
-      ActCod = Str_ConvertStrCodToLongCod (row[0]);
-
-      /* Get number of hits (row[1]) */
-      if (sscanf (row[1],"%lu",&Report->Hits.Num) != 1)
-	 Report->Hits.Num = 0;
+      /* Get number of hits */
+      Report->Hits.Num = Counts.Counts[NumAction].NumClicks;
       NumClicks += Report->Hits.Num;
 
       /* Draw bar proportional to number of hits */
@@ -844,8 +1321,8 @@ static void Rep_WriteSectionHitsPerAction (struct Rep_Report *Report)
       HTM_BR ();
      }
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free counts *****/
+   LogCol_FreeCounts (&Counts);
 
    /***** End section *****/
    fprintf (Gbl.F.Rep,"</section>\n");
@@ -922,56 +1399,71 @@ static void Rep_WriteSectionHistoricCourses (struct Rep_Report *Report)
 
 static void Rep_GetMaxHitsPerYear (struct Rep_Report *Report)
   {
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-
-   DB_QuerySELECT (&mysql_res,"can not get last question index",
-		   "SELECT MAX(N) FROM ("
-		   // Clicks without course selected --------------------------
-	           "SELECT "
-	           "-1 AS CrsCod,"
-	           "YEAR(CONVERT_TZ(ClickTime,@@session.time_zone,'UTC')) AS Year,"
-	           "%u AS Role,"
-	           "COUNT(*) AS N"
-	           " FROM log"
-	           " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
-	           " AND UsrCod=%ld"
-	           " AND CrsCod<=0"
-	           " GROUP BY Year"
-		   // ---------------------------------------------------------
-	           " UNION "
-		   // Clicks as student, non-editing teacher or teacher in courses
-	           "SELECT "
-	           "CrsCod,"
-	           "YEAR(CONVERT_TZ(ClickTime,@@session.time_zone,'UTC')) AS Year,"
-	           "Role,"
-	           "COUNT(*) AS N"
-	           " FROM log"
-	           " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
-	           " AND UsrCod=%ld"
-	           " AND Role>=%u"	// Student
-	           " AND Role<=%u"	// Teacher
-	           " AND CrsCod>0"
-	           " GROUP BY CrsCod,Year,Role"
-		   // ---------------------------------------------------------
-	           ") AS hits_per_crs_year",
-		   (unsigned) Rol_UNK,
-		   (long) Report->UsrFigures.FirstClickTimeUTC,
-		   Gbl.Usrs.Me.UsrDat.UsrCod,
-		   (long) Report->UsrFigures.FirstClickTimeUTC,
-		   Gbl.Usrs.Me.UsrDat.UsrCod,
-		   (unsigned) Rol_STD,
-		   (unsigned) Rol_TCH);
+   struct LogCol_Filter Filter;
+   struct LogCol_Counts Counts;
+   unsigned long MaxHits;
 
-   /***** Get number of users *****/
    Report->MaxHitsPerYear = 0;
-   row = mysql_fetch_row (mysql_res);
-   if (row[0])	// There are questions
-      if (sscanf (row[0],"%lu",&Report->MaxHitsPerYear) != 1)
-         Lay_ShowErrorAndExit ("Error when getting maximum hits.");
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Clicks without course selected, per year *****/
+   LogCol_ResetCounts (&Counts);
+   Rep_ResetFilter (Report,&Filter);
+   Filter.CrsFilter = LogCol_WITHOUT_COURSE;
+   LogCol_GetCountsFromColumns (&Counts,&Filter,LogCol_GROUP_BY_YEAR);
+   LogCol_GetCountsFromQuery (&Counts,"can not get clicks",
+			      "SELECT "
+			      Rep_YEAR_UTC_FROM_HOUR " AS Year,"
+			      "SUM(NumClicks)"
+			      " FROM (SELECT "
+				     Rep_HOUR_UTC_OF_CLICK " AS HourUTC,"
+				     "COUNT(*) AS NumClicks"
+				     " FROM %s"
+				     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+				     " AND UsrCod=%ld"
+				     " AND CrsCod<=0"
+				     " GROUP BY HourUTC) AS hours"
+			      " GROUP BY Year",
+			      Report->LogTable,
+			      (long) Report->StartTimeInLogUTC,
+			      Gbl.Usrs.Me.UsrDat.UsrCod);
+   LogCol_MergeCounts (&Counts);
+   if ((MaxHits = LogCol_GetMaxNumClicks (&Counts)) > Report->MaxHitsPerYear)
+      Report->MaxHitsPerYear = MaxHits;
+   LogCol_FreeCounts (&Counts);
+
+   /***** Clicks as student, non-editing teacher or teacher in courses,
+          per course, year and role *****/
+   Filter.CrsFilter = LogCol_IN_COURSES;
+   Filter.FirstRole = Rol_STD;
+   Filter.LastRole  = Rol_TCH;
+   LogCol_GetCountsFromColumns (&Counts,&Filter,LogCol_GROUP_BY_COURSE_YEAR_ROLE);
+   LogCol_GetCountsFromQuery (&Counts,"can not get clicks",
+			      "SELECT "
+			      "(CrsCod*10000+"
+			      Rep_YEAR_UTC_FROM_HOUR ")*%u+"
+			      "Role AS CrsYearRole,"	// LogCol_KEY_CRS_YEAR_ROLE
+			      "SUM(NumClicks)"
+			      " FROM (SELECT CrsCod,Role,"
+				     Rep_HOUR_UTC_OF_CLICK " AS HourUTC,"
+				     "COUNT(*) AS NumClicks"
+				     " FROM %s"
+				     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+				     " AND UsrCod=%ld"
+				     " AND Role>=%u"	// Student
+				     " AND Role<=%u"	// Teacher
+				     " AND CrsCod>0"
+				     " GROUP BY CrsCod,Role,HourUTC) AS hours"
+			      " GROUP BY CrsYearRole",
+			      (unsigned) Rol_NUM_ROLES,
+			      Report->LogTable,
+			      (long) Report->StartTimeInLogUTC,
+			      Gbl.Usrs.Me.UsrDat.UsrCod,
+			      (unsigned) Rol_STD,
+			      (unsigned) Rol_TCH);
+   LogCol_MergeCounts (&Counts);
+   if ((MaxHits = LogCol_GetMaxNumClicks (&Counts)) > Report->MaxHitsPerYear)
+      Report->MaxHitsPerYear = MaxHits;
+   LogCol_FreeCounts (&Counts);
   }
 
 /*****************************************************************************/
@@ -1095,23 +1587,36 @@ static void Rep_GetAndWriteMyHistoricCrss (Rol_Role_t Role,
   {
    extern const char *Txt_Hits_as_a_USER;
    extern const char *Txt_ROLES_SINGUL_abc[Rol_NUM_ROLES][Usr_NUM_SEXS];
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
+   struct LogCol_Filter Filter;
+   struct LogCol_Counts Counts;
    unsigned NumCrss;
    unsigned NumCrs;
-   long CrsCod;
 
-   /***** Get historic courses of a user from log *****/
-   NumCrss =
-   (unsigned) DB_QuerySELECT (&mysql_res,"can not get courses of a user",
-			      "SELECT CrsCod,COUNT(*) AS N"
-			      " FROM log"
-			      " WHERE UsrCod=%ld AND Role=%u AND CrsCod>0"
-			      " GROUP BY CrsCod"
-			      " HAVING N>%u"
-			      " ORDER BY N DESC",
-			      Gbl.Usrs.Me.UsrDat.UsrCod,(unsigned) Role,
-			      Rep_MIN_CLICKS_CRS);
+   /***** Get historic courses of a user from columns and from log *****/
+   LogCol_ResetCounts (&Counts);
+   Rep_ResetFilter (Report,&Filter);
+   Filter.CrsFilter = LogCol_IN_COURSES;
+   Filter.FirstRole =
+   Filter.LastRole  = Role;
+   LogCol_GetCountsFromColumns (&Counts,&Filter,LogCol_GROUP_BY_COURSE);
+   LogCol_GetCountsFromQuery (&Counts,"can not get courses of a user",
+			      "SELECT CrsCod,COUNT(*)"
+			      " FROM %s"
+			      " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+			      " AND UsrCod=%ld AND Role=%u AND CrsCod>0"
+			      " GROUP BY CrsCod",
+			      Report->LogTable,
+			      (long) Report->StartTimeInLogUTC,
+			      Gbl.Usrs.Me.UsrDat.UsrCod,(unsigned) Role);
+   LogCol_MergeCounts (&Counts);
+   LogCol_SortCountsByNumClicks (&Counts);
+
+   /***** Only courses with enough clicks are listed *****/
+   for (NumCrss = 0;
+	NumCrss < Counts.Num;
+	NumCrss++)
+      if (Counts.Counts[NumCrss].NumClicks <= Rep_MIN_CLICKS_CRS)
+	 break;
 
    /***** List the courses (one row per course) *****/
    if (NumCrss)
@@ -1123,28 +1628,20 @@ static void Rep_GetAndWriteMyHistoricCrss (Rol_Role_t Role,
       fprintf (Gbl.F.Rep,":<ol>");
 
       /* Write courses */
-      for (NumCrs = 1;
-	   NumCrs <= NumCrss;
+      for (NumCrs = 0;
+	   NumCrs < NumCrss;
 	   NumCrs++)
-        {
-         /* Get next course */
-         row = mysql_fetch_row (mysql_res);
-
-	 /* Get course code (row[0]) */
-	 CrsCod = Str_ConvertStrCodToLongCod (row[0]);
-
          /* Write data of this course */
-         Rep_WriteRowCrsData (CrsCod,Role,Report,
+         Rep_WriteRowCrsData (Counts.Counts[NumCrs].Key,Role,Report,
 			      false);	// Do not write number of users in course
-	}
 
       /* End list */
       fprintf (Gbl.F.Rep,"</ol>"
 	                 "</li>");
      }
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free counts *****/
+   LogCol_FreeCounts (&Counts);
   }
 
 /*****************************************************************************/
@@ -1221,37 +1718,58 @@ static void Rep_ShowMyHitsPerYear (bool AnyCourse,long CrsCod,Rol_Role_t Role,
   {
    char SubQueryCrs[128];
    char SubQueryRol[128];
-   MYSQL_RES *mysql_res;
-   MYSQL_ROW row;
-   unsigned long NumRows;
-   unsigned long NumRow;
+   struct LogCol_Filter Filter;
+   struct LogCol_Counts Counts;
+   unsigned NumYear;
    unsigned ReadYear;
    unsigned FirstYear;
    unsigned LastYear;
    unsigned Year;
 
-   /***** Make the query *****/
+   /***** This is called for each of my courses ==> it may take long *****/
+   Rep_HeartBeatMyJob ();
+
+   /***** Set filter *****/
+   Rep_ResetFilter (Report,&Filter);
    if (AnyCourse)
       SubQueryCrs[0] = '\0';
    else
+     {
+      Filter.CrsFilter = LogCol_IN_ONE_COURSE;
+      Filter.CrsCod    = CrsCod;
       sprintf (SubQueryCrs," AND CrsCod=%ld",CrsCod);
+     }
 
    if (Role == Rol_UNK)	// Here Rol_UNK means any role
       SubQueryRol[0] = '\0';
    else
+     {
+      Filter.FirstRole =
+      Filter.LastRole  = Role;
       sprintf (SubQueryRol," AND Role=%u",(unsigned) Role);
+     }
 
-   NumRows = DB_QuerySELECT (&mysql_res,"can not get clicks",
-			     "SELECT SQL_NO_CACHE "
-			     "YEAR(CONVERT_TZ(ClickTime,@@session.time_zone,'UTC')) AS Year,"
-			     "COUNT(*) FROM log"
-			     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
-			     " AND UsrCod=%ld%s%s"
-			     " GROUP BY Year DESC",
-			     (long) Report->UsrFigures.FirstClickTimeUTC,
-			     Gbl.Usrs.Me.UsrDat.UsrCod,
-			     SubQueryCrs,
-			     SubQueryRol);
+   /***** Get my clicks per year from columns and from log *****/
+   LogCol_ResetCounts (&Counts);
+   LogCol_GetCountsFromColumns (&Counts,&Filter,LogCol_GROUP_BY_YEAR);
+   LogCol_GetCountsFromQuery (&Counts,"can not get clicks",
+			      "SELECT SQL_NO_CACHE "
+			      Rep_YEAR_UTC_FROM_HOUR " AS Year,"
+			      "SUM(NumClicks)"
+			      " FROM (SELECT "
+				     Rep_HOUR_UTC_OF_CLICK " AS HourUTC,"
+				     "COUNT(*) AS NumClicks"
+				     " FROM %s"
+				     " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+				     " AND UsrCod=%ld%s%s"
+				     " GROUP BY HourUTC) AS hours"
+			      " GROUP BY Year",
+			      Report->LogTable,
+			      (long) Report->StartTimeInLogUTC,
+			      Gbl.Usrs.Me.UsrDat.UsrCod,
+			      SubQueryCrs,
+			      SubQueryRol);
+   LogCol_MergeCounts (&Counts);	// Sorted by year
 
    /***** Initialize first year *****/
    FirstYear = 1900 + Report->tm_FirstClickTime.tm_year;
@@ -1264,26 +1782,19 @@ static void Rep_ShowMyHitsPerYear (bool AnyCourse,long CrsCod,Rol_Role_t Role,
       /* Set maximum number of hits per year from parameter */
       Report->Hits.Max = Report->MaxHitsPerYear;
    else
-     {
       /* Compute maximum number of hits per year */
-      Rep_ComputeMaxAndTotalHits (&Report->Hits,NumRows,mysql_res,1);
-      mysql_data_seek (mysql_res,0);
-     }
+      Report->Hits.Max = LogCol_GetMaxNumClicks (&Counts);
 
-   /***** Write rows *****/
-   for (NumRow = 1;
-	NumRow <= NumRows;
-	NumRow++)
+   /***** Write rows from the last year *****/
+   for (NumYear = Counts.Num;
+	NumYear != 0;
+	NumYear--)
      {
-      row = mysql_fetch_row (mysql_res);
+      /* Get the year */
+      ReadYear = (unsigned) Counts.Counts[NumYear - 1].Key;
 
-      /* Get the year (in row[0] is the date in YYYY format) */
-      if (sscanf (row[0],"%04u",&ReadYear) != 1)
-	 Lay_ShowErrorAndExit ("Wrong date.");
-
-      /* Get number hits (in row[1]) */
-      if (sscanf (row[1],"%lu",&Report->Hits.Num) != 1)
-	 Report->Hits.Num = 0;
+      /* Get number hits */
+      Report->Hits.Num = Counts.Counts[NumYear - 1].NumClicks;
 
       for (Year = LastYear;
 	   Year >= ReadYear;
@@ -1301,8 +1812,8 @@ static void Rep_ShowMyHitsPerYear (bool AnyCourse,long CrsCod,Rol_Role_t Role,
       LastYear = Year;
      }
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+   /***** Free counts *****/
+   LogCol_FreeCounts (&Counts);
 
    /***** Finally, show the oldest years without clicks *****/
    for (Year  = LastYear;
@@ -1319,32 +1830,16 @@ static void Rep_ShowMyHitsPerYear (bool AnyCourse,long CrsCod,Rol_Role_t Role,
   }
 
 /*****************************************************************************/
-/*************** Compute maximum and total number of hits ********************/
+/***************** Set filter to get my clicks from columns ******************/
 /*****************************************************************************/
 
-static void Rep_ComputeMaxAndTotalHits (struct Rep_Hits *Hits,
-                                        unsigned long NumRows,
-                                        MYSQL_RES *mysql_res,unsigned Field)
+static void Rep_ResetFilter (const struct Rep_Report *Report,
+                             struct LogCol_Filter *Filter)
   {
-   unsigned long NumRow;
-   MYSQL_ROW row;
-
-   /***** For each row... *****/
-   for (NumRow = 1, Hits->Max = 0;
-	NumRow <= NumRows;
-	NumRow++)
-     {
-      /* Get row */
-      row = mysql_fetch_row (mysql_res);
-
-      /* Get number of hits */
-      if (sscanf (row[Field],"%lu",&Hits->Num) != 1)
-	 Hits->Num = 0;
-
-      /* Update maximum hits */
-      if (Hits->Num > Hits->Max)
-	 Hits->Max = Hits->Num;
-     }
+   LogCol_ResetFilter (Filter);
+   Filter->StartTimeUTC = Report->UsrFigures.FirstClickTimeUTC;
+   Filter->EndTimeUTC   = Report->StartTimeInLogUTC;
+   Filter->UsrCod       = Gbl.Usrs.Me.UsrDat.UsrCod;
   }
 
 /*****************************************************************************/
@@ -1408,6 +1903,9 @@ void Rep_RemoveUsrUsageReports (long UsrCod)
 
    /***** Remove all user's usage reports of a user from database *****/
    Rep_RemoveUsrReportsFromDB (UsrCod);
+
+   /***** Remove user's usage report job from database *****/
+   Rep_RemoveUsrJobFromDB (UsrCod);
   }
 
 /*****************************************************************************/
@@ -1460,3 +1958,14 @@ static void Rep_RemoveUsrReportsFromDB (long UsrCod)
 		   "DELETE FROM usr_report WHERE UsrCod=%ld",
 		   UsrCod);
   }
+
+/*****************************************************************************/
+/************* Remove user's usage report job from database ******************/
+/*****************************************************************************/
+
+static void Rep_RemoveUsrJobFromDB (long UsrCod)
+  {
+   DB_QueryDELETE ("can not remove user's usage report job",
+		   "DELETE FROM usr_report_jobs WHERE UsrCod=%ld",
+		   UsrCod);
+  }
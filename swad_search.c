@@ -25,9 +25,11 @@
 /*********************************** Headers *********************************/
 /*****************************************************************************/
 
+#include <stdlib.h>	// For free
 #include <string.h>	// For string functions...
 
 #include "swad_box.h"
+#include "swad_code_set.h"
 #include "swad_database.h"
 #include "swad_form.h"
 #include "swad_global.h"
@@ -462,7 +464,8 @@ static unsigned Sch_SearchCountriesInDB (const char *RangeQuery)
 	 snprintf (FieldName,sizeof (FieldName),
 	           "Name_%s",
 		   Lan_STR_LANG_ID[Gbl.Prefs.Language]);
-	 if (Sch_BuildSearchQuery (SearchQuery,FieldName,NULL,NULL))
+	 if (Sch_BuildSearchQuery (SearchQuery,FieldName,NULL,NULL,
+				   SchIdx_INS_NAME,NULL))	// Names of countries are not indexed
 	   {
 	    /***** Query database and list institutions found *****/
 	    NumCtys = (unsigned) DB_QuerySELECT (&mysql_res,"can not get countries",
@@ -499,7 +502,8 @@ static unsigned Sch_SearchInstitutionsInDB (const char *RangeQuery)
       /***** Check user's permission *****/
       if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_INSTITS))
 	 /***** Split institutions string into words *****/
-	 if (Sch_BuildSearchQuery (SearchQuery,"institutions.FullName",NULL,NULL))
+	 if (Sch_BuildSearchQuery (SearchQuery,"institutions.FullName",NULL,NULL,
+				   SchIdx_INS_NAME,"institutions.InsCod"))
 	   {
 	    /***** Query database and list institutions found *****/
 	    NumInss = (unsigned) DB_QuerySELECT (&mysql_res,"can not get institutions",
@@ -535,7 +539,8 @@ static unsigned Sch_SearchCentresInDB (const char *RangeQuery)
       /***** Check user's permission *****/
       if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_CENTRES))
 	 /***** Split centre string into words *****/
-	 if (Sch_BuildSearchQuery (SearchQuery,"centres.FullName",NULL,NULL))
+	 if (Sch_BuildSearchQuery (SearchQuery,"centres.FullName",NULL,NULL,
+				   SchIdx_CTR_NAME,"centres.CtrCod"))
 	   {
 	    /***** Query database and list centres found *****/
 	    NumCtrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get centres",
@@ -570,7 +575,8 @@ static unsigned Sch_SearchDegreesInDB (const char *RangeQuery)
       /***** Check user's permission *****/
       if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_DEGREES))
 	 /***** Split degree string into words *****/
-	 if (Sch_BuildSearchQuery (SearchQuery,"degrees.FullName",NULL,NULL))
+	 if (Sch_BuildSearchQuery (SearchQuery,"degrees.FullName",NULL,NULL,
+				   SchIdx_DEG_NAME,"degrees.DegCod"))
 	   {
 	    /***** Query database and list degrees found *****/
 	    NumDegs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get degrees",
@@ -604,7 +610,8 @@ static unsigned Sch_SearchCoursesInDB (const char *RangeQuery)
    /***** Check user's permission *****/
    if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_COURSES))
       /***** Split course string into words *****/
-      if (Sch_BuildSearchQuery (SearchQuery,"courses.FullName",NULL,NULL))
+      if (Sch_BuildSearchQuery (SearchQuery,"courses.FullName",NULL,NULL,
+				SchIdx_CRS_NAME,"courses.CrsCod"))
 	{
 	 /***** Query database and list courses found *****/
 	 NumCrss = (unsigned)
@@ -646,7 +653,8 @@ static unsigned Sch_SearchUsrsInDB (Rol_Role_t Role)
    /***** Split user string into words *****/
    if (Sch_BuildSearchQuery (SearchQuery,
 			     "CONCAT_WS(' ',FirstName,Surname1,Surname2)",
-			     NULL,NULL))
+			     NULL,NULL,
+			     SchIdx_USR_NAME,"usr_data.UsrCod"))
       /***** Query database and list users found *****/
       return Usr_ListUsrsFound (Role,SearchQuery);
    else
@@ -677,7 +685,8 @@ static unsigned Sch_SearchOpenDocumentsInDB (const char *RangeQuery)
    if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_OPEN_DOCUMENTS))
       /***** Split document string into words *****/
       if (Sch_BuildSearchQuery (SearchQuery,"SUBSTRING_INDEX(files.Path,'/',-1)",
-				"_latin1 "," COLLATE latin1_general_ci"))
+				"_latin1 "," COLLATE latin1_general_ci",
+				SchIdx_FILE_NAME,"files.FilCod"))
 	{
 	 /***** Query database *****/
 	 NumDocs = DB_QuerySELECT (&mysql_res,"can not get files",
@@ -784,6 +793,9 @@ static unsigned Sch_SearchDocumentsInMyCoursesInDB (const char *RangeQuery)
    extern const char *Txt_document_in_my_courses;
    extern const char *Txt_documents_in_my_courses;
    char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1];
+   struct CodSet_CodeSet MyGrps;
+   char *MyCrssList;
+   char *MyGrpsList;
    MYSQL_RES *mysql_res;
    unsigned long NumDocs;
 
@@ -791,40 +803,23 @@ static unsigned Sch_SearchDocumentsInMyCoursesInDB (const char *RangeQuery)
    if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_DOCUM_IN_MY_COURSES))
       /***** Split document string into words *****/
       if (Sch_BuildSearchQuery (SearchQuery,"SUBSTRING_INDEX(files.Path,'/',-1)",
-				"_latin1 "," COLLATE latin1_general_ci"))
+				"_latin1 "," COLLATE latin1_general_ci",
+				SchIdx_FILE_NAME,"files.FilCod"))
 	{
-	 /***** Create temporary table with codes of files in documents and shared areas accessible by me.
-		It is necessary to speed up the second query *****/
-	 DB_Query ("can not remove temporary table",
-	           "DROP TEMPORARY TABLE IF EXISTS my_files_crs,my_files_grp");
-
-	 DB_Query ("can not create temporary table",
-		   "CREATE TEMPORARY TABLE my_files_crs"
-		   " (FilCod INT NOT NULL,UNIQUE INDEX(FilCod))"
-		   " ENGINE=MEMORY"
-		   " SELECT files.FilCod FROM crs_usr,files"
-		   " WHERE crs_usr.UsrCod=%ld"
-		   " AND crs_usr.CrsCod=files.Cod"
-		   " AND files.FileBrowser IN (%u,%u,%u,%u)",
-		   Gbl.Usrs.Me.UsrDat.UsrCod,
-		   (unsigned) Brw_ADMI_DOC_CRS,
-		   (unsigned) Brw_ADMI_TCH_CRS,
-		   (unsigned) Brw_ADMI_SHR_CRS,
-		   (unsigned) Brw_ADMI_MRK_CRS);
-
-	 DB_Query ("can not create temporary table",
-	           "CREATE TEMPORARY TABLE my_files_grp"
-		   " (FilCod INT NOT NULL,UNIQUE INDEX(FilCod))"
-		   " ENGINE=MEMORY"
-		   " SELECT files.FilCod FROM crs_grp_usr,files"
-		   " WHERE crs_grp_usr.UsrCod=%ld"
-		   " AND crs_grp_usr.GrpCod=files.Cod"
-		   " AND files.FileBrowser IN (%u,%u,%u,%u)",
-		   Gbl.Usrs.Me.UsrDat.UsrCod,
-		   (unsigned) Brw_ADMI_DOC_GRP,
-		   (unsigned) Brw_ADMI_TCH_GRP,
-		   (unsigned) Brw_ADMI_SHR_GRP,
-		   (unsigned) Brw_ADMI_MRK_GRP);
+	 /***** Get lists with codes of my courses and my groups,
+		whose documents and shared areas are accessible by me.
+		They are used to filter files by their course or group
+		without temporary tables *****/
+	 Usr_GetMyCourses ();
+	 CodSet_BuildListOfCods (&Gbl.Usrs.Me.MyCrss.Cods,&MyCrssList);
+
+	 CodSet_ResetSet (&MyGrps);
+	 CodSet_GetSetFromQuery (&MyGrps,"can not get your groups",
+				 "SELECT GrpCod FROM crs_grp_usr"
+				 " WHERE UsrCod=%ld",
+				 Gbl.Usrs.Me.UsrDat.UsrCod);
+	 CodSet_BuildListOfCods (&MyGrps,&MyGrpsList);
+	 CodSet_FreeSet (&MyGrps);
 
 	 /***** Build the query *****/
 	 NumDocs = DB_QuerySELECT (&mysql_res,"can not get files",
@@ -838,8 +833,8 @@ static unsigned Sch_SearchDocumentsInMyCoursesInDB (const char *RangeQuery)
 				   "courses.CrsCod,courses.ShortName AS CrsShortName,"
 				   "-1 AS GrpCod"
 				   " FROM files,courses,degrees,centres,institutions,countries"
-				   " WHERE files.FilCod IN (SELECT FilCod FROM my_files_crs) AND %s"
-				   " AND files.FileBrowser IN (%u,%u,%u,%u)"
+				   " WHERE files.FileBrowser IN (%u,%u,%u,%u)"
+				   " AND files.Cod IN (%s) AND %s"
 				   " AND files.Cod=courses.CrsCod"
 				   " AND courses.DegCod=degrees.DegCod"
 				   " AND degrees.CtrCod=centres.CtrCod"
@@ -855,8 +850,8 @@ static unsigned Sch_SearchDocumentsInMyCoursesInDB (const char *RangeQuery)
 				   "courses.CrsCod,courses.ShortName AS CrsShortName,"
 				   "crs_grp.GrpCod"
 				   " FROM files,crs_grp,crs_grp_types,courses,degrees,centres,institutions,countries"
-				   " WHERE files.FilCod IN (SELECT FilCod FROM my_files_grp) AND %s"
-				   " AND files.FileBrowser IN (%u,%u,%u,%u)"
+				   " WHERE files.FileBrowser IN (%u,%u,%u,%u)"
+				   " AND files.Cod IN (%s) AND %s"
 				   " AND files.Cod=crs_grp.GrpCod"
 				   " AND crs_grp.GrpTypCod=crs_grp_types.GrpTypCod"
 				   " AND crs_grp_types.CrsCod=courses.CrsCod"
@@ -868,28 +863,28 @@ static unsigned Sch_SearchDocumentsInMyCoursesInDB (const char *RangeQuery)
 				   ") AS selected_files"
 				   " WHERE PathFromRoot<>''"
 				   " ORDER BY InsShortName,CtrShortName,DegShortName,CrsShortName,PathFromRoot",
-				   SearchQuery,
 				   (unsigned) Brw_ADMI_DOC_CRS,
 				   (unsigned) Brw_ADMI_TCH_CRS,
 				   (unsigned) Brw_ADMI_SHR_CRS,
 				   (unsigned) Brw_ADMI_MRK_CRS,
+				   MyCrssList,SearchQuery,
 				   RangeQuery,
-				   SearchQuery,
 				   (unsigned) Brw_ADMI_DOC_GRP,
 				   (unsigned) Brw_ADMI_TCH_GRP,
 				   (unsigned) Brw_ADMI_SHR_GRP,
 				   (unsigned) Brw_ADMI_MRK_GRP,
+				   MyGrpsList,SearchQuery,
 				   RangeQuery);
 
+	 /***** Free lists of my courses and my groups *****/
+	 free (MyCrssList);
+	 free (MyGrpsList);
+
 	 /***** List documents found *****/
 	 Brw_ListDocsFound (&mysql_res,NumDocs,
 	                    Txt_document_in_my_courses,
 	                    Txt_documents_in_my_courses);
 
-	 /***** Drop temporary table *****/
-	 DB_Query ("can not remove temporary table",
-		   "DROP TEMPORARY TABLE IF EXISTS my_files_crs,my_files_grp");
-
 	 return (unsigned) NumDocs;
 	}
 
@@ -912,7 +907,8 @@ static unsigned Sch_SearchMyDocumentsInDB (const char *RangeQuery)
    if (Sch_CheckIfIHavePermissionToSearch (Sch_SEARCH_MY_DOCUMENTS))
       /***** Split document string into words *****/
       if (Sch_BuildSearchQuery (SearchQuery,"SUBSTRING_INDEX(files.Path,'/',-1)",
-				"_latin1 "," COLLATE latin1_general_ci"))
+				"_latin1 "," COLLATE latin1_general_ci",
+				SchIdx_FILE_NAME,"files.FilCod"))
 	{
 	 /***** Build the query *****/
 	 NumDocs = DB_QuerySELECT (&mysql_res,"can not get files",
@@ -1053,12 +1049,15 @@ static unsigned Sch_SearchMyDocumentsInDB (const char *RangeQuery)
 /*****************************************************************************/
 /****** Build a search query by splitting a string to search into words ******/
 /*****************************************************************************/
+// CodField is the field with the code of the name, used to get candidates
+// from the index of names of type IndexType (NULL ==> index is not used)
 // Returns true if a valid search query is built
 // Returns false when no valid search query
 
 bool Sch_BuildSearchQuery (char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1],
                            const char *FieldName,
-                           const char *CharSet,const char *Collate)
+                           const char *CharSet,const char *Collate,
+                           SchIdx_Type_t IndexType,const char *CodField)
   {
    const char *Ptr;
    unsigned NumWords;
@@ -1068,10 +1067,12 @@ bool Sch_BuildSearchQuery (char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1],
    size_t MaxLengthWord = 0;
    char SearchWords[Sch_MAX_WORDS_IN_SEARCH][Sch_MAX_BYTES_SEARCH_WORD + 1];
    bool SearchWordIsValid = true;
+   struct SchIdx_Trigrams Trigrams;
 
    if (Gbl.Search.Str[0])
      {
       SearchQuery[0] = '\0';
+      SchIdx_ResetTrigrams (&Trigrams);
       Ptr = Gbl.Search.Str;
       for (NumWords = 0;
 	   NumWords < Sch_MAX_WORDS_IN_SEARCH && *Ptr;
@@ -1131,6 +1132,9 @@ bool Sch_BuildSearchQuery (char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1],
 	       if (Collate[0])
 		  Str_Concat (SearchQuery,Collate,
 		              Sch_MAX_BYTES_SEARCH_QUERY);
+
+	    /* Names with this word must have all its trigrams */
+	    SchIdx_AddTrigramsOfWord (&Trigrams,SearchWords[NumWords]);
 	   }
 	}
 
@@ -1139,6 +1143,12 @@ bool Sch_BuildSearchQuery (char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1],
 	  MaxLengthWord < Sch_MIN_LENGTH_LONGEST_WORD)
 	 return false;
 
+      /***** Get candidates from index of names
+             instead of comparing all the names *****/
+      if (CodField)
+	 SchIdx_AddSearchCondition (SearchQuery,Sch_MAX_BYTES_SEARCH_QUERY,
+				    IndexType,CodField,&Trigrams);
+
       return true;
      }
 
@@ -27,6 +27,8 @@
 /********************************** Headers **********************************/
 /*****************************************************************************/
 
+#include "swad_search_index.h"
+
 /*****************************************************************************/
 /****************************** Public constants *****************************/
 /*****************************************************************************/
@@ -81,7 +83,8 @@ void Sch_SysSearch (void);
 
 bool Sch_BuildSearchQuery (char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1],
                            const char *FieldName,
-                           const char *CharSet,const char *Collate);
+                           const char *CharSet,const char *Collate,
+                           SchIdx_Type_t IndexType,const char *CodField);
 
 void Sch_PutLinkToSearchCoursesParams (__attribute__((unused)) void *Args);
 
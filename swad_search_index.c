@@ -0,0 +1,440 @@
+// swad_search_index.c: index of trigrams of names, used to search
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <ctype.h>		// For isspace, tolower
+#include <stdbool.h>		// For boolean type
+#include <stdio.h>		// For sprintf
+#include <stdlib.h>		// For malloc, free
+#include <string.h>		// For strlen, strchr
+
+#include "swad_constant.h"
+#include "swad_database.h"
+#include "swad_layout.h"
+#include "swad_search_index.h"
+#include "swad_string.h"
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Table sch_trigrams stores, for each name, the trigrams
+   (3 consecutive characters in a word) of the name,
+   with case and accents folded.
+   A name contains a word only if it contains all the trigrams of the word,
+   so a search gets first the names with all the trigrams
+   using the index of sch_trigrams (an intersection of lists of codes),
+   and then only these candidates are compared using LIKE.
+   Words shorter than a trigram do not restrict the candidates.
+   The index is updated when names are created, renamed or removed.
+   Names existing before the index are indexed in background,
+   and the index is not used for a type of names until all are indexed.
+*/
+#define SchIdx_MAX_ROWS_PER_BATCH		1000	// Maximum number of names indexed in background each time
+#define SchIdx_MAX_BYTES_TRIGRAM_IN_INSERT	(3 * Cns_MAX_DECIMAL_DIGITS_LONG + 8)	// "(Type,Cod,Trigram),"
+
+static const struct
+  {
+   const char *Table;
+   const char *CodField;
+   const char *Name;
+  } SchIdx_Sources[SchIdx_NUM_TYPES] =
+  {
+   [SchIdx_USR_NAME ] = {"usr_data"    ,"UsrCod","CONCAT_WS(' ',FirstName,Surname1,Surname2)"},
+   [SchIdx_INS_NAME ] = {"institutions","InsCod","FullName"},
+   [SchIdx_CTR_NAME ] = {"centres"     ,"CtrCod","FullName"},
+   [SchIdx_DEG_NAME ] = {"degrees"     ,"DegCod","FullName"},
+   [SchIdx_CRS_NAME ] = {"courses"     ,"CrsCod","FullName"},
+   [SchIdx_FILE_NAME] = {"files"       ,"FilCod","SUBSTRING_INDEX(Path,'/',-1)"},
+  };
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static void SchIdx_InsertTrigramsOfName (SchIdx_Type_t Type,long Cod,
+                                         const char *Name);
+static bool SchIdx_CheckIfAllNamesAreIndexed (SchIdx_Type_t Type);
+static unsigned SchIdx_GetTrigrams (const char *Str,const char *Separators,
+                                    unsigned long *Trigrams,unsigned MaxTrigrams);
+static unsigned char SchIdx_FoldChar (unsigned char Ch);
+
+/*****************************************************************************/
+/******************* Index the name of a user, place or file *****************/
+/*****************************************************************************/
+// Call this function after a name is inserted or changed in database
+
+void SchIdx_IndexRow (SchIdx_Type_t Type,long Cod)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+
+   /***** Remove trigrams of old name *****/
+   SchIdx_RemoveRow (Type,Cod);
+
+   /***** Get current name and insert its trigrams *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get name to index",
+		       "SELECT %s FROM %s WHERE %s=%ld",
+		       SchIdx_Sources[Type].Name,
+		       SchIdx_Sources[Type].Table,
+		       SchIdx_Sources[Type].CodField,Cod))
+     {
+      row = mysql_fetch_row (mysql_res);
+      if (row[0])
+	 SchIdx_InsertTrigramsOfName (Type,Cod,row[0]);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+/*****************************************************************************/
+/*************** Remove the name of a user, place or file ********************/
+/*****************************************************************************/
+
+void SchIdx_RemoveRow (SchIdx_Type_t Type,long Cod)
+  {
+   DB_QueryDELETE ("can not remove name from index",
+		   "DELETE FROM sch_trigrams WHERE Type=%u AND Cod=%ld",
+		   (unsigned) Type,Cod);
+  }
+
+/*****************************************************************************/
+/**************** Index names existing before the index **********************/
+/*****************************************************************************/
+// Names are indexed in ascending order of code, a batch each time
+
+void SchIdx_IndexNextRows (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   SchIdx_Type_t Type;
+   unsigned UnsignedNum;
+   long LastCod;
+   unsigned long NumRows;
+   unsigned long NumRow;
+   long Cod;
+
+   /***** Create progress of types not yet indexed *****/
+   for (Type  = (SchIdx_Type_t) 0;
+	Type <= (SchIdx_Type_t) (SchIdx_NUM_TYPES - 1);
+	Type++)
+      DB_QueryINSERT ("can not create progress of index",
+		      "INSERT IGNORE INTO sch_indexed"
+		      " (Type,LastCod,Complete)"
+		      " VALUES"
+		      " (%u,0,'N')",
+		      (unsigned) Type);
+
+   /***** Get the first type of names not completely indexed *****/
+   if (!DB_QuerySELECT (&mysql_res,"can not get progress of index",
+			"SELECT Type,LastCod FROM sch_indexed"
+			" WHERE Complete='N'"
+			" ORDER BY Type LIMIT 1"))
+     {
+      DB_FreeMySQLResult (&mysql_res);
+      return;	// All names are indexed
+     }
+   row = mysql_fetch_row (mysql_res);
+
+   /* Get type (row[0]) */
+   if (sscanf (row[0],"%u",&UnsignedNum) != 1)
+      Lay_ShowErrorAndExit ("Error when getting progress of index.");
+   if (UnsignedNum >= SchIdx_NUM_TYPES)
+      Lay_ShowErrorAndExit ("Wrong type of index.");
+   Type = (SchIdx_Type_t) UnsignedNum;
+
+   /* Get last code indexed (row[1]) */
+   LastCod = Str_ConvertStrCodToLongCod (row[1]);
+
+   /* Free structure that stores the query result */
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Index next names.
+	  Trigrams are only inserted (never removed) here, so if a name
+	  is changed at the same time, its trigrams are not lost *****/
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get names to index",
+			     "SELECT %s,%s FROM %s"
+			     " WHERE %s>%ld"
+			     " ORDER BY %s LIMIT %u",
+			     SchIdx_Sources[Type].CodField,
+			     SchIdx_Sources[Type].Name,
+			     SchIdx_Sources[Type].Table,
+			     SchIdx_Sources[Type].CodField,LastCod,
+			     SchIdx_Sources[Type].CodField,
+			     SchIdx_MAX_ROWS_PER_BATCH);
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+
+      /* Get code (row[0]) and name (row[1]) */
+      if ((Cod = Str_ConvertStrCodToLongCod (row[0])) > 0)
+	{
+	 if (row[1])
+	    SchIdx_InsertTrigramsOfName (Type,Cod,row[1]);
+	 LastCod = Cod;
+	}
+     }
+
+   /* Free structure that stores the query result */
+   DB_FreeMySQLResult (&mysql_res);
+
+   /***** Update progress *****/
+   DB_QueryUPDATE ("can not update progress of index",
+		   "UPDATE sch_indexed SET LastCod=%ld,Complete='%c'"
+		   " WHERE Type=%u",
+		   LastCod,
+		   NumRows < SchIdx_MAX_ROWS_PER_BATCH ? 'Y' :
+							 'N',
+		   (unsigned) Type);
+  }
+
+/*****************************************************************************/
+/******************** Insert into index the trigrams of a name ***************/
+/*****************************************************************************/
+
+static void SchIdx_InsertTrigramsOfName (SchIdx_Type_t Type,long Cod,
+                                         const char *Name)
+  {
+   unsigned long *Trigrams;
+   unsigned NumTrigrams;
+   unsigned NumTrigram;
+   char *Query;
+   char *Ptr;
+   size_t Length = strlen (Name);
+
+   if (Length < 3)
+      return;
+
+   /***** Get trigrams of name *****/
+   if ((Trigrams = (unsigned long *) malloc (Length * sizeof (unsigned long))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   NumTrigrams = SchIdx_GetTrigrams (Name," \t\r\n",Trigrams,(unsigned) Length);
+
+   /***** Insert trigrams (repeated trigrams are ignored) *****/
+   if (NumTrigrams)
+     {
+      if ((Query = (char *) malloc (128 + NumTrigrams * SchIdx_MAX_BYTES_TRIGRAM_IN_INSERT)) == NULL)
+	 Lay_NotEnoughMemoryExit ();
+      Ptr = Query;
+      Ptr += sprintf (Ptr,"INSERT IGNORE INTO sch_trigrams"
+			  " (Type,Cod,Trigram)"
+			  " VALUES");
+      for (NumTrigram = 0;
+	   NumTrigram < NumTrigrams;
+	   NumTrigram++)
+	 Ptr += sprintf (Ptr,"%s(%u,%ld,%lu)",
+			 NumTrigram ? "," :
+				      " ",
+			 (unsigned) Type,Cod,Trigrams[NumTrigram]);
+      DB_QueryINSERT ("can not index name",
+		      "%s",
+		      Query);
+      free (Query);
+     }
+
+   free (Trigrams);
+  }
+
+/*****************************************************************************/
+/******************* Check if all names of a type are indexed ****************/
+/*****************************************************************************/
+
+static bool SchIdx_CheckIfAllNamesAreIndexed (SchIdx_Type_t Type)
+  {
+   return (DB_QueryCOUNT ("can not check progress of index",
+			  "SELECT COUNT(*) FROM sch_indexed"
+			  " WHERE Type=%u AND Complete='Y'",
+			  (unsigned) Type) != 0);
+  }
+
+/*****************************************************************************/
+/****************** Reset list of trigrams of searched words *****************/
+/*****************************************************************************/
+
+void SchIdx_ResetTrigrams (struct SchIdx_Trigrams *Trigrams)
+  {
+   Trigrams->Num = 0;
+  }
+
+/*****************************************************************************/
+/****************** Add the trigrams of a searched word **********************/
+/*****************************************************************************/
+// Wildcards of LIKE ('%' and '_') and escape character ('\') split the word,
+// because any character may be in their place
+
+void SchIdx_AddTrigramsOfWord (struct SchIdx_Trigrams *Trigrams,const char *Word)
+  {
+   unsigned long WordTrigrams[SchIdx_MAX_TRIGRAMS_IN_SEARCH];
+   unsigned NumWordTrigrams;
+   unsigned NumWordTrigram;
+   unsigned NumTrigram;
+   bool Found;
+
+   NumWordTrigrams = SchIdx_GetTrigrams (Word," \t\r\n%_\\",
+					 WordTrigrams,SchIdx_MAX_TRIGRAMS_IN_SEARCH);
+
+   /***** Add trigrams not repeated, until the list is full *****/
+   for (NumWordTrigram = 0;
+	NumWordTrigram < NumWordTrigrams &&
+	Trigrams->Num < SchIdx_MAX_TRIGRAMS_IN_SEARCH;
+	NumWordTrigram++)
+     {
+      for (NumTrigram = 0, Found = false;
+	   !Found && NumTrigram < Trigrams->Num;
+	   NumTrigram++)
+	 Found = (Trigrams->Trigrams[NumTrigram] == WordTrigrams[NumWordTrigram]);
+      if (!Found)
+	 Trigrams->Trigrams[Trigrams->Num++] = WordTrigrams[NumWordTrigram];
+     }
+  }
+
+/*****************************************************************************/
+/********** Add to a search query a condition using the index ****************/
+/*****************************************************************************/
+// CodField is the field of the code of the name in the search query.
+// The condition is not added if the index is not complete,
+// if there are no trigrams or if the query would be too long
+
+void SchIdx_AddSearchCondition (char *SearchQuery,size_t MaxBytes,
+                                SchIdx_Type_t Type,const char *CodField,
+                                const struct SchIdx_Trigrams *Trigrams)
+  {
+   char Condition[256 + SchIdx_MAX_TRIGRAMS_IN_SEARCH * (Cns_MAX_DECIMAL_DIGITS_LONG + 1)];
+   char *Ptr;
+   unsigned NumTrigram;
+
+   /***** Check if index can be used *****/
+   if (!Trigrams->Num)
+      return;
+   if (!SchIdx_CheckIfAllNamesAreIndexed (Type))
+      return;
+
+   /***** Build condition: names with all the trigrams *****/
+   Ptr = Condition;
+   Ptr += sprintf (Ptr," AND %s IN"
+		       " (SELECT Cod FROM"
+		       " (SELECT Cod FROM sch_trigrams"
+		       " WHERE Type=%u AND Trigram IN (",
+		   CodField,(unsigned) Type);
+   for (NumTrigram = 0;
+	NumTrigram < Trigrams->Num;
+	NumTrigram++)
+      Ptr += sprintf (Ptr,"%s%lu",
+		      NumTrigram ? "," :
+				   "",
+		      Trigrams->Trigrams[NumTrigram]);
+   sprintf (Ptr,") GROUP BY Cod HAVING COUNT(*)=%u) AS sch_found)",
+	    Trigrams->Num);
+
+   /***** Add condition to query *****/
+   if (strlen (SearchQuery) + strlen (Condition) <= MaxBytes)
+      Str_Concat (SearchQuery,Condition,
+		  MaxBytes);
+  }
+
+/*****************************************************************************/
+/************************ Get the trigrams of a string ***********************/
+/*****************************************************************************/
+// Each trigram is coded as a number with the 3 folded characters
+// Return the number of trigrams (repeated trigrams are included)
+
+static unsigned SchIdx_GetTrigrams (const char *Str,const char *Separators,
+                                    unsigned long *Trigrams,unsigned MaxTrigrams)
+  {
+   unsigned NumTrigrams = 0;
+   unsigned NumCharsInWord = 0;
+   unsigned long Window = 0;	// Last folded characters in the current word
+
+   for (;
+	*Str && NumTrigrams < MaxTrigrams;
+	Str++)
+      if (strchr (Separators,*Str))
+	 NumCharsInWord = 0;
+      else
+	{
+	 Window = ((Window << 8) | SchIdx_FoldChar ((unsigned char) *Str)) & 0xFFFFFFUL;
+	 if (++NumCharsInWord >= 3)
+	    Trigrams[NumTrigrams++] = Window;
+	}
+
+   return NumTrigrams;
+  }
+
+/*****************************************************************************/
+/********************* Fold case and accents of a character ******************/
+/*****************************************************************************/
+// Folding must be at least as wide as the collations used to compare names,
+// so the index never excludes a name that LIKE would find
+
+static unsigned char SchIdx_FoldChar (unsigned char Ch)
+  {
+   /***** ASCII *****/
+   if (Ch < 0x80)
+      return (unsigned char) tolower (Ch);
+
+   /***** Latin-1 / Windows-1252 letters *****/
+   switch (Ch)
+     {
+      case 0x8A: case 0x9A:						//  
+	 return 's';
+      case 0x8E: case 0x9E:						//  
+	 return 'z';
+      case 0x9F: case 0xDD: case 0xFD: case 0xFF:			//    
+	 return 'y';
+      case 0xC0: case 0xC1: case 0xC2: case 0xC3: case 0xC4: case 0xC5:	//      
+      case 0xE0: case 0xE1: case 0xE2: case 0xE3: case 0xE4: case 0xE5:	//      
+      case 0xC6: case 0xE6:						//  
+	 return 'a';
+      case 0xC7: case 0xE7:						//  
+	 return 'c';
+      case 0xC8: case 0xC9: case 0xCA: case 0xCB:			//    
+      case 0xE8: case 0xE9: case 0xEA: case 0xEB:			//    
+	 return 'e';
+      case 0xCC: case 0xCD: case 0xCE: case 0xCF:			//    
+      case 0xEC: case 0xED: case 0xEE: case 0xEF:			//    
+	 return 'i';
+      case 0xD0: case 0xF0:						//  
+	 return 'd';
+      case 0xD1: case 0xF1:						//  
+	 return 'n';
+      case 0xD2: case 0xD3: case 0xD4: case 0xD5: case 0xD6: case 0xD8:	//      
+      case 0xF2: case 0xF3: case 0xF4: case 0xF5: case 0xF6: case 0xF8:	//      
+	 return 'o';
+      case 0xD9: case 0xDA: case 0xDB: case 0xDC:			//    
+      case 0xF9: case 0xFA: case 0xFB: case 0xFC:			//    
+	 return 'u';
+      case 0xDE:							// 
+	 return 0xFE;							// 
+      case 0xDF:							// 
+	 return 's';
+      default:
+	 return Ch;
+     }
+  }
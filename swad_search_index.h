@@ -0,0 +1,69 @@
+// swad_search_index.h: index of trigrams of names, used to search
+
+#ifndef _SWAD_SCH_IDX
+#define _SWAD_SCH_IDX
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stddef.h>		// For size_t
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+#define SchIdx_NUM_TYPES 6
+typedef enum
+  {
+   SchIdx_USR_NAME	= 0,	// Cod = UsrCod
+   SchIdx_INS_NAME	= 1,	// Cod = InsCod
+   SchIdx_CTR_NAME	= 2,	// Cod = CtrCod
+   SchIdx_DEG_NAME	= 3,	// Cod = DegCod
+   SchIdx_CRS_NAME	= 4,	// Cod = CrsCod
+   SchIdx_FILE_NAME	= 5,	// Cod = FilCod
+  } SchIdx_Type_t;	// Do not change these numbers because they are used in database
+
+#define SchIdx_MAX_TRIGRAMS_IN_SEARCH 32	// Maximum number of trigrams used in a search
+
+struct SchIdx_Trigrams
+  {
+   unsigned Num;
+   unsigned long Trigrams[SchIdx_MAX_TRIGRAMS_IN_SEARCH];
+  };
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void SchIdx_IndexRow (SchIdx_Type_t Type,long Cod);
+void SchIdx_RemoveRow (SchIdx_Type_t Type,long Cod);
+void SchIdx_IndexNextRows (void);
+
+void SchIdx_ResetTrigrams (struct SchIdx_Trigrams *Trigrams);
+void SchIdx_AddTrigramsOfWord (struct SchIdx_Trigrams *Trigrams,const char *Word);
+void SchIdx_AddSearchCondition (char *SearchQuery,size_t MaxBytes,
+                                SchIdx_Type_t Type,const char *CodField,
+                                const struct SchIdx_Trigrams *Trigrams);
+
+#endif
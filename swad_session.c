@@ -144,8 +144,7 @@ void Ses_CloseSession (void)
       Gbl.Usrs.Me.IBelongToCurrentDeg = false;
       Gbl.Usrs.Me.IBelongToCurrentCrs = false;
       Gbl.Usrs.Me.Role.Logged = Rol_UNK;	// Don't uncomment this line. Don't change the role to unknown. Keep user's role in order to log the access
-      Gbl.Usrs.Me.MyCrss.Filled = false;
-      Gbl.Usrs.Me.MyCrss.Num = 0;
+      Usr_FreeMyCourses ();
 
       /***** Update number of open sessions in order to show them properly *****/
       Ses_GetNumSessions ();
@@ -0,0 +1,765 @@
+// swad_smtp.c: SMTP client to send automatic emails
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <ctype.h>		// For isdigit
+#include <netdb.h>		// For getaddrinfo
+#include <signal.h>		// For sigaction
+#include <stdarg.h>		// For va_list
+#include <string.h>		// For string functions
+#include <strings.h>		// For strcasecmp
+#include <sys/socket.h>		// For socket, connect
+#include <sys/time.h>		// For struct timeval
+#include <time.h>		// For time, gmtime_r
+#include <unistd.h>		// For close
+
+#include <openssl/evp.h>	// For EVP_EncodeBlock
+#include <openssl/ssl.h>	// For SSL connections
+
+#include "swad_smtp.h"
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+#define SMTP_TIMEOUT		30	// Seconds waiting for server before giving up
+
+#define SMTP_MAX_BYTES_COMMAND	2048
+#define SMTP_MAX_BYTES_AUTH	1024	// Bytes of user/password credentials
+#define SMTP_MAX_BYTES_BASE64	(((SMTP_MAX_BYTES_AUTH + 2) / 3) * 4)
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+// Names in Date header do not depend on locale
+static const char *SMTP_DayNames[7] =
+  {
+   "Sun","Mon","Tue","Wed","Thu","Fri","Sat",
+  };
+static const char *SMTP_MonthNames[12] =
+  {
+   "Jan","Feb","Mar","Apr","May","Jun",
+   "Jul","Aug","Sep","Oct","Nov","Dec",
+  };
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static bool SMTP_Connect (struct SMTP_Session *Session,
+                          const char *Server,const char *Port);
+static bool SMTP_StartTLS (struct SMTP_Session *Session,const char *Server);
+static bool SMTP_Hello (struct SMTP_Session *Session);
+static void SMTP_GetExtension (struct SMTP_Session *Session,const char *Extension);
+static bool SMTP_Login (struct SMTP_Session *Session,
+                        const char *User,const char *Password);
+static bool SMTP_EncodeBase64 (const char *Src,size_t Length,
+                               char Base64[SMTP_MAX_BYTES_BASE64 + 1]);
+
+static int SMTP_SendEnvelope (struct SMTP_Session *Session,
+                              const char *From,const char *To);
+static SMTP_Result_t SMTP_ResetMail (struct SMTP_Session *Session,int Code);
+static bool SMTP_WriteHeaders (struct SMTP_Session *Session,
+                               const char *From,const char *To,
+                               const char *Subject);
+static bool SMTP_WriteContent (struct SMTP_Session *Session,FILE *FileContent);
+
+static int SMTP_Command (struct SMTP_Session *Session,const char *fmt,...);
+static bool SMTP_WriteCommand (struct SMTP_Session *Session,const char *fmt,...);
+static bool SMTP_VWriteCommand (struct SMTP_Session *Session,
+                                const char *fmt,va_list ap);
+static int SMTP_ReadReply (struct SMTP_Session *Session,bool GetExtensions);
+static bool SMTP_ReadLine (struct SMTP_Session *Session);
+static bool SMTP_Write (struct SMTP_Session *Session,const char *Buf,size_t Length);
+static bool SMTP_Flush (struct SMTP_Session *Session);
+static void SMTP_Disconnect (struct SMTP_Session *Session);
+
+/*****************************************************************************/
+/*************** Open a session with SMTP server and log in ******************/
+/*****************************************************************************/
+// Return true if the session is ready to send emails
+// If ImplicitTLS (usually port 465), TLS is started just after connecting.
+// Else, STARTTLS is mandatory, so the password is never sent in clear
+
+bool SMTP_Open (struct SMTP_Session *Session,
+                const char *Server,const char *Port,bool ImplicitTLS,
+                const char *User,const char *Password)
+  {
+   /***** Connect to server *****/
+   if (!SMTP_Connect (Session,Server,Port))
+      return false;
+
+   /***** Start TLS before greeting when port requires it *****/
+   if (ImplicitTLS)
+      if (!SMTP_StartTLS (Session,Server))
+	{
+	 SMTP_Disconnect (Session);
+	 return false;
+	}
+
+   /***** Get greeting and identify myself *****/
+   if (SMTP_ReadReply (Session,false) != 220 ||
+       !SMTP_Hello (Session))
+     {
+      SMTP_Disconnect (Session);
+      return false;
+     }
+
+   /***** Put connection in TLS mode and identify myself again *****/
+   if (!Session->SSL)
+      if (!Session->ServerHasStartTLS ||
+          SMTP_Command (Session,"STARTTLS") != 220 ||
+          !SMTP_StartTLS (Session,Server) ||
+          !SMTP_Hello (Session))
+	{
+	 SMTP_Disconnect (Session);
+	 return false;
+	}
+
+   /***** Log in *****/
+   if (!SMTP_Login (Session,User,Password))
+     {
+      SMTP_Disconnect (Session);
+      return false;
+     }
+
+   return true;
+  }
+
+/*****************************************************************************/
+/********************** Open a connection with server ************************/
+/*****************************************************************************/
+
+static bool SMTP_Connect (struct SMTP_Session *Session,
+                          const char *Server,const char *Port)
+  {
+   struct sigaction SigPipe;
+   struct addrinfo Hints;
+   struct addrinfo *AddrList;
+   struct addrinfo *Addr;
+   struct timeval Timeout;
+
+   /***** Reset session *****/
+   Session->Socket = -1;
+   Session->Ctx = NULL;
+   Session->SSL = NULL;
+   Session->StartBuffer = Session->EndBuffer = 0;
+   Session->NumBytesOut = 0;
+   Session->Line[0] = '\0';
+   Session->ServerHasStartTLS   =
+   Session->ServerHasAuthPlain  =
+   Session->ServerHasAuthLogin  =
+   Session->ServerHasPipelining = false;
+
+   /***** Get addresses of server *****/
+   memset (&Hints,0,sizeof (Hints));
+   Hints.ai_family   = AF_UNSPEC;
+   Hints.ai_socktype = SOCK_STREAM;
+   if (getaddrinfo (Server,Port,&Hints,&AddrList))
+      return false;
+
+   /***** Try addresses until one connects *****/
+   Timeout.tv_sec  = SMTP_TIMEOUT;
+   Timeout.tv_usec = 0;
+   for (Addr = AddrList;
+	Addr != NULL;
+	Addr = Addr->ai_next)
+     {
+      if ((Session->Socket = socket (Addr->ai_family,Addr->ai_socktype,
+                                     Addr->ai_protocol)) < 0)
+	 continue;
+
+      /* Timeouts for receiving and sending (also used by connect) */
+      setsockopt (Session->Socket,SOL_SOCKET,SO_RCVTIMEO,&Timeout,sizeof (Timeout));
+      setsockopt (Session->Socket,SOL_SOCKET,SO_SNDTIMEO,&Timeout,sizeof (Timeout));
+
+      if (connect (Session->Socket,Addr->ai_addr,Addr->ai_addrlen) == 0)
+	 break;
+
+      close (Session->Socket);
+      Session->Socket = -1;
+     }
+   freeaddrinfo (AddrList);
+   if (Session->Socket < 0)
+      return false;
+
+   /***** A server closing the connection must not kill this process *****/
+   memset (&SigPipe,0,sizeof (SigPipe));
+   SigPipe.sa_handler = SIG_IGN;
+   sigaction (SIGPIPE,&SigPipe,&Session->OldSigPipe);
+
+   /***** Create TLS context.
+          Server certificate is verified against system CAs *****/
+   if ((Session->Ctx = SSL_CTX_new (TLS_client_method ())) == NULL)
+     {
+      SMTP_Disconnect (Session);
+      return false;
+     }
+   SSL_CTX_set_min_proto_version (Session->Ctx,TLS1_2_VERSION);
+   SSL_CTX_set_default_verify_paths (Session->Ctx);
+   SSL_CTX_set_verify (Session->Ctx,SSL_VERIFY_PEER,NULL);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/********************** Start TLS in current connection **********************/
+/*****************************************************************************/
+
+static bool SMTP_StartTLS (struct SMTP_Session *Session,const char *Server)
+  {
+   /***** Nothing received in clear can be used after starting TLS *****/
+   Session->StartBuffer = Session->EndBuffer = 0;
+
+   if ((Session->SSL = SSL_new (Session->Ctx)) == NULL)
+      return false;
+   SSL_set_tlsext_host_name (Session->SSL,Server);	// SNI
+   SSL_set1_host (Session->SSL,Server);			// Check name in certificate
+   SSL_set_fd (Session->SSL,Session->Socket);
+
+   return SSL_connect (Session->SSL) == 1;
+  }
+
+/*****************************************************************************/
+/************* Send EHLO and get the extensions supported by server **********/
+/*****************************************************************************/
+
+static bool SMTP_Hello (struct SMTP_Session *Session)
+  {
+   char HostName[256];
+
+   if (gethostname (HostName,sizeof (HostName)))
+      strcpy (HostName,"localhost");
+   HostName[sizeof (HostName) - 1] = '\0';
+
+   Session->ServerHasStartTLS   =
+   Session->ServerHasAuthPlain  =
+   Session->ServerHasAuthLogin  =
+   Session->ServerHasPipelining = false;
+
+   if (!SMTP_Write (Session,"EHLO ",5) ||
+       !SMTP_Write (Session,HostName,strlen (HostName)) ||
+       !SMTP_Write (Session,"\r\n",2))
+      return false;
+
+   return SMTP_ReadReply (Session,true) == 250;
+  }
+
+/*****************************************************************************/
+/************* Get an extension from a line of reply to EHLO *****************/
+/*****************************************************************************/
+
+static void SMTP_GetExtension (struct SMTP_Session *Session,const char *Extension)
+  {
+   char Keywords[SMTP_MAX_BYTES_LINE + 1];
+   char *Keyword;
+   char *SavePtr;
+
+   strcpy (Keywords,Extension);
+   if ((Keyword = strtok_r (Keywords," =",&SavePtr)) == NULL)
+      return;
+
+   if (!strcasecmp (Keyword,"STARTTLS"))
+      Session->ServerHasStartTLS = true;
+   else if (!strcasecmp (Keyword,"PIPELINING"))
+      Session->ServerHasPipelining = true;
+   else if (!strcasecmp (Keyword,"AUTH"))
+      while ((Keyword = strtok_r (NULL," =",&SavePtr)) != NULL)
+	{
+	 if (!strcasecmp (Keyword,"PLAIN"))
+	    Session->ServerHasAuthPlain = true;
+	 else if (!strcasecmp (Keyword,"LOGIN"))
+	    Session->ServerHasAuthLogin = true;
+	}
+  }
+
+/*****************************************************************************/
+/********************** Log in using PLAIN or LOGIN **************************/
+/*****************************************************************************/
+
+static bool SMTP_Login (struct SMTP_Session *Session,
+                        const char *User,const char *Password)
+  {
+   char Plain[SMTP_MAX_BYTES_AUTH];
+   char Base64[SMTP_MAX_BYTES_BASE64 + 1];
+   size_t LengthUser = strlen (User);
+   size_t LengthPassword = strlen (Password);
+
+   if (Session->ServerHasAuthPlain)
+     {
+      /***** AUTH PLAIN: base-64 of "\0user\0password" *****/
+      if (1 + LengthUser + 1 + LengthPassword > sizeof (Plain))
+	 return false;
+      Plain[0] = '\0';
+      memcpy (&Plain[1],User,LengthUser);
+      Plain[1 + LengthUser] = '\0';
+      memcpy (&Plain[1 + LengthUser + 1],Password,LengthPassword);
+      if (!SMTP_EncodeBase64 (Plain,1 + LengthUser + 1 + LengthPassword,Base64))
+	 return false;
+      return SMTP_Command (Session,"AUTH PLAIN %s",Base64) == 235;
+     }
+
+   if (Session->ServerHasAuthLogin)
+     {
+      /***** AUTH LOGIN: user and password are sent in two steps *****/
+      if (SMTP_Command (Session,"AUTH LOGIN") != 334)
+	 return false;
+      if (!SMTP_EncodeBase64 (User,LengthUser,Base64))
+	 return false;
+      if (SMTP_Command (Session,"%s",Base64) != 334)
+	 return false;
+      if (!SMTP_EncodeBase64 (Password,LengthPassword,Base64))
+	 return false;
+      return SMTP_Command (Session,"%s",Base64) == 235;
+     }
+
+   return false;
+  }
+
+/*****************************************************************************/
+/*************************** Encode in base-64 *******************************/
+/*****************************************************************************/
+
+static bool SMTP_EncodeBase64 (const char *Src,size_t Length,
+                               char Base64[SMTP_MAX_BYTES_BASE64 + 1])
+  {
+   if (Length > SMTP_MAX_BYTES_AUTH)
+      return false;
+
+   EVP_EncodeBlock ((unsigned char *) Base64,(const unsigned char *) Src,(int) Length);
+   return true;
+  }
+
+/*****************************************************************************/
+/******************* Send one email in an open session ***********************/
+/*****************************************************************************/
+// FileContent must be positioned at the start of the content.
+// Lines in content are sent ending in CRLF and with leading dots doubled.
+// On SMTP_CONNECTION_ERROR the session is already closed.
+
+SMTP_Result_t SMTP_SendMail (struct SMTP_Session *Session,
+                             const char *From,const char *To,
+                             const char *Subject,FILE *FileContent)
+  {
+   int Code;
+
+   if (Session->Socket < 0)
+      return SMTP_CONNECTION_ERROR;
+
+   /***** Envelope *****/
+   if ((Code = SMTP_SendEnvelope (Session,From,To)) != 354)
+      return SMTP_ResetMail (Session,Code);
+
+   /***** Message *****/
+   if (!SMTP_WriteHeaders (Session,From,To,Subject) ||
+       !SMTP_WriteContent (Session,FileContent) ||
+       !SMTP_Write (Session,".\r\n",3))
+     {
+      SMTP_Disconnect (Session);
+      return SMTP_CONNECTION_ERROR;
+     }
+
+   /***** Server reply once the whole message is received *****/
+   switch ((Code = SMTP_ReadReply (Session,false)))
+     {
+      case 250:
+	 return SMTP_OK;
+      case -1:
+      case 421:	// Service not available, closing connection
+	 SMTP_Disconnect (Session);
+	 return SMTP_CONNECTION_ERROR;
+      default:
+	 return SMTP_MAIL_REJECTED;
+     }
+  }
+
+/*****************************************************************************/
+/************ Send MAIL FROM, RCPT TO and DATA commands to server ************/
+/*****************************************************************************/
+// Return 354 if server is waiting for the message,
+// or the code of the first command rejected (-1 if connection is lost).
+// If server supports PIPELINING (RFC 2920), the three commands are sent
+// together and then the three replies are read, saving two round trips
+
+static int SMTP_SendEnvelope (struct SMTP_Session *Session,
+                              const char *From,const char *To)
+  {
+   int CodeMail;
+   int CodeRcpt;
+   int CodeData;
+
+   if (!Session->ServerHasPipelining)
+     {
+      if ((CodeMail = SMTP_Command (Session,"MAIL FROM:<%s>",From)) != 250)
+	 return CodeMail;
+      if ((CodeRcpt = SMTP_Command (Session,"RCPT TO:<%s>",To)) != 250 &&
+	  CodeRcpt != 251)
+	 return CodeRcpt;
+      return SMTP_Command (Session,"DATA");
+     }
+
+   /***** Send the three commands without waiting *****/
+   if (!SMTP_WriteCommand (Session,"MAIL FROM:<%s>",From) ||
+       !SMTP_WriteCommand (Session,"RCPT TO:<%s>",To) ||
+       !SMTP_WriteCommand (Session,"DATA"))
+      return -1;
+
+   /***** Read the three replies *****/
+   CodeMail = SMTP_ReadReply (Session,false);
+   CodeRcpt = SMTP_ReadReply (Session,false);
+   CodeData = SMTP_ReadReply (Session,false);
+
+   if (CodeMail != 250 ||
+       (CodeRcpt != 250 && CodeRcpt != 251))
+     {
+      /* Server must reject DATA when there is no valid recipient.
+         If not, the message would be sent incomplete,
+         so the connection is closed */
+      if (CodeData == 354)
+	 return -1;
+      return CodeMail != 250 ? CodeMail :
+			       CodeRcpt;
+     }
+
+   return CodeData;
+  }
+
+/*****************************************************************************/
+/*********** Abort current email after server rejected a command *************/
+/*****************************************************************************/
+
+static SMTP_Result_t SMTP_ResetMail (struct SMTP_Session *Session,int Code)
+  {
+   if (Code < 0 ||	// Connection lost
+       Code == 421 ||	// Service not available, closing connection
+       SMTP_Command (Session,"RSET") != 250)
+     {
+      SMTP_Disconnect (Session);
+      return SMTP_CONNECTION_ERROR;
+     }
+
+   return SMTP_MAIL_REJECTED;
+  }
+
+/*****************************************************************************/
+/************************** Write email headers ******************************/
+/*****************************************************************************/
+
+static bool SMTP_WriteHeaders (struct SMTP_Session *Session,
+                               const char *From,const char *To,
+                               const char *Subject)
+  {
+   char Headers[SMTP_MAX_BYTES_COMMAND];
+   time_t Now = time (NULL);
+   struct tm tm;
+   int Length;
+
+   gmtime_r (&Now,&tm);
+   Length = snprintf (Headers,sizeof (Headers),
+		      "From: %s\r\n"
+		      "To: %s\r\n"
+		      "Content-type: text/plain; charset=iso-8859-1\r\n"
+		      "Subject: %s\r\n"
+		      "Date: %s, %02d %s %04d %02d:%02d:%02d +0000\r\n"
+		      "\r\n",
+		      From,To,Subject,
+		      SMTP_DayNames[tm.tm_wday],tm.tm_mday,
+		      SMTP_MonthNames[tm.tm_mon],1900 + tm.tm_year,
+		      tm.tm_hour,tm.tm_min,tm.tm_sec);
+   if (Length < 0 || (size_t) Length >= sizeof (Headers))
+      return false;
+
+   return SMTP_Write (Session,Headers,(size_t) Length);
+  }
+
+/*****************************************************************************/
+/************ Write email content, converting line ends to CRLF **************/
+/*****************************************************************************/
+
+static bool SMTP_WriteContent (struct SMTP_Session *Session,FILE *FileContent)
+  {
+   int Ch;
+   char Byte;
+   bool StartOfLine = true;
+
+   while ((Ch = getc (FileContent)) != EOF)
+      switch (Ch)
+	{
+	 case '\r':	// Ignored, CRLF is written for each LF
+	    break;
+	 case '\n':
+	    if (!SMTP_Write (Session,"\r\n",2))
+	       return false;
+	    StartOfLine = true;
+	    break;
+	 default:
+	    /* A dot at start of line is doubled,
+	       so it can not be taken as end of message */
+	    if (StartOfLine && Ch == '.')
+	       if (!SMTP_Write (Session,".",1))
+		  return false;
+	    Byte = (char) Ch;
+	    if (!SMTP_Write (Session,&Byte,1))
+	       return false;
+	    StartOfLine = false;
+	    break;
+	}
+
+   /***** Last line must end in CRLF *****/
+   if (!StartOfLine)
+      return SMTP_Write (Session,"\r\n",2);
+
+   return true;
+  }
+
+/*****************************************************************************/
+/************************ Close session with server **************************/
+/*****************************************************************************/
+
+void SMTP_Close (struct SMTP_Session *Session)
+  {
+   if (Session->Socket >= 0)
+      SMTP_Command (Session,"QUIT");	// Reply is not important
+
+   SMTP_Disconnect (Session);
+  }
+
+/*****************************************************************************/
+/************ Send a command and return the code of server reply *************/
+/*****************************************************************************/
+// Return -1 if connection is lost
+
+static int SMTP_Command (struct SMTP_Session *Session,const char *fmt,...)
+  {
+   va_list ap;
+   bool Written;
+
+   va_start (ap,fmt);
+   Written = SMTP_VWriteCommand (Session,fmt,ap);
+   va_end (ap);
+   if (!Written)
+      return -1;
+
+   return SMTP_ReadReply (Session,false);
+  }
+
+/*****************************************************************************/
+/************ Write a command without waiting for server reply ***************/
+/*****************************************************************************/
+// The command is buffered and sent when the reply is read
+
+static bool SMTP_WriteCommand (struct SMTP_Session *Session,const char *fmt,...)
+  {
+   va_list ap;
+   bool Written;
+
+   va_start (ap,fmt);
+   Written = SMTP_VWriteCommand (Session,fmt,ap);
+   va_end (ap);
+
+   return Written;
+  }
+
+static bool SMTP_VWriteCommand (struct SMTP_Session *Session,
+                                const char *fmt,va_list ap)
+  {
+   char Command[SMTP_MAX_BYTES_COMMAND];
+   int Length;
+
+   Length = vsnprintf (Command,sizeof (Command) - 2,fmt,ap);
+   if (Length < 0 || (size_t) Length >= sizeof (Command) - 2)
+      return false;
+
+   Command[Length++] = '\r';
+   Command[Length++] = '\n';
+   return SMTP_Write (Session,Command,(size_t) Length);
+  }
+
+/*****************************************************************************/
+/************** Read a reply from server and return its code *****************/
+/*****************************************************************************/
+// A reply may have several lines: "250-..." lines followed by one "250 ..."
+// Return -1 if connection is lost or reply is not valid
+
+static int SMTP_ReadReply (struct SMTP_Session *Session,bool GetExtensions)
+  {
+   bool FirstLine = true;
+   int Code = -1;
+
+   /***** Commands pending to be sent must be sent before waiting *****/
+   if (!SMTP_Flush (Session))
+      return -1;
+
+   do
+     {
+      if (!SMTP_ReadLine (Session))
+	 return -1;
+      if (!isdigit ((unsigned char) Session->Line[0]) ||
+	  !isdigit ((unsigned char) Session->Line[1]) ||
+	  !isdigit ((unsigned char) Session->Line[2]) ||
+	  (Session->Line[3] != '\0' &&
+	   Session->Line[3] != ' ' &&
+	   Session->Line[3] != '-'))
+	 return -1;
+      Code = (Session->Line[0] - '0') * 100 +
+	     (Session->Line[1] - '0') * 10 +
+	     (Session->Line[2] - '0');
+
+      /* First line of reply to EHLO is the greeting */
+      if (GetExtensions && !FirstLine)
+	 SMTP_GetExtension (Session,&Session->Line[4]);
+      FirstLine = false;
+     }
+   while (Session->Line[3] == '-');
+
+   return Code;
+  }
+
+/*****************************************************************************/
+/*************** Read one line from server, without CRLF *********************/
+/*****************************************************************************/
+// Too long lines are truncated
+
+static bool SMTP_ReadLine (struct SMTP_Session *Session)
+  {
+   size_t Length = 0;
+   int NumBytes;
+   char Ch;
+
+   for (;;)
+     {
+      /***** Receive more bytes when buffer is empty *****/
+      if (Session->StartBuffer == Session->EndBuffer)
+	{
+	 if (Session->SSL)
+	    NumBytes = SSL_read (Session->SSL,Session->Buffer,
+				 (int) sizeof (Session->Buffer));
+	 else
+	    NumBytes = (int) recv (Session->Socket,Session->Buffer,
+				   sizeof (Session->Buffer),0);
+	 if (NumBytes <= 0)
+	    return false;
+	 Session->StartBuffer = 0;
+	 Session->EndBuffer = (size_t) NumBytes;
+	}
+
+      /***** Get next byte *****/
+      Ch = Session->Buffer[Session->StartBuffer++];
+      if (Ch == '\n')
+	{
+	 if (Length && Session->Line[Length - 1] == '\r')
+	    Length--;
+	 Session->Line[Length] = '\0';
+	 return true;
+	}
+      if (Length < SMTP_MAX_BYTES_LINE)
+	 Session->Line[Length++] = Ch;
+     }
+  }
+
+/*****************************************************************************/
+/****************** Write bytes to be sent to server *************************/
+/*****************************************************************************/
+// Bytes are buffered, so a message is sent in a few TLS records
+
+static bool SMTP_Write (struct SMTP_Session *Session,const char *Buf,size_t Length)
+  {
+   size_t NumBytes;
+
+   while (Length)
+     {
+      if (Session->NumBytesOut == sizeof (Session->OutBuffer))
+	 if (!SMTP_Flush (Session))
+	    return false;
+
+      NumBytes = sizeof (Session->OutBuffer) - Session->NumBytesOut;
+      if (NumBytes > Length)
+	 NumBytes = Length;
+      memcpy (&Session->OutBuffer[Session->NumBytesOut],Buf,NumBytes);
+      Session->NumBytesOut += NumBytes;
+      Buf += NumBytes;
+      Length -= NumBytes;
+     }
+
+   return true;
+  }
+
+/*****************************************************************************/
+/******************** Send buffered bytes to server **************************/
+/*****************************************************************************/
+
+static bool SMTP_Flush (struct SMTP_Session *Session)
+  {
+   size_t NumBytesSent = 0;
+   int NumBytes;
+
+   if (Session->Socket < 0)
+      return false;
+
+   while (NumBytesSent < Session->NumBytesOut)
+     {
+      if (Session->SSL)
+	 NumBytes = SSL_write (Session->SSL,&Session->OutBuffer[NumBytesSent],
+			       (int) (Session->NumBytesOut - NumBytesSent));
+      else
+	 NumBytes = (int) send (Session->Socket,&Session->OutBuffer[NumBytesSent],
+				Session->NumBytesOut - NumBytesSent,0);
+      if (NumBytes <= 0)
+	 return false;
+      NumBytesSent += (size_t) NumBytes;
+     }
+   Session->NumBytesOut = 0;
+
+   return true;
+  }
+
+/*****************************************************************************/
+/*************** Close connection and free TLS structures ********************/
+/*****************************************************************************/
+
+static void SMTP_Disconnect (struct SMTP_Session *Session)
+  {
+   if (Session->SSL)
+     {
+      SSL_free (Session->SSL);
+      Session->SSL = NULL;
+     }
+   if (Session->Ctx)
+     {
+      SSL_CTX_free (Session->Ctx);
+      Session->Ctx = NULL;
+     }
+   if (Session->Socket >= 0)
+     {
+      close (Session->Socket);
+      Session->Socket = -1;
+
+      /***** Restore previous action for SIGPIPE *****/
+      sigaction (SIGPIPE,&Session->OldSigPipe,NULL);
+     }
+   Session->NumBytesOut = 0;
+  }
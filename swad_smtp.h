@@ -0,0 +1,84 @@
+// swad_smtp.h: SMTP client to send automatic emails
+
+#ifndef _SWAD_SMTP
+#define _SWAD_SMTP
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <signal.h>		// For struct sigaction
+#include <stdbool.h>		// For boolean type
+#include <stdio.h>		// For FILE
+
+#include <openssl/ssl.h>	// For SSL connections
+
+/*****************************************************************************/
+/***************************** Public constants ******************************/
+/*****************************************************************************/
+
+#define SMTP_MAX_BYTES_LINE	1024	// Maximum length of a line received from server
+#define SMTP_MAX_BYTES_BUFFER	4096
+
+/*****************************************************************************/
+/******************************* Public types ********************************/
+/*****************************************************************************/
+
+typedef enum
+  {
+   SMTP_OK,			// Email accepted by server
+   SMTP_MAIL_REJECTED,		// Email rejected by server, but session is still usable
+   SMTP_CONNECTION_ERROR,	// Session lost, it must be opened again
+  } SMTP_Result_t;
+
+struct SMTP_Session
+  {
+   int Socket;
+   SSL_CTX *Ctx;
+   SSL *SSL;		// NULL while the connection is not encrypted
+   char Buffer[SMTP_MAX_BYTES_BUFFER];	// Bytes received and not processed yet
+   size_t StartBuffer;
+   size_t EndBuffer;
+   char Line[SMTP_MAX_BYTES_LINE + 1];	// Last line received from server
+   char OutBuffer[SMTP_MAX_BYTES_BUFFER];	// Bytes to be sent to server
+   size_t NumBytesOut;
+   struct sigaction OldSigPipe;		// Restored when session is closed
+   bool ServerHasStartTLS;
+   bool ServerHasAuthPlain;
+   bool ServerHasAuthLogin;
+   bool ServerHasPipelining;
+  };
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+bool SMTP_Open (struct SMTP_Session *Session,
+                const char *Server,const char *Port,bool ImplicitTLS,
+                const char *User,const char *Password);
+SMTP_Result_t SMTP_SendMail (struct SMTP_Session *Session,
+                             const char *From,const char *To,
+                             const char *Subject,FILE *FileContent);
+void SMTP_Close (struct SMTP_Session *Session);
+
+#endif
@@ -27,8 +27,8 @@
 
 #define _GNU_SOURCE 		// For asprintf
 #include <math.h>		// For log10, floor, ceil, modf, sqrt...
-#include <stdio.h>		// For asprintf
-#include <stdlib.h>		// For getenv, malloc
+#include <stdio.h>		// For asprintf, snprintf
+#include <stdlib.h>		// For free, getenv, malloc
 #include <string.h>		// For string functions
 
 #include "swad_banner.h"
@@ -39,9 +39,11 @@
 #include "swad_HTML.h"
 #include "swad_ID.h"
 #include "swad_log.h"
+#include "swad_log_archive.h"
 #include "swad_profile.h"
 #include "swad_role.h"
 #include "swad_statistic.h"
+#include "swad_statistic_rollup.h"
 
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
@@ -87,6 +89,8 @@ static const unsigned Sta_CellPadding[Sta_NUM_CLICKS_GROUPED_BY] =
 
 #define Sta_STAT_RESULTS_SECTION_ID	"stat_results"
 
+#define Sta_MAX_CLICKS_TO_COUNT	10000UL	// Clicks in detailed list are counted until this number
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
@@ -97,6 +101,14 @@ typedef enum
    Sta_SHOW_COURSE_ACCESSES,
   } Sta_GlobalOrCourseAccesses_t;
 
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+// Numbers of distinct users got from rollups are estimated (HyperLogLog),
+// with an error of about 13%, so they are shown as approximate
+static bool Sta_NumHitsAreEstimated = false;
+
 /*****************************************************************************/
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
@@ -107,9 +119,28 @@ static void Sta_PutFormGblHits (struct Sta_Stats *Stats);
 static void Sta_WriteSelectorCountType (const struct Sta_Stats *Stats);
 static void Sta_WriteSelectorAction (const struct Sta_Stats *Stats);
 static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse);
+static bool Sta_CheckIfClicksCanBeGotFromRollups (Sta_ClicksGroupedBy_t ClicksGroupedBy);
+static bool Sta_CheckIfClicksAreGroupedByTime (Sta_ClicksGroupedBy_t ClicksGroupedBy);
+static void Sta_WriteSelectGroupedByTime (char *Query,size_t Size,
+                                          Sta_ClicksGroupedBy_t ClicksGroupedBy,
+                                          const char *LocalTime,
+                                          const char *QueryCountType,
+                                          const char *FromTable);
+static const char *Sta_GetGroupByTime (Sta_ClicksGroupedBy_t ClicksGroupedBy);
+static void Sta_GroupUTCIntervalsInLocalTime (char **Query,
+                                              const struct Sta_Stats *Stats,
+                                              const char *LocalTime);
+static bool Sta_CheckIfIntervalsHaveUsrs (Sta_CountType_t CountType);
+static unsigned long Sta_GetNumClicksUpToMax (const char *Query);
 static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
+                                          unsigned long NumClicks,
                                           unsigned long NumRows,
                                           MYSQL_RES *mysql_res);
+static void Sta_PutFormToShowPageOfClicks (const struct Sta_Stats *Stats,
+                                           Sta_ClicksPage_t ClicksPage,
+                                           MYSQL_RES *mysql_res,
+                                           unsigned long KeyRow,
+                                           unsigned long FirstRow);
 static void Sta_WriteLogComments (long LogCod);
 static void Sta_ShowNumHitsPerUsr (Sta_CountType_t CountType,
                                    unsigned long NumRows,MYSQL_RES *mysql_res);
@@ -174,6 +205,8 @@ static void Sta_ShowNumHitsPerCourse (Sta_CountType_t CountType,
 static void Sta_DrawBarNumHits (char Color,
 				double HitsNum,double HitsMax,double HitsTotal,
 				unsigned MaxBarWidth);
+static void Sta_WriteNumHits (double HitsNum);
+
 /*****************************************************************************/
 /**************************** Reset stats context ****************************/
 /*****************************************************************************/
@@ -184,8 +217,10 @@ void Sta_ResetStats (struct Sta_Stats *Stats)
    Stats->Role            = Sta_ROLE_DEFAULT;
    Stats->CountType       = Sta_COUNT_TYPE_DEFAULT;
    Stats->NumAction       = Sta_NUM_ACTION_DEFAULT;
-   Stats->FirstRow        = 0;
-   Stats->LastRow         = 0;
+   Stats->ClicksPage      = Sta_CLICKS_PAGE_DEFAULT;
+   Stats->KeyTimeUTC      = (time_t) 0;
+   Stats->KeyLogCod       = -1L;
+   Stats->FirstRow        = 1;
    Stats->RowsPerPage     = Sta_DEF_ROWS_PER_PAGE;
   }
 
@@ -307,8 +342,6 @@ static void Sta_PutFormCrsHits (struct Sta_Stats *Stats)
          Frm_StartFormAnchor (ActSeeAccCrs,Sta_STAT_RESULTS_SECTION_ID);
 
          Grp_PutParamsCodGrps ();
-         Par_PutHiddenParamLong (NULL,"FirstRow",0);
-         Par_PutHiddenParamLong (NULL,"LastRow",0);
 
          /***** Put list of users to select some of them *****/
          HTM_TABLE_BeginCenterPadding (2);
@@ -755,7 +788,11 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
    long LengthQuery;
    MYSQL_RES *mysql_res;
    unsigned long NumRows;
+   unsigned long NumClicks = 0;
    const char *LogTable;
+   char *LogArchivesTable = NULL;
+   const char *FromTable;
+   char Condition[16 + Cns_MAX_DECIMAL_DIGITS_LONG + 1];
    Sta_ClicksDetailedOrGrouped_t DetailedOrGrouped = Sta_CLICKS_GROUPED;
    struct UsrData UsrDat;
    char BrowserTimeZone[Dat_MAX_BYTES_TIME_ZONE + 1];
@@ -763,8 +800,18 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
    const char *Ptr;
    char StrRole[256];
    char StrQueryCountType[Sta_MAX_BYTES_COUNT_TYPE + 1];
+   char *RollupCountType = NULL;
+   const char *QueryCountType;
+   struct Dat_TimeZoneChanges TimeZoneChanges;
+   bool TimeZoneIsKnown;
+   bool GroupInUTCIntervals;
+   unsigned SecondsPerInterval = 0;
+   char UTCTimeExpr[64];
+   char *LocalTime = NULL;
+   char StrUsrCod[64];
    unsigned NumDays;
    bool ICanQueryWholeRange;
+   bool UseRollups;
 
    /***** Reset stats context *****/
    Sta_ResetStats (&Stats);
@@ -853,17 +900,28 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
       case Sta_SHOW_COURSE_ACCESSES:
 	 if (Stats.ClicksGroupedBy == Sta_CLICKS_CRS_DETAILED_LIST)
 	   {
-	    /****** Get the number of the first row to show ******/
-	    Stats.FirstRow = Par_GetParToUnsignedLong ("FirstRow",
-						       1,
-						       ULONG_MAX,
-						       0);
-
-	    /****** Get the number of the last row to show ******/
-	    Stats.LastRow = Par_GetParToUnsignedLong ("LastRow",
-						      1,
-						      ULONG_MAX,
-						      0);
+	    /****** Get the page of clicks to show ******/
+	    Stats.ClicksPage = (Sta_ClicksPage_t)
+			       Par_GetParToUnsignedLong ("ClicksPage",
+							 0,
+							 Sta_NUM_CLICKS_PAGES - 1,
+							 (unsigned long) Sta_CLICKS_PAGE_DEFAULT);
+	    if (Stats.ClicksPage != Sta_MOST_RECENT_CLICKS)
+	      {
+	       /* Get the key of the click from which the page starts */
+	       Stats.KeyTimeUTC = (time_t)
+				  Par_GetParToUnsignedLong ("KeyTime",
+							    0,
+							    ULONG_MAX,
+							    0);
+	       Stats.KeyLogCod = Par_GetParToLong ("KeyLogCod");
+
+	       /* Get the number of the first click to show */
+	       Stats.FirstRow = Par_GetParToUnsignedLong ("FirstRow",
+							  1,
+							  ULONG_MAX,
+							  1);
+	      }
 
 	    /****** Get the number of rows per page ******/
 	    Stats.RowsPerPage =
@@ -915,6 +973,73 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
       return;
      }
 
+   /***** Get changes of UTC offset in browser time zone,
+          used to get local time without converting each click *****/
+   TimeZoneIsKnown = Dat_GetTimeZoneChanges (BrowserTimeZone,
+					     Gbl.DateRange.TimeUTC[Dat_START_TIME],
+					     Gbl.DateRange.TimeUTC[Dat_END_TIME  ],
+					     &TimeZoneChanges);
+
+   /***** Check if hits per hour, pre-aggregated from log, can be used *****/
+   UseRollups = GlobalOrCourse == Sta_SHOW_GLOBAL_ACCESSES &&
+	        Stats.Role != Sta_ROLE_ME &&		// Users are not stored in rollups
+	        Sta_CheckIfClicksCanBeGotFromRollups (Stats.ClicksGroupedBy) &&
+	        TimeZoneIsKnown &&
+		StaRol_CheckIfRollupsCanBeUsed (&TimeZoneChanges,
+						Gbl.DateRange.TimeUTC[Dat_START_TIME]);
+
+   /***** Check if clicks grouped by time can be counted in intervals
+          of UTC time, to group these intervals later by local time *****/
+   GroupInUTCIntervals = !UseRollups &&
+			 TimeZoneIsKnown &&
+			 Sta_CheckIfClicksAreGroupedByTime (Stats.ClicksGroupedBy);
+
+   if (UseRollups)
+     {
+      LogTable = "log_hours";
+      Dat_BuildLocalTimeExpression (&TimeZoneChanges,"log_hours.HourUTC",
+				    &LocalTime);
+      StaRol_BuildCountType (Stats.CountType,&RollupCountType);
+      QueryCountType = RollupCountType;
+      Sta_NumHitsAreEstimated = Sta_CheckIfIntervalsHaveUsrs (Stats.CountType);
+     }
+   else
+     {
+      if (GroupInUTCIntervals)
+	{
+	 /* Intervals must not cross changes of UTC offset */
+	 SecondsPerInterval = Dat_GetSecondsPerTimeZoneInterval (&TimeZoneChanges);
+	 if ((Stats.ClicksGroupedBy == Sta_CLICKS_CRS_PER_MINUTE ||
+	      Stats.ClicksGroupedBy == Sta_CLICKS_GBL_PER_MINUTE) &&
+	     SecondsPerInterval > 60)
+	    SecondsPerInterval = 60;
+	 snprintf (UTCTimeExpr,sizeof (UTCTimeExpr),"intervals.IntervalUTC*%u",
+		   SecondsPerInterval);
+	 Dat_BuildLocalTimeExpression (&TimeZoneChanges,UTCTimeExpr,
+				       &LocalTime);
+	}
+      else if (asprintf (&LocalTime,"CONVERT_TZ(ClickTime,@@session.time_zone,'%s')",
+			 BrowserTimeZone) < 0)	// Time zone not found in the operating system
+	 Lay_NotEnoughMemoryExit ();
+      QueryCountType = StrQueryCountType;
+     }
+
+   /***** Old clicks may be in archives of log *****/
+   if (!UseRollups && !strcmp (LogTable,"log"))
+     {
+      if (GlobalOrCourse == Sta_SHOW_COURSE_ACCESSES)
+	 snprintf (Condition,sizeof (Condition),"CrsCod=%ld",
+		   Gbl.Hierarchy.Crs.CrsCod);
+      LogArc_BuildLogTable (&LogArchivesTable,
+			    Gbl.DateRange.TimeUTC[Dat_START_TIME],
+			    Gbl.DateRange.TimeUTC[Dat_END_TIME  ],
+			    GlobalOrCourse == Sta_SHOW_COURSE_ACCESSES ? Condition :
+									 NULL);
+      FromTable = LogArchivesTable;
+     }
+   else
+      FromTable = LogTable;
+
    /***** Query depending on the type of count *****/
    switch (Stats.CountType)
      {
@@ -948,136 +1073,111 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
    	 snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE LogCod,UsrCod,Role,"
    		   "UNIX_TIMESTAMP(ClickTime) AS F,ActCod FROM %s",
-                   LogTable);
+                   FromTable);
 	 break;
       case Sta_CLICKS_CRS_PER_USR:
 	 snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE UsrCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_CRS_PER_DAY:
       case Sta_CLICKS_GBL_PER_DAY:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%Y%%m%%d') AS Day,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_DAY_AND_HOUR:
       case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%Y%%m%%d') AS Day,"
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%H') AS Hour,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_WEEK:
       case Sta_CLICKS_GBL_PER_WEEK:
-	 /* With %x%v the weeks are counted from monday to sunday.
-	    With %X%V the weeks are counted from sunday to saturday. */
-	 snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           (Gbl.Prefs.FirstDayOfWeek == 0) ?
-	           "SELECT SQL_NO_CACHE "	// Weeks start on monday
-		   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%x%%v') AS Week,"
-		   "%s FROM %s" :
-		   "SELECT SQL_NO_CACHE "	// Weeks start on sunday
-		   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%X%%V') AS Week,"
-		   "%s FROM %s",
-		   BrowserTimeZone,
-		   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_MONTH:
       case Sta_CLICKS_GBL_PER_MONTH:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%Y%%m') AS Month,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_YEAR:
       case Sta_CLICKS_GBL_PER_YEAR:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%Y') AS Year,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_HOUR:
       case Sta_CLICKS_GBL_PER_HOUR:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%H') AS Hour,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
-	 break;
       case Sta_CLICKS_CRS_PER_MINUTE:
       case Sta_CLICKS_GBL_PER_MINUTE:
-         snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
-   	           "SELECT SQL_NO_CACHE "
-                   "DATE_FORMAT(CONVERT_TZ(ClickTime,@@session.time_zone,'%s'),'%%H%%i') AS Minute,"
-                   "%s FROM %s",
-                   BrowserTimeZone,
-                   StrQueryCountType,LogTable);
+	 if (GroupInUTCIntervals)	// Grouped by local time at the end of the query
+	   {
+	    if (Sta_CheckIfIntervalsHaveUsrs (Stats.CountType))
+	       snprintf (StrUsrCod,sizeof (StrUsrCod),"%s.UsrCod AS UsrCod,",
+			 LogTable);
+	    else
+	       StrUsrCod[0] = '\0';
+	    snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
+		      "SELECT "		// SQL_NO_CACHE is not allowed in subqueries
+		      "UNIX_TIMESTAMP(%s.ClickTime) DIV %u AS IntervalUTC,"
+		      "%s"
+		      "COUNT(*) AS NumClicks,"
+		      "SUM(%s.TimeToGenerate) AS SumTimeToGenerate,"
+		      "SUM(%s.TimeToSend) AS SumTimeToSend"
+		      " FROM %s",
+		      LogTable,SecondsPerInterval,
+		      StrUsrCod,
+		      LogTable,
+		      LogTable,
+		      FromTable);
+	   }
+	 else
+	    Sta_WriteSelectGroupedByTime (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
+					  Stats.ClicksGroupedBy,
+					  LocalTime,QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_CRS_PER_ACTION:
       case Sta_CLICKS_GBL_PER_ACTION:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE ActCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_GBL_PER_PLUGIN:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE log_ws.PlgCod,%s AS Num FROM %s,log_ws",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
          break;
       case Sta_CLICKS_GBL_PER_API_FUNCTION:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE log_ws.FunCod,%s AS Num FROM %s,log_ws",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
          break;
       case Sta_CLICKS_GBL_PER_BANNER:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE log_banners.BanCod,%s AS Num FROM %s,log_banners",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
          break;
       case Sta_CLICKS_GBL_PER_COUNTRY:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE CtyCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_GBL_PER_INSTITUTION:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE InsCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_GBL_PER_CENTRE:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE CtrCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_GBL_PER_DEGREE:
          snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE DegCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
       case Sta_CLICKS_GBL_PER_COURSE:
 	 snprintf (Query,Sta_MAX_BYTES_QUERY_ACCESS + 1,
    	           "SELECT SQL_NO_CACHE CrsCod,%s AS Num FROM %s",
-                   StrQueryCountType,LogTable);
+                   QueryCountType,FromTable);
 	 break;
      }
-   sprintf (QueryAux," WHERE %s.ClickTime"
-	             " BETWEEN FROM_UNIXTIME(%ld) AND FROM_UNIXTIME(%ld)",
-            LogTable,
-            (long) Gbl.DateRange.TimeUTC[Dat_START_TIME],
-            (long) Gbl.DateRange.TimeUTC[Dat_END_TIME  ]);
+   if (UseRollups)
+      sprintf (QueryAux," WHERE log_hours.HourUTC"
+			" BETWEEN %ld AND %ld",
+	       (long) Gbl.DateRange.TimeUTC[Dat_START_TIME],
+	       (long) Gbl.DateRange.TimeUTC[Dat_END_TIME  ]);
+   else
+      sprintf (QueryAux," WHERE %s.ClickTime"
+			" BETWEEN FROM_UNIXTIME(%ld) AND FROM_UNIXTIME(%ld)",
+	       LogTable,
+	       (long) Gbl.DateRange.TimeUTC[Dat_START_TIME],
+	       (long) Gbl.DateRange.TimeUTC[Dat_END_TIME  ]);
    Str_Concat (Query,QueryAux,
                Sta_MAX_BYTES_QUERY_ACCESS);
 
@@ -1274,7 +1374,49 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
    switch (Stats.ClicksGroupedBy)
      {
       case Sta_CLICKS_CRS_DETAILED_LIST:
-	 Str_Concat (Query," ORDER BY F",
+	 /* Count clicks, only until a maximum */
+	 NumClicks = Sta_GetNumClicksUpToMax (Query);
+
+	 /* Get only the clicks in the page (and one more
+	    to know if there are more clicks) using the key
+	    (click time, log code) of the click from which the page starts */
+	 switch (Stats.ClicksPage)
+	   {
+	    case Sta_MOST_RECENT_CLICKS:
+	       snprintf (QueryAux,sizeof (QueryAux),
+			 " ORDER BY %s.ClickTime DESC,%s.LogCod DESC"
+			 " LIMIT %u",
+			 LogTable,LogTable,
+			 Stats.RowsPerPage + 1);
+	       break;
+	    case Sta_OLDER_CLICKS:
+	       snprintf (QueryAux,sizeof (QueryAux),
+			 " AND %s.ClickTime<=FROM_UNIXTIME(%ld)"
+			 " AND (%s.ClickTime<FROM_UNIXTIME(%ld)"
+			 " OR %s.LogCod<%ld)"
+			 " ORDER BY %s.ClickTime DESC,%s.LogCod DESC"
+			 " LIMIT %u",
+			 LogTable,(long) Stats.KeyTimeUTC,
+			 LogTable,(long) Stats.KeyTimeUTC,
+			 LogTable,Stats.KeyLogCod,
+			 LogTable,LogTable,
+			 Stats.RowsPerPage + 1);
+	       break;
+	    case Sta_NEWER_CLICKS:
+	       snprintf (QueryAux,sizeof (QueryAux),
+			 " AND %s.ClickTime>=FROM_UNIXTIME(%ld)"
+			 " AND (%s.ClickTime>FROM_UNIXTIME(%ld)"
+			 " OR %s.LogCod>%ld)"
+			 " ORDER BY %s.ClickTime,%s.LogCod"
+			 " LIMIT %u",
+			 LogTable,(long) Stats.KeyTimeUTC,
+			 LogTable,(long) Stats.KeyTimeUTC,
+			 LogTable,Stats.KeyLogCod,
+			 LogTable,LogTable,
+			 Stats.RowsPerPage + 1);
+	       break;
+	   }
+	 Str_Concat (Query,QueryAux,
 	             Sta_MAX_BYTES_QUERY_ACCESS);
 	 break;
       case Sta_CLICKS_CRS_PER_USR:
@@ -1284,38 +1426,23 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
 	 break;
       case Sta_CLICKS_CRS_PER_DAY:
       case Sta_CLICKS_GBL_PER_DAY:
-	 Str_Concat (Query," GROUP BY Day DESC",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_DAY_AND_HOUR:
       case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
-	 Str_Concat (Query," GROUP BY Day DESC,Hour",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_WEEK:
       case Sta_CLICKS_GBL_PER_WEEK:
-	 Str_Concat (Query," GROUP BY Week DESC",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_MONTH:
       case Sta_CLICKS_GBL_PER_MONTH:
-	 Str_Concat (Query," GROUP BY Month DESC",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_YEAR:
       case Sta_CLICKS_GBL_PER_YEAR:
-	 Str_Concat (Query," GROUP BY Year DESC",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_HOUR:
       case Sta_CLICKS_GBL_PER_HOUR:
-	 Str_Concat (Query," GROUP BY Hour",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
-	 break;
       case Sta_CLICKS_CRS_PER_MINUTE:
       case Sta_CLICKS_GBL_PER_MINUTE:
-	 Str_Concat (Query," GROUP BY Minute",
-	             Sta_MAX_BYTES_QUERY_ACCESS);
+	 if (GroupInUTCIntervals)
+	    Sta_GroupUTCIntervalsInLocalTime (&Query,&Stats,LocalTime);
+	 else
+	    Str_Concat (Query,Sta_GetGroupByTime (Stats.ClicksGroupedBy),
+			Sta_MAX_BYTES_QUERY_ACCESS);
 	 break;
       case Sta_CLICKS_CRS_PER_ACTION:
       case Sta_CLICKS_GBL_PER_ACTION:
@@ -1370,6 +1497,13 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
    NumRows = DB_QuerySELECT (&mysql_res,"can not get clicks",
 			     "%s",
 			     Query);
+   free (Query);
+   if (LocalTime)
+      free (LocalTime);
+   if (RollupCountType)
+      free (RollupCountType);
+   if (LogArchivesTable)
+      free (LogArchivesTable);
 
    /***** Count the number of rows in result *****/
    if (NumRows == 0)
@@ -1390,7 +1524,7 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
       switch (Stats.ClicksGroupedBy)
 	{
 	 case Sta_CLICKS_CRS_DETAILED_LIST:
-	    Sta_ShowDetailedAccessesList (&Stats,NumRows,mysql_res);
+	    Sta_ShowDetailedAccessesList (&Stats,NumClicks,NumRows,mysql_res);
 	    break;
 	 case Sta_CLICKS_CRS_PER_USR:
 	    Sta_ShowNumHitsPerUsr (Stats.CountType,NumRows,mysql_res);
@@ -1492,22 +1626,305 @@ static void Sta_ShowHits (Sta_GlobalOrCourseAccesses_t GlobalOrCourse)
      }
   }
 
+/*****************************************************************************/
+/******* Check if clicks can be got from hits per hour instead of log ********/
+/*****************************************************************************/
+
+static bool Sta_CheckIfClicksCanBeGotFromRollups (Sta_ClicksGroupedBy_t ClicksGroupedBy)
+  {
+   switch (ClicksGroupedBy)
+     {
+      case Sta_CLICKS_GBL_PER_DAY:
+      case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
+      case Sta_CLICKS_GBL_PER_WEEK:
+      case Sta_CLICKS_GBL_PER_MONTH:
+      case Sta_CLICKS_GBL_PER_YEAR:
+      case Sta_CLICKS_GBL_PER_HOUR:
+      case Sta_CLICKS_GBL_PER_ACTION:
+      case Sta_CLICKS_GBL_PER_COUNTRY:
+      case Sta_CLICKS_GBL_PER_INSTITUTION:
+      case Sta_CLICKS_GBL_PER_CENTRE:
+      case Sta_CLICKS_GBL_PER_DEGREE:
+      case Sta_CLICKS_GBL_PER_COURSE:
+	 return true;
+      default:	// Minutes, plugins, functions and banners are not in rollups
+	 return false;
+     }
+  }
+
+/*****************************************************************************/
+/******************* Check if clicks are grouped by time *********************/
+/*****************************************************************************/
+
+static bool Sta_CheckIfClicksAreGroupedByTime (Sta_ClicksGroupedBy_t ClicksGroupedBy)
+  {
+   switch (ClicksGroupedBy)
+     {
+      case Sta_CLICKS_CRS_PER_DAY:
+      case Sta_CLICKS_GBL_PER_DAY:
+      case Sta_CLICKS_CRS_PER_DAY_AND_HOUR:
+      case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
+      case Sta_CLICKS_CRS_PER_WEEK:
+      case Sta_CLICKS_GBL_PER_WEEK:
+      case Sta_CLICKS_CRS_PER_MONTH:
+      case Sta_CLICKS_GBL_PER_MONTH:
+      case Sta_CLICKS_CRS_PER_YEAR:
+      case Sta_CLICKS_GBL_PER_YEAR:
+      case Sta_CLICKS_CRS_PER_HOUR:
+      case Sta_CLICKS_GBL_PER_HOUR:
+      case Sta_CLICKS_CRS_PER_MINUTE:
+      case Sta_CLICKS_GBL_PER_MINUTE:
+	 return true;
+      default:
+	 return false;
+     }
+  }
+
+/*****************************************************************************/
+/************* Write the start of a query grouped by local time **************/
+/*****************************************************************************/
+
+static void Sta_WriteSelectGroupedByTime (char *Query,size_t Size,
+                                          Sta_ClicksGroupedBy_t ClicksGroupedBy,
+                                          const char *LocalTime,
+                                          const char *QueryCountType,
+                                          const char *FromTable)
+  {
+   switch (ClicksGroupedBy)
+     {
+      case Sta_CLICKS_CRS_PER_DAY:
+      case Sta_CLICKS_GBL_PER_DAY:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%Y%%m%%d') AS Day,"
+                   "%s FROM %s",
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_DAY_AND_HOUR:
+      case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%Y%%m%%d') AS Day,"
+                   "DATE_FORMAT(%s,'%%H') AS Hour,"
+                   "%s FROM %s",
+                   LocalTime,
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_WEEK:
+      case Sta_CLICKS_GBL_PER_WEEK:
+	 /* With %x%v the weeks are counted from monday to sunday.
+	    With %X%V the weeks are counted from sunday to saturday. */
+	 snprintf (Query,Size,
+   	           (Gbl.Prefs.FirstDayOfWeek == 0) ?
+	           "SELECT SQL_NO_CACHE "	// Weeks start on monday
+		   "DATE_FORMAT(%s,'%%x%%v') AS Week,"
+		   "%s FROM %s" :
+		   "SELECT SQL_NO_CACHE "	// Weeks start on sunday
+		   "DATE_FORMAT(%s,'%%X%%V') AS Week,"
+		   "%s FROM %s",
+		   LocalTime,
+		   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_MONTH:
+      case Sta_CLICKS_GBL_PER_MONTH:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%Y%%m') AS Month,"
+                   "%s FROM %s",
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_YEAR:
+      case Sta_CLICKS_GBL_PER_YEAR:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%Y') AS Year,"
+                   "%s FROM %s",
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_HOUR:
+      case Sta_CLICKS_GBL_PER_HOUR:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%H') AS Hour,"
+                   "%s FROM %s",
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      case Sta_CLICKS_CRS_PER_MINUTE:
+      case Sta_CLICKS_GBL_PER_MINUTE:
+         snprintf (Query,Size,
+   	           "SELECT SQL_NO_CACHE "
+                   "DATE_FORMAT(%s,'%%H%%i') AS Minute,"
+                   "%s FROM %s",
+                   LocalTime,
+                   QueryCountType,FromTable);
+	 break;
+      default:
+	 Query[0] = '\0';
+	 break;
+     }
+  }
+
+/*****************************************************************************/
+/************** Get the end of a query grouped by local time *****************/
+/*****************************************************************************/
+
+static const char *Sta_GetGroupByTime (Sta_ClicksGroupedBy_t ClicksGroupedBy)
+  {
+   switch (ClicksGroupedBy)
+     {
+      case Sta_CLICKS_CRS_PER_DAY:
+      case Sta_CLICKS_GBL_PER_DAY:
+	 return " GROUP BY Day DESC";
+      case Sta_CLICKS_CRS_PER_DAY_AND_HOUR:
+      case Sta_CLICKS_GBL_PER_DAY_AND_HOUR:
+	 return " GROUP BY Day DESC,Hour";
+      case Sta_CLICKS_CRS_PER_WEEK:
+      case Sta_CLICKS_GBL_PER_WEEK:
+	 return " GROUP BY Week DESC";
+      case Sta_CLICKS_CRS_PER_MONTH:
+      case Sta_CLICKS_GBL_PER_MONTH:
+	 return " GROUP BY Month DESC";
+      case Sta_CLICKS_CRS_PER_YEAR:
+      case Sta_CLICKS_GBL_PER_YEAR:
+	 return " GROUP BY Year DESC";
+      case Sta_CLICKS_CRS_PER_HOUR:
+      case Sta_CLICKS_GBL_PER_HOUR:
+	 return " GROUP BY Hour";
+      case Sta_CLICKS_CRS_PER_MINUTE:
+      case Sta_CLICKS_GBL_PER_MINUTE:
+	 return " GROUP BY Minute";
+      default:
+	 return "";
+     }
+  }
+
+/*****************************************************************************/
+/********* Group clicks counted in UTC intervals by browser local time *******/
+/*****************************************************************************/
+/*
+   Query has clicks grouped by intervals in UTC (hours or minutes)
+   with the number of clicks and the sums of times in each interval.
+   It's put as a subquery of a new query
+   that groups these intervals by local time.
+   So the local time is computed once per interval, not once per click.
+*/
+
+static void Sta_GroupUTCIntervalsInLocalTime (char **Query,
+                                              const struct Sta_Stats *Stats,
+                                              const char *LocalTime)
+  {
+   char QueryCountType[Sta_MAX_BYTES_COUNT_TYPE + 1];
+   char *FromTable;
+   char *QueryInLocalTime;
+   size_t Size;
+
+   /***** Count clicks from clicks in each interval *****/
+   switch (Stats->CountType)
+     {
+      case Sta_TOTAL_CLICKS:
+	 Str_Copy (QueryCountType,"SUM(intervals.NumClicks)",
+		   Sta_MAX_BYTES_COUNT_TYPE);
+	 break;
+      case Sta_DISTINCT_USRS:	// Intervals are grouped also by user
+	 Str_Copy (QueryCountType,"COUNT(DISTINCT(intervals.UsrCod))",
+		   Sta_MAX_BYTES_COUNT_TYPE);
+	 break;
+      case Sta_CLICKS_PER_USR:	// Intervals are grouped also by user
+	 Str_Copy (QueryCountType,"SUM(intervals.NumClicks)/"
+				  "GREATEST(COUNT(DISTINCT(intervals.UsrCod)),1)+0.000000",
+		   Sta_MAX_BYTES_COUNT_TYPE);
+	 break;
+      case Sta_GENERATION_TIME:
+	 Str_Copy (QueryCountType,"(SUM(intervals.SumTimeToGenerate)/"
+				  "SUM(intervals.NumClicks)/1E6)+0.000000",
+		   Sta_MAX_BYTES_COUNT_TYPE);
+	 break;
+      case Sta_SEND_TIME:
+	 Str_Copy (QueryCountType,"(SUM(intervals.SumTimeToSend)/"
+				  "SUM(intervals.NumClicks)/1E6)+0.000000",
+		   Sta_MAX_BYTES_COUNT_TYPE);
+	 break;
+     }
+
+   /***** End the query with intervals *****/
+   Str_Concat (*Query,Sta_CheckIfIntervalsHaveUsrs (Stats->CountType) ? " GROUP BY IntervalUTC,UsrCod" :
+									 " GROUP BY IntervalUTC",
+	       Sta_MAX_BYTES_QUERY_ACCESS);
+   if (asprintf (&FromTable,"(%s) AS intervals",*Query) < 0)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Build query grouped by local time *****/
+   Size = strlen (FromTable) + 2 * strlen (LocalTime) + 1024;
+   if ((QueryInLocalTime = (char *) malloc (Size + 1)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   Sta_WriteSelectGroupedByTime (QueryInLocalTime,Size + 1,
+                                 Stats->ClicksGroupedBy,
+                                 LocalTime,QueryCountType,FromTable);
+   Str_Concat (QueryInLocalTime,Sta_GetGroupByTime (Stats->ClicksGroupedBy),
+	       Size);
+   free (FromTable);
+
+   /***** Replace query *****/
+   free (*Query);
+   *Query = QueryInLocalTime;
+  }
+
+/*****************************************************************************/
+/******* Check if clicks in UTC intervals must be grouped also by user *******/
+/*****************************************************************************/
+
+static bool Sta_CheckIfIntervalsHaveUsrs (Sta_CountType_t CountType)
+  {
+   return CountType == Sta_DISTINCT_USRS ||
+	  CountType == Sta_CLICKS_PER_USR;
+  }
+
+/*****************************************************************************/
+/*********** Count the clicks selected by a query, up to a maximum ***********/
+/*****************************************************************************/
+// Counting is stopped at Sta_MAX_CLICKS_TO_COUNT to make it fast
+
+#define Sta_SELECT_NO_CACHE "SELECT SQL_NO_CACHE "
+
+static unsigned long Sta_GetNumClicksUpToMax (const char *Query)
+  {
+   /***** SQL_NO_CACHE is not allowed in subqueries *****/
+   if (!strncmp (Query,Sta_SELECT_NO_CACHE,strlen (Sta_SELECT_NO_CACHE)))
+      Query += strlen (Sta_SELECT_NO_CACHE);
+   else if (!strncmp (Query,"SELECT ",strlen ("SELECT ")))
+      Query += strlen ("SELECT ");
+
+   /***** Count clicks *****/
+   return DB_QueryCOUNT ("can not count clicks",
+			 "SELECT COUNT(*) FROM (SELECT %s LIMIT %lu) AS clicks",
+			 Query,Sta_MAX_CLICKS_TO_COUNT);
+  }
+
 /*****************************************************************************/
 /******************* Show a listing of detailed clicks ***********************/
 /*****************************************************************************/
+/*
+   Clicks are got from database in pages, using as key (click time, log code)
+   of the oldest or the most recent click shown in the current page,
+   so only the clicks in the page are transferred.
+   Clicks are shown from the most recent to the oldest,
+   but clicks newer than key are got in ascending order.
+*/
 
 static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
+                                          unsigned long NumClicks,
                                           unsigned long NumRows,
                                           MYSQL_RES *mysql_res)
   {
    extern Act_Action_t Act_FromActCodToAction[1 + Act_MAX_ACTION_COD];
-   extern const char *Txt_Show_previous_X_clicks;
-   extern const char *Txt_PAGES_Previous;
    extern const char *Txt_Clicks;
    extern const char *Txt_of_PART_OF_A_TOTAL;
    extern const char *Txt_page;
-   extern const char *Txt_Show_next_X_clicks;
-   extern const char *Txt_PAGES_Next;
    extern const char *Txt_No_INDEX;
    extern const char *Txt_User_ID;
    extern const char *Txt_Name;
@@ -1516,12 +1933,14 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
    extern const char *Txt_Action;
    extern const char *Txt_LOG_More_info;
    extern const char *Txt_ROLES_SINGUL_Abc[Rol_NUM_ROLES][Usr_NUM_SEXS];
-   unsigned long NumRow;
-   unsigned long FirstRow;	// First row to show
-   unsigned long LastRow;	// Last rows to show
-   unsigned long NumPagesBefore;
-   unsigned long NumPagesAfter;
-   unsigned long NumPagsTotal;
+   unsigned long NumRowsInPage;
+   unsigned long NumRowInPage;
+   unsigned long FirstRow;		// Number of the first click shown, counted from the most recent
+   unsigned long LastRow;		// Number of the last click shown, counted from the most recent
+   unsigned long NumRowMostRecent;	// Row in query result with the most recent click shown
+   unsigned long NumRowOldest;		// Row in query result with the oldest click shown
+   bool ThereAreOlderClicks;
+   bool ThereAreNewerClicks;
    struct UsrData UsrDat;
    MYSQL_ROW row;
    long LogCod;
@@ -1533,35 +1952,40 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
    /***** Initialize estructura of data of the user *****/
    Usr_UsrDataConstructor (&UsrDat);
 
-   /***** Compute the first and the last row to show *****/
+   /***** Compute the clicks to show.
+          One row more than the rows per page is got from database
+          to know if there are more clicks beyond this page *****/
+   NumRowsInPage = (NumRows > Stats->RowsPerPage) ? Stats->RowsPerPage :
+						    NumRows;
    FirstRow = Stats->FirstRow;
-   LastRow  = Stats->LastRow;
-   if (FirstRow == 0 && LastRow == 0) // Call from main form
-     {
-      // Show last clicks
-      FirstRow = (NumRows / Stats->RowsPerPage - 1) * Stats->RowsPerPage + 1;
-      if ((FirstRow + Stats->RowsPerPage - 1) < NumRows)
-	 FirstRow += Stats->RowsPerPage;
-      LastRow = NumRows;
-     }
-   if (FirstRow < 1) // For security reasons; really it should never be less than 1
-      FirstRow = 1;
-   if (LastRow > NumRows)
-      LastRow = NumRows;
-   if ((LastRow - FirstRow) >= Stats->RowsPerPage) // For if there have been clicks that have increased the number of rows
-      LastRow = FirstRow + Stats->RowsPerPage - 1;
-
-   /***** Compute the number total of pages *****/
-   /* Number of pages before the current one */
-   NumPagesBefore = (FirstRow-1) / Stats->RowsPerPage;
-   if (NumPagesBefore * Stats->RowsPerPage < (FirstRow-1))
-      NumPagesBefore++;
-   /* Number of pages after the current one */
-   NumPagesAfter = (NumRows - LastRow) / Stats->RowsPerPage;
-   if (NumPagesAfter * Stats->RowsPerPage < (NumRows - LastRow))
-      NumPagesAfter++;
-   /* Count the total number of pages */
-   NumPagsTotal = NumPagesBefore + 1 + NumPagesAfter;
+   switch (Stats->ClicksPage)
+     {
+      case Sta_NEWER_CLICKS:		// Clicks in ascending order
+	 ThereAreOlderClicks = true;
+	 ThereAreNewerClicks = (NumRows > Stats->RowsPerPage);
+	 if (!ThereAreNewerClicks)	// For if there have been new clicks
+	    FirstRow = 1;
+	 NumRowMostRecent = NumRowsInPage - 1;
+	 NumRowOldest     = 0;
+	 break;
+      case Sta_OLDER_CLICKS:		// Clicks in descending order
+	 ThereAreOlderClicks = (NumRows > Stats->RowsPerPage);
+	 ThereAreNewerClicks = true;
+	 NumRowMostRecent = 0;
+	 NumRowOldest     = NumRowsInPage - 1;
+	 break;
+      case Sta_MOST_RECENT_CLICKS:	// Clicks in descending order
+      default:
+	 ThereAreOlderClicks = (NumRows > Stats->RowsPerPage);
+	 ThereAreNewerClicks = false;
+	 FirstRow = 1;
+	 NumRowMostRecent = 0;
+	 NumRowOldest     = NumRowsInPage - 1;
+	 break;
+     }
+   LastRow = FirstRow + NumRowsInPage - 1;
+   if (NumClicks < LastRow)	// For if there have been new clicks
+      NumClicks = LastRow;
 
    /***** Put heading with backward and forward buttons *****/
    HTM_TR_Begin (NULL);
@@ -1571,70 +1995,39 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
    HTM_TR_Begin (NULL);
 
    /* Put link to jump to previous page (older clicks) */
-   if (FirstRow > 1)
-     {
-      Frm_StartFormAnchor (ActSeeAccCrs,Sta_STAT_RESULTS_SECTION_ID);
-      Dat_WriteParamsIniEndDates ();
-      Par_PutHiddenParamUnsigned (NULL,"GroupedBy",(unsigned) Sta_CLICKS_CRS_DETAILED_LIST);
-      Par_PutHiddenParamUnsigned (NULL,"StatAct"  ,(unsigned) Stats->NumAction);
-      Par_PutHiddenParamLong (NULL,"FirstRow",FirstRow - Stats->RowsPerPage);
-      Par_PutHiddenParamLong (NULL,"LastRow" ,FirstRow - 1);
-      Par_PutHiddenParamUnsigned (NULL,"RowsPage",Stats->RowsPerPage);
-      Usr_PutHiddenParSelectedUsrsCods (&Gbl.Usrs.Selected);
-     }
    HTM_TD_Begin ("class=\"LM\"");
-   if (FirstRow > 1)
-     {
-      HTM_BUTTON_SUBMIT_Begin (Str_BuildStringLong (Txt_Show_previous_X_clicks,
-						    (long) Stats->RowsPerPage),
-			       "BT_LINK TIT_TBL",NULL);
-      Str_FreeString ();
-      HTM_STRONG_Begin ();
-      HTM_TxtF ("&lt;%s",Txt_PAGES_Previous);
-      HTM_STRONG_End ();
-      HTM_BUTTON_End ();
-     }
+   if (ThereAreOlderClicks)
+      Sta_PutFormToShowPageOfClicks (Stats,Sta_OLDER_CLICKS,
+                                     mysql_res,NumRowOldest,
+                                     LastRow + 1);
    HTM_TD_End ();
-   if (FirstRow > 1)
-      Frm_EndForm ();
 
-   /* Write number of current page */
+   /* Write number of current page.
+      When clicks are not fully counted, the total is a lower bound */
    HTM_TD_Begin ("class=\"DAT_N CM\"");
    HTM_STRONG_Begin ();
-   HTM_TxtF ("%s %lu-%lu %s %lu (%s %ld %s %lu)",
-             Txt_Clicks,
-             FirstRow,LastRow,Txt_of_PART_OF_A_TOTAL,NumRows,
-             Txt_page,NumPagesBefore + 1,Txt_of_PART_OF_A_TOTAL,NumPagsTotal);
+   if (NumClicks < Sta_MAX_CLICKS_TO_COUNT)
+      HTM_TxtF ("%s %lu-%lu %s %lu (%s %lu %s %lu)",
+		Txt_Clicks,
+		FirstRow,LastRow,Txt_of_PART_OF_A_TOTAL,NumClicks,
+		Txt_page,(FirstRow - 1) / Stats->RowsPerPage + 1,
+		Txt_of_PART_OF_A_TOTAL,(NumClicks + Stats->RowsPerPage - 1) / Stats->RowsPerPage);
+   else
+      HTM_TxtF ("%s %lu-%lu %s &gt;%lu (%s %lu)",
+		Txt_Clicks,
+		FirstRow,LastRow,Txt_of_PART_OF_A_TOTAL,NumClicks,
+		Txt_page,(FirstRow - 1) / Stats->RowsPerPage + 1);
    HTM_STRONG_End ();
    HTM_TD_End ();
 
    /* Put link to jump to next page (more recent clicks) */
-   if (LastRow < NumRows)
-     {
-      Frm_StartFormAnchor (ActSeeAccCrs,Sta_STAT_RESULTS_SECTION_ID);
-      Dat_WriteParamsIniEndDates ();
-      Par_PutHiddenParamUnsigned (NULL,"GroupedBy",(unsigned) Sta_CLICKS_CRS_DETAILED_LIST);
-      Par_PutHiddenParamUnsigned (NULL,"StatAct"  ,(unsigned) Stats->NumAction);
-      Par_PutHiddenParamUnsigned (NULL,"FirstRow" ,(unsigned) (LastRow + 1));
-      Par_PutHiddenParamUnsigned (NULL,"LastRow"  ,(unsigned) (LastRow + Stats->RowsPerPage));
-      Par_PutHiddenParamUnsigned (NULL,"RowsPage" ,(unsigned) Stats->RowsPerPage);
-      Usr_PutHiddenParSelectedUsrsCods (&Gbl.Usrs.Selected);
-     }
    HTM_TD_Begin ("class=\"RM\"");
-   if (LastRow < NumRows)
-     {
-      HTM_BUTTON_SUBMIT_Begin (Str_BuildStringLong (Txt_Show_next_X_clicks,
-						    (long) Stats->RowsPerPage),
-			       "BT_LINK TIT_TBL",NULL);
-      Str_FreeString ();
-      HTM_STRONG_Begin ();
-      HTM_TxtF ("%s&gt;",Txt_PAGES_Next);
-      HTM_STRONG_End ();
-      HTM_BUTTON_End ();
-     }
+   if (ThereAreNewerClicks)
+      Sta_PutFormToShowPageOfClicks (Stats,Sta_NEWER_CLICKS,
+                                     mysql_res,NumRowMostRecent,
+                                     FirstRow > Stats->RowsPerPage ? FirstRow - Stats->RowsPerPage :
+								     1);
    HTM_TD_End ();
-   if (LastRow < NumRows)
-      Frm_EndForm ();
 
    HTM_TR_End ();
    HTM_TABLE_End ();
@@ -1654,12 +2047,13 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
 
    HTM_TR_End ();
 
-   /***** Write rows back *****/
-   for (NumRow = LastRow, UniqueId = 1, Gbl.RowEvenOdd = 0;
-	NumRow >= FirstRow;
-	NumRow--, UniqueId++, Gbl.RowEvenOdd = 1 - Gbl.RowEvenOdd)
+   /***** Write rows from the most recent to the oldest *****/
+   for (NumRowInPage = 0, UniqueId = 1, Gbl.RowEvenOdd = 0;
+	NumRowInPage < NumRowsInPage;
+	NumRowInPage++, UniqueId++, Gbl.RowEvenOdd = 1 - Gbl.RowEvenOdd)
      {
-      mysql_data_seek (mysql_res,(my_ulonglong) (NumRow - 1));
+      mysql_data_seek (mysql_res,(my_ulonglong) (Stats->ClicksPage == Sta_NEWER_CLICKS ? NumRowMostRecent - NumRowInPage :
+											NumRowInPage));
       row = mysql_fetch_row (mysql_res);
 
       /* Get log code */
@@ -1677,7 +2071,7 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
 
       /* Write the number of row */
       HTM_TD_Begin ("class=\"LOG RT COLOR%u\"",Gbl.RowEvenOdd);
-      HTM_TxtF ("%ld&nbsp;",NumRow);
+      HTM_TxtF ("%lu&nbsp;",FirstRow + NumRowInPage);
       HTM_TD_End ();
 
       /* Write the user's ID if user is a student */
@@ -1729,6 +2123,57 @@ static void Sta_ShowDetailedAccessesList (const struct Sta_Stats *Stats,
    Usr_UsrDataDestructor (&UsrDat);
   }
 
+/*****************************************************************************/
+/********** Put form to show the clicks older or newer than a click **********/
+/*****************************************************************************/
+
+static void Sta_PutFormToShowPageOfClicks (const struct Sta_Stats *Stats,
+                                           Sta_ClicksPage_t ClicksPage,
+                                           MYSQL_RES *mysql_res,
+                                           unsigned long KeyRow,
+                                           unsigned long FirstRow)
+  {
+   extern const char *Txt_Show_previous_X_clicks;
+   extern const char *Txt_PAGES_Previous;
+   extern const char *Txt_Show_next_X_clicks;
+   extern const char *Txt_PAGES_Next;
+   MYSQL_ROW row;
+
+   /***** Get key (click time, log code) of the click
+          from which the page starts *****/
+   mysql_data_seek (mysql_res,(my_ulonglong) KeyRow);
+   row = mysql_fetch_row (mysql_res);
+
+   /***** Begin form *****/
+   Frm_StartFormAnchor (ActSeeAccCrs,Sta_STAT_RESULTS_SECTION_ID);
+   Dat_WriteParamsIniEndDates ();
+   Par_PutHiddenParamUnsigned (NULL,"GroupedBy" ,(unsigned) Sta_CLICKS_CRS_DETAILED_LIST);
+   Par_PutHiddenParamUnsigned (NULL,"StatAct"   ,(unsigned) Stats->NumAction);
+   Par_PutHiddenParamUnsigned (NULL,"ClicksPage",(unsigned) ClicksPage);
+   Par_PutHiddenParamLong     (NULL,"KeyTime"   ,(long) Dat_GetUNIXTimeFromStr (row[3]));
+   Par_PutHiddenParamLong     (NULL,"KeyLogCod" ,Str_ConvertStrCodToLongCod (row[0]));
+   Par_PutHiddenParamLong     (NULL,"FirstRow"  ,(long) FirstRow);
+   Par_PutHiddenParamUnsigned (NULL,"RowsPage"  ,Stats->RowsPerPage);
+   Usr_PutHiddenParSelectedUsrsCods (&Gbl.Usrs.Selected);
+
+   /***** Link to previous (older) or next (more recent) clicks *****/
+   HTM_BUTTON_SUBMIT_Begin (Str_BuildStringLong (ClicksPage == Sta_OLDER_CLICKS ? Txt_Show_previous_X_clicks :
+										  Txt_Show_next_X_clicks,
+						 (long) Stats->RowsPerPage),
+			    "BT_LINK TIT_TBL",NULL);
+   Str_FreeString ();
+   HTM_STRONG_Begin ();
+   if (ClicksPage == Sta_OLDER_CLICKS)
+      HTM_TxtF ("&lt;%s",Txt_PAGES_Previous);
+   else
+      HTM_TxtF ("%s&gt;",Txt_PAGES_Next);
+   HTM_STRONG_End ();
+   HTM_BUTTON_End ();
+
+   /***** End form *****/
+   Frm_EndForm ();
+  }
+
 /*****************************************************************************/
 /******** Show a listing of with the number of clicks of each user ***********/
 /*****************************************************************************/
@@ -2308,14 +2753,14 @@ static void Sta_DrawBarColors (Sta_ColorType_t ColorType,double HitsMax)
       HTM_TD_Begin ("colspan=\"%u\" class=\"LOG CB\" style=\"width:%upx;\"",
 		    GRAPH_DISTRIBUTION_PER_HOUR_TOTAL_WIDTH/5,
 		    GRAPH_DISTRIBUTION_PER_HOUR_TOTAL_WIDTH/5);
-      HTM_DoubleFewDigits ((double) Interval * HitsMax / 5.0);
+      Sta_WriteNumHits ((double) Interval * HitsMax / 5.0);
       HTM_TD_End ();
      }
 
    HTM_TD_Begin ("colspan=\"%u\" class=\"LOG RB\" style=\"width:%upx;\"",
 		 (GRAPH_DISTRIBUTION_PER_HOUR_TOTAL_WIDTH/5)/2,
 		 (GRAPH_DISTRIBUTION_PER_HOUR_TOTAL_WIDTH/5)/2);
-   HTM_DoubleFewDigits (HitsMax);
+   Sta_WriteNumHits (HitsMax);
    HTM_TD_End ();
 
    HTM_TR_End ();
@@ -2360,8 +2805,10 @@ static void Sta_DrawAccessesPerHourForADay (Sta_ColorType_t ColorType,double Hit
       Str_DoubleNumToStrFewDigits (&Str,HitsNum[Hour]);
 
       /***** Write cell *****/
-      HTM_TD_Begin ("class=\"LOG LM\" title=\"%s\""
+      HTM_TD_Begin ("class=\"LOG LM\" title=\"%s%s\""
 	            " style=\"width:%upx; background-color:#%02X%02X%02X;\"",
+	            Sta_NumHitsAreEstimated ? "&asymp;" :
+					      "",
 	            Str,GRAPH_DISTRIBUTION_PER_HOUR_HOUR_WIDTH,R,G,B);
       HTM_TD_End ();
 
@@ -2830,7 +3277,7 @@ static void Sta_WriteAccessHour (unsigned Hour,struct Sta_Hits *Hits,unsigned Co
       HTM_TxtF ("%u%%",(unsigned) (((Hits->Num * 100.0) /
 		                     Hits->Total) + 0.5));
       HTM_BR ();
-      HTM_DoubleFewDigits (Hits->Num);
+      Sta_WriteNumHits (Hits->Num);
       HTM_BR ();
       BarHeight = (unsigned) (((Hits->Num * 500.0) / Hits->Max) + 0.5);
       if (BarHeight == 0)
@@ -3839,7 +4286,7 @@ static void Sta_DrawBarNumHits (char Color,
 
       /***** Write the number of hits *****/
       HTM_NBSP ();
-      HTM_DoubleFewDigits (HitsNum);
+      Sta_WriteNumHits (HitsNum);
       HTM_TxtF ("&nbsp;(%u",(unsigned) (((HitsNum * 100.0) /
         	                          HitsTotal) + 0.5));
      }
@@ -3852,6 +4299,17 @@ static void Sta_DrawBarNumHits (char Color,
    HTM_TD_End ();
   }
 
+/*****************************************************************************/
+/*************** Write a number of hits, marked if estimated *****************/
+/*****************************************************************************/
+
+static void Sta_WriteNumHits (double HitsNum)
+  {
+   if (Sta_NumHitsAreEstimated)
+      HTM_Txt ("&asymp;");
+   HTM_DoubleFewDigits (HitsNum);
+  }
+
 /*****************************************************************************/
 /**************** Compute the time used to generate the page *****************/
 /*****************************************************************************/
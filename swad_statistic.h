@@ -27,6 +27,8 @@
 /********************************* Headers ***********************************/
 /*****************************************************************************/
 
+#include <time.h>		// For time_t
+
 #include "swad_indicator.h"
 #include "swad_photo.h"
 #include "swad_user.h"
@@ -112,6 +114,15 @@ typedef enum
 #define Sta_MAX_ROWS_PER_PAGE (Sta_MIN_ROWS_PER_PAGE * 10000)
 #define Sta_DEF_ROWS_PER_PAGE (Sta_MIN_ROWS_PER_PAGE * 5)
 
+#define Sta_NUM_CLICKS_PAGES 3
+typedef enum
+  {
+   Sta_MOST_RECENT_CLICKS = 0,	// Page with the most recent clicks
+   Sta_OLDER_CLICKS       = 1,	// Page with clicks older than key
+   Sta_NEWER_CLICKS       = 2,	// Page with clicks newer than key
+  } Sta_ClicksPage_t;
+#define Sta_CLICKS_PAGE_DEFAULT Sta_MOST_RECENT_CLICKS
+
 #define Sta_NUM_COLOR_TYPES 3
 typedef enum
   {
@@ -134,8 +145,10 @@ struct Sta_Stats
    Sta_Role_t Role;
    Sta_CountType_t CountType;
    Act_Action_t NumAction;
-   unsigned long FirstRow;
-   unsigned long LastRow;
+   Sta_ClicksPage_t ClicksPage;
+   time_t KeyTimeUTC;		// Key (click time, log code) of the click...
+   long KeyLogCod;		// ...from which the page of clicks starts
+   unsigned long FirstRow;	// Number of the first click in the page, counted from the most recent
    unsigned RowsPerPage;
   };
 
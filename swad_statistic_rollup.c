@@ -0,0 +1,300 @@
+// swad_statistic_rollup.c: hits per hour pre-aggregated from log
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#define _GNU_SOURCE 		// For asprintf
+#include <stdio.h>		// For asprintf, sprintf
+#include <stdlib.h>		// For free, malloc
+
+#include "swad_config.h"
+#include "swad_database.h"
+#include "swad_global.h"
+#include "swad_layout.h"
+#include "swad_log_archive.h"
+#include "swad_statistic_rollup.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+/*
+   Hits in log are pre-aggregated in table log_hours, one row per hour (UTC)
+   and per action, role, course, degree, centre, institution and country.
+   Each row stores the number of clicks, the sums of times
+   and a sketch to estimate the number of distinct users (HyperLogLog).
+   The last hour rolled up may be incomplete, so it is recomputed
+   by the next rollup, replacing its rows.
+*/
+#define StaRol_MAX_HOURS_PER_ROLLUP	24	// Limit the hours of log scanned in a rollup
+
+#define StaRol_SECONDS_IN_RECENT_LOG ((time_t) ((Cfg_DAYS_IN_RECENT_LOG - 1) * 24UL * 60UL * 60UL))
+
+/* Sketch to estimate distinct users:
+   register = lowest 6 bits of the hash of user's code,
+   value    = position of the leftmost 1 in the remaining 26 bits */
+#define StaRol_NUM_REGISTERS		64
+#define StaRol_HASH_BITS		26
+#define StaRol_ALPHA_x_M_x_M		"2903.04"	// 0.709 * 64 * 64
+
+#define StaRol_MAX_BYTES_REGISTER_IN_SKETCH	192
+#define StaRol_MAX_BYTES_REGISTER_IN_ESTIMATE	64
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static void StaRol_BuildSketch (char **SketchStr);
+static void StaRol_BuildDistinctUsrsEstimate (char **EstimateStr);
+
+/*****************************************************************************/
+/************* Roll up the next hours of hits in a worker process ************/
+/*****************************************************************************/
+// Called by Wrk_RunDetachedTask, which needs a function without result
+
+void StaRol_RollUpNextHits (void)
+  {
+   StaRol_RollUpHits ();
+  }
+
+/*****************************************************************************/
+/******************* Roll up hits in log not rolled up yet *******************/
+/*****************************************************************************/
+// Return true if hits are rolled up until current hour
+
+bool StaRol_RollUpHits (void)
+  {
+   time_t CurrentHour = Gbl.StartExecutionTimeUTC - Gbl.StartExecutionTimeUTC % StaRol_SECONDS_PER_HOUR;
+   time_t LastHour;
+   time_t StartHour;
+   time_t EndHour;
+   char *LogTable;
+   char *SketchStr;
+
+   /***** Get last hour rolled up (it may be incomplete) *****/
+   LastHour = (time_t) DB_QueryCOUNT ("can not get last hour of hits",
+				      "SELECT COALESCE(MAX(HourUTC),0)"
+				      " FROM log_hours");
+
+   /***** Get first hour with hits from last hour rolled up,
+          skipping hours without hits (archived hits included) *****/
+   StartHour = LogArc_GetFirstClickTime (LastHour);
+   StartHour -= StartHour % StaRol_SECONDS_PER_HOUR;
+   if (!StartHour)	// No hits to roll up
+      return true;
+
+   /***** Limit the number of hours to roll up *****/
+   EndHour = StartHour + StaRol_MAX_HOURS_PER_ROLLUP * StaRol_SECONDS_PER_HOUR;
+   if (EndHour > CurrentHour + StaRol_SECONDS_PER_HOUR)
+      EndHour = CurrentHour + StaRol_SECONDS_PER_HOUR;
+
+   /***** Recent hits are faster to get from recent log *****/
+   if (StartHour >= Gbl.StartExecutionTimeUTC - StaRol_SECONDS_IN_RECENT_LOG)
+     {
+      if (asprintf (&LogTable,"log_recent") < 0)
+	 Lay_NotEnoughMemoryExit ();
+     }
+   else	// Old hits may be archived
+      LogArc_BuildLogTable (&LogTable,StartHour,EndHour - 1,NULL);
+
+   /***** Roll up hits replacing the rows of incomplete hours *****/
+   StaRol_BuildSketch (&SketchStr);
+   DB_QueryREPLACE ("can not roll up hits",
+		    "REPLACE INTO log_hours"
+		    " (HourUTC,ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod,"
+		    "NumClicks,SumTimeToGenerate,SumTimeToSend,Sketch)"
+		    " SELECT UNIX_TIMESTAMP(ClickTime) DIV %lu*%lu AS Hour,"
+		    "ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod,"
+		    "COUNT(*),SUM(TimeToGenerate),SUM(TimeToSend),%s"
+		    " FROM %s"
+		    " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+		    " AND ClickTime<FROM_UNIXTIME(%ld)"
+		    " GROUP BY Hour,ActCod,Role,CrsCod,DegCod,CtrCod,InsCod,CtyCod",
+		    (unsigned long) StaRol_SECONDS_PER_HOUR,
+		    (unsigned long) StaRol_SECONDS_PER_HOUR,
+		    SketchStr,
+		    LogTable,
+		    (long) StartHour,
+		    (long) EndHour);
+   free (SketchStr);
+   free (LogTable);
+
+   return EndHour > CurrentHour;
+  }
+
+/*****************************************************************************/
+/*************** Build expression to compute sketch of users *****************/
+/*****************************************************************************/
+// SketchStr must be freed by the caller
+
+static void StaRol_BuildSketch (char **SketchStr)
+  {
+   unsigned NumReg;
+   char *Ptr;
+
+   if ((*SketchStr = malloc (StaRol_NUM_REGISTERS *
+			     StaRol_MAX_BYTES_REGISTER_IN_SKETCH + 16)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** One byte per register with the maximum value for users in it *****/
+   Ptr = *SketchStr;
+   Ptr += sprintf (Ptr,"CONCAT(");
+   for (NumReg = 0;
+	NumReg < StaRol_NUM_REGISTERS;
+	NumReg++)
+      Ptr += sprintf (Ptr,"%sCHAR(MAX(IF(UsrCod>0 AND (CRC32(UsrCod)&%u)=%u,"
+			  "IF((CRC32(UsrCod)>>6)=0,%u,%u-FLOOR(LOG2(CRC32(UsrCod)>>6))),"
+			  "0)))",
+		      NumReg ? "," :
+			       "",
+		      StaRol_NUM_REGISTERS - 1,NumReg,
+		      StaRol_HASH_BITS + 1,StaRol_HASH_BITS);
+   sprintf (Ptr,")");
+  }
+
+/*****************************************************************************/
+/************ Check if hits per hour can be used for a statistic *************/
+/*****************************************************************************/
+
+bool StaRol_CheckIfRollupsCanBeUsed (const struct Dat_TimeZoneChanges *TimeZoneChanges,
+                                     time_t StartTimeUTC)
+  {
+   /***** Hours in rollups must be hours in browser time zone,
+          so time zones with fractions of hour, or with changes
+          of offset in the middle of an hour, can not be used *****/
+   if (Dat_GetSecondsPerTimeZoneInterval (TimeZoneChanges) != StaRol_SECONDS_PER_HOUR)
+      return false;
+
+   /***** Range must begin at the start of an hour *****/
+   if (StartTimeUTC % StaRol_SECONDS_PER_HOUR)
+      return false;
+
+   /***** Rollups must be up to date.
+          As they are built from the first hit in log,
+          they include all the past hits *****/
+   return StaRol_RollUpHits ();
+  }
+
+/*****************************************************************************/
+/************ Build expression to count hits using hits per hour *************/
+/*****************************************************************************/
+// CountTypeStr must be freed by the caller
+
+void StaRol_BuildCountType (Sta_CountType_t CountType,char **CountTypeStr)
+  {
+   char *EstimateStr;
+   int NumBytesPrinted = 0;
+
+   switch (CountType)
+     {
+      case Sta_TOTAL_CLICKS:
+	 NumBytesPrinted = asprintf (CountTypeStr,"SUM(log_hours.NumClicks)");
+	 break;
+      case Sta_DISTINCT_USRS:
+	 StaRol_BuildDistinctUsrsEstimate (&EstimateStr);
+	 NumBytesPrinted = asprintf (CountTypeStr,"ROUND(%s)",
+				     EstimateStr);
+	 free (EstimateStr);
+	 break;
+      case Sta_CLICKS_PER_USR:
+	 StaRol_BuildDistinctUsrsEstimate (&EstimateStr);
+	 NumBytesPrinted = asprintf (CountTypeStr,"SUM(log_hours.NumClicks)/"
+						  "GREATEST(ROUND(%s),1)+0.000000",
+				     EstimateStr);
+	 free (EstimateStr);
+	 break;
+      case Sta_GENERATION_TIME:
+	 NumBytesPrinted = asprintf (CountTypeStr,"(SUM(log_hours.SumTimeToGenerate)/"
+						  "SUM(log_hours.NumClicks)/1E6)+0.000000");
+	 break;
+      case Sta_SEND_TIME:
+	 NumBytesPrinted = asprintf (CountTypeStr,"(SUM(log_hours.SumTimeToSend)/"
+						  "SUM(log_hours.NumClicks)/1E6)+0.000000");
+	 break;
+     }
+   if (NumBytesPrinted < 0)	// -1 if no memory or any other error
+      Lay_NotEnoughMemoryExit ();
+  }
+
+/*****************************************************************************/
+/********** Build expression to estimate distinct users from sketches ********/
+/*****************************************************************************/
+// Sketches of the rows in a group are merged getting the maximum of each register
+// EstimateStr must be freed by the caller
+
+static void StaRol_BuildDistinctUsrsEstimate (char **EstimateStr)
+  {
+   char *SumStr;	// Sum of 2^(-register)
+   char *ZerosStr;	// Number of registers equal to 0
+   char *PtrSum;
+   char *PtrZeros;
+   unsigned NumReg;
+
+   if ((SumStr   = malloc (StaRol_NUM_REGISTERS *
+			   StaRol_MAX_BYTES_REGISTER_IN_ESTIMATE + 3)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   if ((ZerosStr = malloc (StaRol_NUM_REGISTERS *
+			   StaRol_MAX_BYTES_REGISTER_IN_ESTIMATE + 3)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Build sum and number of zeros *****/
+   PtrSum   = SumStr;
+   PtrZeros = ZerosStr;
+   PtrSum   += sprintf (PtrSum  ,"(");
+   PtrZeros += sprintf (PtrZeros,"(");
+   for (NumReg = 1;	// SUBSTRING starts at 1
+	NumReg <= StaRol_NUM_REGISTERS;
+	NumReg++)
+     {
+      PtrSum   += sprintf (PtrSum  ,"%sPOW(2,-MAX(ORD(SUBSTRING(log_hours.Sketch,%u,1))))",
+			   NumReg == 1 ? "" :
+					 "+",
+			   NumReg);
+      PtrZeros += sprintf (PtrZeros,"%s(MAX(ORD(SUBSTRING(log_hours.Sketch,%u,1)))=0)",
+			   NumReg == 1 ? "" :
+					 "+",
+			   NumReg);
+     }
+   sprintf (PtrSum  ,")");
+   sprintf (PtrZeros,")");
+
+   /***** Build estimate, corrected for small numbers of users *****/
+   if (asprintf (EstimateStr,"IF(%s/%s<=%u AND %s>0,%u*LN(%u/%s),%s/%s)",
+		 StaRol_ALPHA_x_M_x_M,SumStr,
+		 StaRol_NUM_REGISTERS * 5 / 2,
+		 ZerosStr,
+		 StaRol_NUM_REGISTERS,StaRol_NUM_REGISTERS,ZerosStr,
+		 StaRol_ALPHA_x_M_x_M,SumStr) < 0)
+      Lay_NotEnoughMemoryExit ();
+
+   free (SumStr);
+   free (ZerosStr);
+  }
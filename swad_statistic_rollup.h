@@ -0,0 +1,53 @@
+// swad_statistic_rollup.h: hits per hour pre-aggregated from log
+
+#ifndef _SWAD_STA_ROL
+#define _SWAD_STA_ROL
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>		// For boolean type
+#include <time.h>		// For time_t
+
+#include "swad_date.h"
+#include "swad_statistic.h"
+
+/*****************************************************************************/
+/************************** Public types and constants ***********************/
+/*****************************************************************************/
+
+#define StaRol_SECONDS_PER_HOUR ((time_t) (60UL * 60UL))
+
+/*****************************************************************************/
+/***************************** Public prototypes *****************************/
+/*****************************************************************************/
+
+void StaRol_RollUpNextHits (void);
+bool StaRol_RollUpHits (void);
+
+bool StaRol_CheckIfRollupsCanBeUsed (const struct Dat_TimeZoneChanges *TimeZoneChanges,
+                                     time_t StartTimeUTC);
+void StaRol_BuildCountType (Sta_CountType_t CountType,char **CountTypeStr);
+
+#endif
@@ -33,10 +33,12 @@
 #include <string.h>		// For string functions
 #include <time.h>		// For time ()
 
+#include "swad_alert.h"
 #include "swad_box.h"
 #include "swad_changelog.h"
 #include "swad_config.h"
 #include "swad_database.h"
+#include "swad_file_browser.h"
 #include "swad_form.h"
 #include "swad_forum.h"
 #include "swad_global.h"
@@ -64,6 +66,12 @@ extern struct Globals Gbl;
 
 #define Syl_WIDTH_NUM_SYLLABUS 20
 
+static const char *Syl_NamesInDBForWhichSyllabus[Syl_NUM_WHICH_SYLLABUS] =
+  {
+   [Syl_LECTURES  ] = "lectures",
+   [Syl_PRACTICALS] = "practicals",
+  };
+
 static const char *StyleSyllabus[1 + Syl_MAX_LEVELS_SYLLABUS] =
   {
    [ 0] = "",
@@ -102,6 +110,7 @@ struct LstItemsSyllabus Syl_LstItemsSyllabus;
 /*****************************************************************************/
 
 static unsigned Syl_GetParamItemNumber (void);
+static unsigned Syl_GetParamVersion (void);
 
 static void Syl_SetSyllabusTypeFromAction (struct Syl_Syllabus *Syllabus);
 static void Syl_ShowSyllabus (struct Syl_Syllabus *Syllabus,
@@ -110,15 +119,28 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
                                  int Level,int *CodItem,const char *Text,bool NewItem);
 static void Syl_PutFormItemSyllabus (struct Syl_Syllabus *Syllabus,
                                      bool NewItem,unsigned NumItem,int Level,int *CodItem,const char *Text);
-static void Syl_PutParamNumItem (void *ParamNumItem);
+static void Syl_PutParamsSyllabus (void *Syllabus);
+static void Syl_PutIconToExportSyllabus (void *Args);
+static void Syl_PutParamCreateXML (void *Args);
+static void Syl_CreateXML (void);
 
 static void Syl_WriteNumItem (char *StrDst,FILE *FileTgt,int Level,int *CodItem);
 
 static void Syl_ChangePlaceItemSyllabus (Syl_ChangePosItem_t UpOrDownPos);
+static void Syl_ExchangeSubtrees (const struct Syl_Syllabus *Syllabus,
+                                  const struct MoveSubtrees *Subtree);
 static void Syl_ChangeLevelItemSyllabus (Syl_ChangeLevelItem_t IncreaseOrDecreaseLevel);
 
-static void Syl_OpenSyllabusFile (const struct Syl_Syllabus *Syllabus,
-                                  char *PathFile);
+static void Syl_ImportSyllabusFromXMLFileIfNotImported (const struct Syl_Syllabus *Syllabus,
+                                                        long CrsCod);
+static void Syl_ImportItemsFromXMLFile (const struct Syl_Syllabus *Syllabus,
+                                        long CrsCod);
+static unsigned Syl_GetVersionFromDB (const struct Syl_Syllabus *Syllabus,
+                                      long CrsCod);
+static bool Syl_LockSyllabusIfNotModified (const struct Syl_Syllabus *Syllabus);
+static void Syl_IncreaseVersionAndUnlockSyllabus (const struct Syl_Syllabus *Syllabus);
+static void Syl_InsertItemIntoDB (const struct Syl_Syllabus *Syllabus,long CrsCod,
+                                  unsigned NumItem,int Level,const char *Text);
 
 /*****************************************************************************/
 /************************** Reset syllabus context ***************************/
@@ -128,6 +150,7 @@ void Syl_ResetSyllabus (struct Syl_Syllabus *Syllabus)
   {
    Syllabus->PathDir[0] = '\0';
    Syllabus->NumItem = 0;
+   Syllabus->Version = 0;
    Syllabus->EditionIsActive = false;
    Syllabus->WhichSyllabus = Syl_DEFAULT_WHICH_SYLLABUS;
   }
@@ -192,6 +215,18 @@ static unsigned Syl_GetParamItemNumber (void)
 					       0);
   }
 
+/*****************************************************************************/
+/************* Get parameter with version of syllabus in a form **************/
+/*****************************************************************************/
+
+static unsigned Syl_GetParamVersion (void)
+  {
+   return (unsigned) Par_GetParToUnsignedLong ("SylVer",
+					       0,
+					       UINT_MAX,
+					       0);
+  }
+
 /*****************************************************************************/
 /********************** Check if syllabus is not empty ***********************/
 /*****************************************************************************/
@@ -201,7 +236,7 @@ bool Syl_CheckSyllabus (struct Syl_Syllabus *Syllabus,long CrsCod)
   {
    bool InfoAvailable;
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (Syllabus,CrsCod);
 
    /***** Number of items > 0 ==> info available *****/
@@ -214,7 +249,7 @@ bool Syl_CheckSyllabus (struct Syl_Syllabus *Syllabus,long CrsCod)
   }
 
 /*****************************************************************************/
-/************** Load syllabus from file to memoruy and edit it ***************/
+/************ Load syllabus from database to memory and edit it **************/
 /*****************************************************************************/
 // Return true if info available
 
@@ -228,7 +263,7 @@ bool Syl_CheckAndEditSyllabus (struct Syl_Syllabus *Syllabus)
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    switch (Gbl.Action.Act)
@@ -259,6 +294,10 @@ bool Syl_CheckAndEditSyllabus (struct Syl_Syllabus *Syllabus)
 
       if (Syllabus->EditionIsActive)
 	{
+	 /***** Create the XML file and put a link to download it *****/
+	 if (Par_GetParToBool ("CreateXML"))
+	    Syl_CreateXML ();
+
 	 /***** Button to view *****/
          Frm_StartForm (Inf_ActionsSeeInfo[Gbl.Crs.Info.Type]);
 	 Btn_PutConfirmButton (Txt_Done);
@@ -356,18 +395,18 @@ static void Syl_SetSyllabusTypeFromAction (struct Syl_Syllabus *Syllabus)
   }
 
 /*****************************************************************************/
-/*** Read from XML and load in memory a syllabus of lectures or practicals ***/
+/* Read from database and load in memory a syllabus of lectures or practicals */
 /*****************************************************************************/
 
 void Syl_LoadListItemsSyllabusIntoMemory (struct Syl_Syllabus *Syllabus,
                                           long CrsCod)
   {
-   char PathFile[PATH_MAX + 1];
-   long PostBeginList;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
    unsigned NumItem = 0;
    int N;
    int CodItem[1 + Syl_MAX_LEVELS_SYLLABUS];	// To make numeration
-   int Result;
+   int Level;
    unsigned NumItemsWithChildren = 0;
 
    /* Path of the private directory for the XML file with the syllabus */
@@ -377,29 +416,28 @@ void Syl_LoadListItemsSyllabusIntoMemory (struct Syl_Syllabus *Syllabus,
 	     Syllabus->WhichSyllabus == Syl_LECTURES ? Cfg_SYLLABUS_FOLDER_LECTURES :
 		                                       Cfg_SYLLABUS_FOLDER_PRACTICALS);
 
-   /***** Open the file with the syllabus *****/
-   Syl_OpenSyllabusFile (Syllabus,PathFile);
-
-   /***** Go to the start of the list of items *****/
-   if (!Str_FindStrInFile (Gbl.F.XML,"<lista>",Str_NO_SKIP_HTML_COMMENTS))
-      Lay_ShowErrorAndExit ("Wrong syllabus format.");
+   /***** Import the syllabus from the XML file the first time *****/
+   Syl_ImportSyllabusFromXMLFileIfNotImported (Syllabus,CrsCod);
 
-   /***** Save the position of the start of the list *****/
-   PostBeginList = ftell (Gbl.F.XML);
+   /***** Get version of the syllabus,
+          used in forms to detect changes made by other users *****/
+   Syllabus->Version = Syl_GetVersionFromDB (Syllabus,CrsCod);
 
-   /***** Loop to count the number of items *****/
-   for (Syl_LstItemsSyllabus.NumItems = 0;
-	Str_FindStrInFile (Gbl.F.XML,"<item",Str_NO_SKIP_HTML_COMMENTS);
-	Syl_LstItemsSyllabus.NumItems++);
+   /***** Get items of the syllabus from database *****/
+   Syl_LstItemsSyllabus.NumItems = (unsigned)
+   DB_QuerySELECT (&mysql_res,"can not get syllabus items",
+		   "SELECT Level,"	// row[0]
+			  "Txt"		// row[1]
+		   " FROM syl_items"
+		   " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+		   " ORDER BY ItmInd",
+		   CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]);
 
    /***** Allocate memory for the list of items *****/
    if ((Syl_LstItemsSyllabus.Lst = (struct ItemSyllabus *) calloc (Syl_LstItemsSyllabus.NumItems + 1,
                                                                    sizeof (struct ItemSyllabus))) == NULL)
       Lay_NotEnoughMemoryExit ();
 
-   /***** Return to the start of the list *****/
-   fseek (Gbl.F.XML,PostBeginList,SEEK_SET);
-
    for (N  = 1;
 	N <= Syl_MAX_LEVELS_SYLLABUS;
 	N++)
@@ -428,18 +466,21 @@ void Syl_LoadListItemsSyllabusIntoMemory (struct Syl_Syllabus *Syllabus,
 	   NumItem < Syl_LstItemsSyllabus.NumItems;
 	   NumItem++)
 	{
-	 /* Go to the start of the item */
-	 if (!Str_FindStrInFile (Gbl.F.XML,"<item",Str_NO_SKIP_HTML_COMMENTS))
-	    Lay_ShowErrorAndExit ("Wrong syllabus format.");
-
-	 /* Get the level */
-	 Syl_LstItemsSyllabus.Lst[NumItem].Level = Syl_ReadLevelItemSyllabus ();
-	 if (Syl_LstItemsSyllabus.Lst[NumItem].Level > Syl_LstItemsSyllabus.NumLevels)
-	    Syl_LstItemsSyllabus.NumLevels = Syl_LstItemsSyllabus.Lst[NumItem].Level;
+	 row = mysql_fetch_row (mysql_res);
+
+	 /* Get the level (row[0]) */
+	 Level = (int) Str_ConvertStrToUnsigned (row[0]);
+	 if (Level < 1)
+	    Level = 1;
+	 else if (Level > Syl_MAX_LEVELS_SYLLABUS)
+	    Level = Syl_MAX_LEVELS_SYLLABUS;
+	 Syl_LstItemsSyllabus.Lst[NumItem].Level = Level;
+	 if (Level > Syl_LstItemsSyllabus.NumLevels)
+	    Syl_LstItemsSyllabus.NumLevels = Level;
 
 	 /* Set the code (number) of the item */
-	 CodItem[Syl_LstItemsSyllabus.Lst[NumItem].Level]++;
-	 for (N = Syl_LstItemsSyllabus.Lst[NumItem].Level + 1;
+	 CodItem[Level]++;
+	 for (N = Level + 1;
 	      N <= Syl_MAX_LEVELS_SYLLABUS;
 	      N++)
 	    CodItem[N] = 0;
@@ -448,21 +489,13 @@ void Syl_LoadListItemsSyllabusIntoMemory (struct Syl_Syllabus *Syllabus,
 	      N++)
 	    Syl_LstItemsSyllabus.Lst[NumItem].CodItem[N] = CodItem[N];
 
-	 /* Get the text of the item */
-	 Result = Str_ReadFileUntilBoundaryStr (Gbl.F.XML,Syl_LstItemsSyllabus.Lst[NumItem].Text,
-	                                        "</item>",strlen ("</item>"),
-	                                        (unsigned long long) Syl_MAX_BYTES_TEXT_ITEM);
-	 if (Result == 0) // Str too long
-	   {
-	    if (!Str_FindStrInFile (Gbl.F.XML,"</item>",Str_NO_SKIP_HTML_COMMENTS)) // End the search
-	       Lay_ShowErrorAndExit ("Wrong syllabus format.");
-	   }
-	 else if (Result == -1)
-	    Lay_ShowErrorAndExit ("Wrong syllabus format.");
+	 /* Get the text of the item (row[1]) */
+	 Str_Copy (Syl_LstItemsSyllabus.Lst[NumItem].Text,row[1],
+	           Syl_MAX_BYTES_TEXT_ITEM);
 	}
 
-   /***** Close the file with the syllabus *****/
-   Fil_CloseXMLFile ();
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
 
    /***** Initialize other fields in the list *****/
    if (Syl_LstItemsSyllabus.NumItems)
@@ -482,6 +515,198 @@ void Syl_LoadListItemsSyllabusIntoMemory (struct Syl_Syllabus *Syllabus,
    Syl_LstItemsSyllabus.NumItemsWithChildren = NumItemsWithChildren;
   }
 
+/*****************************************************************************/
+/******** Import a syllabus from its XML file the first time it's read *******/
+/*****************************************************************************/
+/*
+   Syllabuses were stored in XML files, rewritten on each change.
+   Now they are stored in database, and the XML file is only imported once,
+   when the row of the syllabus in syl_syllabuses does not exist yet.
+*/
+
+static void Syl_ImportSyllabusFromXMLFileIfNotImported (const struct Syl_Syllabus *Syllabus,
+                                                        long CrsCod)
+  {
+   /***** Trivial check: if the syllabus is already in database, do nothing *****/
+   if (DB_QueryCOUNT ("can not check if a syllabus exists",
+		      "SELECT COUNT(*) FROM syl_syllabuses"
+		      " WHERE CrsCod=%ld AND WhichSyllabus='%s'",
+		      CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]))
+      return;
+
+   /***** Create the syllabus in database *****/
+   // If another user is importing the same syllabus at the same time,
+   // this insert waits until the other import is committed
+   DB_StartTransaction ();
+   DB_QueryINSERT ("can not create syllabus",
+		   "INSERT IGNORE INTO syl_syllabuses"
+		   " (CrsCod,WhichSyllabus,Version)"
+		   " VALUES"
+		   " (%ld,'%s',0)",
+		   CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]);
+
+   /***** Import items only if not imported by another user *****/
+   if (Syl_GetVersionFromDB (Syllabus,CrsCod) == 0 &&
+       DB_QueryCOUNT ("can not get number of items of a syllabus",
+		      "SELECT COUNT(*) FROM syl_items"
+		      " WHERE CrsCod=%ld AND WhichSyllabus='%s'",
+		      CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]) == 0)
+      Syl_ImportItemsFromXMLFile (Syllabus,CrsCod);
+
+   DB_CommitTransaction ();
+  }
+
+/*****************************************************************************/
+/*************** Import items of a syllabus from its XML file ****************/
+/*****************************************************************************/
+
+static void Syl_ImportItemsFromXMLFile (const struct Syl_Syllabus *Syllabus,
+                                        long CrsCod)
+  {
+   char PathFile[PATH_MAX + 1];
+   unsigned NumItem;
+   int Level;
+   char Text[Syl_MAX_BYTES_TEXT_ITEM + 1];
+   char TextInQuery[Syl_MAX_BYTES_TEXT_ITEM + 1];
+   int Result;
+
+   /***** Open the file with the syllabus *****/
+   if (Gbl.F.XML == NULL) // If it's not open in this moment...
+     {
+      Syl_BuildPathFileSyllabus (Syllabus,PathFile);
+      if ((Gbl.F.XML = fopen (PathFile,"rb")) == NULL)
+	 return;	// The syllabus has no XML file ==> nothing to import
+     }
+   else  // Go to the start of the file
+      rewind (Gbl.F.XML);
+
+   /***** Go to the start of the list of items *****/
+   if (!Str_FindStrInFile (Gbl.F.XML,"<lista>",Str_NO_SKIP_HTML_COMMENTS))
+      Lay_ShowErrorAndExit ("Wrong syllabus format.");
+
+   /***** Loop to read and insert all the items of the syllabus *****/
+   for (NumItem = 0;
+	Str_FindStrInFile (Gbl.F.XML,"<item",Str_NO_SKIP_HTML_COMMENTS);
+	NumItem++)
+     {
+      /* Get the level */
+      Level = Syl_ReadLevelItemSyllabus ();
+
+      /* Get the text of the item */
+      Result = Str_ReadFileUntilBoundaryStr (Gbl.F.XML,Text,
+					     "</item>",strlen ("</item>"),
+					     (unsigned long long) Syl_MAX_BYTES_TEXT_ITEM);
+      if (Result == 0) // Str too long
+	{
+	 if (!Str_FindStrInFile (Gbl.F.XML,"</item>",Str_NO_SKIP_HTML_COMMENTS)) // End the search
+	    Lay_ShowErrorAndExit ("Wrong syllabus format.");
+	}
+      else if (Result == -1)
+	 Lay_ShowErrorAndExit ("Wrong syllabus format.");
+
+      /* Insert the item into database */
+      TextInQuery[0] = '\0';
+      Str_AddStrToQuery (TextInQuery,Text,sizeof (TextInQuery));
+      Syl_InsertItemIntoDB (Syllabus,CrsCod,NumItem,Level,TextInQuery);
+     }
+
+   /***** Close the file with the syllabus *****/
+   Fil_CloseXMLFile ();
+  }
+
+/*****************************************************************************/
+/******************** Get the version of a syllabus **************************/
+/*****************************************************************************/
+
+static unsigned Syl_GetVersionFromDB (const struct Syl_Syllabus *Syllabus,
+                                      long CrsCod)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned Version = 0;
+
+   /***** Get version of the syllabus from database *****/
+   if (DB_QuerySELECT (&mysql_res,"can not get version of a syllabus",
+		       "SELECT Version FROM syl_syllabuses"
+		       " WHERE CrsCod=%ld AND WhichSyllabus='%s'",
+		       CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]))
+     {
+      row = mysql_fetch_row (mysql_res);
+      Version = Str_ConvertStrToUnsigned (row[0]);
+     }
+
+   /***** Free structure that stores the query result *****/
+   DB_FreeMySQLResult (&mysql_res);
+
+   return Version;
+  }
+
+/*****************************************************************************/
+/*** Lock a syllabus to change it only if not modified after being shown *****/
+/*****************************************************************************/
+/*
+   Forms to edit a syllabus include the version of the syllabus shown.
+   If another user has changed the syllabus after it was shown,
+   the version in database is different and the change is not done,
+   so changes made by other users are not overwritten.
+   Return true if the syllabus is locked and can be changed.
+*/
+
+static bool Syl_LockSyllabusIfNotModified (const struct Syl_Syllabus *Syllabus)
+  {
+   extern const char *Txt_The_syllabus_has_been_modified_by_another_user_Try_again;
+
+   /***** Lock the row of the syllabus until the change is committed *****/
+   DB_StartTransactionLockingRows ("can not lock syllabus",
+				   "SELECT Version FROM syl_syllabuses"
+				   " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+				   " FOR UPDATE",
+				   Gbl.Hierarchy.Crs.CrsCod,
+				   Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]);
+
+   /***** Check if the syllabus has been modified after being shown *****/
+   if (Syl_GetVersionFromDB (Syllabus,Gbl.Hierarchy.Crs.CrsCod) == Syl_GetParamVersion ())
+      return true;
+
+   /***** Modified by another user ==> unlock syllabus without changes *****/
+   DB_RollbackTransaction ();
+   Ale_ShowAlert (Ale_WARNING,Txt_The_syllabus_has_been_modified_by_another_user_Try_again);
+   return false;
+  }
+
+/*****************************************************************************/
+/************ Increase the version of a syllabus and unlock it ***************/
+/*****************************************************************************/
+
+static void Syl_IncreaseVersionAndUnlockSyllabus (const struct Syl_Syllabus *Syllabus)
+  {
+   /***** Increase version *****/
+   DB_QueryUPDATE ("can not update version of syllabus",
+		   "UPDATE syl_syllabuses SET Version=Version+1"
+		   " WHERE CrsCod=%ld AND WhichSyllabus='%s'",
+		   Gbl.Hierarchy.Crs.CrsCod,
+		   Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus]);
+
+   /***** Commit changes and unlock syllabus *****/
+   DB_CommitTransaction ();
+  }
+
+/*****************************************************************************/
+/******************** Insert an item of a syllabus in database ***************/
+/*****************************************************************************/
+
+static void Syl_InsertItemIntoDB (const struct Syl_Syllabus *Syllabus,long CrsCod,
+                                  unsigned NumItem,int Level,const char *Text)
+  {
+   DB_QueryINSERT ("can not create syllabus item",
+		   "INSERT INTO syl_items"
+		   " (CrsCod,WhichSyllabus,ItmInd,Level,Txt)"
+		   " VALUES"
+		   " (%ld,'%s',%u,%d,'%s')",
+		   CrsCod,Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus],
+		   NumItem,Level,Text);
+  }
+
 /*****************************************************************************/
 /*********************** Free list of items of a syllabus ********************/
 /*****************************************************************************/
@@ -548,11 +773,15 @@ static void Syl_ShowSyllabus (struct Syl_Syllabus *Syllabus,
 			 Syllabus->EditionIsActive ? Hlp_COURSE_Syllabus_edit :
 						     Hlp_COURSE_Syllabus,
 			 Box_NOT_CLOSABLE,0);
+   else if (Syllabus->EditionIsActive)
+      Box_BoxTableBegin (NULL,Txt_INFO_TITLE[Gbl.Crs.Info.Type],
+			 Syl_PutIconToExportSyllabus,NULL,
+			 Hlp_COURSE_Syllabus_edit,
+			 Box_NOT_CLOSABLE,0);
    else
       Box_BoxTableBegin (NULL,Txt_INFO_TITLE[Gbl.Crs.Info.Type],
 			 NULL,NULL,
-			 Syllabus->EditionIsActive ? Hlp_COURSE_Syllabus_edit :
-						     Hlp_COURSE_Syllabus,
+			 Hlp_COURSE_Syllabus,
 			 Box_NOT_CLOSABLE,0);
 
    /***** Set width of columns of the table *****/
@@ -641,7 +870,7 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
 	   {
 	    Frm_StartForm (Gbl.Crs.Info.Type == Inf_LECTURES ? ActDelItmSylLec :
 		                                               ActDelItmSylPra);
-	    Syl_PutParamNumItem (&Syllabus->ParamNumItem);
+	    Syl_PutParamsSyllabus (Syllabus);
             Ico_PutIconRemove ();
             Frm_EndForm ();
 	   }
@@ -655,7 +884,7 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
 	    Lay_PutContextualLinkOnlyIcon (Gbl.Crs.Info.Type == Inf_LECTURES ? ActUp_IteSylLec :
 									       ActUp_IteSylPra,
 					   NULL,
-					   Syl_PutParamNumItem,&Syllabus->ParamNumItem,
+					   Syl_PutParamsSyllabus,Syllabus,
 					   "arrow-up.svg",
 					   Str_BuildStringStr (Syl_LstItemsSyllabus.Lst[NumItem].HasChildren ? Txt_Move_up_X_and_its_subsections :
 													   Txt_Move_up_X,
@@ -674,7 +903,7 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
 	    Lay_PutContextualLinkOnlyIcon (Gbl.Crs.Info.Type == Inf_LECTURES ? ActDwnIteSylLec :
 									       ActDwnIteSylPra,
 					   NULL,
-					   Syl_PutParamNumItem,&Syllabus->ParamNumItem,
+					   Syl_PutParamsSyllabus,Syllabus,
 					   "arrow-down.svg",
 					   Str_BuildStringStr (Syl_LstItemsSyllabus.Lst[NumItem].HasChildren ? Txt_Move_down_X_and_its_subsections :
 													   Txt_Move_down_X,
@@ -692,7 +921,7 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
 	    Lay_PutContextualLinkOnlyIcon (Gbl.Crs.Info.Type == Inf_LECTURES ? ActRgtIteSylLec :
 									       ActRgtIteSylPra,
 					   NULL,
-					   Syl_PutParamNumItem,&Syllabus->ParamNumItem,
+					   Syl_PutParamsSyllabus,Syllabus,
 					   "arrow-left.svg",
 					   Str_BuildStringStr (Txt_Increase_level_of_X,
 							       StrItemCod));
@@ -710,7 +939,7 @@ static void Syl_ShowRowSyllabus (struct Syl_Syllabus *Syllabus,unsigned NumItem,
 	    Lay_PutContextualLinkOnlyIcon (Gbl.Crs.Info.Type == Inf_LECTURES ? ActLftIteSylLec :
 									       ActLftIteSylPra,
 					   NULL,
-					   Syl_PutParamNumItem,&Syllabus->ParamNumItem,
+					   Syl_PutParamsSyllabus,Syllabus,
 					   "arrow-right.svg",
 					   Str_BuildStringStr (Txt_Decrease_level_of_X,
 							       StrItemCod));
@@ -825,6 +1054,86 @@ void Syl_WriteSyllabusIntoHTMLTmpFile (FILE *FileHTMLTmp)
 			"</body>\n");
   }
 
+/*****************************************************************************/
+/******************* Put a link (form) to export syllabus ********************/
+/*****************************************************************************/
+
+static void Syl_PutIconToExportSyllabus (__attribute__((unused)) void *Args)
+  {
+   extern const char *Txt_Download;
+
+   Lay_PutContextualLinkOnlyIcon (Gbl.Crs.Info.Type == Inf_PRACTICALS ? ActEditorSylPra :
+									ActEditorSylLec,
+				  NULL,
+                                  Syl_PutParamCreateXML,NULL,
+				  "download.svg",
+				  Txt_Download);
+  }
+
+static void Syl_PutParamCreateXML (__attribute__((unused)) void *Args)
+  {
+   Par_PutHiddenParamChar ("CreateXML",'Y');
+  }
+
+/*****************************************************************************/
+/****** Create the XML file with the syllabus and put a link to download it **/
+/*****************************************************************************/
+// XML is used only to import and export syllabuses.
+// The file has the same format as the old files imported the first time
+
+static void Syl_CreateXML (void)
+  {
+   extern const char *The_ClassFormOutBoxBold[The_NUM_THEMES];
+   extern const char *Txt_NEW_LINE;
+   extern const char *Txt_XML_file;
+   char PathPubFile[PATH_MAX + 1];
+   FILE *FileXML;
+   unsigned NumItem;
+
+   /***** Create a temporary public directory
+	  used to download the XML file *****/
+   Brw_CreateDirDownloadTmp ();
+
+   /***** Create public XML file with the syllabus *****/
+   snprintf (PathPubFile,sizeof (PathPubFile),
+	     "%s/%s/%s/%s",
+             Cfg_PATH_FILE_BROWSER_TMP_PUBLIC,
+             Gbl.FileBrowser.TmpPubDir.L,
+             Gbl.FileBrowser.TmpPubDir.R,
+             Cfg_SYLLABUS_FILENAME);
+   if ((FileXML = fopen (PathPubFile,"wb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not open target file.");
+
+   /***** Write all items of the syllabus *****/
+   XML_WriteStartFile (FileXML,"temario",true);
+   fprintf (FileXML,"<lista>%s",Txt_NEW_LINE);
+   for (NumItem = 0;
+	NumItem < Syl_LstItemsSyllabus.NumItems;
+	NumItem++)
+      fprintf (FileXML,"<item nivel=\"%d\">%s</item>%s",
+	       Syl_LstItemsSyllabus.Lst[NumItem].Level,
+	       Syl_LstItemsSyllabus.Lst[NumItem].Text,
+	       Txt_NEW_LINE);
+   fprintf (FileXML,"</lista>%s",Txt_NEW_LINE);
+   XML_WriteEndFile (FileXML,"temario");
+
+   /***** Close the XML file *****/
+   fclose (FileXML);
+
+   /***** Write the link to XML file *****/
+   HTM_DIV_Begin ("class=\"CM\"");
+   HTM_A_Begin ("href=\"%s/%s/%s/%s\" class=\"%s\" target=\"_blank\"",
+	        Cfg_URL_FILE_BROWSER_TMP_PUBLIC,
+	        Gbl.FileBrowser.TmpPubDir.L,
+	        Gbl.FileBrowser.TmpPubDir.R,
+	        Cfg_SYLLABUS_FILENAME,
+	        The_ClassFormOutBoxBold[Gbl.Prefs.Theme]);
+   Ico_PutIconTextLink ("file.svg",
+			Txt_XML_file);
+   HTM_A_End ();
+   HTM_DIV_End ();
+  }
+
 /*****************************************************************************/
 /*************** Show a form to modify an item of the syllabus ***************/
 /*****************************************************************************/
@@ -871,7 +1180,7 @@ static void Syl_PutFormItemSyllabus (struct Syl_Syllabus *Syllabus,
                             (Gbl.Crs.Info.Type == Inf_LECTURES ? ActModIteSylLec :
                         	                                 ActModIteSylPra));
    Syllabus->ParamNumItem = NumItem;
-   Syl_PutParamNumItem (&Syllabus->ParamNumItem);
+   Syl_PutParamsSyllabus (Syllabus);
    HTM_INPUT_TEXT ("Txt",Syl_MAX_CHARS_TEXT_ITEM,Text,
                    HTM_SUBMIT_ON_CHANGE,
 		   "size=\"60\" placeholder=\"%s\"%s",
@@ -883,13 +1192,16 @@ static void Syl_PutFormItemSyllabus (struct Syl_Syllabus *Syllabus,
   }
 
 /*****************************************************************************/
-/***** Write parameter with the number of an item in a syllabus form *********/
+/** Write parameters with number of item and version in a syllabus form ******/
 /*****************************************************************************/
 
-static void Syl_PutParamNumItem (void *ParamNumItem)
+static void Syl_PutParamsSyllabus (void *Syllabus)
   {
-   if (ParamNumItem)
-      Par_PutHiddenParamUnsigned (NULL,"NumI",*((unsigned *) ParamNumItem));
+   if (Syllabus)
+     {
+      Par_PutHiddenParamUnsigned (NULL,"NumI"  ,((struct Syl_Syllabus *) Syllabus)->ParamNumItem);
+      Par_PutHiddenParamUnsigned (NULL,"SylVer",((struct Syl_Syllabus *) Syllabus)->Version);
+     }
   }
 
 /*****************************************************************************/
@@ -934,11 +1246,6 @@ static void Syl_WriteNumItem (char *StrDst,FILE *FileTgt,int Level,int *CodItem)
 void Syl_RemoveItemSyllabus (void)
   {
    struct Syl_Syllabus Syllabus;
-   char PathFile[PATH_MAX + 1];
-   char PathOldFile[PATH_MAX + 1];
-   char PathNewFile[PATH_MAX + 1];
-   FILE *NewFile;
-   unsigned NumItem;
 
    /***** Reset syllabus context *****/
    Syl_ResetSyllabus (&Syllabus);
@@ -946,7 +1253,7 @@ void Syl_RemoveItemSyllabus (void)
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (&Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (&Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    Syllabus.EditionIsActive = true;
@@ -954,21 +1261,31 @@ void Syl_RemoveItemSyllabus (void)
    /***** Get item number *****/
    Syllabus.NumItem = Syl_GetParamItemNumber ();
 
-   /***** Create a new file to make the update *****/
-   Syl_BuildPathFileSyllabus (&Syllabus,PathFile);
-   Fil_CreateUpdateFile (PathFile,".old",PathOldFile,PathNewFile,&NewFile);
-
-   /***** Create the new XML file *****/
-   Syl_WriteStartFileSyllabus (NewFile);
-   for (NumItem = 0;
-	NumItem < Syl_LstItemsSyllabus.NumItems;
-	NumItem++)
-      if (NumItem != Syllabus.NumItem)
-	 Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-   Syl_WriteEndFileSyllabus (NewFile);
-
-   /***** Close the files *****/
-   Fil_CloseUpdateFile (PathFile,PathOldFile,PathNewFile,NewFile);
+   /***** Remove item *****/
+   if (Syllabus.NumItem < Syl_LstItemsSyllabus.NumItems)
+      if (Syl_LockSyllabusIfNotModified (&Syllabus))
+	{
+	 /* Remove item */
+	 DB_QueryDELETE ("can not remove syllabus item",
+			 "DELETE FROM syl_items"
+			 " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+			 " AND ItmInd=%u",
+			 Gbl.Hierarchy.Crs.CrsCod,
+			 Syl_NamesInDBForWhichSyllabus[Syllabus.WhichSyllabus],
+			 Syllabus.NumItem);
+
+	 /* Move up all indexes after the removed item */
+	 DB_QueryUPDATE ("can not move up syllabus items",
+			 "UPDATE syl_items SET ItmInd=ItmInd-1"
+			 " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+			 " AND ItmInd>%u"
+			 " ORDER BY ItmInd",	// Necessary to not create duplicate key (CrsCod,WhichSyllabus,ItmInd)
+			 Gbl.Hierarchy.Crs.CrsCod,
+			 Syl_NamesInDBForWhichSyllabus[Syllabus.WhichSyllabus],
+			 Syllabus.NumItem);
+
+	 Syl_IncreaseVersionAndUnlockSyllabus (&Syllabus);
+	}
 
    /***** We are editing a syllabus with the internal editor,
           so change info source to internal editor in database *****/
@@ -1005,11 +1322,6 @@ void Syl_DownItemSyllabus (void)
 static void Syl_ChangePlaceItemSyllabus (Syl_ChangePosItem_t UpOrDownPos)
   {
    struct Syl_Syllabus Syllabus;
-   char PathFile[PATH_MAX + 1];
-   char PathOldFile[PATH_MAX + 1];
-   char PathNewFile[PATH_MAX + 1];
-   FILE *NewFile;
-   unsigned NumItem;
    struct MoveSubtrees Subtree;
 
    /***** Reset syllabus context *****/
@@ -1018,7 +1330,7 @@ static void Syl_ChangePlaceItemSyllabus (Syl_ChangePosItem_t UpOrDownPos)
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (&Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (&Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    Syllabus.EditionIsActive = true;
@@ -1032,10 +1344,6 @@ static void Syl_ChangePlaceItemSyllabus (Syl_ChangePosItem_t UpOrDownPos)
 
    if (Syllabus.NumItem < Syl_LstItemsSyllabus.NumItems)
      {
-      /***** Create a new file where make the update *****/
-      Syl_BuildPathFileSyllabus (&Syllabus,PathFile);
-      Fil_CreateUpdateFile (PathFile,".old",PathOldFile,PathNewFile,&NewFile);
-
       /***** Get up or get down position *****/
       switch (UpOrDownPos)
 	{
@@ -1047,45 +1355,71 @@ static void Syl_ChangePlaceItemSyllabus (Syl_ChangePosItem_t UpOrDownPos)
 	    break;
 	}
 
-      /***** Create the new XML file *****/
-      Syl_WriteStartFileSyllabus (NewFile);
+      /***** Exchange subtrees *****/
       if (Subtree.MovAllowed)
-	{
-	 for (NumItem = 0;
-	      NumItem < Subtree.ToGetDown.Ini;
-	      NumItem++)
-	    Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-	 for (NumItem = Subtree.ToGetUp.Ini;
-	      NumItem <= Subtree.ToGetUp.End;
-	      NumItem++)
-	    Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-	 for (NumItem = Subtree.ToGetDown.Ini;
-	      NumItem <= Subtree.ToGetDown.End;
-	      NumItem++)
-	    Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-	 for (NumItem = Subtree.ToGetUp.End + 1;
-	      NumItem < Syl_LstItemsSyllabus.NumItems;
-	      NumItem++)
-	    Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-	}
-      else
-	 Syl_WriteAllItemsFileSyllabus (NewFile);
-      Syl_WriteEndFileSyllabus (NewFile);
-
-      /***** Close the files *****/
-      Fil_CloseUpdateFile (PathFile,PathOldFile,PathNewFile,NewFile);
+	 if (Syl_LockSyllabusIfNotModified (&Syllabus))
+	   {
+	    Syl_ExchangeSubtrees (&Syllabus,&Subtree);
+	    Syl_IncreaseVersionAndUnlockSyllabus (&Syllabus);
+	   }
      }
 
    /***** We are editing a syllabus with the internal editor,
           so change info source to internal editor in database *****/
    Inf_SetInfoSrcIntoDB (Syl_LstItemsSyllabus.NumItems ? Inf_INFO_SRC_EDITOR :
-						         Inf_INFO_SRC_NONE);
+   	                                                 Inf_INFO_SRC_NONE);
 
    /***** Show the updated syllabus to continue editing it *****/
    Syl_FreeListItemsSyllabus ();
    (void) Syl_CheckAndEditSyllabus (&Syllabus);
   }
 
+/*****************************************************************************/
+/************** Exchange two consecutive subtrees of a syllabus **************/
+/*****************************************************************************/
+/*
+   The subtree to get down is just before the subtree to get up.
+   Only the indexes of the items in both subtrees are changed.
+   Indexes are changed to negative (-Index-1, to not use -0) in a first step,
+   necessary to preserve unique index (CrsCod,WhichSyllabus,ItmInd).
+*/
+
+static void Syl_ExchangeSubtrees (const struct Syl_Syllabus *Syllabus,
+                                  const struct MoveSubtrees *Subtree)
+  {
+   unsigned NumItemsToGetUp   = Subtree->ToGetUp.End   - Subtree->ToGetUp.Ini   + 1;
+   unsigned NumItemsToGetDown = Subtree->ToGetDown.End - Subtree->ToGetDown.Ini + 1;
+
+   /* Step 1: Change all indexes involved to negative */
+   DB_QueryUPDATE ("can not exchange indexes of syllabus items",
+		   "UPDATE syl_items SET ItmInd=-ItmInd-1"
+		   " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+		   " AND ItmInd>=%u AND ItmInd<=%u",
+		   Gbl.Hierarchy.Crs.CrsCod,
+		   Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus],
+		   Subtree->ToGetDown.Ini,Subtree->ToGetUp.End);	// All indexes in both subtrees
+
+   /* Step 2: Increase indexes of the subtree to get down */
+   DB_QueryUPDATE ("can not exchange indexes of syllabus items",
+		   "UPDATE syl_items SET ItmInd=-ItmInd-1+%u"
+		   " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+		   " AND ItmInd>=-%u AND ItmInd<=-%u",
+		   NumItemsToGetUp,
+		   Gbl.Hierarchy.Crs.CrsCod,
+		   Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus],
+		   Subtree->ToGetDown.End + 1,Subtree->ToGetDown.Ini + 1);
+
+   /* Step 3: Decrease indexes of the subtree to get up */
+   DB_QueryUPDATE ("can not exchange indexes of syllabus items",
+		   "UPDATE syl_items SET ItmInd=-ItmInd-1-%u"
+		   " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+		   " AND ItmInd>=-%u AND ItmInd<=-%u",
+		   NumItemsToGetDown,
+		   Gbl.Hierarchy.Crs.CrsCod,
+		   Syl_NamesInDBForWhichSyllabus[Syllabus->WhichSyllabus],
+		   Subtree->ToGetUp.End + 1,Subtree->ToGetUp.Ini + 1);
+  }
+
 /*****************************************************************************/
 /********** Compute the limits for get up a subtree of a syllabus ************/
 /*****************************************************************************/
@@ -1201,10 +1535,6 @@ void Syl_LeftItemSyllabus (void)
 static void Syl_ChangeLevelItemSyllabus (Syl_ChangeLevelItem_t IncreaseOrDecreaseLevel)
   {
    struct Syl_Syllabus Syllabus;
-   char PathFile[PATH_MAX + 1];
-   char PathOldFile[PATH_MAX + 1];
-   char PathNewFile[PATH_MAX + 1];
-   FILE *NewFile;
 
    /***** Reset syllabus context *****/
    Syl_ResetSyllabus (&Syllabus);
@@ -1212,7 +1542,7 @@ static void Syl_ChangeLevelItemSyllabus (Syl_ChangeLevelItem_t IncreaseOrDecreas
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (&Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (&Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    Syllabus.EditionIsActive = true;
@@ -1220,30 +1550,36 @@ static void Syl_ChangeLevelItemSyllabus (Syl_ChangeLevelItem_t IncreaseOrDecreas
    /***** Get item number *****/
    Syllabus.NumItem = Syl_GetParamItemNumber ();
 
-   /***** Create a new file to do the update *****/
-   Syl_BuildPathFileSyllabus (&Syllabus,PathFile);
-   Fil_CreateUpdateFile (PathFile,".old",PathOldFile,PathNewFile,&NewFile);
-
-   /***** Increase or decrease level *****/
-   switch (IncreaseOrDecreaseLevel)
+   if (Syllabus.NumItem < Syl_LstItemsSyllabus.NumItems)
      {
-      case Syl_INCREASE_LEVEL:
-	 if (Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level > 1)
-	    Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level--;
-	 break;
-      case Syl_DECREASE_LEVEL:
-	 if (Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level < Syl_MAX_LEVELS_SYLLABUS)
-	    Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level++;
-	 break;
-     }
-
-   /***** Create the new XML file *****/
-   Syl_WriteStartFileSyllabus (NewFile);
-   Syl_WriteAllItemsFileSyllabus (NewFile);
-   Syl_WriteEndFileSyllabus (NewFile);
+      /***** Increase or decrease level *****/
+      switch (IncreaseOrDecreaseLevel)
+	{
+	 case Syl_INCREASE_LEVEL:
+	    if (Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level > 1)
+	       Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level--;
+	    break;
+	 case Syl_DECREASE_LEVEL:
+	    if (Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level < Syl_MAX_LEVELS_SYLLABUS)
+	       Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level++;
+	    break;
+	}
 
-   /***** Close the files *****/
-   Fil_CloseUpdateFile (PathFile,PathOldFile,PathNewFile,NewFile);
+      /***** Update level of the item *****/
+      if (Syl_LockSyllabusIfNotModified (&Syllabus))
+	{
+	 DB_QueryUPDATE ("can not change level of syllabus item",
+			 "UPDATE syl_items SET Level=%d"
+			 " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+			 " AND ItmInd=%u",
+			 Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Level,
+			 Gbl.Hierarchy.Crs.CrsCod,
+			 Syl_NamesInDBForWhichSyllabus[Syllabus.WhichSyllabus],
+			 Syllabus.NumItem);
+
+	 Syl_IncreaseVersionAndUnlockSyllabus (&Syllabus);
+	}
+     }
 
    /***** We are editing a syllabus with the internal editor,
           so change info source to internal editor in database *****/
@@ -1262,11 +1598,6 @@ static void Syl_ChangeLevelItemSyllabus (Syl_ChangeLevelItem_t IncreaseOrDecreas
 void Syl_InsertItemSyllabus (void)
   {
    struct Syl_Syllabus Syllabus;
-   char PathFile[PATH_MAX + 1];
-   char PathOldFile[PATH_MAX + 1];
-   char PathNewFile[PATH_MAX + 1];
-   FILE *NewFile;
-   unsigned NumItem;
    char Txt[Syl_MAX_BYTES_TEXT_ITEM + 1];
 
    /***** Reset syllabus context *****/
@@ -1275,46 +1606,41 @@ void Syl_InsertItemSyllabus (void)
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (&Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (&Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    Syllabus.EditionIsActive = true;
 
    /***** Get item number *****/
    Syllabus.NumItem = Syl_GetParamItemNumber ();
+   if (Syllabus.NumItem > Syl_LstItemsSyllabus.NumItems)
+      Syllabus.NumItem = Syl_LstItemsSyllabus.NumItems;
 
    /***** Get item body *****/
    Par_GetParToHTML ("Txt",Txt,Syl_MAX_BYTES_TEXT_ITEM);
 
-   /***** Create a new file to do the update *****/
-   Syl_BuildPathFileSyllabus (&Syllabus,PathFile);
-   Fil_CreateUpdateFile (PathFile,".old",PathOldFile,PathNewFile,&NewFile);
-
-   /***** Create the new XML file *****/
-   Syl_WriteStartFileSyllabus (NewFile);
-
-   /* Write items before the one to be inserted */
-   for (NumItem = 0;
-	NumItem < Syllabus.NumItem;
-	NumItem++)
-      Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-
-   /* Write the item that will be inserted */
-   Syl_WriteItemFileSyllabus (NewFile,
-                              NumItem ? Syl_LstItemsSyllabus.Lst[NumItem - 1].Level :
-                        	        1,
-                              Txt);
-
-   /* Write items after the one just inserted */
-   for (;
-	NumItem < Syl_LstItemsSyllabus.NumItems;
-	NumItem++)
-      Syl_WriteItemFileSyllabus (NewFile,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-
-   Syl_WriteEndFileSyllabus (NewFile);
-
-   /***** Close the files *****/
-   Fil_CloseUpdateFile (PathFile,PathOldFile,PathNewFile,NewFile);
+   /***** Insert item *****/
+   if (Syl_LockSyllabusIfNotModified (&Syllabus))
+     {
+      /* Move down all indexes from the position of the new item */
+      DB_QueryUPDATE ("can not move down syllabus items",
+		      "UPDATE syl_items SET ItmInd=ItmInd+1"
+		      " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+		      " AND ItmInd>=%u"
+		      " ORDER BY ItmInd DESC",	// Necessary to not create duplicate key (CrsCod,WhichSyllabus,ItmInd)
+		      Gbl.Hierarchy.Crs.CrsCod,
+		      Syl_NamesInDBForWhichSyllabus[Syllabus.WhichSyllabus],
+		      Syllabus.NumItem);
+
+      /* Insert the new item with the level of the previous one */
+      Syl_InsertItemIntoDB (&Syllabus,Gbl.Hierarchy.Crs.CrsCod,
+                            Syllabus.NumItem,
+                            Syllabus.NumItem ? Syl_LstItemsSyllabus.Lst[Syllabus.NumItem - 1].Level :
+                        	               1,
+                            Txt);
+
+      Syl_IncreaseVersionAndUnlockSyllabus (&Syllabus);
+     }
 
    /***** We are editing a syllabus with the internal editor,
           so change info source to internal editor in database *****/
@@ -1333,10 +1659,6 @@ void Syl_InsertItemSyllabus (void)
 void Syl_ModifyItemSyllabus (void)
   {
    struct Syl_Syllabus Syllabus;
-   char PathFile[PATH_MAX + 1];
-   char PathOldFile[PATH_MAX + 1];
-   char PathNewFile[PATH_MAX + 1];
-   FILE *NewFile;
 
    /***** Reset syllabus context *****/
    Syl_ResetSyllabus (&Syllabus);
@@ -1344,7 +1666,7 @@ void Syl_ModifyItemSyllabus (void)
    /***** Set syllabus type depending on current action *****/
    Syl_SetSyllabusTypeFromAction (&Syllabus);
 
-   /***** Load syllabus from XML file to memory *****/
+   /***** Load syllabus from database to memory *****/
    Syl_LoadListItemsSyllabusIntoMemory (&Syllabus,Gbl.Hierarchy.Crs.CrsCod);
 
    Syllabus.EditionIsActive = true;
@@ -1352,21 +1674,27 @@ void Syl_ModifyItemSyllabus (void)
    /***** Get item number *****/
    Syllabus.NumItem = Syl_GetParamItemNumber ();
 
-   /***** Get item body *****/
-   Par_GetParToHTML ("Txt",Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Text,
-                     Syl_MAX_BYTES_TEXT_ITEM);
-
-   /***** Create a new file where make the update *****/
-   Syl_BuildPathFileSyllabus (&Syllabus,PathFile);
-   Fil_CreateUpdateFile (PathFile,".old",PathOldFile,PathNewFile,&NewFile);
-
-   /***** Create the new XML file *****/
-   Syl_WriteStartFileSyllabus (NewFile);
-   Syl_WriteAllItemsFileSyllabus (NewFile);
-   Syl_WriteEndFileSyllabus (NewFile);
+   if (Syllabus.NumItem < Syl_LstItemsSyllabus.NumItems)
+     {
+      /***** Get item body *****/
+      Par_GetParToHTML ("Txt",Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Text,
+			Syl_MAX_BYTES_TEXT_ITEM);
 
-   /***** Close the files *****/
-   Fil_CloseUpdateFile (PathFile,PathOldFile,PathNewFile,NewFile);
+      /***** Update text of the item *****/
+      if (Syl_LockSyllabusIfNotModified (&Syllabus))
+	{
+	 DB_QueryUPDATE ("can not update syllabus item",
+			 "UPDATE syl_items SET Txt='%s'"
+			 " WHERE CrsCod=%ld AND WhichSyllabus='%s'"
+			 " AND ItmInd=%u",
+			 Syl_LstItemsSyllabus.Lst[Syllabus.NumItem].Text,
+			 Gbl.Hierarchy.Crs.CrsCod,
+			 Syl_NamesInDBForWhichSyllabus[Syllabus.WhichSyllabus],
+			 Syllabus.NumItem);
+
+	 Syl_IncreaseVersionAndUnlockSyllabus (&Syllabus);
+	}
+     }
 
    /***** We are editing a syllabus with the internal editor,
           so change info source to internal editor in database *****/
@@ -1393,77 +1721,3 @@ void Syl_BuildPathFileSyllabus (const struct Syl_Syllabus *Syllabus,
    Str_Copy (PathFile,Path,
 	     PATH_MAX);
   }
-
-/*****************************************************************************/
-/*********************** Open file with the syllabus *************************/
-/*****************************************************************************/
-
-static void Syl_OpenSyllabusFile (const struct Syl_Syllabus *Syllabus,
-                                  char *PathFile)
-  {
-   if (Gbl.F.XML == NULL) // If it's not open in this moment...
-     {
-      /* If the directory does not exist, create it */
-      Fil_CreateDirIfNotExists (Syllabus->PathDir);
-
-      /* Open the file for reading */
-      Syl_BuildPathFileSyllabus (Syllabus,PathFile);
-      if ((Gbl.F.XML = fopen (PathFile,"rb")) == NULL)
-	{
-	 /* Can't open the file */
-	 if (!Fil_CheckIfPathExists (Syllabus->PathDir)) // Strange error, since it is just created
-	    Lay_ShowErrorAndExit ("Can not open syllabus file.");
-	 else
-	   {
-	    /* Create a new empty syllabus */
-	    if ((Gbl.F.XML = fopen (PathFile,"wb")) == NULL)
-	       Lay_ShowErrorAndExit ("Can not create syllabus file.");
-	    Syl_WriteStartFileSyllabus (Gbl.F.XML);
-	    Syl_WriteEndFileSyllabus (Gbl.F.XML);
-	    Fil_CloseXMLFile ();
-	    /* Open of new the file for reading */
-	    if ((Gbl.F.XML = fopen (PathFile,"rb")) == NULL)
-	       Lay_ShowErrorAndExit ("Can not open syllabus file.");
-	   }
-	}
-     }
-   else  // Go to the start of the file
-      rewind (Gbl.F.XML);
-  }
-
-/*****************************************************************************/
-/*********************** Write a file with a syllabus ************************/
-/*****************************************************************************/
-
-void Syl_WriteStartFileSyllabus (FILE *FileSyllabus)
-  {
-   extern const char *Txt_NEW_LINE;
-
-   XML_WriteStartFile (FileSyllabus,"temario",true);
-   fprintf (FileSyllabus,"<lista>%s",Txt_NEW_LINE);
-  }
-
-void Syl_WriteAllItemsFileSyllabus (FILE *FileSyllabus)
-  {
-   unsigned NumItem;
-
-   for (NumItem = 0;
-	NumItem < Syl_LstItemsSyllabus.NumItems;
-	NumItem++)
-      Syl_WriteItemFileSyllabus (FileSyllabus,Syl_LstItemsSyllabus.Lst[NumItem].Level,Syl_LstItemsSyllabus.Lst[NumItem].Text);
-  }
-
-void Syl_WriteItemFileSyllabus (FILE *FileSyllabus,int Level,const char *Text)
-  {
-   extern const char *Txt_NEW_LINE;
-
-   fprintf (FileSyllabus,"<item nivel=\"%d\">%s</item>%s",Level,Text,Txt_NEW_LINE);
-  }
-
-void Syl_WriteEndFileSyllabus (FILE *FileSyllabus)
-  {
-   extern const char *Txt_NEW_LINE;
-
-   fprintf (FileSyllabus,"</lista>%s",Txt_NEW_LINE);
-   XML_WriteEndFile (FileSyllabus,"temario");
-  }
@@ -74,6 +74,7 @@ struct Syl_Syllabus
    char PathDir[PATH_MAX + 1];
    unsigned NumItem;		// Item being edited
    unsigned ParamNumItem;	// Used as parameter in forms
+   unsigned Version;		// Version of the syllabus shown, used in forms to detect changes by other users
    bool EditionIsActive;
    Syl_WhichSyllabus_t WhichSyllabus;
   };
@@ -112,9 +113,5 @@ void Syl_InsertItemSyllabus (void);
 void Syl_ModifyItemSyllabus (void);
 void Syl_BuildPathFileSyllabus (const struct Syl_Syllabus *Syllabus,
                                 char *PathFile);
-void Syl_WriteStartFileSyllabus (FILE *FileSyllabus);
-void Syl_WriteAllItemsFileSyllabus (FILE *FileSyllabus);
-void Syl_WriteItemFileSyllabus (FILE *FileSyllabus,int Level,const char *Text);
-void Syl_WriteEndFileSyllabus (FILE *FileSyllabus);
 
 #endif
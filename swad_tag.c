@@ -27,6 +27,7 @@
 
 #include <mysql/mysql.h>	// To access MySQL databases
 #include <stdbool.h>		// For boolean type
+#include <stdio.h>		// For snprintf
 #include <stdlib.h>		// For free
 #include <string.h>		// For string functions
 
@@ -390,6 +391,9 @@ static long Tag_GetTagCodFromTagTxt (const char *TagTxt)
 
 void Tag_InsertTagsIntoDB (long QstCod,const struct Tag_Tags *Tags)
   {
+   char Values[Tag_MAX_TAGS_PER_QUESTION *
+	       (Cns_MAX_DECIMAL_DIGITS_LONG * 2 + Cns_MAX_DECIMAL_DIGITS_UINT + 5) + 1];
+   size_t Length = 0;
    unsigned NumTag;
    unsigned TagIdx;
    long TagCod;
@@ -405,16 +409,24 @@ void Tag_InsertTagsIntoDB (long QstCod,const struct Tag_Tags *Tags)
             /* This tag is new for current course. Add it to tags table */
             TagCod = Tag_CreateNewTag (Gbl.Hierarchy.Crs.CrsCod,Tags->Txt[NumTag]);
 
-         /***** Insert tag in tst_question_tags *****/
-         DB_QueryINSERT ("can not create tag",
-			 "INSERT INTO tst_question_tags"
-                         " (QstCod,TagCod,TagInd)"
-                         " VALUES"
-                         " (%ld,%ld,%u)",
-			 QstCod,TagCod,TagIdx);
+         /***** Add tag to the values to insert in tst_question_tags *****/
+         Length += snprintf (&Values[Length],sizeof (Values) - Length,
+                             "%s(%ld,%ld,%u)",
+                             TagIdx ? "," :
+                        	      "",
+                             QstCod,TagCod,TagIdx);
 
          TagIdx++;
         }
+
+   /***** Insert all tags of the question in tst_question_tags at once *****/
+   if (TagIdx)
+      DB_QueryINSERT ("can not create tags",
+		      "INSERT INTO tst_question_tags"
+		      " (QstCod,TagCod,TagInd)"
+		      " VALUES"
+		      " %s",
+		      Values);
   }
 
 /*****************************************************************************/
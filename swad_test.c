@@ -50,6 +50,7 @@
 #include "swad_match.h"
 #include "swad_media.h"
 #include "swad_parameter.h"
+#include "swad_random.h"
 #include "swad_theme.h"
 #include "swad_test.h"
 #include "swad_test_config.h"
@@ -1908,7 +1909,9 @@ static void Tst_GetQuestionsForNewTestFromDB (struct Tst_Test *Test,
    char UnsignedStr[Cns_MAX_DECIMAL_DIGITS_UINT + 1];
    Tst_AnswerType_t AnswerType;
    bool Shuffle;
-   char StrNumQsts[Cns_MAX_DECIMAL_DIGITS_UINT + 1];
+   struct Rnd_Generator Generator;
+   unsigned long NumCandidateQsts;
+   unsigned long *Indexes;
    unsigned NumQst;
 
    /***** Trivial check: number of questions *****/
@@ -1996,23 +1999,26 @@ static void Tst_GetQuestionsForNewTestFromDB (struct Tst_Test *Test,
                   Tst_MAX_BYTES_QUERY_TEST);
      }
 
-   /* End query */
-   Str_Concat (Query," ORDER BY RAND() LIMIT ",
-               Tst_MAX_BYTES_QUERY_TEST);
-   snprintf (StrNumQsts,sizeof (StrNumQsts),
-	     "%u",
-	     Test->NumQsts);
-   Str_Concat (Query,StrNumQsts,
+   /* End query.
+      All candidate questions are got in a fixed order,
+      and questions are drawn from them below */
+   Str_Concat (Query," ORDER BY tst_questions.QstCod",
                Tst_MAX_BYTES_QUERY_TEST);
 /*
    if (Gbl.Usrs.Me.Roles.LoggedRole == Rol_SYS_ADM)
       Lay_ShowAlert (Lay_INFO,Query);
 */
    /* Make the query */
+   NumCandidateQsts = DB_QuerySELECT (&mysql_res,"can not get questions",
+			              "%s",
+			              Query);
+
+   /***** Draw questions *****/
+   Rnd_SetRandomSeed (&Generator);
    Print->NumQsts.All =
-   Test->NumQsts      = (unsigned) DB_QuerySELECT (&mysql_res,"can not get questions",
-			                           "%s",
-			                           Query);
+   Test->NumQsts      = (unsigned) Rnd_GetSample (&Generator,NumCandidateQsts,
+                                                  (unsigned long) Test->NumQsts,
+                                                  &Indexes);
 
    /***** Get questions and answers from database *****/
    for (NumQst = 0;
@@ -2020,6 +2026,7 @@ static void Tst_GetQuestionsForNewTestFromDB (struct Tst_Test *Test,
 	NumQst++)
      {
       /* Get question row */
+      mysql_data_seek (mysql_res,(my_ulonglong) Indexes[NumQst]);
       row = mysql_fetch_row (mysql_res);
       /*
       QstCod	row[0]
@@ -2063,6 +2070,9 @@ static void Tst_GetQuestionsForNewTestFromDB (struct Tst_Test *Test,
       Print->PrintedQuestions[NumQst].StrAnswers[0] = '\0';
      }
 
+   /***** Free list of drawn questions *****/
+   free (Indexes);
+
    /***** Get if test exam will be visible by teachers *****/
    Print->AllowTeachers = Par_GetParToBool ("AllowTchs");
   }
@@ -5039,6 +5049,8 @@ void Tst_PutParamQstCod (void *QstCod)	// Should be a pointer to long
 
 void Tst_InsertOrUpdateQstTagsAnsIntoDB (struct Tst_Question *Question)
   {
+   bool IsNewQst = (Question->QstCod < 0);
+
    /***** Insert or update question in the table of questions *****/
    Tst_InsertOrUpdateQstIntoDB (Question);
    if (Question->QstCod > 0)
@@ -5047,7 +5059,9 @@ void Tst_InsertOrUpdateQstTagsAnsIntoDB (struct Tst_Question *Question)
       Tag_InsertTagsIntoDB (Question->QstCod,&Question->Tags);
 
       /***** Remove unused tags in current course *****/
-      Tag_RemoveUnusedTagsFromCrs (Gbl.Hierarchy.Crs.CrsCod);
+      if (!IsNewQst)	// Tags of a new question are all used,
+			// so removing is only needed when tags are replaced
+         Tag_RemoveUnusedTagsFromCrs (Gbl.Hierarchy.Crs.CrsCod);
 
       /***** Insert answers in the answers table *****/
       Tst_InsertAnswersIntoDB (Question);
@@ -5129,7 +5143,6 @@ static void Tst_InsertOrUpdateQstIntoDB (struct Tst_Question *Question)
 static void Tst_InsertAnswersIntoDB (struct Tst_Question *Question)
   {
    unsigned NumOpt;
-   unsigned i;
 
    /***** Insert answers in the answers table *****/
    switch (Question->Answer.Type)
@@ -5145,16 +5158,14 @@ static void Tst_InsertAnswersIntoDB (struct Tst_Question *Question)
          break;
       case Tst_ANS_FLOAT:
 	 Str_SetDecimalPointToUS ();	// To print the floating point as a dot
-   	 for (i = 0;
-   	      i < 2;
-   	      i++)
-            DB_QueryINSERT ("can not create answer",
-        		    "INSERT INTO tst_answers"
-                            " (QstCod,AnsInd,Answer,Feedback,MedCod,Correct)"
-                            " VALUES"
-                            " (%ld,%u,'%.15lg','',-1,'Y')",
-			    Question->QstCod,i,
-			    Question->Answer.FloatingPoint[i]);
+         DB_QueryINSERT ("can not create answer",
+        		 "INSERT INTO tst_answers"
+                         " (QstCod,AnsInd,Answer,Feedback,MedCod,Correct)"
+                         " VALUES"
+                         " (%ld,0,'%.15lg','',-1,'Y'),"
+                         "(%ld,1,'%.15lg','',-1,'Y')",
+			 Question->QstCod,Question->Answer.FloatingPoint[0],
+			 Question->QstCod,Question->Answer.FloatingPoint[1]);
          Str_SetDecimalPointToLocal ();	// Return to local system
          break;
       case Tst_ANS_TRUE_FALSE:
@@ -47,10 +47,60 @@
 /**************************** Private constants ******************************/
 /*****************************************************************************/
 
+#define TsI_MAX_QSTS_PER_TRANSACTION	100	// Questions inserted before each commit when importing
+
 /*****************************************************************************/
 /******************************* Private types *******************************/
 /*****************************************************************************/
 
+typedef enum
+  {
+   TsI_BEFORE_TEST,	// First element not read yet
+   TsI_NO_TEST,		// First element is not <test>
+   TsI_IN_TEST,		// Inside <test>
+   TsI_AFTER_TEST,	// <test> already closed
+  } TsI_ImportState_t;
+
+// Where to store the content of the current element
+typedef enum
+  {
+   TsI_CONTENT_NONE,
+   TsI_CONTENT_TAG,
+   TsI_CONTENT_STEM,
+   TsI_CONTENT_FEEDBACK,
+   TsI_CONTENT_ANSWER,		// Integer or true/false answer
+   TsI_CONTENT_LOWER,		// Lower limit of floating point answer
+   TsI_CONTENT_UPPER,		// Upper limit of floating point answer
+   TsI_CONTENT_OPTION_TEXT,
+   TsI_CONTENT_OPTION_FEEDBACK,
+  } TsI_Content_t;
+
+// State of the import while the XML file is read
+struct TsI_Import
+  {
+   TsI_ImportState_t State;
+   bool InQuestion;
+   bool InTags;
+   bool InAnswer;
+   bool InOption;
+   struct
+     {
+      bool Tags;
+      bool Stem;
+      bool Feedback;
+      bool Answer;
+      bool Lower;
+      bool Upper;
+      bool Text;
+      bool OptionFeedback;
+     } Found;			// Only the first element of each kind is read
+   TsI_Content_t Content;
+   unsigned NumOpt;		// Current option of the answer
+   struct Tst_Question Question;
+   unsigned NumQstsAdded;
+   unsigned NumQstsInTransaction;
+  };
+
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
 /*****************************************************************************/
@@ -74,14 +124,16 @@ static void TsI_GetAndWriteTagsXML (long QstCod,FILE *FileXML);
 static void TsI_WriteAnswersOfAQstXML (const struct Tst_Question *Question,
                                        FILE *FileXML);
 static void TsI_ReadQuestionsFromXMLFileAndStoreInDB (const char *FileNameXML);
-static void TsI_ImportQuestionsFromXMLBuffer (const char *XMLBuffer);
+static void TsI_StartElement (void *ImportPtr,unsigned Level,const char *TagName,
+                              const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                              unsigned NumAttributes);
+static void TsI_GetContent (void *ImportPtr,unsigned Level,const char *TagName,
+                            const char *Content);
+static void TsI_EndElement (void *ImportPtr,unsigned Level,const char *TagName);
+static void TsI_ImportQuestion (struct TsI_Import *Import);
 static Tst_AnswerType_t TsI_ConvertFromStrAnsTypXMLToAnsTyp (const char *StrAnsTypeXML);
-static void TsI_GetAnswerFromXML (struct XMLElement *AnswerElem,
-                                  struct Tst_Question *Question);
 static void TsI_WriteHeadingListImportedQst (void);
-static void TsI_WriteRowImportedQst (struct XMLElement *StemElem,
-                                     struct XMLElement *FeedbackElem,
-                                     const struct Tst_Question *Question,
+static void TsI_WriteRowImportedQst (const struct Tst_Question *Question,
                                      bool QuestionExists);
 
 /*****************************************************************************/
@@ -446,237 +498,455 @@ void TsI_ImportQstsFromXML (void)
 
 static void TsI_ReadQuestionsFromXMLFileAndStoreInDB (const char *FileNameXML)
   {
+   extern const char *Hlp_ASSESSMENT_Tests;
+   extern const char *Txt_XML_file_content;
+   extern const char *Txt_Imported_questions;
+   extern const char *Txt_No_questions_have_been_added;
+   extern const char *Txt_A_question_has_been_added;
+   extern const char *Txt_X_questions_have_been_added;
+   static const struct XMLHandlers ImportHandlers =
+     {
+      .StartElement = TsI_StartElement,
+      .Content      = TsI_GetContent,
+      .EndElement   = TsI_EndElement,
+     };
    FILE *FileXML;
-   char *XMLBuffer;
-   unsigned long FileSize;
+   struct TsI_Import Import;
 
    /***** Open file *****/
    if ((FileXML = fopen (FileNameXML,"rb")) == NULL)
       Lay_ShowErrorAndExit ("Can not open XML file.");
 
-   /***** Compute file size *****/
-   fseek (FileXML,0L,SEEK_END);
-   FileSize = (unsigned long) ftell (FileXML);
-   fseek (FileXML,0L,SEEK_SET);
-
-   /***** Allocate memory for XML buffer *****/
-   if ((XMLBuffer = (char *) malloc (FileSize + 1)) == NULL)
-      Lay_NotEnoughMemoryExit ();
-   else
-     {
-      /***** Read file contents into XML buffer *****/
-      if (fread (XMLBuffer,sizeof (char),(size_t) FileSize,FileXML))
-         XMLBuffer[FileSize] = '\0';
-      else
-         XMLBuffer[0] = '\0';
-
-      /***** Import questions from XML buffer *****/
-      TsI_ImportQuestionsFromXMLBuffer (XMLBuffer);
-
-      free (XMLBuffer);
-     }
-
-   /***** Close file *****/
-   fclose (FileXML);
-  }
-
-/*****************************************************************************/
-/******************** Import questions from XML buffer ***********************/
-/*****************************************************************************/
-
-static void TsI_ImportQuestionsFromXMLBuffer (const char *XMLBuffer)
-  {
-   extern const char *Hlp_ASSESSMENT_Tests;
-   extern const char *Txt_XML_file_content;
-   extern const char *Txt_Imported_questions;
-   struct XMLElement *RootElem;
-   struct XMLElement *TestElem = NULL;
-   struct XMLElement *QuestionElem;
-   struct XMLElement *TagsElem;
-   struct XMLElement *TagElem;
-   struct XMLElement *StemElem;
-   struct XMLElement *FeedbackElem;
-   struct XMLElement *AnswerElem;
-   struct XMLAttribute *Attribute;
-   struct Tst_Question Question;
-   bool QuestionExists;
-   bool AnswerTypeFound;
-
-   /***** Allocate and get XML tree *****/
-   XML_GetTree (XMLBuffer,&RootElem);
-
    /***** Begin box *****/
    Box_BoxBegin (NULL,Txt_Imported_questions,
                  NULL,NULL,
                  Hlp_ASSESSMENT_Tests,Box_NOT_CLOSABLE);
 
-   /***** Print XML tree *****/
+   /***** Print XML file *****/
+   /* The whole file is checked before importing any question */
    HTM_DIV_Begin ("class=\"TEST_FILE_CONTENT\"");
    HTM_TEXTAREA_Begin ("title=\"%s\" cols=\"60\" rows=\"5\""
 	               " spellcheck=\"false\" readonly",
 	               Txt_XML_file_content);
-   XML_PrintTree (RootElem);
+   XML_PrintFile (FileXML);
    HTM_TEXTAREA_End ();
    HTM_DIV_End ();
 
-   /***** Get questions from XML tree and print them *****/
-   /* Go to <test> element */
-   if (RootElem->FirstChild)
+   /***** Read the file again, importing questions one by one *****/
+   rewind (FileXML);
+   Import.State                = TsI_BEFORE_TEST;
+   Import.InQuestion           =
+   Import.InTags               =
+   Import.InAnswer             =
+   Import.InOption             = false;
+   Import.Content              = TsI_CONTENT_NONE;
+   Import.NumQstsAdded         = 0;
+   Import.NumQstsInTransaction = 0;
+   XML_ParseFile (FileXML,&ImportHandlers,&Import);
+
+   /***** Commit last questions added *****/
+   if (Import.NumQstsInTransaction)
+      DB_CommitTransaction ();
+
+   /***** Show number of questions added *****/
+   /* The page is written into the HTML output file
+      and sent to the browser only when the action ends,
+      so progress can not be shown while importing.
+      The row of each question and this summary are shown at the end */
+   switch (Import.State)
      {
-      TestElem = RootElem->FirstChild;
-      if (strcmp (TestElem->TagName,"test"))	// <test> must be at level 1
-         TestElem = NULL;
+      case TsI_BEFORE_TEST:
+      case TsI_NO_TEST:
+	 Ale_ShowAlert (Ale_ERROR,"Root element &lt;test&gt; not found.");
+	 break;
+      default:
+	 if (Import.NumQstsAdded == 0)
+	    Ale_ShowAlert (Ale_WARNING,Txt_No_questions_have_been_added);
+	 else if (Import.NumQstsAdded == 1)
+	    Ale_ShowAlert (Ale_SUCCESS,Txt_A_question_has_been_added);
+	 else
+	    Ale_ShowAlert (Ale_SUCCESS,Txt_X_questions_have_been_added,
+	                   Import.NumQstsAdded);
+	 break;
      }
-   if (TestElem)
-     {
-      /* Current element is <test> */
 
-      /***** Write heading of list of imported questions *****/
-      HTM_TABLE_BeginWideMarginPadding (5);
-      TsI_WriteHeadingListImportedQst ();
+   /***** End box *****/
+   Box_BoxEnd ();
 
-      /***** For each question... *****/
-      for (QuestionElem = TestElem->FirstChild;
-	   QuestionElem != NULL;
-	   QuestionElem = QuestionElem->NextBrother)
-	{
-	 if (!strcmp (QuestionElem->TagName,"question"))
+   /***** Close file *****/
+   fclose (FileXML);
+  }
+
+/*****************************************************************************/
+/************** Process the start tag of an element in XML file **************/
+/*****************************************************************************/
+/*
+<test>
+  <question type="...">
+    <tags><tag>...</tag>...</tags>
+    <stem>...</stem>
+    <feedback>...</feedback>
+    <answer shuffle="...">...<option correct="..."><text>...</text><feedback>...</feedback></option>...</answer>
+  </question>
+  ...
+</test>
+*/
+// Only the first element of each kind is taken into account
+
+static void TsI_StartElement (void *ImportPtr,unsigned Level,const char *TagName,
+                              const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                              unsigned NumAttributes)
+  {
+   struct TsI_Import *Import = (struct TsI_Import *) ImportPtr;
+   struct Tst_Question *Question = &Import->Question;
+   const char *Shuffle;
+   const char *Correct;
+
+   switch (Level)
+     {
+      case 1:	// <test> must be at level 1
+	 if (Import->State == TsI_BEFORE_TEST)
+	   {
+	    if (strcmp (TagName,"test"))
+	       Import->State = TsI_NO_TEST;
+	    else
+	      {
+	       Import->State = TsI_IN_TEST;
+
+	       /***** Write heading of list of imported questions *****/
+	       HTM_TABLE_BeginWideMarginPadding (5);
+	       TsI_WriteHeadingListImportedQst ();
+	      }
+	   }
+	 break;
+      case 2:
+	 if (Import->State == TsI_IN_TEST &&
+	     !strcmp (TagName,"question"))
 	   {
 	    /***** Create test question *****/
-	    Tst_QstConstructor (&Question);
+	    Tst_QstConstructor (Question);
+	    Import->InQuestion   = true;
+	    Import->InTags       =
+	    Import->InAnswer     =
+	    Import->InOption     = false;
+	    Import->Found.Tags     =
+	    Import->Found.Stem     =
+	    Import->Found.Feedback =
+	    Import->Found.Answer   =
+	    Import->Found.Lower    =
+	    Import->Found.Upper    = false;
+	    Import->NumOpt = 0;
 
 	    /* Get answer type (in mandatory attribute "type") */
-	    AnswerTypeFound = false;
-	    for (Attribute = QuestionElem->FirstAttribute;
-		 Attribute != NULL;
-		 Attribute = Attribute->Next)
-	       if (!strcmp (Attribute->AttributeName,"type"))
+	    Question->Answer.Type = TsI_ConvertFromStrAnsTypXMLToAnsTyp (XML_GetAttribute (Attributes,NumAttributes,"type"));
+	   }
+	 break;
+      case 3:
+	 if (Import->InQuestion)
+	   {
+	    if (!strcmp (TagName,"tags"))
+	      {
+	       if (!Import->Found.Tags)
 		 {
-		  Question.Answer.Type = TsI_ConvertFromStrAnsTypXMLToAnsTyp (Attribute->Content);
-		  AnswerTypeFound = true;
-		  break;	// Only first attribute "type"
+		  Import->Found.Tags = true;
+		  Import->InTags = true;
 		 }
-
-	    if (AnswerTypeFound)
+	      }
+	    else if (!strcmp (TagName,"stem"))
 	      {
-	       /* Get tags */
-	       for (TagsElem = QuestionElem->FirstChild, Question.Tags.Num = 0;
-		    TagsElem != NULL;
-		    TagsElem = TagsElem->NextBrother)
-		  if (!strcmp (TagsElem->TagName,"tags"))
+	       if (!Import->Found.Stem)
+		 {
+		  Import->Found.Stem = true;
+		  Import->Content = TsI_CONTENT_STEM;
+		 }
+	      }
+	    else if (!strcmp (TagName,"feedback"))
+	      {
+	       if (!Import->Found.Feedback)
+		 {
+		  Import->Found.Feedback = true;
+		  Import->Content = TsI_CONTENT_FEEDBACK;
+		 }
+	      }
+	    else if (!strcmp (TagName,"answer"))
+	       if (!Import->Found.Answer)
+		 {
+		  Import->Found.Answer = true;
+		  Import->InAnswer = true;
+		  switch (Question->Answer.Type)
 		    {
-		     for (TagElem = TagsElem->FirstChild;
-			  TagElem != NULL && Question.Tags.Num < Tag_MAX_TAGS_PER_QUESTION;
-			  TagElem = TagElem->NextBrother)
-			if (!strcmp (TagElem->TagName,"tag"))
-			  {
-			   if (TagElem->Content)
-			     {
-			      Str_Copy (Question.Tags.Txt[Question.Tags.Num],
-					TagElem->Content,
-					Tag_MAX_BYTES_TAG);
-			      Question.Tags.Num++;
-			     }
-			  }
-		     break;	// Only first element "tags"
+		     case Tst_ANS_INT:
+			if (!Tst_AllocateTextChoiceAnswer (Question,0))
+			   /* Abort on error */
+			   Ale_ShowAlertsAndExit ();
+			Import->Content = TsI_CONTENT_ANSWER;
+			break;
+		     case Tst_ANS_FLOAT:
+			if (!Tst_AllocateTextChoiceAnswer (Question,0))
+			   /* Abort on error */
+			   Ale_ShowAlertsAndExit ();
+			if (!Tst_AllocateTextChoiceAnswer (Question,1))
+			   /* Abort on error */
+			   Ale_ShowAlertsAndExit ();
+			break;
+		     case Tst_ANS_TRUE_FALSE:
+			Question->Answer.TF = ' ';
+			Import->Content = TsI_CONTENT_ANSWER;
+			break;
+		     case Tst_ANS_UNIQUE_CHOICE:
+		     case Tst_ANS_MULTIPLE_CHOICE:
+			/* Get whether shuffle answers (in attribute "shuffle") */
+			if ((Shuffle = XML_GetAttribute (Attributes,NumAttributes,"shuffle")))
+			   Question->Answer.Shuffle = XML_GetAttributteYesNo (Shuffle);
+			break;
+		     default:
+			break;
 		    }
-
-	       /* Get stem (mandatory) */
-	       for (StemElem = QuestionElem->FirstChild;
-		    StemElem != NULL;
-		    StemElem = StemElem->NextBrother)
-		  if (!strcmp (StemElem->TagName,"stem"))
+		 }
+	   }
+	 break;
+      case 4:
+	 if (Import->InTags)
+	   {
+	    if (!strcmp (TagName,"tag"))
+	       Import->Content = TsI_CONTENT_TAG;
+	   }
+	 else if (Import->InAnswer)
+	    switch (Question->Answer.Type)
+	      {
+	       case Tst_ANS_FLOAT:
+		  if (!strcmp (TagName,"lower"))
 		    {
-		     if (StemElem->Content)
+		     if (!Import->Found.Lower)
 		       {
-			/* Convert stem from text to HTML (in database stem is stored in HTML) */
-			Str_Copy (Question.Stem,StemElem->Content,
-				  Cns_MAX_BYTES_TEXT);
-			Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
-					  Question.Stem,Cns_MAX_BYTES_TEXT,true);
+			Import->Found.Lower = true;
+			Import->Content = TsI_CONTENT_LOWER;
 		       }
-		     break;	// Only first element "stem"
 		    }
-
-	       /* Get feedback (optional) */
-	       for (FeedbackElem = QuestionElem->FirstChild;
-		    FeedbackElem != NULL;
-		    FeedbackElem = FeedbackElem->NextBrother)
-		  if (!strcmp (FeedbackElem->TagName,"feedback"))
-		    {
-		     if (FeedbackElem->Content)
+		  else if (!strcmp (TagName,"upper"))
+		     if (!Import->Found.Upper)
 		       {
-			/* Convert feedback from text to HTML (in database feedback is stored in HTML) */
-			Str_Copy (Question.Feedback,FeedbackElem->Content,
-				  Cns_MAX_BYTES_TEXT);
-			Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
-					  Question.Feedback,Cns_MAX_BYTES_TEXT,true);
+			Import->Found.Upper = true;
+			Import->Content = TsI_CONTENT_UPPER;
 		       }
-		     break;	// Only first element "feedback"
-		    }
-
-	       /* Get shuffle. By default, shuffle is false. */
-	       Question.Answer.Shuffle = false;
-	       for (AnswerElem = QuestionElem->FirstChild;
-		    AnswerElem != NULL;
-		    AnswerElem = AnswerElem->NextBrother)
-		  if (!strcmp (AnswerElem->TagName,"answer"))
+		  break;
+	       case Tst_ANS_UNIQUE_CHOICE:
+	       case Tst_ANS_MULTIPLE_CHOICE:
+	       case Tst_ANS_TEXT:
+		  if (!strcmp (TagName,"option") &&
+		      Import->NumOpt < Tst_MAX_OPTIONS_PER_QUESTION)
 		    {
-		     if (Question.Answer.Type == Tst_ANS_UNIQUE_CHOICE ||
-			 Question.Answer.Type == Tst_ANS_MULTIPLE_CHOICE)
-			/* Get whether shuffle answers (in attribute "shuffle") */
-			for (Attribute = AnswerElem->FirstAttribute;
-			     Attribute != NULL;
-			     Attribute = Attribute->Next)
-			   if (!strcmp (Attribute->AttributeName,"shuffle"))
-			     {
-			      Question.Answer.Shuffle = XML_GetAttributteYesNoFromXMLTree (Attribute);
-			      break;	// Only first attribute "shuffle"
-			     }
-		     break;	// Only first element "answer"
+		     if (!Tst_AllocateTextChoiceAnswer (Question,Import->NumOpt))
+			/* Abort on error */
+			Ale_ShowAlertsAndExit ();
+		     Import->InOption = true;
+		     Import->Found.Text           =
+		     Import->Found.OptionFeedback = false;
+
+		     if (Question->Answer.Type == Tst_ANS_TEXT)
+			Question->Answer.Options[Import->NumOpt].Correct = true;
+		     else if ((Correct = XML_GetAttribute (Attributes,NumAttributes,"correct")))
+			/* Check if option is correct or wrong */
+			Question->Answer.Options[Import->NumOpt].Correct = XML_GetAttributteYesNo (Correct);
 		    }
+		  break;
+	       default:
+		  break;
+	      }
+	 break;
+      case 5:
+	 if (Import->InOption)
+	   {
+	    if (!strcmp (TagName,"text"))
+	      {
+	       if (!Import->Found.Text)
+		 {
+		  Import->Found.Text = true;
+		  Import->Content = TsI_CONTENT_OPTION_TEXT;
+		 }
+	      }
+	    else if (!strcmp (TagName,"feedback"))
+	       if (!Import->Found.OptionFeedback)
+		 {
+		  Import->Found.OptionFeedback = true;
+		  Import->Content = TsI_CONTENT_OPTION_FEEDBACK;
+		 }
+	   }
+	 break;
+      default:
+	 break;
+     }
+  }
 
-	       /* Get answer (mandatory) */
-	       TsI_GetAnswerFromXML (AnswerElem,&Question);
+/*****************************************************************************/
+/**************** Get the content of an element in XML file ******************/
+/*****************************************************************************/
 
-	       /* Make sure that tags, text and answer are not empty */
-	       if (Tst_CheckIfQstFormatIsCorrectAndCountNumOptions (&Question))
-		 {
-		  /* Check if question already exists in database */
-		  QuestionExists = Tst_CheckIfQuestionExistsInDB (&Question);
+static void TsI_GetContent (void *ImportPtr,
+                            __attribute__((unused)) unsigned Level,
+                            __attribute__((unused)) const char *TagName,
+                            const char *Content)
+  {
+   struct TsI_Import *Import = (struct TsI_Import *) ImportPtr;
+   struct Tst_Question *Question = &Import->Question;
 
-		  /* Write row with this imported question */
-		  TsI_WriteRowImportedQst (StemElem,FeedbackElem,
-		                           &Question,QuestionExists);
+   switch (Import->Content)
+     {
+      case TsI_CONTENT_TAG:
+	 if (Question->Tags.Num < Tag_MAX_TAGS_PER_QUESTION)
+	   {
+	    Str_Copy (Question->Tags.Txt[Question->Tags.Num],Content,
+		      Tag_MAX_BYTES_TAG);
+	    Question->Tags.Num++;
+	   }
+	 break;
+      case TsI_CONTENT_STEM:
+	 /* Convert stem from text to HTML (in database stem is stored in HTML) */
+	 Str_Copy (Question->Stem,Content,
+		   Cns_MAX_BYTES_TEXT);
+	 Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
+			   Question->Stem,Cns_MAX_BYTES_TEXT,true);
+	 break;
+      case TsI_CONTENT_FEEDBACK:
+	 /* Convert feedback from text to HTML (in database feedback is stored in HTML) */
+	 Str_Copy (Question->Feedback,Content,
+		   Cns_MAX_BYTES_TEXT);
+	 Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
+			   Question->Feedback,Cns_MAX_BYTES_TEXT,true);
+	 break;
+      case TsI_CONTENT_ANSWER:
+	 if (Question->Answer.Type == Tst_ANS_INT)
+	    Str_Copy (Question->Answer.Options[0].Text,Content,
+		      Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
+	 else	// Tst_ANS_TRUE_FALSE
+	    // Comparisons must be case insensitive, because users can edit XML
+	    if (!strcasecmp (Content,"true")  ||
+		!strcasecmp (Content,"T")     ||
+		!strcasecmp (Content,"yes")   ||
+		!strcasecmp (Content,"Y"))
+	       Question->Answer.TF = 'T';
+	    else if (!strcasecmp (Content,"false") ||
+		     !strcasecmp (Content,"F")     ||
+		     !strcasecmp (Content,"no")    ||
+		     !strcasecmp (Content,"N"))
+	       Question->Answer.TF = 'F';
+	 break;
+      case TsI_CONTENT_LOWER:
+	 Str_Copy (Question->Answer.Options[0].Text,Content,
+		   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
+	 break;
+      case TsI_CONTENT_UPPER:
+	 Str_Copy (Question->Answer.Options[1].Text,Content,
+		   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
+	 break;
+      case TsI_CONTENT_OPTION_TEXT:
+	 /* Convert answer from text to HTML (in database answer text is stored in HTML) */
+	 Str_Copy (Question->Answer.Options[Import->NumOpt].Text,Content,
+		   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
+	 Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
+			   Question->Answer.Options[Import->NumOpt].Text,
+			   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK,true);
+	 break;
+      case TsI_CONTENT_OPTION_FEEDBACK:
+	 /* Convert feedback from text to HTML (in database answer feedback is stored in HTML) */
+	 Str_Copy (Question->Answer.Options[Import->NumOpt].Feedback,Content,
+		   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
+	 Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
+			   Question->Answer.Options[Import->NumOpt].Feedback,
+			   Tst_MAX_BYTES_ANSWER_OR_FEEDBACK,true);
+	 break;
+      default:
+	 break;
+     }
+  }
 
-		  /***** If a new question ==> insert question, tags and answer in the database *****/
-		  if (!QuestionExists)
-		    {
-		     Question.QstCod = -1L;
-		     Tst_InsertOrUpdateQstTagsAnsIntoDB (&Question);
-		     if (Question.QstCod <= 0)
-			Lay_ShowErrorAndExit ("Can not create question.");
-		    }
-		 }
-	      }
-	    else	// Answer type not found
-	       Lay_ShowErrorAndExit ("Wrong type of answer.");
+/*****************************************************************************/
+/*************** Process the end tag of an element in XML file ***************/
+/*****************************************************************************/
 
-	    /***** Destroy test question *****/
-	    Tst_QstDestructor (&Question);
+static void TsI_EndElement (void *ImportPtr,unsigned Level,
+                            __attribute__((unused)) const char *TagName)
+  {
+   struct TsI_Import *Import = (struct TsI_Import *) ImportPtr;
+
+   /***** Content only in the element just closed *****/
+   Import->Content = TsI_CONTENT_NONE;
+
+   switch (Level)
+     {
+      case 1:
+	 if (Import->State == TsI_IN_TEST)
+	   {
+	    Import->State = TsI_AFTER_TEST;
+	    HTM_TABLE_End ();
 	   }
-	}
+	 break;
+      case 2:
+	 if (Import->InQuestion)
+	   {
+	    /***** Store question, tags and answer in database *****/
+	    TsI_ImportQuestion (Import);
 
-      HTM_TABLE_End ();
+	    /***** Destroy test question *****/
+	    Tst_QstDestructor (&Import->Question);
+	    Import->InQuestion = false;
+	   }
+	 break;
+      case 3:
+	 Import->InTags   =
+	 Import->InAnswer = false;
+	 break;
+      case 4:
+	 if (Import->InOption)
+	   {
+	    Import->InOption = false;
+	    Import->NumOpt++;
+	   }
+	 break;
+      default:
+	 break;
      }
-   else	// TestElem not found
-      Ale_ShowAlert (Ale_ERROR,"Root element &lt;test&gt; not found.");
+  }
 
-   /***** End table *****/
-   Box_BoxEnd ();
+/*****************************************************************************/
+/******** Write an imported question and store it in database if new *********/
+/*****************************************************************************/
+// Questions are inserted in transactions of several questions,
+// much faster than committing every insert when importing large files
+
+static void TsI_ImportQuestion (struct TsI_Import *Import)
+  {
+   struct Tst_Question *Question = &Import->Question;
+   bool QuestionExists;
 
-   /***** Free XML tree *****/
-   XML_FreeTree (RootElem);
+   /***** Make sure that tags, text and answer are not empty *****/
+   if (Tst_CheckIfQstFormatIsCorrectAndCountNumOptions (Question))
+     {
+      /***** Check if question already exists in database *****/
+      QuestionExists = Tst_CheckIfQuestionExistsInDB (Question);
+
+      /***** Write row with this imported question *****/
+      TsI_WriteRowImportedQst (Question,QuestionExists);
+
+      /***** If a new question ==> insert question, tags and answer in the database *****/
+      if (!QuestionExists)
+	{
+	 if (!Import->NumQstsInTransaction)
+	    DB_StartTransaction ();
+
+	 Question->QstCod = -1L;
+	 Tst_InsertOrUpdateQstTagsAnsIntoDB (Question);
+	 if (Question->QstCod <= 0)
+	    Lay_ShowErrorAndExit ("Can not create question.");
+	 Import->NumQstsAdded++;
+
+	 if (++Import->NumQstsInTransaction == TsI_MAX_QSTS_PER_TRANSACTION)
+	   {
+	    DB_CommitTransaction ();
+	    Import->NumQstsInTransaction = 0;
+	   }
+	}
+     }
   }
 
 /*****************************************************************************/
@@ -700,150 +970,6 @@ static Tst_AnswerType_t TsI_ConvertFromStrAnsTypXMLToAnsTyp (const char *StrAnsT
    return (Tst_AnswerType_t) 0;	// Not reached
   }
 
-/*****************************************************************************/
-/**************** Get answer inside an XML question elements *****************/
-/*****************************************************************************/
-// Answer is mandatory
-
-static void TsI_GetAnswerFromXML (struct XMLElement *AnswerElem,
-                                  struct Tst_Question *Question)
-  {
-   struct XMLElement *OptionElem;
-   struct XMLElement *TextElem;
-   struct XMLElement *FeedbackElem;
-   struct XMLElement *LowerUpperElem;
-   struct XMLAttribute *Attribute;
-   unsigned NumOpt;
-
-   switch (Question->Answer.Type)
-     {
-      case Tst_ANS_INT:
-         if (!Tst_AllocateTextChoiceAnswer (Question,0))
-	    /* Abort on error */
-	    Ale_ShowAlertsAndExit ();
-
-         if (AnswerElem->Content)
-            Str_Copy (Question->Answer.Options[0].Text,AnswerElem->Content,
-                      Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
-         break;
-      case Tst_ANS_FLOAT:
-         if (!Tst_AllocateTextChoiceAnswer (Question,0))
-	    /* Abort on error */
-	    Ale_ShowAlertsAndExit ();
-         if (!Tst_AllocateTextChoiceAnswer (Question,1))
-	    /* Abort on error */
-	    Ale_ShowAlertsAndExit ();
-
-         for (LowerUpperElem = AnswerElem->FirstChild;
-              LowerUpperElem != NULL;
-              LowerUpperElem = LowerUpperElem->NextBrother)
-            if (!strcmp (LowerUpperElem->TagName,"lower"))
-              {
-               if (LowerUpperElem->Content)
-                  Str_Copy (Question->Answer.Options[0].Text,
-                            LowerUpperElem->Content,
-                            Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
-               break;	// Only first element "lower"
-              }
-         for (LowerUpperElem = AnswerElem->FirstChild;
-              LowerUpperElem != NULL;
-              LowerUpperElem = LowerUpperElem->NextBrother)
-            if (!strcmp (LowerUpperElem->TagName,"upper"))
-              {
-               if (LowerUpperElem->Content)
-                  Str_Copy (Question->Answer.Options[1].Text,
-                            LowerUpperElem->Content,
-                            Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
-               break;	// Only first element "upper"
-              }
-         break;
-      case Tst_ANS_TRUE_FALSE:
-	 // Comparisons must be case insensitive, because users can edit XML
-         if (!AnswerElem->Content)
-            Question->Answer.TF = ' ';
-         else if (!strcasecmp (AnswerElem->Content,"true")  ||
-                  !strcasecmp (AnswerElem->Content,"T")     ||
-                  !strcasecmp (AnswerElem->Content,"yes")   ||
-                  !strcasecmp (AnswerElem->Content,"Y"))
-            Question->Answer.TF = 'T';
-         else if (!strcasecmp (AnswerElem->Content,"false") ||
-                  !strcasecmp (AnswerElem->Content,"F")     ||
-                  !strcasecmp (AnswerElem->Content,"no")    ||
-                  !strcasecmp (AnswerElem->Content,"N"))
-            Question->Answer.TF = 'F';
-         else
-            Question->Answer.TF = ' ';
-         break;
-      case Tst_ANS_UNIQUE_CHOICE:
-      case Tst_ANS_MULTIPLE_CHOICE:
-      case Tst_ANS_TEXT:
-         /* Get options */
-         for (OptionElem = AnswerElem->FirstChild, NumOpt = 0;
-              OptionElem != NULL && NumOpt < Tst_MAX_OPTIONS_PER_QUESTION;
-              OptionElem = OptionElem->NextBrother, NumOpt++)
-            if (!strcmp (OptionElem->TagName,"option"))
-              {
-               if (!Tst_AllocateTextChoiceAnswer (Question,NumOpt))
-		  /* Abort on error */
-		  Ale_ShowAlertsAndExit ();
-
-	       for (TextElem = OptionElem->FirstChild;
-		    TextElem != NULL;
-		    TextElem = TextElem->NextBrother)
-		  if (!strcmp (TextElem->TagName,"text"))
-		    {
-		     if (TextElem->Content)
-		       {
-			Str_Copy (Question->Answer.Options[NumOpt].Text,
-			          TextElem->Content,
-			          Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
-
-			/* Convert answer from text to HTML (in database answer text is stored in HTML) */
-			Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
-			                  Question->Answer.Options[NumOpt].Text,
-			                  Tst_MAX_BYTES_ANSWER_OR_FEEDBACK,true);
-		       }
-		     break;	// Only first element "text"
-		    }
-
-	       for (FeedbackElem = OptionElem->FirstChild;
-		    FeedbackElem != NULL;
-		    FeedbackElem = FeedbackElem->NextBrother)
-		  if (!strcmp (FeedbackElem->TagName,"feedback"))
-		    {
-		     if (FeedbackElem->Content)
-		       {
-			Str_Copy (Question->Answer.Options[NumOpt].Feedback,
-			          FeedbackElem->Content,
-			          Tst_MAX_BYTES_ANSWER_OR_FEEDBACK);
-
-			/* Convert feedback from text to HTML (in database answer feedback is stored in HTML) */
-			Str_ChangeFormat (Str_FROM_TEXT,Str_TO_HTML,
-			                  Question->Answer.Options[NumOpt].Feedback,
-			                  Tst_MAX_BYTES_ANSWER_OR_FEEDBACK,true);
-		       }
-		     break;	// Only first element "feedback"
-		    }
-
-	       if (Question->Answer.Type == Tst_ANS_TEXT)
-		  Question->Answer.Options[NumOpt].Correct = true;
-	       else
-		  /* Check if option is correct or wrong */
-		  for (Attribute = OptionElem->FirstAttribute;
-		       Attribute != NULL;
-		       Attribute = Attribute->Next)
-		     if (!strcmp (Attribute->AttributeName,"correct"))
-		       {
-			Question->Answer.Options[NumOpt].Correct = XML_GetAttributteYesNoFromXMLTree (Attribute);
-			break;	// Only first attribute "correct"
-		       }
-               }
-         break;
-      default:
-         break;
-     }
-  }
-
 /*****************************************************************************/
 /************* Write heading of list of imported test questions **************/
 /*****************************************************************************/
@@ -874,9 +1000,7 @@ static void TsI_WriteHeadingListImportedQst (void)
 /**************** Write a row with one imported test question ****************/
 /*****************************************************************************/
 
-static void TsI_WriteRowImportedQst (struct XMLElement *StemElem,
-                                     struct XMLElement *FeedbackElem,
-                                     const struct Tst_Question *Question,
+static void TsI_WriteRowImportedQst (const struct Tst_Question *Question,
                                      bool QuestionExists)
   {
    extern const char *Txt_Existing_question;
@@ -886,10 +1010,6 @@ static void TsI_WriteRowImportedQst (struct XMLElement *StemElem,
    extern const char *Txt_TST_Answer_given_by_the_teachers;
    static unsigned NumQst = 0;
    static unsigned NumNonExistingQst = 0;
-   const char *Stem = (StemElem != NULL) ? StemElem->Content :
-	                                   "";
-   const char *Feedback = (FeedbackElem != NULL) ? FeedbackElem->Content :
-	                                           "";
    unsigned NumTag;
    unsigned NumOpt;
    char *AnswerText;
@@ -972,9 +1092,9 @@ static void TsI_WriteRowImportedQst (struct XMLElement *StemElem,
 
    /***** Write the stem and the answers *****/
    HTM_TD_Begin ("class=\"LT COLOR%u\"",Gbl.RowEvenOdd);
-   Tst_WriteQstStem (Stem,ClassStem,
+   Tst_WriteQstStem (Question->Stem,ClassStem,
 		     true);	// Visible
-   Tst_WriteQstFeedback (Feedback,"TEST_TXT_LIGHT");
+   Tst_WriteQstFeedback (Question->Feedback,"TEST_TXT_LIGHT");
    switch (Question->Answer.Type)
      {
       case Tst_ANS_INT:
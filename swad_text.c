@@ -3428,6 +3428,48 @@ const char *Txt_Buildings =
 	"Edif&iacute;cios";
 #endif
 
+const char *Txt_Cache_hits =	// hits = times the data was found in cache
+#if   L==1	// ca
+	"Encerts";
+#elif L==2	// de
+	"Treffer";
+#elif L==3	// en
+	"Hits";
+#elif L==4	// es
+	"Aciertos";
+#elif L==5	// fr
+	"Succ&egrave;s";
+#elif L==6	// gn
+	"Aciertos";		// Okoteve traduccin
+#elif L==7	// it
+	"Successi";
+#elif L==8	// pl
+	"Trafienia";
+#elif L==9	// pt
+	"Acertos";
+#endif
+
+const char *Txt_Cache_misses =	// misses = times the data was not found in cache
+#if   L==1	// ca
+	"Errades";
+#elif L==2	// de
+	"Fehlschl&auml;ge";
+#elif L==3	// en
+	"Misses";
+#elif L==4	// es
+	"Fallos";
+#elif L==5	// fr
+	"&Eacute;checs";
+#elif L==6	// gn
+	"Fallos";		// Okoteve traduccin
+#elif L==7	// it
+	"Fallimenti";
+#elif L==8	// pl
+	"Chybienia";
+#elif L==9	// pt
+	"Falhas";
+#endif
+
 const char *Txt_Calculate =
 #if   L==1	// ca
 	"Calcular";
@@ -15346,6 +15388,27 @@ const char *Txt_Groups =
 	"Grupos";
 #endif
 
+const char *Txt_Groups_are_being_changed_by_other_users_Please_try_again =
+#if   L==1	// ca
+	"Altres usuaris estan canviant els grups. Si us plau, torni-ho a intentar.";
+#elif L==2	// de
+	"Die Gruppen werden von anderen Benutzern ge&auml;ndert. Bitte versuchen Sie es erneut.";
+#elif L==3	// en
+	"Groups are being changed by other users. Please try again.";
+#elif L==4	// es
+	"Otros usuarios est&aacute;n cambiando los grupos. Por favor, int&eacute;ntelo de nuevo.";
+#elif L==5	// fr
+	"Les groupes sont en train d'&ecirc;tre modifi&eacute;s par d'autres utilisateurs. Veuillez r&eacute;essayer.";
+#elif L==6	// gn
+	"Otros usuarios est&aacute;n cambiando los grupos. Por favor, int&eacute;ntelo de nuevo.";	// Okoteve traduccin
+#elif L==7	// it
+	"I gruppi sono in fase di modifica da parte di altri utenti. Per favore, riprova.";
+#elif L==8	// pl
+	"Grupy s&aogon; zmieniane przez innych u&zdot;ytkownik&oacute;w. Spr&oacute;buj ponownie.";
+#elif L==9	// pt
+	"Os grupos est&atilde;o sendo alterados por outros usu&aacute;rios. Por favor, tente novamente.";
+#endif
+
 const char *Txt_Groups_OF_A_USER =	// Warning: it is very important to include %s in the following sentences
 #if   L==1	// ca
 	"Grups de %s";
@@ -15703,6 +15766,27 @@ const char *Txt_historical_log =
 	"log hist&oacute;rico";
 #endif
 
+const char *Txt_Hit_ratio =	// hit ratio = percentage of times the data was found in cache
+#if   L==1	// ca
+	"Taxa d'encerts";
+#elif L==2	// de
+	"Trefferquote";
+#elif L==3	// en
+	"Hit ratio";
+#elif L==4	// es
+	"Tasa de aciertos";
+#elif L==5	// fr
+	"Taux de succ&egrave;s";
+#elif L==6	// gn
+	"Tasa de aciertos";		// Okoteve traduccin
+#elif L==7	// it
+	"Percentuale di successi";
+#elif L==8	// pl
+	"Wsp&oacute;&lstrok;czynnik trafie&nacute;";
+#elif L==9	// pt
+	"Taxa de acertos";
+#endif
+
 const char *Txt_Hits =	// hits = visits, clicks, page views...
 #if   L==1	// ca
 	"Accessos";
@@ -18144,6 +18228,27 @@ const char *Txt_Last_clicks_in_real_time =
 	"&Uacute;ltimos cliques em tempo real";
 #endif
 
+const char *Txt_Last_update =
+#if   L==1	// ca
+	"Darrera actualitzaci&oacute;";
+#elif L==2	// de
+	"Letzte Aktualisierung";
+#elif L==3	// en
+	"Last update";
+#elif L==4	// es
+	"&Uacute;ltima actualizaci&oacute;n";
+#elif L==5	// fr
+	"Derni&egrave;re mise &agrave; jour";
+#elif L==6	// gn
+	"&Uacute;ltima actualizaci&oacute;n";	// Okoteve traduccin
+#elif L==7	// it
+	"Ultimo aggiornamento";
+#elif L==8	// pl
+	"Ostatnia aktualizacja";
+#elif L==9	// pt
+	"&Uacute;ltima atualiza&ccedil;&atilde;o";
+#endif
+
 const char *Txt_Latitude =
 #if   L==1	// ca
 	"Latitud";
@@ -44609,6 +44714,27 @@ const char *Txt_FIGURE_TYPES[Fig_NUM_FIGURES] =
 	"Cookies"
 #elif L==9	// pt
 	"Cookies"
+#endif
+	,
+	[Fig_FRAGMENT_CACHE] =
+#if   L==1	// ca
+	"Mem&ograve;ria cau"
+#elif L==2	// de
+	"Cache"
+#elif L==3	// en
+	"Cache"
+#elif L==4	// es
+	"Cach&eacute;"
+#elif L==5	// fr
+	"Cache"
+#elif L==6	// gn
+	"Cach&eacute;"	// Okoteve traduccin
+#elif L==7	// it
+	"Cache"
+#elif L==8	// pl
+	"Pami&eogon;&cacute; podr&eogon;czna"
+#elif L==9	// pt
+	"Cache"
 #endif
 	};
 
@@ -50034,6 +50160,27 @@ const char *Txt_The_record_field_X_has_been_renamed_as_Y =	// Warning: it is ver
 	"O campo de cart&atilde;o <strong>%s</strong> foi renomeado como <strong>%s</strong>.";
 #endif
 
+const char *Txt_The_report_could_not_be_generated_Please_try_again_later =
+#if   L==1	// ca
+	"No s'ha pogut generar l'informe. Si us plau, torni-ho a intentar m&eacute;s tard.";
+#elif L==2	// de
+	"Der Bericht konnte nicht erstellt werden. Bitte versuchen Sie es sp&auml;ter erneut.";
+#elif L==3	// en
+	"The report could not be generated. Please try again later.";
+#elif L==4	// es
+	"No se ha podido generar el informe. Por favor, int&eacute;ntelo de nuevo m&aacute;s tarde.";
+#elif L==5	// fr
+	"Le rapport n'a pas pu &ecirc;tre g&eacute;n&eacute;r&eacute;. Veuillez r&eacute;essayer plus tard.";
+#elif L==6	// gn
+	"No se ha podido generar el informe. Por favor, int&eacute;ntelo de nuevo m&aacute;s tarde.";	// Okoteve traduccin
+#elif L==7	// it
+	"Non &egrave; stato possibile generare il rapporto. Per favore, riprova pi&ugrave; tardi.";
+#elif L==8	// pl
+	"Nie mo&zdot;na wygenerowa&cacute; raportu. Spr&oacute;buj ponownie p&oacute;&zacute;niej.";
+#elif L==9	// pt
+	"N&atilde;o foi poss&iacute;vel gerar o relat&oacute;rio. Por favor, tente novamente mais tarde.";
+#endif
+
 const char *Txt_The_requested_group_changes_were_successful =
 #if   L==1	// ca
 	"Els canvis de grup sol&middot;licitats s'han realitzat correctament.";
@@ -50406,6 +50553,36 @@ const char *Txt_The_survey_has_been_modified =
 	"O inqu&eacute;rito foi modificado.";
 #endif
 
+const char *Txt_The_syllabus_has_been_modified_by_another_user_Try_again =
+#if   L==1	// ca
+	"El temari ha estat modificat per un altre usuari."
+	" Reviseu-lo i torneu-ho a intentar.";
+#elif L==2	// de
+	"Der Lehrplan wurde von einem anderen Benutzer ge&auml;ndert."
+	" &Uuml;berpr&uuml;fen Sie ihn und versuchen Sie es erneut.";
+#elif L==3	// en
+	"The syllabus has been modified by another user."
+	" Review it and try again.";
+#elif L==4	// es
+	"El temario ha sido modificado por otro usuario."
+	" Rev&iacute;selo e int&eacute;ntelo de nuevo.";
+#elif L==5	// fr
+	"Le programme a &eacute;t&eacute; modifi&eacute; par un autre utilisateur."
+	" V&eacute;rifiez-le et r&eacute;essayez.";
+#elif L==6	// gn
+	"El temario ha sido modificado por otro usuario."
+	" Rev&iacute;selo e int&eacute;ntelo de nuevo.";	// Okoteve traduccin
+#elif L==7	// it
+	"Il programma &egrave; stato modificato da un altro utente."
+	" Controllalo e riprova.";
+#elif L==8	// pl
+	"Program zosta&lstrok; zmieniony przez innego u&zdot;ytkownika."
+	" Sprawd&zacute; go i spr&oacute;buj ponownie.";
+#elif L==9	// pt
+	"O programa foi modificado por outro utilizador."
+	" Reveja-o e tente novamente.";
+#endif
+
 const char *Txt_The_tag_X_has_been_renamed_as_Y =	// Warning: it is very important to include two %s in the following sentences
 #if   L==1	// ca
 	"El descriptor <strong>%s</strong> ha pasado a denominarse <strong>%s</strong>.";	// Necessita traduccio
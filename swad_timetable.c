@@ -35,6 +35,7 @@
 #include "swad_calendar.h"
 #include "swad_database.h"
 #include "swad_form.h"
+#include "swad_fragment_cache.h"
 #include "swad_global.h"
 #include "swad_HTML.h"
 #include "swad_language.h"
@@ -515,6 +516,7 @@ static void TT_PutIconToViewMyTT (__attribute__((unused)) void *Args)
 void TT_ShowTimeTable (struct TT_Timetable *Timetable,long UsrCod)
   {
    extern const char *Txt_The_timetable_is_empty;
+   bool UseCache;
 
    /***** Set type of view depending on current action *****/
    Timetable->View = TT_CRS_VIEW;
@@ -535,6 +537,16 @@ void TT_ShowTimeTable (struct TT_Timetable *Timetable,long UsrCod)
 	 break;
      }
 
+   /***** If viewing course timetable with all groups ==>
+          try to get it from cache of fragments *****/
+   UseCache = (Timetable->Type == TT_COURSE_TIMETABLE &&
+	       Timetable->View == TT_CRS_VIEW &&
+	       Gbl.Crs.Grps.WhichGrps == Grp_ALL_GROUPS);
+   if (UseCache)
+      if (Frg_BeginFragment (Frg_CRS_TIMETABLE,Gbl.Hierarchy.Crs.CrsCod,
+			     Gbl.Prefs.FirstDayOfWeek))
+	 return;	// Timetable written from cache
+
    /***** If editing ==> configure and allocate timetable *****/
    if (Timetable->View == TT_CRS_EDIT ||
        Timetable->View == TT_TUT_EDIT)
@@ -585,6 +597,10 @@ void TT_ShowTimeTable (struct TT_Timetable *Timetable,long UsrCod)
 
    /***** Free internal timetable in memory *****/
    TT_FreeTimeTable ();
+
+   /***** Store timetable in cache of fragments *****/
+   if (UseCache)
+      Frg_EndFragment ();
   }
 
 /*****************************************************************************/
@@ -634,6 +650,9 @@ static void TT_WriteCrsTimeTableIntoDB (const struct TT_Timetable *Timetable,
 			       Timetable->Config.SecondsPerInterval,
 			       TT_ClassTypeDB[TT_TimeTable[Weekday][Interval].Columns[Column].ClassType],
 			       TT_TimeTable[Weekday][Interval].Columns[Column].Info);
+
+   /***** Cached course timetable is no longer valid *****/
+   Frg_InvalidateFragments (Frg_CRS_TIMETABLE,CrsCod);
   }
 
 /*****************************************************************************/
@@ -41,6 +41,7 @@
 #include "swad_announcement.h"
 #include "swad_box.h"
 #include "swad_calendar.h"
+#include "swad_code_set.h"
 #include "swad_config.h"
 #include "swad_connected.h"
 #include "swad_course.h"
@@ -67,6 +68,7 @@
 #include "swad_photo.h"
 #include "swad_privacy.h"
 #include "swad_QR.h"
+#include "swad_random.h"
 #include "swad_record.h"
 #include "swad_role.h"
 #include "swad_setting.h"
@@ -139,6 +141,16 @@ const char *Usr_UsrDatMainFieldNames[Usr_NUM_MAIN_FIELDS_DATA_USR];
 /****************************** Private types ********************************/
 /*****************************************************************************/
 
+struct Usr_ListNicks	// Nicknames written explicitely as recipients
+  {
+   unsigned Num;
+   struct
+     {
+      char Nickname[Nck_MAX_BYTES_NICKNAME_WITHOUT_ARROBA + 1];
+      char EncryptedUsrCod[Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64 + 1];
+     } *Lst;
+  };
+
 /*****************************************************************************/
 /************** External global variables from others modules ****************/
 /*****************************************************************************/
@@ -151,6 +163,13 @@ extern struct Globals Gbl;
 
 static void (*Usr_FuncParamsBigList) (void *Args);	// Used to pass pointer to function
 
+static struct CodSet_CodeSet Usr_CandidateUsrs =	// Users found when searching
+  {
+   .Num  = 0,
+   .Size = 0,
+   .Cods = NULL,
+  };
+
 /*****************************************************************************/
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
@@ -162,8 +181,6 @@ static Usr_Sex_t Usr_GetSexFromStr (const char *Str);
 static bool Usr_CheckIfMyBirthdayHasNotBeenCongratulated (void);
 static void Usr_InsertMyBirthday (void);
 
-static void Usr_RemoveTemporaryTableMyCourses (void);
-
 static void Usr_GetParamOtherUsrIDNickOrEMail (void);
 
 static bool Usr_ChkUsrAndGetUsrDataFromDirectLogin (void);
@@ -207,6 +224,12 @@ static void Usr_BuildParamName (char **ParamName,
 static void Usr_AllocateListSelectedEncryptedUsrCods (struct SelectedUsrs *SelectedUsrs,
 						      Rol_Role_t Role);
 static void Usr_AllocateListOtherRecipients (void);
+static void Usr_GetEncryptedUsrCodsFromNicknames (const char *ListOtherRecipients,
+						  struct Usr_ListNicks *ListNicks);
+static const char *Usr_GetEncryptedUsrCodFromListNicks (const struct Usr_ListNicks *ListNicks,
+							const char *NicknameWithArroba);
+static void Usr_AddEncryptedUsrCodToListOfSelected (const char *EncryptedUsrCod,
+						    size_t *LengthSelectedUsrsCods);
 
 static void Usr_FormToSelectUsrListType (void (*FuncParams) (void *Args),void *Args,
                                          Usr_ShowUsrsType_t ListType);
@@ -1104,15 +1127,13 @@ unsigned Usr_GetNumUsrsInCrssOfAUsr (long UsrCod,Rol_Role_t UsrRole,
    char UnsignedStr[Cns_MAX_DECIMAL_DIGITS_UINT + 1];
    char OthersRolesStr[Usr_MAX_BYTES_ROLES_STR + 1];
    char SubQueryRole[64];
+   struct CodSet_CodeSet UsrCrss;
+   char *UsrCrssList;
    unsigned NumUsrs;
    // This query can be made in a unique, but slower, query
-   // The temporary table achieves speedup from ~2s to few ms
+   // Getting first the courses of the user achieves speedup from ~2s to few ms
 
-   /***** Remove temporary table if exists *****/
-   DB_Query ("can not remove temporary tables",
-	     "DROP TEMPORARY TABLE IF EXISTS usr_courses_tmp");
-
-   /***** Create temporary table with all user's courses
+   /***** Get set of all user's courses
           as student/non-editing teacher/teacher *****/
    switch (UsrRole)
      {
@@ -1133,14 +1154,16 @@ unsigned Usr_GetNumUsrsInCrssOfAUsr (long UsrCod,Rol_Role_t UsrRole,
 	 Rol_WrongRoleExit ();
 	 break;
      }
-   DB_Query ("can not create temporary table",
-	     "CREATE TEMPORARY TABLE IF NOT EXISTS usr_courses_tmp"
-	     " (CrsCod INT NOT NULL,UNIQUE INDEX (CrsCod))"
-	     " ENGINE=MEMORY"
-	     " SELECT CrsCod FROM crs_usr"
-	     " WHERE UsrCod=%ld"
-	     "%s",
-	     UsrCod,SubQueryRole);
+   CodSet_ResetSet (&UsrCrss);
+   if (!CodSet_GetSetFromQuery (&UsrCrss,"can not get courses of a user",
+				"SELECT CrsCod FROM crs_usr"
+				" WHERE UsrCod=%ld"
+				"%s",
+				UsrCod,SubQueryRole))
+     {
+      CodSet_FreeSet (&UsrCrss);
+      return 0;	// The user does not belong to any course
+     }
 
    /***** Get the number of students/teachers in a course from database ******/
    OthersRolesStr[0] = '\0';
@@ -1156,17 +1179,18 @@ unsigned Usr_GetNumUsrsInCrssOfAUsr (long UsrCod,Rol_Role_t UsrRole,
 	 Str_Concat (OthersRolesStr,UnsignedStr,
 		     Usr_MAX_BYTES_ROLES_STR);
         }
+   CodSet_BuildListOfCods (&UsrCrss,&UsrCrssList);
    NumUsrs =
    (unsigned) DB_QueryCOUNT ("can not get number of users",
-			     "SELECT COUNT(DISTINCT crs_usr.UsrCod)"
-			     " FROM crs_usr,usr_courses_tmp"
-			     " WHERE crs_usr.CrsCod=usr_courses_tmp.CrsCod"
-			     " AND crs_usr.Role IN (%s)",
-			     OthersRolesStr);
+			     "SELECT COUNT(DISTINCT UsrCod)"
+			     " FROM crs_usr"
+			     " WHERE CrsCod IN (%s)"
+			     " AND Role IN (%s)",
+			     UsrCrssList,OthersRolesStr);
 
-   /***** Remove temporary table *****/
-   DB_Query ("can not remove temporary tables",
-	     "DROP TEMPORARY TABLE IF EXISTS usr_courses_tmp");
+   /***** Free list and set of user's courses *****/
+   free (UsrCrssList);
+   CodSet_FreeSet (&UsrCrss);
 
    return NumUsrs;
   }
@@ -1433,6 +1457,7 @@ void Usr_FlushCacheUsrSharesAnyOfMyCrs (void)
 bool Usr_CheckIfUsrSharesAnyOfMyCrs (struct UsrData *UsrDat)
   {
    bool ItsMe;
+   char *MyCrssList;
 
    /***** 1. Fast check: Am I logged? *****/
    if (!Gbl.Usrs.Me.Logged)
@@ -1469,12 +1494,18 @@ bool Usr_CheckIfUsrSharesAnyOfMyCrs (struct UsrData *UsrDat)
 
    /* Check if user shares any course with me */
    Gbl.Cache.UsrSharesAnyOfMyCrs.UsrCod = UsrDat->UsrCod;
-   Gbl.Cache.UsrSharesAnyOfMyCrs.SharesAnyOfMyCrs =
-      (DB_QueryCOUNT ("can not check if a user shares any course with you",
-		      "SELECT COUNT(*) FROM crs_usr"
-		      " WHERE UsrCod=%ld"
-		      " AND CrsCod IN (SELECT CrsCod FROM my_courses_tmp)",
-		      UsrDat->UsrCod) != 0);
+   Gbl.Cache.UsrSharesAnyOfMyCrs.SharesAnyOfMyCrs = false;
+   if (Gbl.Usrs.Me.MyCrss.Num)
+     {
+      CodSet_BuildListOfCods (&Gbl.Usrs.Me.MyCrss.Cods,&MyCrssList);
+      Gbl.Cache.UsrSharesAnyOfMyCrs.SharesAnyOfMyCrs =
+	 (DB_QueryCOUNT ("can not check if a user shares any course with you",
+			 "SELECT COUNT(*) FROM crs_usr"
+			 " WHERE UsrCod=%ld"
+			 " AND CrsCod IN (%s)",
+			 UsrDat->UsrCod,MyCrssList) != 0);
+      free (MyCrssList);
+     }
    return Gbl.Cache.UsrSharesAnyOfMyCrs.SharesAnyOfMyCrs;
   }
 
@@ -1484,7 +1515,12 @@ bool Usr_CheckIfUsrSharesAnyOfMyCrs (struct UsrData *UsrDat)
 
 bool Usr_CheckIfUsrSharesAnyOfMyCrsWithDifferentRole (long UsrCod)
   {
-   bool UsrSharesAnyOfMyCrsWithDifferentRole;
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumCrss;
+   unsigned NumCrs;
+   char *MyCrssList;
+   bool UsrSharesAnyOfMyCrsWithDifferentRole = false;
 
    /***** 1. Fast check: Am I logged? *****/
    if (!Gbl.Usrs.Me.Logged)
@@ -1495,28 +1531,33 @@ bool Usr_CheckIfUsrSharesAnyOfMyCrsWithDifferentRole (long UsrCod)
    /* Fill the list with the courses I belong to (if not already filled) */
    Usr_GetMyCourses ();
 
-   /* Remove temporary table if exists */
-   DB_Query ("can not remove temporary tables",
-	     "DROP TEMPORARY TABLE IF EXISTS usr_courses_tmp");
-
-   /* Create temporary table with all user's courses for a role */
-   DB_Query ("can not create temporary table",
-	     "CREATE TEMPORARY TABLE IF NOT EXISTS usr_courses_tmp "
-	     "(CrsCod INT NOT NULL,Role TINYINT NOT NULL,"
-   	     "UNIQUE INDEX(CrsCod,Role)) ENGINE=MEMORY"
-  	     " SELECT CrsCod,Role FROM crs_usr WHERE UsrCod=%ld",
-	     UsrCod);
-
-   /* Get if a user shares any course with me from database */
-   UsrSharesAnyOfMyCrsWithDifferentRole =
-      (DB_QueryCOUNT ("can not check if a user shares any course with you",
-		      "SELECT COUNT(*) FROM my_courses_tmp,usr_courses_tmp"
-                      " WHERE my_courses_tmp.CrsCod=usr_courses_tmp.CrsCod"
-                      " AND my_courses_tmp.Role<>usr_courses_tmp.Role") != 0);
-
-   /* Remove temporary table if exists */
-   DB_Query ("can not remove temporary tables",
-	     "DROP TEMPORARY TABLE IF EXISTS usr_courses_tmp");
+   if (!Gbl.Usrs.Me.MyCrss.Num)
+      return false;
+
+   /* Get the user's roles in the courses shared with me */
+   CodSet_BuildListOfCods (&Gbl.Usrs.Me.MyCrss.Cods,&MyCrssList);
+   NumCrss =
+   (unsigned) DB_QuerySELECT (&mysql_res,"can not check if a user shares"
+					 " any course with you",
+			      "SELECT CrsCod,Role FROM crs_usr"
+			      " WHERE UsrCod=%ld"
+			      " AND CrsCod IN (%s)",
+			      UsrCod,MyCrssList);
+   free (MyCrssList);
+
+   /* Compare the user's role with my role in each shared course */
+   for (NumCrs = 0;
+	NumCrs < NumCrss && !UsrSharesAnyOfMyCrsWithDifferentRole;
+	NumCrs++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      UsrSharesAnyOfMyCrsWithDifferentRole =
+	 (Rol_ConvertUnsignedStrToRole (row[1]) !=
+	  Rol_GetMyRoleInCrs (Str_ConvertStrCodToLongCod (row[0])));
+     }
+
+   /* Free structure that stores the query result */
+   DB_FreeMySQLResult (&mysql_res);
 
    return UsrSharesAnyOfMyCrsWithDifferentRole;
   }
@@ -1725,33 +1766,21 @@ void Usr_GetMyCourses (void)
    if (!Gbl.Usrs.Me.MyCrss.Filled)
      {
       Gbl.Usrs.Me.MyCrss.Num = 0;
+      CodSet_ResetSet (&Gbl.Usrs.Me.MyCrss.Cods);
 
       if (Gbl.Usrs.Me.Logged)
 	{
-	 /***** Remove temporary table with my courses *****/
-	 Usr_RemoveTemporaryTableMyCourses ();
-
-	 /***** Create temporary table with my courses *****/
-	 DB_Query ("can not create temporary table",
-	           "CREATE TEMPORARY TABLE IF NOT EXISTS my_courses_tmp "
-		   "(CrsCod INT NOT NULL,"
-		   "Role TINYINT NOT NULL,"
-		   "DegCod INT NOT NULL,"
-		   "UNIQUE INDEX(CrsCod,Role,DegCod)) ENGINE=MEMORY"
-		   " SELECT crs_usr.CrsCod,crs_usr.Role,courses.DegCod"
-		   " FROM crs_usr,courses,degrees"
-		   " WHERE crs_usr.UsrCod=%ld"
-		   " AND crs_usr.CrsCod=courses.CrsCod"
-		   " AND courses.DegCod=degrees.DegCod"
-		   " ORDER BY degrees.ShortName,courses.ShortName",
-		   Gbl.Usrs.Me.UsrDat.UsrCod);
-
 	 /***** Get my courses from database *****/
 	 NumCrss =
 	 (unsigned) DB_QuerySELECT (&mysql_res,"can not get which courses"
 					       " you belong to",
-				    "SELECT CrsCod,Role,DegCod"
-				    " FROM my_courses_tmp");
+				    "SELECT crs_usr.CrsCod,crs_usr.Role,courses.DegCod"
+				    " FROM crs_usr,courses,degrees"
+				    " WHERE crs_usr.UsrCod=%ld"
+				    " AND crs_usr.CrsCod=courses.CrsCod"
+				    " AND courses.DegCod=degrees.DegCod"
+				    " ORDER BY degrees.ShortName,courses.ShortName",
+				    Gbl.Usrs.Me.UsrDat.UsrCod);
 	 for (NumCrs = 0;
 	      NumCrs < NumCrss;
 	      NumCrs++)
@@ -1769,11 +1798,17 @@ void Usr_GetMyCourses (void)
 	       Gbl.Usrs.Me.MyCrss.Crss[Gbl.Usrs.Me.MyCrss.Num].Role   = Rol_ConvertUnsignedStrToRole (row[1]);
 	       Gbl.Usrs.Me.MyCrss.Crss[Gbl.Usrs.Me.MyCrss.Num].DegCod = Str_ConvertStrCodToLongCod (row[2]);
 	       Gbl.Usrs.Me.MyCrss.Num++;
+
+	       /* Add course code to set of my courses */
+	       CodSet_AddCodToSet (&Gbl.Usrs.Me.MyCrss.Cods,CrsCod);
 	      }
 	   }
 
 	 /***** Free structure that stores the query result *****/
 	 DB_FreeMySQLResult (&mysql_res);
+
+	 /***** Sort set of my courses to search in it *****/
+	 CodSet_SortSet (&Gbl.Usrs.Me.MyCrss.Cods);
 	}
 
       /***** Set boolean that indicates that my courses are yet filled *****/
@@ -1849,25 +1884,11 @@ void Usr_FreeMyCourses (void)
       Gbl.Usrs.Me.MyCrss.Filled = false;
       Gbl.Usrs.Me.MyCrss.Num    = 0;
 
-      /***** Remove temporary table with my courses *****/
-      Usr_RemoveTemporaryTableMyCourses ();
+      /***** Free set of my courses *****/
+      CodSet_FreeSet (&Gbl.Usrs.Me.MyCrss.Cods);
      }
   }
 
-/*****************************************************************************/
-/************************ Free the list of my courses ************************/
-/*****************************************************************************/
-
-static void Usr_RemoveTemporaryTableMyCourses (void)
-  {
-   char Query[128];
-
-   /***** Remove temporary table with my courses *****/
-   sprintf (Query,"DROP TEMPORARY TABLE IF EXISTS my_courses_tmp");
-   if (mysql_query (&Gbl.mysql,Query))
-      DB_ExitOnMySQLError ("can not remove temporary table");
-  }
-
 /*****************************************************************************/
 /**************** Check if a user belongs to an institution ******************/
 /*****************************************************************************/
@@ -4079,28 +4100,42 @@ static void Usr_WriteUsrData (const char *BgColor,
 /******** Get the user's code of a random student from current course ********/
 /*****************************************************************************/
 // Returns user's code or -1 if no user found
+// The student is got by a random position in the index of students,
+// so the students of the course are not sorted randomly
 
 long Usr_GetRamdomStdFromCrs (long CrsCod)
   {
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
+   struct Rnd_Generator Generator;
+   unsigned long NumStds;
    long UsrCod = -1L;	// -1 means user not found
 
-   /***** Get a random student from current course from database *****/
-   if (DB_QuerySELECT (&mysql_res,"can not get a random student"
-				  " from the current course",
-		       "SELECT UsrCod FROM crs_usr"
-		       " WHERE CrsCod=%ld AND Role=%u"
-		       " ORDER BY RAND() LIMIT 1",
-		       CrsCod,(unsigned) Rol_STD))
-     {
-      /***** Get user code *****/
-      row = mysql_fetch_row (mysql_res);
-      UsrCod = Str_ConvertStrCodToLongCod (row[0]);
-     }
+   /***** Get number of students in course *****/
+   if ((NumStds = DB_QueryCOUNT ("can not get number of students"
+				 " in the current course",
+				 "SELECT COUNT(*) FROM crs_usr"
+				 " WHERE CrsCod=%ld AND Role=%u",
+				 CrsCod,(unsigned) Rol_STD)))
+     {
+      /***** Get a random student from current course from database *****/
+      Rnd_SetRandomSeed (&Generator);
+      if (DB_QuerySELECT (&mysql_res,"can not get a random student"
+				     " from the current course",
+			  "SELECT UsrCod FROM crs_usr"
+			  " WHERE CrsCod=%ld AND Role=%u"
+			  " ORDER BY UsrCod LIMIT %lu,1",
+			  CrsCod,(unsigned) Rol_STD,
+			  Rnd_GetNumLessThan (&Generator,NumStds)))
+	{
+	 /***** Get user code *****/
+	 row = mysql_fetch_row (mysql_res);
+	 UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	}
 
-   /***** Free structure that stores the query result *****/
-   DB_FreeMySQLResult (&mysql_res);
+      /***** Free structure that stores the query result *****/
+      DB_FreeMySQLResult (&mysql_res);
+     }
 
    return UsrCod;
   }
@@ -4114,19 +4149,33 @@ long Usr_GetRamdomStdFromGrp (long GrpCod)
   {
    MYSQL_RES *mysql_res;
    MYSQL_ROW row;
+   struct Rnd_Generator Generator;
+   unsigned long NumStds;
    long UsrCod = -1L;	// -1 means user not found
 
-   /***** Get a random student from a group from database *****/
-   if (DB_QuerySELECT (&mysql_res,"can not get a random student from a group",
-		       "SELECT crs_grp_usr.UsrCod FROM crs_grp_usr,crs_usr"
-		       " WHERE crs_grp_usr.GrpCod=%ld"
-		       " AND crs_grp_usr.UsrCod=crs_usr.UsrCod"
-		       " AND crs_usr.Role=%u ORDER BY RAND() LIMIT 1",
-		       GrpCod,(unsigned) Rol_STD))
-     {
-      /***** Get user code *****/
-      row = mysql_fetch_row (mysql_res);
-      UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+   /***** Get number of students in group *****/
+   if ((NumStds = DB_QueryCOUNT ("can not get number of students in a group",
+				 "SELECT COUNT(*) FROM crs_grp_usr,crs_usr"
+				 " WHERE crs_grp_usr.GrpCod=%ld"
+				 " AND crs_grp_usr.UsrCod=crs_usr.UsrCod"
+				 " AND crs_usr.Role=%u",
+				 GrpCod,(unsigned) Rol_STD)))
+     {
+      /***** Get a random student from a group from database *****/
+      Rnd_SetRandomSeed (&Generator);
+      if (DB_QuerySELECT (&mysql_res,"can not get a random student from a group",
+			  "SELECT crs_grp_usr.UsrCod FROM crs_grp_usr,crs_usr"
+			  " WHERE crs_grp_usr.GrpCod=%ld"
+			  " AND crs_grp_usr.UsrCod=crs_usr.UsrCod"
+			  " AND crs_usr.Role=%u"
+			  " ORDER BY crs_grp_usr.UsrCod LIMIT %lu,1",
+			  GrpCod,(unsigned) Rol_STD,
+			  Rnd_GetNumLessThan (&Generator,NumStds)))
+	{
+	 /***** Get user code *****/
+	 row = mysql_fetch_row (mysql_res);
+	 UsrCod = Str_ConvertStrCodToLongCod (row[0]);
+	}
 
       /***** Free structure that stores the query result *****/
       DB_FreeMySQLResult (&mysql_res);
@@ -4782,17 +4831,32 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
    row[11]: crs_usr.Role	(only if Scope == Hie_CRS)
    row[12]: crs_usr.Accepted	(only if Scope == Hie_CRS)
    */
-   const char *OrderQuery = "candidate_users.UsrCod=usr_data.UsrCod"
-			    " ORDER BY "
-			    "usr_data.Surname1,"
-			    "usr_data.Surname2,"
-			    "usr_data.FirstName,"
-			    "usr_data.UsrCod";
+   char *CandidateUsrsList;
+   char *OrderQuery = NULL;
+
+   /***** Trivial check: are there candidate users? *****/
+   if (!Usr_CandidateUsrs.Num)
+     {
+      Usr_GetListUsrsFromQuery (NULL,Role,Gbl.Scope.Current);
+      return;
+     }
+
+   /***** Build subquery to filter candidate users and order them *****/
+   CodSet_BuildListOfCods (&Usr_CandidateUsrs,&CandidateUsrsList);
+   DB_BuildQuery (&OrderQuery,
+		  "usr_data.UsrCod IN (%s)"
+		  " ORDER BY "
+		  "usr_data.Surname1,"
+		  "usr_data.Surname2,"
+		  "usr_data.FirstName,"
+		  "usr_data.UsrCod",
+		  CandidateUsrsList);
+   free (CandidateUsrsList);
 
    /***** Build query *****/
    // if Gbl.Scope.Current is course ==> 3 columns are retrieved: UsrCod, Sex, Accepted
    //                           else ==> 2 columns are retrieved: UsrCod, Sex
-   // Search is faster (aproximately x2) using a temporary table to store users found in the whole platform
+   // Search is faster (aproximately x2) getting first the users found in the whole platform
    switch (Role)
      {
       case Rol_UNK:	// Here Rol_UNK means any rol (role does not matter)
@@ -4802,7 +4866,7 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users from the whole platform */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,usr_data"
+			      " FROM usr_data"
 			      " WHERE %s",
 			      QueryFields,OrderQuery);
 	       break;
@@ -4810,8 +4874,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current country */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,centres,institutions,usr_data"
-			     " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,centres,institutions,usr_data"
+			     " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
 			      " AND degrees.CtrCod=centres.CtrCod"
@@ -4826,8 +4890,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current institution */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,centres,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,centres,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
 			      " AND degrees.CtrCod=centres.CtrCod"
@@ -4841,8 +4905,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current centre */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
 			      " AND degrees.CtrCod=%ld"
@@ -4855,8 +4919,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current degree */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=%ld"
 			      " AND %s",
@@ -4868,8 +4932,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current course */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s,crs_usr.Role,crs_usr.Accepted"
-			      " FROM candidate_users,crs_usr,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      " AND crs_usr.CrsCod=%ld"
 			      " AND %s",
 			      QueryFields,
@@ -4885,8 +4949,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	 /* Search users with no courses */
 	 DB_BuildQuery (&Query,
 			"SELECT %s"
-			" FROM candidate_users,usr_data"
-			" WHERE candidate_users.UsrCod NOT IN (SELECT UsrCod FROM crs_usr)"
+			" FROM usr_data"
+			" WHERE usr_data.UsrCod NOT IN (SELECT UsrCod FROM crs_usr)"
 			" AND %s",
 			QueryFields,
 			OrderQuery);
@@ -4920,8 +4984,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the whole platform */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND %s",
 			      QueryFields,
@@ -4932,8 +4996,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current country */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,centres,institutions,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,centres,institutions,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
@@ -4950,8 +5014,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current institution */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,centres,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,centres,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
@@ -4967,8 +5031,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current centre */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,degrees,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,degrees,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=degrees.DegCod"
@@ -4983,8 +5047,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current degree */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s"
-			      " FROM candidate_users,crs_usr,courses,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,courses,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND crs_usr.CrsCod=courses.CrsCod"
 			      " AND courses.DegCod=%ld"
@@ -4998,8 +5062,8 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 	       /* Search users in courses from the current course */
 	       DB_BuildQuery (&Query,
 			      "SELECT %s,crs_usr.Role,crs_usr.Accepted"
-			      " FROM candidate_users,crs_usr,usr_data"
-			      " WHERE candidate_users.UsrCod=crs_usr.UsrCod"
+			      " FROM crs_usr,usr_data"
+			      " WHERE crs_usr.UsrCod=usr_data.UsrCod"
 			      "%s"
 			      " AND crs_usr.CrsCod=%ld"
 			      " AND %s",
@@ -5023,41 +5087,36 @@ void Usr_SearchListUsrs (Rol_Role_t Role)
 
    /***** Get list of users from database given a query *****/
    Usr_GetListUsrsFromQuery (Query,Role,Gbl.Scope.Current);
+
+   /***** Free subquery *****/
+   free (OrderQuery);
   }
 
 /*****************************************************************************/
-/*************** Create temporary table with candidate users *****************/
+/********************** Get set with candidate users *************************/
 /*****************************************************************************/
 
-void Usr_CreateTmpTableAndSearchCandidateUsrs (const char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1])
+void Usr_GetCandidateUsrs (const char SearchQuery[Sch_MAX_BYTES_SEARCH_QUERY + 1])
   {
-   char Query[256 + Sch_MAX_BYTES_SEARCH_QUERY];
-
-   /***** Create temporary table with candidate users *****/
+   /***** Get set with candidate users *****/
    /*
-      - Search is faster (aproximately x2) using temporary tables.
+      - Search is faster (aproximately x2) getting first the candidate users.
       - Searching for names is made in the whole platform
-        and stored in this table.
+        and stored in memory, without a temporary table in database.
    */
-   sprintf (Query,"CREATE TEMPORARY TABLE candidate_users"
-		  " (UsrCod INT NOT NULL,UNIQUE INDEX(UsrCod)) ENGINE=MEMORY"
-		  " SELECT UsrCod FROM usr_data WHERE %s",
-	    SearchQuery);
-   if (mysql_query (&Gbl.mysql,Query))
-      DB_ExitOnMySQLError ("can not create temporary table");
+   CodSet_FreeSet (&Usr_CandidateUsrs);
+   CodSet_GetSetFromQuery (&Usr_CandidateUsrs,"can not get candidate users",
+			   "SELECT UsrCod FROM usr_data WHERE %s",
+			   SearchQuery);
   }
 
 /*****************************************************************************/
-/***************** Drop temporary table with candidate users *****************/
+/********************** Free set with candidate users ************************/
 /*****************************************************************************/
 
-void Usr_DropTmpTableWithCandidateUsrs (void)
+void Usr_FreeCandidateUsrs (void)
   {
-   char Query[128];
-
-   sprintf (Query,"DROP TEMPORARY TABLE IF EXISTS candidate_users");
-   if (mysql_query (&Gbl.mysql,Query))
-      DB_ExitOnMySQLError ("can not remove temporary table");
+   CodSet_FreeSet (&Usr_CandidateUsrs);
   }
 
 /*****************************************************************************/
@@ -5792,18 +5851,18 @@ static void Usr_BuildParamName (char **ParamName,
 
 bool Usr_GetListMsgRecipientsWrittenExplicitelyBySender (bool WriteErrorMsgs)
   {
-   extern const char *Par_SEPARATOR_PARAM_MULTIPLE;
    extern const char *Txt_There_is_no_user_with_nickname_X;
    extern const char *Txt_There_is_no_user_with_email_X;
    extern const char *Txt_There_are_more_than_one_user_with_the_ID_X_Please_type_a_nick_or_email;
    extern const char *Txt_There_is_no_user_with_ID_nick_or_email_X;
    extern const char *Txt_The_ID_nickname_or_email_X_is_not_valid;
    size_t LengthSelectedUsrsCods;
-   size_t LengthUsrCod;
    const char *Ptr;
    char UsrIDNickOrEmail[Cns_MAX_BYTES_EMAIL_ADDRESS + 1];
    struct UsrData UsrDat;
    struct ListUsrCods ListUsrCods;
+   struct Usr_ListNicks ListNicks;
+   const char *EncryptedUsrCod;
    bool Error = false;
 
    /***** Get list of selected encrypted users's codes if not already got.
@@ -5821,6 +5880,10 @@ bool Usr_GetListMsgRecipientsWrittenExplicitelyBySender (bool WriteErrorMsgs)
    /***** Add encrypted users' IDs to the list with all selected users *****/
    if (Gbl.Usrs.ListOtherRecipients[0])
      {
+      /* Get the users of all the nicknames at once */
+      Usr_GetEncryptedUsrCodsFromNicknames (Gbl.Usrs.ListOtherRecipients,
+					    &ListNicks);
+
       /* Initialize structure with user's data */
       Usr_UsrDataConstructor (&UsrDat);
 
@@ -5840,12 +5903,11 @@ bool Usr_GetListMsgRecipientsWrittenExplicitelyBySender (bool WriteErrorMsgs)
 
 	    if (Nck_CheckIfNickWithArrobaIsValid (UsrIDNickOrEmail))	// 1: It's a nickname
 	      {
-	       if ((UsrDat.UsrCod = Nck_GetUsrCodFromNickname (UsrIDNickOrEmail)) > 0)
-		 {
-		  ListUsrCods.NumUsrs = 1;
-		  Usr_AllocateListUsrCods (&ListUsrCods);
-		  ListUsrCods.Lst[0] = UsrDat.UsrCod;
-		 }
+	       if ((EncryptedUsrCod = Usr_GetEncryptedUsrCodFromListNicks (&ListNicks,
+									  UsrIDNickOrEmail)))
+		  /* Encrypted user's code already got with the nickname */
+		  Usr_AddEncryptedUsrCodToListOfSelected (EncryptedUsrCod,
+							  &LengthSelectedUsrsCods);
 	       else
 		 {
 		  if (WriteErrorMsgs)
@@ -5917,40 +5979,9 @@ bool Usr_GetListMsgRecipientsWrittenExplicitelyBySender (bool WriteErrorMsgs)
                /* Get user's data */
 	       Usr_GetUsrDataFromUsrCod (&UsrDat,Usr_DONT_GET_PREFS);	// Really only EncryptedUsrCod is needed
 
-               /* Find if encrypted user's code is already in list */
-               if (!Usr_FindEncryptedUsrCodsInListOfSelectedEncryptedUsrCods (UsrDat.EncryptedUsrCod,&Gbl.Usrs.Selected))        // If not in list ==> add it
-                 {
-                  LengthUsrCod = strlen (UsrDat.EncryptedUsrCod);
-
-                  /* Add encrypted user's code to list of users */
-                  if (LengthSelectedUsrsCods == 0)	// First user in list
-                    {
-                     if (LengthUsrCod < Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS)
-                       {
-                        /* Add user */
-                        Str_Copy (Gbl.Usrs.Selected.List[Rol_UNK],
-                                  UsrDat.EncryptedUsrCod,
-                                  Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS);
-                        LengthSelectedUsrsCods = LengthUsrCod;
-                       }
-                    }
-                  else					// Not first user in list
-                    {
-                     if (LengthSelectedUsrsCods + (1 + LengthUsrCod) <
-                	 Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS)
-                       {
-                        /* Add separator */
-                        Gbl.Usrs.Selected.List[Rol_UNK][LengthSelectedUsrsCods] = Par_SEPARATOR_PARAM_MULTIPLE[0];
-                        LengthSelectedUsrsCods++;
-
-                        /* Add user */
-                        Str_Copy (Gbl.Usrs.Selected.List[Rol_UNK] + LengthSelectedUsrsCods,
-                                  UsrDat.EncryptedUsrCod,
-                                  Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS);
-                        LengthSelectedUsrsCods += LengthUsrCod;
-                       }
-                    }
-                 }
+               /* Add encrypted user's code to list of users if not already in list */
+               Usr_AddEncryptedUsrCodToListOfSelected (UsrDat.EncryptedUsrCod,
+						       &LengthSelectedUsrsCods);
               }
 
 	    /***** Free list of users' codes *****/
@@ -5960,10 +5991,167 @@ bool Usr_GetListMsgRecipientsWrittenExplicitelyBySender (bool WriteErrorMsgs)
 
       /* Free memory used for user's data */
       Usr_UsrDataDestructor (&UsrDat);
+
+      /* Free list of nicknames */
+      if (ListNicks.Lst)
+	 free (ListNicks.Lst);
      }
    return Error;
   }
 
+/*****************************************************************************/
+/*** Get the encrypted codes of the users of all the nicknames written as ****/
+/*** recipients of a message, with a single query                         ****/
+/*****************************************************************************/
+
+static void Usr_GetEncryptedUsrCodsFromNicknames (const char *ListOtherRecipients,
+						  struct Usr_ListNicks *ListNicks)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   const char *Ptr;
+   char UsrIDNickOrEmail[Cns_MAX_BYTES_EMAIL_ADDRESS + 1];
+   char *SubQuery;
+   size_t MaxLength;
+   bool FirstNick = true;
+   unsigned NumNick;
+
+   ListNicks->Num = 0;
+   ListNicks->Lst = NULL;
+
+   /***** Allocate space for subquery with nicknames in quotes *****/
+   MaxLength = 3 * strlen (ListOtherRecipients);
+   if ((SubQuery = (char *) malloc (MaxLength + 1)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   SubQuery[0] = '\0';
+
+   /***** Build subquery with the valid nicknames without arrobas.
+	  Valid nicknames have only letters, digits and '_' *****/
+   Ptr = ListOtherRecipients;
+   while (*Ptr)
+     {
+      Str_GetNextStringUntilComma (&Ptr,UsrIDNickOrEmail,Cns_MAX_BYTES_EMAIL_ADDRESS);
+      if (Nck_CheckIfNickWithArrobaIsValid (UsrIDNickOrEmail))
+	{
+	 Str_RemoveLeadingArrobas (UsrIDNickOrEmail);
+	 if (!FirstNick)
+	    Str_Concat (SubQuery,",",
+			MaxLength);
+	 Str_Concat (SubQuery,"'",
+		     MaxLength);
+	 Str_Concat (SubQuery,UsrIDNickOrEmail,
+		     MaxLength);
+	 Str_Concat (SubQuery,"'",
+		     MaxLength);
+	 FirstNick = false;
+	}
+     }
+
+   /***** Get users' encrypted codes from database *****/
+   if (!FirstNick)	// Any nickname in list
+     {
+      if ((ListNicks->Num = (unsigned) DB_QuerySELECT (&mysql_res,"can not get users' codes",
+						       "SELECT usr_nicknames.Nickname,"	// row[0]
+							      "usr_data.EncryptedUsrCod"	// row[1]
+						       " FROM usr_nicknames,usr_data"
+						       " WHERE usr_nicknames.Nickname IN (%s)"
+						       " AND usr_nicknames.UsrCod=usr_data.UsrCod",
+						       SubQuery)))
+	{
+	 if ((ListNicks->Lst = calloc ((size_t) ListNicks->Num,
+				       sizeof (*ListNicks->Lst))) == NULL)
+	    Lay_NotEnoughMemoryExit ();
+	 for (NumNick = 0;
+	      NumNick < ListNicks->Num;
+	      NumNick++)
+	   {
+	    row = mysql_fetch_row (mysql_res);
+	    Str_Copy (ListNicks->Lst[NumNick].Nickname,row[0],
+		      Nck_MAX_BYTES_NICKNAME_WITHOUT_ARROBA);
+	    Str_Copy (ListNicks->Lst[NumNick].EncryptedUsrCod,row[1],
+		      Cry_BYTES_ENCRYPTED_STR_SHA256_BASE64);
+	   }
+	}
+
+      /***** Free structure that stores the query result *****/
+      DB_FreeMySQLResult (&mysql_res);
+     }
+
+   /***** Free subquery *****/
+   free (SubQuery);
+  }
+
+/*****************************************************************************/
+/********* Get the encrypted user's code of a nickname from the list *********/
+/*****************************************************************************/
+// Return NULL if nickname is not in list
+
+static const char *Usr_GetEncryptedUsrCodFromListNicks (const struct Usr_ListNicks *ListNicks,
+							const char *NicknameWithArroba)
+  {
+   unsigned NumNick;
+
+   /***** Skip leading arrobas *****/
+   while (*NicknameWithArroba == '@')
+      NicknameWithArroba++;
+
+   /***** Nicknames are compared case insensitive, as in database *****/
+   for (NumNick = 0;
+	NumNick < ListNicks->Num;
+	NumNick++)
+      if (!strcasecmp (ListNicks->Lst[NumNick].Nickname,NicknameWithArroba))
+	 return ListNicks->Lst[NumNick].EncryptedUsrCod;
+
+   return NULL;
+  }
+
+/*****************************************************************************/
+/****** Add an encrypted user's code to the list of selected users if ********/
+/****** not already in list                                            ********/
+/*****************************************************************************/
+
+static void Usr_AddEncryptedUsrCodToListOfSelected (const char *EncryptedUsrCod,
+						    size_t *LengthSelectedUsrsCods)
+  {
+   extern const char *Par_SEPARATOR_PARAM_MULTIPLE;
+   size_t LengthUsrCod;
+
+   /***** Find if encrypted user's code is already in list *****/
+   if (!Usr_FindEncryptedUsrCodsInListOfSelectedEncryptedUsrCods (EncryptedUsrCod,&Gbl.Usrs.Selected))        // If not in list ==> add it
+     {
+      LengthUsrCod = strlen (EncryptedUsrCod);
+
+      /***** Add encrypted user's code to list of users *****/
+      if (*LengthSelectedUsrsCods == 0)	// First user in list
+	{
+	 if (LengthUsrCod < Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS)
+	   {
+	    /* Add user */
+	    Str_Copy (Gbl.Usrs.Selected.List[Rol_UNK],
+		      EncryptedUsrCod,
+		      Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS);
+	    *LengthSelectedUsrsCods = LengthUsrCod;
+	   }
+	}
+      else					// Not first user in list
+	{
+	 if (*LengthSelectedUsrsCods + (1 + LengthUsrCod) <
+	     Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS)
+	   {
+	    /* Add separator */
+	    Gbl.Usrs.Selected.List[Rol_UNK][*LengthSelectedUsrsCods] = Par_SEPARATOR_PARAM_MULTIPLE[0];
+	    (*LengthSelectedUsrsCods)++;
+
+	    /* Add user */
+	    Str_Copy (Gbl.Usrs.Selected.List[Rol_UNK] + *LengthSelectedUsrsCods,
+		      EncryptedUsrCod,
+		      Usr_MAX_BYTES_LIST_ENCRYPTED_USR_CODS);
+	    *LengthSelectedUsrsCods += LengthUsrCod;
+	   }
+	}
+     }
+  }
+
 /*****************************************************************************/
 /************** Find if encrypted user's code is yet in list *****************/
 /*****************************************************************************/
@@ -7331,9 +7519,9 @@ unsigned Usr_ListUsrsFound (Rol_Role_t Role,
    /***** Initialize field names *****/
    Usr_SetUsrDatMainFieldNames ();
 
-   /***** Create temporary table with candidate users *****/
-   // Search is faster (aproximately x2) using temporary tables
-   Usr_CreateTmpTableAndSearchCandidateUsrs (SearchQuery);
+   /***** Get set with candidate users *****/
+   // Search is faster (aproximately x2) getting first the candidate users
+   Usr_GetCandidateUsrs (SearchQuery);
 
    /***** Search for users *****/
    Usr_SearchListUsrs (Role);
@@ -7413,8 +7601,8 @@ unsigned Usr_ListUsrsFound (Rol_Role_t Role,
    /***** Free memory for teachers list *****/
    Usr_FreeUsrsList (Role);
 
-   /***** Drop temporary table with candidate users *****/
-   Usr_DropTmpTableWithCandidateUsrs ();
+   /***** Free set with candidate users *****/
+   Usr_FreeCandidateUsrs ();
 
    return NumUsrs;
   }
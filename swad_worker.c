@@ -0,0 +1,153 @@
+// swad_worker.c: worker processes detached from web server
+
+/*
+    SWAD (Shared Workspace At a Distance in Spanish),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Caas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <fcntl.h>		// For open
+#include <linux/limits.h>	// For PATH_MAX
+#include <stdio.h>		// For fflush, fopen, snprintf
+#include <sys/types.h>		// For pid_t
+#include <unistd.h>		// For fork, setsid, dup2, _exit
+
+#include "swad_database.h"
+#include "swad_file.h"
+#include "swad_global.h"
+#include "swad_worker.h"
+
+/*****************************************************************************/
+/************** External global variables from others modules ****************/
+/*****************************************************************************/
+
+extern struct Globals Gbl;
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static void (*Wrk_FunctionOnError) (void) = NULL;	// Called if the task exits on error
+
+/*****************************************************************************/
+/********* Run a slow task in a process detached from the web server *********/
+/*****************************************************************************/
+// Used by refresh requests to make slow maintenance tasks
+// without making the user wait for them.
+// Return true if the worker process has been created
+
+bool Wrk_RunDetachedTask (void (*Task) (void))
+  {
+   /***** Flush buffered output before forking,
+          so the worker process does not write it again *****/
+   fflush (NULL);
+
+   /***** Fork a worker process *****/
+   switch (fork ())
+     {
+      case -1:	// Error
+	 return false;
+      case 0:	// Worker process
+	 Wrk_BeginDetachedProcess ();
+	 Task ();
+	 Wrk_EndDetachedProcessAndExit ();
+	 return false;	// Not reached
+      default:	// This process
+	 return true;
+     }
+  }
+
+/*****************************************************************************/
+/********* Detach a worker process just forked from the web server ***********/
+/*****************************************************************************/
+
+void Wrk_BeginDetachedProcess (void)
+  {
+   int DevNull;
+
+   /***** Detach from web server,
+          which does not wait for this process to end *****/
+   setsid ();
+   if ((DevNull = open ("/dev/null",O_RDWR)) >= 0)
+     {
+      dup2 (DevNull,STDIN_FILENO);
+      dup2 (DevNull,STDOUT_FILENO);
+      dup2 (DevNull,STDERR_FILENO);
+      if (DevNull > STDERR_FILENO)
+	 close (DevNull);
+     }
+
+   /***** Use my own file for HTML output (only written on error),
+          since the file of the parent process is being sent *****/
+   snprintf (Gbl.HTMLOutput.FileName,sizeof (Gbl.HTMLOutput.FileName),
+	     "%s/%s_wrk.html",
+	     Cfg_PATH_OUT_PRIVATE,Gbl.UniqueNameEncrypted);
+   if ((Gbl.F.Out = fopen (Gbl.HTMLOutput.FileName,"w+t")) == NULL)
+      _exit (1);
+   Gbl.Action.IsAJAXAutoRefresh = true;	// On error, do not log this process as a new click
+
+   /***** Open my own database connection,
+          since the connection of the parent process must not be shared *****/
+   Gbl.DB.DatabaseIsOpen = false;
+   Gbl.DB.LockedTables = false;
+   Gbl.DB.InTransaction = false;
+   DB_OpenDBConnection ();
+  }
+
+/*****************************************************************************/
+/************** Close files and database connection, and exit ****************/
+/*****************************************************************************/
+
+void Wrk_EndDetachedProcessAndExit (void)
+  {
+   Wrk_FunctionOnError = NULL;
+   Fil_CloseAndRemoveFileForHTMLOutput ();
+   DB_CloseDBConnection ();
+   _exit (0);
+  }
+
+/*****************************************************************************/
+/********* Set a function to be called if a worker exits on error ************/
+/*****************************************************************************/
+// Used by a worker to leave its job in a right state
+// (for example, not running) when it exits due to an error
+
+void Wrk_SetFunctionOnError (void (*FunctionOnError) (void))
+  {
+   Wrk_FunctionOnError = FunctionOnError;
+  }
+
+/*****************************************************************************/
+/*********** Call the function set to be called on error, if any *************/
+/*****************************************************************************/
+// Called by Lay_ShowErrorAndExit before closing the database connection.
+// The function is called only once,
+// even if it exits on error again
+
+void Wrk_RunFunctionOnError (void)
+  {
+   void (*FunctionOnError) (void) = Wrk_FunctionOnError;
+
+   Wrk_FunctionOnError = NULL;
+   if (FunctionOnError && Gbl.DB.DatabaseIsOpen)
+      FunctionOnError ();
+  }
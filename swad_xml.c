@@ -27,7 +27,8 @@
 
 #include <ctype.h>		// For isspace()
 #include <stddef.h>		// For NULL
-#include <stdlib.h>		// For free ()
+#include <stdio.h>		// For getc, snprintf
+#include <stdlib.h>		// For malloc, free
 #include <string.h>		// For strlen (), etc.
 
 #include "swad_changelog.h"
@@ -49,6 +50,22 @@ extern struct Globals Gbl;
 /******************************* Private types *******************************/
 /*****************************************************************************/
 
+// The parser reads the file character by character,
+// so memory used does not depend on the size of the file
+struct XML_Parser
+  {
+   FILE *FileXML;
+   int Ch;			// Current character read from file
+   unsigned Level;		// Number of elements open
+   char TagNames[XML_MAX_LEVELS][XML_MAX_BYTES_NAME + 1];	// Names of elements open
+   struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES];	// Attributes of last start tag
+   unsigned NumAttributes;
+   char *Content;		// Content of current element
+   bool ContentExpected;	// Only text after a start tag is content
+   const struct XMLHandlers *Handlers;
+   void *Args;
+  };
+
 /*****************************************************************************/
 /***************************** Private variables *****************************/
 /*****************************************************************************/
@@ -57,9 +74,23 @@ extern struct Globals Gbl;
 /***************************** Private prototypes ****************************/
 /*****************************************************************************/
 
-static void XML_GetElement (struct XMLElement *ParentElem);
-static void XML_GetAttributes (struct XMLElement *Elem);
-static void XML_SkipSpaces (void);
+static void XML_GetStartTag (struct XML_Parser *Parser);
+static bool XML_GetAttributes (struct XML_Parser *Parser);
+static void XML_GetEndTag (struct XML_Parser *Parser);
+static void XML_GetContent (struct XML_Parser *Parser);
+static void XML_GetName (struct XML_Parser *Parser,
+                         char Name[XML_MAX_BYTES_NAME + 1],
+                         const char *Delimiters);
+static void XML_NextChar (struct XML_Parser *Parser);
+static void XML_SkipSpaces (struct XML_Parser *Parser);
+
+static void XML_PrintStartElement (void *Args,unsigned Level,const char *TagName,
+                                   const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                                   unsigned NumAttributes);
+static void XML_PrintContent (void *Args,unsigned Level,const char *TagName,
+                              const char *Content);
+static void XML_PrintEndElement (void *Args,unsigned Level,const char *TagName);
+static void XML_PrintIndent (unsigned Level);
 
 /*****************************************************************************/
 /****** Write the start of an XML file with author and date of creation ******/
@@ -94,444 +125,393 @@ void XML_WriteEndFile (FILE *FileTgt,const char *Type)
   }
 
 /*****************************************************************************/
-/****************** Get the content of XML root element **********************/
+/************ Parse an XML file calling handlers for each event **************/
 /*****************************************************************************/
+// The whole file is checked, so syntax errors abort the execution
 
-void XML_GetTree (const char *XMLBuffer,struct XMLElement **XMLRootElem)
+void XML_ParseFile (FILE *FileXML,const struct XMLHandlers *Handlers,void *Args)
   {
-   /***** Allocate space for the root element *****/
-   if ((*XMLRootElem = calloc (1,sizeof (struct XMLElement))) == NULL)
+   struct XML_Parser Parser;
+
+   /***** Initialize parser *****/
+   Parser.FileXML         = FileXML;
+   Parser.Level           = 0;
+   Parser.NumAttributes   = 0;
+   Parser.ContentExpected = false;
+   Parser.Handlers        = Handlers;
+   Parser.Args            = Args;
+   if ((Parser.Content = (char *) malloc (XML_MAX_BYTES_CONTENT + 1)) == NULL)
       Lay_NotEnoughMemoryExit ();
 
-   Gbl.XMLPtr = XMLBuffer;
-   XML_GetElement (*XMLRootElem);
+   /***** Read the file from the first character *****/
+   XML_NextChar (&Parser);
+   for (;;)
+     {
+      /* Skip spaces */
+      XML_SkipSpaces (&Parser);
+      if (Parser.Ch == EOF)
+	 break;
+
+      if (Parser.Ch == '<')
+	{
+	 XML_NextChar (&Parser);
+	 if (Parser.Ch == '/')			// End tag
+	    XML_GetEndTag (&Parser);
+	 else if (Parser.Ch == '!' ||
+		  Parser.Ch == '?')		// Skip <!...> and <?...>
+	   {
+	    while (Parser.Ch != EOF &&
+		   Parser.Ch != '>')
+	       XML_NextChar (&Parser);
+	    XML_NextChar (&Parser);
+	   }
+	 else					// Start tag
+	    XML_GetStartTag (&Parser);
+	}
+      else
+	 XML_GetContent (&Parser);
+     }
+
+   /***** All elements must be closed *****/
+   if (Parser.Level)
+      Lay_ShowErrorAndExit ("XML syntax error. Unexpected end of file.");
+
+   /***** Free memory used for content *****/
+   free (Parser.Content);
   }
 
 /*****************************************************************************/
-/******************* Get the content of an XML element ***********************/
+/**************************** Get a start tag ********************************/
 /*****************************************************************************/
 
-static void XML_GetElement (struct XMLElement *ParentElem)
+static void XML_GetStartTag (struct XML_Parser *Parser)
   {
-   struct XMLElement *ChildElem;
-   const char *StartContent;
-   const char *Ptr;
-   size_t ContentLength;
-   size_t EndTagNameLength;
-   size_t TagLength;
-   char ErrorTxt[128];
+   const char *TagName;
+   bool UnaryTag;
 
    /*
-   <parent...>  element content  </parent>
-              ^
-             Gbl.XMLPtr
+   <parent><child attribute1="value" attribute2="value">...</child>...</parent>
+            ^
+           Parser->Ch
    */
-   /* Skip spaces */
-   XML_SkipSpaces ();
+   if (Parser->Level == XML_MAX_LEVELS)
+      Lay_ShowErrorAndExit ("XML syntax error. Too many nested elements.");
 
-   StartContent = Gbl.XMLPtr;
-   ContentLength = strcspn (StartContent,"<");
-   Gbl.XMLPtr += ContentLength;
+   /***** Get tag name *****/
+   TagName = Parser->TagNames[Parser->Level];
+   XML_GetName (Parser,Parser->TagNames[Parser->Level],">/ \t\r\n");
+   Parser->Level++;
 
-   while (*Gbl.XMLPtr == '<')	// For each child until parent end tag
-     {
-      Gbl.XMLPtr++;
-      if (*Gbl.XMLPtr == '/')	// Parent end tag
-        {
-         /*
-         <parent>  element content  </parent>
-                                     ^
-                                    Gbl.XMLPtr
-         */
-         /***** Check tag name *****/
-         Gbl.XMLPtr++;
-         /*
-         <parent>  element content  </parent>
-                                      ^
-                                     Gbl.XMLPtr
-         */
-         EndTagNameLength = strcspn (Gbl.XMLPtr,">");
-         if (ParentElem->TagNameLength != EndTagNameLength)
-           {
-            snprintf (ErrorTxt,sizeof (ErrorTxt),
-	              "XML syntax error. Expect end tag &lt;/%s&gt;.",
-		      ParentElem->TagName);
-            Lay_ShowErrorAndExit (ErrorTxt);
-           }
-         if (strncmp (ParentElem->TagName,Gbl.XMLPtr,EndTagNameLength))	// XML tags are case sensitive
-           {
-            snprintf (ErrorTxt,sizeof (ErrorTxt),
-	              "XML syntax error. Expect end tag &lt;/%s&gt;.",
-		      ParentElem->TagName);
-            Lay_ShowErrorAndExit (ErrorTxt);
-           }
-
-         // End of parent element found!
-         Gbl.XMLPtr += EndTagNameLength;
-         Gbl.XMLPtr++;
-         /*
-         <parent>  element content  </parent>
-                                             ^
-                                            Gbl.XMLPtr
-         */
-         /* Remove trailing spaces in content */
-         for (Ptr = StartContent + ContentLength - 1;
-              ContentLength;
-              ContentLength--, Ptr--)
-            if (!isspace ((int) *Ptr))
-               break;
-
-         /* Copy content */
-         if (ContentLength)
-           {
-            if ((ParentElem->Content = (char *) malloc (ContentLength + 1)) == NULL)
-               Lay_NotEnoughMemoryExit ();
-            strncpy (ParentElem->Content,StartContent,ContentLength);
-            ParentElem->Content[ContentLength] = '\0';
-            ParentElem->ContentLength = ContentLength;
-           }
-
-         return;
-        }
-      else if (*Gbl.XMLPtr == '!' ||
-               *Gbl.XMLPtr == '?')	// Skip <!...> and <?...>
-        {
-         TagLength = strcspn (Gbl.XMLPtr,">");
-         Gbl.XMLPtr += TagLength;
-         if (*Gbl.XMLPtr == '>')
-           Gbl.XMLPtr++;
-        }
-      else		// New start tag
-        {
-         /*
-         <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                  ^
-                 Gbl.XMLPtr
-         */
-         /***** Allocate space for the child element *****/
-         if ((ChildElem = calloc (1,sizeof (struct XMLElement))) == NULL)
-            Lay_NotEnoughMemoryExit ();
-
-         /***** Adjust XML elements pointers *****/
-         if (ParentElem->FirstChild)	// This child is a brother of a former child
-            ParentElem->LastChild->NextBrother = ChildElem;
-         else				// This child is the first child
-            ParentElem->FirstChild = ChildElem;
-         ParentElem->LastChild = ChildElem;
-
-         /***** Get child tag name *****/
-         ChildElem->TagNameLength = strcspn (Gbl.XMLPtr,">/ \t");
-         if ((ChildElem->TagName = (char *) malloc (ChildElem->TagNameLength + 1)) == NULL)
-            Lay_NotEnoughMemoryExit ();
-         strncpy (ChildElem->TagName,Gbl.XMLPtr,ChildElem->TagNameLength);
-         ChildElem->TagName[ChildElem->TagNameLength] = '\0';
-         Gbl.XMLPtr += ChildElem->TagNameLength;
-
-         /*
-         <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                       ^
-                      Gbl.XMLPtr
-         */
-         /* Check if end of start tag found */
-         if (*Gbl.XMLPtr == '>')	// End of start tag
-           {
-            Gbl.XMLPtr++;
-            /*
-            <parent><child>...</child>...</parent>
-                           ^
-                          Gbl.XMLPtr
-            */
-            XML_GetElement (ChildElem);
-           }
-         else if (*Gbl.XMLPtr == '/')	// Unary tag?
-           {
-            Gbl.XMLPtr++;
-            /*
-            <parent><child/>...</parent>
-                           ^
-                          Gbl.XMLPtr
-            */
-            if (*Gbl.XMLPtr != '>')	// Here it should be the end of start tag
-               Lay_ShowErrorAndExit ("XML syntax error. Expect &gt; ending unary tag.");
-            Gbl.XMLPtr++;
-            /*
-            <parent><child/>...</parent>
-                            ^
-                           Gbl.XMLPtr
-            */
-           }
-         else	// Start of an attribute
-           {
-            /*
-            <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                          ^
-                         Gbl.XMLPtr
-            */
-            XML_GetAttributes (ChildElem);
-            /*
-            <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                                                                 ^
-                                                                Gbl.XMLPtr
-            */
-            XML_GetElement (ChildElem);
-           }
-        }
+   /***** Get attributes until the end of start tag *****/
+   UnaryTag = XML_GetAttributes (Parser);
+   /*
+   <parent><child attribute1="value" attribute2="value">...</child>...</parent>
+                                                        ^
+                                                       Parser->Ch
+   */
+   if (Parser->Handlers->StartElement)
+      Parser->Handlers->StartElement (Parser->Args,Parser->Level,TagName,
+                                      Parser->Attributes,Parser->NumAttributes);
 
-      /* Skip spaces after the ">" character of the tag */
-      XML_SkipSpaces ();
+   if (UnaryTag)	// <child/>
+     {
+      if (Parser->Handlers->EndElement)
+	 Parser->Handlers->EndElement (Parser->Args,Parser->Level,TagName);
+      Parser->Level--;
+      Parser->ContentExpected = false;
      }
+   else
+      Parser->ContentExpected = true;
   }
 
 /*****************************************************************************/
 /******************* Get the attributes of a start tag ***********************/
 /*****************************************************************************/
+// Return true if the tag is unary
 
-static void XML_GetAttributes (struct XMLElement *Elem)
+static bool XML_GetAttributes (struct XML_Parser *Parser)
   {
+   struct XMLAttribute DiscardedAttribute;
    struct XMLAttribute *Attribute;
-   bool EndOfStartTag = false;
+   int Quote;
+   size_t Length;
    char ErrorTxt[256];
 
-   /*
-   <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                 ^
-                 |
-                Gbl.XMLPtr
-   */
-   do
+   Parser->NumAttributes = 0;
+   for (;;)
      {
       /* Skip spaces */
-      XML_SkipSpaces ();
+      XML_SkipSpaces (Parser);
 
-      if (*Gbl.XMLPtr == '/')	// End of unary tag?
-        {
-         Gbl.XMLPtr++;
-         if (*Gbl.XMLPtr == '>')
-           {
-            Gbl.XMLPtr++;
-            EndOfStartTag = true;
-           }
-         else
-            Lay_ShowErrorAndExit ("XML syntax error. Expect &gt; ending unary tag with attributes.");
-        }
-      else if (*Gbl.XMLPtr == '>')	// End of start tag?
-        {
-         Gbl.XMLPtr++;
-         EndOfStartTag = true;
-        }
-      else if (*Gbl.XMLPtr == '\0')
-         Lay_ShowErrorAndExit ("XML syntax error. Unexpected end of file.");
-      else
+      switch (Parser->Ch)
         {
-         /* Start of attribute name:
-         <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                        ^
-                        |
-                       Gbl.XMLPtr
-         */
-         /***** Allocate space for the attribute *****/
-         if ((Attribute = calloc (1,sizeof (struct XMLAttribute))) == NULL)
-            Lay_NotEnoughMemoryExit ();
-
-         /***** Adjust XML element and attribute pointers *****/
-         if (Elem->FirstAttribute)	// This attribute is a brother of a former attribute in current element
-            Elem->LastAttribute->Next = Attribute;
-         else				// This child is the first child
-            Elem->FirstAttribute = Attribute;
-         Elem->LastAttribute = Attribute;
-
-         /***** Get attribute name *****/
-         Attribute->AttributeNameLength = strcspn (Gbl.XMLPtr,"=");
-         if ((Attribute->AttributeName = (char *) malloc (Attribute->AttributeNameLength + 1)) == NULL)
-            Lay_NotEnoughMemoryExit ();
-         strncpy (Attribute->AttributeName,Gbl.XMLPtr,Attribute->AttributeNameLength);
-         Attribute->AttributeName[Attribute->AttributeNameLength] = '\0';
-         Gbl.XMLPtr += Attribute->AttributeNameLength;
-         /* End of attribute name:
-         <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                                  ^
-                                  |
-                                 Gbl.XMLPtr
-         */
-         /***** Get attribute content *****/
-         Gbl.XMLPtr++;
-         if (*Gbl.XMLPtr == '\"')
-           {
-            Gbl.XMLPtr++;
-            Attribute->ContentLength = strcspn (Gbl.XMLPtr,"\"");
-           }
-         else if (*Gbl.XMLPtr == '\'')
-           {
-            Gbl.XMLPtr++;
-            Attribute->ContentLength = strcspn (Gbl.XMLPtr,"'");
-           }
-         else
-           {
-            snprintf (ErrorTxt,sizeof (ErrorTxt),
-	              "XML syntax error after attribute &quot;%s&quot;"
-	              " inside element &quot;%s&quot;.",
-                      Attribute->AttributeName,Elem->TagName);
-            Lay_ShowErrorAndExit (ErrorTxt);
-           }
-
-         if ((Attribute->Content = (char *) malloc (Attribute->ContentLength + 1)) == NULL)
-            Lay_NotEnoughMemoryExit ();
-         strncpy (Attribute->Content,Gbl.XMLPtr,Attribute->ContentLength);
-         Attribute->Content[Attribute->ContentLength] = '\0';
-         Gbl.XMLPtr += Attribute->ContentLength;
-
-         Gbl.XMLPtr++;
-         /* End of attribute content
-         <parent><child attribute1="value" attribute2="value">...</child>...</parent>
-                                          ^
-                                          |
-                                         Gbl.XMLPtr
-         */
+	 case EOF:
+            Lay_ShowErrorAndExit ("XML syntax error. Unexpected end of file.");
+            break;
+	 case '/':	// End of unary tag?
+	    XML_NextChar (Parser);
+	    if (Parser->Ch != '>')
+	       Lay_ShowErrorAndExit ("XML syntax error. Expect &gt; ending unary tag.");
+	    XML_NextChar (Parser);
+	    return true;
+	 case '>':	// End of start tag
+	    XML_NextChar (Parser);
+	    return false;
+	 default:	// Start of attribute name
+	    /* Attributes beyond the maximum are read but not stored */
+	    Attribute = (Parser->NumAttributes < XML_MAX_ATTRIBUTES) ? &Parser->Attributes[Parser->NumAttributes++] :
+								       &DiscardedAttribute;
+
+	    /***** Get attribute name *****/
+	    XML_GetName (Parser,Attribute->AttributeName,"= \t\r\n/>");
+	    XML_SkipSpaces (Parser);
+	    if (Parser->Ch == '=')
+	      {
+	       XML_NextChar (Parser);
+	       XML_SkipSpaces (Parser);
+	      }
+
+	    /***** Get attribute content *****/
+	    if (Parser->Ch != '\"' &&
+		Parser->Ch != '\'')
+	      {
+	       snprintf (ErrorTxt,sizeof (ErrorTxt),
+			 "XML syntax error after attribute &quot;%s&quot;"
+			 " inside element &quot;%s&quot;.",
+			 Attribute->AttributeName,
+			 Parser->TagNames[Parser->Level - 1]);
+	       Lay_ShowErrorAndExit (ErrorTxt);
+	      }
+	    Quote = Parser->Ch;
+	    XML_NextChar (Parser);
+	    for (Length = 0;
+		 Parser->Ch != Quote;
+		 XML_NextChar (Parser))
+	      {
+	       if (Parser->Ch == EOF)
+		  Lay_ShowErrorAndExit ("XML syntax error. Unexpected end of file.");
+	       if (Length < XML_MAX_BYTES_ATTRIBUTE)
+		  Attribute->Content[Length++] = (char) Parser->Ch;
+	      }
+	    Attribute->Content[Length] = '\0';
+	    XML_NextChar (Parser);
+	    break;
         }
      }
-   while (!EndOfStartTag);
   }
 
 /*****************************************************************************/
-/****************** Skip spaces while parsing XML buffer *********************/
+/***************************** Get an end tag ********************************/
 /*****************************************************************************/
 
-static void XML_SkipSpaces (void)
+static void XML_GetEndTag (struct XML_Parser *Parser)
   {
-   while (isspace ((int) *Gbl.XMLPtr))
-      Gbl.XMLPtr++;
+   char EndTagName[XML_MAX_BYTES_NAME + 1];
+   char ErrorTxt[128];
+
+   /*
+   <parent>  element content  </parent>
+                               ^
+                              Parser->Ch
+   */
+   XML_NextChar (Parser);
+   XML_GetName (Parser,EndTagName,">");
+   XML_NextChar (Parser);
+
+   /***** Check tag name *****/
+   if (!Parser->Level)
+      Lay_ShowErrorAndExit ("XML syntax error. Unexpected end tag.");
+   if (strcmp (EndTagName,Parser->TagNames[Parser->Level - 1]))	// XML tags are case sensitive
+     {
+      snprintf (ErrorTxt,sizeof (ErrorTxt),
+		"XML syntax error. Expect end tag &lt;/%s&gt;.",
+		Parser->TagNames[Parser->Level - 1]);
+      Lay_ShowErrorAndExit (ErrorTxt);
+     }
+
+   /***** End of element found *****/
+   if (Parser->Handlers->EndElement)
+      Parser->Handlers->EndElement (Parser->Args,Parser->Level,
+                                    Parser->TagNames[Parser->Level - 1]);
+   Parser->Level--;
+   Parser->ContentExpected = false;
   }
 
 /*****************************************************************************/
-/**************************** Print an XML element ***************************/
+/********************* Get the content of an element *************************/
 /*****************************************************************************/
 
-void XML_PrintTree (struct XMLElement *ParentElem)
+static void XML_GetContent (struct XML_Parser *Parser)
   {
-   static int Level = -1;
-   struct XMLElement *ChildElem;
-   struct XMLElement *NextBrother;
-   struct XMLAttribute *Attribute;
-   int i;
+   size_t Length;
 
-   Level++;
+   /*
+   <parent>  element content  </parent>
+             ^
+            Parser->Ch
+   */
+   for (Length = 0;
+	Parser->Ch != EOF && Parser->Ch != '<';
+	XML_NextChar (Parser))
+      if (Length < XML_MAX_BYTES_CONTENT)
+	 Parser->Content[Length++] = (char) Parser->Ch;
+
+   /* Remove trailing spaces in content */
+   while (Length && isspace ((int) (unsigned char) Parser->Content[Length - 1]))
+      Length--;
+   Parser->Content[Length] = '\0';
+
+   /***** Text between a start tag and its first child or its end tag *****/
+   if (Parser->ContentExpected && Length)
+      if (Parser->Handlers->Content)
+	 Parser->Handlers->Content (Parser->Args,Parser->Level,
+	                            Parser->TagNames[Parser->Level - 1],
+	                            Parser->Content);
+   Parser->ContentExpected = false;
+  }
 
-   /***** Print start tag *****/
-   if (Level > 0)
-     {
-      for (i = 1;
-	   i < Level;
-	   i++)
-         HTM_Txt ("   ");
-      HTM_TxtF ("&lt;%s",ParentElem->TagName ? ParentElem->TagName :
-        	                               "");
-
-      /* Print attributes */
-      for (Attribute = ParentElem->FirstAttribute;
-	   Attribute != NULL;
-	   Attribute = Attribute->Next)
-         HTM_TxtF (" %s=&quot;%s&quot;",
-                   Attribute->AttributeName,
-                   Attribute->Content);
-
-      HTM_Txt ("&gt;\n");
-
-      /***** Print content *****/
-      if (ParentElem->Content)
-        {
-         for (i = 1;
-              i < Level;
-              i++)
-            HTM_Txt ("   ");
-         HTM_TxtF ("%s\n",ParentElem->Content);
-        }
-     }
+/*****************************************************************************/
+/***************** Get the name of a tag or an attribute *********************/
+/*****************************************************************************/
 
-   /***** Print children *****/
-   ChildElem = ParentElem->FirstChild;
-   while (ChildElem)
-     {
-      NextBrother = ChildElem->NextBrother;
-      XML_PrintTree (ChildElem);
-      ChildElem = NextBrother;
-     }
+static void XML_GetName (struct XML_Parser *Parser,
+                         char Name[XML_MAX_BYTES_NAME + 1],
+                         const char *Delimiters)
+  {
+   size_t Length;
 
-   /***** Print end tag *****/
-   if (Level > 0)
+   for (Length = 0;
+	Parser->Ch != EOF && !strchr (Delimiters,Parser->Ch);
+	XML_NextChar (Parser))
      {
-      for (i = 1;
-	   i < Level;
-	   i++)
-         HTM_Txt ("   ");
-      HTM_TxtF ("&lt;/%s&gt;\n",ParentElem->TagName ? ParentElem->TagName :
-        	                                      "");
+      if (Length == XML_MAX_BYTES_NAME)
+	 Lay_ShowErrorAndExit ("XML syntax error. Name too long.");
+      Name[Length++] = (char) Parser->Ch;
      }
+   Name[Length] = '\0';
 
-   Level--;
+   if (Parser->Ch == EOF)
+      Lay_ShowErrorAndExit ("XML syntax error. Unexpected end of file.");
+   if (!Length)
+      Lay_ShowErrorAndExit ("XML syntax error. Expect name.");
   }
 
 /*****************************************************************************/
-/********** Get attribute "yes"/"no" from an XML element in a tree ***********/
+/******************* Read next character from XML file ***********************/
 /*****************************************************************************/
 
-bool XML_GetAttributteYesNoFromXMLTree (struct XMLAttribute *Attribute)
+static void XML_NextChar (struct XML_Parser *Parser)
   {
-   if (!Attribute->Content)
-      Lay_ShowErrorAndExit ("XML attribute yes/no not found.");
-   if (!strcasecmp (Attribute->Content,"yes") ||
-       !strcasecmp (Attribute->Content,"y"))	// case insensitive, because users can edit XML
-      return true;
-   if (!strcasecmp (Attribute->Content,"no") ||
-       !strcasecmp (Attribute->Content,"n"))	// case insensitive, because users can edit XML
-      return false;
-   Lay_ShowErrorAndExit ("XML attribute yes/no not found.");
-   return false;	// Not reached
+   Parser->Ch = getc (Parser->FileXML);
   }
 
 /*****************************************************************************/
-/************ Free the memory allocated for an XML element *******************/
+/******************* Skip spaces while parsing XML file **********************/
 /*****************************************************************************/
 
-void XML_FreeTree (struct XMLElement *ParentElem)
+static void XML_SkipSpaces (struct XML_Parser *Parser)
   {
-   struct XMLElement *ChildElem;
-   struct XMLElement *NextElemBrother;
-   struct XMLAttribute *Attribute;
-   struct XMLAttribute *NextAttrib;
+   while (Parser->Ch != EOF && isspace (Parser->Ch))
+      XML_NextChar (Parser);
+  }
 
-   /***** Free memory allocated for children *****/
-   ChildElem = ParentElem->FirstChild;
-   while (ChildElem)
-     {
-      NextElemBrother = ChildElem->NextBrother;
-      XML_FreeTree (ChildElem);
-      ChildElem = NextElemBrother;
-     }
+/*****************************************************************************/
+/************************** Print an XML file ********************************/
+/*****************************************************************************/
 
-   /***** Free memory allocated for TagName *****/
-   if (ParentElem->TagName)
+void XML_PrintFile (FILE *FileXML)
+  {
+   static const struct XMLHandlers PrintHandlers =
      {
-      free (ParentElem->TagName);
-      ParentElem->TagName = NULL;
-      ParentElem->TagNameLength = (size_t) 0;
-     }
+      .StartElement = XML_PrintStartElement,
+      .Content      = XML_PrintContent,
+      .EndElement   = XML_PrintEndElement,
+     };
 
-   /***** Free memory allocated for attributes *****/
-   Attribute = ParentElem->FirstAttribute;
-   while (Attribute)
-     {
-      NextAttrib = Attribute->Next;
-      free (Attribute->AttributeName);
-      free (Attribute->Content);
-      free (Attribute);
-      Attribute = NextAttrib;
-     }
+   XML_ParseFile (FileXML,&PrintHandlers,NULL);
+  }
 
-   /***** Free memory allocated for Content *****/
-   if (ParentElem->Content)
-     {
-      free (ParentElem->Content);
-      ParentElem->Content = NULL;
-      ParentElem->ContentLength = (size_t) 0;
-     }
+static void XML_PrintStartElement (__attribute__((unused)) void *Args,
+                                   unsigned Level,const char *TagName,
+                                   const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                                   unsigned NumAttributes)
+  {
+   unsigned NumAttribute;
+
+   /***** Print start tag *****/
+   XML_PrintIndent (Level);
+   HTM_TxtF ("&lt;%s",TagName);
+
+   /***** Print attributes *****/
+   for (NumAttribute = 0;
+	NumAttribute < NumAttributes;
+	NumAttribute++)
+      HTM_TxtF (" %s=&quot;%s&quot;",
+		Attributes[NumAttribute].AttributeName,
+		Attributes[NumAttribute].Content);
+
+   HTM_Txt ("&gt;\n");
+  }
+
+static void XML_PrintContent (__attribute__((unused)) void *Args,
+                              unsigned Level,
+                              __attribute__((unused)) const char *TagName,
+                              const char *Content)
+  {
+   XML_PrintIndent (Level);
+   HTM_TxtF ("%s\n",Content);
+  }
+
+static void XML_PrintEndElement (__attribute__((unused)) void *Args,
+                                 unsigned Level,const char *TagName)
+  {
+   XML_PrintIndent (Level);
+   HTM_TxtF ("&lt;/%s&gt;\n",TagName);
+  }
+
+static void XML_PrintIndent (unsigned Level)
+  {
+   unsigned i;
+
+   for (i = 1;
+	i < Level;
+	i++)
+      HTM_Txt ("   ");
+  }
+
+/*****************************************************************************/
+/************** Get the content of an attribute of a start tag ***************/
+/*****************************************************************************/
+// Return NULL if the attribute is not found
+
+const char *XML_GetAttribute (const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                              unsigned NumAttributes,const char *AttributeName)
+  {
+   unsigned NumAttribute;
+
+   for (NumAttribute = 0;
+	NumAttribute < NumAttributes;
+	NumAttribute++)
+      if (!strcmp (Attributes[NumAttribute].AttributeName,AttributeName))
+	 return Attributes[NumAttribute].Content;	// Only first attribute
+
+   return NULL;
+  }
+
+/*****************************************************************************/
+/********************** Get content "yes"/"no" of an attribute ***************/
+/*****************************************************************************/
+
+bool XML_GetAttributteYesNo (const char *Content)
+  {
+   if (!Content)
+      Lay_ShowErrorAndExit ("XML attribute yes/no not found.");
+   if (!strcasecmp (Content,"yes") ||
+       !strcasecmp (Content,"y"))	// case insensitive, because users can edit XML
+      return true;
+   if (!strcasecmp (Content,"no") ||
+       !strcasecmp (Content,"n"))	// case insensitive, because users can edit XML
+      return false;
+   Lay_ShowErrorAndExit ("XML attribute yes/no not found.");
+   return false;	// Not reached
   }
@@ -29,30 +29,39 @@
 
 #include <stdio.h>	// For FILE *
 
+#include "swad_constant.h"
+
+/*****************************************************************************/
+/***************************** Public constants ******************************/
+/*****************************************************************************/
+
+#define XML_MAX_LEVELS			 16	// Maximum number of nested elements
+#define XML_MAX_BYTES_NAME		 63	// Maximum length of tag and attribute names
+#define XML_MAX_ATTRIBUTES		  8	// Maximum number of attributes got from a start tag
+#define XML_MAX_BYTES_ATTRIBUTE		255	// Longer attribute contents are truncated
+#define XML_MAX_BYTES_CONTENT	Cns_MAX_BYTES_TEXT	// Longer element contents are truncated
+
 /*****************************************************************************/
 /******************************** Public types *******************************/
 /*****************************************************************************/
 
 struct XMLAttribute
   {
-   struct XMLAttribute *Next;
-   char *AttributeName;
-   size_t AttributeNameLength;
-   char *Content;
-   size_t ContentLength;
+   char AttributeName[XML_MAX_BYTES_NAME + 1];
+   char Content[XML_MAX_BYTES_ATTRIBUTE + 1];
   };
 
-struct XMLElement
+// Functions called by the parser while reading an XML file.
+// Level is 1 for the outermost element.
+// Content is the text between a start tag and its first child or its end tag
+struct XMLHandlers
   {
-   struct XMLElement *FirstChild;
-   struct XMLElement *LastChild;
-   struct XMLElement *NextBrother;
-   struct XMLAttribute *FirstAttribute;
-   struct XMLAttribute *LastAttribute;
-   char *TagName;
-   size_t TagNameLength;
-   char *Content;
-   size_t ContentLength;
+   void (*StartElement) (void *Args,unsigned Level,const char *TagName,
+                         const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                         unsigned NumAttributes);
+   void (*Content) (void *Args,unsigned Level,const char *TagName,
+                    const char *Content);
+   void (*EndElement) (void *Args,unsigned Level,const char *TagName);
   };
 
 /*****************************************************************************/
@@ -62,9 +71,10 @@ struct XMLElement
 void XML_WriteStartFile (FILE *FileTgt,const char *Type,bool Credits);
 void XML_WriteEndFile (FILE *FileTgt,const char *Type);
 
-void XML_GetTree (const char *XMLBuffer,struct XMLElement **XMLRootElem);
-void XML_PrintTree (struct XMLElement *ParentElem);
-bool XML_GetAttributteYesNoFromXMLTree (struct XMLAttribute *Attribute);
-void XML_FreeTree (struct XMLElement *ParentElem);
+void XML_ParseFile (FILE *FileXML,const struct XMLHandlers *Handlers,void *Args);
+void XML_PrintFile (FILE *FileXML);
+const char *XML_GetAttribute (const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                              unsigned NumAttributes,const char *AttributeName);
+bool XML_GetAttributteYesNo (const char *Content);
 
 #endif
@@ -0,0 +1,376 @@
+// group_stress_test.c: concurrency stress test of changes of groups
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Canas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Usage:
+//   SWAD_DB_PASSWORD=... group_stress_test CrsCod NumStds MaxStudents [NumRounds]
+// Run it in a test server with a copy of the database of SWAD
+// (host, user and database in swad_config.h).
+// A new type of group with two groups of MaxStudents students
+// is created in the course CrsCod, and NumStds fake students
+// are registered in the course.
+// Each student runs in two processes, each one with its own connection
+// to database, as if the student sent two requests at the same time.
+// In each round, each process tries to join one of the groups
+// (a different group in each process of the same student) or to leave it,
+// all at the same time, calling Grp_ChangeMyGrpsAtomically.
+// At the end, the number of students in each group is checked
+// against MaxStudents, and the type of group, the groups
+// and the fake students are removed.
+// Exit 0 if no group has more than MaxStudents students
+// and no student is in both groups.
+
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../swad_database.h"
+#include "../swad_global.h"
+#include "../swad_group.h"
+
+/*****************************************************************************/
+/************************** Private constants ********************************/
+/*****************************************************************************/
+
+#define FIRST_FAKE_USR_COD	2000000000L	// Fake students are FIRST_FAKE_USR_COD, FIRST_FAKE_USR_COD + 1...
+#define NUM_GRPS		2
+#define NUM_PROCS_PER_STD	2	// Concurrent requests of each student
+#define DEFAULT_NUM_ROUNDS	20
+
+/*****************************************************************************/
+/****************** Global variables and functions used by *******************/
+/************************ swad_database.c, swad_group.c **********************/
+/*****************************************************************************/
+
+struct Globals Gbl;
+
+void Lay_ShowErrorAndExit (const char *Txt)
+  {
+   fprintf (stderr,"%s\n",Txt ? Txt :
+				"Error.");
+   exit (2);
+  }
+
+void Lay_NotEnoughMemoryExit (void)
+  {
+   Lay_ShowErrorAndExit ("Not enough memory.");
+  }
+
+bool Usr_ItsMe (long UsrCod)
+  {
+   return UsrCod == Gbl.Usrs.Me.UsrDat.UsrCod;
+  }
+
+time_t Dat_GetUNIXTimeFromStr (const char *Str)
+  {
+   time_t Time = (time_t) 0;
+
+   if (Str)
+      if (sscanf (Str,"%ld",&Time) != 1)
+	 Time = (time_t) 0;
+   return Time;
+  }
+
+long Str_ConvertStrCodToLongCod (const char *Str)
+  {
+   long Code;
+
+   if (!Str)
+      return -1L;
+   if (sscanf (Str,"%ld",&Code) != 1)
+      return -1L;
+   return Code;
+  }
+
+void Str_Copy (char *Dst,const char *Src,size_t DstSize)
+  {
+   if (strlen (Src) > DstSize)
+      Lay_ShowErrorAndExit ("String too long.");
+   strcpy (Dst,Src);
+  }
+
+void Str_Concat (char *Dst,const char *Src,size_t DstSize)
+  {
+   if (strlen (Dst) + strlen (Src) > DstSize)
+      Lay_ShowErrorAndExit ("String too long.");
+   strcat (Dst,Src);
+  }
+
+/*****************************************************************************/
+/********************************* Timing ************************************/
+/*****************************************************************************/
+
+static double Seconds (void)
+  {
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + (double) ts.tv_nsec / 1E9;
+  }
+
+/*****************************************************************************/
+/********** Create a type of group with groups and fake students *************/
+/*****************************************************************************/
+
+static void CreateGroups (long CrsCod,unsigned NumStds,unsigned MaxStudents,
+                          long *GrpTypCod,long GrpCods[NUM_GRPS])
+  {
+   unsigned NumGrp;
+   unsigned NumStd;
+
+   *GrpTypCod =
+   DB_QueryINSERTandReturnCode ("can not create type of group",
+				"INSERT INTO crs_grp_types"
+				" (CrsCod,GrpTypName,Mandatory,Multiple,"
+				"MustBeOpened,OpenTime)"
+				" VALUES"
+				" (%ld,'Stress test %d','N','N','N',NOW())",
+				CrsCod,(int) getpid ());
+
+   for (NumGrp = 0;
+	NumGrp < NUM_GRPS;
+	NumGrp++)
+      GrpCods[NumGrp] =
+      DB_QueryINSERTandReturnCode ("can not create group",
+				   "INSERT INTO crs_grp"
+				   " (GrpTypCod,GrpName,RooCod,MaxStudents,Open,FileZones)"
+				   " VALUES"
+				   " (%ld,'%u',-1,%u,'Y','N')",
+				   *GrpTypCod,NumGrp + 1,MaxStudents);
+
+   for (NumStd = 0;
+	NumStd < NumStds;
+	NumStd++)
+      DB_QueryINSERT ("can not register student",
+		      "INSERT INTO crs_usr"
+		      " (CrsCod,UsrCod,Role,Accepted)"
+		      " VALUES"
+		      " (%ld,%ld,%u,'Y')",
+		      CrsCod,FIRST_FAKE_USR_COD + (long) NumStd,
+		      (unsigned) Rol_STD);
+  }
+
+/*****************************************************************************/
+/********** Remove the type of group, its groups and fake students ***********/
+/*****************************************************************************/
+
+static void RemoveGroups (long CrsCod,unsigned NumStds,long GrpTypCod)
+  {
+   DB_QueryDELETE ("can not remove students from groups",
+		   "DELETE FROM crs_grp_usr"
+		   " WHERE GrpCod IN"
+		   " (SELECT GrpCod FROM crs_grp WHERE GrpTypCod=%ld)",
+		   GrpTypCod);
+   DB_QueryDELETE ("can not remove groups",
+		   "DELETE FROM crs_grp WHERE GrpTypCod=%ld",
+		   GrpTypCod);
+   DB_QueryDELETE ("can not remove type of group",
+		   "DELETE FROM crs_grp_types WHERE GrpTypCod=%ld",
+		   GrpTypCod);
+   DB_QueryDELETE ("can not remove students",
+		   "DELETE FROM crs_usr"
+		   " WHERE CrsCod=%ld AND UsrCod>=%ld AND UsrCod<%ld",
+		   CrsCod,
+		   FIRST_FAKE_USR_COD,FIRST_FAKE_USR_COD + (long) NumStds);
+  }
+
+/*****************************************************************************/
+/************* Change the groups of a student in several rounds **************/
+/*****************************************************************************/
+// Run in a child process. Results are written to Pipe.
+// In the same round, the processes of a student try to join different groups
+
+static void RunStd (long CrsCod,long UsrCod,unsigned NumProc,
+                    const long GrpCods[NUM_GRPS],
+                    unsigned NumRounds,time_t StartTime,int Pipe)
+  {
+   struct ListCodGrps LstGrpsIWant;
+   long GrpCodIWant;
+   unsigned NumRound;
+   unsigned Seed = (unsigned) getpid ();
+   unsigned Results[Grp_NUM_RESULTS_OF_CHANGES] = {0};	// Indexed by Grp_ResultOfChanges_t
+   struct timespec Delay = {0,1000000L};
+
+   /***** Current user is a student in the course *****/
+   Gbl.Hierarchy.Crs.CrsCod = CrsCod;
+   Gbl.Usrs.Me.UsrDat.UsrCod = UsrCod;
+   Gbl.Usrs.Me.Role.Logged = Rol_STD;
+   DB_OpenDBConnection ();
+
+   /***** Wait for other students *****/
+   while (time (NULL) < StartTime)
+      nanosleep (&Delay,NULL);
+
+   /***** Join a group or leave groups in each round *****/
+   LstGrpsIWant.GrpCods = &GrpCodIWant;
+   for (NumRound = 0;
+	NumRound < NumRounds;
+	NumRound++)
+     {
+      GrpCodIWant = GrpCods[(NumRound + NumProc) % NUM_GRPS];
+      LstGrpsIWant.NumGrps = (rand_r (&Seed) % 4) ? 1 :	// Join a group
+						    0;	// Leave groups
+      Results[Grp_ChangeMyGrpsAtomically (&LstGrpsIWant)]++;
+     }
+
+   DB_CloseDBConnection ();
+
+   if (write (Pipe,Results,sizeof (Results)) != (ssize_t) sizeof (Results))
+      exit (2);
+   exit (0);
+  }
+
+/*****************************************************************************/
+/*********************************** Main ************************************/
+/*****************************************************************************/
+
+int main (int argc,char *argv[])
+  {
+   const char *Password = getenv ("SWAD_DB_PASSWORD");
+   long CrsCod;
+   unsigned NumStds;
+   unsigned MaxStudents;
+   unsigned NumRounds;
+   unsigned NumStd;
+   unsigned NumProc;
+   long GrpTypCod;
+   long GrpCods[NUM_GRPS];
+   unsigned NumGrp;
+   unsigned NumStdsInGrp;
+   unsigned Results[Grp_NUM_RESULTS_OF_CHANGES];
+   unsigned TotalResults[Grp_NUM_RESULTS_OF_CHANGES] = {0};
+   unsigned NumResult;
+   int Pipe[2];
+   int Status;
+   time_t StartTime;
+   struct timespec Delay = {0,1000000L};
+   double Start;
+   bool Ok = true;
+
+   if (argc < 4 || !Password)
+     {
+      fprintf (stderr,"Usage: SWAD_DB_PASSWORD=... %s CrsCod NumStds MaxStudents [NumRounds]\n",
+	       argv[0]);
+      return 2;
+     }
+   CrsCod      = atol (argv[1]);
+   NumStds     = (unsigned) atoi (argv[2]);
+   MaxStudents = (unsigned) atoi (argv[3]);
+   NumRounds   = argc > 4 ? (unsigned) atoi (argv[4]) :
+			    DEFAULT_NUM_ROUNDS;
+
+   snprintf (Gbl.Config.DatabasePassword,sizeof (Gbl.Config.DatabasePassword),
+	     "%s",Password);
+
+   /***** Create groups *****/
+   DB_OpenDBConnection ();
+   CreateGroups (CrsCod,NumStds,MaxStudents,&GrpTypCod,GrpCods);
+   DB_CloseDBConnection ();
+
+   /***** Run students at the same time *****/
+   if (pipe (Pipe))
+      return 2;
+   StartTime = time (NULL) + 2;
+   for (NumStd = 0;
+	NumStd < NumStds;
+	NumStd++)
+      for (NumProc = 0;
+	   NumProc < NUM_PROCS_PER_STD;
+	   NumProc++)
+	 switch (fork ())
+	   {
+	    case -1:
+	       return 2;
+	    case 0:
+	       close (Pipe[0]);
+	       RunStd (CrsCod,FIRST_FAKE_USR_COD + (long) NumStd,NumProc,GrpCods,
+		       NumRounds,StartTime,Pipe[1]);
+	       break;
+	    default:
+	       break;
+	   }
+   close (Pipe[1]);
+
+   /***** Wait for students *****/
+   while (time (NULL) < StartTime)
+      nanosleep (&Delay,NULL);
+   Start = Seconds ();
+   while (read (Pipe[0],Results,sizeof (Results)) == (ssize_t) sizeof (Results))
+      for (NumResult = 0;
+	   NumResult < Grp_NUM_RESULTS_OF_CHANGES;
+	   NumResult++)
+	 TotalResults[NumResult] += Results[NumResult];
+   while (wait (&Status) > 0)
+      if (!WIFEXITED (Status) || WEXITSTATUS (Status))
+	 Ok = false;
+   printf ("%u students x %u requests x %u rounds in %.3f s:"
+	   " %u made, %u not made, %u locked, %u not valid\n",
+	   NumStds,NUM_PROCS_PER_STD,NumRounds,Seconds () - Start,
+	   TotalResults[Grp_CHANGES_MADE],
+	   TotalResults[Grp_CHANGES_NOT_MADE],
+	   TotalResults[Grp_GROUPS_LOCKED],
+	   TotalResults[Grp_SELECTION_NOT_VALID]);
+   if (!Ok)
+      printf ("Some students exited with error\n");
+
+   /***** Check limits and remove groups *****/
+   DB_OpenDBConnection ();
+   for (NumGrp = 0;
+	NumGrp < NUM_GRPS;
+	NumGrp++)
+     {
+      NumStdsInGrp = (unsigned) DB_QueryCOUNT ("can not count students",
+					       "SELECT COUNT(*) FROM crs_grp_usr"
+					       " WHERE GrpCod=%ld",
+					       GrpCods[NumGrp]);
+      printf ("Group %u: %u students (maximum %u)\n",
+	      NumGrp + 1,NumStdsInGrp,MaxStudents);
+      if (NumStdsInGrp > MaxStudents)
+	 Ok = false;
+     }
+   if (DB_QueryCOUNT ("can not count students",
+		      "SELECT COUNT(*) FROM"
+		      " (SELECT UsrCod FROM crs_grp_usr,crs_grp"
+		      " WHERE crs_grp.GrpTypCod=%ld"
+		      " AND crs_grp.GrpCod=crs_grp_usr.GrpCod"
+		      " GROUP BY UsrCod HAVING COUNT(*)>1) AS more_than_one",
+		      GrpTypCod))
+     {
+      printf ("Some students are in more than one group of single enrolment\n");
+      Ok = false;
+     }
+   RemoveGroups (CrsCod,NumStds,GrpTypCod);
+   DB_CloseDBConnection ();
+
+   printf (Ok ? "Limits respected\n" :
+		"Limits NOT respected\n");
+   return Ok ? 0 :
+	       1;
+  }
@@ -0,0 +1,416 @@
+// log_column_bench.c: benchmark of swad_log_column.c against SQL over log
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Canas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Usage:
+//   SWAD_DB_PASSWORD=... log_column_bench export
+//   SWAD_DB_PASSWORD=... log_column_bench query [NumUsrs]
+// Run it in a test server with a copy of the database of SWAD
+// (host, user and database in swad_config.h).
+// "export" exports all the closed months of log to files
+// in Cfg_PATH_LOG_COLUMNS_PRIVATE and shows the time spent.
+// "query" gets the clicks per year, per action and per course
+// of the NumUsrs users with more clicks (10 by default),
+// from the files and from log, checks that counts are equal
+// and shows the time spent by both ways.
+// Exit 0 if counts are equal.
+
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../swad_alert.h"
+#include "../swad_database.h"
+#include "../swad_global.h"
+#include "../swad_log_archive.h"
+#include "../swad_log_column.h"
+
+/*****************************************************************************/
+/****************** Global variables and functions used by *******************/
+/****************** swad_database.c, swad_log_archive.c... *******************/
+/*****************************************************************************/
+
+struct Globals Gbl;
+
+const char *Txt_Creating_database_tables_if_they_do_not_exist = "";
+const char *Txt_Created_tables_in_the_database_that_did_not_exist = "";
+
+void Lay_ShowErrorAndExit (const char *Txt)
+  {
+   fprintf (stderr,"%s\n",Txt ? Txt :
+				"Error.");
+   exit (2);
+  }
+
+void Lay_NotEnoughMemoryExit (void)
+  {
+   Lay_ShowErrorAndExit ("Not enough memory.");
+  }
+
+void Ale_ShowAlert (Ale_AlertType_t AlertType,const char *fmt,...)
+  {
+   (void) AlertType;
+   (void) fmt;
+  }
+
+void HTM_Txt (const char *Txt)
+  {
+   (void) Txt;
+  }
+
+void HTM_OL_Begin (void)
+  {
+  }
+
+void HTM_OL_End (void)
+  {
+  }
+
+void HTM_LI_Begin (const char *fmt,...)
+  {
+   (void) fmt;
+  }
+
+void HTM_LI_End (void)
+  {
+  }
+
+time_t Dat_GetUNIXTimeFromStr (const char *Str)
+  {
+   time_t Time = (time_t) 0;
+
+   if (Str)
+      if (sscanf (Str,"%ld",&Time) != 1)
+	 Time = (time_t) 0;
+   return Time;
+  }
+
+long Str_ConvertStrCodToLongCod (const char *Str)
+  {
+   long Code;
+
+   if (!Str)
+      return -1L;
+   if (sscanf (Str,"%ld",&Code) != 1)
+      return -1L;
+   return Code;
+  }
+
+void Str_Copy (char *Dst,const char *Src,size_t DstSize)
+  {
+   if (strlen (Src) > DstSize)
+      Lay_ShowErrorAndExit ("String too long.");
+   strcpy (Dst,Src);
+  }
+
+void Fil_CreateDirIfNotExists (const char Path[PATH_MAX + 1])
+  {
+   mkdir (Path,(mode_t) 0xFFF);
+  }
+
+/*****************************************************************************/
+/********************************* Timing ************************************/
+/*****************************************************************************/
+
+static double Seconds (void)
+  {
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + (double) ts.tv_nsec / 1E9;
+  }
+
+/*****************************************************************************/
+/********************** Export all the closed months *************************/
+/*****************************************************************************/
+
+static void Export (void)
+  {
+   time_t EndOfColumns;
+   time_t PrevEndOfColumns;
+   unsigned NumMonths = 0;
+   double Start = Seconds ();
+
+   for (EndOfColumns = LogCol_GetEndOfColumns ();
+	;
+	NumMonths++)
+     {
+      PrevEndOfColumns = EndOfColumns;
+      LogCol_ExportNextMonth ();
+      if ((EndOfColumns = LogCol_GetEndOfColumns ()) == PrevEndOfColumns)
+	 break;
+     }
+
+   printf ("Exported %u months in %.3f s\n",NumMonths,Seconds () - Start);
+  }
+
+/*****************************************************************************/
+/**************** Compare counts without taking zeros into account ***********/
+/*****************************************************************************/
+
+static bool EqualCounts (const struct LogCol_Counts *C1,
+                         const struct LogCol_Counts *C2)
+  {
+   unsigned i1 = 0;
+   unsigned i2 = 0;
+
+   for (;;)
+     {
+      while (i1 < C1->Num && !C1->Counts[i1].NumClicks)
+	 i1++;
+      while (i2 < C2->Num && !C2->Counts[i2].NumClicks)
+	 i2++;
+      if (i1 == C1->Num || i2 == C2->Num)
+	 return i1 == C1->Num && i2 == C2->Num;
+      if (C1->Counts[i1].Key       != C2->Counts[i2].Key ||
+	  C1->Counts[i1].NumClicks != C2->Counts[i2].NumClicks)
+	 return false;
+      i1++;
+      i2++;
+     }
+  }
+
+/*****************************************************************************/
+/********* Get counts of a user from columns and from log, and compare *******/
+/*****************************************************************************/
+
+static bool QueryUsr (long UsrCod,time_t EndOfColumns,
+                      double TimeColumns[3],double TimeSQL[3])
+  {
+   static const char *GroupByTxt[3] =
+     {
+      "year",
+      "action",
+      "course",
+     };
+   static const LogCol_GroupBy_t GroupBys[3] =
+     {
+      LogCol_GROUP_BY_YEAR,
+      LogCol_GROUP_BY_ACTION,
+      LogCol_GROUP_BY_COURSE,
+     };
+   struct LogCol_Filter Filter;
+   struct LogCol_Counts CountsColumns;
+   struct LogCol_Counts CountsSQL;
+   char Condition[64];
+   char *LogTable;
+   struct tm tm;
+   time_t StartOfYear;
+   time_t EndOfYear;
+   int Year;
+   int LastYear;
+   unsigned i;
+   double Start;
+   bool Equal = true;
+
+   /***** Filter: clicks of the user in closed months *****/
+   LogCol_ResetFilter (&Filter);
+   Filter.EndTimeUTC = EndOfColumns;
+   Filter.UsrCod = UsrCod;
+   snprintf (Condition,sizeof (Condition),"UsrCod=%ld",UsrCod);
+
+   for (i = 0;
+	i < 3;
+	i++)
+     {
+      /***** From columns *****/
+      LogCol_ResetCounts (&CountsColumns);
+      Start = Seconds ();
+      LogCol_GetCountsFromColumns (&CountsColumns,&Filter,GroupBys[i]);
+      LogCol_MergeCounts (&CountsColumns);
+      TimeColumns[i] += Seconds () - Start;
+
+      /***** From log *****/
+      LogCol_ResetCounts (&CountsSQL);
+      Start = Seconds ();
+      LogArc_BuildLogTable (&LogTable,(time_t) 0,EndOfColumns - 1,Condition);
+      switch (GroupBys[i])
+	{
+	 case LogCol_GROUP_BY_ACTION:
+	    LogCol_GetCountsFromQuery (&CountsSQL,"can not get clicks",
+				       "SELECT ActCod,COUNT(*)"
+				       " FROM %s"
+				       " WHERE ClickTime<FROM_UNIXTIME(%ld)"
+				       " AND UsrCod=%ld"
+				       " GROUP BY ActCod",
+				       LogTable,(long) EndOfColumns,UsrCod);
+	    break;
+	 case LogCol_GROUP_BY_COURSE:
+	    LogCol_GetCountsFromQuery (&CountsSQL,"can not get clicks",
+				       "SELECT CrsCod,COUNT(*)"
+				       " FROM %s"
+				       " WHERE ClickTime<FROM_UNIXTIME(%ld)"
+				       " AND UsrCod=%ld"
+				       " GROUP BY CrsCod",
+				       LogTable,(long) EndOfColumns,UsrCod);
+	    break;
+	 default:	// Years (UTC) from the first click
+	    gmtime_r (&EndOfColumns,&tm);
+	    LastYear = 1900 + tm.tm_year;
+	    Year = 1900 + tm.tm_year;
+	    if (CountsColumns.Num)
+	       Year = (int) CountsColumns.Counts[0].Key;
+	    for (;
+		 Year <= LastYear;
+		 Year++)
+	      {
+	       memset (&tm,0,sizeof (tm));
+	       tm.tm_year = Year - 1900;
+	       tm.tm_mday = 1;
+	       StartOfYear = timegm (&tm);
+	       tm.tm_year++;
+	       EndOfYear = timegm (&tm);
+	       if (EndOfYear > EndOfColumns)
+		  EndOfYear = EndOfColumns;
+	       LogCol_GetCountsFromQuery (&CountsSQL,"can not get clicks",
+					  "SELECT %d,COUNT(*)"
+					  " FROM %s"
+					  " WHERE ClickTime>=FROM_UNIXTIME(%ld)"
+					  " AND ClickTime<FROM_UNIXTIME(%ld)"
+					  " AND UsrCod=%ld",
+					  Year,LogTable,
+					  (long) StartOfYear,(long) EndOfYear,
+					  UsrCod);
+	      }
+	    break;
+	}
+      free (LogTable);
+      LogCol_MergeCounts (&CountsSQL);
+      TimeSQL[i] += Seconds () - Start;
+
+      /***** Compare *****/
+      if (!EqualCounts (&CountsColumns,&CountsSQL))
+	{
+	 printf ("User %ld: different clicks per %s\n",UsrCod,GroupByTxt[i]);
+	 Equal = false;
+	}
+
+      LogCol_FreeCounts (&CountsColumns);
+      LogCol_FreeCounts (&CountsSQL);
+     }
+
+   return Equal;
+  }
+
+/*****************************************************************************/
+/************ Get counts of the users with more clicks and compare ***********/
+/*****************************************************************************/
+
+static bool Query (unsigned NumUsrs)
+  {
+   static const char *GroupByTxt[3] =
+     {
+      "year",
+      "action",
+      "course",
+     };
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned NumUsr;
+   time_t EndOfColumns;
+   double TimeColumns[3] = {0.0,0.0,0.0};
+   double TimeSQL[3] = {0.0,0.0,0.0};
+   unsigned i;
+   bool Equal = true;
+
+   if ((EndOfColumns = LogCol_GetEndOfColumns ()) == (time_t) 0)
+     {
+      printf ("No months exported. Run \"log_column_bench export\" first.\n");
+      return false;
+     }
+
+   NumUsrs = (unsigned) DB_QuerySELECT (&mysql_res,"can not get users",
+					"SELECT UsrCod"
+					" FROM usr_figures"
+					" ORDER BY NumClicks DESC"
+					" LIMIT %u",
+					NumUsrs);
+   for (NumUsr = 0;
+	NumUsr < NumUsrs;
+	NumUsr++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      if (!QueryUsr (Str_ConvertStrCodToLongCod (row[0]),EndOfColumns,
+		     TimeColumns,TimeSQL))
+	 Equal = false;
+     }
+   DB_FreeMySQLResult (&mysql_res);
+
+   printf ("%u users\n"
+	   "clicks per  columns (s)  log (s)  speedup\n",
+	   NumUsrs);
+   for (i = 0;
+	i < 3;
+	i++)
+      printf ("%-10s  %11.3f  %7.3f  %6.1fx\n",
+	      GroupByTxt[i],TimeColumns[i],TimeSQL[i],
+	      TimeColumns[i] > 0.0 ? TimeSQL[i] / TimeColumns[i] :
+				     0.0);
+   printf (Equal ? "Counts are equal\n" :
+		   "Counts are NOT equal\n");
+
+   return Equal;
+  }
+
+/*****************************************************************************/
+/*********************************** Main ************************************/
+/*****************************************************************************/
+
+int main (int argc,char *argv[])
+  {
+   const char *Password = getenv ("SWAD_DB_PASSWORD");
+   bool Ok = true;
+
+   if (argc < 2 || !Password)
+     {
+      fprintf (stderr,"Usage: SWAD_DB_PASSWORD=... %s export | query [NumUsrs]\n",
+	       argv[0]);
+      return 2;
+     }
+
+   Gbl.PID = getpid ();
+   Gbl.StartExecutionTimeUTC = time (NULL);
+   snprintf (Gbl.Config.DatabasePassword,sizeof (Gbl.Config.DatabasePassword),
+	     "%s",Password);
+   DB_OpenDBConnection ();
+
+   if (!strcmp (argv[1],"export"))
+      Export ();
+   else if (!strcmp (argv[1],"query"))
+      Ok = Query (argc > 2 ? (unsigned) atoi (argv[2]) :
+			     10);
+   else
+      Lay_ShowErrorAndExit ("Wrong command.");
+
+   DB_CloseDBConnection ();
+   return Ok ? 0 :
+	       1;
+  }
@@ -0,0 +1,201 @@
+#!/usr/bin/python3
+#
+# smtp_fake_server.py: fake SMTP server to test swad_smtp.c
+#
+##########################################################################
+#
+#   SWAD (Shared Workspace At a Distance),
+#   is a web platform developed at the University of Granada (Spain),
+#   and used to support university teaching.
+#
+#   This file is part of SWAD core.
+#   Copyright (C) 1999-2020 Antonio Canas Vargas
+#
+#   This program is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU Affero General Public License as
+#   published by the Free Software Foundation, either version 3 of the
+#   License, or (at your option) any later version.
+#
+#   This program is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU Affero General Public License for more details.
+#
+#   You should have received a copy of the GNU Affero General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+##########################################################################
+
+# Usage:
+#   smtp_fake_server.py cert_file key_file user password log_file [options]
+# Options:
+#   --implicit-tls    start TLS just after connecting (as in port 465)
+#   --drop-after N    close the connection after receiving N emails in it
+#   --reject ADDRESS  reject this recipient with 550
+#   --pipelining      announce PIPELINING and hold the replies to MAIL and RCPT
+#                     until DATA is received, so a client waiting for each
+#                     reply before sending the next command gets stuck
+#
+# The server listens on a free port of 127.0.0.1 and writes it on stdout.
+# Each event is appended to log_file as one line:
+#   CONNECT
+#   AUTH <mechanism>
+#   MAIL <from> <to> <content in hexadecimal>
+#   QUIT
+
+import base64
+import socket
+import ssl
+import sys
+import threading
+
+if len(sys.argv) < 6:
+	sys.exit(2)
+
+cert_file, key_file, user, password, log_filename = sys.argv[1:6]
+implicit_tls = "--implicit-tls" in sys.argv
+pipelining = "--pipelining" in sys.argv
+drop_after = None
+reject = None
+for i, arg in enumerate(sys.argv):
+	if arg == "--drop-after":
+		drop_after = int(sys.argv[i + 1])
+	elif arg == "--reject":
+		reject = sys.argv[i + 1]
+
+context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+context.load_cert_chain(cert_file, key_file)
+log_lock = threading.Lock()
+
+def log(line):
+	with log_lock:
+		with open(log_filename, "a") as log_file:
+			log_file.write(line + "\n")
+
+class Connection:
+	def __init__(self, sock):
+		self.sock = sock
+		self.file = sock.makefile("rb")
+		self.held = []
+
+	def start_tls(self):
+		self.file.close()
+		self.sock = context.wrap_socket(self.sock, server_side=True)
+		self.file = self.sock.makefile("rb")
+
+	def send(self, line):
+		self.held.append(line + "\r\n")
+		self.sock.sendall("".join(self.held).encode("latin1"))
+		self.held = []
+
+	def hold(self, line):
+		self.held.append(line + "\r\n")
+
+	def recv(self):
+		line = self.file.readline()
+		if not line:
+			raise EOFError
+		if not line.endswith(b"\r\n"):
+			raise ValueError("line not ended in CRLF")
+		return line[:-2].decode("latin1")
+
+def ehlo(conn, tls):
+	conn.send("250-fake.smtp.server")
+	if tls:
+		conn.send("250-AUTH LOGIN PLAIN")
+	else:
+		conn.send("250-STARTTLS")
+	if pipelining:
+		conn.send("250-PIPELINING")
+	conn.send("250 8BITMIME")
+
+def serve(sock):
+	conn = Connection(sock)
+	tls = False
+	logged_in = False
+	mail_from = None
+	rcpt_to = None
+	num_mails = 0
+	reply = conn.hold if pipelining else conn.send
+	log("CONNECT")
+	try:
+		if implicit_tls:
+			conn.start_tls()
+			tls = True
+		conn.send("220 fake.smtp.server ESMTP")
+		while True:
+			line = conn.recv()
+			verb = line.split(" ")[0].upper()
+			if verb == "EHLO":
+				ehlo(conn, tls)
+			elif verb == "STARTTLS" and not tls:
+				conn.send("220 Ready to start TLS")
+				conn.start_tls()
+				tls = True
+			elif verb == "AUTH" and tls:
+				words = line.split(" ")
+				if words[1].upper() == "PLAIN":
+					credentials = base64.b64decode(words[2]).split(b"\0")
+					ok = credentials[1:] == [user.encode(), password.encode()]
+				else:
+					conn.send("334 VXNlcm5hbWU6")
+					got_user = base64.b64decode(conn.recv())
+					conn.send("334 UGFzc3dvcmQ6")
+					got_password = base64.b64decode(conn.recv())
+					ok = (got_user, got_password) == (user.encode(), password.encode())
+				if ok:
+					logged_in = True
+					log("AUTH " + words[1].upper())
+					conn.send("235 Authentication successful")
+				else:
+					conn.send("535 Authentication failed")
+			elif verb == "MAIL" and logged_in:
+				mail_from = line[10:].strip("<>")
+				reply("250 OK")
+			elif verb == "RCPT" and mail_from is not None:
+				address = line[8:].strip("<>")
+				if address == reject:
+					reply("550 No such user")
+				else:
+					rcpt_to = address
+					reply("250 OK")
+			elif verb == "DATA" and rcpt_to is not None:
+				conn.send("354 End data with <CR><LF>.<CR><LF>")
+				lines = []
+				while True:
+					data_line = conn.recv()
+					if data_line == ".":
+						break
+					if data_line.startswith("."):
+						data_line = data_line[1:]
+					lines.append(data_line)
+				content = "\n".join(lines).split("\n\n", 1)[1]
+				log("MAIL %s %s %s" % (mail_from, rcpt_to,
+				                       content.encode("latin1").hex()))
+				conn.send("250 OK queued")
+				mail_from = rcpt_to = None
+				num_mails += 1
+				if drop_after is not None and num_mails >= drop_after:
+					break
+			elif verb == "RSET":
+				mail_from = rcpt_to = None
+				conn.send("250 OK")
+			elif verb == "QUIT":
+				log("QUIT")
+				conn.send("221 Bye")
+				break
+			else:
+				conn.send("503 Bad sequence of commands")
+	except (EOFError, ValueError, OSError, ssl.SSLError):
+		pass
+	conn.sock.close()
+
+listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+listener.bind(("127.0.0.1", 0))
+listener.listen(8)
+print(listener.getsockname()[1])
+sys.stdout.flush()
+while True:
+	sock, address = listener.accept()
+	threading.Thread(target=serve, args=(sock,), daemon=True).start()
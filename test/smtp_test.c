@@ -0,0 +1,253 @@
+// smtp_test.c: test of swad_smtp.c against smtp_fake_server.py
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Canas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Usage:
+//   smtp_test port user password log_file batch|reject|drop|badpass [implicit-tls]
+// Run by smtp_test.sh, which starts the fake server for each scenario.
+// Exit 0 if the scenario gives the expected results.
+
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../swad_smtp.h"
+
+/*****************************************************************************/
+/***************************** Private constants *****************************/
+/*****************************************************************************/
+
+#define NUM_MAILS 5
+
+// Content with dots at start of line, a CRLF line end
+// and no line end at the end
+static const char *Content = "First line\n"
+			     ".Line starting with a dot\n"
+			     "..\n"
+			     "Line ended in CRLF\r\n"
+			     "Last line without end";
+static const char *ExpectedContent = "First line\n"
+				     ".Line starting with a dot\n"
+				     "..\n"
+				     "Line ended in CRLF\n"
+				     "Last line without end";
+
+/*****************************************************************************/
+/***************************** Private variables *****************************/
+/*****************************************************************************/
+
+static const char *Port;
+static const char *User;
+static const char *Password;
+static const char *LogFileName;
+static bool ImplicitTLS;
+
+/*****************************************************************************/
+/***************************** Private prototypes ****************************/
+/*****************************************************************************/
+
+static SMTP_Result_t Send (struct SMTP_Session *Session,const char *To);
+static void CountLog (unsigned *NumConnections,unsigned *NumMails,
+                      unsigned *NumMailsOK);
+static int Check (const char *What,unsigned Value,unsigned Expected);
+
+/*****************************************************************************/
+/********************************* Main **************************************/
+/*****************************************************************************/
+
+int main (int argc,char *argv[])
+  {
+   struct SMTP_Session Session;
+   unsigned NumMail;
+   unsigned NumConnections;
+   unsigned NumMails;
+   unsigned NumMailsOK;
+   unsigned NumReconnections = 0;
+   int Errors = 0;
+   SMTP_Result_t Result;
+
+   if (argc < 6)
+     {
+      fprintf (stderr,"Usage: %s port user password log_file scenario\n",argv[0]);
+      return 2;
+     }
+   Port        = argv[1];
+   User        = argv[2];
+   Password    = argv[3];
+   LogFileName = argv[4];
+   ImplicitTLS = (argc > 6 && !strcmp (argv[6],"implicit-tls"));
+
+   if (!strcmp (argv[5],"badpass"))
+     {
+      /***** Wrong password: session must not be opened *****/
+      if (SMTP_Open (&Session,"localhost",Port,ImplicitTLS,User,"wrong password"))
+	{
+	 fprintf (stderr,"Session opened with wrong password\n");
+	 return 1;
+	}
+      return 0;
+     }
+
+   if (!SMTP_Open (&Session,"localhost",Port,ImplicitTLS,User,Password))
+     {
+      fprintf (stderr,"Can not open session\n");
+      return 1;
+     }
+
+   if (!strcmp (argv[5],"batch"))
+     {
+      /***** All emails in only one session *****/
+      for (NumMail = 0;
+	   NumMail < NUM_MAILS;
+	   NumMail++)
+	 Errors += Check ("result",Send (&Session,"user@example.com"),SMTP_OK);
+      SMTP_Close (&Session);
+
+      CountLog (&NumConnections,&NumMails,&NumMailsOK);
+      Errors += Check ("connections",NumConnections,1);
+      Errors += Check ("emails",NumMails,NUM_MAILS);
+      Errors += Check ("emails with right content",NumMailsOK,NUM_MAILS);
+     }
+   else if (!strcmp (argv[5],"reject"))
+     {
+      /***** A rejected recipient must not close the session *****/
+      Errors += Check ("result",Send (&Session,"user@example.com"),SMTP_OK);
+      Errors += Check ("result",Send (&Session,"rejected@example.com"),SMTP_MAIL_REJECTED);
+      Errors += Check ("result",Send (&Session,"user@example.com"),SMTP_OK);
+      SMTP_Close (&Session);
+
+      CountLog (&NumConnections,&NumMails,&NumMailsOK);
+      Errors += Check ("connections",NumConnections,1);
+      Errors += Check ("emails",NumMails,2);
+     }
+   else if (!strcmp (argv[5],"drop"))
+     {
+      /***** Server closes the connection after 2 emails,
+             so the session must be opened again *****/
+      for (NumMail = 0;
+	   NumMail < NUM_MAILS;
+	   NumMail++)
+	{
+	 if ((Result = Send (&Session,"user@example.com")) == SMTP_CONNECTION_ERROR)
+	   {
+	    NumReconnections++;
+	    SMTP_Close (&Session);	// Must be harmless after connection error
+	    if (!SMTP_Open (&Session,"localhost",Port,ImplicitTLS,User,Password))
+	      {
+	       fprintf (stderr,"Can not open session again\n");
+	       return 1;
+	      }
+	    Result = Send (&Session,"user@example.com");
+	   }
+	 Errors += Check ("result",Result,SMTP_OK);
+	}
+      SMTP_Close (&Session);
+
+      CountLog (&NumConnections,&NumMails,&NumMailsOK);
+      Errors += Check ("reconnections",NumReconnections,2);
+      Errors += Check ("connections",NumConnections,3);
+      Errors += Check ("emails",NumMails,NUM_MAILS);
+      Errors += Check ("emails with right content",NumMailsOK,NUM_MAILS);
+     }
+   else
+     {
+      fprintf (stderr,"Unknown scenario %s\n",argv[5]);
+      return 2;
+     }
+
+   return Errors ? 1 :
+		   0;
+  }
+
+/*****************************************************************************/
+/************************** Send the test email ******************************/
+/*****************************************************************************/
+
+static SMTP_Result_t Send (struct SMTP_Session *Session,const char *To)
+  {
+   FILE *FileContent;
+   SMTP_Result_t Result;
+
+   if ((FileContent = tmpfile ()) == NULL)
+     {
+      perror ("tmpfile");
+      exit (2);
+     }
+   fputs (Content,FileContent);
+   rewind (FileContent);
+
+   Result = SMTP_SendMail (Session,User,To,"[SWAD] Test",FileContent);
+   fclose (FileContent);
+
+   return Result;
+  }
+
+/*****************************************************************************/
+/******************* Count events written by fake server *********************/
+/*****************************************************************************/
+
+static void CountLog (unsigned *NumConnections,unsigned *NumMails,
+                      unsigned *NumMailsOK)
+  {
+   FILE *LogFile;
+   char Line[4096];
+   char Hex[4096];
+   char ExpectedHex[4096];
+   size_t i;
+
+   for (i = 0;
+	ExpectedContent[i];
+	i++)
+      sprintf (&ExpectedHex[2 * i],"%02x",(unsigned char) ExpectedContent[i]);
+
+   *NumConnections = *NumMails = *NumMailsOK = 0;
+   if ((LogFile = fopen (LogFileName,"rb")) == NULL)
+      return;
+   while (fgets (Line,sizeof (Line),LogFile))
+      if (!strncmp (Line,"CONNECT",7))
+	 (*NumConnections)++;
+      else if (sscanf (Line,"MAIL %*s %*s %4095s",Hex) == 1)
+	{
+	 (*NumMails)++;
+	 if (!strcmp (Hex,ExpectedHex))
+	    (*NumMailsOK)++;
+	}
+   fclose (LogFile);
+  }
+
+/*****************************************************************************/
+/****************** Check a value and report if wrong ************************/
+/*****************************************************************************/
+
+static int Check (const char *What,unsigned Value,unsigned Expected)
+  {
+   if (Value == Expected)
+      return 0;
+
+   fprintf (stderr,"Wrong %s: %u (expected %u)\n",What,Value,Expected);
+   return 1;
+  }
@@ -0,0 +1,51 @@
+#!/bin/bash
+#
+# smtp_test.sh: test swad_smtp.c against a fake SMTP server
+#
+# Usage: ./smtp_test.sh (from this directory, after "make smtp_test")
+# Needs python3 and openssl to create a self-signed certificate.
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+# Self-signed certificate for localhost,
+# trusted by the client through SSL_CERT_FILE
+openssl req -x509 -newkey rsa:2048 -nodes -days 1 -subj "/CN=localhost" \
+	-addext "subjectAltName=DNS:localhost" \
+	-keyout "$WORKDIR/key.pem" -out "$WORKDIR/cert.pem" 2>/dev/null || exit 2
+export SSL_CERT_FILE="$WORKDIR/cert.pem"
+
+FAILED=0
+NUMRUN=0
+
+# Run one scenario: name, then options for the fake server
+run ()
+{
+	SCENARIO=$1
+	shift
+	NUMRUN=$((NUMRUN + 1))
+	LOG="$WORKDIR/$NUMRUN.log"
+	coproc SERVER { exec python3 ./smtp_fake_server.py "$WORKDIR/cert.pem" "$WORKDIR/key.pem" \
+		swad@example.com secret "$LOG" "$@"; }
+	read -r PORT <&"${SERVER[0]}"
+	TLS=
+	[ "$1" = "--implicit-tls" ] && TLS=implicit-tls
+	if ./smtp_test "$PORT" swad@example.com secret "$LOG" "$SCENARIO" $TLS; then
+		echo "PASS: $SCENARIO $*"
+	else
+		echo "FAIL: $SCENARIO $*"
+		FAILED=1
+	fi
+	kill "$SERVER_PID"
+	wait "$SERVER_PID" 2>/dev/null
+}
+
+run batch
+run batch --implicit-tls
+run batch --pipelining
+run reject --reject rejected@example.com
+run reject --pipelining --reject rejected@example.com
+run drop --drop-after 2
+run badpass
+
+exit $FAILED
@@ -0,0 +1,565 @@
+// test_import_bench.c: benchmark of the import of test questions from XML
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Canas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Usage:
+//   test_import_bench generate NumQsts File
+//   test_import_bench parse File
+//   SWAD_DB_PASSWORD=... test_import_bench import CrsCod File
+// "generate" writes a synthetic XML file of test questions
+// with NumQsts questions of all the types, with tags,
+// feedback and options, as exported by SWAD.
+// "parse" reads the file with XML_ParseFile
+// and shows the time spent and the peak memory used.
+// It does not need a database.
+// "import" must be run in a test server with a copy of the database
+// of SWAD (host, user and database in swad_config.h),
+// with write permission in Cfg_PATH_TEST_PRIVATE.
+// It imports the file twice in the course CrsCod
+// calling TsI_ImportQstsFromXML, as when a teacher uploads it,
+// first with new questions and then with questions already existing,
+// shows the time spent, and removes the questions and tags imported.
+// Exit 0 if all the questions are imported.
+
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../swad_alert.h"
+#include "../swad_box.h"
+#include "../swad_database.h"
+#include "../swad_file.h"
+#include "../swad_global.h"
+#include "../swad_icon.h"
+#include "../swad_media.h"
+#include "../swad_test.h"
+#include "../swad_test_import.h"
+#include "../swad_xml.h"
+
+/*****************************************************************************/
+/************************** Private constants ********************************/
+/*****************************************************************************/
+
+#define NUM_TAGS	50	// Tags are chosen from tag00, tag01...
+
+/*****************************************************************************/
+/****************** Global variables and functions used by *******************/
+/*************** swad_test_import.c, swad_test.c, swad_tag.c... **************/
+/*****************************************************************************/
+
+struct Globals Gbl;
+
+static const char *BenchFile;			// File imported by Fil_EndReceptionOfFile
+static Ale_AlertType_t LastAlertType = Ale_NONE;
+
+void Lay_ShowErrorAndExit (const char *Txt)
+  {
+   fprintf (stderr,"%s\n",Txt ? Txt :
+				"Error.");
+   exit (2);
+  }
+
+void Lay_NotEnoughMemoryExit (void)
+  {
+   Lay_ShowErrorAndExit ("Not enough memory.");
+  }
+
+void Ale_CreateAlert (Ale_AlertType_t Type,const char *Section,
+                      const char *fmt,...)
+  {
+   (void) Section;
+   (void) fmt;
+
+   LastAlertType = Type;
+  }
+
+Ale_AlertType_t Ale_GetTypeOfLastAlert (void)
+  {
+   return LastAlertType;
+  }
+
+void Ale_ShowAlertsAndExit ()
+  {
+   Lay_ShowErrorAndExit ("Alert.");
+  }
+
+void Ale_ShowAlert (Ale_AlertType_t AlertType,const char *fmt,...)
+  {
+   va_list ap;
+
+   if (AlertType == Ale_ERROR)
+     {
+      va_start (ap,fmt);
+      vfprintf (stderr,fmt,ap);
+      va_end (ap);
+      fprintf (stderr,"\n");
+     }
+  }
+
+void Box_BoxBegin (const char *Width,const char *Title,
+                   void (*FunctionToDrawContextualIcons) (void *Args),void *Args,
+                   const char *HelpLink,Box_Closable_t Closable)
+  {
+   (void) Width;
+   (void) Title;
+   (void) FunctionToDrawContextualIcons;
+   (void) Args;
+   (void) HelpLink;
+   (void) Closable;
+  }
+
+void Box_BoxEnd (void)
+  {
+  }
+
+void Ico_PutIcon (const char *Icon,const char *Title,const char *Class)
+  {
+   (void) Icon;
+   (void) Title;
+   (void) Class;
+  }
+
+void Ico_PutIconNotVisible (void)
+  {
+  }
+
+void Med_MediaConstructor (struct Media *Media)
+  {
+   Media->MedCod  = -1L;
+   Media->Action  = Med_ACTION_NO_MEDIA;
+   Media->Status  = Med_STATUS_NONE;
+   Media->Name[0] = '\0';
+   Media->Type    = Med_TYPE_NONE;
+   Media->URL     = NULL;
+   Media->Title   = NULL;
+  }
+
+void Med_MediaDestructor (struct Media *Media)
+  {
+   (void) Media;
+  }
+
+void Fil_CreateDirIfNotExists (const char Path[PATH_MAX + 1])
+  {
+   mkdir (Path,(mode_t) 0xFFF);
+  }
+
+struct Param *Fil_StartReceptionOfFile (const char *ParamFile,
+                                        char *FileName,char *MIMEType)
+  {
+   (void) ParamFile;
+
+   snprintf (FileName,PATH_MAX + 1,"%s",BenchFile);
+   strcpy (MIMEType,"text/xml");
+   return NULL;
+  }
+
+bool Fil_EndReceptionOfFile (char *FileNameDataTmp,struct Param *Param)
+  {
+   char AbsPath[PATH_MAX + 1];
+
+   (void) Param;
+
+   /* The file received is the benchmark file */
+   unlink (FileNameDataTmp);
+   return realpath (BenchFile,AbsPath) &&
+	  !symlink (AbsPath,FileNameDataTmp);
+  }
+
+/*****************************************************************************/
+/********************************* Timing ************************************/
+/*****************************************************************************/
+
+static double Seconds (void)
+  {
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + (double) ts.tv_nsec / 1E9;
+  }
+
+/*****************************************************************************/
+/******************** Generate a synthetic XML test file *********************/
+/*****************************************************************************/
+
+static void WriteTags (FILE *FileXML,unsigned NumQst)
+  {
+   unsigned NumTags = 1 + NumQst % 3;
+   unsigned NumTag;
+
+   fprintf (FileXML,"<tags>\n");
+   for (NumTag = 0;
+	NumTag < NumTags;
+	NumTag++)
+      fprintf (FileXML,"<tag>tag%02u</tag>\n",
+	       (NumQst * 7 + NumTag * 13) % NUM_TAGS);
+   fprintf (FileXML,"</tags>\n");
+  }
+
+static void WriteOptions (FILE *FileXML,unsigned NumQst,
+                          unsigned NumOpts,unsigned NumCorrect,bool Text)
+  {
+   unsigned NumOpt;
+
+   for (NumOpt = 0;
+	NumOpt < NumOpts;
+	NumOpt++)
+     {
+      if (Text)
+	 fprintf (FileXML,"<option>");
+      else
+	 fprintf (FileXML,"<option correct=\"%s\">",
+		  NumOpt < NumCorrect ? "yes" :
+				        "no");
+      fprintf (FileXML,"<text>Answer %u of question %u</text>"
+		       "<feedback>Feedback of answer %u, explaining"
+		       " why it is %s</feedback>"
+		       "</option>\n",
+	       NumOpt + 1,NumQst,
+	       NumOpt + 1,NumOpt < NumCorrect || Text ? "correct" :
+						        "wrong");
+     }
+  }
+
+static bool Generate (unsigned NumQsts,const char *FileName)
+  {
+   extern const char *Tst_StrAnswerTypesXML[Tst_NUM_ANS_TYPES];
+   FILE *FileXML;
+   unsigned NumQst;
+   Tst_AnswerType_t AnsType;
+
+   if ((FileXML = fopen (FileName,"wb")) == NULL)
+      return false;
+
+   fprintf (FileXML,"<?xml version=\"1.0\" encoding=\"windows-1252\"?>\n"
+		    "<test>\n");
+   for (NumQst = 1;
+	NumQst <= NumQsts;
+	NumQst++)
+     {
+      AnsType = (Tst_AnswerType_t) (NumQst % Tst_NUM_ANS_TYPES);
+      fprintf (FileXML,"<question type=\"%s\">\n",
+	       Tst_StrAnswerTypesXML[AnsType]);
+      WriteTags (FileXML,NumQst);
+      fprintf (FileXML,"<stem>Question %u: stem of a synthetic question,"
+		       " long enough to look like a real one,"
+		       " with several sentences.\n"
+		       "Second line of the stem.</stem>\n"
+		       "<feedback>Feedback of question %u.</feedback>\n",
+	       NumQst,NumQst);
+      switch (AnsType)
+	{
+	 case Tst_ANS_INT:
+	    fprintf (FileXML,"<answer>%u</answer>\n",NumQst);
+	    break;
+	 case Tst_ANS_FLOAT:
+	    fprintf (FileXML,"<answer><lower>%u.5</lower><upper>%u.5</upper></answer>\n",
+		     NumQst,NumQst + 1);
+	    break;
+	 case Tst_ANS_TRUE_FALSE:
+	    fprintf (FileXML,"<answer>%s</answer>\n",
+		     NumQst % 2 ? "true" :
+				  "false");
+	    break;
+	 case Tst_ANS_UNIQUE_CHOICE:
+	    fprintf (FileXML,"<answer shuffle=\"yes\">\n");
+	    WriteOptions (FileXML,NumQst,4,1,false);
+	    fprintf (FileXML,"</answer>\n");
+	    break;
+	 case Tst_ANS_MULTIPLE_CHOICE:
+	    fprintf (FileXML,"<answer shuffle=\"no\">\n");
+	    WriteOptions (FileXML,NumQst,5,2,false);
+	    fprintf (FileXML,"</answer>\n");
+	    break;
+	 case Tst_ANS_TEXT:
+	    fprintf (FileXML,"<answer>\n");
+	    WriteOptions (FileXML,NumQst,2,0,true);
+	    fprintf (FileXML,"</answer>\n");
+	    break;
+	 default:
+	    break;
+	}
+      fprintf (FileXML,"</question>\n");
+     }
+   fprintf (FileXML,"</test>\n");
+
+   return fclose (FileXML) == 0;
+  }
+
+/*****************************************************************************/
+/********************** Parse an XML file without database *******************/
+/*****************************************************************************/
+
+struct Counts
+  {
+   unsigned long NumElements;
+   unsigned long NumQsts;
+   unsigned long BytesContent;
+  };
+
+static void CountStartElement (void *CountsPtr,unsigned Level,const char *TagName,
+                               const struct XMLAttribute Attributes[XML_MAX_ATTRIBUTES],
+                               unsigned NumAttributes)
+  {
+   struct Counts *Counts = (struct Counts *) CountsPtr;
+
+   (void) Attributes;
+   (void) NumAttributes;
+
+   Counts->NumElements++;
+   if (Level == 2 && !strcmp (TagName,"question"))
+      Counts->NumQsts++;
+  }
+
+static void CountContent (void *CountsPtr,unsigned Level,const char *TagName,
+                          const char *Content)
+  {
+   struct Counts *Counts = (struct Counts *) CountsPtr;
+
+   (void) Level;
+   (void) TagName;
+
+   Counts->BytesContent += strlen (Content);
+  }
+
+static bool Parse (const char *FileName)
+  {
+   static const struct XMLHandlers CountHandlers =
+     {
+      .StartElement = CountStartElement,
+      .Content      = CountContent,
+      .EndElement   = NULL,
+     };
+   FILE *FileXML;
+   struct stat FileStatus;
+   struct Counts Counts = {0,0,0};
+   struct rusage Usage;
+   double Start;
+   double Time;
+
+   if ((FileXML = fopen (FileName,"rb")) == NULL ||
+       fstat (fileno (FileXML),&FileStatus))
+      return false;
+
+   Start = Seconds ();
+   XML_ParseFile (FileXML,&CountHandlers,&Counts);
+   Time = Seconds () - Start;
+   fclose (FileXML);
+
+   getrusage (RUSAGE_SELF,&Usage);
+   printf ("%lu questions, %lu elements, %lu bytes of content\n"
+	   "%.1f MiB parsed in %.3f s (%.1f MiB/s, %.0f questions/s),"
+	   " peak memory %ld KiB\n",
+	   Counts.NumQsts,Counts.NumElements,Counts.BytesContent,
+	   (double) FileStatus.st_size / (1024.0 * 1024.0),Time,
+	   Time > 0.0 ? (double) FileStatus.st_size / (1024.0 * 1024.0) / Time :
+			0.0,
+	   Time > 0.0 ? (double) Counts.NumQsts / Time :
+			0.0,
+	   Usage.ru_maxrss);
+   return Counts.NumQsts != 0;
+  }
+
+/*****************************************************************************/
+/************************ Import an XML file in a course *********************/
+/*****************************************************************************/
+
+static void ShowEngines (void)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+   unsigned long NumRows;
+   unsigned long NumRow;
+
+   NumRows = DB_QuerySELECT (&mysql_res,"can not get engines",
+			     "SELECT TABLE_NAME,ENGINE"
+			     " FROM information_schema.TABLES"
+			     " WHERE TABLE_SCHEMA=DATABASE()"
+			     " AND TABLE_NAME IN"
+			     " ('tst_questions','tst_answers',"
+			     "'tst_tags','tst_question_tags')"
+			     " ORDER BY TABLE_NAME");
+   for (NumRow = 0;
+	NumRow < NumRows;
+	NumRow++)
+     {
+      row = mysql_fetch_row (mysql_res);
+      printf ("%s: %s\n",row[0],row[1]);
+     }
+   DB_FreeMySQLResult (&mysql_res);
+  }
+
+static double ImportFile (long CrsCod,long LastQstCod,unsigned *NumQsts)
+  {
+   double Start;
+   double Time;
+
+   Start = Seconds ();
+   TsI_ImportQstsFromXML ();
+   Time = Seconds () - Start;
+
+   *NumQsts = DB_QueryCOUNT ("can not count questions",
+			     "SELECT COUNT(*) FROM tst_questions"
+			     " WHERE CrsCod=%ld AND QstCod>%ld",
+			     CrsCod,LastQstCod);
+   return Time;
+  }
+
+static void RemoveImported (long CrsCod,long LastQstCod,long LastTagCod)
+  {
+   DB_QueryDELETE ("can not remove answers",
+		   "DELETE FROM tst_answers"
+		   " USING tst_questions,tst_answers"
+		   " WHERE tst_questions.CrsCod=%ld"
+		   " AND tst_questions.QstCod>%ld"
+		   " AND tst_questions.QstCod=tst_answers.QstCod",
+		   CrsCod,LastQstCod);
+   DB_QueryDELETE ("can not remove tags of questions",
+		   "DELETE FROM tst_question_tags"
+		   " USING tst_questions,tst_question_tags"
+		   " WHERE tst_questions.CrsCod=%ld"
+		   " AND tst_questions.QstCod>%ld"
+		   " AND tst_questions.QstCod=tst_question_tags.QstCod",
+		   CrsCod,LastQstCod);
+   DB_QueryDELETE ("can not remove questions",
+		   "DELETE FROM tst_questions"
+		   " WHERE CrsCod=%ld AND QstCod>%ld",
+		   CrsCod,LastQstCod);
+   DB_QueryDELETE ("can not remove tags",
+		   "DELETE FROM tst_tags"
+		   " WHERE CrsCod=%ld AND TagCod>%ld",
+		   CrsCod,LastTagCod);
+  }
+
+static bool Import (long CrsCod,const char *FileName,unsigned NumQstsInFile)
+  {
+   char FileNameXMLTmp[PATH_MAX + 1];
+   long LastQstCod;
+   long LastTagCod;
+   unsigned NumQstsNew;
+   unsigned NumQstsExisting;
+   double TimeNew;
+   double TimeExisting;
+
+   /***** Output of HTML is discarded *****/
+   if ((Gbl.F.Out = fopen ("/dev/null","wb")) == NULL)
+      return false;
+   Gbl.Hierarchy.Crs.CrsCod = CrsCod;
+   snprintf (Gbl.UniqueNameEncrypted,sizeof (Gbl.UniqueNameEncrypted),
+	     "test_import_bench_%d",(int) getpid ());
+   BenchFile = FileName;
+
+   ShowEngines ();
+   LastQstCod = (long) DB_QueryCOUNT ("can not get last question",
+				      "SELECT COALESCE(MAX(QstCod),0)"
+				      " FROM tst_questions");
+   LastTagCod = (long) DB_QueryCOUNT ("can not get last tag",
+				      "SELECT COALESCE(MAX(TagCod),0)"
+				      " FROM tst_tags");
+
+   /***** Import new questions and then the same questions again *****/
+   TimeNew      = ImportFile (CrsCod,LastQstCod,&NumQstsNew);
+   TimeExisting = ImportFile (CrsCod,LastQstCod,&NumQstsExisting);
+   printf ("%u new questions imported in %.3f s (%.0f questions/s)\n"
+	   "%u existing questions checked in %.3f s (%.0f questions/s)\n",
+	   NumQstsNew,TimeNew,
+	   TimeNew > 0.0 ? (double) NumQstsNew / TimeNew :
+			   0.0,
+	   NumQstsInFile,TimeExisting,
+	   TimeExisting > 0.0 ? (double) NumQstsInFile / TimeExisting :
+				0.0);
+
+   /***** Remove questions, tags and temporary file *****/
+   RemoveImported (CrsCod,LastQstCod,LastTagCod);
+   snprintf (FileNameXMLTmp,sizeof (FileNameXMLTmp),
+	     "%s/%s.xml",
+	     Cfg_PATH_TEST_PRIVATE,Gbl.UniqueNameEncrypted);
+   unlink (FileNameXMLTmp);
+   fclose (Gbl.F.Out);
+
+   return NumQstsNew == NumQstsInFile &&
+	  NumQstsExisting == NumQstsInFile;
+  }
+
+/*****************************************************************************/
+/*********************************** Main ************************************/
+/*****************************************************************************/
+
+static unsigned CountQstsInFile (const char *FileName)
+  {
+   static const struct XMLHandlers CountHandlers =
+     {
+      .StartElement = CountStartElement,
+      .Content      = NULL,
+      .EndElement   = NULL,
+     };
+   FILE *FileXML;
+   struct Counts Counts = {0,0,0};
+
+   if ((FileXML = fopen (FileName,"rb")) == NULL)
+      Lay_ShowErrorAndExit ("Can not open XML file.");
+   XML_ParseFile (FileXML,&CountHandlers,&Counts);
+   fclose (FileXML);
+   return (unsigned) Counts.NumQsts;
+  }
+
+int main (int argc,char *argv[])
+  {
+   const char *Password = getenv ("SWAD_DB_PASSWORD");
+   bool Ok = false;
+
+   if (argc == 4 && !strcmp (argv[1],"generate"))
+      Ok = Generate ((unsigned) atoi (argv[2]),argv[3]);
+   else if (argc == 3 && !strcmp (argv[1],"parse"))
+      Ok = Parse (argv[2]);
+   else if (argc == 4 && !strcmp (argv[1],"import") && Password)
+     {
+      Gbl.PID = getpid ();
+      Gbl.StartExecutionTimeUTC = time (NULL);
+      snprintf (Gbl.Config.DatabasePassword,sizeof (Gbl.Config.DatabasePassword),
+		"%s",Password);
+      DB_OpenDBConnection ();
+      Ok = Import (atol (argv[2]),argv[3],CountQstsInFile (argv[3]));
+      DB_CloseDBConnection ();
+     }
+   else
+     {
+      fprintf (stderr,"Usage: %s generate NumQsts File\n"
+		      "       %s parse File\n"
+		      "       SWAD_DB_PASSWORD=... %s import CrsCod File\n",
+	       argv[0],argv[0],argv[0]);
+      return 2;
+     }
+
+   return Ok ? 0 :
+	       1;
+  }
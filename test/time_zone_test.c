@@ -0,0 +1,410 @@
+// time_zone_test.c: test of changes of UTC offset got in swad_date.c
+
+/*
+    SWAD (Shared Workspace At a Distance),
+    is a web platform developed at the University of Granada (Spain),
+    and used to support university teaching.
+
+    This file is part of SWAD core.
+    Copyright (C) 1999-2020 Antonio Canas Vargas
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Usage:
+//   time_zone_test os StartYear EndYear TimeZone...
+//   SWAD_DB_PASSWORD=... time_zone_test db StartYear EndYear TimeZone...
+// "os" compares the changes of UTC offset got by Dat_GetTimeZoneChanges
+// with the offset got from the operating system every five minutes.
+// It is run by time_zone_test.sh ("make check").
+// "db" compares the local times got with Dat_BuildLocalTimeExpression
+// with the ones got with CONVERT_TZ, as statistics did before,
+// around each change and every hour of the range,
+// and shows the time spent by both ways.
+// Run it in a test server with the time zone tables of MySQL loaded
+// (mysql_tzinfo_to_sql /usr/share/zoneinfo | mysql -u root mysql)
+// and the database of SWAD (host, user and database in swad_config.h).
+// Exit 0 if times are equal.
+
+/*****************************************************************************/
+/********************************* Headers ***********************************/
+/*****************************************************************************/
+
+#include <mysql/mysql.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../swad_config.h"
+#include "../swad_date.h"
+
+/*****************************************************************************/
+/************************** Private constants ********************************/
+/*****************************************************************************/
+
+#define SECONDS_PER_SAMPLE_OS	(5 * 60)	// Offset is checked every five minutes
+#define SECONDS_PER_SAMPLE_DB	(60 * 60)	// Local time is checked every hour
+#define MAX_TIMES_IN_INSERT	1000
+
+/*****************************************************************************/
+/********************* Functions used by swad_date.c *************************/
+/*****************************************************************************/
+
+void Lay_NotEnoughMemoryExit (void)
+  {
+   fprintf (stderr,"Not enough memory.\n");
+   exit (2);
+  }
+
+/*****************************************************************************/
+/********************************* Timing ************************************/
+/*****************************************************************************/
+
+static double Seconds (void)
+  {
+   struct timespec ts;
+
+   clock_gettime (CLOCK_MONOTONIC,&ts);
+   return (double) ts.tv_sec + (double) ts.tv_nsec / 1E9;
+  }
+
+/*****************************************************************************/
+/******************* Get UTC time of January 1st of a year *******************/
+/*****************************************************************************/
+
+static time_t StartOfYearUTC (unsigned Year)
+  {
+   struct tm tm;
+
+   memset (&tm,0,sizeof (tm));
+   tm.tm_year = (int) Year - 1900;
+   tm.tm_mday = 1;
+   return timegm (&tm);
+  }
+
+/*****************************************************************************/
+/************* Get the offset of a time from the list of changes *************/
+/*****************************************************************************/
+
+static long OffsetFromChanges (const struct Dat_TimeZoneChanges *Changes,
+                               time_t TimeUTC)
+  {
+   unsigned NumChange;
+
+   for (NumChange = Changes->Num - 1;
+	NumChange > 0 && TimeUTC < Changes->TimeUTC[NumChange];
+	NumChange--);
+   return Changes->Offset[NumChange];
+  }
+
+/*****************************************************************************/
+/******** Get the offset of a time from the OS for a named time zone *********/
+/*****************************************************************************/
+
+static long OffsetFromOS (time_t TimeUTC)
+  {
+   struct tm tm;
+
+   localtime_r (&TimeUTC,&tm);
+   return tm.tm_gmtoff;
+  }
+
+/*****************************************************************************/
+/********** Compare changes of a time zone with the operating system *********/
+/*****************************************************************************/
+
+static bool CheckTimeZoneInOS (const char *TimeZone,
+                               time_t StartTimeUTC,time_t EndTimeUTC)
+  {
+   struct Dat_TimeZoneChanges Changes;
+   char TZ[1 + Dat_MAX_BYTES_TIME_ZONE + 1];
+   unsigned NumChange;
+   time_t Time;
+   double Start;
+   double Elapsed;
+   bool Ok = true;
+
+   /***** Get changes *****/
+   Start = Seconds ();
+   if (!Dat_GetTimeZoneChanges (TimeZone,StartTimeUTC,EndTimeUTC,&Changes))
+     {
+      printf ("FAIL: %s: time zone unknown or too many changes\n",TimeZone);
+      return false;
+     }
+   Elapsed = Seconds () - Start;
+
+   /***** Fixed offsets are not in the tz database *****/
+   if (TimeZone[0] == '+' ||
+       TimeZone[0] == '-')
+     {
+      printf ("%s: %s: offset %ld\n",
+	      Changes.Num == 1 ? "PASS" :
+				 "FAIL",
+	      TimeZone,Changes.Offset[0]);
+      return Changes.Num == 1;
+     }
+
+   /***** Set the time zone in this process *****/
+   snprintf (TZ,sizeof (TZ),":%s",TimeZone);
+   setenv ("TZ",TZ,1);
+   tzset ();
+
+   /***** Each change must be at the exact second *****/
+   if (Changes.Offset[0] != OffsetFromOS (StartTimeUTC))
+     {
+      printf ("FAIL: %s: wrong offset at start\n",TimeZone);
+      Ok = false;
+     }
+   for (NumChange = 1;
+	Ok && NumChange < Changes.Num;
+	NumChange++)
+      if (Changes.Offset[NumChange - 1] != OffsetFromOS (Changes.TimeUTC[NumChange] - 1) ||
+	  Changes.Offset[NumChange    ] != OffsetFromOS (Changes.TimeUTC[NumChange]    ))
+	{
+	 printf ("FAIL: %s: wrong change at %ld\n",
+		 TimeZone,(long) Changes.TimeUTC[NumChange]);
+	 Ok = false;
+	}
+
+   /***** No change must be missed *****/
+   for (Time = StartTimeUTC;
+	Ok && Time < EndTimeUTC;
+	Time += SECONDS_PER_SAMPLE_OS)
+      if (OffsetFromChanges (&Changes,Time) != OffsetFromOS (Time))
+	{
+	 printf ("FAIL: %s: change missed before %ld\n",TimeZone,(long) Time);
+	 Ok = false;
+	}
+
+   unsetenv ("TZ");
+   tzset ();
+
+   if (Ok)
+      printf ("PASS: %s: %u changes got in %.3f ms\n",
+	      TimeZone,Changes.Num - 1,Elapsed * 1E3);
+   return Ok;
+  }
+
+/*****************************************************************************/
+/*************************** Database queries ********************************/
+/*****************************************************************************/
+
+static void Query (MYSQL *mysql,const char *Query)
+  {
+   if (mysql_query (mysql,Query))
+     {
+      fprintf (stderr,"%s\n%s\n",mysql_error (mysql),Query);
+      exit (2);
+     }
+  }
+
+static void QueryRow (MYSQL *mysql,const char *Query,
+                      char *Result1,char *Result2,size_t Size)
+  {
+   MYSQL_RES *mysql_res;
+   MYSQL_ROW row;
+
+   if (mysql_query (mysql,Query) ||
+       (mysql_res = mysql_store_result (mysql)) == NULL)
+     {
+      fprintf (stderr,"%s\n%s\n",mysql_error (mysql),Query);
+      exit (2);
+     }
+   row = mysql_fetch_row (mysql_res);
+   snprintf (Result1,Size,"%s",row && row[0] ? row[0] :
+					       "");
+   snprintf (Result2,Size,"%s",row && row[1] ? row[1] :
+					       "");
+   mysql_free_result (mysql_res);
+  }
+
+/*****************************************************************************/
+/************** Insert a time in the table of times to check *****************/
+/*****************************************************************************/
+
+static void InsertTime (MYSQL *mysql,char *Insert,size_t *Length,
+                        unsigned *NumTimes,time_t Time)
+  {
+   if (*NumTimes == 0)
+      *Length = (size_t) sprintf (Insert,"INSERT IGNORE INTO tz_times (T) VALUES");
+   *Length += (size_t) sprintf (Insert + *Length,"%s(%ld)",
+				*NumTimes ? "," :
+					    "",
+				(long) Time);
+   if (++*NumTimes == MAX_TIMES_IN_INSERT)
+     {
+      Query (mysql,Insert);
+      *NumTimes = 0;
+     }
+  }
+
+/*****************************************************************************/
+/************ Compare local times of a time zone with CONVERT_TZ *************/
+/*****************************************************************************/
+
+static bool CheckTimeZoneInDB (MYSQL *mysql,const char *TimeZone,
+                               time_t StartTimeUTC,time_t EndTimeUTC)
+  {
+   static const long Around[] = {-60 * 60,-1,0,1,60 * 60};
+   struct Dat_TimeZoneChanges Changes;
+   char *LocalTime;
+   char *Insert;
+   char *Select;
+   size_t Length = 0;
+   unsigned NumTimes = 0;
+   unsigned NumChange;
+   unsigned i;
+   time_t Time;
+   char NumRows[64];
+   char NumWrong[64];
+   char FirstWrong[64];
+   char Unused[64];
+   double Start;
+   double ElapsedConvertTZ;
+   double ElapsedExpression;
+
+   /***** Get changes and build expression *****/
+   if (!Dat_GetTimeZoneChanges (TimeZone,StartTimeUTC,EndTimeUTC,&Changes))
+     {
+      printf ("FAIL: %s: time zone unknown or too many changes\n",TimeZone);
+      return false;
+     }
+   Dat_BuildLocalTimeExpression (&Changes,"T",&LocalTime);
+
+   /***** Fill table with times around each change and every hour *****/
+   if ((Insert = malloc (128 + MAX_TIMES_IN_INSERT * 32)) == NULL)
+      Lay_NotEnoughMemoryExit ();
+   Query (mysql,"DELETE FROM tz_times");
+   for (NumChange = 1;
+	NumChange < Changes.Num;
+	NumChange++)
+      for (i = 0;
+	   i < sizeof (Around) / sizeof (Around[0]);
+	   i++)
+	 InsertTime (mysql,Insert,&Length,&NumTimes,
+		     Changes.TimeUTC[NumChange] + Around[i]);
+   for (Time = StartTimeUTC;
+	Time < EndTimeUTC;
+	Time += SECONDS_PER_SAMPLE_DB)
+      InsertTime (mysql,Insert,&Length,&NumTimes,Time);
+   if (NumTimes)
+      Query (mysql,Insert);
+   free (Insert);
+
+   if ((Select = malloc (1024 + 2 * strlen (LocalTime))) == NULL)
+      Lay_NotEnoughMemoryExit ();
+
+   /***** Check that time zone tables are loaded *****/
+   sprintf (Select,"SELECT CONVERT_TZ(FROM_UNIXTIME(0),@@session.time_zone,'%s'),0",
+	    TimeZone);
+   QueryRow (mysql,Select,NumRows,Unused,sizeof (NumRows));
+   if (!NumRows[0])
+     {
+      printf ("FAIL: %s: time zone not loaded in MySQL\n",TimeZone);
+      free (Select);
+      free (LocalTime);
+      return false;
+     }
+
+   /***** Compare local times *****/
+   sprintf (Select,"SELECT COUNT(*),MIN(T) FROM tz_times"
+		   " WHERE DATE_FORMAT(CONVERT_TZ(FROM_UNIXTIME(T),@@session.time_zone,'%s'),'%%Y%%m%%d%%H%%i%%s')"
+		   "<>DATE_FORMAT(%s,'%%Y%%m%%d%%H%%i%%s')",
+	    TimeZone,LocalTime);
+   QueryRow (mysql,Select,NumWrong,FirstWrong,sizeof (NumWrong));
+
+   /***** Time spent grouping by hour in both ways *****/
+   sprintf (Select,"SELECT COUNT(DISTINCT DATE_FORMAT(CONVERT_TZ(FROM_UNIXTIME(T),@@session.time_zone,'%s'),'%%Y%%m%%d%%H')),0"
+		   " FROM tz_times",
+	    TimeZone);
+   Start = Seconds ();
+   QueryRow (mysql,Select,NumRows,Unused,sizeof (NumRows));
+   ElapsedConvertTZ = Seconds () - Start;
+
+   sprintf (Select,"SELECT COUNT(DISTINCT DATE_FORMAT(%s,'%%Y%%m%%d%%H')),0"
+		   " FROM tz_times",
+	    LocalTime);
+   Start = Seconds ();
+   QueryRow (mysql,Select,NumRows,Unused,sizeof (NumRows));
+   ElapsedExpression = Seconds () - Start;
+
+   free (Select);
+   free (LocalTime);
+
+   if (strcmp (NumWrong,"0"))
+     {
+      printf ("FAIL: %s: %s times differ, first at %s\n",
+	      TimeZone,NumWrong,FirstWrong);
+      return false;
+     }
+   printf ("PASS: %s: %u changes, CONVERT_TZ %.3f s, expression %.3f s\n",
+	   TimeZone,Changes.Num - 1,ElapsedConvertTZ,ElapsedExpression);
+   return true;
+  }
+
+/*****************************************************************************/
+/******************************* Main function *******************************/
+/*****************************************************************************/
+
+int main (int argc,char *argv[])
+  {
+   const char *Password = getenv ("SWAD_DB_PASSWORD");
+   MYSQL mysql;
+   time_t StartTimeUTC;
+   time_t EndTimeUTC;
+   int NumArg;
+   bool Ok = true;
+
+   if (argc < 5 ||
+       (strcmp (argv[1],"os") && strcmp (argv[1],"db")) ||
+       (!strcmp (argv[1],"db") && !Password))
+     {
+      fprintf (stderr,"Usage: %s os StartYear EndYear TimeZone...\n"
+		      "       SWAD_DB_PASSWORD=... %s db StartYear EndYear TimeZone...\n",
+	       argv[0],argv[0]);
+      return 2;
+     }
+   StartTimeUTC = StartOfYearUTC ((unsigned) atoi (argv[2]));
+   EndTimeUTC   = StartOfYearUTC ((unsigned) atoi (argv[3]));
+
+   if (!strcmp (argv[1],"os"))
+      for (NumArg = 4;
+	   NumArg < argc;
+	   NumArg++)
+	 Ok = CheckTimeZoneInOS (argv[NumArg],StartTimeUTC,EndTimeUTC) && Ok;
+   else
+     {
+      if (mysql_init (&mysql) == NULL ||
+	  mysql_real_connect (&mysql,Cfg_DATABASE_HOST,
+			      Cfg_DATABASE_USER,Password,
+			      Cfg_DATABASE_DBNAME,0,NULL,0) == NULL)
+	{
+	 fprintf (stderr,"Can not connect to database.\n");
+	 return 2;
+	}
+      Query (&mysql,"SET time_zone='+00:00'");
+      Query (&mysql,"CREATE TEMPORARY TABLE tz_times (T BIGINT NOT NULL,UNIQUE INDEX(T))");
+
+      for (NumArg = 4;
+	   NumArg < argc;
+	   NumArg++)
+	 Ok = CheckTimeZoneInDB (&mysql,argv[NumArg],StartTimeUTC,EndTimeUTC) && Ok;
+
+      mysql_close (&mysql);
+     }
+
+   return Ok ? 0 :
+	       1;
+  }
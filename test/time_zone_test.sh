@@ -0,0 +1,36 @@
+#!/bin/bash
+#
+# time_zone_test.sh: test changes of UTC offset got by swad_date.c
+#
+# Usage: ./time_zone_test.sh (from this directory, after "make time_zone_test")
+# Needs zic to compile time zones with changes of offset in the same day.
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf "$WORKDIR"' EXIT
+
+FAILED=0
+
+# Time zones of the tz database of the operating system,
+# including offsets of 30 and 45 minutes and DST in the southern hemisphere
+./time_zone_test os 2000 2030 \
+	Europe/Madrid America/New_York America/Santiago America/Sao_Paulo \
+	Australia/Lord_Howe Asia/Kathmandu Pacific/Apia Africa/Casablanca \
+	UTC +05:30 -03:00 || FAILED=1
+
+# Synthetic time zones:
+# two changes in the same day, and two changes in the same hour
+cat > "$WORKDIR/test.zi" <<'ZONES'
+Zone	Test/TwoChangesInOneDay	0:00	-	AAA	2021 Jun 1 02:00u
+				1:00	-	BBB	2021 Jun 1 20:00u
+				0:00	-	AAA	2021 Nov 1 10:30u
+				0:30	-	CCC	2021 Nov 1 11:50u
+				0:00	-	AAA
+Zone	Test/TwoChangesInOneHour	0:00	-	AAA	2021 Jun 1 02:10u
+				2:00	-	BBB	2021 Jun 1 02:40u
+				1:00	-	CCC
+ZONES
+zic -d "$WORKDIR/zoneinfo" "$WORKDIR/test.zi" || exit 2
+TZDIR="$WORKDIR/zoneinfo" ./time_zone_test os 2020 2023 \
+	Test/TwoChangesInOneDay Test/TwoChangesInOneHour || FAILED=1
+
+exit $FAILED